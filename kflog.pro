@@ -35,6 +35,21 @@ TEMPLATE = subdirs
                 kflog/kfrgmn \
                 kflog/kfrxsp
                 
+# The recorder emulator harness is optional: qmake CONFIG+=kfremu
+kfremu {
+    SUBDIRS += kflog/kfremu
+    }
+
+# The distance check of GeoVectors is optional: qmake CONFIG+=kfdistcheck
+kfdistcheck {
+    SUBDIRS += kflog/kfdistcheck
+    }
+
+# The download check of the HTTP client is optional: qmake CONFIG+=kfhttpcheck
+kfhttpcheck {
+    SUBDIRS += kflog/kfhttpcheck
+    }
+
 # FIXME: Under Qt5 opengl_igc is crashing in virtualbox               
 lessThan(QT_MAJOR_VERSION, 5) {               
     SUBDIRS += kflog/opengl_igc
@@ -19,11 +19,13 @@
 
 #include "AirspaceHelper.h"
 #include "mapcontents.h"
+#include "mapmatrix.h"
 #include "OpenAip.h"
 #include "openairparser.h"
 #include "resource.h"
 
-extern QSettings _settings;
+extern MapMatrix* _globalMapMatrix;
+extern QSettings  _settings;
 
 QMap<QString, BaseMapElement::objectType> AirspaceHelper::m_airspaceTypeMap;
 
@@ -31,6 +33,8 @@ QSet<int> AirspaceHelper::m_airspaceDictionary;
 
 QMutex AirspaceHelper::m_mutex;
 
+SourceCache<Airspace> AirspaceHelper::m_cache;
+
 int AirspaceHelper::loadAirspaces( QList<Airspace>& list )
 {
   // Set a global lock during execution to avoid calls in parallel.
@@ -79,46 +83,117 @@ int AirspaceHelper::loadAirspaces( QList<Airspace>& list )
         }
     }
 
-  OpenAirParser oap;
-  OpenAip oaip;
-  QString errorInfo;
+  // The type mapping must be loaded before the tasks are started, because
+  // it is used by all of them.
+  if( m_airspaceTypeMap.isEmpty() )
+    {
+      loadAirspaceTypeMapping();
+    }
+
+  // Only the files, which are new or changed since the last load, are read.
+  QList<AirspaceLoadTask *> tasks;
+  QList<QByteArray> fingerprints;
+  QThreadPool pool;
+  int readCounter = 0;
 
-  while( ! preselect.isEmpty() )
+  for( int i = preselect.size() - 1; i >= 0; i-- )
     {
-      QString srcName;
+      const QString& srcName = preselect.at(i);
 
-      if( preselect.first().endsWith(QString(".TXT")) ||
-	  preselect.first().endsWith(QString(".txt")) )
+      if( ! srcName.endsWith(QString(".TXT")) &&
+          ! srcName.endsWith(QString(".txt")) &&
+          ! srcName.endsWith(QString(".aip")) )
         {
-          srcName = preselect.first();
+          preselect.removeAt(i);
+        }
+    }
 
-          if( oap.parse(srcName, list) )
-            {
-              loadCounter++;
-            }
+  m_cache.retain( preselect );
 
-          preselect.removeAt(0);
+  for( int i = 0; i < preselect.size(); i++ )
+    {
+      const QString& srcName = preselect.at(i);
+
+      QByteArray fp = SourceCache<Airspace>::fingerprint( srcName );
+      QList<Airspace> cached;
+
+      fingerprints.append( fp );
+
+      if( m_cache.lookup( srcName, fp, cached ) )
+        {
           continue;
         }
 
-      if( preselect.first().endsWith(QString(".aip")) )
+      AirspaceLoadTask* task = new AirspaceLoadTask( srcName );
+      task->setAutoDelete( false );
+      tasks.append( task );
+      pool.start( task );
+    }
+
+  pool.waitForDone();
+
+  for( int i = 0; i < tasks.size(); i++ )
+    {
+      AirspaceLoadTask* task = tasks.at(i);
+
+      if( task->isOk() )
         {
-          // there can't be the same name aic after this aip
-          // parse found aip file
-          srcName = preselect.first();
+          // The airspaces are cached with their WGS84 coordinates.
+          int idx = preselect.indexOf( task->fileName() );
+          m_cache.insert( task->fileName(), fingerprints.at(idx), task->getAirspaces() );
+        }
+      else
+        {
+          m_cache.remove( task->fileName() );
+        }
+    }
 
-          if( oaip.readAirspaces(srcName, list, errorInfo ) )
-            {
-              loadCounter++;
-            }
+  readCounter = tasks.size();
+  qDeleteAll( tasks );
+
+  // Merge the results in the order of the files.
+  for( int i = 0; i < preselect.size(); i++ )
+    {
+      const QString& srcName = preselect.at(i);
+      QList<Airspace> asList;
 
-          preselect.removeAt(0);
+      if( m_cache.lookup( srcName, fingerprints.at(i), asList ) == false )
+        {
           continue;
         }
 
-    } // End of While
+      loadCounter++;
+
+      bool isOpenAip = srcName.endsWith(QString(".aip"));
 
-  qDebug("ASH: %d Airspace file(s) loaded in %dms", loadCounter, t.elapsed());
+      for( int j = 0; j < asList.size(); j++ )
+        {
+          Airspace& as = asList[j];
+
+          if( isOpenAip && addAirspaceIdentifier( as.getId() ) == false )
+            {
+              // Airspace is already known. Ignore object.
+              qDebug() << "ASH: Known Airspace"
+                       << as.getName()
+                       << "ignored!";
+              continue;
+            }
+
+          // Translate all WGS84 points to current map projection
+          QPolygon polygon = as.getProjectedPolygon();
+
+          for( int k = 0; k < polygon.size(); k++ )
+            {
+              polygon.setPoint( k, _globalMapMatrix->wgsToMap( polygon.point(k) ) );
+            }
+
+          as.setProjectedPolygon( polygon );
+          list.append( as );
+        }
+    }
+
+  qDebug("ASH: %d Airspace file(s) loaded in %dms, %d of them read",
+         loadCounter, t.elapsed(), readCounter);
 
 //    for(int i=0; i < list.size(); i++ )
 //      {
@@ -277,6 +352,40 @@ AirspaceHelper::initializeAirspaceTypeMapping(const QString& mapFilePath)
   return typeMap;
 }
 
+/*---------------------- AirspaceLoadTask ------------------------------------*/
+
+AirspaceLoadTask::AirspaceLoadTask( const QString& fileName ) :
+  QRunnable(),
+  m_fileName(fileName),
+  m_isOpenAip(fileName.endsWith(QString(".aip"))),
+  m_ok(false)
+{
+  // The map projection is not thread safe and is done later on.
+  m_openAirParser.setMapProjection( false );
+  m_openAip.setMapProjection( false );
+
+  // The settings are not thread safe too.
+  m_openAirParser.setMaxArcDeviation( _settings.value( "/Airspace/MaxArcDeviation", 25.0 ).toDouble() );
+}
+
+AirspaceLoadTask::~AirspaceLoadTask()
+{
+}
+
+void AirspaceLoadTask::run()
+{
+  if( m_isOpenAip )
+    {
+      QString errorInfo;
+
+      m_ok = m_openAip.readAirspaces( m_fileName, m_airspaceList, errorInfo );
+    }
+  else
+    {
+      m_ok = m_openAirParser.parse( m_fileName, m_airspaceList );
+    }
+}
+
 /*---------------------- AirspaceHelperThread --------------------------------*/
 
 #include <csignal>
@@ -43,11 +43,15 @@
 #include <QList>
 #include <QMap>
 #include <QMutex>
+#include <QRunnable>
 #include <QSet>
 #include <QString>
 
 #include "airspace.h"
 #include "basemapelement.h"
+#include "OpenAip.h"
+#include "openairparser.h"
+#include "sourcecache.h"
 
 class AirspaceHelper
 {
@@ -69,6 +73,13 @@ class AirspaceHelper
 
   /**
    * Searches on a default place for OpenAir and OpenAip airspace files.
+   * Every file is parsed by an own task in a thread pool. The results are
+   * appended to the list in the order of the files, so that the result does
+   * not depend on the number of used threads. The map projection of the
+   * read airspaces is done in the calling thread.
+   *
+   * The read airspaces of every file are cached. A file is only read again,
+   * if it is new or if its fingerprint has changed.
    *
    * @returns The number of successfully loaded files
    *
@@ -167,6 +178,86 @@ class AirspaceHelper
 
   /** Mutex to ensure thread safety. */
   static QMutex m_mutex;
+
+  /** The read airspaces per file, protected by m_mutex. */
+  static SourceCache<Airspace> m_cache;
+};
+
+/******************************************************************************/
+
+/**
+ * \class AirspaceLoadTask
+ *
+ * \author agent
+ *
+ * \brief Task to read one airspace file in a thread pool.
+ *
+ * The task reads an OpenAir or an OpenAIP airspace file. The read airspaces
+ * contain the WGS84 coordinates in their polygons, because the map
+ * projection is not thread safe. The projection and the removal of
+ * duplicates are done by \ref AirspaceHelper::loadAirspaces.
+ *
+ * \date 2026
+ *
+ * \version 1.0
+ */
+
+class AirspaceLoadTask : public QRunnable
+{
+ public:
+
+  AirspaceLoadTask( const QString& fileName );
+
+  virtual ~AirspaceLoadTask();
+
+  /**
+   * Reads the airspace file. Called by the thread pool.
+   */
+  void run();
+
+  /**
+   * \return True, if the file has been read successfully.
+   */
+  bool isOk() const
+  {
+    return m_ok;
+  };
+
+  /**
+   * \return The name of the read file.
+   */
+  const QString& fileName() const
+  {
+    return m_fileName;
+  };
+
+  /**
+   * \return True, if the file is in OpenAIP format.
+   */
+  bool isOpenAip() const
+  {
+    return m_isOpenAip;
+  };
+
+  /**
+   * \return The read airspaces with unprojected polygons.
+   */
+  QList<Airspace>& getAirspaces()
+  {
+    return m_airspaceList;
+  };
+
+ private:
+
+  QString m_fileName;
+  bool    m_isOpenAip;
+  bool    m_ok;
+
+  /** The parsers are created in the calling thread. */
+  OpenAirParser m_openAirParser;
+  OpenAip       m_openAip;
+
+  QList<Airspace> m_airspaceList;
 };
 
 /******************************************************************************/
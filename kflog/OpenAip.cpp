@@ -26,7 +26,8 @@ extern QSettings  _settings;
 
 OpenAip::OpenAip() :
   m_filterRadius(0.0),
-  m_filterRunwayLength(0.0)
+  m_filterRunwayLength(0.0),
+  m_mapProjection(true)
 {
   m_supportedDataFormats << "1.0" << "1.1";
 }
@@ -245,19 +246,9 @@ bool OpenAip::readNavAids( QString fileName,
                   break;
                 }
 
-              if( useFiltering == true )
+              if( useFiltering == true && filterOut( rp ) )
                 {
-
-                  if( m_filterRadius > 0.0 )
-                    {
-                      double d = dist( &m_homePosition, rp.getWGSPositionPtr() );
-
-                      if( d > m_filterRadius )
-                        {
-                          // The radius filter said no. To far away from home.
-                          continue;
-                        }
-                    }
+                  continue;
                 }
 
               // Short name is only 8 characters long and must be unique
@@ -409,8 +400,11 @@ bool OpenAip::readGeoLocation( QXmlStreamReader& xml, SinglePoint& sp )
                   WGSPoint wgsPoint( ilat, ilon );
                   sp.setWGSPosition( wgsPoint );
 
-                  // Map WGS point to map projection
-                  sp.setPosition( _globalMapMatrix->wgsToMap(wgsPoint) );
+                  if( m_mapProjection )
+                    {
+                      // Map WGS point to map projection
+                      sp.setPosition( _globalMapMatrix->wgsToMap(wgsPoint) );
+                    }
                 }
 
               if( elev != INT_MIN )
@@ -677,19 +671,9 @@ bool OpenAip::readHotspots( QString fileName,
                   break;
                 }
 
-              if( useFiltering == true )
+              if( useFiltering == true && filterOut( sp ) )
                 {
-
-                  if( m_filterRadius > 0.0 )
-                    {
-                      double d = dist( &m_homePosition, sp.getWGSPositionPtr() );
-
-                      if( d > m_filterRadius )
-                        {
-                          // The radius filter said no. To far away from home.
-                          continue;
-                        }
-                    }
+                  continue;
                 }
 
               // Short name is only 8 characters long and must be unique
@@ -866,60 +850,9 @@ bool OpenAip::readAirfields( QString fileName,
                   break;
                 }
 
-              if( useFiltering == true )
+              if( useFiltering == true && filterOut( af ) )
                 {
-                  if( af.getTypeID() == BaseMapElement::CivHeliport ||
-                      af.getTypeID() == BaseMapElement::MilHeliport )
-                    {
-                      // Filter out heli ports.
-                      continue;
-                    }
-
-                  if( m_filterRadius > 0.0 )
-                    {
-                      double d = dist( &m_homePosition, af.getWGSPositionPtr() );
-
-                      if( d > m_filterRadius )
-                        {
-                          // The radius filter said no. To far away from home.
-                          continue;
-                        }
-                    }
-
-                  if( m_filterRunwayLength > 0.0 )
-                    {
-                      QList<Runway>& rl = af.getRunwayList();
-
-                      if( rl.isEmpty() )
-                        {
-                          // No runways are defined, ignore these data
-                          continue;
-                        }
-
-                      bool rwyLenOk = false;
-                      float rwy2short = 0.0;
-
-                      for( int i = 0; i < rl.size(); i++ )
-                        {
-                          if( rl.at(i).m_length < m_filterRunwayLength )
-                            {
-                              rwy2short = rl.at(i).m_length;
-                              continue;
-                            }
-
-                          // One runway fulfills the length condition, break loop.
-                          rwyLenOk = true;
-                          break;
-                        }
-
-                      if( rwyLenOk == false )
-                        {
-                          qDebug() << "OpenAip::readAirfields:"
-                                   << af.getName() << af.getCountry()
-                                   << "runway length" << rwy2short << "to short!";
-                          continue;
-                        }
-                    }
+                  continue;
                 }
 
               // Short name is only 8 characters long and must be unique
@@ -1641,6 +1574,74 @@ void OpenAip::loadUserFilterValues()
   // m_filterRunwayLength = 0.0;
 }
 
+bool OpenAip::filterOut( SinglePoint& sp )
+{
+  if( m_filterRadius > 0.0 )
+    {
+      double d = dist( &m_homePosition, sp.getWGSPositionPtr() );
+
+      if( d > m_filterRadius )
+        {
+          // The radius filter said no. To far away from home.
+          return true;
+        }
+    }
+
+  return false;
+}
+
+bool OpenAip::filterOut( Airfield& af )
+{
+  if( af.getTypeID() == BaseMapElement::CivHeliport ||
+      af.getTypeID() == BaseMapElement::MilHeliport )
+    {
+      // Filter out heli ports.
+      return true;
+    }
+
+  if( filterOut( static_cast<SinglePoint&> (af) ) )
+    {
+      return true;
+    }
+
+  if( m_filterRunwayLength > 0.0 )
+    {
+      QList<Runway>& rl = af.getRunwayList();
+
+      if( rl.isEmpty() )
+        {
+          // No runways are defined, ignore these data
+          return true;
+        }
+
+      bool rwyLenOk = false;
+      float rwy2short = 0.0;
+
+      for( int i = 0; i < rl.size(); i++ )
+        {
+          if( rl.at(i).m_length < m_filterRunwayLength )
+            {
+              rwy2short = rl.at(i).m_length;
+              continue;
+            }
+
+          // One runway fulfills the length condition, break loop.
+          rwyLenOk = true;
+          break;
+        }
+
+      if( rwyLenOk == false )
+        {
+          qDebug() << "OpenAip::filterOut:"
+                   << af.getName() << af.getCountry()
+                   << "runway length" << rwy2short << "to short!";
+          return true;
+        }
+    }
+
+  return false;
+}
+
 bool OpenAip::readAirspaces( QString fileName,
                              QList<Airspace>& airspaceList,
                              QString& errorInfo )
@@ -1754,17 +1755,9 @@ bool OpenAip::readAirspaces( QString fileName,
                       continue;
                     }
 
-                  if( AirspaceHelper::addAirspaceIdentifier(as.getId()) )
-                    {
-                      airspaceList.append( as.createAirspaceObject() );
-                    }
-                  else
-                    {
-                      // Airspace is already known. Ignore object.
-                      qDebug() << "QIAP:: Known Airspace"
-                               << as.getName()
-                               << "ignored!";
-                    }
+                  // Duplicates are removed by the caller, because more
+                  // than one file can be read in parallel.
+                  airspaceList.append( as.createAirspaceObject() );
                 }
             }
 
@@ -2117,8 +2110,16 @@ bool OpenAip::readAirspaceGeometrie( QXmlStreamReader& xml, Airspace& as )
       int latInt = static_cast<int> (rint(600000.0 * lat));
       int lonInt = static_cast<int> (rint(600000.0 * lon));
 
-      // Project coordinates to map datum and store them in a polygon
-      asPolygon.setPoint( i/2, _globalMapMatrix->wgsToMap( latInt, lonInt ) );
+      if( m_mapProjection )
+        {
+          // Project coordinates to map datum and store them in a polygon
+          asPolygon.setPoint( i/2, _globalMapMatrix->wgsToMap( latInt, lonInt ) );
+        }
+      else
+        {
+          // The projection is done later on by the caller.
+          asPolygon.setPoint( i/2, latInt, lonInt );
+        }
     }
 
   if( asPolygon.count() < 2 )
@@ -149,6 +149,44 @@ class OpenAip
    */
   QString shortName( const QString& name );
 
+  /**
+   * Loads the user's defined filter values from the configuration data.
+   * Must be called from the GUI thread.
+   */
+  void loadUserFilterValues();
+
+  /**
+   * Checks the point against the loaded user filter values.
+   *
+   * \param sp Point to be checked
+   *
+   * \return true, if the point shall be ignored otherwise false
+   */
+  bool filterOut( SinglePoint& sp );
+
+  /**
+   * Checks the airfield against the loaded user filter values. Heliports
+   * and airfields with too short runways are filtered out too.
+   *
+   * \param af Airfield to be checked
+   *
+   * \return true, if the airfield shall be ignored otherwise false
+   */
+  bool filterOut( Airfield& af );
+
+  /**
+   * Enables or disables the map projection of read positions. Must be
+   * disabled, if a file is read outside of the GUI thread, because the map
+   * projection is not thread safe. The caller has to project the
+   * positions later on.
+   *
+   * \param enable Projection on/off
+   */
+  void setMapProjection( const bool enable )
+    {
+      m_mapProjection = enable;
+    };
+
   /**
    * \return A reference to the short name set.
    */
@@ -231,11 +269,6 @@ class OpenAip
    */
   bool getUnitValueAsFloat( const QString number, const QString unit, float& result );
 
-  /**
-   * Loads the user's defined filter values from the configuration data.
-   */
-  void loadUserFilterValues();
-
   /**
    * Containing all supported OpenAip data formats.
    */
@@ -279,6 +312,9 @@ class OpenAip
 
   /** Contains all short names of parsed file. */
   QSet<QString> m_shortNameSet;
+
+  /** Flag to enable the map projection of read positions. */
+  bool m_mapProjection;
 };
 
 #endif /* OpenAip_h */
@@ -16,16 +16,132 @@
 #include <QtCore>
 
 #include "mapcontents.h"
+#include "mapmatrix.h"
 #include "OpenAip.h"
 #include "OpenAipPoiLoader.h"
 
-extern QSettings _settings;
+#define DATA_STREAM QDataStream::Qt_4_7
+
+// general KFLOG file token: @KFL
+#define KFLOG_FILE_MAGIC    0x404b464c
+
+// compiled openAIP point file
+#define FILE_TYPE_OAIP_POI     0x4f
+#define FILE_VERSION_OAIP_POI  100
+
+extern MapMatrix* _globalMapMatrix;
+extern QSettings  _settings;
 
 // set static member variable
 QMutex OpenAipPoiLoader::m_mutexAf;
 QMutex OpenAipPoiLoader::m_mutexNa;
 QMutex OpenAipPoiLoader::m_mutexHs;
 
+SourceCache<Airfield>    OpenAipPoiLoader::m_cacheAf;
+SourceCache<RadioPoint>  OpenAipPoiLoader::m_cacheNa;
+SourceCache<SinglePoint> OpenAipPoiLoader::m_cacheHs;
+
+/**
+ * Reads all passed files in parallel and merges the results in file order
+ * into the passed list. Files, which are unchanged since the last load, are
+ * taken from the cache. Filtering, map projection and the creation of
+ * unique short names are done here in the calling thread.
+ */
+template<class T>
+static int loadFiles( const QStringList& files,
+                      const OpenAipPoiTask::Kind kind,
+                      SourceCache<T>& cache,
+                      QList<T>& list )
+{
+  QThreadPool pool;
+  QList<OpenAipPoiTask *> tasks;
+  QList<QByteArray> fingerprints;
+
+  cache.retain( files );
+
+  for( int i = 0; i < files.size(); i++ )
+    {
+      QByteArray fp = SourceCache<T>::fingerprint( files.at(i) );
+      QList<T> cached;
+
+      fingerprints.append( fp );
+
+      if( cache.lookup( files.at(i), fp, cached ) )
+        {
+          continue;
+        }
+
+      OpenAipPoiTask* task = new OpenAipPoiTask( files.at(i), kind );
+      task->setAutoDelete( false );
+      tasks.append( task );
+      pool.start( task );
+    }
+
+  pool.waitForDone();
+
+  for( int i = 0; i < tasks.size(); i++ )
+    {
+      OpenAipPoiTask* task = tasks.at(i);
+
+      if( task->isOk() == false )
+        {
+          cache.remove( task->fileName() );
+          continue;
+        }
+
+      // The points are cached unfiltered with their WGS84 positions.
+      QList<T> results;
+      task->takeResults( results );
+      cache.insert( task->fileName(), fingerprints.at( files.indexOf( task->fileName() ) ), results );
+    }
+
+  if( tasks.size() > 0 )
+    {
+      qDebug( "OAIP: %d of %d file(s) read", tasks.size(), files.size() );
+    }
+
+  qDeleteAll( tasks );
+
+  int loadCounter = 0;
+
+  OpenAip filter;
+  filter.loadUserFilterValues();
+
+  for( int i = 0; i < files.size(); i++ )
+    {
+      QList<T> results;
+
+      if( cache.lookup( files.at(i), fingerprints.at(i), results ) == false )
+        {
+          continue;
+        }
+
+      loadCounter++;
+
+      // Short names must be unique per file.
+      OpenAip names;
+
+      for( int j = 0; j < results.size(); j++ )
+        {
+          T& item = results[j];
+
+          if( filter.filterOut( item ) )
+            {
+              continue;
+            }
+
+          item.setPosition( _globalMapMatrix->wgsToMap( item.getWGSPosition() ) );
+
+          // Short name is only 8 characters long and must be unique
+          item.setShortName( names.shortName( item.getName() ) );
+
+          list.append( item );
+        }
+    }
+
+  return loadCounter;
+}
+
 OpenAipPoiLoader::OpenAipPoiLoader()
 {
 }
@@ -34,27 +150,17 @@ OpenAipPoiLoader::~OpenAipPoiLoader()
 {
 }
 
-int OpenAipPoiLoader::load( QList<Airfield>& airfieldList )
+QStringList OpenAipPoiLoader::selectFiles( const QString& filter, const QString& kind )
 {
-  // Set a global lock during execution to avoid calls in parallel.
-  QMutexLocker locker( &m_mutexAf );
-
-  QTime t;
-  t.start();
-  int loadCounter = 0; // number of successfully loaded files
-
   QString mapDir = MapContents::instance()->getMapRootDirectory() + "/points";
   QStringList preselect;
 
-  // Setup a filter for the desired file extensions.
-  QString filter = "*_wpt.aip";
-
   MapContents::addDir( preselect, mapDir, filter );
 
   if( preselect.count() == 0 )
     {
-      qWarning( "OAIP: No airfield files found in the map directory!" );
-      return loadCounter;
+      qWarning() << "OAIP: No" << kind << "files found in the map directory!";
+      return preselect;
     }
 
   // Check, which files shall be loaded.
@@ -63,8 +169,8 @@ int OpenAipPoiLoader::load( QList<Airfield>& airfieldList )
   if( files.isEmpty() )
     {
       // No files shall be loaded
-      qWarning() << "OAIP: No airfield files defined for loading by the user!";
-      return loadCounter;
+      qWarning() << "OAIP: No" << kind << "files defined for loading by the user!";
+      return files;
     }
 
   if( files.first() != "All" )
@@ -81,26 +187,20 @@ int OpenAipPoiLoader::load( QList<Airfield>& airfieldList )
         }
     }
 
-  while( ! preselect.isEmpty() )
-    {
-      QString srcName;
-      OpenAip openAip;
-      QString errorInfo;
-
-      srcName = preselect.first();
-
-      // Remove source file to be read from the list.
-      preselect.removeAt(0);
-
-      bool ok = openAip.readAirfields( srcName,
-				       airfieldList,
-				       errorInfo,
-				       true );
-      if( ok )
-	{
-	  loadCounter++;
-	}
-    }
+  return preselect;
+}
+
+int OpenAipPoiLoader::load( QList<Airfield>& airfieldList )
+{
+  // Set a global lock during execution to avoid calls in parallel.
+  QMutexLocker locker( &m_mutexAf );
+
+  QTime t;
+  t.start();
+
+  QStringList files = selectFiles( "*_wpt.aip", "airfield" );
+
+  int loadCounter = loadFiles( files, OpenAipPoiTask::Airfields, m_cacheAf, airfieldList );
 
   qDebug( "OAIP: %d airfield file(s) with %d items loaded in %dms",
           loadCounter, airfieldList.size(), t.elapsed() );
@@ -115,145 +215,378 @@ int OpenAipPoiLoader::load( QList<RadioPoint>& navaidsList )
 
   QTime t;
   t.start();
-  int loadCounter = 0; // number of successfully loaded files
 
-  QString mapDir = MapContents::instance()->getMapRootDirectory() + "/points";
-  QStringList preselect;
+  QStringList files = selectFiles( "*_nav.aip", "navaid" );
 
-  // Setup a filter for the desired file extensions.
-  QString filter = "*_nav.aip";
+  int loadCounter = loadFiles( files, OpenAipPoiTask::NavAids, m_cacheNa, navaidsList );
 
-  MapContents::addDir( preselect, mapDir, filter );
+  qDebug( "OAIP: %d navaid file(s) with %d items loaded in %dms",
+          loadCounter, navaidsList.size(), t.elapsed() );
 
-  if( preselect.count() == 0 )
-    {
-      qWarning( "OAIP: No navaid files found in the map directory!" );
-      return loadCounter;
-    }
+  return loadCounter;
+}
 
-  // Check, which files shall be loaded.
-  QStringList files = _settings.value( "/Points/FileList", QStringList(QString("All"))).toStringList();
+int OpenAipPoiLoader::load( QList<SinglePoint>& hotspotList )
+{
+  // Set a global lock during execution to avoid calls in parallel.
+  QMutexLocker locker( &m_mutexHs );
 
-  if( files.isEmpty() )
+  QTime t;
+  t.start();
+
+  QStringList files = selectFiles( "*_hot.aip", "hotspot" );
+
+  int loadCounter = loadFiles( files, OpenAipPoiTask::Hotspots, m_cacheHs, hotspotList );
+
+  qDebug( "OAIP: %d hotspot file(s) with %d items loaded in %dms",
+          loadCounter, hotspotList.size(), t.elapsed() );
+
+  return loadCounter;
+}
+
+/******************************************************************************/
+
+static void writeSinglePoint( QDataStream& out, SinglePoint& sp )
+{
+  out << sp.getName()
+      << sp.getShortName()
+      << qint16( sp.getTypeID() )
+      << sp.getCountry()
+      << sp.getComment()
+      << qint32( sp.getWGSPosition().lat() )
+      << qint32( sp.getWGSPosition().lon() )
+      << sp.getElevation();
+}
+
+static void readSinglePoint( QDataStream& in, SinglePoint& sp )
+{
+  QString name, shortName, country, comment;
+  qint16 typeId;
+  qint32 lat, lon;
+  float elevation;
+
+  in >> name >> shortName >> typeId >> country >> comment
+     >> lat >> lon >> elevation;
+
+  sp.setName( name );
+  sp.setShortName( shortName );
+  sp.setTypeID( static_cast<BaseMapElement::objectType> (typeId) );
+  sp.setCountry( country );
+  sp.setComment( comment );
+  sp.setWGSPosition( WGSPoint( lat, lon ) );
+  sp.setElevation( elevation );
+}
+
+static void writeAirfield( QDataStream& out, Airfield& af )
+{
+  writeSinglePoint( out, af );
+
+  out << af.getICAO()
+      << af.getFrequency()
+      << af.getAtis()
+      << af.hasWinch()
+      << af.hasTowing()
+      << af.isLandable();
+
+  QList<Runway>& rl = af.getRunwayList();
+
+  out << quint8( rl.size() );
+
+  for( int i = 0; i < rl.size(); i++ )
     {
-      // No files shall be loaded
-      qWarning() << "OAIP: No navaid files defined for loading by the user!";
-      return loadCounter;
+      const Runway& rw = rl.at(i);
+
+      out << rw.m_length
+          << quint16( rw.m_heading.first )
+          << quint16( rw.m_heading.second )
+          << quint8( rw.m_surface )
+          << rw.m_isOpen
+          << rw.m_isBidirectional
+          << rw.m_width;
     }
+}
 
-  if( files.first() != "All" )
+static void readAirfield( QDataStream& in, Airfield& af )
+{
+  readSinglePoint( in, af );
+
+  QString icao;
+  float frequency, atis;
+  bool winch, towing, landable;
+  quint8 rwCount;
+
+  in >> icao >> frequency >> atis >> winch >> towing >> landable >> rwCount;
+
+  af.setICAO( icao );
+  af.setFrequency( frequency );
+  af.setAtis( atis );
+  af.setWinch( winch );
+  af.setTowing( towing );
+  af.setLandable( landable );
+
+  for( int i = 0; i < rwCount; i++ )
     {
-      // Tidy up the preselection list, if not all found files shall be loaded.
-      for( int i = preselect.size() - 1; i >= 0; i-- )
-        {
-          QString file = QFileInfo(preselect.at(i)).fileName();
+      Runway rw;
+      quint16 h1, h2;
+      quint8 surface;
 
-          if( files.contains( file ) == false )
-            {
-              preselect.removeAt(i);
-            }
-        }
+      in >> rw.m_length >> h1 >> h2 >> surface
+         >> rw.m_isOpen >> rw.m_isBidirectional >> rw.m_width;
+
+      rw.m_heading = QPair<ushort, ushort>( h1, h2 );
+      rw.m_surface = static_cast<enum Runway::SurfaceType> (surface);
+
+      af.addRunway( rw );
     }
+}
+
+static void writeRadioPoint( QDataStream& out, RadioPoint& rp )
+{
+  writeSinglePoint( out, rp );
+
+  out << rp.getICAO()
+      << rp.getFrequency()
+      << rp.getChannel()
+      << rp.getRange()
+      << rp.getDeclination()
+      << rp.isAligned2TrueNorth();
+}
+
+static void readRadioPoint( QDataStream& in, RadioPoint& rp )
+{
+  readSinglePoint( in, rp );
+
+  QString icao, channel;
+  float frequency, range, declination;
+  bool aligned;
 
-  while( ! preselect.isEmpty() )
+  in >> icao >> frequency >> channel >> range >> declination >> aligned;
+
+  rp.setICAO( icao );
+  rp.setFrequency( frequency );
+  rp.setChannel( channel );
+  rp.setRange( range );
+  rp.setDeclination( declination );
+  rp.setAligned2TrueNorth( aligned );
+}
+
+OpenAipPoiTask::OpenAipPoiTask( const QString& fileName, const Kind kind ) :
+  QRunnable(),
+  m_fileName(fileName),
+  m_kind(kind),
+  m_ok(false)
+{
+  // The compiled file is stored beside the source file.
+  if( fileName.endsWith( ".aip" ) )
     {
-      QString srcName;
-      OpenAip openAip;
-      QString errorInfo;
+      m_compiledName = fileName.left( fileName.size() - 4 ) + ".aic";
+    }
+  else
+    {
+      m_compiledName = fileName + "c";
+    }
+}
 
-      srcName = preselect.first();
+OpenAipPoiTask::~OpenAipPoiTask()
+{
+}
 
-      // Remove source file to be read from the list.
-      preselect.removeAt(0);
+void OpenAipPoiTask::run()
+{
+  QFile file( m_fileName );
+
+  if( file.size() == 0 || ! file.open( QIODevice::ReadOnly ) )
+    {
+      qWarning() << "OAIP: Cannot read file" << m_fileName;
+      m_ok = false;
+      return;
+    }
 
-      bool ok = openAip.readNavAids( srcName,
-                                     navaidsList,
-				     errorInfo,
-				     true );
+  QByteArray hash = QCryptographicHash::hash( file.readAll(), QCryptographicHash::Md5 );
+  file.close();
 
-      if( ok )
-	{
-	  loadCounter++;
-	}
+  if( readCompiledFile( hash ) )
+    {
+      m_ok = true;
+      return;
     }
 
-  qDebug( "OAIP: %d navaid file(s) with %d items loaded in %dms",
-          loadCounter, navaidsList.size(), t.elapsed() );
+  OpenAip openAip;
+  QString errorInfo;
 
-  return loadCounter;
+  // The map projection is not thread safe, it is done by the loader.
+  openAip.setMapProjection( false );
+
+  switch( m_kind )
+    {
+      case Airfields:
+        m_ok = openAip.readAirfields( m_fileName, m_airfieldList, errorInfo );
+        break;
+      case NavAids:
+        m_ok = openAip.readNavAids( m_fileName, m_navaidList, errorInfo );
+        break;
+      case Hotspots:
+        m_ok = openAip.readHotspots( m_fileName, m_hotspotList, errorInfo );
+        break;
+    }
+
+  if( m_ok )
+    {
+      writeCompiledFile( hash );
+    }
 }
 
-int OpenAipPoiLoader::load( QList<SinglePoint>& hotspotList )
+void OpenAipPoiTask::takeResults( QList<Airfield>& list )
 {
-  // Set a global lock during execution to avoid calls in parallel.
-  QMutexLocker locker( &m_mutexHs );
-
-  QTime t;
-  t.start();
-  int loadCounter = 0; // number of successfully loaded files
+  list = m_airfieldList;
+  m_airfieldList.clear();
+}
 
-  QString mapDir = MapContents::instance()->getMapRootDirectory() + "/points";
-  QStringList preselect;
+void OpenAipPoiTask::takeResults( QList<RadioPoint>& list )
+{
+  list = m_navaidList;
+  m_navaidList.clear();
+}
 
-  // Setup a filter for the desired file extensions.
-  QString filter = "*_hot.aip";
+void OpenAipPoiTask::takeResults( QList<SinglePoint>& list )
+{
+  list = m_hotspotList;
+  m_hotspotList.clear();
+}
 
-  MapContents::addDir( preselect, mapDir, filter );
+bool OpenAipPoiTask::readCompiledFile( const QByteArray& hash )
+{
+  QFile file( m_compiledName );
 
-  if( preselect.count() == 0 )
+  if( ! file.exists() || ! file.open( QIODevice::ReadOnly ) )
     {
-      qWarning( "OAIP: No hotspot files found in the map directory!" );
-      return loadCounter;
+      return false;
     }
 
-  // Check, which files shall be loaded.
-  QStringList files = _settings.value( "/Points/FileList", QStringList(QString("All"))).toStringList();
+  QDataStream in( &file );
+  in.setVersion( DATA_STREAM );
 
-  if( files.isEmpty() )
+  quint32 magic = 0;
+  qint8 type = 0;
+  quint16 version = 0;
+  quint8 kind = 0;
+  QByteArray fileHash;
+  quint32 count = 0;
+
+  in >> magic >> type >> version >> kind >> fileHash >> count;
+
+  if( magic != KFLOG_FILE_MAGIC || type != FILE_TYPE_OAIP_POI ||
+      version != FILE_VERSION_OAIP_POI || kind != m_kind || fileHash != hash )
     {
-      // No files shall be loaded
-      qWarning() << "OAIP: No hotspot files defined for loading by the user!";
-      return loadCounter;
+      return false;
     }
 
-  if( files.first() != "All" )
+  for( uint i = 0; i < count && in.status() == QDataStream::Ok; i++ )
     {
-      // Tidy up the preselection list, if not all found files shall be loaded.
-      for( int i = preselect.size() - 1; i >= 0; i-- )
+      switch( m_kind )
         {
-          QString file = QFileInfo(preselect.at(i)).fileName();
-
-          if( files.contains( file ) == false )
+          case Airfields:
             {
-              preselect.removeAt(i);
+              Airfield af;
+              readAirfield( in, af );
+              m_airfieldList.append( af );
+              break;
+            }
+          case NavAids:
+            {
+              RadioPoint rp;
+              readRadioPoint( in, rp );
+              m_navaidList.append( rp );
+              break;
+            }
+          case Hotspots:
+            {
+              SinglePoint sp;
+              readSinglePoint( in, sp );
+              m_hotspotList.append( sp );
+              break;
             }
         }
     }
 
-  while( ! preselect.isEmpty() )
+  if( in.status() != QDataStream::Ok )
     {
-      QString srcName;
-      OpenAip openAip;
-      QString errorInfo;
+      qWarning() << "OAIP: Compiled file" << m_compiledName << "is corrupted!";
 
-      srcName = preselect.first();
+      m_airfieldList.clear();
+      m_navaidList.clear();
+      m_hotspotList.clear();
+      return false;
+    }
 
-      // Remove source file to be read from the list.
-      preselect.removeAt(0);
+  return true;
+}
+
+bool OpenAipPoiTask::writeCompiledFile( const QByteArray& hash )
+{
+  QString tmpName = m_compiledName + ".tmp";
 
-      bool ok = openAip.readHotspots( srcName,
-                                      hotspotList,
-				      errorInfo,
-				      true );
+  QFile file( tmpName );
 
-      if( ok )
-	{
-	  loadCounter++;
-	}
+  if( ! file.open( QIODevice::WriteOnly ) )
+    {
+      qWarning() << "OAIP: Cannot open compiled file" << tmpName << "for writing!";
+      return false;
     }
 
-  qDebug( "OAIP: %d hotspot file(s) with %d items loaded in %dms",
-          loadCounter, hotspotList.size(), t.elapsed() );
+  QDataStream out( &file );
+  out.setVersion( DATA_STREAM );
 
-  return loadCounter;
+  quint32 count = 0;
+
+  switch( m_kind )
+    {
+      case Airfields:
+        count = m_airfieldList.size();
+        break;
+      case NavAids:
+        count = m_navaidList.size();
+        break;
+      case Hotspots:
+        count = m_hotspotList.size();
+        break;
+    }
+
+  out << quint32( KFLOG_FILE_MAGIC )
+      << qint8( FILE_TYPE_OAIP_POI )
+      << quint16( FILE_VERSION_OAIP_POI )
+      << quint8( m_kind )
+      << hash
+      << count;
+
+  for( uint i = 0; i < count; i++ )
+    {
+      switch( m_kind )
+        {
+          case Airfields:
+            writeAirfield( out, m_airfieldList[i] );
+            break;
+          case NavAids:
+            writeRadioPoint( out, m_navaidList[i] );
+            break;
+          case Hotspots:
+            writeSinglePoint( out, m_hotspotList[i] );
+            break;
+        }
+    }
+
+  bool ok = (out.status() == QDataStream::Ok);
+
+  file.close();
+
+  if( ! ok )
+    {
+      qWarning() << "OAIP: Cannot write compiled file" << tmpName;
+      file.remove();
+      return false;
+    }
+
+  QFile::remove( m_compiledName );
+
+  return QFile::rename( tmpName, m_compiledName );
 }
@@ -25,20 +25,30 @@
  *
  * See here for more info: http://www.openaip.net
  *
+ * All selected files are read in parallel by the threads of a thread pool.
+ * The results are merged in file order, after all files have been read.
+ * The read points of every file are cached, so that a reload reads only the
+ * new and the changed files.
+ *
  * \date 2014
  *
- * \version 1.0
+ * \version 1.1
  */
 
 #ifndef OpenAip_Poi_Loader_h_
 #define OpenAip_Poi_Loader_h_
 
+#include <QByteArray>
 #include <QList>
 #include <QMutex>
+#include <QRunnable>
+#include <QString>
+#include <QStringList>
 
 #include "airfield.h"
 #include "radiopoint.h"
 #include "singlepoint.h"
+#include "sourcecache.h"
 
 class OpenAipPoiLoader
 {
@@ -80,10 +90,111 @@ class OpenAipPoiLoader
 
  private:
 
+  /**
+   * Searches on default places openAIP files matching the passed filter and
+   * removes all files not selected by the user.
+   *
+   * \param filter File name filter, e.g. *_wpt.aip
+   *
+   * \param kind Kind of files used in messages
+   *
+   * \return list of files to be loaded
+   */
+  QStringList selectFiles( const QString& filter, const QString& kind );
+
   /** Mutex to ensure thread safety. */
   static QMutex m_mutexAf;
   static QMutex m_mutexNa;
   static QMutex m_mutexHs;
+
+  /** The read points per file, protected by the related mutex. */
+  static SourceCache<Airfield>    m_cacheAf;
+  static SourceCache<RadioPoint>  m_cacheNa;
+  static SourceCache<SinglePoint> m_cacheHs;
+};
+
+/**
+ * \class OpenAipPoiTask
+ *
+ * \author agent
+ *
+ * \brief Reads one openAIP point file in a thread of a thread pool.
+ *
+ * The read data are stored as compiled file beside the source file. The
+ * compiled file is used instead of the XML source as long as the content of
+ * the source file is unchanged. Filtering and the map projection of the read
+ * points are not done here, because they need the GUI thread.
+ *
+ * \date 2026
+ *
+ * \version 1.0
+ */
+class OpenAipPoiTask : public QRunnable
+{
+ public:
+
+  enum Kind { Airfields = 0, NavAids = 1, Hotspots = 2 };
+
+  OpenAipPoiTask( const QString& fileName, const Kind kind );
+
+  virtual ~OpenAipPoiTask();
+
+  /**
+   * Reads the file. That is the main method of the task.
+   */
+  void run();
+
+  /**
+   * \return The name of the read file.
+   */
+  const QString& fileName() const
+    {
+      return m_fileName;
+    };
+
+  /**
+   * \return true, if the file was read successfully.
+   */
+  bool isOk() const
+    {
+      return m_ok;
+    };
+
+  /**
+   * Moves the read results into the passed list.
+   */
+  void takeResults( QList<Airfield>& list );
+  void takeResults( QList<RadioPoint>& list );
+  void takeResults( QList<SinglePoint>& list );
+
+ private:
+
+  /**
+   * Reads the compiled file, if it belongs to the source file content.
+   *
+   * \param hash Hash of the source file content
+   *
+   * \return true in case of success otherwise false
+   */
+  bool readCompiledFile( const QByteArray& hash );
+
+  /**
+   * Writes the read results into the compiled file.
+   *
+   * \param hash Hash of the source file content
+   *
+   * \return true in case of success otherwise false
+   */
+  bool writeCompiledFile( const QByteArray& hash );
+
+  QString m_fileName;
+  QString m_compiledName;
+  Kind    m_kind;
+  bool    m_ok;
+
+  QList<Airfield>    m_airfieldList;
+  QList<RadioPoint>  m_navaidList;
+  QList<SinglePoint> m_hotspotList;
 };
 
 #endif /* OpenAip_Poi_Loader_h_ */
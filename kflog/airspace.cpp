@@ -15,11 +15,15 @@
  **
  ***********************************************************************/
 
+#include <QCryptographicHash>
+
 #include "airspace.h"
+#include "mapcalc.h"
 
 Airspace::Airspace() :
   m_lLimitType(BaseMapElement::NotSet),
   m_uLimitType(BaseMapElement::NotSet),
+  m_circleRadius(0.0),
   m_id(-1)
 {
   // All Airspaces are closed regions ...
@@ -38,6 +42,7 @@ Airspace::Airspace( QString name,
   LineElement( name, oType, pP, false, 0, country ),
   m_lLimitType(lType),
   m_uLimitType(uType),
+  m_circleRadius(0.0),
   m_id(identifier)
 {
   // All Airspaces are closed regions ...
@@ -95,6 +100,11 @@ Airspace::Airspace( QString name,
   // create a QPainterPath object from the projected airspace.
   m_airspaceRegion.addPolygon(projPolygon);
   m_airspaceRegion.closeSubpath();
+
+  // The polygon is passed with WGS84 coordinates and projected later.
+  m_wgsKey = QCryptographicHash::hash( QByteArray::fromRawData( reinterpret_cast<const char *> (pP.constData()),
+                                                                pP.size() * sizeof(QPoint) ),
+                                       QCryptographicHash::Md5 );
 }
 
 Airspace Airspace::createAirspaceObject()
@@ -102,15 +112,25 @@ Airspace Airspace::createAirspaceObject()
   // We need that method because the default constructor cannot setup a
   // complete airspace. The default constructor is only used as a collection
   // container during parsing of airspace source file.
-  return Airspace( getName(),
-		   getTypeID(),
-		   getProjectedPolygon(),
-		   m_uLimit.getFeet(),
-		   m_uLimitType,
-		   m_lLimit.getFeet(),
-		   m_lLimitType,
-		   m_id,
-		   getCountry() );
+  Airspace as( getName(),
+               getTypeID(),
+               getProjectedPolygon(),
+               m_uLimit.getFeet(),
+               m_uLimitType,
+               m_lLimit.getFeet(),
+               m_lLimitType,
+               m_id,
+               getCountry() );
+
+  as.setCircle( m_circleCenter, m_circleRadius );
+  return as;
+}
+
+bool Airspace::isInsideCircle( const QPoint& point ) const
+{
+  // dist returns kilometers
+  return dist( m_circleCenter.x(), m_circleCenter.y(),
+               point.x(), point.y() ) * 1000.0 <= m_circleRadius;
 }
 
 void Airspace::drawRegion( QPainter* targetP, const QRect &viewRect )
@@ -294,6 +314,58 @@ QString Airspace::getInfoString(bool ExtendedHTMLFormat) const
   return text;
 }
 
+/**
+ * Returns the normalized lower and upper limits of the airspace, which are
+ * used by the intersection check of a whole flight.
+ */
+void Airspace::getVerticalLimits( VerticalLimit& lower, VerticalLimit& upper ) const
+{
+  // The same decisions as in conflicts for the inside case.
+  lower.meters = m_lLimit.getMeters();
+  upper.meters = m_uLimit.getMeters();
+
+  switch( m_lLimitType )
+    {
+      case MSL:
+        lower.reference = PressureLimit;
+        break;
+      case GND:
+        // we're always above ground
+        lower.reference = ( m_lLimit == 0 ) ? AlwaysInside : GroundLimit;
+        break;
+      case FL:
+      case STD:
+        lower.reference = StdLimit;
+        break;
+      case UNLTD:
+        lower.reference = NeverInside;
+        break;
+      case NotSet:
+        lower.reference = ( 0.0 >= m_lLimit.getMeters() ) ? AlwaysInside : NeverInside;
+        break;
+    }
+
+  switch( m_uLimitType )
+    {
+      case NotSet:
+        upper.reference = ( 100000.0 <= m_uLimit.getMeters() ) ? AlwaysInside : NeverInside;
+        break;
+      case MSL:
+        upper.reference = PressureLimit;
+        break;
+      case GND:
+        upper.reference = GroundLimit;
+        break;
+      case FL:
+      case STD:
+        upper.reference = StdLimit;
+        break;
+      case UNLTD:
+        upper.reference = AlwaysInside;
+        break;
+    }
+}
+
 /**
  * Returns true if the given altitude conflicts with the airspace
  * properties. Only the altitude is considered not the current
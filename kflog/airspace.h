@@ -39,6 +39,7 @@
 #ifndef AIRSPACE_H
 #define AIRSPACE_H
 
+#include <QByteArray>
 #include <QDateTime>
 #include <QPolygon>
 #include <QPainter>
@@ -56,6 +57,22 @@ public:
 
   enum ConflictType { None, NearAbove, NearBelow, VeryNearAbove, VeryNearBelow, Inside };
 
+  /**
+   * Altitude, to which a normalized vertical limit is related.
+   */
+  enum LimitReference { AlwaysInside, NeverInside, PressureLimit, GroundLimit, StdLimit };
+
+  /**
+   * A vertical limit of the airspace with all unit conversions already done.
+   * The airspace is inside of the limit, if the related altitude is above a
+   * lower limit respectively below an upper limit.
+   */
+  struct VerticalLimit
+  {
+    LimitReference reference;
+    double         meters;
+  };
+
   Airspace();
 
   /**
@@ -94,12 +111,54 @@ public:
     return ( glConfig->isBorder(typeID) && isVisible() );
   };
 
+  /**
+   * Sets the polygon containing the projected positions of the airspace and
+   * creates the airspace region from it.
+   *
+   * \param newPolygon Polygon with projected coordinate points.
+   */
+  void setProjectedPolygon( const QPolygon& newPolygon )
+  {
+    LineElement::setProjectedPolygon( newPolygon );
+
+    m_airspaceRegion = QPainterPath();
+    m_airspaceRegion.addPolygon( projPolygon );
+    m_airspaceRegion.closeSubpath();
+  };
+
+  /**
+   * Defines the airspace as exact circle. The polygon is still used for the
+   * drawing but the point inside checks are done by a distance check.
+   *
+   * \param center The WGS84 coordinates of the circle center.
+   *
+   * \param radius The radius of the circle in meters.
+   */
+  void setCircle( const QPoint& center, const double radius )
+  {
+    m_circleCenter = center;
+    m_circleRadius = radius;
+  };
+
+  /**
+   * Returns true, if the airspace is an exact circle.
+   */
+  bool isCircle() const
+  {
+    return m_circleRadius > 0.0;
+  };
+
   /**
    * Returns true, if the passed WGS84 coordinate point lays inside the airspace
    * polygon.
    */
   bool isWgsPointInside( const QPoint& point )
   {
+    if( isCircle() )
+      {
+        return isInsideCircle( point );
+      }
+
     if( m_airspaceRegion.isEmpty() )
       {
         return false;
@@ -123,6 +182,38 @@ public:
     return m_airspaceRegion.contains( point );
   };
 
+  /**
+   * Returns true, if the passed point lays inside the airspace. Circular
+   * airspaces are checked with the WGS84 coordinates, all others with the
+   * projected coordinates.
+   */
+  bool isPointInside( const QPoint& wgsPoint, const QPoint& projPoint )
+  {
+    if( isCircle() )
+      {
+        return isInsideCircle( wgsPoint );
+      }
+
+    return isProjectedPointInside( projPoint );
+  };
+
+  /**
+   * Returns a hash of the WGS84 polygon, which was passed to the constructor.
+   * It does not change with the map projection.
+   */
+  const QByteArray& getWgsKey() const
+  {
+    return m_wgsKey;
+  };
+
+  /**
+   * Returns the bounding box of the projected airspace polygon.
+   */
+  const QRect& getBoundingBox() const
+  {
+    return bBox;
+  };
+
   /**
    * Draws the airspace into the given painter.
    * Return a pointer to the drawn region or 0.
@@ -234,6 +325,13 @@ public:
   ConflictType conflicts (const AltitudeCollection& alt,
                           const AirspaceWarningDistance& dist) const;
 
+  /**
+   * Returns the normalized lower and upper limits of the airspace. A point is
+   * inside the limits with the same result as \ref conflicts returns
+   * Inside for it.
+   */
+  void getVerticalLimits( VerticalLimit& lower, VerticalLimit& upper ) const;
+
   /*
    * Compares two items, in this case, Airspaces.
    * The items are compared on their levels. Because kflog provides a view
@@ -272,6 +370,13 @@ public:
   };
 
 private:
+
+  /**
+   * Returns true, if the distance of the WGS84 point to the circle center
+   * is not larger than the circle radius.
+   */
+  bool isInsideCircle( const QPoint& point ) const;
+
   /**
    * Contains the lower limit.
    * @see #getLowerL
@@ -300,10 +405,22 @@ private:
    */
   QPainterPath m_airspaceRegion;
 
+  /**
+   * Center in WGS84 coordinates and radius in meters of a circular airspace.
+   * The radius is zero, if the airspace is not a circle.
+   */
+  QPoint m_circleCenter;
+  double m_circleRadius;
+
   /**
    * Unique identifier used by openAip.
    */
   int m_id;
+
+  /**
+   * MD5 hash of the WGS84 polygon.
+   */
+  QByteArray m_wgsKey;
 };
 
 /**
@@ -198,6 +198,19 @@ void AirSpaceListViewItem::createChildren()
               subsubItem->setForeground( 0, col1 );
               subsubItem->setForeground( 1, col2 );
 
+              if( Violations[i].MaxPenetration() > 0.0 )
+                {
+                  Altitude penetration( double( Violations[i].MaxPenetration() ) );
+
+                  sl = (QStringList() << QObject::tr( "Penetration" )
+                                      << penetration.getText(true, 0) );
+
+                  subsubItem = new AirSpaceListViewItem::AirSpaceFlagListViewItem(subItem, sl, Violations[i], m_Flight );
+                  subsubItem->setFlags( Qt::ItemIsEnabled );
+                  subsubItem->setForeground( 0, col1 );
+                  subsubItem->setForeground( 1, col2 );
+                }
+
 #ifdef AIRSPACELISTVIEWITEM_EXTENDED_TRACE
               QString LastID;
               LastID.sprintf("%d",Violations[i].LastIndexPointinRoute());
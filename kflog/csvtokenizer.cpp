@@ -0,0 +1,495 @@
+/***********************************************************************
+**
+**   csvtokenizer.cpp
+**
+**   This file is part of KFLog.
+**
+************************************************************************
+**
+**   Copyright (c):  2026 by agent <agent@local>
+**
+**   This file is distributed under the terms of the General Public
+**   License. See the file COPYING for more information.
+**
+***********************************************************************/
+
+#include <cctype>
+#include <cmath>
+#include <cstring>
+
+#include <QtCore>
+
+#include "csvtokenizer.h"
+
+static inline bool isBlank( const char c )
+{
+  return c == ' ' || c == '\t';
+}
+
+bool CsvTokenizer::Field::contains( const char c ) const
+{
+  int upper = toupper( (uchar) c );
+
+  for( int i = 0; i < size; i++ )
+    {
+      if( toupper( (uchar) data[i] ) == upper )
+        {
+          return true;
+        }
+    }
+
+  return false;
+}
+
+bool CsvTokenizer::Field::equals( const char* text ) const
+{
+  return (int) strlen( text ) == size && qstrnicmp( data, text, size ) == 0;
+}
+
+CsvTokenizer::CsvTokenizer( const char* codec, const char separator ) :
+  m_codec(QTextCodec::codecForName( codec )),
+  m_separator(separator),
+  m_mapped(0),
+  m_pos(0),
+  m_end(0),
+  m_lineNo(0),
+  m_lineOk(true)
+{
+  if( m_codec == 0 )
+    {
+      m_codec = QTextCodec::codecForLocale();
+    }
+}
+
+CsvTokenizer::~CsvTokenizer()
+{
+  close();
+}
+
+bool CsvTokenizer::open( const QString& fileName )
+{
+  close();
+
+  m_file.setFileName( fileName );
+
+  if( ! m_file.open( QIODevice::ReadOnly ) )
+    {
+      return false;
+    }
+
+  qint64 size = m_file.size();
+
+  if( size > 0 )
+    {
+      m_mapped = m_file.map( 0, size );
+    }
+
+  if( m_mapped != 0 )
+    {
+      m_pos = reinterpret_cast<const char *>( m_mapped );
+      m_end = m_pos + size;
+    }
+  else
+    {
+      // Not mappable, e.g. a pipe. Read the whole file instead.
+      m_buffer = m_file.readAll();
+      m_pos    = m_buffer.constData();
+      m_end    = m_pos + m_buffer.size();
+    }
+
+  // Skip an UTF-8 byte order mark.
+  if( m_end - m_pos >= 3 && memcmp( m_pos, "\xef\xbb\xbf", 3 ) == 0 )
+    {
+      m_pos += 3;
+    }
+
+  m_lineNo = 0;
+  return true;
+}
+
+void CsvTokenizer::close()
+{
+  if( m_mapped != 0 )
+    {
+      m_file.unmap( m_mapped );
+      m_mapped = 0;
+    }
+
+  if( m_file.isOpen() )
+    {
+      m_file.close();
+    }
+
+  m_buffer.clear();
+  m_fields.clear();
+
+  m_pos = m_end = 0;
+}
+
+bool CsvTokenizer::readLine()
+{
+  if( m_pos == 0 || m_pos >= m_end )
+    {
+      return false;
+    }
+
+  m_fields.clear();
+  m_lineNo++;
+  m_lineOk = true;
+
+  // Search the end of the line, \n, \r\n and \r are accepted.
+  const char* begin = m_pos;
+  const char* end   = begin;
+
+  while( end < m_end && *end != '\n' && *end != '\r' )
+    {
+      end++;
+    }
+
+  m_pos = end;
+
+  if( m_pos < m_end && *m_pos == '\r' )
+    {
+      m_pos++;
+    }
+
+  if( m_pos < m_end && *m_pos == '\n' )
+    {
+      m_pos++;
+    }
+
+  // Trim the line.
+  while( begin < end && isBlank( *begin ) )
+    {
+      begin++;
+    }
+
+  while( end > begin && isBlank( *(end - 1) ) )
+    {
+      end--;
+    }
+
+  const char* p = begin;
+
+  while( true )
+    {
+      Field field;
+
+      while( p < end && isBlank( *p ) )
+        {
+          p++;
+        }
+
+      field.data = p;
+
+      if( p < end && *p == '"' )
+        {
+          // A quoted field can contain the separator.
+          field.quoted = true;
+          field.data   = ++p;
+
+          const char* quote = static_cast<const char *>( memchr( p, '"', end - p ) );
+
+          if( quote == 0 )
+            {
+              // Syntax error, the rest of the line is the last field.
+              m_lineOk   = false;
+              field.size = end - p;
+              m_fields.append( field );
+              return true;
+            }
+
+          field.size = quote - p;
+          p = quote + 1;
+        }
+
+      const char* sep = static_cast<const char *>( memchr( p, m_separator, end - p ) );
+
+      if( sep == 0 )
+        {
+          sep = end;
+        }
+
+      const char* last = sep;
+
+      while( last > p && isBlank( *(last - 1) ) )
+        {
+          last--;
+        }
+
+      if( ! field.quoted || last > p )
+        {
+          // Unquoted field or characters behind the closing quote, they
+          // belong to the field too.
+          field.size = last - field.data;
+        }
+
+      m_fields.append( field );
+
+      if( sep == end )
+        {
+          return true;
+        }
+
+      p = sep + 1;
+    }
+}
+
+QString CsvTokenizer::toString( const int index ) const
+{
+  const Field& f = field( index );
+
+  if( f.size == 0 )
+    {
+      return QString();
+    }
+
+  QString text = m_codec->toUnicode( f.data, f.size );
+
+  if( f.quoted )
+    {
+      text.remove( QChar('"') );
+    }
+
+  return text;
+}
+
+int CsvTokenizer::scanNumber( const char* begin, const char* end, double& value )
+{
+  const char* p = begin;
+  bool negative = false;
+
+  if( p < end && (*p == '-' || *p == '+') )
+    {
+      negative = (*p == '-');
+      p++;
+    }
+
+  double number = 0.0;
+  double scale  = 1.0;
+  int digits    = 0;
+
+  while( p < end && isdigit( (uchar) *p ) )
+    {
+      number = number * 10.0 + (*p++ - '0');
+      digits++;
+    }
+
+  if( p < end && *p == '.' )
+    {
+      p++;
+
+      while( p < end && isdigit( (uchar) *p ) )
+        {
+          number = number * 10.0 + (*p++ - '0');
+          scale *= 10.0;
+          digits++;
+        }
+    }
+
+  if( digits == 0 )
+    {
+      return 0;
+    }
+
+  value = negative ? -number / scale : number / scale;
+  return p - begin;
+}
+
+bool CsvTokenizer::toDouble( const Field& field, double& value )
+{
+  const char* p   = field.data;
+  const char* end = field.data + field.size;
+
+  while( p < end && isBlank( *p ) )
+    {
+      p++;
+    }
+
+  while( end > p && isBlank( *(end - 1) ) )
+    {
+      end--;
+    }
+
+  int n = scanNumber( p, end, value );
+
+  return n > 0 && p + n == end;
+}
+
+bool CsvTokenizer::toInt( const Field& field, int& value )
+{
+  double number;
+
+  if( ! toDouble( field, number ) || number != floor( number ) ||
+      fabs( number ) > 2147483647.0 )
+    {
+      return false;
+    }
+
+  value = (int) number;
+  return true;
+}
+
+bool CsvTokenizer::toCoordinate( const Field& field, const int degreeDigits, int& value )
+{
+  const char* p   = field.data;
+  const char* end = field.data + field.size;
+
+  while( p < end && isBlank( *p ) )
+    {
+      p++;
+    }
+
+  while( end > p && isBlank( *(end - 1) ) )
+    {
+      end--;
+    }
+
+  if( end - p < degreeDigits + 1 )
+    {
+      return false;
+    }
+
+  double degree = 0.0;
+
+  for( int i = 0; i < degreeDigits; i++, p++ )
+    {
+      if( ! isdigit( (uchar) *p ) )
+        {
+          return false;
+        }
+
+      degree = degree * 10.0 + (*p - '0');
+    }
+
+  if( *p == ':' )
+    {
+      p++;
+    }
+
+  double minutes = 0.0;
+  double seconds = 0.0;
+
+  if( p < end && (*p == '-' || *p == '+') )
+    {
+      return false;
+    }
+
+  int n = scanNumber( p, end, minutes );
+
+  if( n == 0 )
+    {
+      return false;
+    }
+
+  p += n;
+
+  if( p < end && *p == ':' )
+    {
+      p++;
+
+      if( p < end && (*p == '-' || *p == '+') )
+        {
+          return false;
+        }
+
+      n = scanNumber( p, end, seconds );
+
+      if( n == 0 )
+        {
+          return false;
+        }
+
+      p += n;
+    }
+
+  bool negative = false;
+
+  if( p < end )
+    {
+      switch( toupper( (uchar) *p ) )
+        {
+          case 'N':
+          case 'E':
+            break;
+          case 'S':
+          case 'W':
+            negative = true;
+            break;
+          default:
+            return false;
+        }
+
+      p++;
+    }
+
+  if( p != end )
+    {
+      return false;
+    }
+
+  double coord = (degree * 600000.) + (10000. * (minutes + seconds / 60.));
+
+  value = (int) rint( negative ? -coord : coord );
+  return true;
+}
+
+bool CsvTokenizer::toMeters( const Field& field, float& value )
+{
+  const char* p   = field.data;
+  const char* end = field.data + field.size;
+
+  while( p < end && isBlank( *p ) )
+    {
+      p++;
+    }
+
+  while( end > p && isBlank( *(end - 1) ) )
+    {
+      end--;
+    }
+
+  double number;
+  int n = scanNumber( p, end, number );
+
+  if( n == 0 )
+    {
+      return false;
+    }
+
+  p += n;
+
+  while( p < end && isBlank( *p ) )
+    {
+      p++;
+    }
+
+  Field unit;
+  unit.data = p;
+  unit.size = end - p;
+
+  if( unit.equals( "m" ) )
+    {
+      value = number;
+    }
+  else if( unit.equals( "ft" ) || unit.equals( "f" ) )
+    {
+      value = number * 0.3048;
+    }
+  else if( unit.equals( "nm" ) )
+    {
+      // nautical miles
+      value = number * 1852;
+    }
+  else if( unit.equals( "ml" ) )
+    {
+      // statute miles
+      value = number * 1609.34;
+    }
+  else
+    {
+      return false;
+    }
+
+  return true;
+}
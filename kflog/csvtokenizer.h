@@ -0,0 +1,209 @@
+/***********************************************************************
+**
+**   csvtokenizer.h
+**
+**   This file is part of KFLog.
+**
+************************************************************************
+**
+**   Copyright (c):  2026 by agent <agent@local>
+**
+**   This file is distributed under the terms of the General Public
+**   License. See the file COPYING for more information.
+**
+***********************************************************************/
+
+/**
+ * \class CsvTokenizer
+ *
+ * \author agent
+ *
+ * \brief Splits the lines of a comma separated text file into fields.
+ *
+ * The file is mapped into the memory and is split line by line. A field
+ * refers to its characters in the mapped file, no strings are created for
+ * it. String elements can be enclosed in quotation marks, a separator
+ * inside of them does not end the field. The static parsers convert fields
+ * directly into numbers, coordinates and lengths. Only the fields, which
+ * are needed as text, have to be decoded by toString().
+ *
+ * \date 2026
+ *
+ * \version 1.0
+ */
+
+#ifndef CSV_TOKENIZER_H
+#define CSV_TOKENIZER_H
+
+#include <QByteArray>
+#include <QFile>
+#include <QString>
+#include <QVarLengthArray>
+
+class QTextCodec;
+
+class CsvTokenizer
+{
+ public:
+
+  /** A field of the current line. */
+  class Field
+  {
+   public:
+
+    Field() :
+      data(0),
+      size(0),
+      quoted(false)
+    {};
+
+    bool isEmpty() const
+    {
+      return size == 0;
+    };
+
+    /** \return True, if the field starts with the character. */
+    bool startsWith( const char c ) const
+    {
+      return size > 0 && data[0] == c;
+    };
+
+    /** \return True, if the field contains the character, case insensitive. */
+    bool contains( const char c ) const;
+
+    /** \return True, if the field is equal to text, case insensitive. */
+    bool equals( const char* text ) const;
+
+    /** First character of the field, quotation marks are excluded */
+    const char* data;
+
+    /** Number of characters */
+    int size;
+
+    /** True, if the field was enclosed in quotation marks */
+    bool quoted;
+  };
+
+  /**
+   * \param codec Name of the text codec of the file
+   *
+   * \param separator Separator of the fields
+   */
+  CsvTokenizer( const char* codec="ISO 8859-15", const char separator=',' );
+
+  virtual ~CsvTokenizer();
+
+  /**
+   * Opens the file. It is mapped into the memory, if possible, otherwise
+   * it is read completely.
+   *
+   * \return True in case of success.
+   */
+  bool open( const QString& fileName );
+
+  void close();
+
+  /**
+   * Reads the next line and splits it into fields. Leading and trailing
+   * white spaces of the line and of unquoted fields are removed.
+   *
+   * \return False at the end of the file.
+   */
+  bool readLine();
+
+  /** \return The number of the current line, starting with 1. */
+  int lineNumber() const
+  {
+    return m_lineNo;
+  };
+
+  /** \return True, if the current line contains no characters. */
+  bool isEmptyLine() const
+  {
+    return m_fields.size() == 1 && m_fields[0].isEmpty();
+  };
+
+  /** \return False, if the current line contains an unclosed quotation. */
+  bool isLineOk() const
+  {
+    return m_lineOk;
+  };
+
+  /** \return The number of fields of the current line. */
+  int count() const
+  {
+    return m_fields.size();
+  };
+
+  /** \return The field or an empty field, if the index is out of range. */
+  const Field& field( const int index ) const
+  {
+    return ( index >= 0 && index < m_fields.size() ) ? m_fields[index] : m_empty;
+  };
+
+  /**
+   * \return The decoded text of a field. Remaining quotation marks inside of
+   * a quoted field are removed.
+   */
+  QString toString( const int index ) const;
+
+  /**
+   * Converts a field into a number. White spaces around the number are
+   * allowed.
+   *
+   * \return True, if the complete field is a number.
+   */
+  static bool toDouble( const Field& field, double& value );
+
+  /** Converts a field into an integer, see toDouble(). */
+  static bool toInt( const Field& field, int& value );
+
+  /**
+   * Converts a coordinate into the KFLog format. Accepted are degrees with
+   * the passed number of digits, followed by decimal minutes or by minutes
+   * and seconds, optionally separated by colons, and the hemisphere. The
+   * formats are ddmm.mmmN (SeeYou), dd:mm.mmmN and dd:mm:ssN (Cambridge).
+   * S and W give negative values.
+   *
+   * \return True, if the field is a valid coordinate.
+   */
+  static bool toCoordinate( const Field& field, const int degreeDigits, int& value );
+
+  /**
+   * Converts a length with unit into meters. The units m, ft, f, nm and ml
+   * are accepted case insensitive.
+   *
+   * \return True, if the field contains a number and a known unit.
+   */
+  static bool toMeters( const Field& field, float& value );
+
+ private:
+
+  Q_DISABLE_COPY ( CsvTokenizer )
+
+  /**
+   * Scans a decimal number without exponent.
+   *
+   * \return The number of scanned characters, 0 if there is no number.
+   */
+  static int scanNumber( const char* begin, const char* end, double& value );
+
+  QTextCodec* m_codec;
+  char        m_separator;
+
+  QFile       m_file;
+  uchar*      m_mapped;
+
+  /** Used, if the file cannot be mapped */
+  QByteArray  m_buffer;
+
+  const char* m_pos;
+  const char* m_end;
+  int         m_lineNo;
+  bool        m_lineOk;
+
+  QVarLengthArray<Field, 16> m_fields;
+  Field                      m_empty;
+};
+
+#endif
@@ -0,0 +1,159 @@
+/***********************************************************************
+**
+**   curvesmoother.cpp
+**
+**   This file is part of KFLog.
+**
+************************************************************************
+**
+**   Copyright (c):  2026 by agent <agent@local>
+**
+**   This file is distributed under the terms of the General Public
+**   License. See the file COPYING for more information.
+**
+***********************************************************************/
+
+#include "curvesmoother.h"
+#include "flight.h"
+#include "flightpoint.h"
+
+CurveSmoother::CurveSmoother() :
+  m_flight(0)
+{
+}
+
+CurveSmoother::~CurveSmoother()
+{
+}
+
+void CurveSmoother::clear()
+{
+  m_flight = 0;
+  m_times.clear();
+
+  for( int i = 0; i < SeriesCount; i++ )
+    {
+      m_raw[i].clear();
+      m_prefix[i].clear();
+      m_cache[i].clear();
+    }
+}
+
+void CurveSmoother::setFlight( Flight* flight )
+{
+  if( flight == 0 )
+    {
+      clear();
+      return;
+    }
+
+  QList<FlightPoint*>& route = flight->getRoute();
+  const int n = route.size();
+
+  if( flight == m_flight && n == m_times.size() )
+    {
+      // Only the surface heights can change later on.
+      QVector<double>& elev = m_raw[Elevation];
+      bool changed = false;
+
+      for( int i = 0; i < n; i++ )
+        {
+          double value = route.at(i)->surfaceHeight;
+
+          if( elev[i] != value )
+            {
+              elev[i] = value;
+              changed = true;
+            }
+        }
+
+      if( changed )
+        {
+          prepareSeries( Elevation );
+        }
+
+      return;
+    }
+
+  clear();
+  m_flight = flight;
+
+  m_times.resize( n );
+
+  for( int i = 0; i < SeriesCount; i++ )
+    {
+      m_raw[i].resize( n );
+    }
+
+  time_t startTime = flight->getStartTime();
+
+  for( int i = 0; i < n; i++ )
+    {
+      const FlightPoint* fp = route.at(i);
+
+      time_t t = fp->time;
+
+      // Correct time for overnight-flights:
+      if( t < startTime )
+        {
+          t += 86400;
+        }
+
+      m_times[i] = t;
+
+      // dT is never zero, see Flight::__calculateBasicInformation
+      m_raw[Baro][i]      = fp->height;
+      m_raw[Elevation][i] = fp->surfaceHeight;
+      m_raw[Speed][i]     = (float) fp->dS / (float) fp->dT * 3.6;
+      m_raw[Vario][i]     = (float) fp->dH / (float) fp->dT;
+    }
+
+  for( int i = 0; i < SeriesCount; i++ )
+    {
+      prepareSeries( i );
+    }
+}
+
+void CurveSmoother::prepareSeries( const int series )
+{
+  const QVector<double>& raw = m_raw[series];
+  QVector<double>& prefix = m_prefix[series];
+
+  prefix.resize( raw.size() + 1 );
+  prefix[0] = 0.0;
+
+  for( int i = 0; i < raw.size(); i++ )
+    {
+      prefix[i + 1] = prefix[i] + raw[i];
+    }
+
+  m_cache[series].clear();
+}
+
+const QVector<double>& CurveSmoother::smoothed( const Series series, const int smoothness )
+{
+  QMap<int, QVector<double> >& cache = m_cache[series];
+
+  QMap<int, QVector<double> >::iterator it = cache.find( smoothness );
+
+  if( it != cache.end() )
+    {
+      return it.value();
+    }
+
+  const int n = m_raw[series].size();
+  const double* prefix = m_prefix[series].constData();
+
+  QVector<double> result( n );
+  double* out = result.data();
+
+  for( int i = 0; i < n; i++ )
+    {
+      // Reduce the window at both ends, so that it stays centered.
+      int h = qMin( smoothness, qMin( i, n - 1 - i ) );
+
+      out[i] = (prefix[i + h + 1] - prefix[i - h]) / (2 * h + 1);
+    }
+
+  return cache.insert( smoothness, result ).value();
+}
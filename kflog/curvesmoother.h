@@ -0,0 +1,120 @@
+/***********************************************************************
+**
+**   curvesmoother.h
+**
+**   This file is part of KFLog.
+**
+************************************************************************
+**
+**   Copyright (c):  2026 by agent <agent@local>
+**
+**   This file is distributed under the terms of the General Public
+**   License. See the file COPYING for more information.
+**
+***********************************************************************/
+
+/**
+ * \class CurveSmoother
+ *
+ * \author agent
+ *
+ * \brief Moving average engine for the curves of the flight evaluation.
+ *
+ * The raw values of a flight are copied once into columns. For every column
+ * a prefix sum array is built, so that the average of any window is
+ * calculated with one subtraction, independent of the window size. The
+ * smoothed series are cached per smoothness value.
+ *
+ * The window of point i covers the points i-h...i+h, where h is the
+ * smoothness. At the begin and at the end of the flight h is reduced, so
+ * that the window stays centered.
+ *
+ * \date 2026
+ *
+ * \version 1.0
+ */
+
+#ifndef CURVE_SMOOTHER_H
+#define CURVE_SMOOTHER_H
+
+#include <ctime>
+
+#include <QMap>
+#include <QVector>
+
+class Flight;
+
+class CurveSmoother
+{
+ public:
+
+  enum Series { Baro = 0, Elevation = 1, Speed = 2, Vario = 3, SeriesCount = 4 };
+
+  CurveSmoother();
+
+  virtual ~CurveSmoother();
+
+  /**
+   * Assigns a flight. The raw columns are only loaded again, if the flight
+   * has been changed. The elevation column is checked on every call, because
+   * the surface heights are filled in later on during map drawing.
+   *
+   * \param flight Flight to be used, can be null.
+   */
+  void setFlight( Flight* flight );
+
+  /**
+   * \return The number of points of the assigned flight.
+   */
+  int size() const
+  {
+    return m_times.size();
+  };
+
+  /**
+   * \return The fix times of the assigned flight, corrected for flights over
+   *         midnight.
+   */
+  const QVector<time_t>& times() const
+  {
+    return m_times;
+  };
+
+  /**
+   * Returns the smoothed series. It is calculated on the first request
+   * and cached for later requests.
+   *
+   * \param series Series to be returned
+   *
+   * \param smoothness Number of points used at each side of a point
+   *
+   * \return The smoothed series.
+   */
+  const QVector<double>& smoothed( const Series series, const int smoothness );
+
+  /**
+   * Removes all data.
+   */
+  void clear();
+
+ private:
+
+  /**
+   * Builds the prefix sum array of a series and removes its cached data.
+   */
+  void prepareSeries( const int series );
+
+  Flight* m_flight;
+
+  QVector<time_t> m_times;
+
+  QVector<double> m_raw[SeriesCount];
+
+  /** Prefix sums, element k contains the sum of the raw elements 0...k-1. */
+  QVector<double> m_prefix[SeriesCount];
+
+  /** Smoothed series, cached per smoothness value. */
+  QMap<int, QVector<double> > m_cache[SeriesCount];
+};
+
+#endif
@@ -350,6 +350,8 @@ void DataView::slotSetFlightData()
 
           if(fl.count())
             {
+              const QVector<int>& gaggleTimes = fg->getGaggleTimes();
+
               htmlText +=
                   "<TABLE BORDER=0 CELLPADDING=0 CELLSPACING=0>\
                   <TR><TD COLSPAN=3 BGCOLOR=#BBBBBB><B>" +
@@ -369,7 +371,9 @@ void DataView::slotSetFlightData()
                       flight->getDate() + "</TD></TR>\
                       <TR><TD>" + flight->getDistance() + "</TD><TD ALIGN=right>" +
                       printTime(flight->getLandTime() - flight->getStartTime()) +
-                      "</TD></TR>";
+                      "</TD></TR>\
+                      <TR><TD>" + tr("In gaggle") + ":</TD><TD ALIGN=right>" +
+                      printTime(gaggleTimes.value(loop)) + "</TD></TR>";
               }
             }
           else
@@ -17,7 +17,7 @@
 
 /**
  * This class is a HTTP download manager. It processes download requests
- * in their incoming order one by one but not in parallel.
+ * in their incoming order, up to MaxParallel of them in parallel.
  */
 
 #ifndef _WIN32
@@ -35,6 +35,8 @@
 
 const double DownloadManager::MinFsSpace = 25.0; // 25MB
 
+const int DownloadManager::MaxParallel = 4;
+
 QSet<QString> DownloadManager::blackList;
 QSet<QString> DownloadManager::logList;
 
@@ -43,15 +45,10 @@ QSet<QString> DownloadManager::logList;
  */
 DownloadManager::DownloadManager( QObject *parent ) :
   QObject(parent),
-  client(0),
-  downloadRunning(false),
+  canceled(false),
   requests(0),
   errors(0)
 {
-  client = new HttpClient(this, false);
-
-  connect( client, SIGNAL( finished(QString &, QNetworkReply::NetworkError) ),
-           this, SLOT( slotFinished(QString &, QNetworkReply::NetworkError) ));
 }
 
 /**
@@ -60,14 +57,11 @@ DownloadManager::DownloadManager( QObject *parent ) :
  */
 bool DownloadManager::downloadRequest( QString &url, QString &destination )
 {
-  mutex.lock();
-
   // Check input parameters. If url was already requested the download
   // is rejected.
-  if( url.isEmpty() || urlSet.contains(url) || destination.isEmpty() ||
-      blackList.contains(url) )
+  if( canceled || url.isEmpty() || urlSet.contains(url) ||
+      destination.isEmpty() || blackList.contains(url) )
     {
-      mutex.unlock();
       return false;
     }
 
@@ -76,48 +70,79 @@ bool DownloadManager::downloadRequest( QString &url, QString &destination )
       // That shall prevent the repeated download of wrong map files.
       qWarning( "DownloadManager(%d): %s already downloaded. Request is rejected!",
                 __LINE__, url.toLatin1().data() );
-      mutex.unlock();
       return false;
     }
 
+  // The free space of the destination file system is checked, when the
+  // download is started.
+  QPair<QString, QString> pair( url, destination );
+
+  if( runningClients.size() < MaxParallel )
+    {
+      // A client is free, do start the download
+      if( startDownload( pair ) == false )
+        {
+          return false;
+        }
+    }
+  else
+    {
+      // Insert request in queue.
+      queue.enqueue( pair );
+    }
+
+  urlSet.insert( url );
+  requests++;
+  return true;
+}
+
+/**
+ * Starts the download of the passed request by a free HTTP client.
+ */
+bool DownloadManager::startDownload( const QPair<QString, QString>& request )
+{
+  QString url = request.first;
+  QString destination = request.second;
+
   QString destDir = QFileInfo(destination).absolutePath();
 
-  // Check free size of destination file system. If size is less than 25MB the
-  // download is rejected.
+  // Check free size of destination file system. If size is less than 25MB
+  // the download is not executed.
   if( getFreeUserSpace( destDir ) < MinFsSpace )
     {
       qWarning( "DownloadManager(%d): Free space on %s less than %lfMB!",
                 __LINE__, destDir.toLatin1().data(), MinFsSpace/(1024*1024) );
-
-      mutex.unlock();
       return false;
     }
 
-  if( downloadRunning == false )
+  HttpClient *client;
+
+  if( idleClients.isEmpty() )
     {
-      // No download is running, do start the next one
-      if( client->downloadFile( url, destination ) == false )
-        {
-          qWarning( "DownloadManager(%d): Download of '%s' failed!",
-                     __LINE__, url.toLatin1().data() );
+      client = new HttpClient(this, false);
 
-          // Start of download failed.
-          mutex.unlock();
-          return false;
-        }
+      connect( client, SIGNAL( finished(QString &, QNetworkReply::NetworkError) ),
+               this, SLOT( slotFinished(QString &, QNetworkReply::NetworkError) ));
+    }
+  else
+    {
+      client = idleClients.takeFirst();
+    }
 
-      QString destFile = QFileInfo(destination).fileName();
-      emit status( tr("downloading %1").arg(destFile) );
-      downloadRunning = true;
+  if( client->downloadFile( url, destination ) == false )
+    {
+      // Start of download failed.
+      qWarning( "DownloadManager(%d): Download of '%s' failed!",
+                 __LINE__, url.toLatin1().data() );
+
+      idleClients.append( client );
+      return false;
     }
 
-  // Insert request in queue.
-  urlSet.insert( url );
-  QPair<QString, QString> pair( url, destination );
-  queue.enqueue( pair );
-  requests++;
+  runningClients.insert( client, request );
 
-  mutex.unlock();
+  QString destFile = QFileInfo(destination).fileName();
+  emit status( tr("downloading %1").arg(destFile) );
   return true;
 }
 
@@ -127,7 +152,24 @@ bool DownloadManager::downloadRequest( QString &url, QString &destination )
  */
 void DownloadManager::slotFinished( QString &urlIn, QNetworkReply::NetworkError codeIn )
 {
-  mutex.lock();
+  HttpClient *client = qobject_cast<HttpClient *>( sender() );
+
+  if( client == 0 || ! runningClients.contains( client ) )
+    {
+      return;
+    }
+
+  QPair<QString, QString> pair = runningClients.take( client );
+  idleClients.append( client );
+
+  // Remove last done request from the url set.
+  urlSet.remove( urlIn );
+
+  if( canceled )
+    {
+      // A download aborted by a network error of another one.
+      return;
+    }
 
   if( codeIn != QNetworkReply::NoError && codeIn != QNetworkReply::ContentNotFoundError )
     {
@@ -139,11 +181,19 @@ void DownloadManager::slotFinished( QString &urlIn, QNetworkReply::NetworkError
       qWarning( "DownloadManager(%d): Network problem occurred, canceling of all downloads!",
                 __LINE__ );
 
+      canceled = true;
       queue.clear();
       urlSet.clear();
-      downloadRunning = false;
+
+      // The aborted downloads keep their partial files for a later resume.
+      QList<HttpClient *> running = runningClients.keys();
+
+      for( int i = 0; i < running.size(); i++ )
+        {
+          running.at(i)->slotCancelDownload();
+        }
+
       emit networkError();
-      mutex.unlock();
       return;
     }
 
@@ -162,76 +212,31 @@ void DownloadManager::slotFinished( QString &urlIn, QNetworkReply::NetworkError
     {
       // Store download url in log list.
       logList.insert( urlIn );
+
+      if( client->isFileChanged() )
+        {
+          changed.append( pair.second );
+        }
     }
 
-  // Remove the last done request from the queue and from the url set.
-  if( ! queue.isEmpty() )
+  // Start the next downloads from the queue.
+  while( ! queue.isEmpty() && runningClients.size() < MaxParallel )
     {
-      QPair<QString, QString> pair = queue.dequeue();
-    }
+      QPair<QString, QString> next = queue.dequeue();
 
-  // Remove last done request from the url set.
-  urlSet.remove( urlIn );
+      if( startDownload( next ) == false )
+        {
+          errors++;
+          urlSet.remove( next.first );
+        }
+    }
 
-  if( queue.isEmpty() )
+  if( runningClients.isEmpty() )
     {
       // No more entries in queue. All downloads are finished.
-      downloadRunning = false;
       emit status( tr("Downloads finished") );
       emit finished( requests, errors );
-      mutex.unlock();
-      return;
-    }
-
-  // Get next request from the queue
-  QPair<QString, QString> pair = queue.head();
-
-  QString url = pair.first;
-  QString destination = pair.second;
-
-  QString destDir = QFileInfo(destination).absolutePath();
-
-  // Check free size of destination file system. If size is less than 25MB the
-  // download is not executed.
-  if( getFreeUserSpace( destDir ) < MinFsSpace )
-    {
-      qWarning( "DownloadManager(%d): Free space on %s less than %lfMB!",
-                __LINE__, destDir.toLatin1().data(), MinFsSpace/(1024*1024) );
-
-      mutex.unlock();
-
-      // We simulate an operation cancel error, if the file system has
-      // not enough space available.
-      slotFinished( url, QNetworkReply::OperationCanceledError );
-      return;
     }
-
-#ifndef _WIN32
-  sleep(1); // make a short break
-#else
-  Sleep(1000); // make a short break - Sleep() takes milliseconds
-#endif
-
-  // Start the next download.
-  if( client->downloadFile( url, destination ) == false )
-    {
-    // Start of download failed.
-      qWarning( "DownloadManager(%d): Download of '%s' failed!",
-                 __LINE__, url.toLatin1().data() );
-
-      mutex.unlock();
-
-      // We simulate an operation cancel error, if download
-      // could not be started.
-      slotFinished( url, QNetworkReply::OperationCanceledError );
-      return;
-    }
-
-  QString destFile = QFileInfo(destination).fileName();
-  emit status( tr("downloading %1").arg(destFile) );
-
-  mutex.unlock();
-  return;
 }
 
 #ifndef _WIN32
@@ -23,7 +23,10 @@
  * \brief Manager for HTTP download handling
  *
  * This class handles the HTTP download requests in Cumulus. Downloads
- * of different map files can be requested.
+ * of different map files can be requested. Up to MaxParallel downloads
+ * are executed at the same time, each by its own HTTP client. Files, which
+ * are not modified on the server, are not transferred again. The changed
+ * files are reported, so that only their dependent data must be reloaded.
  *
  * \date 2010-2012
  */
@@ -56,6 +59,15 @@ class DownloadManager : public QObject
    */
   bool downloadRequest( QString &url, QString &destination );
 
+  /**
+   * Returns the destinations of the files, which were replaced by a newer
+   * version from the server.
+   */
+  const QStringList& changedFiles() const
+  {
+    return changed;
+  };
+
   signals:
 
    /** Sends out a status message. */
@@ -84,6 +96,12 @@ class DownloadManager : public QObject
    */
   double getFreeUserSpace( QString& path );
 
+  /**
+   * Starts the download of the passed url and destination pair by a free
+   * HTTP client. Returns false, if the download could not be started.
+   */
+  bool startDownload( const QPair<QString, QString>& request );
+
  private slots:
 
   /** Catch a finish signal with the downloaded url and the related result. */
@@ -91,11 +109,14 @@ class DownloadManager : public QObject
 
  private:
 
-  /** HTTP download client */
-  HttpClient *client;
+  /** HTTP download clients without a running download */
+  QList<HttpClient *> idleClients;
+
+  /** HTTP download clients with a running download and their request */
+  QHash<HttpClient *, QPair<QString, QString> > runningClients;
 
-  /** Download working flag */
-  bool downloadRunning;
+  /** Set, if all downloads are canceled due to a network error. */
+  bool canceled;
 
   /** Set of urls to be downloaded, used for fast checks */
   QSet<QString> urlSet;
@@ -105,15 +126,18 @@ class DownloadManager : public QObject
    */
   QQueue< QPair<QString, QString> > queue;
 
-  /** Mutex to protect data accesses. */
-  QMutex mutex;
-
   /** Counter for download request. */
   int requests;
 
   /** Counter for download errors. */
   int errors;
 
+  /** Destinations of the replaced files. */
+  QStringList changed;
+
+  /** Maximum number of parallel downloads. */
+  static const int MaxParallel;
+
   /**
    * Required minimum space in bytes on file system destination to
    * execute the download request.
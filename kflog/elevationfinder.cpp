@@ -53,6 +53,28 @@ ElevationFinder* ElevationFinder::instance()
   return &instance;
 }
 
+QByteArray ElevationFinder::sourceKey() const
+{
+  if( ! useOGIE )
+    {
+      return QByteArray();
+    }
+
+  QFileInfo fi( demFileName );
+
+  QByteArray key = demFileName.toUtf8();
+
+  key += ":" + QByteArray::number( fi.size() ) +
+         ":" + QByteArray::number( fi.lastModified().toMSecsSinceEpoch() );
+
+  key += ":" + QByteArray::number( demTL.x() ) + "," + QByteArray::number( demTL.y() ) +
+         ":" + QByteArray::number( demBR.x() ) + "," + QByteArray::number( demBR.y() ) +
+         ":" + QByteArray::number( demRows ) + "," + QByteArray::number( demCols ) +
+         ":" + QByteArray::number( demGridLat ) + "," + QByteArray::number( demGridLon );
+
+  return key;
+}
+
 int ElevationFinder::elevationWgs(const QPoint& coordinates)
 {
   if( useOGIE ) //use openGLIGCexplorer's DEM file
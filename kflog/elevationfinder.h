@@ -19,6 +19,7 @@
 #ifndef ELEVATION_FINDER_H
 #define ELEVATION_FINDER_H
 
+#include <QByteArray>
 #include <QObject>
 #include <QPoint>
 #include <QTimer>
@@ -91,6 +92,12 @@ class ElevationFinder : public QObject
    * @returns true if KFLog we rely on the isohypses to find the elevation for a position.
    */
   bool useIsohypseForElevation() {return !useOGIE;};
+  /**
+   * @returns A key of the elevation source, which changes, if the DEM file or
+   * its configuration is changed. The key is empty, if the isohypses are used,
+   * because their results depend on the isolines of the current map view.
+   */
+  QByteArray sourceKey() const;
 
 private slots:
 
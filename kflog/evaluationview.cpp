@@ -188,7 +188,7 @@ void EvaluationView::mouseReleaseEvent(QMouseEvent* event)
     evalDialog->updateText(flight->getPointIndexByTime(cursor1),
                            flight->getPointIndexByTime(cursor2), true);
 
-    __draw();
+    __drawOverlay();
 
     // Reset mouse cursors, if the new end position is reached.
     pixBufferMouse = QPixmap();
@@ -285,81 +285,11 @@ void EvaluationView::slotSetCursors(Flight* theFlight, time_t NewCursor1, time_t
         evalDialog->updateText( flight->getPointIndexByTime(cursor1),
                                 flight->getPointIndexByTime(cursor2),
                                 true );
-        __draw();
+        __drawOverlay();
         repaint();
     }
 }
 
-QPoint EvaluationView::__baroPoint(int durch[], int gn, int i)
-{
-  int height = scrollFrame->viewport()->height();
-
-  int x = ( curTime - startTime ) / secWidth + X_DISTANCE ;
-
-  int gesamt = 0;
-
-  for(int loop = 0; loop < qMin(gn, (i * 2 + 1)); loop++)
-    {
-      gesamt += durch[loop];
-    }
-
-  int y = height - (int)( ( gesamt / qMin(gn, (i * 2 + 1)) ) / scale_h ) - Y_DISTANCE;
-
-  return QPoint(x, y);
-}
-
-void EvaluationView::_addBaroPoint( QPolygonF& vector, int baro_d[], int gn, int i)
-{
-  int x = ( curTime - startTime ) / secWidth + X_DISTANCE ;
-
-  float gesamt = 0.0;
-
-  for(int loop = 0; loop < qMin(gn, (i * 2 + 1)); loop++)
-    {
-      gesamt += baro_d[loop];
-    }
-
-  qreal y = gesamt / qMin(gn, (i * 2 + 1));
-
-  // Note the y value is not yet scaled.
-  vector.append( QPointF(x, y) );
-}
-
-void EvaluationView::_addSpeedPoint( QPolygonF& vector, float speed_d[], int gn, int i)
-{
-  int x = ( curTime - startTime ) / secWidth + X_DISTANCE ;
-
-  float gesamt = 0.0;
-
-  for(int loop = 0; loop < qMin(gn, (i * 2 + 1)); loop++)
-    {
-      gesamt += speed_d[loop];
-    }
-
-  qreal y = gesamt / qMin(gn, (i *  2 + 1));
-
-  // Note the y value is not yet scaled.
-  vector.append( QPointF(x, y) );
-}
-
-
-void EvaluationView::_addVarioPoint( QPolygonF& vector, float vario_d[], int gn, int i )
-{
-  int x = ( curTime - startTime ) / secWidth + X_DISTANCE ;
-
-  float gesamt = 0.0;
-
-  for(int loop = 0; loop < qMin(gn, (i * 2 + 1)); loop++)
-    {
-      gesamt += vario_d[loop];
-    }
-
-  qreal y = ( gesamt / qMin(gn, (i * 2 + 1)) );
-
-  // Note the y value is not yet scaled.
-  vector.append( QPointF(x, y) );
-}
-
 void EvaluationView::__drawCsystem(QPainter* painter)
 {
   pixBufferYAxis.fill(Qt::white);
@@ -568,6 +498,7 @@ void EvaluationView::drawCurve( bool arg_vario,
       // Can become zero if the splitter is moved up to the upper
       // end in the EvaluationDialog.
       pixBufferKurve = QPixmap();
+      pixBufferCurves = QPixmap();
       pixBufferYAxis = QPixmap();
       return;
     }
@@ -613,11 +544,13 @@ void EvaluationView::drawCurve( bool arg_vario,
       resize( maxWidth, scrollFrame->viewport()->height() );
 
       // Resize pixmaps to the needed size.
-      pixBufferKurve = QPixmap( width, scrollFrame->viewport()->height() );
-      pixBufferYAxis = QPixmap( COORD_DISTANCE + 1, scrollFrame->viewport()->height() );
+      pixBufferKurve  = QPixmap( width, scrollFrame->viewport()->height() );
+      pixBufferCurves = QPixmap( width, scrollFrame->viewport()->height() );
+      pixBufferYAxis  = QPixmap( COORD_DISTANCE + 1, scrollFrame->viewport()->height() );
 
       // Clear pixmaps.
       pixBufferKurve.fill( Qt::white );
+      pixBufferCurves.fill( Qt::white );
       pixBufferYAxis.fill( Qt::white );
 
       vario = arg_vario;
@@ -635,6 +568,7 @@ void EvaluationView::drawCurve( bool arg_vario,
       // Clear pixmaps, if no flight is assigned.
       pixBufferKurve.fill( Qt::white );
       pixBufferYAxis.fill( Qt::white );
+      pixBufferCurves = QPixmap();
     }
 
   repaint();
@@ -659,221 +593,168 @@ void EvaluationView::__draw()
       scale_va = double(varioScale) / ((double)(height - 2*Y_DISTANCE) / 2.0);
     }
 
-  unsigned int gn_v  = smoothness_v * 2 + 1;
-  unsigned int gn_va = smoothness_va * 2 + 1;
-  unsigned int gn_h  = smoothness_h * 2 + 1;
+  // The flight data are loaded only once by the smoother. The smoothed
+  // curves are cached per smoothness value.
+  smoother.setFlight( flight );
 
-  int *baro_d      = new int[gn_h];
-  int *baro_d_last = new int[gn_h];
+  const int points = smoother.size();
 
-  int *elev_d      = new int[gn_h];
-  int *elev_d_last = new int[gn_h];
+  if( points == 0 )
+    {
+      return;
+    }
 
-  float *speed_d      = new float[gn_v];
-  float *speed_d_last = new float[gn_v];
+  const time_t* times = smoother.times().constData();
 
-  float *vario_d      = new float[gn_va];
-  float *vario_d_last = new float[gn_va];
+  // The x positions are the same for all curves.
+  QVector<qreal> xpos( points );
 
-  for(unsigned int loop = 0; baro && loop < gn_h; loop++)
+  for( int i = 0; i < points; i++ )
     {
-      baro_d[loop]      = flight->getPoint(loop).height;
-      baro_d_last[loop] = flight->getPoint(flight->getRouteLength() - loop - 1).height;
-      elev_d[loop]      = flight->getPoint(loop).surfaceHeight;
-      elev_d_last[loop] = flight->getPoint(flight->getRouteLength() - loop - 1).surfaceHeight;
+      xpos[i] = ( times[i] - startTime ) / secWidth + X_DISTANCE;
     }
 
-  for(unsigned int loop = 0; speed && loop < gn_v; loop++)
-    {
-      speed_d[loop]      = getSpeed(flight->getPoint(loop));
-      speed_d_last[loop] = getSpeed(flight->getPoint(flight->getRouteLength() - loop - 1));
-    }
+  QPolygonF baroArray;
+  QPolygonF elevArray;
+  QPolygonF varioArray;
+  QPolygonF speedArray;
 
-  for(unsigned int loop = 0; vario && loop < gn_va; loop++)
+  if( baro )
     {
-      vario_d[loop]      = getVario(flight->getPoint(loop));
-      vario_d_last[loop] = getVario(flight->getPoint(flight->getRouteLength() - loop - 1));
-    }
+      const QVector<double>& b = smoother.smoothed( CurveSmoother::Baro, smoothness_h );
+      const QVector<double>& e = smoother.smoothed( CurveSmoother::Elevation, smoothness_h );
 
-  QPolygonF baroArray(flight->getRouteLength());
-  QPolygon  elevArray(flight->getRouteLength()+2);
-  QPolygonF varioArray(flight->getRouteLength());
-  QPolygonF speedArray(flight->getRouteLength());
-
-  qreal maxBaro  = 0.0;
-  qreal minVario = 0.0;
-  qreal maxVario = 0.0;
-  qreal maxSpeed = 0.0;
-
-#ifdef DebugMultiFlightsInOneIGCFile
-  // detect multiple flights in one IGC-File
-  // it is still unclear how we should handle this internally
-  // This poor algorithm will only work with low wind speeds
-  qreal lastSpeed = 0.0;
-  int StartTime = 0;
-#endif
+      qreal maxBaro = 0.0;
 
-  for(int loop = 0; loop < flight->getRouteLength(); loop++)
-    {
-      curTime = flight->getPoint(loop).time;
-      // Correct time for overnight-flights:
-      if(curTime < startTime)
+      // Search the baro maximum
+      for( int i = 0; i < points; i++ )
         {
-          curTime += 86400;
+          maxBaro = qMax( maxBaro, b[i] );
         }
-#ifdef DebugMultiFlightsInOneIGCFile
-      qreal currentSpeed = getSpeed(flight->getPoint(loop));
 
-      if (currentSpeed > 50.0)
-          {
-              if (lastSpeed < 50.0)
-              {
-                  StartTime = curTime;
-              }
-          }
-      else
-          {
-               if (lastSpeed > 50.0)
-                  {
-                    qDebug() << flight->getDate() << "," << printTime(StartTime,true,true) << "," << printTime(curTime, true, true) << "," << printTime(curTime - StartTime, true, true);
-                  }
-          }
-
-      lastSpeed = currentSpeed;
-#endif
-      if( baro )
-        {
-          /* Das Array wird hier noch falsch gefüllt. Wenn über 3 Punkte geglättet wird, stimmt
-           * alles. Wenn jedoch z.B. über 5 Punkte geglättet wird, werden die Punkte
-           * ( -4, -3, -2, -1, 0, 1) genommen, statt (-2, -1, 0, 1, 2). Das ist vermutlich
-           * die Ursache dafür, dass die Kurve "wandert".
-           */
-          if(loop < flight->getRouteLength() - smoothness_h && loop > smoothness_h)
-            {
-              baro_d[(loop - smoothness_h - 1) % gn_h] = flight->getPoint(loop + smoothness_h).height;
-              elev_d[(loop - smoothness_h - 1) % gn_h] = flight->getPoint(loop + smoothness_h).surfaceHeight;
-            }
+      scale_h = maxBaro / ((double)(height - 2 * Y_DISTANCE));
 
-          if(loop < flight->getRouteLength() - smoothness_h)
-            {
-              _addBaroPoint( baroArray, baro_d, gn_h, loop );
+      baroArray.resize( points );
 
-              elevArray.setPoint(loop, __baroPoint(elev_d, gn_h, loop));
-            }
-          else
-            {
-              _addBaroPoint( baroArray, baro_d_last, gn_h,
-                             flight->getRouteLength() - loop - 1);
+      // add two points so we can draw a filled area
+      elevArray.resize( points + 2 );
 
-              elevArray.setPoint( loop, __baroPoint(elev_d_last, gn_h,
-                                  flight->getRouteLength() - loop - 1) );
-            }
+      for( int i = 0; i < points; i++ )
+        {
+          baroArray[i] = QPointF( xpos[i], height - ( b[i] / scale_h ) - Y_DISTANCE );
+          elevArray[i] = QPointF( xpos[i], height - ( e[i] / scale_h ) - Y_DISTANCE );
+        }
 
-          // Search the new baro maximum
-          qreal by = baroArray.last().y();
+      elevArray[points]     = QPointF( xpos[points - 1], height - Y_DISTANCE );
+      elevArray[points + 1] = QPointF( X_DISTANCE, height - Y_DISTANCE );
+    }
 
-          if( by > maxBaro )
-            {
-              maxBaro = by;
-            }
-        }
+  if( vario )
+    {
+      const QVector<double>& v = smoother.smoothed( CurveSmoother::Vario, smoothness_va );
 
-      if( vario )
+      if( varioScale == 0 )
         {
-          if( loop < flight->getRouteLength() - smoothness_va && loop > smoothness_va)
-            {
-              vario_d[(loop - smoothness_va - 1) % gn_va] = getVario(flight->getPoint(loop + smoothness_va));
-            }
+          qreal minVario = 0.0;
+          qreal maxVario = 0.0;
 
-          if( loop < flight->getRouteLength() - smoothness_va )
-            {
-              _addVarioPoint(varioArray, vario_d, gn_va, loop);
-            }
-          else
+          // Search the variometer maximum/minimum
+          for( int i = 0; i < points; i++ )
             {
-              _addVarioPoint(varioArray, vario_d_last, gn_va, flight->getRouteLength() - loop - 1);
+              maxVario = qMax( maxVario, v[i] );
+              minVario = qMin( minVario, v[i] );
             }
 
-          // Search the new variometer maximum/minimum
-          qreal vy = varioArray.last().y();
+          // Recalculate current variometer scale
+          scale_va = qMax(maxVario, ( -1.0 * minVario) ) /
+                      ((double)(height - 2 * Y_DISTANCE) / 2.0);
+        }
 
-          if( vy > 0.0 && vy > maxVario )
-            {
-              maxVario = vy;
-            }
-          else if( vy < 0.0 && vy < minVario )
-            {
-              minVario = vy;
-            }
+      varioArray.resize( points );
+
+      for( int i = 0; i < points; i++ )
+        {
+          varioArray[i] = QPointF( xpos[i], (height / 2) - ( v[i] / scale_va ) );
         }
+    }
+
+  if( speed )
+    {
+      const QVector<double>& sp = smoother.smoothed( CurveSmoother::Speed, smoothness_v );
 
-      if( speed )
+      if( speedScale == 0 )
         {
-          if(loop < flight->getRouteLength() - smoothness_v && loop > smoothness_v)
-            {
-              speed_d[(loop - smoothness_v - 1) % gn_v] = getSpeed(flight->getPoint(loop + smoothness_v));
-            }
+          qreal maxSpeed = 0.0;
 
-          if(loop < flight->getRouteLength() - smoothness_v)
-            {
-              _addSpeedPoint( speedArray, speed_d, gn_v, loop);
-            }
-          else
+          // Search the speed maximum
+          for( int i = 0; i < points; i++ )
             {
-              _addSpeedPoint( speedArray, speed_d_last, gn_v, flight->getRouteLength() - loop - 1);
+              maxSpeed = qMax( maxSpeed, sp[i] );
             }
 
-          // Search the new speed maximum
-          qreal sy = speedArray.last().y();
+          // Recalculate current speed scale
+          scale_v = maxSpeed / ((double) (height - 2 * Y_DISTANCE));
+        }
 
-          if( sy > maxSpeed )
-            {
-              maxSpeed = sy;
-            }
+      speedArray.resize( points );
+
+      for( int i = 0; i < points; i++ )
+        {
+          speedArray[i] = QPointF( xpos[i], height - ( sp[i] / scale_v ) - Y_DISTANCE );
         }
     }
 
+  pixBufferCurves.fill(Qt::white);
+
+  QPainter painter;
+  painter.begin(&pixBufferCurves);
+
   if( baro )
-    {
-      scale_h = maxBaro / ((double)(height - 2 * Y_DISTANCE));
+    { // draw elevation
+      painter.setBrush(QColor(35, 120, 20));
+      painter.setPen(QPen(QColor(35, 120, 20), 1));
+      painter.drawPolygon(elevArray);
     }
 
-  if( vario && varioScale == 0 )
+  __drawCsystem(&painter);
+
+  if(vario)
     {
-      // Recalculate current variometer scale
-      scale_va = qMax(maxVario, ( -1.0 * minVario) ) /
-                  ((double)(height - 2 * Y_DISTANCE) / 2.0);
+      painter.setPen(QPen(QColor(255,100,100), 1));
+      painter.drawPolyline(varioArray);
     }
 
-  if( speed && speedScale == 0 )
+  if(speed)
     {
-      // Recalculate current speed scale
-      scale_v = maxSpeed / ((double) (height - 2 * Y_DISTANCE));
+      painter.setPen(QPen(QColor(0,0,0), 1));
+      painter.drawPolyline(speedArray);
     }
 
-  pixBufferKurve.fill(Qt::white);
+  if(baro)
+    {
+      painter.setPen(QPen(QColor(100, 100, 255), 1));
+      painter.drawPolyline(baroArray);
+    }
 
-  QPainter painter;
-  painter.begin(&pixBufferKurve);
+  painter.end();
 
-  if( baro )
-    { // draw elevation
-      painter.setBrush(QColor(35, 120, 20));
-      painter.setPen(QPen(QColor(35, 120, 20), 1));
-      // add two points so we can draw a filled area
+  __drawOverlay();
+}
 
-      elevArray.setPoint( flight->getRouteLength(),
-                          QPoint( elevArray[flight->getRouteLength()-1].x(),
-                          height - Y_DISTANCE ) );
+void EvaluationView::__drawOverlay()
+{
+  if( pixBufferCurves.isNull() || ! flight )
+    {
+      return;
+    }
 
-      elevArray.setPoint( flight->getRouteLength() + 1,
-                           QPoint( X_DISTANCE,
-                           height - Y_DISTANCE ) );
+  int height = scrollFrame->viewport()->height();
 
-      painter.drawPolygon(elevArray);
-    }
+  // Start with a copy of the cached curves.
+  pixBufferKurve = pixBufferCurves;
 
-  __drawCsystem(&painter);
+  QPainter painter;
+  painter.begin(&pixBufferKurve);
 
   int xpos = 0;
 
@@ -920,68 +801,10 @@ void EvaluationView::__draw()
       painter.drawText(xpos - 40, Y_DISTANCE - 10 - 5, 80, 10, Qt::AlignCenter, timeText);
     }
 
-  if(vario)
-    {
-      // All y values must be scaled to the found minimum/maximum value
-      for( int i = 0; i < varioArray.size(); i++ )
-        {
-          qreal y = varioArray.at(i).y();
-
-          y = (height / 2) - (y / scale_va);
-
-          varioArray.replace( i, QPointF(varioArray.at(i).x(), y) );
-        }
-
-      painter.setPen(QPen(QColor(255,100,100), 1));
-      painter.drawPolyline(varioArray);
-    }
-
-  if(speed)
-    {
-      // All y values must be scaled to the found minimum/maximum value
-      for( int i = 0; i < speedArray.size(); i++ )
-        {
-          qreal y = speedArray.at(i).y();
-
-          y = height - ( y / scale_v ) - Y_DISTANCE;
-
-          speedArray.replace( i, QPointF(speedArray.at(i).x(), y) );
-        }
-
-      painter.setPen(QPen(QColor(0,0,0), 1));
-      painter.drawPolyline(speedArray);
-    }
-
-  if(baro)
-    {
-      // All y values must be scaled to the found maximum value
-      for( int i = 0; i < baroArray.size(); i++ )
-        {
-          qreal y = baroArray.at(i).y();
-
-          y = height - ( y / scale_h ) - Y_DISTANCE;
-
-          baroArray.replace( i, QPointF(baroArray.at(i).x(), y) );
-        }
-
-      painter.setPen(QPen(QColor(100, 100, 255), 1));
-      painter.drawPolyline(baroArray);
-  }
-
   painter.end();
 
   __drawCursor(( cursor1 - startTime ) / secWidth + X_DISTANCE, false, 1);
   __drawCursor(( cursor2 - startTime ) / secWidth + X_DISTANCE, false, 2);
-
-  delete [] baro_d;
-  delete [] baro_d_last;
-  delete [] elev_d;
-  delete [] elev_d_last;
-
-  delete [] speed_d;
-  delete [] speed_d_last;
-  delete [] vario_d;
-  delete [] vario_d_last;
 }
 
 void EvaluationView::__drawCursor( const int xpos,
@@ -27,6 +27,8 @@
 #include <QScrollArea>
 #include <QWidget>
 
+#include "curvesmoother.h"
+
 class Flight;
 class FlightPoint;
 class EvaluationDialog;
@@ -105,18 +107,6 @@ private:
   /** Draws the coordinate system axis. */
   void __drawCsystem(QPainter* painter);
 
-  /** Calculates the elevation point for the drawing polygon. */
-  QPoint __baroPoint(int durch[], int gn, int i);
-
-  /** Calculates the altitude point for the drawing polygon. */
-  void _addBaroPoint( QPolygonF& vector, int baro_d[], int gn, int i);
-
-  /** Calculates the variometer point for the drawing polygon. */
-  void _addVarioPoint( QPolygonF& vector, float vario_d[], int gn, int i );
-
-  /** Calculates the speed point for the drawing polygon. */
-  void _addSpeedPoint( QPolygonF& vector, float speed_d[], int gn, int i);
-
   /**
    * Prepares the flight pointer.
    */
@@ -140,6 +130,12 @@ private:
   /** Draw graphs */
   void __draw();
 
+  /**
+   * Draws the turnpoints and the cursors on top of the cached curves. Must
+   * be called only, if the cursors or the task have been changed.
+   */
+  void __drawOverlay();
+
   /** Draw y-axis */
   void __drawYAxis();
 
@@ -165,12 +161,17 @@ private:
   /** Contains the Y-Axis. */
   QPixmap pixBufferYAxis;
 
-  /** Contains the altitude, speed, variometer curves.*/
+  /** Contains the altitude, speed, variometer curves, turnpoints and cursors.*/
   QPixmap pixBufferKurve;
 
+  /** Contains only the altitude, speed, variometer curves.*/
+  QPixmap pixBufferCurves;
+
+  /** Provides the smoothed curve data of the flight. */
+  CurveSmoother smoother;
+
   time_t startTime;
   time_t landTime;
-  time_t curTime;
   /**
     * Dieser Wert gibt den Abstand zwischen zwei Zeichenpunkten in
     * Sekunden an.
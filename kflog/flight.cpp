@@ -31,7 +31,10 @@
 
 #include "airspace.h"
 #include "airspacewarningdistance.h"
+#include "elevationfinder.h"
 #include "flight.h"
+#include "flightanalysiscache.h"
+#include "geovectors.h"
 #include "mainwindow.h"
 #include "mapcalc.h"
 #include "mapconfig.h"
@@ -83,7 +86,8 @@ extern MapContents* _globalMapContents;
 
 Flight::Flight( const QString& fName,
                 const QList<FlightPoint*>& r,
-                const FlightStaticData& flightStaticData )
+                const FlightStaticData& flightStaticData,
+                const FlightAnalysisCache* cache )
   : BaseFlightElement("flight", BaseMapElement::Flight, fName),
     m_flightStaticData(flightStaticData),
     v_max(0),
@@ -101,14 +105,31 @@ Flight::Flight( const QString& fName,
     nAnimationIndex(0),
     bAnimationActive(false),
     taskTimesSet(false),
+    m_olcScore(0.0),
+    m_olcDistance(0.0),
     m_dfpt(MapConfig::Altitude)
 {
   origTask.checkWaypoints(route, flightStaticData.gliderType);
 
-  __calculateBasicInformation();
-  __checkMaxMin();
-  __flightState();
-  calAirSpaceIntersections();
+  // The surface heights were just set by the flight loader.
+  m_elevationKey = ElevationFinder::instance()->sourceKey();
+
+  if( cache != 0 )
+    {
+      m_analysisHash = cache->hash;
+    }
+
+  if( cache == 0 || ! cache->isValid() || ! __restoreAnalysis( *cache ) )
+    {
+      __calculateBasicInformation();
+      __flightState();
+    }
+
+  if( m_analysisAirspaces.isEmpty() )
+    {
+      // Not restored from the cache, the cache is updated afterwards.
+      calAirSpaceIntersections();
+    }
 
   header.append(flightStaticData.pilot);
   header.append(flightStaticData.gliderRegistration);
@@ -162,13 +183,10 @@ void Flight::__setOptimizeRange( unsigned int start[],
   stop[2] = qMin((int)(start[2] + ( 2 * step )), route.count() - 1);
 }
 
-double Flight::__calculateOptimizePoints( FlightPoint* fp1,
-                                          FlightPoint* fp2,
-                                          FlightPoint* fp3 )
+double Flight::__calculateOptimizePoints( const double dist1,
+                                          const double dist2,
+                                          const double dist3 )
 {
-  double dist1 = dist(fp1, fp2);
-  double dist2 = dist(fp2, fp3);
-  double dist3 = dist(fp1, fp3);
   double tDist = dist1 + dist2 + dist3;
 
   if(FlightTask::isFAI(tDist, dist1, dist2, dist3)) return tDist * FAI_POINT;
@@ -266,6 +284,47 @@ void Flight::__flightState()
     }
 }
 
+/**
+ * Running state of the search for the extreme values of a flight.
+ */
+struct MaxMinState
+{
+  float refv, refh, refva1, refva2;
+  unsigned int v_max, h_max, va_max, va_min;
+};
+
+static inline void updateMaxMin( MaxMinState& s,
+                                 const FlightPoint* fp,
+                                 const unsigned int loop )
+{
+  // Fetch extreme values
+  float tmp = (float)fp->dS / (float)fp->dT;
+
+  if(tmp > s.refv) {
+      s.v_max = loop;
+      s.refv = tmp;
+  }
+
+  tmp = fp->height;
+
+  if(tmp > s.refh) {
+      s.h_max = loop;
+      s.refh = tmp;
+  }
+
+  tmp = (float)fp->dH / (float)fp->dT;
+
+  if(tmp > s.refva1) {
+      s.va_max = loop;
+      s.refva1 = tmp;
+  }
+
+  if(tmp < s.refva2) {
+      s.va_min = loop;
+      s.refva2 = tmp;
+  }
+}
+
 void Flight::__calculateBasicInformation()
 {
   /**
@@ -273,64 +332,135 @@ void Flight::__calculateBasicInformation()
    * with windy conditions. This results in incorrect turning directions
    * of thermals.
    */
-  float        prevBearing = 0, nextBearing = 0 , diffBearing = 0, prevDiffBearing = 0;
-  unsigned int points = route.count();
+  const int points = route.count();
 
-  for(unsigned int n = 0; n < points; n++)
-  {
-    if(n==0)
+  MaxMinState mm = { .0, .0, .0, 500., 0, 0, 0, 0 };
+
+  if( points < 2 )
     {
-      route.at(n)->dH = 0;
-      route.at(n)->dT = qMax( (route.at(n+1)->time - route.at(n)->time), time_t(1));
-      route.at(n)->dS = 0;
+      if( points == 1 )
+        {
+          FlightPoint* fp = route.at(0);
+          fp->dH = 0;
+          fp->dT = 1;
+          fp->dS = 0;
+          fp->bearing = 0;
+          fp->dBearing = 0;
+          updateMaxMin( mm, fp, 0 );
+        }
 
-      route.at(n)->bearing  = getBearing(*route.at(n), *route.at(n+1));
-      route.at(n)->dBearing = 0;
+      v_max = mm.v_max;
+      h_max = mm.h_max;
+      va_max = mm.va_max;
+      va_min = mm.va_min;
+      return;
     }
-    else if(n==(points-1))
+
+  // Copy the needed values of the points into columns.
+  QVector<int>    lat( points ), lon( points ), height( points );
+  QVector<time_t> time( points );
+  GeoVectors      vectors;
+
+  for( int k = 0; k < points; k++ )
     {
-      route.at(n)->dH = route.at(n)->height - route.at(n-1)->height;
-      route.at(n)->dT = qMax( (route.at(n)->time - route.at(n-1)->time), time_t(1));
-      route.at(n)->dS = (int)(dist(route.at(n)->origP.lat(), route.at(n)->origP.lon(), route.at(n-1)->origP.lat(), route.at(n-1)->origP.lon()) * 1000.0);
+      const FlightPoint* fp = route.at( k );
+
+      lat[k]    = fp->origP.lat();
+      lon[k]    = fp->origP.lon();
+      height[k] = fp->height;
+      time[k]   = fp->time;
+
+      vectors.append( fp->origP );
+    }
 
-      route.at(n)->bearing  = getBearing(*route.at(n-1), *route.at(n));
-      route.at(n)->dBearing = __diffAngle(route.at(n-1)->bearing, route.at(n)->bearing);
+  // Values of the segments between the points k - 1 and k. Every segment
+  // bearing is calculated only once.
+  QVector<int>    segDH( points ), segDT( points );
+  QVector<double> segDS( points );
+  QVector<float>  segBearing( points );
+
+  vectors.segmentLengths( segDS.data() );
+
+  segDH[0] = segDT[0] = 0;
+  segBearing[0] = 0;
+
+  for( int k = 1; k < points; k++ )
+    {
+      segDH[k] = height[k] - height[k - 1];
+      segDT[k] = qMax( time[k] - time[k - 1], time_t(1) );
     }
-    //calculate the bearing by calculating the average between the bearing with the previous and next point
-    else
+
+  for( int k = 1; k < points; k++ )
     {
-      route.at(n)->dH = route.at(n)->height - route.at(n-1)->height;
-      route.at(n)->dT = qMax( (route.at(n)->time - route.at(n-1)->time), time_t(1));
-      route.at(n)->dS = (int)(dist(route.at(n)->origP.lat(), route.at(n)->origP.lon(), route.at(n-1)->origP.lat(), route.at(n-1)->origP.lon()) * 1000.0);
+      segBearing[k] = getBearing( lat[k - 1], lon[k - 1], lat[k], lon[k] );
+    }
 
-      prevBearing = getBearing(*route.at(n-1), *route.at(n));
-      nextBearing = getBearing(*route.at(n), *route.at(n+1));
-      diffBearing = __diffAngle(prevBearing, nextBearing);
+  // The bearings depend on the previous points and are calculated in order.
+  float prevBearing = 0, nextBearing = 0 , diffBearing = 0, prevDiffBearing = 0;
 
-      //in windy conditions large changes in diffBearing can occur, which means that the plane suddenly changes its turn direction
-      if(fabs(prevDiffBearing-diffBearing)*9/route.at(n)->dT > M_PI)
-        diffBearing = -diffBearing;
+  for( int n = 0; n < points; n++ )
+    {
+      FlightPoint* fp = route.at(n);
 
-      //calculate the bearing as an average of the previous and the next bearing
-      if(diffBearing<0)
-        route.at(n)->bearing = fabs(diffBearing)/2+nextBearing;
-      else
-        route.at(n)->bearing = fabs(diffBearing)/2+prevBearing;
+      if(n == 0)
+        {
+          fp->dH = 0;
+          fp->dT = segDT[n + 1];
+          fp->dS = 0;
 
-      //be sure that the bearing is not larger than 360 degrees
-      if(route.at(n)->bearing > 2.0*M_PI)
-        route.at(n)->bearing  = route.at(n)->bearing - 2.0*M_PI;
+          fp->bearing  = segBearing[n + 1];
+          fp->dBearing = 0;
+        }
+      else if(n == (points - 1))
+        {
+          fp->dH = segDH[n];
+          fp->dT = segDT[n];
+          fp->dS = (int)(segDS[n] * 1000.0);
 
-      route.at(n)->dBearing = __diffAngle(route.at(n-1)->bearing, route.at(n)->bearing);
-      //in windy conditions large changes in dBearing can occur, which means that the plane suddenly changes its turn direction
-      if((route.at(n)->dBearing-route.at(n-1)->dBearing)*9/route.at(n)->dT>270/180*M_PI && route.at(n)->dBearing>0)
-        route.at(n)->dBearing = route.at(n)->dBearing - 2*M_PI;
-      else if((route.at(n)->dBearing-route.at(n-1)->dBearing)*9/route.at(n)->dT<(-270/180*M_PI) && route.at(n)->dBearing<0)
-        route.at(n)->dBearing = route.at(n)->dBearing + 2*M_PI;
+          fp->bearing  = segBearing[n];
+          fp->dBearing = __diffAngle(route.at(n-1)->bearing, fp->bearing);
+        }
+      //calculate the bearing by calculating the average between the bearing with the previous and next point
+      else
+        {
+          fp->dH = segDH[n];
+          fp->dT = segDT[n];
+          fp->dS = (int)(segDS[n] * 1000.0);
+
+          prevDiffBearing = diffBearing;
+          prevBearing = segBearing[n];
+          nextBearing = segBearing[n + 1];
+          diffBearing = __diffAngle(prevBearing, nextBearing);
+
+          //in windy conditions large changes in diffBearing can occur, which means that the plane suddenly changes its turn direction
+          if(fabs(prevDiffBearing-diffBearing)*9/fp->dT > M_PI)
+            diffBearing = -diffBearing;
+
+          //calculate the bearing as an average of the previous and the next bearing
+          if(diffBearing<0)
+            fp->bearing = fabs(diffBearing)/2+nextBearing;
+          else
+            fp->bearing = fabs(diffBearing)/2+prevBearing;
+
+          //be sure that the bearing is not larger than 360 degrees
+          if(fp->bearing > 2.0*M_PI)
+            fp->bearing  = fp->bearing - 2.0*M_PI;
+
+          fp->dBearing = __diffAngle(route.at(n-1)->bearing, fp->bearing);
+          //in windy conditions large changes in dBearing can occur, which means that the plane suddenly changes its turn direction
+          if((fp->dBearing-route.at(n-1)->dBearing)*9/fp->dT>270/180*M_PI && fp->dBearing>0)
+            fp->dBearing = fp->dBearing - 2*M_PI;
+          else if((fp->dBearing-route.at(n-1)->dBearing)*9/fp->dT<(-270/180*M_PI) && fp->dBearing<0)
+            fp->dBearing = fp->dBearing + 2*M_PI;
+        }
 
-      prevDiffBearing = diffBearing;
+      updateMaxMin( mm, fp, n );
     }
-  }
+
+  v_max = mm.v_max;
+  h_max = mm.h_max;
+  va_max = mm.va_max;
+  va_min = mm.va_min;
 }
 
 float Flight::__diffAngle(float firstAngle, float secondAngle)
@@ -345,7 +475,8 @@ float Flight::__diffAngle(float firstAngle, float secondAngle)
   return diffAngle;
 }
 
-unsigned int Flight::__calculateBestTask( unsigned int start[],
+unsigned int Flight::__calculateBestTask( const GeoVectors& vectors,
+                                          unsigned int start[],
                                           unsigned int stop[],
                                           unsigned int step,
                                           unsigned int idList[],
@@ -354,24 +485,22 @@ unsigned int Flight::__calculateBestTask( unsigned int start[],
 {
   unsigned int numSteps = 0;
   double temp = 0;
-  FlightPoint *pointA, *pointB, *pointC;
 
   for(int loopA = start[0]; loopA <= qMin((int)stop[0], route.count() - 1); loopA += step)
     {
-      pointA = route.at(loopA);
-
       if(isTotal) start[1] = loopA + step;
 
       for(int loopB = start[1]; loopB <= qMin((int)stop[1], route.count() - 1); loopB += step)
         {
-          pointB = route.at(loopB);
+          double distAB = vectors.dist(loopA, loopB);
 
           if(isTotal) start[2] = loopB + step;
 
           for(int loopC = start[2]; loopC <= qMin((int)stop[2], route.count() - 1); loopC += step)
             {
-              pointC = route.at(loopC);
-              temp = __calculateOptimizePoints(pointA, pointB, pointC);
+              temp = __calculateOptimizePoints(distAB,
+                                               vectors.dist(loopB, loopC),
+                                               vectors.dist(loopA, loopC));
 
               /* wir behalten die besten Dreiecke ( taskValue[0] := bester ) */
               if(temp > taskValue[MAX_TASK_ID])
@@ -526,6 +655,54 @@ bool Flight::drawMapElement( QPainter* targetPainter )
   return true;
 }
 
+QRect Flight::drawAnimationPart( QPainter* targetPainter, const int from, const int to )
+{
+  QRect bBox;
+
+  if( ! isVisible() || route.count() == 0 )
+    {
+      return bBox;
+    }
+
+  int delta = 1;
+
+  if(!glMapMatrix->isSwitchScale())
+    {
+      delta = 8;
+    }
+
+  // Start at the last point, which drawMapElement() used before "from".
+  int n = (from > 0) ? ((from - 1) / delta) * delta : 0;
+
+  QPoint curPointA = glMapMatrix->map(route.at(n)->projP);
+
+  float vario_min = getPoint(VA_MIN).dH/getPoint(VA_MIN).dT;
+  float vario_max = getPoint(VA_MAX).dH/getPoint(VA_MAX).dT;
+  int altitude_max = getPoint(H_MAX).height;
+  float speed_max = getPoint(V_MAX).dS/getPoint(V_MAX).dT;
+
+  m_dfpt = (MapConfig::DrawFlightPointType) _settings.value( "/Flight/DrawType", MapConfig::Altitude).toInt();
+
+  for( n = n + delta; n < to && n < route.count(); n = n + delta )
+    {
+      QPoint curPointB = glMapMatrix->map(route.at(n)->projP);
+
+      QPen drawP = glConfig->getDrawPen(route.at(n), vario_min, vario_max, altitude_max, speed_max, m_dfpt);
+      drawP.setCapStyle(Qt::SquareCap);
+      targetPainter->setPen(drawP);
+      targetPainter->drawLine(curPointA, curPointB);
+
+      // Add the pen width, that the whole line is covered.
+      int w = drawP.width() + 1;
+
+      bBox |= QRect( curPointA, curPointB ).normalized().adjusted( -w, -w, w, w );
+
+      curPointA = curPointB;
+    }
+
+  return bBox;
+}
+
 QString Flight::getTaskTypeString( bool isOrig ) const
 {
   if(isOrig || !optimized)
@@ -931,44 +1108,6 @@ QRect Flight::getTaskRect() const
       return origTask.getRect();
 }
 
-void Flight::__checkMaxMin()
-{
-  v_max = 0;
-  h_max = 0;
-  va_max = 0;
-  va_min = 0;
-  float tmp, refv = .0, refh = .0, refva1 = .0 , refva2 = 500.;
-
-  FlightPoint *fp;
-  unsigned int loop = 0;
-  foreach(fp, route) {
-      // Fetch extreme values
-      tmp = (float)fp->dS / (float)fp->dT;
-      if(tmp > refv) {
-          v_max = loop;
-          refv = tmp;
-      }
-
-      tmp = fp->height;
-      if(tmp > refh) {
-          h_max = loop;
-          refh = tmp;
-      }
-
-      tmp = (float)fp->dH / (float)fp->dT;
-      if(tmp > refva1) {
-          va_max = loop;
-          refva1 = tmp;
-      }
-      if(tmp < refva2) {
-          va_min = loop;
-          refva2 = tmp;
-      }
-
-      loop++;
-  }
-}
-
 QList<Waypoint*> Flight::getWPList()
 {
   if( !optimized )
@@ -1009,6 +1148,15 @@ bool Flight::optimizeTaskOLC( Map* map )
       return false;
     }
 
+  __setOlcTask( idList, points, distance );
+  __saveAnalysis();
+
+  delete wizard;
+  return true;
+}
+
+void Flight::__setOlcTask( const unsigned int idList[], double points, double distance )
+{
   QList<Waypoint*> wpL;
 
   APPEND_WAYPOINT_OLC2003(startIndex, 0, QObject::tr("Take-Off"))
@@ -1038,8 +1186,15 @@ bool Flight::optimizeTaskOLC( Map* map )
   optimizedTask.setOptimizedTask(points,distance);
   optimized = true;
 
-  delete wizard;
-  return true;
+  m_olcPoints.clear();
+
+  for( int i = 0; i < LEGS + 3; i++ )
+    {
+      m_olcPoints.append( idList[i] );
+    }
+
+  m_olcScore = points;
+  m_olcDistance = distance;
 }
 
 /*
@@ -1122,7 +1277,10 @@ bool Flight::optimizeTask()
   // steps muss noch besser berechnet werden!!!
   step = step * 3;
 
-  numSteps = __calculateBestTask(start, stop, step, idList, taskValue, true);
+  // Unit vectors of the flight points for the distance calculation
+  GeoVectors vectors( route );
+
+  numSteps = __calculateBestTask(vectors, start, stop, step, idList, taskValue, true);
   totalSteps = numSteps;
 
   // Sichern der ID's der Favoriten
@@ -1137,7 +1295,7 @@ bool Flight::optimizeTask()
     {
       __setOptimizeRange(start, stop, idTempList, loop * 3, step);
 
-      numSteps = __calculateBestTask(start, stop, stepB, idList, taskValue, false);
+      numSteps = __calculateBestTask(vectors, start, stop, stepB, idList, taskValue, false);
       secondSteps += numSteps;
     }
   step = stepB;
@@ -1151,7 +1309,7 @@ bool Flight::optimizeTask()
     {
       __setOptimizeRange(start, stop, idTempList, loop * 3, step);
 
-      numSteps = __calculateBestTask(start, stop, 1, idList, taskValue, false);
+      numSteps = __calculateBestTask(vectors, start, stop, 1, idList, taskValue, false);
       secondSteps += numSteps;
     }
 
@@ -1322,12 +1480,6 @@ bool Flight::isAnimationActive(void)  {  return bAnimationActive;  }
 /** No descriptions */
 int Flight::getAnimationIndex()  {  return nAnimationIndex;  }
 
-/** No descriptions */
-void Flight::setLastAnimationPos(QPoint pos)  {  preAnimationPos = pos;  }
-
-/** No descriptions */
-QPoint Flight::getLastAnimationPos(void)  {  return preAnimationPos;  }
-
 /** Re-calculates all projections for this flight. */
 void Flight::reProject()
 {
@@ -1343,6 +1495,45 @@ void Flight::reProject()
   calAirSpaceIntersections();
 }
 
+void Flight::__calculateAltitudeColumns()
+{
+  const int count = route.size();
+
+  m_altitudePressure.resize( count );
+  m_altitudeGround.resize( count );
+  m_altitudeStd.resize( count );
+  m_projectedBox = QRect();
+
+  if( count == 0 )
+    {
+      return;
+    }
+
+  // Standard altitude correction, see Altitude::setStdAltitude
+  const int stdDelta = (int) rint( (1013 - m_flightStaticData.qnh) * 9.1437 );
+
+  int left   = route.at(0)->projP.x();
+  int right  = left;
+  int top    = route.at(0)->projP.y();
+  int bottom = top;
+
+  for( int i = 0; i < count; i++ )
+    {
+      const FlightPoint* fp = route.at(i);
+
+      m_altitudePressure[i] = fp->height;
+      m_altitudeGround[i]   = fp->height - fp->surfaceHeight;
+      m_altitudeStd[i]      = fp->height + stdDelta;
+
+      left   = qMin( left, fp->projP.x() );
+      right  = qMax( right, fp->projP.x() );
+      top    = qMin( top, fp->projP.y() );
+      bottom = qMax( bottom, fp->projP.y() );
+    }
+
+  m_projectedBox.setCoords( left, top, right, bottom );
+}
+
 void Flight::calAirSpaceIntersections()
 {
   // List with finished airspace intersections
@@ -1353,112 +1544,342 @@ void Flight::calAirSpaceIntersections()
       return;
     }
 
+  __calculateAltitudeColumns();
+
   // Get all loaded airspaces from MapContent.
   SortableAirspaceList& loadedAirspaces = _globalMapContents->getAirspaceList();
 
-  // List with started airspace intersections
-  QList<Flight::AirSpaceIntersection> asStartIntersections;
+  const int count = route.size();
 
-  for( int ridx = 0; ridx < route.size(); ridx++ )
-    {
-      FlightPoint* fp = route.at(ridx);
+  // Altitude limit, which is never reached by a flight.
+  const float unlimited = 1.0e9f;
 
-      fp->isAirspaceIntersected = false;
+  // Vertical distance to the nearest limit of all flight points.
+  QVector<float> depth( count );
+
+  for( int ridx = 0; ridx < count; ridx++ )
+    {
+      route.at(ridx)->isAirspaceIntersected = false;
+    }
 
-      // Check for airspace violations at the current coordinate.
-      AltitudeCollection altitudesForI;
-      altitudesForI.pressureAltitude = Altitude(fp->height);
-      altitudesForI.gpsAltitude = Altitude(fp->gpsHeight);
-      altitudesForI.gndAltitude = Altitude((fp->height) - (fp->surfaceHeight));
-      altitudesForI.gndAltitudeError = Altitude(0);
-      altitudesForI.stdAltitude.setStdAltitude(fp->height, m_flightStaticData.qnh);
+  for( int i = 0; i < loadedAirspaces.count(); i++ )
+    {
+      Airspace& as = loadedAirspaces[i];
 
-      AirspaceWarningDistance awdForI;
+      if( as.getTypeID() == BaseMapElement::AirFir )
+        {
+          // Don't consider FIR airspaces
+          continue;
+        }
 
-      // look for violated airspaces
-      for ( int i = 0 ; i < loadedAirspaces.count(); i++ )
+      if( ! as.isCircle() &&
+          ! as.getBoundingBox().intersects( m_projectedBox ) )
         {
-          bool insideAs = false;
+          // The flight is always outside of the airspace.
+          continue;
+        }
+
+      Airspace::VerticalLimit limit[2];
+      as.getVerticalLimits( limit[0], limit[1] );
 
-          Airspace& as = loadedAirspaces[i];
+      const float* column[2] = { 0, 0 };
+      float value[2] = { 0.0, 0.0 };
+      bool never = false;
 
-          if( as.getTypeID() == BaseMapElement::AirFir )
+      for( int k = 0; k < 2; k++ )
+        {
+          switch( limit[k].reference )
             {
-              // Don't consider FIR airspaces
-              continue;
+              case Airspace::PressureLimit:
+                column[k] = m_altitudePressure.constData();
+                value[k]  = limit[k].meters;
+                break;
+              case Airspace::GroundLimit:
+                column[k] = m_altitudeGround.constData();
+                value[k]  = limit[k].meters;
+                break;
+              case Airspace::StdLimit:
+                column[k] = m_altitudeStd.constData();
+                value[k]  = limit[k].meters;
+                break;
+              case Airspace::AlwaysInside:
+                column[k] = m_altitudePressure.constData();
+                value[k]  = ( k == 0 ) ? -unlimited : unlimited;
+                break;
+              case Airspace::NeverInside:
+                never = true;
+                break;
             }
+        }
+
+      if( never )
+        {
+          continue;
+        }
+
+      // Vertical check of all flight points in one simple loop. A positive
+      // depth means inside of the vertical limits.
+      const float* lowerColumn = column[0];
+      const float* upperColumn = column[1];
+      const float  lowerValue  = value[0];
+      const float  upperValue  = value[1];
+      float* depthData = depth.data();
 
-          // At first check, if the projected coordinate lays inside the
-          // airspace polygon.
-          if( as.isProjectedPointInside( fp->projP ) )
+      for( int ridx = 0; ridx < count; ridx++ )
+        {
+          depthData[ridx] = qMin( lowerColumn[ridx] - lowerValue,
+                                  upperValue - upperColumn[ridx] );
+        }
+
+      // Horizontal check only of the points inside of the vertical limits.
+      const QRect& box = as.getBoundingBox();
+      int first = -1;
+      float maxDepth = 0.0;
+
+      for( int ridx = 0; ridx <= count; ridx++ )
+        {
+          bool inside = false;
+
+          if( ridx < count && depthData[ridx] >= 0.0 )
             {
-              Airspace::ConflictType conflict =
-                  loadedAirspaces[i].conflicts( altitudesForI, awdForI );
+              FlightPoint* fp = route.at(ridx);
 
-              if( conflict == Airspace::Inside )
+              if( as.isCircle() || box.contains( fp->projP ) )
                 {
-                  insideAs = true;
+                  inside = as.isPointInside( fp->origP, fp->projP );
                 }
             }
 
-          if( insideAs == true )
+          if( inside )
             {
-              fp->isAirspaceIntersected = true;
+              route.at(ridx)->isAirspaceIntersected = true;
 
-              bool violationIsKnown = false;
-
-              // Check, if violated airspace is already handled by us.
-              for( int i = 0; i < asStartIntersections.size(); i++ )
+              if( first < 0 )
                 {
-                  Flight::AirSpaceIntersection& asi = asStartIntersections[i];
-
-                  if( asi.AirSpace() == &as )
-                    {
-                      // update end point
-                      asi.SetLastIndexPointinRoute(ridx);
-                      violationIsKnown = true;
-                      break;
-                    }
+                  first = ridx;
+                  maxDepth = depthData[ridx];
                 }
-
-              if( violationIsKnown == false )
+              else
                 {
-                  // Unknown violation, add it to the start list
-                  Flight::AirSpaceIntersection newAsi( &as, ridx, ridx );
-                  asStartIntersections.append( newAsi );
+                  maxDepth = qMax( maxDepth, depthData[ridx] );
                 }
             }
-          else
+          else if( first >= 0 )
             {
-              // Not or not more inside. Look in start list, if airspace
-              // conflicts can be closed.
-              for( int i = asStartIntersections.size() - 1; i >= 0; i-- )
+              // The intersection ends at the previous point.
+              if( maxDepth >= unlimited / 2 )
                 {
-                  Flight::AirSpaceIntersection& asi = asStartIntersections[i];
-
-                  if( asi.AirSpace() == &as )
-                    {
-                      // Take conflict from the start list and put it in the
-                      // finished list.
-                      m_airspaceIntersections.append( asStartIntersections.takeAt(i) );
-                      break;
-                    }
+                  // No vertical limits
+                  maxDepth = 0.0;
                 }
+
+              m_airspaceIntersections.append( AirSpaceIntersection( &as,
+                                                                    first,
+                                                                    ridx - 1,
+                                                                    Airspace::Inside,
+                                                                    maxDepth ) );
+              first = -1;
             }
         }
     }
 
-  // Close all still open airspace conflicts at the end of the flight.
-  for( int i = asStartIntersections.size() - 1; i >= 0; i-- )
+  // Timeline ordered by the begin of the intersections.
+  qStableSort( m_airspaceIntersections );
+
+  QByteArray key = __airspaceKey();
+
+  if( key != m_analysisAirspaces )
+    {
+      m_analysisAirspaces = key;
+      __saveAnalysis();
+    }
+}
+
+QByteArray Flight::__airspaceKey()
+{
+  SortableAirspaceList& loadedAirspaces = _globalMapContents->getAirspaceList();
+
+  QCryptographicHash md5( QCryptographicHash::Md5 );
+
+  QByteArray data;
+  QDataStream out( &data, QIODevice::WriteOnly );
+
+  // The ground related limits depend on the surface heights.
+  out << qint32( m_flightStaticData.qnh ) << m_elevationKey
+      << qint32( loadedAirspaces.count() );
+
+  for( int i = 0; i < loadedAirspaces.count(); i++ )
+    {
+      Airspace& as = loadedAirspaces[i];
+
+      Airspace::VerticalLimit lower, upper;
+      as.getVerticalLimits( lower, upper );
+
+      out << as.getName() << qint32( as.getTypeID() ) << as.getWgsKey()
+          << qint32( lower.reference ) << lower.meters
+          << qint32( upper.reference ) << upper.meters;
+    }
+
+  md5.addData( data );
+  return md5.result();
+}
+
+bool Flight::__restoreAnalysis( const FlightAnalysisCache& cache )
+{
+  const int count = route.size();
+
+  if( cache.dH.size() != count )
+    {
+      return false;
+    }
+
+  for( int i = 0; i < count; i++ )
+    {
+      FlightPoint* fp = route.at(i);
+
+      fp->dH = cache.dH[i];
+      fp->dT = cache.dT[i];
+      fp->dS = cache.dS[i];
+      fp->bearing = cache.bearing[i];
+      fp->dBearing = cache.dBearing[i];
+      fp->f_state = cache.state[i];
+      fp->isAirspaceIntersected = false;
+    }
+
+  v_max  = cache.v_max;
+  h_max  = cache.h_max;
+  va_min = cache.va_min;
+  va_max = cache.va_max;
+
+  if( cache.olcPoints.size() == LEGS + 3 )
+    {
+      unsigned int idList[LEGS+3];
+
+      for( int i = 0; i < LEGS + 3; i++ )
+        {
+          idList[i] = cache.olcPoints[i];
+        }
+
+      __setOlcTask( idList, cache.olcScore, cache.olcDistance );
+    }
+
+  if( cache.elevationKey.isEmpty() || cache.elevationKey != m_elevationKey )
+    {
+      // The surface heights have been calculated again, so the ground
+      // related intersections are calculated again too.
+      return true;
+    }
+
+  if( cache.airspaceKey != __airspaceKey() )
+    {
+      // The airspaces have been changed, the intersections are calculated again.
+      return true;
+    }
+
+  SortableAirspaceList& loadedAirspaces = _globalMapContents->getAirspaceList();
+
+  m_airspaceIntersections.clear();
+
+  for( int i = 0; i < cache.intersections.size(); i++ )
+    {
+      const FlightAnalysisCache::Intersection& is = cache.intersections[i];
+
+      if( is.airspace < 0 || is.airspace >= loadedAirspaces.count() )
+        {
+          m_airspaceIntersections.clear();
+          return true;
+        }
+
+      m_airspaceIntersections.append( AirSpaceIntersection( &loadedAirspaces[is.airspace],
+                                                            is.first,
+                                                            is.last,
+                                                            Airspace::Inside,
+                                                            is.maxPenetration ) );
+
+      for( int ridx = is.first; ridx <= is.last; ridx++ )
+        {
+          route.at(ridx)->isAirspaceIntersected = true;
+        }
+    }
+
+  m_analysisAirspaces = cache.airspaceKey;
+  return true;
+}
+
+void Flight::__saveAnalysis()
+{
+  if( m_analysisHash.isEmpty() )
+    {
+      return;
+    }
+
+  const int count = route.size();
+
+  FlightAnalysisCache cache;
+
+  cache.hash = m_analysisHash;
+  cache.elevationKey = m_elevationKey;
+
+  cache.surfaceHeight.resize( count );
+  cache.dH.resize( count );
+  cache.dT.resize( count );
+  cache.dS.resize( count );
+  cache.bearing.resize( count );
+  cache.dBearing.resize( count );
+  cache.state.resize( count );
+
+  for( int i = 0; i < count; i++ )
+    {
+      const FlightPoint* fp = route.at(i);
+
+      cache.surfaceHeight[i] = fp->surfaceHeight;
+      cache.dH[i] = fp->dH;
+      cache.dT[i] = fp->dT;
+      cache.dS[i] = fp->dS;
+      cache.bearing[i] = fp->bearing;
+      cache.dBearing[i] = fp->dBearing;
+      cache.state[i] = fp->f_state;
+    }
+
+  cache.v_max  = v_max;
+  cache.h_max  = h_max;
+  cache.va_min = va_min;
+  cache.va_max = va_max;
+
+  // The airspaces are identified by their index in the airspace list.
+  SortableAirspaceList& loadedAirspaces = _globalMapContents->getAirspaceList();
+
+  QHash<const Airspace*, int> airspaceIndex;
+
+  for( int i = 0; i < loadedAirspaces.count(); i++ )
+    {
+      airspaceIndex.insert( &loadedAirspaces[i], i );
+    }
+
+  cache.airspaceKey = m_analysisAirspaces;
+
+  for( int i = 0; i < m_airspaceIntersections.size(); i++ )
     {
-      Flight::AirSpaceIntersection& asi = asStartIntersections[i];
+      AirSpaceIntersection& asi = m_airspaceIntersections[i];
+
+      FlightAnalysisCache::Intersection is;
+      is.airspace = airspaceIndex.value( asi.AirSpace(), -1 );
+      is.first = asi.FirstIndexPointinRoute();
+      is.last = asi.LastIndexPointinRoute();
+      is.maxPenetration = asi.MaxPenetration();
 
-      // update end point
-      asi.SetLastIndexPointinRoute( route.size() - 1 );
+      cache.intersections.append( is );
+    }
 
-      // Get conflict from the start list and put it in the finished list.
-      m_airspaceIntersections.append( asi );
+  for( int i = 0; i < m_olcPoints.size(); i++ )
+    {
+      cache.olcPoints.append( m_olcPoints[i] );
     }
+
+  cache.olcScore = m_olcScore;
+  cache.olcDistance = m_olcDistance;
+
+  cache.save( getFileName() );
 }
 
 bool Flight::loadQNH()
@@ -24,6 +24,7 @@
 #include <QList>
 #include <QString>
 #include <QStringList>
+#include <QVector>
 
 #include "baseflightelement.h"
 #include "flighttask.h"
@@ -31,6 +32,9 @@
 #include "optimization.h"
 #include "airspace.h"
 
+class FlightAnalysisCache;
+class GeoVectors;
+
 struct statePoint
 {
   int f_state;
@@ -69,18 +73,21 @@ class Flight : public BaseFlightElement
       AirSpaceIntersection( Airspace* AirSpace,
                             const int First,
                             const int Last,
-                            Airspace::ConflictType Type=Airspace::Inside ) :
+                            Airspace::ConflictType Type=Airspace::Inside,
+                            const float MaxPenetration=0.0 ) :
         m_AirSpace(AirSpace),
         m_TypeOfIntersection(Type),
         m_FirstPointIndexinRoute(First),
-        m_LastPointIndexinRoute(Last)
+        m_LastPointIndexinRoute(Last),
+        m_MaxPenetration(MaxPenetration)
       {};
 
       AirSpaceIntersection(const AirSpaceIntersection& other) :
         m_AirSpace(other.m_AirSpace),
         m_TypeOfIntersection(other.m_TypeOfIntersection),
         m_FirstPointIndexinRoute(other.m_FirstPointIndexinRoute),
-        m_LastPointIndexinRoute(other.m_LastPointIndexinRoute)
+        m_LastPointIndexinRoute(other.m_LastPointIndexinRoute),
+        m_MaxPenetration(other.m_MaxPenetration)
       {};
 
       Airspace* AirSpace()
@@ -101,12 +108,25 @@ class Flight : public BaseFlightElement
       void SetLastIndexPointinRoute( const int idx )
         { m_LastPointIndexinRoute = idx; };
 
+      /**
+       * Maximum vertical distance in meters to the nearest limited border of
+       * the airspace during the intersection. Zero, if the airspace has no
+       * vertical limits.
+       */
+      float MaxPenetration() const
+        { return m_MaxPenetration; };
+
+      /** Sort order of the intersection timeline. */
+      bool operator < (const AirSpaceIntersection& other) const
+        { return m_FirstPointIndexinRoute < other.m_FirstPointIndexinRoute; };
+
     protected:
 
       Airspace* m_AirSpace;
       Airspace::ConflictType m_TypeOfIntersection;
       int m_FirstPointIndexinRoute;
       int m_LastPointIndexinRoute;
+      float m_MaxPenetration;
     };
 
   class FlightStaticData
@@ -145,10 +165,13 @@ class Flight : public BaseFlightElement
    * @param  fileName  The name of the igc-file
    * @param  route  The logged flight-points
    * @param  flightData  The static data of the flight
+   * @param  cache  The analysis cache of the flight file. The derived data
+   *                are taken from it, if it is valid.
    */
   Flight( const QString& fileName,
           const QList<FlightPoint*>& route,
-          const FlightStaticData& flightStaticData );
+          const FlightStaticData& flightStaticData,
+          const FlightAnalysisCache* cache = 0 );
   /**
    * Destroys the flight-object.
    */
@@ -403,22 +426,16 @@ class Flight : public BaseFlightElement
   /** No descriptions */
   int getAnimationIndex();
 
-  /** No descriptions */
-  void setLastAnimationPixmap(QPixmap& newPixmap)
-  {
-    pixAnimate = newPixmap;
-  };
-
-  /** No descriptions */
-  QPixmap& getLastAnimationPixmap()
-  {
-    return pixAnimate;
-  };
-
-  /** No descriptions */
-  QPoint getLastAnimationPos(void);
-  /** No descriptions */
-  void setLastAnimationPos(QPoint pos);
+  /**
+   * Draws the flight path between two route points. Used by the animation
+   * to extend the flight, which was drawn up to the point "from", until
+   * the point "to". The same points are used as in drawMapElement().
+   *
+   * \param  targetP  The painter to draw the path into.
+   *
+   * \return The bounding rectangle of the drawn lines.
+   */
+  QRect drawAnimationPart( QPainter* targetP, const int from, const int to );
   /** Sets task begin and end time */
   void setTaskByTimes(int timeBegin,int timeEnd);
   /** Re-calculates all projections for this flight. */
@@ -502,7 +519,8 @@ class Flight : public BaseFlightElement
 private:
 
   /** */
-  unsigned int __calculateBestTask(unsigned int start[], unsigned int stop[],
+  unsigned int __calculateBestTask(const GeoVectors& vectors,
+      unsigned int start[], unsigned int stop[],
       unsigned int step, unsigned int idList[],
       double taskValue[], bool isTotal);
   /** */
@@ -512,21 +530,52 @@ private:
   void __setOptimizeRange(unsigned int start[], unsigned int stop[],
       unsigned int idList[], unsigned int id, unsigned int step);
   /** */
-  double __calculateOptimizePoints(FlightPoint* fp1,
-                                   FlightPoint* fp2,
-                                   FlightPoint* fp3);
-    /** */
-  void __checkMaxMin();
+  double __calculateOptimizePoints(const double dist1,
+                                   const double dist2,
+                                   const double dist3);
 
   /** Kreisflug?? */
   void __flightState();
 
-  /** calculate the basic en-route information, like dT, dH, dS, dBearing and bearing */
+  /**
+   * Calculates the basic en-route information, like dT, dH, dS, dBearing
+   * and bearing, and the indexes of the extreme values in one pass.
+   */
   void __calculateBasicInformation();
 
+  /**
+   * Fills the altitude columns and the projected bounding box of the flight
+   * points, which are used by the airspace checks.
+   */
+  void __calculateAltitudeColumns();
+
   /** calculates the smallest difference of two angles */
   float __diffAngle(float firstAngle, float secondAngle);
 
+  /**
+   * Creates the optimized task from the points found by the OLC optimization.
+   */
+  void __setOlcTask(const unsigned int idList[], double points, double distance);
+
+  /**
+   * Takes the derived data of the flight from the analysis cache. The
+   * airspace intersections are only taken, if the airspaces are unchanged.
+   *
+   * \return True, if the derived data of the points were taken.
+   */
+  bool __restoreAnalysis(const FlightAnalysisCache& cache);
+
+  /**
+   * Writes the derived data of the flight into the analysis cache file.
+   */
+  void __saveAnalysis();
+
+  /**
+   * \return A key of the loaded airspaces and the QNH, which are used by
+   *         the airspace intersections.
+   */
+  QByteArray __airspaceKey();
+
   /** The static data of the flight. */
   FlightStaticData m_flightStaticData;
 
@@ -556,14 +605,40 @@ private:
   /**  */
   bool bAnimationActive;
   bool taskTimesSet;
-  QPoint preAnimationPos;
-  QPixmap pixAnimate;
   /** */
   QStringList header;
 
-  /** List with airspaces, which were intersected during the flight. */
+  /**
+   * List with airspaces, which were intersected during the flight, ordered
+   * by the begin of the intersection.
+   */
   QList<AirSpaceIntersection> m_airspaceIntersections;
 
+  /**
+   * Pressure, ground and standard altitudes of the flight points in meters,
+   * one entry per route point.
+   */
+  QVector<float> m_altitudePressure;
+  QVector<float> m_altitudeGround;
+  QVector<float> m_altitudeStd;
+
+  /** Bounding box of the projected flight points. */
+  QRect m_projectedBox;
+
+  /** Hash of the flight file, used as key of the analysis cache. */
+  QByteArray m_analysisHash;
+
+  /** Airspace key of the current airspace intersections. */
+  QByteArray m_analysisAirspaces;
+
+  /** Key of the elevation source of the surface heights. */
+  QByteArray m_elevationKey;
+
+  /** Points, score and distance of the OLC optimization, if done. */
+  QVector<unsigned int> m_olcPoints;
+  double m_olcScore;
+  double m_olcDistance;
+
   /* The data type to be used for flight drawing. */
   enum MapConfig::DrawFlightPointType m_dfpt;
 };
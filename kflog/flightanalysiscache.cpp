@@ -0,0 +1,206 @@
+/***********************************************************************
+**
+**   flightanalysiscache.cpp
+**
+**   This file is part of KFLog.
+**
+************************************************************************
+**
+**   Copyright (c):  2026 by agent <agent@local>
+**
+**   This file is distributed under the terms of the General Public
+**   License. See the file COPYING for more information.
+**
+***********************************************************************/
+
+#include <QtCore>
+
+#include "flightanalysiscache.h"
+
+#define DATA_STREAM QDataStream::Qt_4_7
+
+// general KFLOG file token: @KFL
+#define KFLOG_FILE_MAGIC    0x404b464c
+
+// flight analysis cache file
+#define FILE_TYPE_FLIGHT_ANALYSIS  0x46
+
+// Must be increased, if a change of the flight analysis changes the results.
+#define FILE_VERSION_FLIGHT_ANALYSIS  102
+
+FlightAnalysisCache::FlightAnalysisCache() :
+  v_max(0),
+  h_max(0),
+  va_min(0),
+  va_max(0),
+  olcScore(0.0),
+  olcDistance(0.0),
+  m_valid(false)
+{
+}
+
+FlightAnalysisCache::~FlightAnalysisCache()
+{
+}
+
+QByteArray FlightAnalysisCache::fileHash( const QString& fileName )
+{
+  QFile file( fileName );
+
+  if( ! file.open( QIODevice::ReadOnly ) )
+    {
+      return QByteArray();
+    }
+
+  return QCryptographicHash::hash( file.readAll(), QCryptographicHash::Md5 );
+}
+
+bool FlightAnalysisCache::load( const QString& fileName,
+                                const QByteArray& fileHash,
+                                const int points )
+{
+  m_valid = false;
+  hash = fileHash;
+
+  if( hash.isEmpty() )
+    {
+      return false;
+    }
+
+  QFile file( cacheFileName( fileName ) );
+
+  if( ! file.exists() || ! file.open( QIODevice::ReadOnly ) )
+    {
+      return false;
+    }
+
+  QDataStream in( &file );
+  in.setVersion( DATA_STREAM );
+
+  quint32 magic = 0;
+  qint8 type = 0;
+  quint16 version = 0;
+  QByteArray storedHash;
+  qint32 count = 0;
+
+  in >> magic >> type >> version >> storedHash >> count;
+
+  if( magic != KFLOG_FILE_MAGIC || type != FILE_TYPE_FLIGHT_ANALYSIS ||
+      version != FILE_VERSION_FLIGHT_ANALYSIS || storedHash != hash ||
+      count != points )
+    {
+      return false;
+    }
+
+  in >> elevationKey >> surfaceHeight >> dH >> dT >> dS
+     >> bearing >> dBearing >> state
+     >> v_max >> h_max >> va_min >> va_max;
+
+  qint32 number = 0;
+
+  in >> airspaceKey >> number;
+
+  // An intersection takes at least 16 bytes. A corrupted number must not
+  // allocate more intersections than the rest of the file can contain.
+  if( number < 0 || qint64( number ) * 16 > file.bytesAvailable() )
+    {
+      in.setStatus( QDataStream::ReadCorruptData );
+      number = 0;
+    }
+
+  intersections.resize( number );
+
+  for( int i = 0; i < intersections.size() && in.status() == QDataStream::Ok; i++ )
+    {
+      Intersection& is = intersections[i];
+
+      in >> is.airspace >> is.first >> is.last >> is.maxPenetration;
+
+      if( is.first < 0 || is.last < is.first || is.last >= points )
+        {
+          in.setStatus( QDataStream::ReadCorruptData );
+        }
+    }
+
+  in >> olcPoints >> olcScore >> olcDistance;
+
+  if( in.status() != QDataStream::Ok ||
+      surfaceHeight.size() != points || dH.size() != points ||
+      dT.size() != points || dS.size() != points ||
+      bearing.size() != points || dBearing.size() != points ||
+      state.size() != points )
+    {
+      qWarning() << "FlightAnalysisCache: File" << file.fileName() << "is corrupted!";
+      return false;
+    }
+
+  for( int i = 0; i < olcPoints.size(); i++ )
+    {
+      if( olcPoints[i] >= (quint32) points )
+        {
+          olcPoints.clear();
+          break;
+        }
+    }
+
+  m_valid = true;
+  return true;
+}
+
+bool FlightAnalysisCache::save( const QString& fileName ) const
+{
+  if( hash.isEmpty() )
+    {
+      return false;
+    }
+
+  QString cacheName = cacheFileName( fileName );
+  QString tmpName   = cacheName + ".tmp";
+
+  QFile file( tmpName );
+
+  if( ! file.open( QIODevice::WriteOnly ) )
+    {
+      // The directory of the flight can be read only.
+      return false;
+    }
+
+  QDataStream out( &file );
+  out.setVersion( DATA_STREAM );
+
+  out << quint32( KFLOG_FILE_MAGIC )
+      << qint8( FILE_TYPE_FLIGHT_ANALYSIS )
+      << quint16( FILE_VERSION_FLIGHT_ANALYSIS )
+      << hash
+      << qint32( dH.size() );
+
+  out << elevationKey << surfaceHeight << dH << dT << dS
+      << bearing << dBearing << state
+      << v_max << h_max << va_min << va_max;
+
+  out << airspaceKey << qint32( intersections.size() );
+
+  for( int i = 0; i < intersections.size(); i++ )
+    {
+      const Intersection& is = intersections[i];
+
+      out << is.airspace << is.first << is.last << is.maxPenetration;
+    }
+
+  out << olcPoints << olcScore << olcDistance;
+
+  bool ok = (out.status() == QDataStream::Ok);
+
+  file.close();
+
+  if( ! ok )
+    {
+      qWarning() << "FlightAnalysisCache: Cannot write file" << tmpName;
+      file.remove();
+      return false;
+    }
+
+  QFile::remove( cacheName );
+
+  return QFile::rename( tmpName, cacheName );
+}
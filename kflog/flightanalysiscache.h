@@ -0,0 +1,155 @@
+/***********************************************************************
+**
+**   flightanalysiscache.h
+**
+**   This file is part of KFLog.
+**
+************************************************************************
+**
+**   Copyright (c):  2026 by agent <agent@local>
+**
+**   This file is distributed under the terms of the General Public
+**   License. See the file COPYING for more information.
+**
+***********************************************************************/
+
+/**
+ * \class FlightAnalysisCache
+ *
+ * \author agent
+ *
+ * \brief Persistent cache of the derived data of a flight.
+ *
+ * The cache is stored in a binary file beside the flight file. It contains
+ * the derived columns of the flight points, the flight state, the extreme
+ * values, the airspace intersections and the result of the OLC
+ * optimization. The cache is only used, if the MD5 hash of the flight file
+ * and the algorithm version are unchanged.
+ *
+ * The airspace intersections are stored together with a key of the loaded
+ * airspaces, because they depend on them, see \ref Flight. In the same way
+ * the surface heights are stored together with a key of the elevation
+ * source, see \ref ElevationFinder::sourceKey.
+ *
+ * \date 2026
+ *
+ * \version 1.0
+ */
+
+#ifndef FLIGHT_ANALYSIS_CACHE_H
+#define FLIGHT_ANALYSIS_CACHE_H
+
+#include <QByteArray>
+#include <QString>
+#include <QVector>
+
+class FlightAnalysisCache
+{
+ public:
+
+  /**
+   * Stored values of one airspace intersection.
+   */
+  class Intersection
+  {
+   public:
+
+    Intersection() :
+      airspace(0),
+      first(0),
+      last(0),
+      maxPenetration(0.0)
+    {};
+
+    /** Index of the airspace in the airspace list of the map contents. */
+    qint32 airspace;
+    qint32 first;
+    qint32 last;
+    float  maxPenetration;
+  };
+
+  FlightAnalysisCache();
+
+  virtual ~FlightAnalysisCache();
+
+  /**
+   * \return The MD5 hash of the content of the passed file.
+   */
+  static QByteArray fileHash( const QString& fileName );
+
+  /**
+   * \return The name of the cache file of the passed flight file.
+   */
+  static QString cacheFileName( const QString& fileName )
+  {
+    return fileName + ".kfa";
+  };
+
+  /**
+   * Reads the cache of a flight file. Can be called in any thread.
+   *
+   * \param fileName Name of the flight file
+   *
+   * \param fileHash Hash of the flight file. It is stored in \ref hash also
+   *        when the cache cannot be used.
+   *
+   * \param points Number of the flight points
+   *
+   * \return True, if a valid cache was found.
+   */
+  bool load( const QString& fileName, const QByteArray& fileHash, const int points );
+
+  /**
+   * Writes the cache of a flight file.
+   *
+   * \return True in case of success.
+   */
+  bool save( const QString& fileName ) const;
+
+  /**
+   * \return True, if the cache contains valid data.
+   */
+  bool isValid() const
+  {
+    return m_valid;
+  };
+
+  /** The hash of the flight file */
+  QByteArray hash;
+
+  /**
+   * Key of the elevation source, which was used for the surface heights.
+   * Empty, if the surface heights must not be taken from the cache.
+   */
+  QByteArray elevationKey;
+
+  /** The derived values of all flight points */
+  QVector<qint32> surfaceHeight;
+  QVector<qint32> dH;
+  QVector<qint32> dT;
+  QVector<qint32> dS;
+  QVector<float>  bearing;
+  QVector<float>  dBearing;
+  QVector<quint8> state;
+
+  /** The indexes of the extreme values */
+  quint32 v_max;
+  quint32 h_max;
+  quint32 va_min;
+  quint32 va_max;
+
+  /** Key of the airspaces, which were used for the intersections. */
+  QByteArray airspaceKey;
+  QVector<Intersection> intersections;
+
+  /** The result of the OLC optimization. Empty, if not optimized. */
+  QVector<quint32> olcPoints;
+  double olcScore;
+  double olcDistance;
+
+ private:
+
+  bool m_valid;
+};
+
+#endif
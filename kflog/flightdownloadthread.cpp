@@ -0,0 +1,160 @@
+/***********************************************************************
+**
+**   flightdownloadthread.cpp
+**
+**   This file is part of KFLog.
+**
+************************************************************************
+**
+**   Copyright (c):  2026 by agent <agent@local>
+**
+**   This file is distributed under the terms of the General Public
+**   License. See the file COPYING for more information.
+**
+***********************************************************************/
+
+#include <csignal>
+
+#include <QtCore>
+
+#include "flightdownloadthread.h"
+#include "flightrecorderpluginbase.h"
+
+FlightDownloadThread::FlightDownloadThread( FlightRecorderPluginBase* recorder,
+                                            const QList<Job>& jobs,
+                                            const bool signedFlights,
+                                            const int retries,
+                                            int* breakTransfer,
+                                            QObject *parent ) :
+  QThread( parent ),
+  m_recorder(recorder),
+  m_jobs(jobs),
+  m_signed(signedFlights),
+  m_retries(qMax( retries, 0 )),
+  m_breakTransfer(breakTransfer),
+  m_canceled(false)
+{
+  setObjectName( "FlightDownloadThread" );
+}
+
+FlightDownloadThread::~FlightDownloadThread()
+{
+}
+
+void FlightDownloadThread::cancel()
+{
+  QMutexLocker locker( &m_mutex );
+  m_canceled = true;
+
+  if( m_breakTransfer != 0 )
+    {
+      // Let the plugin abort the running transfer.
+      *m_breakTransfer = 1;
+    }
+}
+
+bool FlightDownloadThread::isCanceled()
+{
+  QMutexLocker locker( &m_mutex );
+  return m_canceled;
+}
+
+void FlightDownloadThread::run()
+{
+#ifndef WIN32
+  sigset_t sigset;
+  sigfillset( &sigset );
+
+  // deactivate all signals in this thread
+  pthread_sigmask( SIG_SETMASK, &sigset, 0 );
+#endif
+
+  int downloaded = 0;
+  int failed     = 0;
+
+  for( int i = 0; i < m_jobs.size() && ! isCanceled(); i++ )
+    {
+      const Job& job = m_jobs.at(i);
+
+      emit downloadStarted( i, m_jobs.size(), job.fileName );
+
+      // A partial file of a failed download is only removed, if the file
+      // did not exist before.
+      bool existed = QFile::exists( job.fileName );
+      bool ok      = false;
+      QString error;
+
+      for( int retry = 0; retry <= m_retries && ! isCanceled(); retry++ )
+        {
+          if( retry > 0 )
+            {
+              emit downloadRetry( i, retry, error );
+
+              // Give the recorder time to leave a broken transfer.
+              msleep( 1000 );
+            }
+
+          {
+            QMutexLocker locker( &m_mutex );
+
+            if( m_canceled )
+              {
+                break;
+              }
+
+            if( m_breakTransfer != 0 )
+              {
+                *m_breakTransfer = 0;
+              }
+          }
+
+          int ret = m_recorder->downloadFlight( job.flightID, m_signed, job.fileName );
+
+          if( ret >= FR_OK )
+            {
+              ok = true;
+              break;
+            }
+
+          error = m_recorder->lastError();
+
+          if( ret == FR_NOTSUPPORTED )
+            {
+              break;
+            }
+        }
+
+      if( ok )
+        {
+          downloaded++;
+        }
+      else
+        {
+          if( ! existed )
+            {
+              QFile::remove( job.fileName );
+            }
+
+          if( error.isEmpty() )
+            {
+              error = isCanceled() ? tr("Download canceled") :
+                                     tr("Cannot download flight from recorder.");
+            }
+
+          failed++;
+        }
+
+      emit downloadFinished( i, ok, job.fileName, error );
+    }
+
+  m_mutex.lock();
+
+  if( m_breakTransfer != 0 )
+    {
+      *m_breakTransfer = 0;
+    }
+
+  m_mutex.unlock();
+
+  emit queueFinished( downloaded, failed, isCanceled() );
+}
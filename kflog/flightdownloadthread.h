@@ -0,0 +1,170 @@
+/***********************************************************************
+**
+**   flightdownloadthread.h
+**
+**   This file is part of KFLog.
+**
+************************************************************************
+**
+**   Copyright (c):  2026 by agent <agent@local>
+**
+**   This file is distributed under the terms of the General Public
+**   License. See the file COPYING for more information.
+**
+***********************************************************************/
+
+/**
+ * \class FlightDownloadThread
+ *
+ * \author agent
+ *
+ * \brief Downloads a queue of flights from a recorder in an extra thread.
+ *
+ * The flights are downloaded back to back by the recorder plugin. A failed
+ * download is repeated up to the passed number of retries. The state of the
+ * queue is reported by signals, which are delivered to the receivers in the
+ * GUI thread. The plugin must not be used by other threads, as long as the
+ * download is running.
+ *
+ * A cancel request stops the queue after the current flight. If the plugin
+ * exports the variable breakTransfer, the current flight is aborted too.
+ * The variable is a plain int of the plugin, which is set by the GUI thread
+ * and polled by the plugin in the download thread between the transferred
+ * blocks. Both threads write it only under the cancel mutex, so that a
+ * cancel request cannot be reset by the start of the next try.
+ *
+ * \date 2026
+ *
+ * \version 1.0
+ */
+
+#ifndef FLIGHT_DOWNLOAD_THREAD_H
+#define FLIGHT_DOWNLOAD_THREAD_H
+
+#include <QList>
+#include <QMutex>
+#include <QString>
+#include <QThread>
+
+class FlightRecorderPluginBase;
+
+class FlightDownloadThread : public QThread
+{
+  Q_OBJECT
+
+ private:
+
+  Q_DISABLE_COPY ( FlightDownloadThread )
+
+ public:
+
+  /** One flight of the download queue. */
+  class Job
+  {
+   public:
+
+    Job( const int id=0, const QString& name="" ) :
+      flightID(id),
+      fileName(name)
+    {};
+
+    /** Index of the flight in the directory of the recorder */
+    int flightID;
+
+    /** Name of the IGC file */
+    QString fileName;
+  };
+
+  /**
+   * \param recorder The connected recorder plugin
+   *
+   * \param jobs The flights to be downloaded
+   *
+   * \param signedFlights Download signed flights, if true
+   *
+   * \param retries Number of repetitions of a failed download
+   *
+   * \param breakTransfer Abort flag of the plugin or 0
+   *
+   * \param parent The parent object
+   */
+  FlightDownloadThread( FlightRecorderPluginBase* recorder,
+                        const QList<Job>& jobs,
+                        const bool signedFlights,
+                        const int retries,
+                        int* breakTransfer,
+                        QObject *parent=0 );
+
+  virtual ~FlightDownloadThread();
+
+  /**
+   * Requests the abort of the download queue. Can be called from any thread.
+   */
+  void cancel();
+
+  /**
+   * \return True, if the abort of the queue was requested.
+   */
+  bool isCanceled();
+
+ protected:
+
+  /**
+   * That is the main method of the thread.
+   */
+  void run();
+
+ signals:
+
+  /**
+   * Emitted, when the download of a flight is started.
+   *
+   * \param job Index of the flight in the queue
+   * \param jobs Number of flights in the queue
+   * \param fileName Name of the IGC file
+   */
+  void downloadStarted( int job, int jobs, const QString& fileName );
+
+  /**
+   * Emitted, when a failed download is repeated.
+   *
+   * \param job Index of the flight in the queue
+   * \param retry Number of the repetition
+   * \param error Reason of the failed download
+   */
+  void downloadRetry( int job, int retry, const QString& error );
+
+  /**
+   * Emitted, when the download of a flight is finished.
+   *
+   * \param job Index of the flight in the queue
+   * \param ok True, if the flight was downloaded
+   * \param fileName Name of the IGC file
+   * \param error Reason of a failed download
+   */
+  void downloadFinished( int job, bool ok, const QString& fileName,
+                         const QString& error );
+
+  /**
+   * Emitted, when the queue is finished.
+   *
+   * \param downloaded Number of the downloaded flights
+   * \param failed Number of the failed flights
+   * \param canceled True, if the queue was canceled
+   */
+  void queueFinished( int downloaded, int failed, bool canceled );
+
+ private:
+
+  FlightRecorderPluginBase* m_recorder;
+  QList<Job>                m_jobs;
+  bool                      m_signed;
+  int                       m_retries;
+  int*                      m_breakTransfer;
+
+  /** Protects the cancel flag and the writes of the abort flag. */
+  QMutex m_mutex;
+  bool   m_canceled;
+};
+
+#endif
@@ -21,19 +21,70 @@
 #include "flightgroup.h"
 #include "mapcalc.h"
 
+const double FlightGroup::GaggleRadius = 1.0;
+const int    FlightGroup::GaggleHeight = 200;
+
 FlightGroup::FlightGroup(const QString& fName) :
-  BaseFlightElement("flight group", BaseMapElement::FlightGroup, fName)
+  BaseFlightElement("flight group", BaseMapElement::FlightGroup, fName),
+  m_timeIndex(0)
 {
 }
 
 FlightGroup::FlightGroup(const QList<class Flight *>& fList, const QString& fName) :
   BaseFlightElement("flight group", BaseMapElement::FlightGroup, fName),
-  flightList(fList)
+  flightList(fList),
+  m_timeIndex(0)
 {
 }
 
 FlightGroup::~FlightGroup()
 {
+  clearTimeIndex();
+}
+
+const FlightGroupIndex* FlightGroup::getTimeIndex()
+{
+  if( m_timeIndex == 0 )
+    {
+      m_timeIndex = new FlightGroupIndex( flightList );
+    }
+
+  return m_timeIndex;
+}
+
+const QVector<int>& FlightGroup::getGaggleTimes()
+{
+  if( m_gaggleTimes.isEmpty() && ! flightList.isEmpty() )
+    {
+      const FlightGroupIndex* index = getTimeIndex();
+
+      m_gaggleTimes.fill( 0, flightList.size() );
+
+      for( int s = 0; s < index->slots(); s++ )
+        {
+          const time_t time = index->startTime() + time_t( s ) * index->step();
+
+          QList< QList<int> > gaggles =
+            index->getGaggles( time, GaggleRadius, GaggleHeight );
+
+          for( int i = 0; i < gaggles.size(); i++ )
+            {
+              for( int j = 0; j < gaggles.at(i).size(); j++ )
+                {
+                  m_gaggleTimes[gaggles.at(i).at(j)] += index->step();
+                }
+            }
+        }
+    }
+
+  return m_gaggleTimes;
+}
+
+void FlightGroup::clearTimeIndex()
+{
+  delete m_timeIndex;
+  m_timeIndex = 0;
+  m_gaggleTimes.clear();
 }
 
 bool FlightGroup::drawMapElement( QPainter* targetP )
@@ -73,6 +124,7 @@ void FlightGroup::removeFlight(BaseFlightElement *f)
   if( flightList.contains( flight ) )
     {
       flightList.removeOne( flight );
+      clearTimeIndex();
     }
 }
 
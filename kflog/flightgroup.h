@@ -21,10 +21,12 @@
 
 #include "baseflightelement.h"
 #include "flight.h"
+#include "flightgroupindex.h"
 
 #include <QList>
 #include <QString>
 #include <QPainter>
+#include <QVector>
 
 /**
  * \class FlightGroup
@@ -104,8 +106,30 @@ class FlightGroup : public BaseFlightElement
   void setFlightList(QList<class Flight *>& fl)
   {
     flightList = fl;
+    clearTimeIndex();
   };
 
+  /**
+   * Returns the time aligned index of the flights in the group. The index is
+   * built at the first call after a change of the flight list.
+   */
+  const FlightGroupIndex* getTimeIndex();
+
+  /**
+   * Returns for every flight of the group the seconds, which it has flown
+   * in a gaggle with other flights of the group. A flight is in a gaggle, if
+   * another flight is not farther away than GaggleRadius and GaggleHeight.
+   * The times are computed with the time index and kept until the flight
+   * list is changed.
+   */
+  const QVector<int>& getGaggleTimes();
+
+  /** Maximum horizontal distance in km of the flights of a gaggle. */
+  static const double GaggleRadius;
+
+  /** Maximum altitude difference in meters of the flights of a gaggle. */
+  static const int GaggleHeight;
+
   /**
    * re-project the flights in this flight group. Reimplemented from BaseFlightElement.
    */
@@ -113,7 +137,16 @@ class FlightGroup : public BaseFlightElement
 
  private:
 
+  /** Removes the time index, because the flight list has been changed. */
+  void clearTimeIndex();
+
   QList<class Flight *> flightList;
+
+  /** Time aligned index of the flights, built on demand. */
+  FlightGroupIndex* m_timeIndex;
+
+  /** Gaggle times of the flights, computed on demand. */
+  QVector<int> m_gaggleTimes;
 };
 
 #endif
@@ -0,0 +1,418 @@
+/***********************************************************************
+**
+**   flightgroupindex.cpp
+**
+**   This file is part of KFLog.
+**
+************************************************************************
+**
+**   Copyright (c):  2026 by agent <agent@local>
+**
+**   This file is distributed under the terms of the General Public
+**   License. See the file COPYING for more information.
+**
+***********************************************************************/
+
+#include <cmath>
+#include <cstdlib>
+
+#include <QtCore>
+
+#include "flight.h"
+#include "flightgroupindex.h"
+#include "flightpoint.h"
+#include "geovectors.h"
+
+/** Maximum span of the time grid in seconds. */
+static const time_t MaxSpan = 24 * 3600;
+
+/** Maximum number of grid elements, i.e. grid times multiplied by flights. */
+static const qint64 MaxElements = 4 * 1024 * 1024;
+
+FlightGroupIndex::FlightGroupIndex( const QList<Flight*>& flights, const int step ) :
+  m_flights( flights.size() ),
+  m_slots( 0 ),
+  m_step( qMax( step, 1 ) ),
+  m_startTime( 0 ),
+  m_shifts( flights.size(), 0 )
+{
+  QList< QList<FlightPoint*> > routes;
+
+  time_t refTime = 0;
+  time_t endTime = 0;
+  bool first = true;
+
+  for( int i = 0; i < flights.size(); i++ )
+    {
+      routes.append( flights.at(i)->getRoute() );
+
+      const QList<FlightPoint*>& route = routes.last();
+
+      if( route.isEmpty() )
+        {
+          continue;
+        }
+
+      const time_t start = route.first()->time;
+
+      if( first )
+        {
+          refTime = start;
+        }
+
+      // Same alignment as in Map::__prepareAnimation.
+      m_shifts[i] = (time_t) qRound( (start - refTime) / 86400.0 ) * 86400;
+
+      if( first || start - m_shifts[i] < m_startTime )
+        {
+          m_startTime = start - m_shifts[i];
+        }
+
+      if( first || route.last()->time - m_shifts[i] > endTime )
+        {
+          endTime = route.last()->time - m_shifts[i];
+        }
+
+      first = false;
+    }
+
+  if( first || endTime < m_startTime )
+    {
+      return;
+    }
+
+  endTime = qMin( endTime, m_startTime + MaxSpan );
+
+  qint64 size = ( qint64( endTime - m_startTime ) / m_step + 1 ) * m_flights;
+
+  if( size > MaxElements )
+    {
+      // Enlarge the step, so that the grid fits into the limit.
+      const qint64 slots = qMax( MaxElements / m_flights, qint64( 2 ) );
+
+      m_step = (int) ( ( endTime - m_startTime ) / ( slots - 1 ) + 1 );
+      size   = ( qint64( endTime - m_startTime ) / m_step + 1 ) * m_flights;
+    }
+
+  m_slots = (int) ( size / m_flights );
+
+  const int elements = (int) size;
+
+  m_valid.fill( 0, elements );
+  m_lat.resize( elements );
+  m_lon.resize( elements );
+  m_altitude.resize( elements );
+  m_x.resize( elements );
+  m_y.resize( elements );
+  m_z.resize( elements );
+
+  // Every task writes only the elements of its flight.
+  QThreadPool pool;
+  QList<FlightGroupIndexTask *> tasks;
+
+  for( int i = 0; i < routes.size(); i++ )
+    {
+      FlightGroupIndexTask* task = new FlightGroupIndexTask( this, i, routes.at(i) );
+      task->setAutoDelete( false );
+      tasks.append( task );
+      pool.start( task );
+    }
+
+  pool.waitForDone();
+  qDeleteAll( tasks );
+}
+
+FlightGroupIndex::~FlightGroupIndex()
+{
+}
+
+void FlightGroupIndex::resample( const int flight, const QList<FlightPoint*>& route )
+{
+  if( route.isEmpty() )
+    {
+      return;
+    }
+
+  char*   valid    = m_valid.data();
+  int*    lat      = m_lat.data();
+  int*    lon      = m_lon.data();
+  int*    altitude = m_altitude.data();
+  double* x        = m_x.data();
+  double* y        = m_y.data();
+  double* z        = m_z.data();
+
+  // The grid times are converted into times of the flight.
+  const time_t shift = m_shifts.at( flight );
+  const time_t first = route.first()->time;
+  const time_t last  = route.last()->time;
+
+  int j = 0;
+
+  for( int s = 0; s < m_slots; s++ )
+    {
+      const time_t time = m_startTime + shift + time_t( s ) * m_step;
+
+      if( time < first )
+        {
+          continue;
+        }
+
+      if( time > last )
+        {
+          break;
+        }
+
+      // Search the segment containing the grid time.
+      while( j + 1 < route.size() && route.at(j + 1)->time < time )
+        {
+          j++;
+        }
+
+      const FlightPoint* p1 = route.at(j);
+      const FlightPoint* p2 = route.at( qMin( j + 1, route.size() - 1 ) );
+
+      double f = 0.0;
+
+      if( p2->time > p1->time )
+        {
+          f = double( time - p1->time ) / double( p2->time - p1->time );
+          f = qBound( 0.0, f, 1.0 );
+        }
+
+      const int idx = s * m_flights + flight;
+
+      lat[idx] = p1->origP.lat() + (int) rint( f * ( p2->origP.lat() - p1->origP.lat() ) );
+      lon[idx] = p1->origP.lon() + (int) rint( f * ( p2->origP.lon() - p1->origP.lon() ) );
+      altitude[idx] = p1->height + (int) rint( f * ( p2->height - p1->height ) );
+
+      GeoVectors::toUnitVector( QPoint( lat[idx], lon[idx] ), x[idx], y[idx], z[idx] );
+      valid[idx] = 1;
+    }
+}
+
+int FlightGroupIndex::slot( const time_t time ) const
+{
+  if( m_slots == 0 || time < m_startTime )
+    {
+      return -1;
+    }
+
+  const int s = ( time - m_startTime + m_step / 2 ) / m_step;
+
+  return ( s < m_slots ) ? s : -1;
+}
+
+bool FlightGroupIndex::getPosition( const int flight, const time_t time,
+                                    QPoint& position, int& altitude ) const
+{
+  const int s = slot( time );
+
+  if( s < 0 || flight < 0 || flight >= m_flights )
+    {
+      return false;
+    }
+
+  const int idx = s * m_flights + flight;
+
+  if( m_valid[idx] == 0 )
+    {
+      return false;
+    }
+
+  position = QPoint( m_lat[idx], m_lon[idx] );
+  altitude = m_altitude[idx];
+  return true;
+}
+
+int FlightGroupIndex::getPositions( const time_t time,
+                                    QVector<int>& flights,
+                                    QVector<QPoint>& positions,
+                                    QVector<int>& altitudes ) const
+{
+  flights.clear();
+  positions.clear();
+  altitudes.clear();
+
+  const int s = slot( time );
+
+  if( s < 0 )
+    {
+      return 0;
+    }
+
+  const int base = s * m_flights;
+
+  for( int f = 0; f < m_flights; f++ )
+    {
+      const int idx = base + f;
+
+      if( m_valid[idx] )
+        {
+          flights.append( f );
+          positions.append( QPoint( m_lat[idx], m_lon[idx] ) );
+          altitudes.append( m_altitude[idx] );
+        }
+    }
+
+  return flights.size();
+}
+
+void FlightGroupIndex::getDistances( const int flight1, const int flight2,
+                                     QVector<double>& distances ) const
+{
+  distances.fill( -1.0, m_slots );
+
+  if( flight1 < 0 || flight1 >= m_flights ||
+      flight2 < 0 || flight2 >= m_flights )
+    {
+      return;
+    }
+
+  for( int s = 0; s < m_slots; s++ )
+    {
+      const int i1 = s * m_flights + flight1;
+      const int i2 = s * m_flights + flight2;
+
+      if( m_valid[i1] == 0 || m_valid[i2] == 0 )
+        {
+          continue;
+        }
+
+      const double dx = m_x[i1] - m_x[i2];
+      const double dy = m_y[i1] - m_y[i2];
+      const double dz = m_z[i1] - m_z[i2];
+
+      distances[s] = GeoVectors::chordToKm( dx * dx + dy * dy + dz * dz );
+    }
+}
+
+QList< QList<int> > FlightGroupIndex::getGaggles( const time_t time,
+                                                  const double radius,
+                                                  const int height,
+                                                  const int minCount ) const
+{
+  QList< QList<int> > gaggles;
+
+  const int s = slot( time );
+
+  if( s < 0 )
+    {
+      return gaggles;
+    }
+
+  const int base = s * m_flights;
+
+  // The neighbourhood of the flights is joined with a union find structure.
+  QVector<int> parent( m_flights );
+
+  for( int f = 0; f < m_flights; f++ )
+    {
+      parent[f] = f;
+    }
+
+  for( int f1 = 0; f1 < m_flights; f1++ )
+    {
+      const int i1 = base + f1;
+
+      if( m_valid[i1] == 0 )
+        {
+          continue;
+        }
+
+      for( int f2 = f1 + 1; f2 < m_flights; f2++ )
+        {
+          const int i2 = base + f2;
+
+          if( m_valid[i2] == 0 ||
+              abs( m_altitude[i1] - m_altitude[i2] ) > height )
+            {
+              continue;
+            }
+
+          const double dx = m_x[i1] - m_x[i2];
+          const double dy = m_y[i1] - m_y[i2];
+          const double dz = m_z[i1] - m_z[i2];
+
+          if( GeoVectors::chordToKm( dx * dx + dy * dy + dz * dz ) > radius )
+            {
+              continue;
+            }
+
+          int r1 = f1;
+          int r2 = f2;
+
+          while( parent[r1] != r1 )
+            {
+              r1 = parent[r1];
+            }
+
+          while( parent[r2] != r2 )
+            {
+              r2 = parent[r2];
+            }
+
+          if( r1 != r2 )
+            {
+              parent[qMax( r1, r2 )] = qMin( r1, r2 );
+            }
+        }
+    }
+
+  // Collect the members of every root in ascending order.
+  QVector<int> gaggleOfRoot( m_flights, -1 );
+  QList< QList<int> > groups;
+
+  for( int f = 0; f < m_flights; f++ )
+    {
+      if( m_valid[base + f] == 0 )
+        {
+          continue;
+        }
+
+      int r = f;
+
+      while( parent[r] != r )
+        {
+          r = parent[r];
+        }
+
+      if( gaggleOfRoot[r] < 0 )
+        {
+          gaggleOfRoot[r] = groups.size();
+          groups.append( QList<int>() );
+        }
+
+      groups[gaggleOfRoot[r]].append( f );
+    }
+
+  for( int i = 0; i < groups.size(); i++ )
+    {
+      if( groups.at(i).size() >= minCount )
+        {
+          gaggles.append( groups.at(i) );
+        }
+    }
+
+  return gaggles;
+}
+
+/*---------------------- FlightGroupIndexTask --------------------------------*/
+
+FlightGroupIndexTask::FlightGroupIndexTask( FlightGroupIndex* index,
+                                            const int flight,
+                                            const QList<FlightPoint*>& route ) :
+  QRunnable(),
+  m_index(index),
+  m_flight(flight),
+  m_route(route)
+{
+}
+
+FlightGroupIndexTask::~FlightGroupIndexTask()
+{
+}
+
+void FlightGroupIndexTask::run()
+{
+  m_index->resample( m_flight, m_route );
+}
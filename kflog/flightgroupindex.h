@@ -0,0 +1,237 @@
+/***********************************************************************
+**
+**   flightgroupindex.h
+**
+**   This file is part of KFLog.
+**
+************************************************************************
+**
+**   Copyright (c):  2026 by agent <agent@local>
+**
+**   This file is distributed under the terms of the General Public
+**   License. See the file COPYING for more information.
+**
+***********************************************************************/
+
+/**
+ * \class FlightGroupIndex
+ *
+ * \author agent
+ *
+ * \brief Time aligned index of the flights of a flight group.
+ *
+ * All flights are resampled by linear interpolation onto a common time grid.
+ * Flights of different days are shifted by whole days, as it is done by the
+ * animation of the map, so that they are compared at the same time of day.
+ * All times of the queries are times at the day of the first flight.
+ *
+ * The grid spans at most one day. If the grid would become too big, the
+ * distance of the grid times is enlarged.
+ *
+ * The values of one grid time are stored side by side for all flights, so
+ * that a query for a time has to read only one contiguous block. Besides
+ * the coordinates and the altitude, the unit vector of every position is
+ * stored for fast distance calculations, see \ref GeoVectors.
+ *
+ * The resampling of the flights is done in parallel in a thread pool.
+ *
+ * \date 2026
+ *
+ * \version 1.0
+ */
+
+#ifndef FLIGHT_GROUP_INDEX_H
+#define FLIGHT_GROUP_INDEX_H
+
+#include <ctime>
+
+#include <QList>
+#include <QPoint>
+#include <QRunnable>
+#include <QVector>
+
+class Flight;
+class FlightPoint;
+
+class FlightGroupIndex
+{
+ public:
+
+  /**
+   * Builds the index of the passed flights.
+   *
+   * \param flights Flights to be indexed. The flight numbers used by the
+   *        queries are the positions in this list.
+   *
+   * \param step Distance of the grid times in seconds.
+   */
+  FlightGroupIndex( const QList<Flight*>& flights, const int step = 4 );
+
+  virtual ~FlightGroupIndex();
+
+  /**
+   * \return The number of indexed flights.
+   */
+  int flights() const
+  {
+    return m_flights;
+  };
+
+  /**
+   * \return The number of grid times.
+   */
+  int slots() const
+  {
+    return m_slots;
+  };
+
+  /**
+   * \return The first grid time.
+   */
+  time_t startTime() const
+  {
+    return m_startTime;
+  };
+
+  /**
+   * \return The distance of the grid times in seconds.
+   */
+  int step() const
+  {
+    return m_step;
+  };
+
+  /**
+   * \return The whole days in seconds, which are subtracted from the times
+   *         of the passed flight to align it with the first flight.
+   */
+  time_t shift( const int flight ) const
+  {
+    return m_shifts.value( flight, 0 );
+  };
+
+  /**
+   * \return The grid slot nearest to the passed time or -1, if the time is
+   *         outside of the grid.
+   */
+  int slot( const time_t time ) const;
+
+  /**
+   * Returns the position of a flight at the passed time.
+   *
+   * \param flight Number of the flight
+   *
+   * \param time Time of the position
+   *
+   * \param position The position in KFLog coordinates
+   *
+   * \param altitude The pressure altitude in meters
+   *
+   * \return True, if the flight was in the air at that time.
+   */
+  bool getPosition( const int flight, const time_t time,
+                    QPoint& position, int& altitude ) const;
+
+  /**
+   * Returns the numbers of all flights, which were in the air at the passed
+   * time, together with their positions and altitudes.
+   */
+  int getPositions( const time_t time,
+                    QVector<int>& flights,
+                    QVector<QPoint>& positions,
+                    QVector<int>& altitudes ) const;
+
+  /**
+   * Computes the distance in km between two flights for every grid time. The
+   * distance is set to -1, if one of the flights was not in the air.
+   */
+  void getDistances( const int flight1, const int flight2,
+                     QVector<double>& distances ) const;
+
+  /**
+   * Finds the gaggles at the passed time. A flight belongs to a gaggle, if
+   * it is not farther away than the given radius and altitude difference
+   * from another flight of the gaggle.
+   *
+   * \param time Time of the search
+   *
+   * \param radius Maximum horizontal distance in km
+   *
+   * \param height Maximum altitude difference in meters
+   *
+   * \param minCount Minimum number of flights of a gaggle
+   *
+   * \return The gaggles as lists of flight numbers
+   */
+  QList< QList<int> > getGaggles( const time_t time,
+                                  const double radius,
+                                  const int height,
+                                  const int minCount = 2 ) const;
+
+ private:
+
+  friend class FlightGroupIndexTask;
+
+  /**
+   * Resamples one flight onto the time grid. Called by the thread pool.
+   */
+  void resample( const int flight, const QList<FlightPoint*>& route );
+
+  int    m_flights;
+  int    m_slots;
+  int    m_step;
+  time_t m_startTime;
+
+  /** Day shift of every flight in seconds. */
+  QVector<time_t> m_shifts;
+
+  /**
+   * The values of all flights at one grid time are stored side by side. The
+   * element of a flight f at the grid slot s has the index s * m_flights + f.
+   */
+  QVector<char>   m_valid;
+  QVector<int>    m_lat;
+  QVector<int>    m_lon;
+  QVector<int>    m_altitude;
+  QVector<double> m_x;
+  QVector<double> m_y;
+  QVector<double> m_z;
+};
+
+/**
+ * \class FlightGroupIndexTask
+ *
+ * \author agent
+ *
+ * \brief Resamples one flight of a \ref FlightGroupIndex in a thread pool.
+ *
+ * Every task writes only the elements of its own flight, so that no locking
+ * is needed.
+ *
+ * \date 2026
+ *
+ * \version 1.0
+ */
+class FlightGroupIndexTask : public QRunnable
+{
+ public:
+
+  FlightGroupIndexTask( FlightGroupIndex* index,
+                        const int flight,
+                        const QList<FlightPoint*>& route );
+
+  virtual ~FlightGroupIndexTask();
+
+  /**
+   * Resamples the flight. Called by the thread pool.
+   */
+  void run();
+
+ private:
+
+  FlightGroupIndex*   m_index;
+  int                 m_flight;
+  QList<FlightPoint*> m_route;
+};
+
+#endif
@@ -67,80 +67,313 @@ FlightLoader::~FlightLoader()
 
 bool FlightLoader::openFlight(QFile& flightFile)
 {
-  QFileInfo fInfo(flightFile);
+  return openFlights( QStringList( flightFile.fileName() ) ).size() > 0;
+}
+
+QStringList FlightLoader::openFlights(const QStringList& files)
+{
+  QStringList loaded;
+  QStringList errors;
+  QString error;
+
+  QThreadPool pool;
+  QList<FlightLoadTask *> tasks;
+
+  for( int i = 0; i < files.size(); i++ )
+    {
+      if( __checkFile( files.at(i), error ) == false )
+        {
+          errors.append( error );
+          continue;
+        }
+
+      FlightLoadTask* task = new FlightLoadTask( files.at(i) );
+      task->setAutoDelete( false );
+      tasks.append( task );
+      pool.start( task );
+    }
+
+  if( tasks.size() > 0 )
+    {
+      QProgressDialog importProgress( _mainWindow );
+      importProgress.setWindowModality(Qt::WindowModal);
+      importProgress.setWindowTitle(QObject::tr("Loading flight..."));
+      importProgress.setMinimumWidth(importProgress.sizeHint().width() + 45);
+      importProgress.setRange(0, tasks.size() * 100);
+      importProgress.setMinimumDuration(0);
+      importProgress.setValue(0);
+
+      // The cancel method of QProgressDialog did not work, if signal canceled is
+      // not catched!
+      connect(&importProgress, SIGNAL(canceled()), this, SLOT(slot_CancelLoad()));
+
+      // The parsed flights are created in the order of the file list, while
+      // the remaining files are still parsed by the pool.
+      int next = 0;
+
+      while( next < tasks.size() )
+        {
+          if( importProgress.wasCanceled() )
+            {
+              for( int i = next; i < tasks.size(); i++ )
+                {
+                  tasks.at(i)->cancel();
+                }
+
+              break;
+            }
+
+          FlightLoadTask* task = tasks.at(next);
+
+          importProgress.setLabelText(
+              "<html>" + QObject::tr("Please wait while loading file %1 of %2<BR><B>%3</B>")
+                         .arg(next + 1).arg(tasks.size()).arg(task->fileName()) + "</html>");
 
-  if(! flightFile.exists() )
+          int progress = next * 100;
+
+          for( int i = next; i < tasks.size(); i++ )
+            {
+              progress += tasks.at(i)->progress();
+            }
+
+          importProgress.setValue( progress );
+
+          if( task->isFinished() == false )
+            {
+              // Wait a moment and keep the GUI alive.
+              QEventLoop loop;
+              QTimer::singleShot( 50, &loop, SLOT(quit()) );
+              loop.exec();
+              continue;
+            }
+
+          if( __createFlight( task, error ) )
+            {
+              loaded.append( task->fileName() );
+            }
+          else
+            {
+              errors.append( error );
+            }
+
+          next++;
+        }
+
+      pool.waitForDone();
+      qDeleteAll( tasks );
+    }
+
+  if( errors.size() > 0 )
     {
-      QMessageBox::warning(_mainWindow, QObject::tr("File does not exist"),
-          "<html>" + QObject::tr("The selected file<BR><B>%1</B><BR>does not exist!").arg(flightFile.fileName()) + "</html>", QMessageBox::Ok);
+      QMessageBox::warning( _mainWindow,
+                            QObject::tr("Error while loading flights"),
+                            "<html>" + errors.join("<BR><BR>") + "</html>",
+                            QMessageBox::Ok );
+    }
+
+  return loaded;
+}
+
+bool FlightLoader::__checkFile(const QString& fileName, QString& error)
+{
+  QFileInfo fInfo(fileName);
+
+  if(! fInfo.exists() )
+    {
+      error = QObject::tr("The selected file<BR><B>%1</B><BR>does not exist!").arg(fileName);
       return false;
     }
 
   if( fInfo.suffix().toLower() == "kfp")
-  {
-      QMessageBox::warning(_mainWindow, QObject::tr("File is empty"),
-          "<html>" + QObject::tr("Cannot open the selected file<BR><B>%1</B><BR>directly. Please open the flight file instead.").arg(flightFile.fileName()) + "</html>", QMessageBox::Ok);
+    {
+      error = QObject::tr("Cannot open the selected file<BR><B>%1</B><BR>directly. Please open the flight file instead.").arg(fileName);
       return false;
-  }
+    }
 
-  if(!flightFile.size())
+  if(!fInfo.size())
     {
-      QMessageBox::warning(_mainWindow, QObject::tr("File is empty"),
-          "<html>" + QObject::tr("The selected file<BR><B>%1</B><BR>is empty!").arg(flightFile.fileName()) + "</html>", QMessageBox::Ok);
+      error = QObject::tr("The selected file<BR><B>%1</B><BR>is empty!").arg(fileName);
       return false;
     }
 
-  if(!flightFile.open(QIODevice::ReadOnly))
+  if(!fInfo.isReadable())
     {
-      QMessageBox::warning(_mainWindow, QObject::tr("No permission to file"),
-          "<html>" + QObject::tr("You don't have permission to access file<BR><B>%1</B>").arg(flightFile.fileName() + "</html>"), QMessageBox::Ok);
+      error = QObject::tr("You don't have permission to access file<BR><B>%1</B>").arg(fileName);
       return false;
     }
 
   //
   // We need a better format-identification then only the extension ...
   //
-  if( fInfo.suffix().toLower() == "igc")
+  QString suffix = fInfo.suffix().toLower();
+
+  if( suffix != "igc" && suffix != "gdn" && suffix != "trk" )
+    {
+      error = QObject::tr("Couldn't open the file<BR><B>%1</B><BR>because it has an unknown file extension").arg(fileName);
+      return false;
+    }
+
+  return true;
+}
+
+bool FlightLoader::__createFlight(FlightLoadTask* task, QString& error)
+{
+  if( task->error().isEmpty() == false )
+    {
+      error = task->error();
+      return false;
+    }
+
+  extern MapMatrix *_globalMapMatrix;
+  extern MapContents *_globalMapContents;
+  ElevationFinder * ef=ElevationFinder::instance();
+
+  QList<FlightPoint*>& flightRoute = task->route();
+  Flight::FlightStaticData& fsd = task->staticData();
+  const FlightAnalysisCache& cache = task->analysisCache();
+
+  // The stored surface heights are only valid for the same elevation source.
+  const bool useCachedHeights = cache.isValid() &&
+                                ! cache.elevationKey.isEmpty() &&
+                                cache.elevationKey == ef->sourceKey();
+
+  for( int i = 0; i < flightRoute.size(); i++ )
+    {
+      FlightPoint* point = flightRoute.at(i);
+
+      point->projP = _globalMapMatrix->wgsToMap(point->origP);
+
+      if( useCachedHeights )
+        {
+          // The elevation lookup is the most expensive part here.
+          point->surfaceHeight = cache.surfaceHeight[i];
+        }
+      else
+        {
+          point->surfaceHeight = ef->elevation(point->origP, point->projP);
+        }
+    }
+
+  for( int i = 0; i < fsd.waypoints.size(); i++ )
+    {
+      Waypoint* wp = fsd.waypoints.at(i);
+
+      wp->projP = _globalMapMatrix->wgsToMap(wp->origP);
+    }
+
+  Flight* newFlight = new Flight( task->fileName(),
+                                  flightRoute,
+                                  fsd,
+                                  &cache );
+
+  // The points and waypoints are owned by the flight now.
+  flightRoute.clear();
+  fsd.waypoints.clear();
+
+  _globalMapContents->appendFlight( newFlight );
+  return true;
+}
+
+void FlightLoader::slot_CancelLoad()
+{
+  // This slot is needed to get set the cancel flag of the progress dialog.
+}
+
+/*---------------------- FlightLoadTask --------------------------------------*/
+
+FlightLoadTask::FlightLoadTask( const QString& fileName ) :
+  QRunnable(),
+  m_fileName(fileName),
+  m_fileSize(0),
+  m_progress(0),
+  m_finished(false),
+  m_canceled(false)
+{
+}
+
+FlightLoadTask::~FlightLoadTask()
+{
+  qDeleteAll( m_route );
+  qDeleteAll( m_fsd.waypoints );
+}
+
+void FlightLoadTask::run()
+{
+  QFile file( m_fileName );
+  QFileInfo fInfo( file );
+
+  m_fileSize = qMax( fInfo.size(), qint64(1) );
+
+  bool ok = false;
+
+  if( ! file.open( QIODevice::ReadOnly ) )
     {
-      return openIGC(flightFile, fInfo);
+      m_error = QObject::tr("You don't have permission to access file<BR><B>%1</B>").arg(m_fileName);
     }
-  else if( fInfo.suffix().toLower() == "gdn" || fInfo.suffix().toLower() == "trk")
+  else if( fInfo.suffix().toLower() == "igc" )
     {
-      return openGardownFile(flightFile, fInfo);
+      ok = parseIGC( file );
     }
   else
     {
-      QMessageBox::warning(_mainWindow, QObject::tr("Unknown file extension"),
-          "<html>" + QObject::tr("Couldn't open the file, because it has an unknown file extension") + "</html>", QMessageBox::Ok);
-      return false;
+      ok = parseGardownFile( file );
+    }
+
+  if( ok && m_route.isEmpty() )
+    {
+      m_error = QObject::tr("The selected file<BR><B>%1</B><BR>contains no flight!").arg(m_fileName);
     }
+  else if( ! ok && m_error.isEmpty() )
+    {
+      m_error = QObject::tr("Loading of file<BR><B>%1</B><BR>was canceled.").arg(m_fileName);
+    }
+  else if( ok )
+    {
+      m_cache.load( m_fileName,
+                    FlightAnalysisCache::fileHash( m_fileName ),
+                    m_route.size() );
+    }
+
+  QMutexLocker locker( &m_mutex );
+  m_progress = 100;
+  m_finished = true;
+}
 
-  return false;
+void FlightLoadTask::cancel()
+{
+  QMutexLocker locker( &m_mutex );
+  m_canceled = true;
+}
+
+bool FlightLoadTask::isCanceled()
+{
+  QMutexLocker locker( &m_mutex );
+  return m_canceled;
+}
+
+bool FlightLoadTask::isFinished()
+{
+  QMutexLocker locker( &m_mutex );
+  return m_finished;
+}
+
+int FlightLoadTask::progress()
+{
+  QMutexLocker locker( &m_mutex );
+  return m_progress;
+}
+
+void FlightLoadTask::setProgress( const int progress )
+{
+  QMutexLocker locker( &m_mutex );
+  m_progress = progress;
 }
 
 /** Parses an igc-file */
-bool FlightLoader::openIGC(QFile& igcFile, QFileInfo& fInfo)
+bool FlightLoadTask::parseIGC( QFile& igcFile )
 {
-  QProgressDialog importProgress( _mainWindow );
-  importProgress.setWindowModality(Qt::WindowModal);
-  importProgress.setWindowTitle(QObject::tr("Loading flight..."));
-  importProgress.setLabelText(
-      "<html>" + QObject::tr("Please wait while loading file<BR><B>%1</B>").arg(igcFile.fileName()) + "</html>");
-  importProgress.setMinimumWidth(importProgress.sizeHint().width() + 45);
-  importProgress.setRange(0, 100);
-  importProgress.setVisible(true);
-  //importProgress.setMinimumDuration(0);
-  importProgress.setValue(0);
-
-  // The cancel method of QProgressDialog did not work, if signal canceled is
-  // not catched!
-  connect(&importProgress, SIGNAL(canceled()), this, SLOT(slot_CancelLoad()));
-
-  unsigned int fileLength = fInfo.size();
   QTextStream stream(&igcFile);
 
-  Flight::FlightStaticData fsd;
-
   char latChar, lonChar;
   bool isFirstWP = true;
   int lat, latmin, latTemp, lon, lonmin, lonTemp, baroAltTemp, gpsAltTemp;
@@ -148,11 +381,12 @@ bool FlightLoader::openIGC(QFile& igcFile, QFileInfo& fInfo)
   time_t curTime = 0, preTime = 0, timeOfFlightDay = 0;
 
   FlightPoint newPoint;
-  QList<FlightPoint*> flightRoute;
+  QList<FlightPoint*>& flightRoute = m_route;
+  Flight::FlightStaticData& fsd = m_fsd;
   Waypoint* newWP = 0;
   Waypoint* preWP = 0;
 
-  QList<bOption> options;
+  QList<FlightLoader::bOption> options;
 
   //
   // This regexp is used to check the syntax of the position-lines in
@@ -173,10 +407,6 @@ bool FlightLoader::openIGC(QFile& igcFile, QFileInfo& fInfo)
   //
   QRegExp bRecord("^B[0-2][0-9][0-6][0-9][0-6][0-9][0-9][0-9][0-6][0-9][0-9][0-9][0-9][NS][0-1][0-9][0-9][0-6][0-9][0-9][0-9][0-9][EW][AV][0-9,-][0-9][0-9][0-9][0-9][0-9,-][0-9][0-9][0-9][0-9]");
 
-  extern MapMatrix *_globalMapMatrix;
-  extern MapContents *_globalMapContents;
-  ElevationFinder * ef=ElevationFinder::instance();
-
   int lineCount = 0;
   unsigned int wp_count = 0;
   int last0 = -1;
@@ -225,21 +455,18 @@ bool FlightLoader::openIGC(QFile& igcFile, QFileInfo& fInfo)
   //
 
   int lastProgress = 0;
-  int readChar     = 0;
+  qint64 readChar  = 0;
 
   while (!stream.atEnd())
     {
-      QCoreApplication::processEvents();
+      lineCount++;
 
-      if( importProgress.wasCanceled() )
+      if( (lineCount % 100) == 0 && isCanceled() )
         {
-          importProgress.close();
           igcFile.close();
           return false;
         }
 
-      lineCount++;
-
       QString s = stream.readLine();
 
       readChar += s.length();
@@ -249,12 +476,12 @@ bool FlightLoader::openIGC(QFile& igcFile, QFileInfo& fInfo)
           continue;
         }
 
-      int progress = readChar * 100 / fileLength;
+      int progress = (int) (readChar * 100 / m_fileSize);
 
       if( lastProgress != progress  )
         {
           lastProgress = progress;
-          importProgress.setValue( progress > 100 ? 100 : progress );
+          setProgress( progress > 100 ? 100 : progress );
         }
 
       // First character of the read line is the key.
@@ -270,15 +497,13 @@ bool FlightLoader::openIGC(QFile& igcFile, QFileInfo& fInfo)
           if(bRecord.indexIn(s) == -1)
             {
               // IO-Error !!!
-              QString lineNr = QString::number(lineCount);
-
-              QMessageBox::warning(_mainWindow, QObject::tr("Syntax-error in IGC-file"),
-                  "<html>" + QObject::tr("Syntax-error while loading igc-file"
-                  "<BR><B>%1</B><BR>Aborting!").arg(igcFile.fileName()) + "</html>",
-                  QMessageBox::Ok);
+              m_error = QObject::tr("Syntax-error in line %1 while loading igc-file"
+                                    "<BR><B>%2</B><BR>Aborting!")
+                                    .arg(lineCount).arg(igcFile.fileName());
 
               qWarning( "KFLog: Error in reading line %d in igc-file %s",
                         lineCount, igcFile.fileName().toLatin1().data() );
+              igcFile.close();
               return false;
             }
 
@@ -332,8 +557,6 @@ bool FlightLoader::openIGC(QFile& igcFile, QFileInfo& fInfo)
 
           newPoint.time = curTime;
           newPoint.origP = WGSPoint(latTemp, lonTemp);
-          newPoint.projP = _globalMapMatrix->wgsToMap(newPoint.origP);
-          newPoint.surfaceHeight = ef->elevation(newPoint.origP, newPoint.projP);
           newPoint.height = baroAltTemp;
           newPoint.gpsHeight = gpsAltTemp;
 
@@ -362,9 +585,9 @@ bool FlightLoader::openIGC(QFile& igcFile, QFileInfo& fInfo)
               manufactureCode = "XXX";
             }
 
-          if( m_manufactures.contains( manufactureCode ) )
+          if( FlightLoader::m_manufactures.contains( manufactureCode ) )
             {
-              fsd.frManufacturer = m_manufactures.value( manufactureCode );
+              fsd.frManufacturer = FlightLoader::m_manufactures.value( manufactureCode );
             }
           else
             {
@@ -461,7 +684,7 @@ bool FlightLoader::openIGC(QFile& igcFile, QFileInfo& fInfo)
           // The byte count starts from the beginning of the B Record starting at 1.
 
           int nrOfOpts = s.mid(1, 2).toInt();
-          bOption opt;
+          FlightLoader::bOption opt;
 
           if ( nrOfOpts < 1 || nrOfOpts > 10 )
           {
@@ -501,7 +724,6 @@ bool FlightLoader::openIGC(QFile& igcFile, QFileInfo& fInfo)
                   newWP = new Waypoint;
                   newWP->name = s.mid(18,20);
                   newWP->origP = WGSPoint(latTemp, lonTemp);
-                  newWP->projP = _globalMapMatrix->wgsToMap(newWP->origP);
                   newWP->type = Flight::NotSet;
                   if(isFirstWP || NULL == preWP)
                       newWP->distance = 0;
@@ -521,7 +743,6 @@ bool FlightLoader::openIGC(QFile& igcFile, QFileInfo& fInfo)
                       newWP = new Waypoint;
                       newWP->name =  preWP->name;
                       newWP->origP = preWP->origP;
-                      newWP->projP = preWP->projP;
 
                       fsd.waypoints.append(newWP);
                     }
@@ -541,54 +762,13 @@ bool FlightLoader::openIGC(QFile& igcFile, QFileInfo& fInfo)
     }
 
   igcFile.close();
-
-  if( flightRoute.count() == 0 )
-    {
-      QMessageBox::warning( _mainWindow,
-                            QObject::tr("File contains no flight"),
-                            "<html>" +
-                            QObject::tr("The selected file<BR><B>%1</B><BR>contains no flight!").arg(igcFile.fileName()) +
-                            "</html>",
-                            QMessageBox::Ok,
-                            0);
-      return false;
-    }
-
-  importProgress.setLabelText(
-        "<html>" + QObject::tr("Please wait while checking airspaces") + "</html>");
-
-  importProgress.repaint();
-  QCoreApplication::processEvents();
-
-  Flight* newFlight = new Flight( igcFile.fileName(),
-                                  flightRoute,
-                                  fsd );
-
-  _globalMapContents->appendFlight( newFlight) ;
   return true;
 }
 
-void FlightLoader::slot_CancelLoad()
-{
-  // This slot is needed to get set the cancel flag of the progress dialog.
-}
-
 /** Parses a file downloaded with Gardown in DOS or a Garmin *.trk file */
-bool FlightLoader::openGardownFile(QFile& gardownFile, QFileInfo& fInfo)
+bool FlightLoadTask::parseGardownFile( QFile& gardownFile )
 {
-  QProgressDialog importProgress( _mainWindow );
-  importProgress.setWindowModality(Qt::WindowModal);
-  importProgress.setWindowTitle(QObject::tr("Loading flight..."));
-  importProgress.setLabelText(
-      "<html>" + QObject::tr("Please wait while loading file<BR><B>%1</B>").arg(gardownFile.fileName()) + "</html>");
-  importProgress.setMinimumWidth(importProgress.sizeHint().width() + 45);
-  importProgress.setRange(0, 200);
-  importProgress.setVisible(true);
-  importProgress.setMinimumDuration(0);
-  importProgress.setValue(0);
-
-  unsigned int fileLength = fInfo.size();
-  unsigned int filePos = 0;
+  qint64 filePos = 0;
   QString s;
   QTextStream stream(&gardownFile);
 
@@ -599,8 +779,7 @@ bool FlightLoader::openGardownFile(QFile& gardownFile, QFileInfo& fInfo)
   int hh = 0, mm = 0, ss = 0, height;
   time_t curTime = 0, timeOfFlightDay = 0;
 
-  QList<FlightPoint*> flightRoute;
-  QList<Waypoint*> wpList;
+  QList<FlightPoint*>& flightRoute = m_route;
 
   //
   // This regexp is used to check the syntax of the position-lines in
@@ -610,10 +789,6 @@ bool FlightLoader::openGardownFile(QFile& gardownFile, QFileInfo& fInfo)
   //
   QRegExp bRecord("^[$]GPRMC,[0-9][0-9][0-9][0-9][0-9][0-9],[AV],[0-9][0-9][0-9][0-9]\\.[0-9][0-9][0-9],[NS],[0-9][0-9][0-9][0-9][0-9]\\.[0-9][0-9][0-9],[EW],[0-9][0-9][0-9]\\.[0-9],[0-9][0-9][0-9]\\.[0-9],[0-9][0-9][0-9][0-9][0-9][0-9][0-9],[0-9][0-9][0-9]\\.[0-9],[EW],[*][0-9][0-9]$");
 
-  extern MapMatrix *_globalMapMatrix;
-  extern MapContents *_globalMapContents;
-  ElevationFinder * ef=ElevationFinder::instance();
-
   int lineCount = 0;
 
   float fLat, fLon;
@@ -621,16 +796,17 @@ bool FlightLoader::openGardownFile(QFile& gardownFile, QFileInfo& fInfo)
 
   while (!stream.atEnd())
     {
-      if(importProgress.wasCanceled())
+      lineCount++;
+
+      if( (lineCount % 100) == 0 && isCanceled() )
         {
+          gardownFile.close();
           return false;
         }
 
-      lineCount++;
-
       s = stream.readLine();
       filePos += s.length();
-      importProgress.setValue(( filePos * 200 ) / fileLength);
+      setProgress( (int) qMin( filePos * 100 / m_fileSize, qint64(100) ) );
 
       if(s.mid(0,2) == "T ")
         {
@@ -702,8 +878,6 @@ bool FlightLoader::openGardownFile(QFile& gardownFile, QFileInfo& fInfo)
 
           newPoint->time = curTime;
           newPoint->origP = WGSPoint(latTemp, lonTemp);
-          newPoint->projP = _globalMapMatrix->wgsToMap(newPoint->origP);
-          newPoint->surfaceHeight = ef->elevation(newPoint->origP, newPoint->projP);
           newPoint->height = height;
           newPoint->gpsHeight = height;
 
@@ -716,35 +890,17 @@ bool FlightLoader::openGardownFile(QFile& gardownFile, QFileInfo& fInfo)
         }
     }
 
-  // close the import dialog, clean up and add the FlightRoute we just created
-  importProgress.close();
-
-  if(!flightRoute.count())
-    {
-      QMessageBox::warning( _mainWindow,
-                            QObject::tr("File contains no flight"),
-                            "<html>" +
-                            QObject::tr("The selected file<BR><B>%1</B><BR>exists but contains no QNH value").arg(gardownFile.fileName()) +
-                            "</html>",
-                            QMessageBox::Ok,
-                            0 );
-      return false;
-    }
+  gardownFile.close();
 
   recorderID = "gardown";
   pilotName  = "gardown";
   gliderType = "gardown";
   gliderID   = "gardown";
 
-  Flight::FlightStaticData fsd;
-
-  fsd.frRecorderId       = "gardown";
-  fsd.pilot              = "gardown";
-  fsd.gliderType         = "gardown";
-  fsd.gliderRegistration = "gardown";
+  m_fsd.frRecorderId       = "gardown";
+  m_fsd.pilot              = "gardown";
+  m_fsd.gliderType         = "gardown";
+  m_fsd.gliderRegistration = "gardown";
 
-  _globalMapContents->appendFlight( new Flight(gardownFile.fileName(),
-                                               flightRoute,
-                                               fsd) );
   return true;
 }
@@ -24,6 +24,15 @@
 #include <QFile>
 #include <QFileInfo>
 #include <QHash>
+#include <QList>
+#include <QMutex>
+#include <QRunnable>
+#include <QStringList>
+
+#include "flight.h"
+#include "flightanalysiscache.h"
+
+class FlightLoadTask;
 
 class FlightLoader : public QObject
 {
@@ -33,6 +42,8 @@ class FlightLoader : public QObject
 
   Q_DISABLE_COPY ( FlightLoader )
 
+  friend class FlightLoadTask;
+
   public:
 
   FlightLoader( QObject *parent=0 );
@@ -47,21 +58,17 @@ class FlightLoader : public QObject
    */
   bool openFlight(QFile&);
 
-   /**
-   * Loads a new flight-file.
-   *
-   * @param  file  The path to the igc-file
-   * @return "true", when the file has successfully been loaded
-   */
-  bool openIGC(QFile&, QFileInfo&);
-
-   /**
-   * Imports a file downloaded with Gardown in DOS
+  /**
+   * Loads several flight files. The files are parsed in parallel in a thread
+   * pool, while one progress dialog shows the state of all files. The parsed
+   * flights are created and added to the map contents in the order of the
+   * passed list. All errors are collected and reported in one message box
+   * at the end.
    *
-   * @param  file  The path to the Gardown-file
-   * @return "true", when the file has successfully been loaded
+   * @param  files  The paths to the files
+   * @return The paths of the successfully loaded files
    */
-  bool openGardownFile(QFile&, QFileInfo&);
+  QStringList openFlights(const QStringList& files);
 
   private slots:
 
@@ -69,6 +76,23 @@ class FlightLoader : public QObject
 
   private:
 
+  /**
+   * Checks, if the file can be loaded.
+   *
+   * @param  fileName  The path to the file
+   * @param  error  The reason, if the file cannot be loaded
+   * @return "true", when the file can be loaded
+   */
+  bool __checkFile(const QString& fileName, QString& error);
+
+  /**
+   * Projects the parsed flight of a finished task, creates the flight and
+   * adds it to the map contents. Must be called in the GUI thread.
+   *
+   * @return "true", when the flight has been added
+   */
+  bool __createFlight(FlightLoadTask* task, QString& error);
+
   // Short structure to handle the optional entries in an igc file
   class bOption
   {
@@ -82,4 +106,111 @@ class FlightLoader : public QObject
 
 };
 
+/**
+ * \class FlightLoadTask
+ *
+ * \author agent
+ *
+ * \brief Parses a flight file in a thread pool.
+ *
+ * The task reads the fixes, the header data and the declared task of an IGC
+ * or Gardown file. Only the WGS84 coordinates are set, because the map
+ * projection and the elevation lookup are not thread safe. They are done by
+ * the \ref FlightLoader in the GUI thread. The analysis cache of the flight
+ * file is read by the task too.
+ *
+ * \date 2026
+ *
+ * \version 1.0
+ */
+class FlightLoadTask : public QRunnable
+{
+ public:
+
+  FlightLoadTask( const QString& fileName );
+
+  /**
+   * Deletes the parsed points and waypoints, which were not taken over by
+   * a flight.
+   */
+  virtual ~FlightLoadTask();
+
+  /**
+   * Parses the file. Called by the thread pool.
+   */
+  void run();
+
+  /**
+   * Requests the abort of the parsing.
+   */
+  void cancel();
+
+  /**
+   * \return True, if the abort of the parsing was requested.
+   */
+  bool isCanceled();
+
+  /**
+   * \return True, if the parsing is finished.
+   */
+  bool isFinished();
+
+  /**
+   * \return The parsing progress in percent.
+   */
+  int progress();
+
+  const QString& fileName() const
+  {
+    return m_fileName;
+  };
+
+  /**
+   * \return The reason of a failed parsing. Valid after the parsing is
+   *         finished.
+   */
+  const QString& error() const
+  {
+    return m_error;
+  };
+
+  QList<FlightPoint*>& route()
+  {
+    return m_route;
+  };
+
+  Flight::FlightStaticData& staticData()
+  {
+    return m_fsd;
+  };
+
+  const FlightAnalysisCache& analysisCache() const
+  {
+    return m_cache;
+  };
+
+ private:
+
+  /** Parses an igc-file */
+  bool parseIGC( QFile& igcFile );
+
+  /** Parses a file downloaded with Gardown in DOS or a Garmin *.trk file */
+  bool parseGardownFile( QFile& gardownFile );
+
+  void setProgress( const int progress );
+
+  QString                  m_fileName;
+  qint64                   m_fileSize;
+  QString                  m_error;
+  QList<FlightPoint*>      m_route;
+  Flight::FlightStaticData m_fsd;
+  FlightAnalysisCache      m_cache;
+
+  /** Protects the state members below. */
+  QMutex m_mutex;
+  int    m_progress;
+  bool   m_finished;
+  bool   m_canceled;
+};
+
 #endif
@@ -21,6 +21,7 @@
 
 #ifndef _WIN32
 #include <termios.h>
+#include "serialtransport.h"
 #endif
 
 #include <QObject>
@@ -230,6 +231,13 @@ public:
    * Closes the connection with the flight recorder.
    */
   virtual int closeRecorder()=0;
+  /**
+   * Stops or restarts the port activities of the plugin, which are triggered
+   * by timers of the GUI thread, e.g. a keep alive of the connection. Must be
+   * called in the GUI thread, before and after a download thread uses the
+   * port. The default does nothing.
+   */
+  virtual void setKeepAlive(const bool /* active */) {};
   /**
    * Write flight declaration to recorder
    */
@@ -311,6 +319,13 @@ protected:
    */
   QObject* _parent;
 
+#ifndef _WIN32
+  /**
+   * The buffered serial port used by the plugins with a serial transfer mode.
+   */
+  SerialTransport _serial;
+#endif
+
 signals:
 
   /**
@@ -25,6 +25,7 @@
 #include "distance.h"
 #include "flighttask.h"
 #include "mapcalc.h"
+#include "sectorcrossing.h"
 
 #define PRE_ID loop - 1
 #define CUR_ID loop
@@ -283,6 +284,47 @@ double FlightTask::__sectorangle(int loop, bool isDraw)
   return sectorAngle;
 }
 
+QPointF FlightTask::__sectorAxis(int loop)
+{
+  Waypoint* wp = wpList.at(CUR_ID);
+
+  QPointF axis( 1.0, 0.0 );
+
+  switch(wp->tpType)
+    {
+    case Begin:
+      // away from the next point
+      if(loop + 1 < wpList.count())
+        axis = SectorCrossing::direction(wp->origP, wpList.at(NEXT_ID)->origP);
+      break;
+    case RouteP:
+      if(loop >= 1 && loop + 1 < wpList.count())
+        {
+          // vector pointing to the outside of the two legs
+          QPointF pre = SectorCrossing::direction(wp->origP, wpList.at(PRE_ID)->origP);
+          QPointF next = SectorCrossing::direction(wp->origP, wpList.at(NEXT_ID)->origP);
+
+          axis = pre + next;
+
+          double length = hypot(axis.x(), axis.y());
+
+          if(length < 1E-6)
+            // straight legs, the sector is perpendicular to them
+            axis = QPointF(-pre.y(), pre.x());
+          else
+            axis /= length;
+        }
+      break;
+    case End:
+      // away from the previous point
+      if(loop >= 1 && loop < wpList.count())
+        axis = SectorCrossing::direction(wp->origP, wpList.at(PRE_ID)->origP);
+      break;
+    }
+
+  return axis;
+}
+
 void FlightTask::__setWaypointType()
 {
   /*
@@ -741,7 +783,7 @@ double FlightTask::getOlcPoints()
   return  olcPoints;
 }
 
-void FlightTask::checkWaypoints(QList<FlightPoint*> route, const QString& gliderType)
+void FlightTask::checkWaypoints(const QList<FlightPoint*>& route, const QString& gliderType)
 {
   /*
    *   �berpr�ft, ob die Sektoren der Wendepunkte erreicht wurden
@@ -785,14 +827,19 @@ void FlightTask::checkWaypoints(QList<FlightPoint*> route, const QString& glider
       preTime = route.at(loop)->time;
     }
 
-  unsigned int startIndex = 0, dummy = 0;
+  // The sectors are checked with the track segments, to find also entries
+  // between two logged points.
+  SectorCrossing crossing( route );
+  SectorCrossing::Position start;
+  start.segment = 0;
+  start.time = route.isEmpty() ? 0 : route.first()->time;
 
   for(int loop = 0; loop < wpList.count(); loop++)
     {
-      double deltaAngle = 0.0, pointAngle = 0.0;
-      dummy = 0;
+      Waypoint* wp = wpList.at(loop);
 
       __sectorangle(loop, false);
+
       /*
        * Prüfung, ob Flugpunkte in den Sektoren liegen.
        *
@@ -800,82 +847,25 @@ void FlightTask::checkWaypoints(QList<FlightPoint*> route, const QString& glider
        *      _nicht_ erreicht wurde. Dies führt an Mitternacht zu
        *      einem möglichen Fehler ...
        */
-      for(int pLoop = startIndex + 1; pLoop < route.count(); pLoop++)
-        {
-          if( wpList.at(loop)->projP == route.at(pLoop)->projP )
-            {
-              // Wir sind in allen Sektoren ...
-              if(!wpList.at(loop)->sector1)
-                wpList.at(loop)->sector1 = route.at(pLoop)->time;
+      SectorCrossing::Entries entries;
 
-              if(!wpList.at(loop)->sector2)
-                wpList.at(loop)->sector2 = route.at(pLoop)->time;
+      crossing.findEntries( wp->origP, __sectorAxis(loop), start, entries );
 
-              if(!wpList.at(loop)->sectorFAI)
-                wpList.at(loop)->sectorFAI = route.at(pLoop)->time;
-
-              // ... daher ist ein Abbruch m�glich!
-              startIndex = pLoop;
-              break;
-            }
-          else
-            {
-              if(dist(wpList.at(loop), route.at(pLoop)) <= 0.5)
-                {
-                  // Wir sind im kleinen Zylinder ...
-                  if(!wpList.at(loop)->sector1)
-                    wpList.at(loop)->sector1 = route.at(pLoop)->time;
-
-                  if(!wpList.at(loop)->sector2)
-                    wpList.at(loop)->sector2 = route.at(pLoop)->time;
-
-                  if(!dummy)
-                    {
-                      startIndex = pLoop;
-                      dummy = pLoop;
-                    }
-                }
+      if(!wp->sector1)
+        wp->sector1 = entries.sector1;
 
-              pointAngle = polar(
-                                 ( wpList.at(loop)->projP.x() - route.at(pLoop)->projP.x() ),
-                                 ( wpList.at(loop)->projP.y() - route.at(pLoop)->projP.y() ) );
+      if(!wp->sector2)
+        wp->sector2 = entries.sector2;
 
-              deltaAngle = sqrt( ( pointAngle - wpList.at(loop)->angle ) *
-                                 ( pointAngle - wpList.at(loop)->angle ) );
+      if(!wp->sectorFAI)
+        wp->sectorFAI = entries.sectorFAI;
 
-              if(deltaAngle <= (0.25 * M_PI))
-                {
-                  // Wir sind im FAI-Sektor ...
-                  if(!wpList.at(loop)->sectorFAI)
-                    wpList.at(loop)->sectorFAI = route.at(pLoop)->time;
-
-                  if(dist(wpList.at(loop), route.at(pLoop)) <= 3.0)
-                    {
-                      // ... und in Sektor 1 ...
-                      if(!wpList.at(loop)->sector1)
-                        {
-                          wpList.at(loop)->sector1 = route.at(pLoop)->time;
-                          // ... daher ist ein Abbruch m�glich!
-                          startIndex = pLoop;
-                          break;
-                        }
-
-                    }
-                }
-              else if(deltaAngle <= (0.5 * M_PI))
-                {
-                  // "nur" in Sektor 2
-                  if(!wpList.at(loop)->sector2)
-                    wpList.at(loop)->sector2 = route.at(pLoop)->time;
-
-                  if(!dummy)
-                    {
-                      startIndex = pLoop;
-                      dummy = pLoop;
-                    }
-                }
-            }
-        }
+      // The search for the next point starts at the entry into sector 1 or,
+      // if not reached, at the first entry into sector 2.
+      if(entries.sector1)
+        start = entries.sector1Pos;
+      else if(entries.sector2)
+        start = entries.sector2Pos;
     }
 
   /*
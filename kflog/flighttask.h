@@ -25,6 +25,7 @@
 #include <QHash>
 #include <QList>
 #include <QRect>
+#include <QPointF>
 #include <QPolygon>
 
 struct faiRange
@@ -110,7 +111,11 @@ class FlightTask : public BaseFlightElement
   void printMapElement(QPainter* targetP, bool isText);
   void printMapElement(QPainter* targetP, bool isText, double dX, double dY);
   /** */
-  void checkWaypoints(QList<FlightPoint*> route, const QString& gliderType);
+  /**
+   * Checks, when the sectors of the waypoints have been reached by the
+   * flight and calculates the points of the task.
+   */
+  void checkWaypoints(const QList<FlightPoint*>& route, const QString& gliderType);
   /** */
   double getOlcPoints();
   /** */
@@ -200,6 +205,11 @@ class FlightTask : public BaseFlightElement
    * Calculates the sector.
    */
   double __sectorangle(int loop, bool isDraw);
+  /**
+   * Returns the direction to the middle of the sectors of a waypoint as unit
+   * vector in the local plane of the waypoint, see \ref SectorCrossing.
+   */
+  QPointF __sectorAxis(int loop);
   /**
    * Proofes the type of the task and sets the status of the waypoints.
    */
@@ -0,0 +1,172 @@
+/***********************************************************************
+**
+**   geovectors.cpp
+**
+**   This file is part of KFLog.
+**
+************************************************************************
+**
+**   Copyright (c):  2026 by agent <agent@local>
+**
+**   This file is distributed under the terms of the General Public
+**   License. See the file COPYING for more information.
+**
+***********************************************************************/
+
+#ifdef _MSC_VER
+#define _USE_MATH_DEFINES
+#endif
+#include <cmath>
+
+#include "flightpoint.h"
+#include "geovectors.h"
+#include "mapdefaults.h"
+
+// Pi / (180 degrees * 600000 KFLog degrees)
+static const double rad = M_PI / 108000000.0;
+
+double GeoVectors::chordToKm( const double chord2 )
+{
+  double half = sqrt( chord2 ) / 2.0;
+
+  if( half > 1.0 )
+    {
+      half = 1.0;
+    }
+
+  return 2.0 * asin( half ) * RADIUS / 1000.;
+}
+
+GeoVectors::GeoVectors()
+{
+}
+
+GeoVectors::GeoVectors( const QList<FlightPoint*>& route )
+{
+  const int count = route.size();
+
+  m_x.resize( count );
+  m_y.resize( count );
+  m_z.resize( count );
+
+  for( int i = 0; i < count; i++ )
+    {
+      toUnitVector( route.at(i)->origP, m_x[i], m_y[i], m_z[i] );
+    }
+}
+
+GeoVectors::~GeoVectors()
+{
+}
+
+void GeoVectors::clear()
+{
+  m_x.clear();
+  m_y.clear();
+  m_z.clear();
+}
+
+void GeoVectors::append( const QPoint& point )
+{
+  double x, y, z;
+
+  toUnitVector( point, x, y, z );
+
+  m_x.append( x );
+  m_y.append( y );
+  m_z.append( z );
+}
+
+void GeoVectors::toUnitVector( const QPoint& point,
+                               double& x, double& y, double& z )
+{
+  // KFLog points contain the latitude as x and the longitude as y.
+  const double lat = point.x() * rad;
+  const double lon = point.y() * rad;
+
+  const double cosLat = cos( lat );
+
+  x = cosLat * cos( lon );
+  y = cosLat * sin( lon );
+  z = sin( lat );
+}
+
+double GeoVectors::dist( const int i, const int j ) const
+{
+  const double dx = m_x[i] - m_x[j];
+  const double dy = m_y[i] - m_y[j];
+  const double dz = m_z[i] - m_z[j];
+
+  return chordToKm( dx * dx + dy * dy + dz * dz );
+}
+
+void GeoVectors::distances( const int i, const int first, const int last,
+                            double* result ) const
+{
+  distances( m_x[i], m_y[i], m_z[i], first, last, result );
+}
+
+void GeoVectors::distances( const QPoint& point, const int first,
+                            const int last, double* result ) const
+{
+  double x, y, z;
+
+  toUnitVector( point, x, y, z );
+  distances( x, y, z, first, last, result );
+}
+
+void GeoVectors::distances( const double x, const double y, const double z,
+                            const int first, const int last,
+                            double* result ) const
+{
+  const int count = last - first;
+
+  const double* px = m_x.constData() + first;
+  const double* py = m_y.constData() + first;
+  const double* pz = m_z.constData() + first;
+
+  // At first the squared chord lengths in a loop without any branches.
+  for( int k = 0; k < count; k++ )
+    {
+      const double dx = px[k] - x;
+      const double dy = py[k] - y;
+      const double dz = pz[k] - z;
+
+      result[k] = dx * dx + dy * dy + dz * dz;
+    }
+
+  for( int k = 0; k < count; k++ )
+    {
+      result[k] = chordToKm( result[k] );
+    }
+}
+
+void GeoVectors::segmentLengths( double* result ) const
+{
+  const int count = size();
+
+  if( count == 0 )
+    {
+      return;
+    }
+
+  const double* px = m_x.constData();
+  const double* py = m_y.constData();
+  const double* pz = m_z.constData();
+
+  result[0] = 0.0;
+
+  for( int k = 1; k < count; k++ )
+    {
+      const double dx = px[k] - px[k - 1];
+      const double dy = py[k] - py[k - 1];
+      const double dz = pz[k] - pz[k - 1];
+
+      result[k] = dx * dx + dy * dy + dz * dz;
+    }
+
+  for( int k = 1; k < count; k++ )
+    {
+      result[k] = chordToKm( result[k] );
+    }
+}
@@ -0,0 +1,137 @@
+/***********************************************************************
+**
+**   geovectors.h
+**
+**   This file is part of KFLog.
+**
+************************************************************************
+**
+**   Copyright (c):  2026 by agent <agent@local>
+**
+**   This file is distributed under the terms of the General Public
+**   License. See the file COPYING for more information.
+**
+***********************************************************************/
+
+/**
+ * \class GeoVectors
+ *
+ * \author agent
+ *
+ * \brief Coordinates as unit vectors for fast great circle distances.
+ *
+ * The WGS84 coordinates are converted once into unit vectors of the earth
+ * sphere. The great circle distance of two points is then computed from the
+ * chord length of their vectors with one square root and one arc sine,
+ * instead of the trigonometric functions of the haversine formula used by
+ * \ref dist. Both formulas are mathematically equivalent.
+ *
+ * The vector components are stored in separate arrays. The batch methods
+ * compute the chord lengths in a simple loop, which can be vectorized by
+ * the compiler.
+ *
+ * \date 2026
+ *
+ * \version 1.0
+ */
+
+#ifndef GEO_VECTORS_H
+#define GEO_VECTORS_H
+
+#include <QList>
+#include <QPoint>
+#include <QVector>
+
+class FlightPoint;
+
+class GeoVectors
+{
+ public:
+
+  GeoVectors();
+
+  /**
+   * Stores the unit vectors of the route points.
+   */
+  GeoVectors( const QList<FlightPoint*>& route );
+
+  virtual ~GeoVectors();
+
+  /**
+   * Removes all points.
+   */
+  void clear();
+
+  /**
+   * Appends a point in KFLog coordinates.
+   */
+  void append( const QPoint& point );
+
+  /**
+   * \return The number of stored points.
+   */
+  int size() const
+  {
+    return m_x.size();
+  };
+
+  /**
+   * \return The great circle distance in km between two stored points.
+   */
+  double dist( const int i, const int j ) const;
+
+  /**
+   * Computes the great circle distances in km of the stored point i to the
+   * stored points first ... last - 1.
+   *
+   * \param result Array with at least last - first elements.
+   */
+  void distances( const int i, const int first, const int last,
+                  double* result ) const;
+
+  /**
+   * Computes the great circle distances in km of the passed point in KFLog
+   * coordinates to the stored points first ... last - 1.
+   *
+   * \param result Array with at least last - first elements.
+   */
+  void distances( const QPoint& point, const int first, const int last,
+                  double* result ) const;
+
+  /**
+   * Computes the great circle distances in km between all neighboured
+   * points. The element k of the result contains the distance between the
+   * points k - 1 and k, the element 0 is set to zero.
+   *
+   * \param result Array with at least \ref size elements.
+   */
+  void segmentLengths( double* result ) const;
+
+  /**
+   * Converts a point in KFLog coordinates into a unit vector.
+   */
+  static void toUnitVector( const QPoint& point,
+                            double& x, double& y, double& z );
+
+  /**
+   * Converts the squared chord length between two unit vectors into the
+   * great circle distance in km.
+   */
+  static double chordToKm( const double chord2 );
+
+ private:
+
+  /**
+   * Computes the distances of the unit vector (x, y, z) to the stored
+   * points first ... last - 1.
+   */
+  void distances( const double x, const double y, const double z,
+                  const int first, const int last,
+                  double* result ) const;
+
+  QVector<double> m_x;
+  QVector<double> m_y;
+  QVector<double> m_z;
+};
+
+#endif
@@ -18,6 +18,13 @@
 /**
  * This class is a simple HTTP download client.
  */
+
+#ifndef _WIN32
+#include <cstdio>
+#include <unistd.h>
+#include <utime.h>
+#endif
+
 #ifdef QT_5
     #include <QtWidgets>
 #else
@@ -38,7 +45,10 @@ HttpClient::HttpClient( QObject *parent, const bool showProgressDialog ) :
   _url(""),
   _destination(""),
   downloadRunning(false),
-  timer(0)
+  timer(0),
+  resumeOffset(0),
+  responseChecked(false),
+  fileChanged(false)
  {
    if( showProgressDialog )
      {
@@ -94,10 +104,13 @@ bool HttpClient::downloadFile( QString &urlIn, QString &destinationIn )
       return false;
     }
 
-  tmpFile = new QFile( destinationIn + "." +
-                       QDateTime::currentDateTime().toString("yyyyMMdd_hhmmss") );
+  fileChanged     = false;
+  responseChecked = false;
 
-  if( ! tmpFile->open( QIODevice::WriteOnly ) )
+  // The partial file of an interrupted download is continued.
+  tmpFile = new QFile( destinationIn + ".part" );
+
+  if( ! tmpFile->open( QIODevice::WriteOnly | QIODevice::Append ) )
     {
       qWarning( "HttpClient(%d): Unable to open the file %s: %s",
                  __LINE__,
@@ -156,6 +169,38 @@ bool HttpClient::downloadFile( QString &urlIn, QString &destinationIn )
   request.setUrl( QUrl( _url, QUrl::TolerantMode ));
   request.setRawHeader( "User-Agent", appl.toLatin1() );
 
+  QByteArray etag, lastModified;
+  readValidators( etag, lastModified );
+
+  resumeOffset = tmpFile->size();
+
+  if( resumeOffset > 0 && ( ! etag.isEmpty() || ! lastModified.isEmpty() ) )
+    {
+      // Request the rest of the partial file. If the content was changed
+      // meanwhile, the server sends the complete new content.
+      request.setRawHeader( "Range", "bytes=" + QByteArray::number( resumeOffset ) + "-" );
+      request.setRawHeader( "If-Range", etag.isEmpty() ? lastModified : etag );
+    }
+  else
+    {
+      resumeOffset = 0;
+      tmpFile->resize( 0 );
+
+      if( QFile::exists( destinationIn ) )
+        {
+          // Request the content only, if it differs from the existing file.
+          if( ! etag.isEmpty() )
+            {
+              request.setRawHeader( "If-None-Match", etag );
+            }
+
+          if( ! lastModified.isEmpty() )
+            {
+              request.setRawHeader( "If-Modified-Since", lastModified );
+            }
+        }
+    }
+
   reply = manager->get(request);
 
   if( ! reply )
@@ -337,6 +382,11 @@ void HttpClient::slotReadyRead()
 {
   if( reply && tmpFile )
     {
+      if( ! responseChecked )
+        {
+          checkResponse();
+        }
+
       QByteArray byteArray = reply->readAll();
 
       if( byteArray.size() > 0 )
@@ -348,6 +398,98 @@ void HttpClient::slotReadyRead()
   timer->start();
 }
 
+void HttpClient::checkResponse()
+{
+  responseChecked = true;
+
+  int status = reply->attribute( QNetworkRequest::HttpStatusCodeAttribute ).toInt();
+
+  if( status != 206 && tmpFile->size() > 0 )
+    {
+      // The server sends the complete content, drop the partial file.
+      tmpFile->resize( 0 );
+      tmpFile->seek( 0 );
+    }
+
+  if( status == 200 || status == 206 )
+    {
+      // The validators belong to the partial file now.
+      writeValidators( reply->rawHeader( "ETag" ), reply->rawHeader( "Last-Modified" ) );
+    }
+}
+
+bool HttpClient::isComplete()
+{
+  int status = reply->attribute( QNetworkRequest::HttpStatusCodeAttribute ).toInt();
+  qint64 expected = -1;
+
+  if( status == 206 )
+    {
+      // Content-Range: bytes <first>-<last>/<total>
+      QByteArray range = reply->rawHeader( "Content-Range" );
+      int idx = range.lastIndexOf( '/' );
+
+      if( idx != -1 )
+        {
+          bool ok;
+          expected = range.mid( idx + 1 ).trimmed().toLongLong( &ok );
+
+          if( ! ok )
+            {
+              expected = -1;
+            }
+        }
+    }
+  else if( reply->hasRawHeader( "Content-Length" ) &&
+           reply->rawHeader( "Content-Encoding" ).isEmpty() )
+    {
+      expected = reply->header( QNetworkRequest::ContentLengthHeader ).toLongLong();
+    }
+
+  if( expected >= 0 && tmpFile->size() != expected )
+    {
+      qWarning( "HttpClient(%d): %s is incomplete, %lld of %lld bytes received!",
+                __LINE__, _url.toLatin1().data(), tmpFile->size(), expected );
+      return false;
+    }
+
+  return true;
+}
+
+void HttpClient::readValidators( QByteArray& etag, QByteArray& lastModified )
+{
+  etag.clear();
+  lastModified.clear();
+
+  QFile file( _destination + ".etag" );
+
+  if( file.open( QIODevice::ReadOnly ) )
+    {
+      etag         = file.readLine().trimmed();
+      lastModified = file.readLine().trimmed();
+      file.close();
+    }
+}
+
+void HttpClient::writeValidators( const QByteArray& etag, const QByteArray& lastModified )
+{
+  QString fileName = _destination + ".etag";
+
+  if( etag.isEmpty() && lastModified.isEmpty() )
+    {
+      QFile::remove( fileName );
+      return;
+    }
+
+  QFile file( fileName );
+
+  if( file.open( QIODevice::WriteOnly ) )
+    {
+      file.write( etag + "\n" + lastModified + "\n" );
+      file.close();
+    }
+}
+
 /**
  * Download is finished. Close destination file and reply instance.
  * The reply instance has to be deleted.
@@ -370,27 +512,84 @@ void HttpClient::slotFinished()
       // read reply error status
       enum QNetworkReply::NetworkError error = reply->error();
 
+      int status = reply->attribute( QNetworkRequest::HttpStatusCodeAttribute ).toInt();
+
+      if( error == QNetworkReply::NoError && status != 304 )
+        {
+          if( ! responseChecked )
+            {
+              // No data were received, e.g. an empty file.
+              checkResponse();
+            }
+
+          // Read last received bytes.
+          slotReadyRead();
+        }
+
+      tmpFile->flush();
+
+#ifndef _WIN32
+      fsync( tmpFile->handle() );
+#endif
+
+      if( error == QNetworkReply::NoError && status != 304 && ! isComplete() )
+        {
+          // The partial file is kept, the next request continues it.
+          error = QNetworkReply::UnknownContentError;
+        }
+
       // close opened IO device
       reply->close();
 
       // close temporary file
       tmpFile->close();
 
-      if( error != QNetworkReply::NoError )
+      if( error == QNetworkReply::NoError && status == 304 )
         {
-          // Request was aborted, tmp file is removed.
+          // The existing file is up to date. Its modification time is
+          // renewed, because it is used for the update checks.
           tmpFile->remove();
+
+#ifndef _WIN32
+          utime( _destination.toLocal8Bit().data(), 0 );
+#endif
         }
-      else
+      else if( error == QNetworkReply::NoError )
         {
-          // Read last received bytes. Seems not to be necessary.
-          // slotReadyRead();
-
+#ifndef _WIN32
+          // Replace the destination file atomically.
+          if( ::rename( tmpFile->fileName().toLocal8Bit().data(),
+                      _destination.toLocal8Bit().data() ) == 0 )
+            {
+              fileChanged = true;
+            }
+#else
           // Remove an old existing destination file before rename file.
           QFile::remove( _destination );
 
           // Rename temporary file to destination file.
-          tmpFile->rename( _destination );
+          fileChanged = tmpFile->rename( _destination );
+#endif
+          if( ! fileChanged )
+            {
+              qWarning( "HttpClient(%d): Cannot rename %s!",
+                        __LINE__, tmpFile->fileName().toLatin1().data() );
+
+              tmpFile->remove();
+              error = QNetworkReply::UnknownContentError;
+            }
+        }
+      else if( tmpFile->size() == 0 || ( status != 0 && status != 200 && status != 206 ) )
+        {
+          // The server refused the request or nothing was received. A
+          // partial file of a broken connection is kept for a resume.
+          tmpFile->remove();
+
+          if( resumeOffset > 0 || status == 200 || status == 206 )
+            {
+              // The validators belonged to the removed partial file.
+              QFile::remove( _destination + ".etag" );
+            }
         }
 
       delete tmpFile;
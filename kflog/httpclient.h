@@ -22,6 +22,13 @@
  *
  * \brief This class is a simple HTTP download client.
  *
+ * The data are received into a partial file beside the destination. If a
+ * partial file of an interrupted download exists, the download is resumed
+ * with a range request. The ETag and Last-Modified headers of the server
+ * are stored in a validator file beside the destination and are used for a
+ * conditional request, so that an unchanged file is not transferred again.
+ * A complete download replaces the destination by an atomic rename.
+ *
  * \date 2010
  *
  * \version $Id$
@@ -64,6 +71,16 @@ class HttpClient : public QObject
    */
   bool downloadFile( QString &url, QString &destination );
 
+  /**
+   * Returns true, if the last finished download has replaced the
+   * destination file. It is false, if the server reported the file as not
+   * modified or if the download failed.
+   */
+  bool isFileChanged() const
+  {
+    return fileChanged;
+  };
+
   /**
    * Returns the network manager to be used by the HTTP client.
    */
@@ -95,11 +112,13 @@ class HttpClient : public QObject
    */
   void downloadProgress( qint64 bytesReceived, qint64 bytesTotal );
 
- private slots:
+ public slots:
 
   /** User request, to cancel a running download */
   void slotCancelDownload();
 
+ private slots:
+
   // Slots for Signal emitted by QNetworkAccessManager
   void slotAuthenticationRequired( QNetworkReply *reply, QAuthenticator *authenticator );
   void slotProxyAuthenticationRequired( const QNetworkProxy &proxy, QAuthenticator *authenticator );
@@ -121,6 +140,25 @@ class HttpClient : public QObject
   /** Opens a user password dialog on server request. */
   void getUserPassword( QAuthenticator *authenticator );
 
+  /**
+   * Checks the response header, when the first data are received. The
+   * partial file is truncated, if the server does not continue it. The
+   * validators of the new content are stored.
+   */
+  void checkResponse();
+
+  /**
+   * Returns true, if the partial file contains the complete content
+   * announced by the server.
+   */
+  bool isComplete();
+
+  /** Reads the stored ETag and Last-Modified of the destination. */
+  void readValidators( QByteArray& etag, QByteArray& lastModified );
+
+  /** Stores the ETag and Last-Modified of the destination. */
+  void writeValidators( const QByteArray& etag, const QByteArray& lastModified );
+
   QObject               *_parent;
   QProgressDialog       *_progressDialog;
   QNetworkAccessManager *manager;
@@ -130,6 +168,15 @@ class HttpClient : public QObject
   QString               _destination;
   bool                  downloadRunning;
   QTimer                *timer;
+
+  /** Size of the partial file at the start of the download */
+  qint64                resumeOffset;
+
+  /** Set, when the response header was checked */
+  bool                  responseChecked;
+
+  /** Set, when the destination was replaced */
+  bool                  fileChanged;
 };
 
 #endif /* HTTP_CLIENT_H */
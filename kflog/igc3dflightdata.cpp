@@ -35,134 +35,157 @@ class Igc3DViewState;
 Igc3DFlightData::Igc3DFlightData( Igc3DViewState *s )
 {
   state = s;
-  firstDataPoint = 0;
-  tmpDataPoint = 0;
   flight_opened_flag = 0;
   flightlength = 0;
-}
+  m_zShadow = 0.0;
+  m_flightValid = false;
+  m_shadowValid = false;
 
-Igc3DFlightData::~Igc3DFlightData()
-{
-  tmpDataPoint = firstDataPoint;
-
-  for( int i = 0; i < flightlength; i++ )
+  for( int i = 0; i < ViewKeySize; i++ )
     {
-      Igc3DFlightDataPoint *delpt = tmpDataPoint;
-      tmpDataPoint = tmpDataPoint->next;
-      delete delpt;
+      m_flightKey[i] = m_shadowKey[i] = 0.0;
     }
 }
 
-void Igc3DFlightData::calculate_flight(void)
+Igc3DFlightData::~Igc3DFlightData()
 {
-  float imagex, imagez;
-  float sinalpha, cosalpha, sinbeta, cosbeta, singamma, cosgamma;
-  float tx, ty, tz;
-
-  sinalpha = sin(state->alpha * M_PI / 180.0);
-  cosalpha = cos(state->alpha * M_PI / 180.0);
-  sinbeta = sin(state->beta * M_PI / 180.0);
-  cosbeta = cos(state->beta * M_PI / 180.0);
-  singamma = sin(state->gamma * M_PI / 180.0);
-  cosgamma = cos(state->gamma * M_PI / 180.0);
+}
 
-  tmpDataPoint = firstDataPoint;
+bool Igc3DFlightData::updateViewKey( float key[ViewKeySize] )
+{
+  const float current[ViewKeySize] = { state->alpha, state->beta, state->gamma,
+                                       state->deltax, state->deltay, state->deltaz,
+                                       state->mag, state->dist,
+                                       state->width, state->height };
+  bool changed = false;
 
-  for( int i=0; i < flightlength; i++)
+  for( int i = 0; i < ViewKeySize; i++ )
     {
-      // ROTATIONS
-      // Euler angles (phi, theta, psi) = (gamma, beta, alpha)
-      // rotate: psi around old z, theta around intermediate x, phi around new z'.
-      // In Mathematica, do:
-      // MatrixForm[RotationMatrix3D[\[Gamma], \[Beta], \[Alpha]] . {x, y, z}]
-      tx = tmpDataPoint->z * sinbeta * sinalpha
-          + tmpDataPoint->y * (cosalpha * singamma + cosgamma * cosbeta * sinalpha)
-          + tmpDataPoint->x * (cosgamma * cosalpha - cosbeta * singamma * sinalpha);
-
-      ty = tmpDataPoint->z * cosalpha * sinbeta
-          - tmpDataPoint->x * (cosbeta * cosalpha * singamma + cosgamma * sinalpha)
-          + tmpDataPoint->y * (cosgamma * cosbeta * cosalpha - singamma * sinalpha);
-
-      tz = tmpDataPoint->z * cosbeta - tmpDataPoint->y * cosgamma * sinbeta + tmpDataPoint->x * singamma * sinbeta;
+      if( key[i] != current[i] )
+        {
+          key[i] = current[i];
+          changed = true;
+        }
+    }
 
-      // SHIFTING AND PROJECTION
-      // shift
-      tx = tx + state->deltax;
-      ty = ty + state->deltay;
-      tz = tz + state->deltaz;
+  return changed;
+}
 
-      ty = - fabs(ty);
+void Igc3DFlightData::project( const float* x,
+                               const float* y,
+                               const float* z,
+                               const int count,
+                               QPolygon& screen )
+{
+  const float sinalpha = sin(state->alpha * M_PI / 180.0);
+  const float cosalpha = cos(state->alpha * M_PI / 180.0);
+  const float sinbeta  = sin(state->beta * M_PI / 180.0);
+  const float cosbeta  = cos(state->beta * M_PI / 180.0);
+  const float singamma = sin(state->gamma * M_PI / 180.0);
+  const float cosgamma = cos(state->gamma * M_PI / 180.0);
+
+  // ROTATIONS
+  // Euler angles (phi, theta, psi) = (gamma, beta, alpha)
+  // rotate: psi around old z, theta around intermediate x, phi around new z'.
+  // In Mathematica, do:
+  // MatrixForm[RotationMatrix3D[\[Gamma], \[Beta], \[Alpha]] . {x, y, z}]
+  const float m00 = cosgamma * cosalpha - cosbeta * singamma * sinalpha;
+  const float m01 = cosalpha * singamma + cosgamma * cosbeta * sinalpha;
+  const float m02 = sinbeta * sinalpha;
+
+  const float m10 = -(cosbeta * cosalpha * singamma + cosgamma * sinalpha);
+  const float m11 = cosgamma * cosbeta * cosalpha - singamma * sinalpha;
+  const float m12 = cosalpha * sinbeta;
+
+  const float m20 = singamma * sinbeta;
+  const float m21 = -cosgamma * sinbeta;
+  const float m22 = cosbeta;
+
+  const float dx = state->deltax;
+  const float dy = state->deltay;
+  const float dz = state->deltaz;
+
+  // The projection into the image plane and the magnification are combined
+  // into one factor, which is divided by the distance of the point.
+  const float scale = state->mag * state->dist;
+
+  // slightly above centre...
+  const float column0 = (state->height + 80) / 2;
+  const float row0    = state->width / 2;
+
+  // The loop has no dependencies between its iterations and works on
+  // contiguous arrays, so that the compiler is able to vectorize it.
+  QVector<float> rows( count );
+  QVector<float> columns( count );
+
+  float* row    = rows.data();
+  float* column = columns.data();
+
+  for( int i = 0; i < count; i++ )
+    {
+      const float tx = m00 * x[i] + m01 * y[i] + m02 * z[i] + dx;
+      const float ty = m10 * x[i] + m11 * y[i] + m12 * z[i] + dy;
+      const float tz = m20 * x[i] + m21 * y[i] + m22 * z[i] + dz;
 
-      // Project into image plane
-      imagex = - (tx / ty) * state->dist;
-      imagez = - (tz / ty) * state->dist;
+      const float k = scale / fabsf( ty );
 
-      // calculate screen coordinates
-      tmpDataPoint->column = (((state->height + 80)/ 2)) + state->mag * imagex;
-      // slightly above centre...
+      column[i] = column0 + tx * k;
+      row[i]    = row0 - tz * k;
+    }
 
-      tmpDataPoint->row = (state->width / 2 ) - state->mag * imagez;
+  screen.resize( count );
 
-      tmpDataPoint = tmpDataPoint->next;
+  for( int i = 0; i < count; i++ )
+    {
+      screen[i] = QPoint( (int) row[i], (int) column[i] );
     }
 }
 
-void Igc3DFlightData::calculate_shadow(void)
+void Igc3DFlightData::calculate_flight(void)
 {
-  float imagex, imagez;
-  float sinalpha, cosalpha, sinbeta, cosbeta, singamma, cosgamma;
-  float tx, ty, tz;
+  if( updateViewKey( m_flightKey ) == false && m_flightValid == true )
+    {
+      // Nothing has been changed since the last call.
+      return;
+    }
 
-  sinalpha = sin(state->alpha * M_PI / 180.0);
-  cosalpha = cos(state->alpha * M_PI / 180.0);
-  sinbeta = sin(state->beta * M_PI / 180.0);
-  cosbeta = cos(state->beta * M_PI / 180.0);
-  singamma = sin(state->gamma * M_PI / 180.0);
-  cosgamma = cos(state->gamma * M_PI / 180.0);
+  project( m_x.constData(), m_y.constData(), m_z.constData(),
+           flightlength, m_flightScreen );
 
-  tmpDataPoint = firstDataPoint;
+  m_flightValid = true;
+}
 
-  for( int i = 0; i < flightlength; i+=3 )
+void Igc3DFlightData::calculate_shadow(void)
+{
+  if( updateViewKey( m_shadowKey ) == false && m_shadowValid == true )
     {
-      // ROTATIONS
-      // Euler angles (phi, theta, psi) = (gamma, beta, alpha)
-      // rotate: psi around old z, theta around intermediate x, phi around new z'.
-      // In Mathematica, do:
-      // MatrixForm[RotationMatrix3D[\[Gamma], \[Beta], \[Alpha]] . {x, y, z}]
-      tx = tmpDataPoint->z_shadow * sinbeta * sinalpha
-          + tmpDataPoint->y * (cosalpha * singamma + cosgamma * cosbeta * sinalpha)
-          + tmpDataPoint->x * (cosgamma * cosalpha - cosbeta * singamma * sinalpha);
-
-      ty = tmpDataPoint->z_shadow * cosalpha * sinbeta
-          - tmpDataPoint->x * (cosbeta * cosalpha * singamma + cosgamma * sinalpha)
-          + tmpDataPoint->y * (cosgamma * cosbeta * cosalpha - singamma * sinalpha);
-
-      tz = tmpDataPoint->z_shadow * cosbeta - tmpDataPoint->y * cosgamma * sinbeta + tmpDataPoint->x * singamma * sinbeta;
+      // Nothing has been changed since the last call.
+      return;
+    }
 
-      // SHIFTING AND PROJECTION
-      // shift
-      tx = tx + state->deltax;
-      ty = ty + state->deltay;
-      tz = tz + state->deltaz;
+  project( m_shadowX.constData(), m_shadowY.constData(), m_shadowZ.constData(),
+           m_shadowX.size(), m_shadowScreen );
 
-      ty = - fabs(ty);
+  m_shadowValid = true;
+}
 
-      // Project into image plane
-      imagex = - (tx / ty) * state->dist;
-      imagez = - (tz / ty) * state->dist;
+void Igc3DFlightData::dataChanged()
+{
+  // Only every third point is used for the shadow.
+  const int count = (flightlength + 2) / 3;
 
-      // calculate screen coordinates
-      tmpDataPoint->shadow_column = (((state->height + 80)/ 2)) + state->mag * imagex;
-      // slightly above centre...
+  m_shadowX.resize( count );
+  m_shadowY.resize( count );
+  m_shadowZ.fill( m_zShadow, count );
 
-      tmpDataPoint->shadow_row = (state->width / 2 ) - state->mag * imagez;
-      tmpDataPoint->has_shadow = 1;
+  for( int i = 0; i < count; i++ )
+    {
+      m_shadowX[i] = m_x[i * 3];
+      m_shadowY[i] = m_y[i * 3];
+    }
 
-      for( int j = 0; j < 3; j++ )
-        {
-          tmpDataPoint = tmpDataPoint->next;
-        }
-  }
+  m_flightValid = false;
+  m_shadowValid = false;
 }
 
 void Igc3DFlightData::flatten_data(void)
@@ -171,19 +194,23 @@ void Igc3DFlightData::flatten_data(void)
 
   if( flight_opened_flag )
     {
-      tmpDataPoint = firstDataPoint;
       tmpx = (state->maxx + state->minx) / 2.0;
       tmpy = (state->maxy + state->miny) / 2.0;
       tmpz = (state->maxz + state->minz) / 2.0;
 
+      float* x = m_x.data();
+      float* y = m_y.data();
+      float* z = m_z.data();
+
       for( int i = 0; i < flightlength; i++ )
         {
-          tmpDataPoint->x = tmpDataPoint->x - tmpx;
-          tmpDataPoint->y = tmpDataPoint->y - tmpy;
-          tmpDataPoint->z = tmpDataPoint->z - tmpz;
-          tmpDataPoint->z_shadow = state->minz - tmpz; // shadow at lowest point of flight
-          tmpDataPoint = tmpDataPoint->next;
+          x[i] -= tmpx;
+          y[i] -= tmpy;
+          z[i] -= tmpz;
         }
+
+      m_zShadow = state->minz - tmpz; // shadow at lowest point of flight
+      dataChanged();
     }
 }
 
@@ -193,22 +220,21 @@ void Igc3DFlightData::centre_data_to_marker(void)
 
   if( flight_opened_flag )
     {
-      tmpDataPoint = firstDataPoint;
+      int marker = qBound( 0, state->flight_marker_position, flightlength - 1 );
 
-      for( int i = 0; i < state->flight_marker_position; i++ )
-        {
-          tmpDataPoint = tmpDataPoint->next;
-        }
-      tmpx = tmpDataPoint->x;
-      tmpy = tmpDataPoint->y;
-      tmpDataPoint = firstDataPoint;
+      tmpx = m_x[marker];
+      tmpy = m_y[marker];
+
+      float* x = m_x.data();
+      float* y = m_y.data();
 
       for( int i = 0; i < flightlength; i++ )
         {
-          tmpDataPoint->x = tmpDataPoint->x - tmpx;
-          tmpDataPoint->y = tmpDataPoint->y - tmpy;
-          tmpDataPoint = tmpDataPoint->next;
+          x[i] -= tmpx;
+          y[i] -= tmpy;
         }
+
+      dataChanged();
     }
 }
 
@@ -216,12 +242,13 @@ void Igc3DFlightData::change_zfactor(void)
 {
   if( flight_opened_flag )
     {
-      tmpDataPoint = firstDataPoint;
+      const float factor = state->zfactor / 1000.0;
+      const float* ph = m_pressureHeight.constData();
+      float* z = m_z.data();
 
       for( int i = 0; i < flightlength; i++ )
         {
-          tmpDataPoint->z = (float) (tmpDataPoint->pressureheight * state->zfactor) / 1000.0;
-          tmpDataPoint = tmpDataPoint->next;
+          z[i] = ph[i] * factor;
         }
 
       calculate_min_max();
@@ -236,26 +263,29 @@ void Igc3DFlightData::calculate_min_max(void)
 
   if( flight_opened_flag )
     {
-      tmpDataPoint = firstDataPoint;
-      state->maxx = state->maxy = state->maxz = -1e300;
-      state->minx = state->miny = state->minz = 1e300;
+      float minx = 1e30, miny = 1e30, minz = 1e30;
+      float maxx = -1e30, maxy = -1e30, maxz = -1e30;
+
+      const float* x = m_x.constData();
+      const float* y = m_y.constData();
+      const float* z = m_z.constData();
 
       for( int i = 0; i < flightlength; i++ )
         {
-          if( tmpDataPoint->x < state->minx )
-            state->minx = tmpDataPoint->x;
-          if( tmpDataPoint->y < state->miny )
-            state->miny = tmpDataPoint->y;
-          if( tmpDataPoint->z < state->minz )
-            state->minz = tmpDataPoint->z;
-          if( tmpDataPoint->x > state->maxx )
-            state->maxx = tmpDataPoint->x;
-          if( tmpDataPoint->y > state->maxy )
-            state->maxy = tmpDataPoint->y;
-          if( tmpDataPoint->z > state->maxz )
-            state->maxz = tmpDataPoint->z;
-          tmpDataPoint = tmpDataPoint->next;
+          minx = qMin( minx, x[i] );
+          maxx = qMax( maxx, x[i] );
+          miny = qMin( miny, y[i] );
+          maxy = qMax( maxy, y[i] );
+          minz = qMin( minz, z[i] );
+          maxz = qMax( maxz, z[i] );
         }
+
+      state->minx = minx;
+      state->miny = miny;
+      state->minz = minz;
+      state->maxx = maxx;
+      state->maxy = maxy;
+      state->maxz = maxz;
     }
   // Make sure that object is behind the projection plane
   // even if far corner is pointed right at us.
@@ -273,67 +303,47 @@ void Igc3DFlightData::calculate_min_max(void)
 
 void Igc3DFlightData::draw_flight( QPainter *p )
 {
-
   p->setPen( QColor( 255, 0, 0 ) ); // Color red
-
-  tmpDataPoint = firstDataPoint;
-
-  for( int i = 0; i < flightlength - 1; i++ )
-    {
-      p->drawLine( (int) tmpDataPoint->row, (int) tmpDataPoint->column,
-                   (int) tmpDataPoint->next->row, (int) tmpDataPoint->next->column );
-
-      tmpDataPoint = tmpDataPoint->next;
-    }
+  p->drawPolyline( m_flightScreen );
 }
 
 void Igc3DFlightData::draw_marker( QPainter *p )
 {
-  Igc3DFlightDataPoint *shadow;
+  if( m_flightScreen.isEmpty() )
+    {
+      return;
+    }
 
   p->setPen( QColor( 15, 125, 55 ) ); // green
-  tmpDataPoint = firstDataPoint;
 
-  for( int i = 0; i < state->flight_marker_position; i++ )
-    {
-      tmpDataPoint = tmpDataPoint->next;
-    }
+  int marker = qBound( 0, state->flight_marker_position, m_flightScreen.size() - 1 );
+
+  const QPoint& pt = m_flightScreen.at( marker );
 
-  if( state->flight_trace && state->flight_shadow )
+  if( state->flight_trace && state->flight_shadow && ! m_shadowScreen.isEmpty() )
     {
-      shadow = tmpDataPoint;
+      // Use the next point, which has a shadow. After the last shadow point
+      // the search is continued at the begin of the flight.
+      int shadow = (marker + 2) / 3;
 
-      while( !shadow->has_shadow )
+      if( shadow >= m_shadowScreen.size() )
         {
-          shadow = shadow->next;
+          shadow = 0;
         }
 
-      p->drawLine( (int) tmpDataPoint->row, (int) tmpDataPoint->column,
-                   (int) shadow->shadow_row, (int) shadow->shadow_column );
+      p->drawLine( pt, m_shadowScreen.at( shadow ) );
     }
   else if( state->flight_trace )
     {
-      p->drawLine( (int) tmpDataPoint->row, (int) tmpDataPoint->column - 15,
-                  (int) tmpDataPoint->row, (int) tmpDataPoint->column + 15 );
-      p->drawLine( (int) tmpDataPoint->row - 15, (int) tmpDataPoint->column,
-                   (int) tmpDataPoint->row + 15, (int) tmpDataPoint->column );
+      p->drawLine( pt.x(), pt.y() - 15, pt.x(), pt.y() + 15 );
+      p->drawLine( pt.x() - 15, pt.y(), pt.x() + 15, pt.y() );
     }
 }
 
 void Igc3DFlightData::draw_shadow(QPainter *p)
 {
   p->setPen( QColor( 10, 10, 10 ) ); // gray
-  tmpDataPoint = firstDataPoint;
-
-  for( int i = 0; i < flightlength - 3; i += 3 )
-    {
-      p->drawLine( (int) tmpDataPoint->shadow_row,
-                   (int) tmpDataPoint->shadow_column,
-                   (int) tmpDataPoint->next->next->next->shadow_row,
-                   (int) tmpDataPoint->next->next->next->shadow_column );
-
-      tmpDataPoint = tmpDataPoint->next->next->next;
-    }
+  p->drawPolyline( m_shadowScreen );
 }
 
 void Igc3DFlightData::koord2dist(void)
@@ -347,42 +357,41 @@ void Igc3DFlightData::koord2dist(void)
   centrex = (state->minx + state->maxx) / 2.0;
   centrey = (state->miny + state->maxy) / 2.0;
 
-  // Calculate x,y distances to center point
-  tmpDataPoint = firstDataPoint;
+  // Terms depending only on the center point
+  const double cosCentreY = cos( centrey * M_PI / 180.0 );
+  const double sinCentreY = sin( centrey * M_PI / 180.0 );
 
+  // Calculate x,y distances to center point
   for( int i = 0; i < flightlength; i++ )
     {
-      tmpx = tmpDataPoint->x;
-      tmpy = tmpDataPoint->y;
+      tmpx = m_x[i];
+      tmpy = m_y[i];
 
-      tmpDataPoint->x = rho * acos( cos( centrey * M_PI / 180.0 ) * cos(
-          centrey * M_PI / 180.0 ) * cos( (tmpx - centrex) * M_PI / 180.0 )
-          + sin( centrey * M_PI / 180.0 ) * sin( centrey * M_PI / 180.0 ) );
+      m_x[i] = rho * acos( cosCentreY * cosCentreY * cos( (tmpx - centrex) * M_PI / 180.0 )
+                           + sinCentreY * sinCentreY );
 
       if( centrex > tmpx )
         {
-          tmpDataPoint->x = tmpDataPoint->x * (-1.0);
+          m_x[i] = m_x[i] * (-1.0);
         }
 
-      tmpDataPoint->y = rho * acos( cos( tmpy * M_PI / 180.0 ) * cos( centrey
-          * M_PI / 180.0 ) * cos( (centrex - centrex) * M_PI / 180.0 ) + sin(
-          tmpy * M_PI / 180.0 ) * sin( centrey * M_PI / 180.0 ) );
+      m_y[i] = rho * acos( cos( tmpy * M_PI / 180.0 ) * cosCentreY
+                           + sin( tmpy * M_PI / 180.0 ) * sinCentreY );
 
       if( centrey > tmpy )
         {
-          tmpDataPoint->y = tmpDataPoint->y * (-1.0);
+          m_y[i] = m_y[i] * (-1.0);
         }
-
-      tmpDataPoint = tmpDataPoint->next;
     }
+
+  dataChanged();
 }
 
 void Igc3DFlightData::load(Flight* flight)
 {
-  int fixlines = 0;
-  QString r, s, t;
+  QString r, s;
 
-  float hh, mm, ss, lat, latmin, latsec, lon, lonmin, lonsec, hightlocal, gpshightlocal;
+  float lat, latmin, latsec, lon, lonmin, lonsec;
   char NS, AV, EW; //flags for North/South, A=Valid/V=navwarning, East/West
 
   FlightPoint cP;
@@ -391,15 +400,16 @@ void Igc3DFlightData::load(Flight* flight)
 
   if( flight && flight->getTypeID() == BaseMapElement::Flight )
     {
-      for( int i = 0; i < flight->getRouteLength() - 2; i++ )
+      const int count = qMax( 0, flight->getRouteLength() - 2 );
+
+      m_x.reserve( count );
+      m_y.reserve( count );
+      m_z.reserve( count );
+      m_pressureHeight.reserve( count );
+
+      for( int i = 0; i < count; i++ )
         {
           flight->searchGetNextPoint( i, cP );
-          hightlocal = cP.height;
-          gpshightlocal = cP.gpsHeight;
-
-          //time
-          t = printTime( cP.time, false, true );
-          sscanf( t.toLatin1().data(), "%02f:%02f:%02f", &hh, &mm, &ss );
 
           r = WGSPoint::printPos( cP.origP.lat(), true );
 
@@ -410,47 +420,34 @@ void Igc3DFlightData::load(Flight* flight)
           sscanf( s.toLatin1().data(), "%3f%c %2f%c %2f%c %c", &lon, &AV, &lonmin,
                   &AV, &lonsec, &AV, &EW );
 
-          if( firstDataPoint == 0 )
-            {
-              firstDataPoint = new Igc3DFlightDataPoint;
-              tmpDataPoint = firstDataPoint;
-              tmpDataPoint->runningnumber = 1;
-            }
-          else
-            {
-              tmpDataPoint->next = new Igc3DFlightDataPoint;
-              tmpDataPoint->next->previous = tmpDataPoint;
-              tmpDataPoint->next->runningnumber = tmpDataPoint->runningnumber + 1;
-              tmpDataPoint = tmpDataPoint->next;
-            }
-
-          tmpDataPoint->z = hightlocal / 1000.0;
-          tmpDataPoint->pressureheight = hightlocal;
-          tmpDataPoint->gpsheight = gpshightlocal;
-          tmpDataPoint->timesec = hh * 3600 + mm * 60 + ss;
-          tmpDataPoint->y = lat + (latmin / 60.0) + (latsec / 3600.0);
+          float y = lat + (latmin / 60.0) + (latsec / 3600.0);
 
           if( NS == 'S' )
             {
-              tmpDataPoint->y = tmpDataPoint->y * (-1.0);
+              y = y * (-1.0);
             }
 
-          tmpDataPoint->latdeg = tmpDataPoint->y;
-          tmpDataPoint->x = lon + (lonmin / 60.0) + (lonsec / 3600.0);
+          float x = lon + (lonmin / 60.0) + (lonsec / 3600.0);
 
           if( EW == 'W' )
             {
-              tmpDataPoint->x = tmpDataPoint->x * (-1.0);
+              x = x * (-1.0);
             }
 
-          tmpDataPoint->londeg = tmpDataPoint->x;
-          fixlines++;
+          m_x.append( x );
+          m_y.append( y );
+          m_z.append( cP.height / 1000.0 );
+          m_pressureHeight.append( cP.height );
+        }
+
+      flightlength = m_x.size();
+
+      if( flightlength > 0 )
+        {
+          flight_opened_flag = 1;
         }
 
-      tmpDataPoint->next = firstDataPoint;
-      firstDataPoint->previous = tmpDataPoint; // Closing the loop.
-      flightlength = fixlines;
-      flight_opened_flag = 1;
+      dataChanged();
     }
 }
 
@@ -459,18 +456,15 @@ void Igc3DFlightData::reset()
 {
   flight_opened_flag = 0;
   flightlength = 0;
+  m_zShadow = 0.0;
 
-  if( firstDataPoint != 0 )
-    {
-      Igc3DFlightDataPoint *tmp = firstDataPoint;
+  m_x.clear();
+  m_y.clear();
+  m_z.clear();
+  m_pressureHeight.clear();
 
-      while( tmp->next != firstDataPoint )
-        {
-          tmp = tmp->next;
-          delete tmp->previous;
-        }
+  m_flightScreen.clear();
+  m_shadowScreen.clear();
 
-      delete tmp;
-      firstDataPoint = 0;
-    }
+  dataChanged();
 }
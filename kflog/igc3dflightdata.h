@@ -22,6 +22,9 @@
 #ifndef IGC_3D_FLIGHT_DATA_H
 #define IGC_3D_FLIGHT_DATA_H
 
+#include <QPolygon>
+#include <QVector>
+
 #include "igc3dviewstate.h"
 #include "flight.h"
 
@@ -31,28 +34,13 @@ class QString;
 class Flight;
 class Igc3DViewState;
 
-class Igc3DFlightDataPoint
-{
-	public:
-
-		Igc3DFlightDataPoint()
-		{
-		  next = previous = 0;
-		  x = y = z = z_shadow = 0.0;
-		  has_shadow = 0;
-		};
-
-		Igc3DFlightDataPoint *next, *previous;
-		int runningnumber;
-		int has_shadow;
-		float x, y, z, z_shadow;
-		float row, column;
-		float shadow_row, shadow_column;
-		float latdeg, londeg;
-		float pressureheight, gpsheight;
-		float timesec;
-};
-
+/**
+ * The coordinates of the flight points are stored in separate contiguous
+ * arrays. The projection into the screen is done with a precomputed rotation
+ * matrix in a simple loop, which can be vectorized by the compiler. The
+ * projected points are cached and only calculated again, if the view state
+ * or the flight data have been changed.
+ */
 class Igc3DFlightData
 {
 	public:
@@ -73,18 +61,71 @@ class Igc3DFlightData
 		void load(Flight *flight);
 		int flight_opened_flag;
 		void centre_data_to_marker(void);
-	
-		Igc3DFlightDataPoint *firstDataPoint, *tmpDataPoint;
+
 		int flightlength;
-		
+
   private: // Private methods
 
     /** reset data structures. */
     void reset();
 
+    /**
+     * Must be called after a change of the flight coordinates. Rebuilds the
+     * shadow coordinates and invalidates the projected points.
+     */
+    void dataChanged();
+
+    /**
+     * Number of view state values, which are used by the projection.
+     */
+    enum { ViewKeySize = 10 };
+
+    /**
+     * Stores the current view state values into the passed key and returns
+     * true, if they differ from the old key content.
+     */
+    bool updateViewKey( float key[ViewKeySize] );
+
+    /**
+     * Rotates, shifts and projects the passed points into the screen.
+     */
+    void project( const float* x,
+                  const float* y,
+                  const float* z,
+                  const int count,
+                  QPolygon& screen );
+
 	private:
 
 		Igc3DViewState *state;
+
+		/** Flight coordinates in km relative to the center of the box. */
+		QVector<float> m_x;
+		QVector<float> m_y;
+		QVector<float> m_z;
+
+		/** Pressure heights of the flight points in meters. */
+		QVector<float> m_pressureHeight;
+
+		/** Height of the shadow plane. */
+		float m_zShadow;
+
+		/** Coordinates of the shadow, only every third flight point is used. */
+		QVector<float> m_shadowX;
+		QVector<float> m_shadowY;
+		QVector<float> m_shadowZ;
+
+		/** Projected flight and shadow points. */
+		QPolygon m_flightScreen;
+		QPolygon m_shadowScreen;
+
+		/** View state values used for the cached projected points. */
+		float m_flightKey[ViewKeySize];
+		float m_shadowKey[ViewKeySize];
+
+		/** Flags, if the cached projected points are valid. */
+		bool m_flightValid;
+		bool m_shadowValid;
 	};
 
 #endif
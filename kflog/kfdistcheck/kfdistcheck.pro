@@ -0,0 +1,35 @@
+# KFLog qmake project file
+
+# Qt5 needs the QtWidgets library
+greaterThan(QT_MAJOR_VERSION, 4) {
+QT += widgets
+DEFINES += QT_5
+}
+
+TEMPLATE = app
+
+CONFIG += console
+
+INCLUDEPATH += ../
+
+SOURCES =   main.cpp \
+            ../geovectors.cpp \
+            ../mapcalc.cpp \
+            ../mapmatrix.cpp \
+            ../projectionbase.cpp \
+            ../projectioncylindric.cpp \
+            ../projectionlambert.cpp \
+            ../wgspoint.cpp
+
+HEADERS =   ../geovectors.h \
+            ../mapcalc.h \
+            ../mapmatrix.h \
+            ../projectionbase.h \
+            ../projectioncylindric.h \
+            ../projectionlambert.h \
+            ../wgspoint.h
+
+OBJECTS_DIR = .obj
+MOC_DIR = .obj
+
+DESTDIR = ../../release/bin
@@ -0,0 +1,215 @@
+/***********************************************************************
+**
+**   main.cpp
+**
+**   This file is part of KFLog.
+**
+************************************************************************
+**
+**   Copyright (c):  2026 by agent <agent@local>
+**
+**   This file is distributed under the terms of the General Public
+**   License. See the file COPYING for more information.
+**
+***********************************************************************/
+
+/**
+ * Compares the great circle distances of \ref GeoVectors with the haversine
+ * distances of \ref dist over the B-records of IGC files, e.g.
+ *
+ *   kfdistcheck ../testdata/391V7331.igc ../testdata/45VGW1J3.IGC
+ *
+ * Checked are the legs between neighboured fixes, the legs between fixes
+ * spread over the whole flight, as they are used by the optimization, and
+ * the batch distances of single fixes to all others. A distance passes, if
+ * it differs by at most Tolerance from dist(). The exit code is 0, if all
+ * distances passed.
+ */
+
+#include <cmath>
+#include <cstdio>
+
+#include <QtCore>
+
+#include "geovectors.h"
+#include "mapcalc.h"
+#include "mapmatrix.h"
+
+// Needed by the linked KFLog sources.
+QSettings _settings( QSettings::UserScope, "KFLog", "kfdistcheck" );
+MapMatrix *_globalMapMatrix = static_cast<MapMatrix *> (0);
+
+/** Maximum difference of a distance to dist() in km, i.e. 1 mm. */
+static const double Tolerance = 1e-6;
+
+/** Distance of the fixes, which are combined to long legs. */
+static const int Stride = 50;
+
+/**
+ * Reads the positions of the valid B-records of an IGC file in KFLog
+ * coordinates, as it is done by the flight loader.
+ */
+static bool readFixes( const QString& fileName, QList<QPoint>& fixes )
+{
+  QFile file( fileName );
+
+  if( ! file.open( QIODevice::ReadOnly ) )
+    {
+      return false;
+    }
+
+  while( ! file.atEnd() )
+    {
+      QByteArray line = file.readLine();
+
+      if( line.size() < 35 || line.at(0) != 'B' || line.at(24) != 'A' )
+        {
+          continue;
+        }
+
+      int hh, mm, ss, lat, latmin, lon, lonmin;
+      char latChar, lonChar;
+
+      if( sscanf( line.mid(1, 23).constData(), "%2d%2d%2d%2d%5d%1c%3d%5d%1c",
+                  &hh, &mm, &ss, &lat, &latmin, &latChar,
+                  &lon, &lonmin, &lonChar ) != 9 )
+        {
+          continue;
+        }
+
+      int latTemp = lat * 600000 + latmin * 10;
+      int lonTemp = lon * 600000 + lonmin * 10;
+
+      if( latChar == 'S' ) latTemp = -latTemp;
+      if( lonChar == 'W' ) lonTemp = -lonTemp;
+
+      fixes.append( QPoint( latTemp, lonTemp ) );
+    }
+
+  return true;
+}
+
+/**
+ * Compares one distance and updates the statistics.
+ */
+static void compare( const QPoint& p1, const QPoint& p2, const double d,
+                     double& maxDiff, int& count, int& failed )
+{
+  double ref = dist( p1.x(), p1.y(), p2.x(), p2.y() );
+  double diff = fabs( d - ref );
+
+  maxDiff = qMax( maxDiff, diff );
+  count++;
+
+  if( ! ( diff <= Tolerance ) )
+    {
+      failed++;
+    }
+}
+
+/**
+ * Checks the distances of one file and prints the result.
+ *
+ * \return True, if all distances passed.
+ */
+static bool checkFile( const QString& fileName )
+{
+  QTextStream out( stdout );
+  QList<QPoint> fixes;
+
+  if( ! readFixes( fileName, fixes ) || fixes.size() < 2 )
+    {
+      out << fileName << ": no fixes found" << endl;
+      return false;
+    }
+
+  GeoVectors vectors;
+
+  for( int i = 0; i < fixes.size(); i++ )
+    {
+      vectors.append( fixes.at(i) );
+    }
+
+  const int n = fixes.size();
+
+  double maxDiff = 0.0;
+  int count = 0;
+  int failed = 0;
+
+  // Legs between neighboured fixes
+  QVector<double> lengths( n );
+  vectors.segmentLengths( lengths.data() );
+
+  double track = 0.0;
+  double trackRef = 0.0;
+
+  for( int i = 1; i < n; i++ )
+    {
+      compare( fixes.at(i - 1), fixes.at(i), lengths.at(i), maxDiff, count, failed );
+
+      track += lengths.at(i);
+      trackRef += dist( fixes.at(i - 1).x(), fixes.at(i - 1).y(),
+                        fixes.at(i).x(), fixes.at(i).y() );
+    }
+
+  // Long legs over the whole flight
+  for( int i = 0; i < n; i += Stride )
+    {
+      for( int j = i + Stride; j < n; j += Stride )
+        {
+          compare( fixes.at(i), fixes.at(j), vectors.dist( i, j ), maxDiff, count, failed );
+        }
+    }
+
+  // Batch distances of single fixes to all fixes
+  QVector<double> batch( n );
+
+  for( int i = 0; i < n; i += n / 4 + 1 )
+    {
+      vectors.distances( i, 0, n, batch.data() );
+
+      for( int j = 0; j < n; j++ )
+        {
+          compare( fixes.at(i), fixes.at(j), batch.at(j), maxDiff, count, failed );
+        }
+
+      vectors.distances( fixes.at(i), 0, n, batch.data() );
+
+      for( int j = 0; j < n; j++ )
+        {
+          compare( fixes.at(i), fixes.at(j), batch.at(j), maxDiff, count, failed );
+        }
+    }
+
+  out << fileName << ": " << n << " fixes, " << count << " distances, "
+      << "track " << QString::number( track, 'f', 6 ) << " km, "
+      << "dist() " << QString::number( trackRef, 'f', 6 ) << " km, "
+      << "max. difference " << QString::number( maxDiff * 1e6, 'f', 3 ) << " mm, "
+      << failed << " failed" << endl;
+
+  return failed == 0;
+}
+
+int main( int argc, char *argv[] )
+{
+  QCoreApplication app( argc, argv );
+
+  QStringList files = app.arguments().mid( 1 );
+
+  if( files.isEmpty() )
+    {
+      QTextStream( stderr ) << "Usage: kfdistcheck <igc files>" << endl;
+      return 2;
+    }
+
+  QTextStream( stdout ) << "Tolerance " << Tolerance * 1e6 << " mm" << endl;
+
+  bool ok = true;
+
+  for( int i = 0; i < files.size(); i++ )
+    {
+      ok = checkFile( files.at(i) ) && ok;
+    }
+
+  return ok ? 0 : 1;
+}
@@ -0,0 +1,331 @@
+/***********************************************************************
+**
+**   httpcheck.cpp
+**
+**   This file is part of KFLog.
+**
+************************************************************************
+**
+**   Copyright (c):  2026 by agent <agent@local>
+**
+**   This file is distributed under the terms of the General Public
+**   License. See the file COPYING for more information.
+**
+***********************************************************************/
+
+#include <QtCore>
+#include <QtNetwork>
+
+#include "httpcheck.h"
+#include "httpclient.h"
+
+/** Size of the served contents */
+static const int ContentSize = 1000;
+
+/** Bytes sent of the short body */
+static const int ShortSize = 400;
+
+/** Maximum duration of a download in ms */
+static const int Timeout = 10000;
+
+static const char* LastModified = "Mon, 19 Oct 2026 12:00:00 GMT";
+
+/** \return The content of the passed version. */
+static QByteArray content( const char version )
+{
+  QByteArray data;
+
+  for( int i = 0; i < ContentSize; i++ )
+    {
+      data.append( char( version + i % 26 ) );
+    }
+
+  return data;
+}
+
+HttpCheck::HttpCheck( const QString& directory, QObject *parent ) :
+  QObject(parent),
+  m_directory(directory),
+  m_server(0),
+  m_client(0),
+  m_answer(Full),
+  m_finished(false),
+  m_error(QNetworkReply::NoError),
+  m_failed(0)
+{
+  m_destination = m_directory + "/file.txt";
+
+  m_server = new QTcpServer( this );
+
+  connect( m_server, SIGNAL(newConnection()), this, SLOT(slotNewConnection()) );
+
+  m_client = new HttpClient( this, false );
+
+  connect( m_client, SIGNAL(finished(QString &, QNetworkReply::NetworkError)),
+           this, SLOT(slotFinished(QString &, QNetworkReply::NetworkError)) );
+}
+
+HttpCheck::~HttpCheck()
+{
+}
+
+int HttpCheck::run()
+{
+  QTextStream out( stdout );
+
+  QDir().mkpath( m_directory );
+  QFile::remove( m_destination );
+  QFile::remove( m_destination + ".part" );
+  QFile::remove( m_destination + ".etag" );
+
+  if( ! m_server->listen( QHostAddress::LocalHost, 0 ) )
+    {
+      out << "Cannot start the server: " << m_server->errorString() << endl;
+      return 2;
+    }
+
+  const QByteArray v1 = content( 'a' );
+  const QByteArray v2 = content( 'A' );
+
+  QNetworkReply::NetworkError error;
+
+  out << "200: complete download" << endl;
+  error = __download( Full );
+  __check( "no error", error == QNetworkReply::NoError );
+  __check( "file changed", m_client->isFileChanged() );
+  __check( "content", __readFile( m_destination ) == v1 );
+  __check( "no partial file", ! QFile::exists( m_destination + ".part" ) );
+  __check( "ETag stored", __readFile( m_destination + ".etag" ).startsWith( "\"v1\"\n" ) );
+
+  out << "304: not modified" << endl;
+  error = __download( NotModified );
+  __check( "If-None-Match sent", m_request.value( "if-none-match" ) == "\"v1\"" );
+  __check( "no error", error == QNetworkReply::NoError );
+  __check( "file not changed", ! m_client->isFileChanged() );
+  __check( "content", __readFile( m_destination ) == v1 );
+  __check( "no partial file", ! QFile::exists( m_destination + ".part" ) );
+
+  out << "short body: connection closed after " << ShortSize << " of "
+      << ContentSize << " bytes" << endl;
+  error = __download( Short );
+
+  const QByteArray part = __readFile( m_destination + ".part" );
+
+  __check( "error reported", error != QNetworkReply::NoError );
+  __check( "file not changed", ! m_client->isFileChanged() );
+  __check( "content", __readFile( m_destination ) == v1 );
+  __check( "partial file kept", ! part.isEmpty() && v2.startsWith( part ) &&
+                                part.size() < ContentSize );
+  __check( "ETag stored", __readFile( m_destination + ".etag" ).startsWith( "\"v2\"\n" ) );
+
+  out << "206: resumed download" << endl;
+  error = __download( Resume );
+  __check( "Range sent", m_request.value( "range" ) ==
+                         "bytes=" + QByteArray::number( part.size() ) + "-" );
+  __check( "If-Range sent", m_request.value( "if-range" ) == "\"v2\"" );
+  __check( "no error", error == QNetworkReply::NoError );
+  __check( "file changed", m_client->isFileChanged() );
+  __check( "content", __readFile( m_destination ) == v2 );
+  __check( "no partial file", ! QFile::exists( m_destination + ".part" ) );
+
+  out << m_failed << " checks failed" << endl;
+
+  return m_failed == 0 ? 0 : 1;
+}
+
+QNetworkReply::NetworkError HttpCheck::__download( const Answer answer )
+{
+  m_answer   = answer;
+  m_finished = false;
+  m_error    = QNetworkReply::NoError;
+  m_request.clear();
+
+  QString url = QString( "http://127.0.0.1:%1/file.txt" ).arg( m_server->serverPort() );
+
+  if( ! m_client->downloadFile( url, m_destination ) )
+    {
+      return QNetworkReply::UnknownNetworkError;
+    }
+
+  QElapsedTimer timer;
+  timer.start();
+
+  while( ! m_finished )
+    {
+      if( timer.elapsed() > Timeout )
+        {
+          // Aborts the download, the client finishes it.
+          m_client->slotCancelDownload();
+          timer.restart();
+        }
+
+      QCoreApplication::processEvents( QEventLoop::WaitForMoreEvents, 100 );
+    }
+
+  return m_error;
+}
+
+void HttpCheck::slotFinished( QString& /* url */, QNetworkReply::NetworkError code )
+{
+  m_error    = code;
+  m_finished = true;
+}
+
+void HttpCheck::slotNewConnection()
+{
+  while( m_server->hasPendingConnections() )
+    {
+      QTcpSocket* socket = m_server->nextPendingConnection();
+
+      connect( socket, SIGNAL(readyRead()), this, SLOT(slotReadRequest()) );
+      connect( socket, SIGNAL(disconnected()), socket, SLOT(deleteLater()) );
+    }
+}
+
+void HttpCheck::slotReadRequest()
+{
+  QTcpSocket* socket = qobject_cast<QTcpSocket *>( sender() );
+
+  if( socket == 0 )
+    {
+      return;
+    }
+
+  QByteArray& buffer = m_buffers[socket];
+  buffer.append( socket->readAll() );
+
+  int end = buffer.indexOf( "\r\n\r\n" );
+
+  if( end < 0 )
+    {
+      return;
+    }
+
+  // The request line is followed by the headers.
+  QList<QByteArray> lines = buffer.left( end ).split( '\n' );
+  QMap<QByteArray, QByteArray> headers;
+
+  for( int i = 1; i < lines.size(); i++ )
+    {
+      int colon = lines.at(i).indexOf( ':' );
+
+      if( colon > 0 )
+        {
+          headers.insert( lines.at(i).left( colon ).trimmed().toLower(),
+                          lines.at(i).mid( colon + 1 ).trimmed() );
+        }
+    }
+
+  m_buffers.remove( socket );
+  m_request = headers;
+
+  __answer( socket, headers );
+}
+
+void HttpCheck::__answer( QTcpSocket* socket,
+                          const QMap<QByteArray, QByteArray>& headers )
+{
+  const QByteArray v1 = content( 'a' );
+  const QByteArray v2 = content( 'A' );
+
+  QByteArray etag = "\"v1\"";
+  QByteArray body = v1;
+  QByteArray status = "200 OK";
+  QByteArray range;
+  int length = ContentSize;
+
+  switch( m_answer )
+    {
+      case Full:
+        break;
+
+      case NotModified:
+
+        if( headers.value( "if-none-match" ) == etag )
+          {
+            status = "304 Not Modified";
+            body.clear();
+          }
+
+        break;
+
+      case Short:
+
+        etag = "\"v2\"";
+        body = v2.left( ShortSize );
+        break;
+
+      case Resume:
+        {
+          etag = "\"v2\"";
+          body = v2;
+
+          QByteArray rangeHeader = headers.value( "range" );
+          bool ok = false;
+          int first = -1;
+
+          if( rangeHeader.startsWith( "bytes=" ) && rangeHeader.endsWith( "-" ) )
+            {
+              first = rangeHeader.mid( 6, rangeHeader.size() - 7 ).toInt( &ok );
+            }
+
+          if( ok && first > 0 && first < ContentSize &&
+              headers.value( "if-range" ) == etag )
+            {
+              status = "206 Partial Content";
+              range  = "bytes " + QByteArray::number( first ) + "-" +
+                       QByteArray::number( ContentSize - 1 ) + "/" +
+                       QByteArray::number( ContentSize );
+              body   = v2.mid( first );
+              length = body.size();
+            }
+
+          break;
+        }
+    }
+
+  QByteArray answer = "HTTP/1.1 " + status + "\r\n";
+
+  answer += "ETag: " + etag + "\r\n";
+
+  if( ! status.startsWith( "304" ) )
+    {
+      answer += "Last-Modified: " + QByteArray( LastModified ) + "\r\n";
+      answer += "Content-Length: " + QByteArray::number( length ) + "\r\n";
+    }
+
+  if( ! range.isEmpty() )
+    {
+      answer += "Content-Range: " + range + "\r\n";
+    }
+
+  answer += "Connection: close\r\n\r\n";
+  answer += body;
+
+  socket->write( answer );
+
+  // A short body is closed before the announced length is reached.
+  socket->disconnectFromHost();
+}
+
+void HttpCheck::__check( const QString& name, const bool ok )
+{
+  QTextStream( stdout ) << "  " << ( ok ? "ok     " : "FAILED " ) << name << endl;
+
+  if( ! ok )
+    {
+      m_failed++;
+    }
+}
+
+QByteArray HttpCheck::__readFile( const QString& fileName )
+{
+  QFile file( fileName );
+
+  if( ! file.open( QIODevice::ReadOnly ) )
+    {
+      return QByteArray();
+    }
+
+  return file.readAll();
+}
@@ -0,0 +1,133 @@
+/***********************************************************************
+**
+**   httpcheck.h
+**
+**   This file is part of KFLog.
+**
+************************************************************************
+**
+**   Copyright (c):  2026 by agent <agent@local>
+**
+**   This file is distributed under the terms of the General Public
+**   License. See the file COPYING for more information.
+**
+***********************************************************************/
+
+/**
+ * \class HttpCheck
+ *
+ * \author agent
+ *
+ * \brief Checks the HttpClient against a local scripted HTTP server.
+ *
+ * The server listens on the loopback interface and answers every request
+ * according to the current case. The cases run one after the other on the
+ * same destination file:
+ *
+ * - 200: the complete file is sent with an ETag.
+ * - 304: the client must send If-None-Match, the file is not modified.
+ * - short body: a new content is announced, but the connection is closed
+ *   after a part of it. The partial file must be kept.
+ * - 206 resume: the client must request the rest with Range and If-Range,
+ *   the completed file must replace the destination.
+ *
+ * \date 2026
+ *
+ * \version 1.0
+ */
+
+#ifndef HTTP_CHECK_H
+#define HTTP_CHECK_H
+
+#include <QByteArray>
+#include <QHash>
+#include <QMap>
+#include <QNetworkReply>
+#include <QObject>
+#include <QString>
+
+class QTcpServer;
+class QTcpSocket;
+class HttpClient;
+
+class HttpCheck : public QObject
+{
+  Q_OBJECT
+
+ private:
+
+  Q_DISABLE_COPY ( HttpCheck )
+
+ public:
+
+  /**
+   * \param directory Directory of the downloaded files
+   */
+  HttpCheck( const QString& directory, QObject *parent = 0 );
+
+  virtual ~HttpCheck();
+
+  /**
+   * Runs all cases.
+   *
+   * \return The exit code, 0 if all cases passed.
+   */
+  int run();
+
+ private slots:
+
+  /** A client has connected to the server. */
+  void slotNewConnection();
+
+  /** Request data of a client are available. */
+  void slotReadRequest();
+
+  /** The HttpClient has finished a download. */
+  void slotFinished( QString &url, QNetworkReply::NetworkError code );
+
+ private:
+
+  /** The answer of the server to the current case */
+  enum Answer
+  {
+    Full,
+    NotModified,
+    Short,
+    Resume
+  };
+
+  /**
+   * Downloads the file with the server answer of the case.
+   *
+   * \return The error code of the download.
+   */
+  QNetworkReply::NetworkError __download( const Answer answer );
+
+  /** Answers a complete request. */
+  void __answer( QTcpSocket* socket, const QMap<QByteArray, QByteArray>& headers );
+
+  /** Prints the result of a check and counts the failures. */
+  void __check( const QString& name, const bool ok );
+
+  /** \return The content of a file or an empty array. */
+  static QByteArray __readFile( const QString& fileName );
+
+  QString     m_directory;
+  QString     m_destination;
+  QTcpServer* m_server;
+  HttpClient* m_client;
+
+  Answer      m_answer;
+
+  /** Headers of the last request, the names are in lower case. */
+  QMap<QByteArray, QByteArray> m_request;
+
+  /** Received request data of every connection */
+  QHash<QTcpSocket*, QByteArray> m_buffers;
+
+  bool        m_finished;
+  QNetworkReply::NetworkError m_error;
+  int         m_failed;
+};
+
+#endif
@@ -0,0 +1,29 @@
+# KFLog qmake project file
+
+# Qt5 needs the QtWidgets library
+greaterThan(QT_MAJOR_VERSION, 4) {
+QT += widgets
+DEFINES += QT_5
+}
+
+QT += network
+
+TEMPLATE = app
+
+CONFIG += console
+
+INCLUDEPATH += ../
+
+SOURCES =   httpcheck.cpp \
+            main.cpp \
+            ../authdialog.cpp \
+            ../httpclient.cpp
+
+HEADERS =   httpcheck.h \
+            ../authdialog.h \
+            ../httpclient.h
+
+OBJECTS_DIR = .obj
+MOC_DIR = .obj
+
+DESTDIR = ../../release/bin
@@ -0,0 +1,49 @@
+/***********************************************************************
+**
+**   main.cpp
+**
+**   This file is part of KFLog.
+**
+************************************************************************
+**
+**   Copyright (c):  2026 by agent <agent@local>
+**
+**   This file is distributed under the terms of the General Public
+**   License. See the file COPYING for more information.
+**
+***********************************************************************/
+
+/**
+ * Checks the download cases of the HttpClient against a local scripted
+ * HTTP server, see \ref HttpCheck. No network access is needed.
+ *
+ *   kfhttpcheck [directory of the downloaded files]
+ *
+ * The exit code is 0, if all checks passed.
+ */
+
+#include <QtCore>
+
+#include "httpcheck.h"
+
+// Needed by the HttpClient, which reads the proxy from the settings.
+QSettings _settings( QSettings::UserScope, "KFLog", "kfhttpcheck" );
+
+int main( int argc, char *argv[] )
+{
+  QCoreApplication app( argc, argv );
+
+  // The local server must not be reached through a proxy.
+  qputenv( "http_proxy", "" );
+
+  QString directory = QDir::tempPath() + "/kfhttpcheck";
+
+  if( app.arguments().size() > 1 )
+    {
+      directory = app.arguments().at(1);
+    }
+
+  HttpCheck check( directory );
+
+  return check.run();
+}
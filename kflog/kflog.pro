@@ -72,6 +72,8 @@ SOURCES = \
     centertodialog.cpp \
     configmapelement.cpp \
     coordedit.cpp \
+    csvtokenizer.cpp \
+    curvesmoother.cpp \
     da4record.cpp \
     dataview.cpp \
     distance.cpp \
@@ -81,14 +83,18 @@ SOURCES = \
     evaluationframe.cpp \
     evaluationview.cpp \
     flight.cpp \
+    flightanalysiscache.cpp \
+    flightdownloadthread.cpp \
     flightdataprint.cpp \
     flightgroup.cpp \
+    flightgroupindex.cpp \
     flightgrouplistviewitem.cpp \
     flightlistviewitem.cpp \
     flightloader.cpp \
     flightrecorderpluginbase.cpp \
     flightselectiondialog.cpp \
     flighttask.cpp \
+    geovectors.cpp \
     helpwindow.cpp \
     httpclient.cpp \
     igc3ddialog.cpp \
@@ -104,11 +110,14 @@ SOURCES = \
     main.cpp \
     mainwindow.cpp \
     map.cpp \
+    mapatlas.cpp \
     mapcalc.cpp \
     mapconfig.cpp \
     mapcontents.cpp \
     mapcontrolview.cpp \
+    maphitindex.cpp \
     mapmatrix.cpp \
+    mappedwaypointfile.cpp \
     MessageHelpBox.cpp \
     objecttree.cpp \
     OpenAip.cpp \
@@ -123,6 +132,8 @@ SOURCES = \
     recorderdialog.cpp \
     rowdelegate.cpp \
     runway.cpp \
+    sectorcrossing.cpp \
+    serialtransport.cpp \
     singlepoint.cpp \
     Speed.cpp \
     taskdataprint.cpp \
@@ -153,6 +164,8 @@ HEADERS = \
     centertodialog.h \
     configmapelement.h \
     coordedit.h \
+    csvtokenizer.h \
+    curvesmoother.h \
     da4record.h \
     dataview.h \
     distance.h \
@@ -162,8 +175,11 @@ HEADERS = \
     evaluationframe.h \
     evaluationview.h \
     flight.h \
+    flightanalysiscache.h \
+    flightdownloadthread.h \
     flightdataprint.h \
     flightgroup.h \
+    flightgroupindex.h \
     flightgrouplistviewitem.h \
     flightlistviewitem.h \
     flightloader.h \
@@ -172,6 +188,7 @@ HEADERS = \
     flightselectiondialog.h \
     flighttask.h \
     frstructs.h \
+    geovectors.h \
     gliders.h \
     helpwindow.h \
     httpclient.h \
@@ -187,12 +204,15 @@ HEADERS = \
     lineelement.h \
     mainwindow.h \
     map.h \
+    mapatlas.h \
     mapcalc.h \
     mapconfig.h \
     mapcontents.h \
     mapcontrolview.h \
     mapdefaults.h \
+    maphitindex.h \
     mapmatrix.h \
+    mappedwaypointfile.h \
     MessageHelpBox.h \
     MetaTypes.h \
     objecttree.h \
@@ -207,7 +227,10 @@ HEADERS = \
     radiopoint.h \
     recorderdialog.h \
     rowdelegate.h \
+    sectorcrossing.h \
+    serialtransport.h \
     singlepoint.h \
+    sourcecache.h \
     Speed.h \
     resource.h \
     runway.h \
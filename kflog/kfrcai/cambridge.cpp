@@ -44,6 +44,9 @@
 #define TIMEOUT_ERROR  -1
 #define CHECKSUM_ERROR -2
 
+// Timeout of a serial read in milliseconds
+#define READ_TIMEOUT  100
+
 
 // Cambridge waypoint attributes are using bit arrays
 #define CAI_TURNPOINT        1
@@ -59,32 +62,6 @@
 
 const char* c36 = "0123456789abcdefghijklmnopqrstuvwxyz";
 
-/*
- * name and ID of the port
- */
-const char* portName = "\0";
-int portID;
-
-/*
- * holds the port-settings at start of the application
- */
-struct termios oldTermEnv;
-
-/*
- * is used to change the port-settings
- */
-struct termios newTermEnv;
-
-/*
- * Needed to reset the serial port in any case of unexpected exiting
- * of the programm. Called via signal-handler of the runtime-environment.
- */
-void releaseTTY(int /* signal*/)
-{
-  tcsetattr(portID, TCSANOW, &oldTermEnv);
-  //exit(-1);
-}
-
 void debugHex (const void* buf, unsigned int size)
 {
   for (unsigned int ix1=0; ix1 < size; ix1+=0x10)
@@ -168,7 +145,6 @@ Cambridge::Cambridge( QObject *parent ) : FlightRecorderPluginBase( parent )
   _capabilities.supEditArvRadius = true;
   _capabilities.supEditAudio = true;
   _capabilities.supEditLogInterval = true;
-  portID = -1;
 }
 
 Cambridge::~Cambridge()
@@ -188,57 +164,8 @@ QString Cambridge::getLibName() const
 
 int Cambridge::openRecorder(const QString& pName, int baud)
 {
-  portName = pName.toLatin1().data();
-
-  portID = open(portName, O_RDWR | O_NOCTTY);
-
-  if(portID != -1) {
-    //
-    // Before we change any port-settings, we must establish a
-    // signal-handler, which is used to restore the port-settings
-    // after terminating the programm.
-    //    Because a SIGKILL-signal removes the programm immediately,
-    // the status of the port will be undefined.
-    //
-    struct sigaction sact;
-
-    sact.sa_handler = releaseTTY;
-    sigaction(SIGHUP, &sact, NULL);
-    sigaction(SIGINT, &sact, NULL);
-    sigaction(SIGPIPE, &sact, NULL);
-    sigaction(SIGTERM, &sact, NULL);
-
-    /*
-     * Set the terminal mode of the serial line
-     */
-
-    // reading the current port-settings
-    tcgetattr(portID, &newTermEnv);
-
-    // storing the port-settings to restore them ...
-    oldTermEnv = newTermEnv;
-    /*
-     * Do some common settup
-     */
-    newTermEnv.c_iflag &= ~(IGNBRK | BRKINT | PARMRK | ISTRIP | INLCR | IGNCR | ICRNL | IXON);
-    newTermEnv.c_oflag &= ~OPOST;
-    newTermEnv.c_lflag &= ~(ECHO | ECHONL | ICANON | ISIG | IEXTEN);
-    /*
-     * No flow control at all :-(
-     */
-    newTermEnv.c_cflag &= ~(CSIZE | PARENB | CRTSCTS | IXON | IXOFF);
-    newTermEnv.c_cflag |= (CS8 | CLOCAL);
-
-    // control characters
-    newTermEnv.c_cc[VMIN] = 0; // don't wait for a character
-    newTermEnv.c_cc[VTIME] = 1; // wait at least 1 msec.
-
-    cfsetospeed(&newTermEnv, B4800);
-    cfsetispeed(&newTermEnv, B4800);
-
-    // Activating the port-settings
-    tcsetattr(portID, TCSANOW, &newTermEnv);
-
+  // No flow control at all :-(
+  if( _serial.open( pName, B4800 ) ) {
     // now change baud rate to user setting
     wb(STX);
     wait_ms(100);
@@ -247,64 +174,52 @@ int Cambridge::openRecorder(const QString& pName, int baud)
         sendCommand("baud 4");
         qDebug("baud 4");
         wait_ms(50);
-        cfsetospeed(&newTermEnv, B1200);
-        cfsetispeed(&newTermEnv, B1200);
+        _serial.setSpeed(B1200);
         break;
       case 2400:
         sendCommand("baud 5");
         qDebug("baud 5");
         wait_ms(50);
-        cfsetospeed(&newTermEnv, B2400);
-        cfsetispeed(&newTermEnv, B2400);
+        _serial.setSpeed(B2400);
         break;
       case 4800:
         sendCommand("baud 6");
         qDebug("baud 6");
         wait_ms(50);
-        cfsetospeed(&newTermEnv, B4800);
-        cfsetispeed(&newTermEnv, B4800);
+        _serial.setSpeed(B4800);
         break;
       case 9600:
         sendCommand("baud 7");
         qDebug("baud 7");
         wait_ms(50);
-        cfsetospeed(&newTermEnv, B9600);
-        cfsetispeed(&newTermEnv, B9600);
+        _serial.setSpeed(B9600);
         break;
       case 19200:
         sendCommand("baud 8");
         qDebug("baud 8");
         wait_ms(50);
-        cfsetospeed(&newTermEnv, B19200);
-        cfsetispeed(&newTermEnv, B19200);
+        _serial.setSpeed(B19200);
         break;
       case 38400:
         sendCommand("baud 9");
         qDebug("baud 9");
         wait_ms(50);
-        cfsetospeed(&newTermEnv, B38400);
-        cfsetispeed(&newTermEnv, B38400);
+        _serial.setSpeed(B38400);
         break;
       case 57600:
         sendCommand("baud 10");
         qDebug("baud 10");
         wait_ms(50);
-        cfsetospeed(&newTermEnv, B57600);
-        cfsetispeed(&newTermEnv, B57600);
+        _serial.setSpeed(B57600);
         break;
 //      case 115200:
 //        sendCommand("baud 11");
 //        qDebug("baud 11");
 //        wait_ms(50);
-//        cfsetospeed(&newTermEnv, B115200);
-//        cfsetispeed(&newTermEnv, B115200);
+//        _serial.setSpeed(B115200);
 //        break;
     }
 
-    // Activating the port-settings
-    qDebug("activating port setting ...");
-    tcsetattr(portID, TCSANOW, &newTermEnv);
-    qDebug("Done.");
     wait_ms(50);
 
     _isConnected = true;
@@ -324,7 +239,7 @@ int Cambridge::openRecorder(const QString& /*URL*/)
 
 int Cambridge::closeRecorder()
 {
-  if (portID != -1) {
+  if (_serial.isOpen()) {
     // before we close the connection, set the baud rate
     // of the CAI 302 back to its default value and let
     // it provide nmea output.
@@ -334,16 +249,12 @@ int Cambridge::closeRecorder()
       wait_ms(100);
       sendCommand("baud 6");
       wait_ms(50);
-      cfsetospeed(&newTermEnv, B4800);
-      cfsetispeed(&newTermEnv, B4800);
-      tcsetattr(portID, TCSANOW, &newTermEnv);
+      _serial.setSpeed(B4800);
       wait_ms(50);
       sendCommand("pnp");
     }
 
-    tcsetattr(portID, TCSANOW, &oldTermEnv);
-    close(portID);
-    portID = -1;
+    _serial.close();
     _isConnected = false;
     return FR_OK;
   }
@@ -864,7 +775,7 @@ QString Cambridge::lon2cai(int lon)
 int Cambridge::wb(unsigned char c)
 {
   // qDebug ("wb (%x)", c);
-  if (write(portID, &c, 1) != 1) {
+  if (!_serial.writeByte(c)) {
     return -1;
   }
   return 1;
@@ -878,7 +789,7 @@ void Cambridge::wait_ms(const int t)
 unsigned char *Cambridge::readData(unsigned char *bufP, int count)
 {
   int rc;
-  switch (rc = read(portID, bufP, count)) {
+  switch (rc = _serial.read(bufP, count, READ_TIMEOUT)) {
   case -1:
     qWarning("readData(): ERROR");
     break;
@@ -910,10 +821,9 @@ int Cambridge::calcChecksum16(unsigned char *buf, int count)
 
 int Cambridge::sendCommand(QString cmd)
 {
-  // flush the buffer and send the command
-  tcflush(portID, TCIOFLUSH);
-  ssize_t ret = write(portID, cmd.toLatin1().data(), cmd.length());
-  wb('\r');
+  // flush the buffer and send the command together with the line end
+  _serial.flush();
+  int ret = _serial.write(cmd.toLatin1() + '\r');
 
   if( ret == -1 )
     {
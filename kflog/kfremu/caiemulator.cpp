@@ -0,0 +1,256 @@
+/***********************************************************************
+**
+**   caiemulator.cpp
+**
+**   This file is part of KFLog.
+**
+************************************************************************
+**
+**   Copyright (c):  2026 by agent <agent@local>
+**
+**   This file is distributed under the terms of the General Public
+**   License. See the file COPYING for more information.
+**
+***********************************************************************/
+
+#include <QtCore>
+
+#include "caiemulator.h"
+
+// Ctrl-C switches the CAI into the command mode, see kfrcai/cambridge.cpp
+#define STX 0x03
+
+// Size of a flight data block
+#define BYTES_PER_BLOCK 512
+
+// Flights of a directory block and the size of an entry
+#define DIR_FLIGHTS 8
+#define DIR_ENTRY   36
+
+#define DIR_COMMAND    196
+#define FLIGHT_COMMAND 64
+
+#define UPLOAD_PROMPT "\r\n\nup>"
+
+CaiEmulator::CaiEmulator( QObject *parent ) :
+  RecorderEmulator( parent ),
+  m_upload(false),
+  m_flight(-1),
+  m_offset(0)
+{
+}
+
+CaiEmulator::~CaiEmulator()
+{
+}
+
+QString CaiEmulator::verify( const int flight, const QString& fileName ) const
+{
+  QFile file( fileName );
+
+  if( ! file.open( QIODevice::ReadOnly ) )
+    {
+      return "cannot open file";
+    }
+
+  const QByteArray& expected = m_flights.at(flight).data;
+  QByteArray data = file.readAll();
+
+  for( int i = 0; i < qMin( data.size(), expected.size() ); i++ )
+    {
+      if( data.at(i) != expected.at(i) )
+        {
+          return QString( "byte %1 differs" ).arg( i );
+        }
+    }
+
+  if( data.size() != expected.size() )
+    {
+      return QString( "size is %1 instead of %2" ).arg( data.size() ).arg( expected.size() );
+    }
+
+  return QString();
+}
+
+void CaiEmulator::received( const unsigned char byte )
+{
+  if( byte == STX )
+    {
+      // back to the command mode
+      discardOutput();
+      m_line.clear();
+      m_upload = false;
+      return;
+    }
+
+  if( byte != '\r' )
+    {
+      m_line.append( (char) byte );
+      return;
+    }
+
+  QByteArray cmd = m_line;
+  m_line.clear();
+
+  // The plugin flushes its input before every command.
+  discardOutput();
+
+  __command( cmd );
+}
+
+void CaiEmulator::__command( const QByteArray& cmd )
+{
+  if( ! m_upload )
+    {
+      command( cmd );
+
+      // The plugin sets the new speed of the port itself, so the baud
+      // command and the NMEA output of pnp need no action.
+      if( cmd == "upload" )
+        {
+          m_upload = true;
+        }
+
+      return;
+    }
+
+  if( ! cmd.startsWith( "b " ) )
+    {
+      // Configuration and waypoints are not emulated.
+      command( cmd );
+      __reply( cmd, QByteArray(), 0 );
+      return;
+    }
+
+  QByteArray arg = cmd.mid( 2 );
+
+  if( arg == "n" )
+    {
+      // next block of the flight
+      command( cmd + " " + QByteArray::number( m_offset ) );
+
+      QByteArray block;
+
+      if( m_flight >= 0 )
+        {
+          block = m_flights.at(m_flight).data.mid( m_offset, BYTES_PER_BLOCK );
+          m_offset += block.size();
+        }
+
+      QByteArray data;
+      data.append( (char) (block.size() >> 8) );
+      data.append( (char) (block.size() & 0xff) );
+      data.append( block );
+
+      // The number of valid bytes is not protected by the plugin against
+      // a wrong checksum, a corrupted value would overrun its buffer.
+      __reply( cmd, data, 2 );
+      return;
+    }
+
+  command( cmd );
+
+  if( arg == "s" )
+    {
+      // The emulated flights are not signed.
+      __reply( cmd, QByteArray( 2, '\0' ), 2 );
+      return;
+    }
+
+  int number = arg.toInt();
+
+  if( number >= DIR_COMMAND )
+    {
+      const int first = (number - DIR_COMMAND) * DIR_FLIGHTS;
+
+      QByteArray data( 1 + DIR_FLIGHTS * DIR_ENTRY, '\0' );
+
+      data[0] = m_flights.size();
+
+      for( int i = 0; i < DIR_FLIGHTS && first + i < m_flights.size(); i++ )
+        {
+          const CannedFlight& flight = m_flights.at(first + i);
+          const QDate& date = flight.date;
+          const int pos = 1 + i * DIR_ENTRY;
+          const int start = flight.startTime();
+          const int stop = flight.stopTime();
+
+          // Flights over midnight end on the next day.
+          const QDate stopDate = stop < start ? date.addDays( 1 ) : date;
+
+          data[pos]      = date.year() - 2000;
+          data[pos + 1]  = date.month();
+          data[pos + 2]  = date.day();
+          data[pos + 3]  = start / 3600;
+          data[pos + 4]  = (start / 60) % 60;
+          data[pos + 5]  = start % 60;
+          data[pos + 6]  = stopDate.year() - 2000;
+          data[pos + 7]  = stopDate.month();
+          data[pos + 8]  = stopDate.day();
+          data[pos + 9]  = stop / 3600;
+          data[pos + 10] = (stop / 60) % 60;
+          data[pos + 11] = stop % 60;
+
+          data.replace( pos + 12, qMin( 23, flight.pilot.size() ), flight.pilot.left( 23 ) );
+        }
+
+      __reply( cmd, data, data.size() );
+      return;
+    }
+
+  if( number >= FLIGHT_COMMAND && number - FLIGHT_COMMAND < m_flights.size() )
+    {
+      m_flight = number - FLIGHT_COMMAND;
+      m_offset = 0;
+
+      QByteArray data( "Y" );
+      data.append( (char) (BYTES_PER_BLOCK >> 8) );
+      data.append( (char) (BYTES_PER_BLOCK & 0xff) );
+
+      __reply( cmd, data, data.size() );
+      return;
+    }
+
+  __reply( cmd, QByteArray( "N" ), 1 );
+}
+
+void CaiEmulator::__reply( const QByteArray& cmd, const QByteArray& data,
+                           const int protectedBytes )
+{
+  const QByteArray prompt( UPLOAD_PROMPT );
+
+  // length of the reply after the echo including the header and the prompt
+  const int length = 5 + data.size() + prompt.size();
+
+  unsigned char cmdChecksum = 0;
+
+  for( int i = 0; i < cmd.size(); i++ )
+    {
+      cmdChecksum ^= (unsigned char) cmd.at(i);
+    }
+
+  int replyChecksum = 0;
+
+  for( int i = 0; i < data.size(); i++ )
+    {
+      replyChecksum = (replyChecksum + (unsigned char) data.at(i)) & 0xffff;
+    }
+
+  for( int i = 0; i < prompt.size(); i++ )
+    {
+      replyChecksum = (replyChecksum + (unsigned char) prompt.at(i)) & 0xffff;
+    }
+
+  QByteArray header( cmd );
+
+  header.append( (char) (length >> 8) );
+  header.append( (char) (length & 0xff) );
+  header.append( (char) cmdChecksum );
+  header.append( (char) (replyChecksum >> 8) );
+  header.append( (char) (replyChecksum & 0xff) );
+  header.append( data.left( protectedBytes ) );
+
+  send( header );
+  send( data.mid( protectedBytes ), true );
+  send( prompt );
+}
@@ -0,0 +1,88 @@
+/***********************************************************************
+**
+**   caiemulator.h
+**
+**   This file is part of KFLog.
+**
+************************************************************************
+**
+**   Copyright (c):  2026 by agent <agent@local>
+**
+**   This file is distributed under the terms of the General Public
+**   License. See the file COPYING for more information.
+**
+***********************************************************************/
+
+/**
+ * \class CaiEmulator
+ *
+ * \author agent
+ *
+ * \brief Emulates a Cambridge CAI 302 for the kfrcai plugin.
+ *
+ * The upload mode commands of the flight directory and the flight transfer
+ * are answered. The IGC files are transfered unchanged in blocks.
+ *
+ * \date 2026
+ *
+ * \version 1.0
+ */
+
+#ifndef CAI_EMULATOR_H
+#define CAI_EMULATOR_H
+
+#include <QByteArray>
+
+#include "recorderemulator.h"
+
+class CaiEmulator : public RecorderEmulator
+{
+  Q_OBJECT
+
+ private:
+
+  Q_DISABLE_COPY ( CaiEmulator )
+
+ public:
+
+  CaiEmulator( QObject *parent=0 );
+
+  virtual ~CaiEmulator();
+
+  virtual QString libName() const
+  {
+    return "libkfrcai.so";
+  };
+
+  virtual QString verify( const int flight, const QString& fileName ) const;
+
+ protected:
+
+  virtual void received( const unsigned char byte );
+
+ private:
+
+  /**
+   * Answers a command line.
+   */
+  void __command( const QByteArray& cmd );
+
+  /**
+   * Sends the reply of an upload mode command. Errors are injected only
+   * into the data after the first protected bytes.
+   */
+  void __reply( const QByteArray& cmd, const QByteArray& data,
+                const int protectedBytes );
+
+  /** Received part of the command line */
+  QByteArray m_line;
+
+  /** True in upload mode */
+  bool m_upload;
+
+  /** Flight selected for the transfer and the position in the file */
+  int m_flight;
+  int m_offset;
+};
+
+#endif
@@ -0,0 +1,351 @@
+/***********************************************************************
+**
+**   filseremulator.cpp
+**
+**   This file is part of KFLog.
+**
+************************************************************************
+**
+**   Copyright (c):  2026 by agent <agent@local>
+**
+**   This file is distributed under the terms of the General Public
+**   License. See the file COPYING for more information.
+**
+***********************************************************************/
+
+#include <QtCore>
+
+#include "filseremulator.h"
+
+// Protocol bytes of the LX recorders, see kfrfil/filser.cpp
+#define STX  0x02
+#define ACK  0x06
+#define NAK  0x15
+#define SYN  0x16
+
+#define CMD_K ('K' | 0x80)
+#define CMD_L ('L' | 0x80)
+#define CMD_M ('M' | 0x80)
+#define CMD_N ('N' | 0x80)
+#define CMD_Q ('Q' | 0x80)
+#define CMD_F ('f' | 0x80)
+
+// Length of a flight table record including the CRC
+#define FLIGHT_INDEX_WIDTH 0x60
+
+// Number of memory sections of a flight
+#define SECTIONS 16
+
+// Minimum and maximum size of a memory section
+#define MIN_SECTION 0x1000
+#define MAX_SECTION 0xffff
+
+// Record types of the fil format
+#define MAX_LSTRING 63
+#define FIL_END     0x40
+#define FIL_START   0x80
+
+FilserEmulator::FilserEmulator( QObject *parent ) :
+  RecorderEmulator( parent ),
+  m_state(Idle),
+  m_start(0),
+  m_end(0)
+{
+}
+
+FilserEmulator::~FilserEmulator()
+{
+}
+
+QList<QByteArray> FilserEmulator::__storedLines( const int flight ) const
+{
+  QList<QByteArray> stored;
+
+  const QList<QByteArray>& lines = m_flights.at(flight).lines;
+
+  for( int i = 0; i < lines.size(); i++ )
+    {
+      // A string record cannot be empty.
+      if( ! lines.at(i).isEmpty() )
+        {
+          stored.append( lines.at(i).left( MAX_LSTRING ) );
+        }
+    }
+
+  return stored;
+}
+
+void FilserEmulator::setFlights( const QList<CannedFlight>& flights )
+{
+  RecorderEmulator::setFlights( flights );
+
+  m_memory.clear();
+  m_flightTable.clear();
+
+  for( int i = 0; i < m_flights.size(); i++ )
+    {
+      const CannedFlight& flight = m_flights.at(i);
+
+      const int start = m_memory.size();
+
+      m_memory.append( (char) FIL_START );
+      m_memory.append( "STReRAZ", 8 );
+      m_memory.append( (char) (i + 1) );
+
+      QList<QByteArray> lines = __storedLines( i );
+
+      for( int j = 0; j < lines.size(); j++ )
+        {
+          m_memory.append( (char) lines.at(j).size() );
+          m_memory.append( lines.at(j) );
+        }
+
+      m_memory.append( (char) FIL_END );
+
+      const int end = m_memory.size();
+
+      QByteArray record( FLIGHT_INDEX_WIDTH - 1, '\0' );
+
+      record[0] = 1;
+      record[1] = (start >> 8) & 0xff;
+      record[2] = start & 0xff;
+      record[4] = (start >> 16) & 0xff;
+      record[5] = (end >> 8) & 0xff;
+      record[6] = end & 0xff;
+      record[8] = (end >> 16) & 0xff;
+
+      QByteArray date = flight.date.toString( "dd.MM.yy" ).toLatin1();
+      QByteArray startTime = QTime( 0, 0 ).addSecs( flight.startTime() )
+                             .toString( "HH:mm:ss" ).toLatin1();
+      QByteArray stopTime  = QTime( 0, 0 ).addSecs( flight.stopTime() )
+                             .toString( "HH:mm:ss" ).toLatin1();
+
+      record.replace( 9, 8, date );
+      record.replace( 18, 8, startTime );
+      record.replace( 27, 8, stopTime );
+      record.replace( 40, qMin( 50, flight.pilot.size() ), flight.pilot.left( 50 ) );
+
+      // serial number and flight of the day
+      record[91] = 0x12;
+      record[92] = 0x34;
+      record[94] = (i + 1) % 36;
+
+      record.append( (char) __crc( record ) );
+      m_flightTable.append( record );
+    }
+
+  // The end of the table is a record with a zero index byte.
+  QByteArray record( FLIGHT_INDEX_WIDTH - 1, '\0' );
+  record.append( (char) __crc( record ) );
+  m_flightTable.append( record );
+}
+
+QString FilserEmulator::verify( const int flight, const QString& fileName ) const
+{
+  QFile file( fileName );
+
+  if( ! file.open( QIODevice::ReadOnly ) )
+    {
+      return "cannot open file";
+    }
+
+  QList<QByteArray> expected = __storedLines( flight );
+  QList<QByteArray> lines = file.readAll().split( '\n' );
+
+  // The last line end leaves an empty part.
+  if( ! lines.isEmpty() && lines.last().isEmpty() )
+    {
+      lines.removeLast();
+    }
+
+  for( int i = 0; i < expected.size(); i++ )
+    {
+      if( i >= lines.size() )
+        {
+          return QString( "file ends at line %1" ).arg( i + 1 );
+        }
+
+      if( lines.at(i) != expected.at(i) + "\r" )
+        {
+          return QString( "line %1 differs" ).arg( i + 1 );
+        }
+    }
+
+  if( lines.size() != expected.size() )
+    {
+      return QString( "%1 extra lines" ).arg( lines.size() - expected.size() );
+    }
+
+  return QString();
+}
+
+void FilserEmulator::received( const unsigned char byte )
+{
+  switch( m_state )
+    {
+      case Idle:
+
+        if( byte == SYN )
+          {
+            // Wake up or keep alive, the plugin has flushed its input.
+            discardOutput();
+            sendByte( ACK );
+          }
+        else if( byte == STX )
+          {
+            m_state = Command;
+          }
+
+        break;
+
+      case Command:
+
+        m_state = Idle;
+        __command( byte );
+        break;
+
+      case Address:
+
+        m_address.append( (char) byte );
+
+        if( m_address.size() < 7 )
+          {
+            break;
+          }
+
+        m_state = Idle;
+
+        if( __crc( m_address.left( 6 ) ) != (unsigned char) m_address.at(6) )
+          {
+            sendByte( NAK );
+            break;
+          }
+
+        m_start = (unsigned char) m_address.at(0) |
+                  ((unsigned char) m_address.at(1) << 8) |
+                  ((unsigned char) m_address.at(2) << 16);
+
+        m_end   = (unsigned char) m_address.at(3) |
+                  ((unsigned char) m_address.at(4) << 8) |
+                  ((unsigned char) m_address.at(5) << 16);
+
+        if( m_start > m_end || m_end > m_memory.size() )
+          {
+            sendByte( NAK );
+            break;
+          }
+
+        sendByte( ACK );
+        break;
+    }
+}
+
+void FilserEmulator::__command( const unsigned char cmd )
+{
+  // The plugin flushes its input before every command.
+  discardOutput();
+
+  command( QByteArray( 1, (char) cmd ) );
+
+  if( cmd == CMD_Q )
+    {
+      // memory setting
+      const char setting[] = { 0x00, 0x00, 0x06, (char) 0x80, 0x00, 0x0b };
+
+      __sendBlock( QByteArray( setting, sizeof(setting) ) );
+    }
+  else if( cmd == CMD_M )
+    {
+      send( m_flightTable );
+    }
+  else if( cmd == CMD_N )
+    {
+      m_address.clear();
+      m_state = Address;
+    }
+  else if( cmd == CMD_L )
+    {
+      QList<int> sections = __sections();
+      QByteArray table( 2 * SECTIONS, '\0' );
+
+      for( int i = 0; i < sections.size(); i++ )
+        {
+          table[2 * i]     = (sections.at(i) >> 8) & 0xff;
+          table[2 * i + 1] = sections.at(i) & 0xff;
+        }
+
+      __sendBlock( table, true );
+    }
+  else if( cmd >= CMD_F && cmd < CMD_F + SECTIONS )
+    {
+      QList<int> sections = __sections();
+      int index = cmd - CMD_F;
+
+      if( index >= sections.size() )
+        {
+          sendByte( NAK );
+          return;
+        }
+
+      int start = m_start;
+
+      for( int i = 0; i < index; i++ )
+        {
+          start += sections.at(i);
+        }
+
+      __sendBlock( m_memory.mid( start, sections.at(index) ), true );
+    }
+  else
+    {
+      // Basic data, waypoints and tasks are not emulated.
+      sendByte( NAK );
+    }
+}
+
+QList<int> FilserEmulator::__sections() const
+{
+  QList<int> sections;
+
+  int size = m_end - m_start;
+  int sectionSize = qMin( MAX_SECTION,
+                          qMax( MIN_SECTION, (size + SECTIONS - 1) / SECTIONS ) );
+
+  while( size > 0 && sections.size() < SECTIONS )
+    {
+      sections.append( qMin( size, sectionSize ) );
+      size -= sections.last();
+    }
+
+  return sections;
+}
+
+void FilserEmulator::__sendBlock( const QByteArray& data, const bool errors )
+{
+  send( data, errors );
+  sendByte( __crc( data ), errors );
+}
+
+unsigned char FilserEmulator::__crc( const QByteArray& data )
+{
+  unsigned char crc = 0xff;
+
+  for( int i = 0; i < data.size(); i++ )
+    {
+      unsigned char d = data.at(i);
+
+      for( int count = 8; --count >= 0; d <<= 1 )
+        {
+          unsigned char tmp = crc ^ d;
+
+          crc <<= 1;
+
+          if( tmp & 0x80 )
+            {
+              crc ^= 0x69;
+            }
+        }
+    }
+
+  return crc;
+}
@@ -0,0 +1,116 @@
+/***********************************************************************
+**
+**   filseremulator.h
+**
+**   This file is part of KFLog.
+**
+************************************************************************
+**
+**   Copyright (c):  2026 by agent <agent@local>
+**
+**   This file is distributed under the terms of the General Public
+**   License. See the file COPYING for more information.
+**
+***********************************************************************/
+
+/**
+ * \class FilserEmulator
+ *
+ * \author agent
+ *
+ * \brief Emulates a Filser LX recorder for the kfrfil plugin.
+ *
+ * The flights are stored in the emulated memory in the fil format. Every
+ * line of the IGC file is stored as a string record, so the plugin converts
+ * the memory back into the lines of the IGC file. Lines longer than a
+ * string record are truncated.
+ *
+ * \date 2026
+ *
+ * \version 1.0
+ */
+
+#ifndef FILSER_EMULATOR_H
+#define FILSER_EMULATOR_H
+
+#include <QByteArray>
+#include <QList>
+
+#include "recorderemulator.h"
+
+class FilserEmulator : public RecorderEmulator
+{
+  Q_OBJECT
+
+ private:
+
+  Q_DISABLE_COPY ( FilserEmulator )
+
+ public:
+
+  FilserEmulator( QObject *parent=0 );
+
+  virtual ~FilserEmulator();
+
+  virtual QString libName() const
+  {
+    return "libkfrfil.so";
+  };
+
+  virtual void setFlights( const QList<CannedFlight>& flights );
+
+  virtual QString verify( const int flight, const QString& fileName ) const;
+
+ protected:
+
+  virtual void received( const unsigned char byte );
+
+ private:
+
+  /** States of the command parser */
+  enum State
+  {
+    Idle,
+    Command,
+    Address
+  };
+
+  /**
+   * \return The lines of a flight as stored in the memory.
+   */
+  QList<QByteArray> __storedLines( const int flight ) const;
+
+  /**
+   * Answers a command byte, which was sent after a STX.
+   */
+  void __command( const unsigned char cmd );
+
+  /**
+   * Appends the CRC and sends the data.
+   */
+  void __sendBlock( const QByteArray& data, const bool errors=false );
+
+  /**
+   * \return The sizes of the memory sections of the selected range.
+   */
+  QList<int> __sections() const;
+
+  static unsigned char __crc( const QByteArray& data );
+
+  State m_state;
+
+  /** Memory of the recorder */
+  QByteArray m_memory;
+
+  /** Flight table of the M command */
+  QByteArray m_flightTable;
+
+  /** Received address bytes of the N command */
+  QByteArray m_address;
+
+  /** Memory range selected by the N command */
+  int m_start;
+  int m_end;
+};
+
+#endif
@@ -0,0 +1,40 @@
+# KFLog qmake project file
+
+# Qt5 needs the QtWidgets library
+greaterThan(QT_MAJOR_VERSION, 4) {
+QT += widgets
+DEFINES += QT_5
+}
+
+TEMPLATE = app
+
+CONFIG += console
+
+INCLUDEPATH += ../
+
+SOURCES =   caiemulator.cpp \
+            filseremulator.cpp \
+            main.cpp \
+            recorderbenchmark.cpp \
+            recorderemulator.cpp \
+            volksloggeremulator.cpp \
+            ../flightrecorderpluginbase.cpp \
+            ../serialtransport.cpp
+
+HEADERS =   caiemulator.h \
+            filseremulator.h \
+            recorderbenchmark.h \
+            recorderemulator.h \
+            volksloggeremulator.h \
+            ../flightrecorderpluginbase.h \
+            ../serialtransport.h
+
+# The plugins take the base classes from the binary.
+QMAKE_LFLAGS += -rdynamic
+
+LIBS += -ldl
+
+OBJECTS_DIR = .obj
+MOC_DIR = .obj
+
+DESTDIR = ../../release/bin
@@ -0,0 +1,151 @@
+/***********************************************************************
+**
+**   main.cpp
+**
+**   This file is part of KFLog.
+**
+************************************************************************
+**
+**   Copyright (c):  2026 by agent <agent@local>
+**
+**   This file is distributed under the terms of the General Public
+**   License. See the file COPYING for more information.
+**
+***********************************************************************/
+
+/**
+ * Benchmark of the flight transfer of the recorder plugins. A plugin is
+ * connected to an emulated recorder by a pseudo terminal, see README.kfremu.
+ */
+
+#include <QtCore>
+
+#include "recorderbenchmark.h"
+#include "serialtransport.h"
+
+static void usage()
+{
+  QTextStream err( stderr );
+
+  err << "Usage: kfremu --recorder fil|cai|gcs [options] <igc files>" << endl
+      << endl
+      << "  --lib <path>          plugin library, default is the installed one" << endl
+      << "  --baud <n>            port speed set by the plugin, default 19200" << endl
+      << "  --rate <n>            fixed rate in bytes/s, default is the port speed" << endl
+      << "  --error-rate <p>      probability of a corrupted byte, default 0" << endl
+      << "  --stall-rate <p>      probability of a stall after a byte, default 0" << endl
+      << "  --stall-time <ms>     duration of a stall, default 500" << endl
+      << "  --seed <n>            start value of the random numbers, default 1" << endl
+      << "  --retries <n>         retries of a failed download, default 2" << endl
+      << "  --signed              download signed flights" << endl
+      << "  --output <dir>        directory of the downloaded files" << endl;
+}
+
+/**
+ * Parses the command line into the options.
+ *
+ * \return True, if the command line is valid.
+ */
+static bool parseArguments( const QStringList& args,
+                            RecorderBenchmark::Options& options )
+{
+  options.output = QDir::tempPath() + "/kfremu";
+
+  for( int i = 1; i < args.size(); i++ )
+    {
+      const QString& arg = args.at(i);
+
+      if( arg == "--signed" )
+        {
+          options.signedFlights = true;
+          continue;
+        }
+
+      if( ! arg.startsWith( "--" ) )
+        {
+          options.files.append( arg );
+          continue;
+        }
+
+      if( i + 1 >= args.size() )
+        {
+          return false;
+        }
+
+      const QString value = args.at(++i);
+
+      bool ok = true;
+
+      if( arg == "--recorder" )
+        {
+          options.recorder = value;
+        }
+      else if( arg == "--lib" )
+        {
+          options.lib = value;
+        }
+      else if( arg == "--baud" )
+        {
+          options.baud = value.toInt( &ok );
+        }
+      else if( arg == "--rate" )
+        {
+          options.rate = value.toInt( &ok );
+        }
+      else if( arg == "--error-rate" )
+        {
+          options.errorRate = value.toDouble( &ok );
+        }
+      else if( arg == "--stall-rate" )
+        {
+          options.stallRate = value.toDouble( &ok );
+        }
+      else if( arg == "--stall-time" )
+        {
+          options.stallTime = value.toInt( &ok );
+        }
+      else if( arg == "--seed" )
+        {
+          options.seed = value.toUInt( &ok );
+        }
+      else if( arg == "--retries" )
+        {
+          options.retries = value.toInt( &ok );
+        }
+      else if( arg == "--output" )
+        {
+          options.output = value;
+        }
+      else
+        {
+          ok = false;
+        }
+
+      if( ! ok )
+        {
+          return false;
+        }
+    }
+
+  return ! options.recorder.isEmpty() && ! options.files.isEmpty();
+}
+
+int main( int argc, char *argv[] )
+{
+  QCoreApplication app( argc, argv );
+
+  RecorderBenchmark::Options options;
+
+  if( ! parseArguments( app.arguments(), options ) )
+    {
+      usage();
+      return 2;
+    }
+
+  // The port of the plugin reports its side of the transfer at closing.
+  SerialTransport::setReportStatistics( true );
+
+  RecorderBenchmark benchmark( options );
+
+  return benchmark.run();
+}
@@ -0,0 +1,332 @@
+/***********************************************************************
+**
+**   recorderbenchmark.cpp
+**
+**   This file is part of KFLog.
+**
+************************************************************************
+**
+**   Copyright (c):  2026 by agent <agent@local>
+**
+**   This file is distributed under the terms of the General Public
+**   License. See the file COPYING for more information.
+**
+***********************************************************************/
+
+#include <dlfcn.h>
+
+#include <QtCore>
+
+#include "caiemulator.h"
+#include "filseremulator.h"
+#include "flightrecorderpluginbase.h"
+#include "frstructs.h"
+#include "recorderbenchmark.h"
+#include "volksloggeremulator.h"
+
+RecorderBenchmark::RecorderBenchmark( const Options& options, QObject *parent ) :
+  QObject( parent ),
+  m_options(options),
+  m_emulator(0),
+  m_libHandle(0),
+  m_recorder(0),
+  m_breakTransfer(0),
+  m_dirTime(0)
+{
+}
+
+RecorderBenchmark::~RecorderBenchmark()
+{
+  __unloadPlugin();
+  delete m_emulator;
+}
+
+int RecorderBenchmark::run()
+{
+  QTextStream out( stdout );
+
+  QList<CannedFlight> flights;
+
+  for( int i = 0; i < m_options.files.size(); i++ )
+    {
+      CannedFlight flight;
+
+      if( ! flight.load( m_options.files.at(i) ) )
+        {
+          return 1;
+        }
+
+      flights.append( flight );
+    }
+
+  if( ! QDir().mkpath( m_options.output ) )
+    {
+      qWarning() << "RecorderBenchmark: Cannot create" << m_options.output;
+      return 1;
+    }
+
+  if( ! __createEmulator() || ! __loadPlugin() )
+    {
+      return 1;
+    }
+
+  m_emulator->setFlights( flights );
+  m_emulator->setRate( m_options.rate );
+  m_emulator->setErrors( m_options.errorRate, m_options.stallRate,
+                         m_options.stallTime, m_options.seed );
+  m_emulator->start();
+
+  out << "Recorder " << m_options.recorder << " at " << m_emulator->portName()
+      << ", " << m_options.baud << " baud, rate "
+      << (m_options.rate > 0 ? QString::number( m_options.rate ) + " bytes/s"
+                             : QString( "of the port speed" ) )
+      << endl
+      << "Error rate " << m_options.errorRate
+      << ", stall rate " << m_options.stallRate
+      << ", stall time " << m_options.stallTime << " ms"
+      << ", seed " << m_options.seed << endl;
+
+  bool ok = false;
+
+  m_timer.start();
+
+  if( m_recorder->openRecorder( m_emulator->portName(), m_options.baud ) != FR_OK )
+    {
+      out << "Cannot open the recorder: " << m_recorder->lastError() << endl;
+    }
+  else
+    {
+      QList<FRDirEntry *> dirList;
+
+      int rc = m_recorder->getFlightDir( &dirList );
+
+      m_dirTime = m_timer.elapsed();
+      m_dirStatistics = m_emulator->statistics();
+
+      out << "Flight directory: " << dirList.size() << " flights in "
+          << m_dirTime << " ms" << endl;
+
+      if( rc != FR_OK || dirList.size() != flights.size() )
+        {
+          out << "Wrong flight directory: " << m_recorder->lastError() << endl;
+        }
+      else
+        {
+          __download( dirList.size() );
+          ok = __report();
+        }
+
+      qDeleteAll( dirList );
+
+      m_recorder->closeRecorder();
+    }
+
+  m_emulator->stop();
+  __unloadPlugin();
+
+  return ok ? 0 : 1;
+}
+
+bool RecorderBenchmark::__createEmulator()
+{
+  if( m_options.recorder == "fil" )
+    {
+      m_emulator = new FilserEmulator;
+    }
+  else if( m_options.recorder == "cai" )
+    {
+      m_emulator = new CaiEmulator;
+    }
+  else if( m_options.recorder == "gcs" )
+    {
+      m_emulator = new VolksloggerEmulator;
+    }
+  else
+    {
+      qWarning() << "RecorderBenchmark: Unknown recorder" << m_options.recorder;
+      return false;
+    }
+
+  return m_emulator->openPty();
+}
+
+bool RecorderBenchmark::__loadPlugin()
+{
+  QString lib = m_options.lib;
+
+  if( lib.isEmpty() )
+    {
+      lib = QCoreApplication::applicationDirPath() + "/../lib/" + m_emulator->libName();
+    }
+
+  // The plugins use the base classes of the KFLog binary. The functions of
+  // the map and task classes are not linked into the harness, they are
+  // not called during the flight transfer. So they are resolved lazily.
+  m_libHandle = dlopen( lib.toLocal8Bit().constData(), RTLD_LAZY );
+
+  if( m_libHandle == 0 )
+    {
+      qWarning() << "RecorderBenchmark: Cannot open" << lib << dlerror();
+      return false;
+    }
+
+  FlightRecorderPluginBase* (*getRecorder)();
+
+  getRecorder = (FlightRecorderPluginBase* (*) ()) dlsym( m_libHandle, "getRecorder" );
+
+  if( getRecorder == 0 || (m_recorder = getRecorder()) == 0 )
+    {
+      qWarning() << "RecorderBenchmark: No recorder object in" << lib;
+      return false;
+    }
+
+  m_breakTransfer = (int *) dlsym( m_libHandle, "breakTransfer" );
+
+  return true;
+}
+
+void RecorderBenchmark::__unloadPlugin()
+{
+  delete m_recorder;
+  m_recorder = 0;
+
+  if( m_libHandle != 0 )
+    {
+      dlclose( m_libHandle );
+      m_libHandle = 0;
+      m_breakTransfer = 0;
+    }
+}
+
+void RecorderBenchmark::__download( const int flights )
+{
+  m_results.clear();
+
+  m_emulator->setErrorsEnabled( true );
+
+  for( int i = 0; i < flights; i++ )
+    {
+      Result result;
+
+      result.fileName = QString( "%1/%2-%3.igc" )
+                        .arg( m_options.output )
+                        .arg( m_options.recorder )
+                        .arg( i + 1, 2, 10, QChar('0') );
+
+      result.start = m_emulator->statistics();
+      result.time  = m_timer.elapsed();
+
+      for( int retry = 0; retry <= m_options.retries; retry++ )
+        {
+          if( retry > 0 )
+            {
+              result.retries++;
+            }
+
+          if( m_breakTransfer != 0 )
+            {
+              *m_breakTransfer = 0;
+            }
+
+          int ret = m_recorder->downloadFlight( i, m_options.signedFlights,
+                                                result.fileName );
+
+          if( ret >= FR_OK )
+            {
+              result.ok = true;
+              break;
+            }
+
+          result.error = m_recorder->lastError();
+
+          if( ret == FR_NOTSUPPORTED )
+            {
+              break;
+            }
+        }
+
+      result.time  = m_timer.elapsed() - result.time;
+      result.end   = m_emulator->statistics();
+      result.bytes = QFileInfo( result.fileName ).size();
+
+      m_results.append( result );
+    }
+
+  m_emulator->setErrorsEnabled( false );
+}
+
+bool RecorderBenchmark::__report()
+{
+  QTextStream out( stdout );
+
+  bool allOk = true;
+
+  qint64 time = 0;
+  qint64 bytes = 0;
+  qint64 sent = 0;
+  int retries = 0;
+  int corrupted = 0;
+  int stalls = 0;
+
+  out << endl
+      << qSetFieldWidth( 5 ) << "Nr"
+      << qSetFieldWidth( 10 ) << "Bytes" << "Sent" << "Time/ms"
+      << "Bytes/s" << "Sent/s" << "Retries" << "Corrupt" << "Stalls"
+      << qSetFieldWidth( 0 ) << "  Result" << endl;
+
+  for( int i = 0; i < m_results.size(); i++ )
+    {
+      const Result& result = m_results.at(i);
+
+      QString check;
+
+      if( ! result.ok )
+        {
+          check = "failed: " + result.error.simplified();
+        }
+      else
+        {
+          check = m_emulator->verify( i, result.fileName );
+          check = check.isEmpty() ? QString( "ok" ) : "wrong: " + check;
+        }
+
+      if( check != "ok" )
+        {
+          allOk = false;
+        }
+
+      const qint64 resultSent = result.end.bytesSent - result.start.bytesSent;
+      const int resultCorrupted = result.end.corruptedBytes - result.start.corruptedBytes;
+      const int resultStalls = result.end.stalls - result.start.stalls;
+      const qint64 ms = qMax( result.time, (qint64) 1 );
+
+      out << qSetFieldWidth( 5 ) << i + 1
+          << qSetFieldWidth( 10 ) << result.bytes << resultSent << result.time
+          << result.bytes * 1000 / ms << resultSent * 1000 / ms
+          << result.retries << resultCorrupted << resultStalls
+          << qSetFieldWidth( 0 ) << "  " << check << endl;
+
+      time      += result.time;
+      bytes     += result.bytes;
+      sent      += resultSent;
+      retries   += result.retries;
+      corrupted += resultCorrupted;
+      stalls    += resultStalls;
+    }
+
+  const qint64 ms = qMax( time, (qint64) 1 );
+  RecorderEmulator::Statistics statistics = m_emulator->statistics();
+
+  out << qSetFieldWidth( 5 ) << "All"
+      << qSetFieldWidth( 10 ) << bytes << sent << time
+      << bytes * 1000 / ms << sent * 1000 / ms
+      << retries << corrupted << stalls
+      << qSetFieldWidth( 0 ) << endl << endl
+      << "Commands " << statistics.commands
+      << ", repeated " << statistics.repeatedCommands
+      << ", bytes received " << statistics.bytesReceived
+      << ", bytes sent " << statistics.bytesSent
+      << " (directory " << m_dirStatistics.bytesSent << ")" << endl;
+
+  return allOk;
+}
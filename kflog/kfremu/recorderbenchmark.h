@@ -0,0 +1,178 @@
+/***********************************************************************
+**
+**   recorderbenchmark.h
+**
+**   This file is part of KFLog.
+**
+************************************************************************
+**
+**   Copyright (c):  2026 by agent <agent@local>
+**
+**   This file is distributed under the terms of the General Public
+**   License. See the file COPYING for more information.
+**
+***********************************************************************/
+
+/**
+ * \class RecorderBenchmark
+ *
+ * \author agent
+ *
+ * \brief Measures the flight transfer of a recorder plugin.
+ *
+ * The plugin is loaded and connected to a recorder emulator. The flight
+ * directory is read and all flights are downloaded one after the other, a
+ * failed download is repeated. Errors are injected by the emulator during
+ * the downloads only.
+ * The time, the throughput and the retries of every flight are reported
+ * and the downloaded files are checked against the served flights.
+ *
+ * \date 2026
+ *
+ * \version 1.0
+ */
+
+#ifndef RECORDER_BENCHMARK_H
+#define RECORDER_BENCHMARK_H
+
+#include <QElapsedTimer>
+#include <QList>
+#include <QObject>
+#include <QString>
+#include <QStringList>
+
+#include "recorderemulator.h"
+
+class FlightRecorderPluginBase;
+
+class RecorderBenchmark : public QObject
+{
+  Q_OBJECT
+
+ private:
+
+  Q_DISABLE_COPY ( RecorderBenchmark )
+
+ public:
+
+  /** Settings of a benchmark run */
+  class Options
+  {
+   public:
+
+    Options() :
+      baud(19200),
+      rate(0),
+      errorRate(0.0),
+      stallRate(0.0),
+      stallTime(500),
+      seed(1),
+      retries(2),
+      signedFlights(false)
+    {};
+
+    /** Emulated recorder: fil, cai or gcs */
+    QString recorder;
+
+    /** Path of the plugin library, empty for the installed one */
+    QString lib;
+
+    int    baud;
+    int    rate;
+    double errorRate;
+    double stallRate;
+    int    stallTime;
+    uint   seed;
+    int    retries;
+    bool   signedFlights;
+
+    /** Directory of the downloaded files */
+    QString output;
+
+    /** IGC files served as flights */
+    QStringList files;
+  };
+
+  RecorderBenchmark( const Options& options, QObject *parent=0 );
+
+  virtual ~RecorderBenchmark();
+
+  /**
+   * Runs the benchmark and prints the results.
+   *
+   * \return 0, if all flights were downloaded and verified, otherwise 1.
+   */
+  int run();
+
+ private:
+
+  /** Measured values of a flight */
+  class Result
+  {
+   public:
+
+    Result() :
+      ok(false),
+      time(0),
+      bytes(0),
+      retries(0)
+    {};
+
+    QString fileName;
+    bool    ok;
+    QString error;
+    qint64  time;
+    qint64  bytes;
+    int     retries;
+
+    /** Counters of the emulator at the start and at the end */
+    RecorderEmulator::Statistics start;
+    RecorderEmulator::Statistics end;
+  };
+
+  /**
+   * Creates the emulator of the selected recorder.
+   *
+   * \return True in case of success.
+   */
+  bool __createEmulator();
+
+  /**
+   * Loads the plugin library and creates the recorder object.
+   *
+   * \return True in case of success.
+   */
+  bool __loadPlugin();
+
+  void __unloadPlugin();
+
+  /**
+   * Downloads all flights and measures every download.
+   */
+  void __download( const int flights );
+
+  /**
+   * Prints the results and checks the downloaded files.
+   *
+   * \return True, if all flights are correct.
+   */
+  bool __report();
+
+  Options m_options;
+
+  RecorderEmulator*         m_emulator;
+  void*                     m_libHandle;
+  FlightRecorderPluginBase* m_recorder;
+  int*                      m_breakTransfer;
+
+  /** Time and counters of the flight directory */
+  qint64 m_dirTime;
+  RecorderEmulator::Statistics m_dirStatistics;
+
+  /** Results of the flights */
+  QList<Result> m_results;
+
+  QElapsedTimer m_timer;
+};
+
+#endif
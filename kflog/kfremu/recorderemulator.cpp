@@ -0,0 +1,460 @@
+/***********************************************************************
+**
+**   recorderemulator.cpp
+**
+**   This file is part of KFLog.
+**
+************************************************************************
+**
+**   Copyright (c):  2026 by agent <agent@local>
+**
+**   This file is distributed under the terms of the General Public
+**   License. See the file COPYING for more information.
+**
+***********************************************************************/
+
+#include <cctype>
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+
+#include <fcntl.h>
+#include <poll.h>
+#include <termios.h>
+#include <unistd.h>
+
+#include <QtCore>
+
+#include "recorderemulator.h"
+
+// Maximum output in milliseconds, which is written at once after a pause.
+#define BURST_TIME 20
+
+/*---------------------- CannedFlight ----------------------------------------*/
+
+CannedFlight::CannedFlight()
+{
+}
+
+bool CannedFlight::load( const QString& fileName )
+{
+  QFile file( fileName );
+
+  if( ! file.open( QIODevice::ReadOnly ) )
+    {
+      qWarning() << "CannedFlight: Cannot open" << fileName;
+      return false;
+    }
+
+  this->fileName = fileName;
+  data = file.readAll();
+
+  lines.clear();
+  fixes.clear();
+  date = QDate();
+  pilot.clear();
+  gliderID.clear();
+
+  QList<QByteArray> rawLines = data.split( '\n' );
+
+  for( int i = 0; i < rawLines.size(); i++ )
+    {
+      QByteArray line = rawLines.at(i);
+
+      if( line.endsWith( '\r' ) )
+        {
+          line.chop( 1 );
+        }
+
+      if( line.isEmpty() && i == rawLines.size() - 1 )
+        {
+          // no line after the last line end
+          break;
+        }
+
+      lines.append( line );
+
+      if( line.startsWith( "HFDTE" ) )
+        {
+          // HFDTEDDMMYY or HFDTEDATE:DDMMYY,NN
+          QByteArray digits;
+
+          for( int j = 5; j < line.size() && digits.size() < 6; j++ )
+            {
+              if( isdigit( line.at(j) ) )
+                {
+                  digits.append( line.at(j) );
+                }
+            }
+
+          if( digits.size() == 6 )
+            {
+              int year = digits.mid( 4, 2 ).toInt();
+
+              date = QDate( year < 80 ? 2000 + year : 1900 + year,
+                            digits.mid( 2, 2 ).toInt(),
+                            digits.mid( 0, 2 ).toInt() );
+            }
+        }
+      else if( line.startsWith( "HFPLT" ) && line.contains( ':' ) )
+        {
+          pilot = line.mid( line.indexOf( ':' ) + 1 ).trimmed();
+        }
+      else if( line.startsWith( "HFGID" ) && line.contains( ':' ) )
+        {
+          gliderID = line.mid( line.indexOf( ':' ) + 1 ).trimmed();
+        }
+      else if( line.startsWith( 'B' ) && line.size() >= 35 )
+        {
+          // BHHMMSSDDMMmmmNDDDMMmmmEVPPPPPGGGGG
+          Fix fix;
+
+          fix.time = line.mid( 1, 2 ).toInt() * 3600 +
+                     line.mid( 3, 2 ).toInt() * 60 +
+                     line.mid( 5, 2 ).toInt();
+
+          fix.lat = line.mid( 7, 2 ).toInt() * 60000 + line.mid( 9, 5 ).toInt();
+          fix.lon = line.mid( 15, 3 ).toInt() * 60000 + line.mid( 18, 5 ).toInt();
+
+          if( line.at(14) == 'S' )
+            {
+              fix.lat = -fix.lat;
+            }
+
+          if( line.at(23) == 'W' )
+            {
+              fix.lon = -fix.lon;
+            }
+
+          fix.valid    = line.at(24);
+          fix.gpsAlt   = line.mid( 30, 5 ).toInt();
+          fix.position = line.mid( 7, 18 );
+
+          fixes.append( fix );
+        }
+    }
+
+  if( fixes.isEmpty() || ! date.isValid() )
+    {
+      qWarning() << "CannedFlight:" << fileName << "has no date or no fixes";
+      return false;
+    }
+
+  return true;
+}
+
+int CannedFlight::startTime() const
+{
+  return fixes.isEmpty() ? 0 : fixes.first().time;
+}
+
+int CannedFlight::stopTime() const
+{
+  return fixes.isEmpty() ? 0 : fixes.last().time;
+}
+
+/*---------------------- RecorderEmulator ------------------------------------*/
+
+RecorderEmulator::RecorderEmulator( QObject *parent ) :
+  QThread( parent ),
+  m_master(-1),
+  m_slave(-1),
+  m_rate(0),
+  m_errorRate(0.0),
+  m_stallRate(0.0),
+  m_stallTime(0),
+  m_random(1),
+  m_stallEnd(0),
+  m_errorsEnabled(false),
+  m_stop(false)
+{
+}
+
+RecorderEmulator::~RecorderEmulator()
+{
+  stop();
+}
+
+bool RecorderEmulator::openPty()
+{
+  m_master = posix_openpt( O_RDWR | O_NOCTTY );
+
+  if( m_master == -1 || grantpt( m_master ) == -1 || unlockpt( m_master ) == -1 )
+    {
+      qWarning() << "RecorderEmulator: Cannot create a pseudo terminal"
+                 << strerror( errno );
+      return false;
+    }
+
+  m_portName = ptsname( m_master );
+
+  m_slave = ::open( m_portName.toLocal8Bit().constData(), O_RDWR | O_NOCTTY );
+
+  if( m_slave == -1 )
+    {
+      qWarning() << "RecorderEmulator: Cannot open" << m_portName
+                 << strerror( errno );
+      return false;
+    }
+
+  // No echo and no line processing, until the plugin sets up the port.
+  struct termios termEnv;
+
+  tcgetattr( m_slave, &termEnv );
+  cfmakeraw( &termEnv );
+  tcsetattr( m_slave, TCSANOW, &termEnv );
+
+  fcntl( m_master, F_SETFL, fcntl( m_master, F_GETFL ) | O_NONBLOCK );
+
+  return true;
+}
+
+void RecorderEmulator::setFlights( const QList<CannedFlight>& flights )
+{
+  m_flights = flights;
+}
+
+void RecorderEmulator::setRate( const int bytesPerSecond )
+{
+  m_rate = bytesPerSecond;
+}
+
+void RecorderEmulator::setErrors( const double errorRate, const double stallRate,
+                                  const int stallTime, const uint seed )
+{
+  m_errorRate = errorRate;
+  m_stallRate = stallRate;
+  m_stallTime = stallTime;
+  m_random    = seed;
+}
+
+void RecorderEmulator::setErrorsEnabled( const bool enable )
+{
+  QMutexLocker locker( &m_mutex );
+  m_errorsEnabled = enable;
+}
+
+RecorderEmulator::Statistics RecorderEmulator::statistics()
+{
+  QMutexLocker locker( &m_mutex );
+  return m_statistics;
+}
+
+void RecorderEmulator::stop()
+{
+  m_mutex.lock();
+  m_stop = true;
+  m_mutex.unlock();
+
+  wait();
+
+  if( m_slave != -1 )
+    {
+      ::close( m_slave );
+      m_slave = -1;
+    }
+
+  if( m_master != -1 )
+    {
+      ::close( m_master );
+      m_master = -1;
+    }
+}
+
+void RecorderEmulator::run()
+{
+  m_clock.start();
+
+  int last = 0;
+  double credit = 0.0;
+
+  while( true )
+    {
+      m_mutex.lock();
+      bool stop = m_stop;
+      m_mutex.unlock();
+
+      if( stop )
+        {
+          break;
+        }
+
+      struct pollfd pfd;
+      pfd.fd      = m_master;
+      pfd.events  = POLLIN;
+      pfd.revents = 0;
+
+      // Short wait, if output is pending, to keep the rate smooth.
+      poll( &pfd, 1, m_output.isEmpty() ? 50 : 2 );
+
+      if( pfd.revents & POLLIN )
+        {
+          unsigned char buffer[256];
+
+          int done = ::read( m_master, buffer, sizeof(buffer) );
+
+          if( done > 0 )
+            {
+              m_mutex.lock();
+              m_statistics.bytesReceived += done;
+              m_mutex.unlock();
+
+              for( int i = 0; i < done; i++ )
+                {
+                  received( buffer[i] );
+                }
+            }
+        }
+
+      int now = m_clock.elapsed();
+      int rate = __rate();
+
+      credit += (now - last) * rate / 1000.0;
+      last = now;
+
+      const double burst = qMax( 1.0, rate * BURST_TIME / 1000.0 );
+
+      if( credit > burst )
+        {
+          credit = burst;
+        }
+
+      if( m_output.isEmpty() || now < m_stallEnd )
+        {
+          continue;
+        }
+
+      credit -= __write( qMin( (int) credit, m_output.size() ) );
+    }
+}
+
+int RecorderEmulator::__rate() const
+{
+  if( m_rate > 0 )
+    {
+      return m_rate;
+    }
+
+  // The termios of the slave side are also reported for the master side.
+  struct termios termEnv;
+
+  if( tcgetattr( m_master, &termEnv ) == -1 )
+    {
+      return 960;
+    }
+
+  switch( cfgetospeed( &termEnv ) )
+    {
+      case B1200:
+        return 120;
+      case B2400:
+        return 240;
+      case B4800:
+        return 480;
+      case B19200:
+        return 1920;
+      case B38400:
+        return 3840;
+      case B57600:
+        return 5760;
+      case B115200:
+        return 11520;
+      case B9600:
+      default:
+        return 960;
+    }
+}
+
+int RecorderEmulator::__write( const int count )
+{
+  m_mutex.lock();
+  const bool errors = m_errorsEnabled;
+  m_mutex.unlock();
+
+  int written = 0;
+  int corrupted = 0;
+  int stalls = 0;
+
+  while( written < count )
+    {
+      unsigned char byte = m_output.at(written);
+      bool inject = errors && m_errorMask.at(written);
+
+      if( inject && m_errorRate > 0.0 && random() < m_errorRate )
+        {
+          byte = corrupt( byte );
+          corrupted++;
+        }
+
+      if( ::write( m_master, &byte, 1 ) != 1 )
+        {
+          // The buffer of the pseudo terminal is full.
+          break;
+        }
+
+      written++;
+
+      if( inject && m_stallRate > 0.0 && random() < m_stallRate )
+        {
+          m_stallEnd = m_clock.elapsed() + m_stallTime;
+          stalls++;
+          break;
+        }
+    }
+
+  m_output.remove( 0, written );
+  m_errorMask.remove( 0, written );
+
+  m_mutex.lock();
+  m_statistics.bytesSent      += written;
+  m_statistics.corruptedBytes += corrupted;
+  m_statistics.stalls         += stalls;
+  m_mutex.unlock();
+
+  return written;
+}
+
+void RecorderEmulator::send( const QByteArray& data, const bool errors )
+{
+  m_output.append( data );
+  m_errorMask.append( QByteArray( data.size(), errors ? 1 : 0 ) );
+}
+
+void RecorderEmulator::sendByte( const unsigned char byte, const bool errors )
+{
+  m_output.append( (char) byte );
+  m_errorMask.append( errors ? 1 : 0 );
+}
+
+void RecorderEmulator::discardOutput()
+{
+  m_output.clear();
+  m_errorMask.clear();
+}
+
+void RecorderEmulator::command( const QByteArray& cmd )
+{
+  QMutexLocker locker( &m_mutex );
+
+  m_statistics.commands++;
+
+  if( cmd == m_lastCommand )
+    {
+      m_statistics.repeatedCommands++;
+    }
+
+  m_lastCommand = cmd;
+}
+
+unsigned char RecorderEmulator::corrupt( const unsigned char byte )
+{
+  return byte ^ (1 << (int) (random() * 8));
+}
+
+double RecorderEmulator::random()
+{
+  // 64 bit linear congruential generator, the upper 53 bits are used.
+  m_random = m_random * Q_UINT64_C(6364136223846793005) + Q_UINT64_C(1442695040888963407);
+
+  return (m_random >> 11) * (1.0 / 9007199254740992.0);
+}
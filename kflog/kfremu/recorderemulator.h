@@ -0,0 +1,316 @@
+/***********************************************************************
+**
+**   recorderemulator.h
+**
+**   This file is part of KFLog.
+**
+************************************************************************
+**
+**   Copyright (c):  2026 by agent <agent@local>
+**
+**   This file is distributed under the terms of the General Public
+**   License. See the file COPYING for more information.
+**
+***********************************************************************/
+
+/**
+ * \class RecorderEmulator
+ *
+ * \author agent
+ *
+ * \brief Base class of the flight recorder emulators.
+ *
+ * An emulator creates a pseudo terminal pair. The plugin under test opens
+ * the slave side like a serial port, the emulator answers on the master
+ * side in its own thread. The derived classes implement the protocol of a
+ * recorder in \ref received and answer with \ref send.
+ *
+ * The answers are written with the throughput of the port speed, which is
+ * set by the plugin, or with a fixed rate. Errors are injected into the
+ * data blocks on request, a byte is corrupted by a flipped bit or the
+ * stream is stalled for a while. The transfered bytes, the commands and
+ * the injected errors are counted.
+ *
+ * \date 2026
+ *
+ * \version 1.0
+ */
+
+#ifndef RECORDER_EMULATOR_H
+#define RECORDER_EMULATOR_H
+
+#include <QByteArray>
+#include <QDate>
+#include <QList>
+#include <QMutex>
+#include <QString>
+#include <QThread>
+#include <QTime>
+
+/**
+ * \class CannedFlight
+ *
+ * \author agent
+ *
+ * \brief An IGC file, which is served by an emulator as recorded flight.
+ *
+ * \date 2026
+ *
+ * \version 1.0
+ */
+class CannedFlight
+{
+ public:
+
+  /** A B-record of the IGC file */
+  class Fix
+  {
+   public:
+
+    /** Seconds since midnight */
+    int time;
+
+    /** Latitude and longitude in 1/1000 minutes, negative for S and W */
+    int lat;
+    int lon;
+
+    /** A for a 3D fix, V for a 2D fix */
+    char valid;
+
+    int gpsAlt;
+
+    /** Latitude, longitude and validity as written in the B-record */
+    QByteArray position;
+  };
+
+  CannedFlight();
+
+  /**
+   * Reads and parses an IGC file.
+   *
+   * \return True in case of success.
+   */
+  bool load( const QString& fileName );
+
+  QString fileName;
+
+  /** Content of the file */
+  QByteArray data;
+
+  /** Lines of the file without the line ends */
+  QList<QByteArray> lines;
+
+  QList<Fix> fixes;
+
+  QDate date;
+
+  QByteArray pilot;
+  QByteArray gliderID;
+
+  /** Time of the first and the last fix in seconds since midnight */
+  int startTime() const;
+  int stopTime() const;
+};
+
+class RecorderEmulator : public QThread
+{
+  Q_OBJECT
+
+ private:
+
+  Q_DISABLE_COPY ( RecorderEmulator )
+
+ public:
+
+  /** Counters of the transfer */
+  class Statistics
+  {
+   public:
+
+    Statistics() :
+      bytesSent(0),
+      bytesReceived(0),
+      corruptedBytes(0),
+      stalls(0),
+      commands(0),
+      repeatedCommands(0)
+    {};
+
+    qint64 bytesSent;
+    qint64 bytesReceived;
+    int    corruptedBytes;
+    int    stalls;
+    int    commands;
+
+    /** Commands, which were sent twice in a row */
+    int    repeatedCommands;
+  };
+
+  RecorderEmulator( QObject *parent=0 );
+
+  virtual ~RecorderEmulator();
+
+  /**
+   * Creates the pseudo terminal pair.
+   *
+   * \return True in case of success.
+   */
+  bool openPty();
+
+  /**
+   * \return The name of the slave device, which is opened by the plugin.
+   */
+  const QString& portName() const
+  {
+    return m_portName;
+  };
+
+  /**
+   * \return The name of the plugin library of the emulated recorder.
+   */
+  virtual QString libName() const = 0;
+
+  /**
+   * Sets the flights stored in the recorder. Must be called before the
+   * thread is started.
+   */
+  virtual void setFlights( const QList<CannedFlight>& flights );
+
+  /**
+   * Sets a fixed rate in bytes per second. With 0 the rate follows the
+   * port speed set by the plugin, a byte needs ten bits.
+   */
+  void setRate( const int bytesPerSecond );
+
+  /**
+   * Sets the error injection.
+   *
+   * \param errorRate Probability of a corrupted byte
+   *
+   * \param stallRate Probability of a stall after a byte
+   *
+   * \param stallTime Duration of a stall in milliseconds
+   *
+   * \param seed Start value of the random numbers
+   */
+  void setErrors( const double errorRate, const double stallRate,
+                  const int stallTime, const uint seed );
+
+  /**
+   * Enables or disables the error injection. Can be called from any
+   * thread.
+   */
+  void setErrorsEnabled( const bool enable );
+
+  /**
+   * Checks a downloaded file against the flight served by the emulator.
+   *
+   * \return An empty string, if the file is correct, otherwise the found
+   *         difference.
+   */
+  virtual QString verify( const int flight, const QString& fileName ) const = 0;
+
+  /**
+   * \return The counters of the transfer. Can be called from any thread.
+   */
+  Statistics statistics();
+
+  /**
+   * Stops the thread and closes the pseudo terminal.
+   */
+  void stop();
+
+ protected:
+
+  /**
+   * That is the main method of the thread.
+   */
+  void run();
+
+  /**
+   * Handles a byte sent by the plugin. Called in the emulator thread.
+   */
+  virtual void received( const unsigned char byte ) = 0;
+
+  /**
+   * Queues data for the output to the plugin. If errors is true, the
+   * error injection may corrupt the data.
+   */
+  void send( const QByteArray& data, const bool errors=false );
+
+  void sendByte( const unsigned char byte, const bool errors=false );
+
+  /**
+   * Discards the not yet written output, e.g. if the plugin aborts a
+   * command.
+   */
+  void discardOutput();
+
+  /**
+   * Counts a received command.
+   */
+  void command( const QByteArray& cmd );
+
+  /**
+   * \return A corrupted copy of the byte. The default flips one bit.
+   */
+  virtual unsigned char corrupt( const unsigned char byte );
+
+  /**
+   * \return A random number between 0 and 1.
+   */
+  double random();
+
+  QList<CannedFlight> m_flights;
+
+ private:
+
+  /**
+   * \return The current output rate in bytes per second.
+   */
+  int __rate() const;
+
+  /**
+   * Writes up to count bytes of the output queue to the master side.
+   *
+   * \return The number of written bytes.
+   */
+  int __write( const int count );
+
+  QString m_portName;
+
+  /** File descriptor of the master side */
+  int m_master;
+
+  /**
+   * Descriptor of the slave side. It is kept open, so that the master
+   * side stays usable, while the plugin has closed the port.
+   */
+  int m_slave;
+
+  int    m_rate;
+  double m_errorRate;
+  double m_stallRate;
+  int    m_stallTime;
+  quint64 m_random;
+
+  /** Time since the start of the thread */
+  QTime m_clock;
+
+  /** End of the current stall in milliseconds of m_clock */
+  int m_stallEnd;
+
+  /** Output queue and per byte the permission to corrupt it */
+  QByteArray m_output;
+  QByteArray m_errorMask;
+
+  QByteArray m_lastCommand;
+
+  /** Protects the statistics and the flags below. */
+  QMutex     m_mutex;
+  Statistics m_statistics;
+  bool       m_errorsEnabled;
+  bool       m_stop;
+};
+
+#endif
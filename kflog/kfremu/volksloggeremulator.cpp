@@ -0,0 +1,464 @@
+/***********************************************************************
+**
+**   volksloggeremulator.cpp
+**
+**   This file is part of KFLog.
+**
+************************************************************************
+**
+**   Copyright (c):  2026 by agent <agent@local>
+**
+**   This file is distributed under the terms of the General Public
+**   License. See the file COPYING for more information.
+**
+***********************************************************************/
+
+#include <QtCore>
+
+#include "volksloggeremulator.h"
+
+// Control bytes, see kfrgcs/vla_support.h
+#define STX 0x02
+#define ETX 0x03
+#define ENQ 0x05
+#define ACK 0x06
+#define DLE 0x10
+#define CAN 0x18
+
+// Commands
+#define CMD_INF 0x00
+#define CMD_DIR 0x01
+#define CMD_GFL 0x02
+#define CMD_GFS 0x03
+#define CMD_SIG 0x08
+#define CMD_RST 0x0c
+
+// Command byte, two parameters, five unused bytes and the CRC
+#define COMMAND_SIZE 10
+
+// Record types of the GCS format, see kfrgcs/vlconv.cpp
+#define REC_VRT 0x00
+#define REC_VRB 0x20
+#define REC_SEP 0x40
+#define REC_END 0x60
+#define REC_POS 0x80
+#define REC_TND 0xA0
+#define REC_POC 0xE0
+
+// Variable record fields
+#define FLD_PLT1 0x01
+#define FLD_GID  0x06
+#define FLD_HDR  0x50
+
+// Largest time difference of a fix record
+#define MAX_FIX_DT 127
+
+// Serial number of the emulated recorder
+#define SERIAL_NUMBER 0x1234
+
+// Length of the emulated signature
+#define SIGNATURE_SIZE 16
+
+VolksloggerEmulator::VolksloggerEmulator( QObject *parent ) :
+  RecorderEmulator( parent ),
+  m_inCommand(false),
+  m_blockPos(0)
+{
+}
+
+VolksloggerEmulator::~VolksloggerEmulator()
+{
+}
+
+void VolksloggerEmulator::setFlights( const QList<CannedFlight>& flights )
+{
+  RecorderEmulator::setFlights( flights );
+
+  m_directory.clear();
+
+  for( int i = 0; i < m_flights.size(); i++ )
+    {
+      const CannedFlight& flight = m_flights.at(i);
+      const int start = flight.startTime();
+
+      int duration = flight.stopTime() - start;
+
+      if( duration < 0 )
+        {
+          duration += 86400;
+        }
+
+      m_directory.append( (char) REC_SEP );
+      m_directory.append( __encodeHeader( i ) );
+
+      // time and date of the first fix
+      m_directory.append( (char) REC_TND );
+      m_directory.append( (char) 0 );
+      m_directory.append( (char) ((start >> 16) & 0xff) );
+      m_directory.append( (char) ((start >> 8) & 0xff) );
+      m_directory.append( (char) (start & 0xff) );
+      m_directory.append( (char) (((flight.date.year() % 100) / 10 << 4) | (flight.date.year() % 10)) );
+      m_directory.append( (char) ((flight.date.month() / 10 << 4) | (flight.date.month() % 10)) );
+      m_directory.append( (char) ((flight.date.day() / 10 << 4) | (flight.date.day() % 10)) );
+
+      // duration and start of the recording relative to the time above
+      m_directory.append( (char) REC_END );
+      m_directory.append( (char) ((duration >> 16) & 0xff) );
+      m_directory.append( (char) ((duration >> 8) & 0xff) );
+      m_directory.append( (char) (duration & 0xff) );
+      m_directory.append( QByteArray( 3, '\0' ) );
+    }
+
+  // end of the directory
+  m_directory.append( (char) REC_POC );
+  m_directory.append( (char) 0x00 );
+  m_directory.append( (char) 0x80 );
+}
+
+QByteArray VolksloggerEmulator::__encodeHeader( const int flight ) const
+{
+  const CannedFlight& canned = m_flights.at(flight);
+
+  QByteArray data;
+
+  // serial number, datum, hardware and firmware version, fix accuracy
+  const char header[] = { REC_VRB, 10, FLD_HDR,
+                          (char) (SERIAL_NUMBER >> 8), (char) (SERIAL_NUMBER & 0xff),
+                          100, 0x32, 0x36, 0, 50 };
+
+  data.append( header, sizeof(header) );
+
+  QByteArray pilot = canned.pilot.left( 16 );
+  pilot.append( QByteArray( 17 - pilot.size(), '\0' ) );
+
+  data.append( (char) REC_VRB );
+  data.append( (char) (3 + pilot.size()) );
+  data.append( (char) FLD_PLT1 );
+  data.append( pilot );
+
+  QByteArray gliderID = canned.gliderID.left( 7 );
+  gliderID.append( QByteArray( 8 - gliderID.size(), '\0' ) );
+
+  data.append( (char) REC_VRB );
+  data.append( (char) (3 + gliderID.size()) );
+  data.append( (char) FLD_GID );
+  data.append( gliderID );
+
+  return data;
+}
+
+QByteArray VolksloggerEmulator::__encodeFlight( const int flight ) const
+{
+  const CannedFlight& canned = m_flights.at(flight);
+  const int start = canned.startTime();
+  const QDate& date = canned.date;
+
+  QByteArray data;
+
+  data.append( (char) REC_SEP );
+  data.append( __encodeHeader( flight ) );
+
+  data.append( (char) REC_TND );
+  data.append( (char) 0 );
+  data.append( (char) ((start >> 16) & 0xff) );
+  data.append( (char) ((start >> 8) & 0xff) );
+  data.append( (char) (start & 0xff) );
+  data.append( (char) (((date.year() % 100) / 10 << 4) | (date.year() % 10)) );
+  data.append( (char) ((date.month() / 10 << 4) | (date.month() % 10)) );
+  data.append( (char) ((date.day() / 10 << 4) | (date.day() % 10)) );
+
+  int last = start;
+
+  for( int i = 0; i < canned.fixes.size(); i++ )
+    {
+      const CannedFlight::Fix& fix = canned.fixes.at(i);
+
+      int dt = fix.time - last;
+
+      if( dt < 0 )
+        {
+          // over midnight
+          dt += 86400;
+        }
+
+      last = fix.time;
+
+      // A fix record takes only small time differences, the rest is
+      // skipped by empty timed records.
+      while( dt > MAX_FIX_DT )
+        {
+          int skip = qMin( 255, dt - MAX_FIX_DT );
+
+          data.append( (char) REC_VRT );
+          data.append( (char) 4 );
+          data.append( (char) skip );
+          data.append( (char) 0 );
+
+          dt -= skip;
+        }
+
+      const int lat = qAbs( fix.lat );
+      const int lon = qAbs( fix.lon );
+      const int gpsAlt = qBound( 0, (fix.gpsAlt + 1000) / 10, 2047 );
+
+      data.append( (char) (REC_POS | (fix.valid == 'A' ? 0x10 : 0)) );
+      data.append( (char) 0 );
+      data.append( (char) dt );
+      data.append( (char) (((lat >> 16) & 0x7f) | (fix.lat < 0 ? 0x80 : 0)) );
+      data.append( (char) ((lat >> 8) & 0xff) );
+      data.append( (char) (lat & 0xff) );
+      data.append( (char) ((lon >> 16) & 0xff) );
+      data.append( (char) ((lon >> 8) & 0xff) );
+      data.append( (char) (lon & 0xff) );
+      data.append( (char) ((fix.lon < 0 ? 0x80 : 0) | ((gpsAlt >> 4) & 0x70) | 0x01) );
+      data.append( (char) (gpsAlt & 0xff) );
+    }
+
+  // security record
+  data.append( (char) REC_END );
+  data.append( QByteArray( 40, '\0' ) );
+
+  return data;
+}
+
+QString VolksloggerEmulator::verify( const int flight, const QString& fileName ) const
+{
+  QFile file( fileName );
+
+  if( ! file.open( QIODevice::ReadOnly ) )
+    {
+      return "cannot open file";
+    }
+
+  const QList<CannedFlight::Fix>& fixes = m_flights.at(flight).fixes;
+
+  int count = 0;
+
+  while( ! file.atEnd() )
+    {
+      QByteArray line = file.readLine();
+
+      if( ! line.startsWith( 'B' ) )
+        {
+          continue;
+        }
+
+      if( count >= fixes.size() )
+        {
+          return QString( "more than %1 fixes" ).arg( fixes.size() );
+        }
+
+      const CannedFlight::Fix& fix = fixes.at(count);
+
+      QByteArray time = QTime( 0, 0 ).addSecs( fix.time ).toString( "HHmmss" ).toLatin1();
+
+      if( line.mid( 1, 6 ) != time || line.mid( 7, 18 ) != fix.position )
+        {
+          return QString( "fix %1 differs" ).arg( count + 1 );
+        }
+
+      count++;
+    }
+
+  if( count != fixes.size() )
+    {
+      return QString( "%1 of %2 fixes" ).arg( count ).arg( fixes.size() );
+    }
+
+  return QString();
+}
+
+void VolksloggerEmulator::received( const unsigned char byte )
+{
+  if( m_inCommand )
+    {
+      m_command.append( (char) byte );
+
+      if( m_command.size() == COMMAND_SIZE )
+        {
+          m_inCommand = false;
+          __command();
+        }
+
+      return;
+    }
+
+  switch( byte )
+    {
+      case CAN:
+
+        // abort of a command or a transfer
+        discardOutput();
+        m_block.clear();
+        m_blockMask.clear();
+        m_blockPos = 0;
+        break;
+
+      case 'R':
+
+        // connect request
+        send( "LLLL" );
+        break;
+
+      case ENQ:
+
+        m_command.clear();
+        m_inCommand = true;
+        break;
+
+      case ACK:
+
+        // request of the next byte of a block
+        if( m_blockPos < m_block.size() )
+          {
+            sendByte( m_block.at(m_blockPos), m_blockMask.at(m_blockPos) );
+            m_blockPos++;
+          }
+
+        break;
+
+      default:
+        break;
+    }
+}
+
+void VolksloggerEmulator::__command()
+{
+  unsigned short crc = 0;
+
+  for( int i = 0; i < m_command.size(); i++ )
+    {
+      crc = __updateCrc( m_command.at(i), crc );
+    }
+
+  command( m_command.left( 3 ) );
+
+  if( crc != 0 )
+    {
+      sendByte( 1 );
+      return;
+    }
+
+  const unsigned char cmd = m_command.at(0);
+  const unsigned char param1 = m_command.at(1);
+
+  switch( cmd )
+    {
+      case CMD_INF:
+        {
+          // session id, serial number, firmware version and build
+          const char info[] = { 0, 1, (char) (SERIAL_NUMBER >> 8),
+                                (char) (SERIAL_NUMBER & 0xff), 0x36, 0, 0, 1 };
+
+          sendByte( 0 );
+          __setBlock( QByteArray( info, sizeof(info) ), false );
+          break;
+        }
+
+      case CMD_DIR:
+
+        sendByte( 0 );
+        __setBlock( m_directory, false );
+        break;
+
+      case CMD_GFL:
+      case CMD_GFS:
+
+        if( param1 >= m_flights.size() )
+          {
+            sendByte( 1 );
+            break;
+          }
+
+        sendByte( 0 );
+        __setBlock( __encodeFlight( param1 ), true );
+        break;
+
+      case CMD_SIG:
+
+        sendByte( 0 );
+        __setBlock( QByteArray( SIGNATURE_SIZE, 'S' ), true );
+        break;
+
+      case CMD_RST:
+
+        sendByte( 0 );
+        break;
+
+      default:
+
+        // The database is not emulated.
+        sendByte( 1 );
+        break;
+    }
+}
+
+void VolksloggerEmulator::__setBlock( const QByteArray& data, const bool errors )
+{
+  unsigned short crc = 0;
+
+  for( int i = 0; i < data.size(); i++ )
+    {
+      crc = __updateCrc( data.at(i), crc );
+    }
+
+  QByteArray payload( data );
+  payload.append( (char) (crc >> 8) );
+  payload.append( (char) (crc & 0xff) );
+
+  m_block.clear();
+  m_blockMask.clear();
+  m_blockPos = 0;
+
+  m_block.append( (char) DLE );
+  m_block.append( (char) STX );
+  m_blockMask.append( QByteArray( 2, 0 ) );
+
+  for( int i = 0; i < payload.size(); i++ )
+    {
+      if( payload.at(i) == DLE )
+        {
+          // An escaped DLE is never corrupted, that would break the framing.
+          m_block.append( (char) DLE );
+          m_block.append( (char) DLE );
+          m_blockMask.append( QByteArray( 2, 0 ) );
+        }
+      else
+        {
+          m_block.append( payload.at(i) );
+          m_blockMask.append( errors ? 1 : 0 );
+        }
+    }
+
+  m_block.append( (char) DLE );
+  m_block.append( (char) ETX );
+  m_blockMask.append( QByteArray( 2, 0 ) );
+}
+
+unsigned char VolksloggerEmulator::corrupt( const unsigned char byte )
+{
+  unsigned char result = RecorderEmulator::corrupt( byte );
+
+  if( result == DLE )
+    {
+      // The byte differs from a DLE in one bit, so its complement is
+      // neither the byte nor a DLE.
+      result = ~byte;
+    }
+
+  return result;
+}
+
+unsigned short VolksloggerEmulator::__updateCrc( const unsigned char byte,
+                                                 const unsigned short crc )
+{
+  // CRC-CCITT, the same as the table based one of the plugin
+  unsigned short result = crc ^ (byte << 8);
+
+  for( int i = 0; i < 8; i++ )
+    {
+      result = (result & 0x8000) ? (result << 1) ^ 0x1021 : (result << 1);
+    }
+
+  return result;
+}
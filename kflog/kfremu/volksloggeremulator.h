@@ -0,0 +1,114 @@
+/***********************************************************************
+**
+**   volksloggeremulator.h
+**
+**   This file is part of KFLog.
+**
+************************************************************************
+**
+**   Copyright (c):  2026 by agent <agent@local>
+**
+**   This file is distributed under the terms of the General Public
+**   License. See the file COPYING for more information.
+**
+***********************************************************************/
+
+/**
+ * \class VolksloggerEmulator
+ *
+ * \author agent
+ *
+ * \brief Emulates a Volkslogger for the kfrgcs plugin.
+ *
+ * The flights are stored in the binary GCS format of the Volkslogger. Only
+ * the fixes and the header fields needed by the flight directory are
+ * encoded, so a downloaded flight is checked by the time, the position
+ * and the validity of its B-records. Every byte of a data block is sent
+ * on request of the plugin, as the real recorder does.
+ *
+ * \date 2026
+ *
+ * \version 1.0
+ */
+
+#ifndef VOLKSLOGGER_EMULATOR_H
+#define VOLKSLOGGER_EMULATOR_H
+
+#include <QByteArray>
+#include <QList>
+
+#include "recorderemulator.h"
+
+class VolksloggerEmulator : public RecorderEmulator
+{
+  Q_OBJECT
+
+ private:
+
+  Q_DISABLE_COPY ( VolksloggerEmulator )
+
+ public:
+
+  VolksloggerEmulator( QObject *parent=0 );
+
+  virtual ~VolksloggerEmulator();
+
+  virtual QString libName() const
+  {
+    return "libkfrgcs.so";
+  };
+
+  virtual void setFlights( const QList<CannedFlight>& flights );
+
+  virtual QString verify( const int flight, const QString& fileName ) const;
+
+ protected:
+
+  virtual void received( const unsigned char byte );
+
+  /**
+   * A corrupted byte must not become a DLE, otherwise the plugin would
+   * miss the end of the block and wait forever.
+   */
+  virtual unsigned char corrupt( const unsigned char byte );
+
+ private:
+
+  /**
+   * Handles a complete command packet.
+   */
+  void __command();
+
+  /**
+   * Prepares a data block, which is sent byte by byte on request.
+   */
+  void __setBlock( const QByteArray& data, const bool errors );
+
+  /**
+   * \return The flight encoded in the GCS format.
+   */
+  QByteArray __encodeFlight( const int flight ) const;
+
+  /**
+   * \return The header records of a flight used in the flight data and in
+   *         the directory.
+   */
+  QByteArray __encodeHeader( const int flight ) const;
+
+  static unsigned short __updateCrc( const unsigned char byte,
+                                     const unsigned short crc );
+
+  /** True, while a command packet is received */
+  bool m_inCommand;
+
+  QByteArray m_command;
+
+  /** Data block in transfer and the permission to corrupt its bytes */
+  QByteArray m_block;
+  QByteArray m_blockMask;
+  int        m_blockPos;
+
+  QByteArray m_directory;
+};
+
+#endif
@@ -66,30 +66,18 @@
 #define EXTEND_INFO        254        /* fd */
 #define FIXEXT_INFO        255        /* fe */
 
+// Timeout of a serial read in milliseconds
+#define READ_TIMEOUT  100
+
 #define LOW_SECURITY        0x0d
 #define MED_SECURITY        0x0e
 #define HIGH_SECURITY       0x0f
 
 
-/**
- * The device-name of the port.
- */
-const char* portName = "\0";
-int portID = -1;
 const char* c36 = "0123456789abcdefghijklmnopqrstuvwxyz";
 
 extern int breakTransfer;
 
-/**
- * holds the port-settings at start of the application
- */
-struct termios oldTermEnv;
-
-/**
- * is used to change the port-settings
- */
-struct termios newTermEnv;
-
 /*
  * Command bytes for communication with the lx device
  */
@@ -156,15 +144,6 @@ void debugHex (const void* buf, unsigned int size)
     }
 }
 
-/**
- * Needed to reset the serial port in any case of unexpected exiting
- * of the program. Called via signal-handler of the runtime-environment.
- */
-void releaseTTY(int /* signal*/)
-{
-  tcsetattr(portID, TCSANOW, &oldTermEnv);
-}
-
 Filser::Filser( QObject *parent ) : FlightRecorderPluginBase( parent ),
   _speed(B0)
 {
@@ -198,7 +177,6 @@ Filser::Filser( QObject *parent ) : FlightRecorderPluginBase( parent ),
   _capabilities.supAutoSpeed = true;       //supports automatic transfer speed detection
   //End set capabilities.
 
-  portID = -1;
   _da4BufferValid = false;
 
   _keepalive = new QTimer( this );
@@ -216,12 +194,12 @@ Filser::~Filser()
   */
 void Filser::slotTimeout()
 {
-  tcflush(portID, TCIOFLUSH); // Make sure the next ACK comes from the
-                              // following wb(SYN). And remove the
-                              // position data, that might have been
-                              // arrived.
+  _serial.flush(); // Make sure the next ACK comes from the
+                   // following wb(SYN). And remove the
+                   // position data, that might have been
+                   // arrived.
   wb( SYN );
-  tcdrain( portID );
+  _serial.drain();
   int ret = rb();
 
   if( ret != ACK )
@@ -262,7 +240,7 @@ int Filser::getFlightDir( QList<FRDirEntry *>* dirList )
 
   _keepalive->blockSignals(true);
 
-  tcflush(portID, TCIOFLUSH);
+  _serial.flush();
 
   wb(STX);
   wb(M);
@@ -439,7 +417,7 @@ int Filser::getBasicData(FR_BasicData& data)
   _errorinfo = "";
   int lc = 0 ;
 
-  tcflush(portID, TCIOFLUSH);
+  _serial.flush();
 
   wb(STX);
   wb(REQ_BASIC_DATA);
@@ -512,7 +490,7 @@ int Filser::getBasicData(FR_BasicData& data)
 
   // during sleep, hopefully the extra bytes will arrive and can be flushed savely.
   //sleep (1);
-  //tcflush(portID, TCIOFLUSH);
+  //_serial.flush();
   //
   // 13.03.05 Fughe: Maybe it is saver to throw them away.
   //                 check4Device() is doing this now too by 'while(0xff != rb());'.
@@ -525,7 +503,7 @@ int Filser::getBasicData(FR_BasicData& data)
     return FR_ERROR;
   }
 
-  tcflush(portID, TCIOFLUSH);
+  _serial.flush();
 
   wb(STX);
   wb(REQ_FLIGHT_DATA);
@@ -638,54 +616,6 @@ int Filser::downloadFlight(int flightID, int /*secMode*/, const QString& fileNam
 
 int Filser::openRecorder(const QString& pName, int baud)
 {
-  portName = pName.toLatin1().data();
-
-  portID = open(portName, O_RDWR | O_NOCTTY);
-
-  if(portID != -1) {
-    //
-    // Before we change any port-settings, we must establish a
-    // signal-handler, which is used to restore the port-settings
-    // after terminating the program.
-    // Because a SIGKILL-signal removes the program immediately,
-    // the status of the port will be undefined.
-    //
-    struct sigaction sact;
-
-    sact.sa_handler = releaseTTY;
-    sigaction(SIGHUP, &sact, 0);
-    sigaction(SIGINT, &sact, 0);
-    sigaction(SIGPIPE, &sact, 0);
-    sigaction(SIGTERM, &sact, 0);
-
-    /*
-     * Set the terminal mode of the serial line
-     */
-
-    // reading the current port-settings
-    tcgetattr(portID, &newTermEnv);
-
-    // storing the port-settings to restore them ...
-    oldTermEnv = newTermEnv;
-
-    /*
-     * Do some common settup
-     */
-    newTermEnv.c_iflag = IGNPAR;
-    newTermEnv.c_iflag &= ~(IGNBRK | BRKINT | PARMRK | ISTRIP | INLCR | IGNCR | ICRNL | IXON);
-    newTermEnv.c_oflag &= ~OPOST;
-    newTermEnv.c_oflag |= ONLCR;
-    newTermEnv.c_lflag &= ~(ECHO | ECHONL | ICANON | ISIG | IEXTEN);
-    /*
-     * No flow control at all :-(
-     */
-    newTermEnv.c_cflag &= ~(CSIZE | PARENB | CSTOPB | CRTSCTS | IXON | IXOFF);
-    newTermEnv.c_cflag |= (CS8 | CLOCAL | CREAD);
-
-    // control characters
-    newTermEnv.c_cc[VMIN] = 0; // don't wait for a character
-    newTermEnv.c_cc[VTIME] = 1; // wait at least 1 msec.
-
 //    if(baud >= 115200) speed = B115200;
 //    else if(baud >= 57600) speed = B57600;
 //    else
@@ -694,20 +624,14 @@ int Filser::openRecorder(const QString& pName, int baud)
 //  2400 - 38400 bps
 //  These are the only speeds known by Filser devices, right?
 //  Does anybody have different experiences?
-    if(baud >= 38400) _speed = B38400;
-    else if(baud >= 19200) _speed = B19200;
-    else if(baud >=  9600) _speed = B9600;
-    else if(baud >=  4800) _speed = B4800;
-    else                   _speed = B2400;
-
-    cfsetospeed(&newTermEnv, _speed);
-    cfsetispeed(&newTermEnv, _speed);
-
-    // flush the device
-    tcflush (portID, TCIOFLUSH);
-    // Activating the port-settings
-    tcsetattr(portID, TCSANOW, &newTermEnv);
-
+  if(baud >= 38400) _speed = B38400;
+  else if(baud >= 19200) _speed = B19200;
+  else if(baud >=  9600) _speed = B9600;
+  else if(baud >=  4800) _speed = B4800;
+  else                   _speed = B2400;
+
+  // No flow control at all :-(
+  if( _serial.open( pName, _speed ) ) {
     _isConnected = true;
     _da4BufferValid = false;
 
@@ -756,14 +680,14 @@ bool Filser::defMem(struct flightTable *ft)
   memcpy(address_buf + 3, &flight_end_adr, 3);
   address_buf[6] = calcCrcBuf(address_buf, 6);
 
-  tcflush(portID, TCIOFLUSH);
+  _serial.flush();
 
   wb(STX);
   wb(N);
   for(unsigned int i = 0; i < sizeof(address_buf); i++) {
     wb(address_buf[i]);
   }
-  tcdrain (portID);
+  _serial.drain();
   if (rb() != ACK) {
     _errorinfo = tr("Invalid response from LX-device.");
     return false;
@@ -775,11 +699,11 @@ bool Filser::getMemSection(unsigned char *memSection, int size)
 {
   int i;
 
-  tcflush(portID, TCIOFLUSH);
+  _serial.flush();
 
   wb(STX);
   wb(L);
-  tcdrain (portID);
+  _serial.drain();
   for(i = 0; i < size; i++) {
     memSection[i] = rb();
   }
@@ -825,7 +749,7 @@ bool Filser::getLoggerData(unsigned char *memSection, int sectionSize)
     }
     int count = ((unsigned char)memSection[2 * i] << 8) + (unsigned char)memSection[(2 * i) + 1];
 
-    tcflush(portID, TCIOFLUSH);
+    _serial.flush();
     wb(STX);
     wb(f + i);
     while ((bufP - bufP2) < (count + 1)) {
@@ -1530,7 +1454,7 @@ unsigned char Filser::calcCrcBuf(const void *buf, unsigned int count)
 unsigned char *Filser::readData(unsigned char *bufP, int count)
 {
   int rc;
-  switch (rc = read(portID, bufP, count)) {
+  switch (rc = _serial.read(bufP, count, READ_TIMEOUT)) {
   case -1:
     qWarning("read_data(): ERROR");
     break;
@@ -1545,7 +1469,7 @@ unsigned char *Filser::readData(unsigned char *bufP, int count)
 unsigned char *Filser::writeData(unsigned char *bufP, int count)
 {
   int rc;
-  switch (rc = write(portID, bufP, count))
+  switch (rc = _serial.write(bufP, count))
   {
   case -1:
     qWarning("write_data(): ERROR");
@@ -1569,7 +1493,7 @@ bool Filser::readMemSetting()
     return false;
   }
 
-  tcflush(portID, TCIOFLUSH);
+  _serial.flush();
 
   wb(STX);
   wb(Q);
@@ -1628,18 +1552,18 @@ bool Filser::AutoBaud()
 
   t1 = time(0);
   while (!breakTransfer) {
-    tcflush(portID, TCIOFLUSH); // Make sure the next ACK comes from the
-                                // following wb(SYN). And remove the
-                                // position data, that might have been
-                                // arrived.
+    _serial.flush(); // Make sure the next ACK comes from the
+                     // following wb(SYN). And remove the
+                     // position data, that might have been
+                     // arrived.
     wb(SYN);
-    tcdrain (portID);
+    _serial.drain();
 
     while(0xff != rb())       // 12.03.2005 Fughe: Make the stream really
       lc++;                   //                   empty!
     qWarning ("while _AB: %d", lc);
     wb(SYN);
-    tcdrain (portID);
+    _serial.drain();
 
     int ret = rb();
     if (ret == ACK) {
@@ -1669,8 +1593,6 @@ bool Filser::AutoBaud()
     else if(autobaud >=  4800) { autobaud =  2400; autospeed = B4800; }
     else                       { autobaud = 38400; autospeed = B2400; }
 
-    cfsetospeed(&newTermEnv, autospeed);
-    cfsetispeed(&newTermEnv, autospeed);
     if (_speed != autospeed)
     {
       _speed = autospeed;
@@ -1702,7 +1624,7 @@ bool Filser::AutoBaud()
       }
     }
 
-    tcsetattr(portID, TCSANOW, &newTermEnv);
+    _serial.setSpeed( autospeed );
 
   }
   return rc;
@@ -1733,18 +1655,18 @@ bool Filser::check4Device()
 
   t1 = time(0);
   while (!breakTransfer) {
-    tcflush(portID, TCIOFLUSH); // Make sure the next ACK comes from the
-                                // following wb(SYN). And remove the
-                                // position data, that might have been
-                                // arrived.
+    _serial.flush(); // Make sure the next ACK comes from the
+                     // following wb(SYN). And remove the
+                     // position data, that might have been
+                     // arrived.
     wb(SYN);
-    tcdrain (portID);
+    _serial.drain();
 
     while(0xff != rb())         // 12.03.2005 Fughe: Make the stream really
       lc++;                     //                   empty!
     qWarning ("while c4d: %d", lc);
     wb(SYN);
-    tcdrain (portID);
+    _serial.drain();
 
     int ret = rb();
     if (ret == ACK) {
@@ -1819,7 +1741,7 @@ bool Filser::check4Device()
 int Filser::wb(unsigned char c)
 {
   // qDebug ("wb (%x)", c);
-  if( write( portID, &c, 1 ) != 1 )
+  if( ! _serial.writeByte( c ) )
     {
       return -1;
     }
@@ -1836,7 +1758,7 @@ unsigned char Filser::rb()
 {
   unsigned char buf;
 
-  if( read( portID, &buf, 1 ) != 1 )
+  if( ! _serial.readByte( buf, READ_TIMEOUT ) )
     {
       return 0xff;
     }
@@ -1860,14 +1782,24 @@ char *Filser::wordtoserno(unsigned int Binaer)
   return Seriennummer;
 }
 
+void Filser::setKeepAlive(const bool active)
+{
+  if( active && _isConnected )
+    {
+      _keepalive->start (1000); // one second timer
+    }
+  else
+    {
+      _keepalive->stop();
+    }
+}
+
 int Filser::closeRecorder()
 {
-  if( portID != -1 )
+  if( _serial.isOpen() )
     {
       _keepalive->stop();
-      tcsetattr( portID, TCSANOW, &oldTermEnv );
-      close( portID );
-      portID = -1;
+      _serial.close();
       _isConnected = false;
       _da4BufferValid = false;
       return FR_OK;
@@ -2065,7 +1997,7 @@ int Filser::readDA4Buffer()
 
   _errorinfo = "";
 
-  tcflush( portID, TCIOFLUSH );
+  _serial.flush();
 
   wb( STX );
   wb( R );
@@ -2147,7 +2079,7 @@ int Filser::writeDA4Buffer()
 
   _errorinfo = "";
 
-  tcflush(portID, TCIOFLUSH);
+  _serial.flush();
 
   wb(STX);
   wb(W);
@@ -2164,7 +2096,7 @@ int Filser::writeDA4Buffer()
   wb (crc);
 
   // wait until all output has been written
-  tcdrain(portID);
+  _serial.drain();
   int result = rb();
 
   if( result == ACK )
@@ -102,6 +102,10 @@ public:
    * Closes the connection with the flight recorder.
    */
   virtual int closeRecorder();
+  /**
+   * Stops or restarts the keep alive timer of the connection.
+   */
+  virtual void setKeepAlive(const bool active);
   /**
    * Write flight declaration to recorder
    */
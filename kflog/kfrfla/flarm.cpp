@@ -49,30 +49,8 @@
 // for the flarmcfg file we need DOS line feeds
 #define ENDL "\r\n"
 
-/**
- * The device-name of the port.
- */
-const char* portName = "\0";
-int portID = -1;
-
-/**
- * holds the port-settings at start of the application
- */
-struct termios oldTermEnv;
-
-/**
- * is used to change the port-settings
- */
-struct termios newTermEnv;
-
-/**
- * Needed to reset the serial port in any case of unexpected exiting
- * of the program. Called via signal-handler of the runtime-environment.
- */
-void releaseTTY(int /* signal*/)
-{
-  tcsetattr(portID, TCSANOW, &oldTermEnv);
-}
+// Timeout of a serial read of a NMEA sentence in milliseconds
+#define READ_TIMEOUT  1000
 
 Flarm::Flarm( QObject *parent ) : FlightRecorderPluginBase( parent ),
   _speed(B0)
@@ -112,9 +90,6 @@ Flarm::Flarm( QObject *parent ) : FlightRecorderPluginBase( parent ),
   _capabilities.supDspCompetitionID = true;
   _capabilities.supAutoSpeed = true;       //supports automatic transfer speed detection
   //End set capabilities.
-
-  portID = -1;
-
 }
 
 Flarm::~Flarm()
@@ -145,17 +120,16 @@ int Flarm::getFlightDir( QList<FRDirEntry *>* dirList )
   * The Flarm documentation does not recommend to parse this information.
   * However, this is the only means to read serial # and device type
   */
-QString Flarm::getFlarmDebug (QFile& file) {
+QString Flarm::getFlarmDebug () {
   QString str = "$PFLAS,R*";
   ushort cs = calcCheckSum (str.length(), str);
   QString ccs = QString ("%1").arg (cs, 2, 16, QChar('0'));
   QString sentence = str + ccs + ENDL;
   qDebug () << "getFlarmDebug cmd: " << sentence << endl;
-  file.write (sentence.toLatin1().constData(), sentence.length());
-  file.flush();
+  _serial.write (sentence.toLatin1());
     
   for (int i=0; i<10;i++){
-    QString bytes = file.readLine();
+    QString bytes = _serial.readLine (READ_TIMEOUT);
     qDebug () << "debug: " << bytes;
     if (bytes.contains ("Build"))
       return bytes;
@@ -164,16 +138,15 @@ QString Flarm::getFlarmDebug (QFile& file) {
 }
 
 
-QString Flarm::getFlarmData (QFile& file, const QString& cmd, const QString& key) {
+QString Flarm::getFlarmData (const QString& cmd, const QString& key) {
   QString str = cmd + ",R," + key + "*";
   ushort cs = calcCheckSum (str.length(), str);
   QString ccs = QString ("%1").arg (cs, 2, 16, QChar('0'));
   QString sentence = str + ccs + ENDL;
   qDebug () << "getFlarmData cmd: " << sentence << endl;
-  file.write (sentence.toLatin1().constData(), sentence.length());
-  file.flush();
+  _serial.write (sentence.toLatin1());
     
-  QString bytes = file.readLine();
+  QString bytes = _serial.readLine (READ_TIMEOUT);
   //sometimes some other sentences come inbetween
   QTime t1 = QTime::currentTime ();
   while (!bytes.startsWith (cmd + ",A,")) {
@@ -182,7 +155,7 @@ QString Flarm::getFlarmData (QFile& file, const QString& cmd, const QString& key
       return "";
     }
     qDebug () << "ignored bytes: " << bytes << endl;
-    bytes = file.readLine();
+    bytes = _serial.readLine (READ_TIMEOUT);
   }
   qDebug () << "answer: " << bytes;
 
@@ -206,7 +179,7 @@ QString Flarm::getFlarmData (QFile& file, const QString& cmd, const QString& key
   }
 }
 
-bool Flarm::putFlarmData (QFile& file, const QString& cmd, const QString& key, const QString& data1, const QString& data2, const QString& data3) {
+bool Flarm::putFlarmData (const QString& cmd, const QString& key, const QString& data1, const QString& data2, const QString& data3) {
   QString str = cmd + ",S," + key;
   if (data1 != NULL)
     str += "," + data1;
@@ -219,10 +192,9 @@ bool Flarm::putFlarmData (QFile& file, const QString& cmd, const QString& key, c
   QString ccs = QString ("%1").arg (cs, 2, 16, QChar('0'));
   QString sentence = str + ccs + ENDL;
   qDebug () << "putFlarmData cmd: " << sentence << endl;
-  file.write (sentence.toLatin1().constData(), sentence.length());
-  file.flush();
+  _serial.write (sentence.toLatin1());
 
-  QString bytes = file.readLine();
+  QString bytes = _serial.readLine (READ_TIMEOUT);
   //sometimes some other sentences come inbetween
   QTime t1 = QTime::currentTime();
   while (!bytes.startsWith (cmd + ",A,")) {
@@ -232,7 +204,7 @@ bool Flarm::putFlarmData (QFile& file, const QString& cmd, const QString& key, c
       return false;
     }
     qDebug () << "ignored bytes: " << bytes << endl;
-    bytes = file.readLine();
+    bytes = _serial.readLine (READ_TIMEOUT);
   }
   qDebug () << "putFlarmData answer: " << bytes << endl;
 
@@ -267,20 +239,17 @@ int Flarm::getBasicData(FR_BasicData& data)
     return FR_ERROR;
   }
 
-  QFile file;
-  file.open (portID, QIODevice::ReadWrite);
-  
-  data.pilotName     = getFlarmData (file, "$PFLAC","PILOT");
-  data.copilotName   = getFlarmData (file, "$PFLAC","COPIL");
-  data.gliderType    = getFlarmData (file, "$PFLAC","GLIDERTYPE");
-  data.gliderID      = getFlarmData (file, "$PFLAC","GLIDERID");
-  data.competitionID = getFlarmData (file, "$PFLAC","COMPID");
+  data.pilotName     = getFlarmData ("$PFLAC","PILOT");
+  data.copilotName   = getFlarmData ("$PFLAC","COPIL");
+  data.gliderType    = getFlarmData ("$PFLAC","GLIDERTYPE");
+  data.gliderID      = getFlarmData ("$PFLAC","GLIDERID");
+  data.competitionID = getFlarmData ("$PFLAC","COMPID");
   // this delivers always 0xFFFFFF; we get device id from debug info
-  // data.devID  = getFlarmData (file, "$PFLAC","ID");
-  data.swVersion     = getFlarmData (file, "$PFLAV","");
+  // data.devID  = getFlarmData ("$PFLAC","ID");
+  data.swVersion     = getFlarmData ("$PFLAV","");
   qDebug () << "Version: " << data.swVersion << endl;
   
-  QStringList debug  = getFlarmDebug (file).split (",");
+  QStringList debug  = getFlarmDebug ().split (",");
   data.recorderType  = debug[0];
   data.serialNumber  = debug[1];
   data.dvcID         = debug[2];
@@ -305,19 +274,16 @@ int Flarm::writeConfigData(FR_BasicData& data, FR_ConfigData& /*configdata*/)
   if (!check4Device()) {
     return FR_ERROR;
   }
-  
-  QFile file;
-  file.open (portID, QIODevice::ReadWrite);
 
-  if (!putFlarmData (file, "$PFLAC", "PILOT", data.pilotName))
+  if (!putFlarmData ("$PFLAC", "PILOT", data.pilotName))
     return FR_ERROR;
-  if (!putFlarmData (file, "$PFLAC", "COPIL", data.copilotName))
+  if (!putFlarmData ("$PFLAC", "COPIL", data.copilotName))
     return FR_ERROR;
-  if (!putFlarmData (file, "$PFLAC", "GLIDERTYPE", data.gliderType))
+  if (!putFlarmData ("$PFLAC", "GLIDERTYPE", data.gliderType))
     return FR_ERROR;
-  if (!putFlarmData (file, "$PFLAC", "GLIDERID", data.gliderID))
+  if (!putFlarmData ("$PFLAC", "GLIDERID", data.gliderID))
     return FR_ERROR;
-  if (!putFlarmData (file, "$PFLAC", "COMPID", data.competitionID))
+  if (!putFlarmData ("$PFLAC", "COMPID", data.competitionID))
     return FR_ERROR;
 
   return FR_OK;
@@ -332,71 +298,17 @@ int Flarm::downloadFlight(int /*flightID*/, int /*secMode*/, const QString& /*fi
 
 int Flarm::openRecorder(const QString& pName, int baud)
 {
-  portName = pName.toLatin1().data();
-
-  portID = open(portName, O_RDWR | O_NOCTTY);
-
-  if(portID != -1) {
-    //
-    // Before we change any port-settings, we must establish a
-    // signal-handler, which is used to restore the port-settings
-    // after terminating the program.
-    // Because a SIGKILL-signal removes the program immediately,
-    // the status of the port will be undefined.
-    //
-    struct sigaction sact;
-
-    sact.sa_handler = releaseTTY;
-    sigaction(SIGHUP, &sact, NULL);
-    sigaction(SIGINT, &sact, NULL);
-    sigaction(SIGPIPE, &sact, NULL);
-    sigaction(SIGTERM, &sact, NULL);
-
-    /*
-     * Set the terminal mode of the serial line
-     */
-
-    // reading the current port-settings
-    tcgetattr(portID, &newTermEnv);
-
-    // storing the port-settings to restore them ...
-    oldTermEnv = newTermEnv;
-
-    /*
-     * Do some common settup
-     */
-    newTermEnv.c_iflag = IGNPAR;
-    newTermEnv.c_iflag &= ~(IGNBRK | BRKINT | PARMRK | ISTRIP | INLCR | IGNCR | ICRNL | IXON);
-    newTermEnv.c_oflag &= ~OPOST;
-    newTermEnv.c_oflag |= ONLCR;
-    newTermEnv.c_lflag &= ~(ECHO | ECHONL | ICANON | ISIG | IEXTEN);
-    /*
-     * No flow control at all :-(
-     */
-    newTermEnv.c_cflag &= ~(CSIZE | PARENB | CSTOPB | CRTSCTS | IXON | IXOFF);
-    newTermEnv.c_cflag |= (CS8 | CLOCAL | CREAD);
-
-    // control characters
-    newTermEnv.c_cc[VMIN] = 0; // don't wait for a character
-    newTermEnv.c_cc[VTIME] = 1; // wait at least 1 msec.
-
 //  4800 - 57600 bps
 //  These are the only speeds known by Flarm devices
 //  Taken from Data port Specification
-    if (baud >= 57600)     _speed = B57600;
-    else if(baud >= 38400) _speed = B38400;
-    else if(baud >= 19200) _speed = B19200;
-    else if(baud >=  9600) _speed = B9600;
-    else                   _speed = B4800;
-
-    cfsetospeed(&newTermEnv, _speed);
-    cfsetispeed(&newTermEnv, _speed);
-
-    // flush the device
-    tcflush (portID, TCIOFLUSH);
-    // Activating the port-settings
-    tcsetattr(portID, TCSANOW, &newTermEnv);
-
+  if (baud >= 57600)     _speed = B57600;
+  else if(baud >= 38400) _speed = B38400;
+  else if(baud >= 19200) _speed = B19200;
+  else if(baud >=  9600) _speed = B9600;
+  else                   _speed = B4800;
+
+  // No flow control at all :-(
+  if( _serial.open( pName, _speed ) ) {
     _isConnected = true;
     //_da4BufferValid = false;
 
@@ -463,16 +375,20 @@ bool Flarm::AutoBaud()
 
   QTime t1 = QTime::currentTime();
   while (true) {
-    tcflush(portID, TCIOFLUSH);
+    _serial.flush();
+
+    QRegExp typical ("^\\$PFLAU|^\\$GPGGA|^\\$PGRMZ|^\\$GPRMC");
+
+    QString bytes = _serial.readLine (READ_TIMEOUT);
+
+    // the first line after the flush can be the rest of a sentence
+    if (!bytes.contains (typical))
+      bytes = _serial.readLine (READ_TIMEOUT);
 
-    QFile file;
-    file.open (portID, QIODevice::ReadOnly);
-    
-    QString bytes = file.readLine();
     qDebug () << "bytes: " << bytes;
 
     // check for some typical sentences
-    if (bytes.contains (QRegExp("^\\$PFLAU|^\\$GPGGA|^\\$PGRMZ|^\\$GPRMC"))) {
+    if (bytes.contains (typical)) {
       break;
     }
     else {
@@ -497,8 +413,6 @@ bool Flarm::AutoBaud()
     else if(autobaud >=  9600) { autobaud =  4800; autospeed = B9600; }
     else                       { autobaud = 57600; autospeed = B4800; }
 
-    cfsetospeed(&newTermEnv, autospeed);
-    cfsetispeed(&newTermEnv, autospeed);
     if (_speed != autospeed)
     {
       _speed = autospeed;
@@ -529,7 +443,7 @@ bool Flarm::AutoBaud()
       }
     }
 
-    tcsetattr(portID, TCSANOW, &newTermEnv);
+    _serial.setSpeed (autospeed);
 
   }
   return true;
@@ -542,12 +456,9 @@ bool Flarm::AutoBaud()
 bool Flarm::check4Device()
 {
   _errorinfo = "";
-  
-  QFile file;
-  file.open (portID, QIODevice::ReadWrite);
 
   // self test
-  QString result = getFlarmData (file, "$PFLAE","");
+  QString result = getFlarmData ("$PFLAE","");
   if (result.isEmpty()) {
     _errorinfo = tr("No response from flarm device!\n");
     return false;
@@ -563,11 +474,9 @@ bool Flarm::check4Device()
 
 int Flarm::closeRecorder()
 {
-  if( portID != -1 )
+  if( _serial.isOpen() )
     {
-      tcsetattr( portID, TCSANOW, &oldTermEnv );
-      close( portID );
-      portID = -1;
+      _serial.close();
       _isConnected = false;
       return FR_OK;
     }
@@ -618,53 +527,50 @@ int Flarm::writeDeclaration(FRTaskDeclaration* decl, QList<Waypoint*>* wpList, c
     qDebug() << "Flarm::writeDeclaration" << endl;
     if (!check4Device())
       return FR_ERROR;
-      
-    QFile file;
-    file.open (portID, QIODevice::ReadWrite);
 
     // deactivated competition mode
-    if (!putFlarmData (file, "$PFLAC", "CFLAGS", "0"))
+    if (!putFlarmData ("$PFLAC", "CFLAGS", "0"))
       return FR_ERROR;
 
     // deaktivated Stealth mode"
-    if (!putFlarmData (file, "$PFLAC", "PRIV", "0"))
+    if (!putFlarmData ("$PFLAC", "PRIV", "0"))
       return FR_ERROR;
 
     // aircraft type;  1 = glider
-    if (!putFlarmData (file, "$PFLAC", "ACFT", "1"))
+    if (!putFlarmData ("$PFLAC", "ACFT", "1"))
       return FR_ERROR;
 
     // Pilot name
-    if (!putFlarmData (file, "$PFLAC", "PILOT", decl->pilotA))
+    if (!putFlarmData ("$PFLAC", "PILOT", decl->pilotA))
       return FR_ERROR;
 
     // Copilot name
-    if (!putFlarmData (file, "$PFLAC", "COPIL", decl->pilotB))
+    if (!putFlarmData ("$PFLAC", "COPIL", decl->pilotB))
       return FR_ERROR;
 
     // Glider type
-    if (!putFlarmData (file, "$PFLAC", "GLIDERTYPE", decl->gliderType))
+    if (!putFlarmData ("$PFLAC", "GLIDERTYPE", decl->gliderType))
       return FR_ERROR;
 
     // Aircraft registration
-    if (!putFlarmData (file, "$PFLAC", "GLIDERID", decl->gliderID))
+    if (!putFlarmData ("$PFLAC", "GLIDERID", decl->gliderID))
       return FR_ERROR;
 
     // Competition ID
-    if (!putFlarmData (file, "$PFLAC", "COMPID", decl->compID))
+    if (!putFlarmData ("$PFLAC", "COMPID", decl->compID))
       return FR_ERROR;
 
     // Competition Class
-    if (!putFlarmData (file, "$PFLAC", "COMPCLASS", decl->compClass))
+    if (!putFlarmData ("$PFLAC", "COMPCLASS", decl->compClass))
       return FR_ERROR;
 
     //TODO: make configurable?
     // Logger interval
-    if (!putFlarmData (file, "$PFLAC", "LOGINT", "4"))
+    if (!putFlarmData ("$PFLAC", "LOGINT", "4"))
       return FR_ERROR;
 
     // Task declaration
-    if (!putFlarmData (file, "$PFLAC","NEWTASK", name))
+    if (!putFlarmData ("$PFLAC","NEWTASK", name))
       return FR_ERROR;
 
     int wpCnt = 0;
@@ -677,7 +583,7 @@ int Flarm::writeDeclaration(FRTaskDeclaration* decl, QList<Waypoint*>* wpList, c
             break;
 
         // qDebug ("wp: %s", wp->name.toLatin1().constData());
-        if (!putFlarmData (file, "$PFLAC", "ADDWP", lat2flarm(wp->origP.lat()), lon2flarm(wp->origP.lon()), wp->name))
+        if (!putFlarmData ("$PFLAC", "ADDWP", lat2flarm(wp->origP.lat()), lon2flarm(wp->origP.lon()), wp->name))
           return FR_ERROR;
     }
 
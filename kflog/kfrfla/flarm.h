@@ -153,9 +153,9 @@ private:
   void sendStreamComment (QTextStream& stream, const QString& comment);
   void sendStreamData (QTextStream& stream, const QString& sentence);
   int sendStreamData (QTextStream& stream, FRTaskDeclaration* decl, QList<Waypoint*>* wpList, const QString& name);
-  QString getFlarmDebug(QFile&);
-  QString getFlarmData(QFile&, const QString&, const QString&);
-  bool putFlarmData(QFile&, const QString& cmd, const QString& key, const QString& data1=NULL, const QString& data2=NULL, const QString& data3=NULL);
+  QString getFlarmDebug();
+  QString getFlarmData(const QString&, const QString&);
+  bool putFlarmData(const QString& cmd, const QString& key, const QString& data1=NULL, const QString& data2=NULL, const QString& data3=NULL);
   QString lat2flarm (int);
   QString lon2flarm (int);
 
@@ -61,6 +61,7 @@ protected:
   VLA_ERROR serial_close_port();
   VLA_ERROR serial_set_baudrate(const int32 baudrate);
   VLA_ERROR serial_out(const byte outbyte);
+  VLA_ERROR serial_out(const byte *data, const int32 count);
 	VLA_ERROR serial_in(byte *inbyte);
 	VLA_ERROR serial_empty_io_buffers();
 
@@ -118,8 +119,8 @@ protected:
   int16 sendcommand(byte cmd, byte param1, byte param2);
   // wait for acknowledgement of command (if no data is expected)
   int16 wait4ack();
-  // read block of data from VL, with flow-control
-  int32 readlog(lpb puffer, int32);
+  // read block of data from VL, with flow-control, into puffer or sink
+  int32 readlog(lpb puffer, int32, VLA_SINK *sink = 0);
 
   VLA_XFR();
   void set_databaud(int32 db);
@@ -136,7 +137,8 @@ protected:
   // read all binary flight logs from VL
   VLA_ERROR all_logsget(lpb dbbbuffer, int32 dbbsize);
   // read one binary flight log from VL
-  int32 flightget(lpb buffer, int32 buffersize, int16 flightnr, int16 secmode);
+  int32 flightget(lpb buffer, int32 buffersize, int16 flightnr, int16 secmode,
+                  VLA_SINK *sink = 0);
   VLA_ERROR readdir(lpb buffer, int32 buffersize);
 };
 
@@ -197,19 +197,24 @@ int16 VLA_XFR::wait4ack() {
 
 // read a big data packet from the VL after requesting it with a command
 // via sendcommand. Read a maximum of maxlen characters (excluding CRC)
+// into puffer or pass them to the sink, as soon as they are known not to
+// be part of the CRC. In that case puffer may be 0.
 //
-int32 VLA_XFR::readlog(lpb puffer, int32 maxlen) {
+int32 VLA_XFR::readlog(lpb puffer, int32 maxlen, VLA_SINK *sink) {
   int32 gcs_counter = 0;
   byte  c;
   int16 dle_r = 0;
   word crc16  = 0;
   int16 start = 0;
   int16 ende  = 0;
+  int16 data;
+  byte  lag[2]; // the last two characters could be the CRC
   lpb p;
   int pp = 0; 
   progress_reset();
 
-  memset(puffer, 0xff, maxlen);
+  if (puffer)
+    memset(puffer, 0xff, maxlen);
 //   for(i=0; i<maxlen; i++) 
 //     puffer[i] = 0xff;
 
@@ -233,6 +238,7 @@ int32 VLA_XFR::readlog(lpb puffer, int32 maxlen) {
     }
     // oder aber das empfangene Zeichen wird ausgewertet
     else {      //printf("%02x",c);
+      data = 0;
       switch (c) {
       case DLE: 
         if (dle_r == 0) {             //!DLE, DLE -> Achtung!
@@ -240,22 +246,12 @@ int32 VLA_XFR::readlog(lpb puffer, int32 maxlen) {
         }
         else { 	                 // DLE, DLE -> DLE-Zeichen
           dle_r = 0;
-          if (start) {
-            if(gcs_counter < maxlen)
-              *p++ = c;
-            gcs_counter++;
-            crc16 = UpdateCRC(c,crc16);
-          }
+          data = 1;
         }
         break;
       case ETX: 
         if (dle_r == 0) {             //!DLE, ETX -> Zeichen
-          if (start) {
-            if(gcs_counter < maxlen)
-              *p++ = c;
-            gcs_counter++;
-            crc16 = UpdateCRC(c,crc16);
-          };
+          data = 1;
         }
         else {
           if (start==1) {
@@ -266,12 +262,7 @@ int32 VLA_XFR::readlog(lpb puffer, int32 maxlen) {
         break;
       case STX: 
         if (dle_r == 0) {	         //!DLE, STX -> Zeichen
-          if (start) {
-            if(gcs_counter < maxlen)
-              *p++ = c;
-            gcs_counter++;
-            crc16 = UpdateCRC(c,crc16);
-          }
+          data = 1;
         }
         else {
           start = 1;           // DLE, STX -> Blockstart
@@ -281,14 +272,21 @@ int32 VLA_XFR::readlog(lpb puffer, int32 maxlen) {
         }
         break;
       default: 
-        if (start) {
-          if(gcs_counter < maxlen)
-            *p++ = c;
-          gcs_counter++;
-          crc16 = UpdateCRC(c,crc16);
-        }
+        data = 1;
         break;
       }
+      if (data && start) {
+        if (sink) {
+          // pass the character received two characters before
+          if (gcs_counter >= 2)
+            sink->put(lag[gcs_counter & 1]);
+          lag[gcs_counter & 1] = c;
+        }
+        else if(gcs_counter < maxlen)
+          *p++ = c;
+        gcs_counter++;
+        crc16 = UpdateCRC(c,crc16);
+      }
     }
   }
   wait_ms(100);
@@ -303,14 +301,16 @@ int32 VLA_XFR::readlog(lpb puffer, int32 maxlen) {
   }
   else if (gcs_counter > 2) {              //CRC am Ende abschneiden
     gcs_counter -= 2;
-    p--;
-    p--;
-    if (gcs_counter < maxlen)
-      p[0] = 0xff;
-    if (gcs_counter+1 < maxlen)
-      p[1] = 0xff;
-    p++;
-    p++;
+    if (!sink) {
+      p--;
+      p--;
+      if (gcs_counter < maxlen)
+        p[0] = 0xff;
+      if (gcs_counter+1 < maxlen)
+        p[1] = 0xff;
+      p++;
+      p++;
+    }
   }
   else {
     show(VLS_TXT_EMPTY);
@@ -351,12 +351,16 @@ VLA_ERROR VLA_XFR::dbbput(lpb dbbbuffer, int32 dbbsize) {
   crc16 = 0;
   step = dbbsize / 400;
 
-  for(i=0; i<dbbsize; i++) {
-    c = dbbbuffer[i];
-    crc16 = UpdateCRC(c,crc16);
-    serial_out(c);
-    if((i%step)==0) 
-      progress_set(VLS_TXT_WDB);
+  if (step < 1)
+    step = 1;
+
+  // Die Datenbank wird blockweise geschrieben, ein Block je Fortschrittsschritt
+  for(i=0; i<dbbsize; i+=step) {
+    int32 n = (dbbsize - i < step) ? dbbsize - i : step;
+    for(int32 j=0; j<n; j++)
+      crc16 = UpdateCRC(dbbbuffer[i+j],crc16);
+    serial_out(dbbbuffer+i, n);
+    progress_set(VLS_TXT_WDB);
   }
 
   serial_out(crc16/256);
@@ -428,7 +432,7 @@ VLA_ERROR VLA_XFR::all_logsget(lpb dbbbuffer, int32 dbbsize) {
   Auslesen des Fluges flightnumber im Sicherheitslevel secmode,
   Abspeichern als GCS-Datei im Speicher
 */
-long VLA_XFR::flightget(lpb buffer, int32 buffersize, int16 flightnr, int16 secmode) {
+long VLA_XFR::flightget(lpb buffer, int32 buffersize, int16 flightnr, int16 secmode, VLA_SINK *sink) {
   long groesse = 0;
   long sgr = 0;
 
@@ -445,7 +449,7 @@ long VLA_XFR::flightget(lpb buffer, int32 buffersize, int16 flightnr, int16 secm
 
   serial_set_baudrate(databaud); // DATA-Baudrate einstellen
 
-  groesse = readlog(buffer,buffersize);
+  groesse = readlog(buffer,buffersize,sink);
 	
   if (groesse <= 0)
     return 0;
@@ -458,7 +462,12 @@ long VLA_XFR::flightget(lpb buffer, int32 buffersize, int16 flightnr, int16 secm
   if (cret)
     return 0;
 
-  if ((sgr = readlog(buffer+groesse,buffersize-groesse))<=0)
+  if (sink)
+    sgr = readlog(0,0,sink);
+  else
+    sgr = readlog(buffer+groesse,buffersize-groesse);
+
+  if (sgr<=0)
     return 0;
 
   return groesse + sgr;
@@ -778,30 +787,26 @@ VLA_ERROR VLAPI::read_igcfile(char *filename, int index, int secmode) {
   FILE *outfile = fopen(filename,"wt");
   if(!outfile)
     return VLA_ERR_FILE;
-	
+
+  // the IGC-file is written in big blocks
+  setvbuf(outfile, 0, _IOFBF, 65536);
+
   VLA_ERROR err = stillconnect();
   if(err != VLA_ERR_NOERR) {
     fclose(outfile);
     return err;
   }
 
-  byte logbuffer[VLAPI_LOG_MEMSIZE];
-  if (flightget(logbuffer, sizeof(logbuffer), index, secmode)>0)
+  // the flight log is converted, while it is read from the logger
+  GCSCONV conv(0,outfile,1);
+  err = VLA_ERR_MISC;
+  if (flightget(0, 0, index, secmode, &conv)>0)
     err = VLA_ERR_NOERR;
 	
   word serno; long sp;
-  long r;
   if(err == VLA_ERR_NOERR) {
-    r = convert_gcs(0,outfile,logbuffer,1,&serno,&sp);
-    if(r>0) {
-      err = VLA_ERR_NOERR;
-      print_g_record(
-                     outfile,   // output to stdout
-                     logbuffer,		// binary file is in buffer
-                     r				  // length of binary file to include
-                     );
-    }
-    else
+    // write header, B-records and G-records
+    if(conv.finish(&serno,&sp) <= 0)
       err = VLA_ERR_MISC;
   }
   fclose(outfile);
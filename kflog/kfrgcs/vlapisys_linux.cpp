@@ -25,28 +25,22 @@
 #include <sys/stat.h>
 #include <fcntl.h>
 
-#include <csignal>
-#include <termios.h>
 #include <ctime>
 #include <unistd.h>
 
+#include <QString>
+
+#include "../serialtransport.h"
+
 using namespace std; 
 
 int noninteractive;
 
-/**
- * Needed to reset the serial port in any case of unexpected exiting
- * of the programm. Called via signal-handler of the runtime-environment.
- */
-void releaseTTY(int signal)
-{
-  extern int portID;
-  extern struct termios oldTermEnv;
+// Timeout of a serial read in milliseconds
+#define READ_TIMEOUT  100
 
-  cerr << "Logger-Connection: releaseTTY(" << signal << ")\n";
-  tcsetattr(portID, TCSANOW, &oldTermEnv);
-  exit(-1);
-}
+extern QString portName;
+extern SerialTransport* serialPort;
 
 /***********************************************************************
  *
@@ -67,134 +61,53 @@ int32 VLA_SYS::get_timer_s()  {  return time(NULL);  }
  */
 VLA_ERROR VLA_SYS::serial_open_port()
 {
-  extern char* portName;
-  extern int portID;
-  extern struct termios newTermEnv;
-  extern struct termios oldTermEnv;
-
-  /* eventuell als Mode zusaetzlich O_NONBLOCK ??? */
-  portID = open(portName, O_RDWR | O_NOCTTY);
-
-  if(portID == -1) {
-    return VLA_ERR_COMM;
-  }
-
-  //
-  // Before we change any port-settings, we must establish a
-  // signal-handler, which is used to restore the port-settings
-  // after terminating the programm.
-  //    Because a SIGKILL-signal removes the programm immediately,
-  // the status of the port will be undefined.
-  //
-  struct sigaction sact;
-
-  sact.sa_handler = releaseTTY;
-  sigaction(SIGHUP, &sact, NULL);
-  sigaction(SIGINT, &sact, NULL);
-  sigaction(SIGPIPE, &sact, NULL);
-  sigaction(SIGTERM, &sact, NULL);
-
-  ////////////////////////////////////////////////////////////////////////
-  //
-  // port-configuration
-  //
-
-  // reading the current port-settings
-  tcgetattr(portID, &newTermEnv);
-
-  // storing the port-settings to restore them ...
-  oldTermEnv = newTermEnv;
-
-  newTermEnv.c_cflag |= HUPCL; // (egal)
-
-  newTermEnv.c_iflag |= CREAD;   // (wichtig!)
-  newTermEnv.c_iflag |= CLOCAL;  // (wichtig!)
-  newTermEnv.c_iflag &= ~IGNCR;  // (wichtig!)
-  newTermEnv.c_iflag &= ~INLCR;  // (wichtig!)
-  newTermEnv.c_iflag &= ~ISTRIP; // (scheint egal zu sein ...)
-
-  newTermEnv.c_iflag |= CRTSCTS; // (scheint egal zu sein ...)
-
-  newTermEnv.c_iflag &= ~IGNBRK; //
-  newTermEnv.c_iflag &= ~BRKINT; // (Kombination der drei wichtig!)
-  newTermEnv.c_lflag &= ~IEXTEN; //
-
-  newTermEnv.c_iflag &= ~IGNPAR;  // (scheint egal zu sein ...)
-
-  newTermEnv.c_iflag &= ~IXOFF;   // (scheint egal zu sein ...)
-  newTermEnv.c_iflag &= ~IXANY;   // (scheint egal zu sein ...)
-
-  // Bytesize = 8
-  newTermEnv.c_cflag |= CS8;
-
-  // disable stop-bit
-  newTermEnv.c_cflag &= ~CSTOPB;
-
-  // enable raw-mode (diable canonical-mode)
-  newTermEnv.c_lflag &= ~ICANON;
-
-  // don't wait for a character
-  newTermEnv.c_cc[VMIN] = 0;
-
-  // wait at least 1 msec.
-  newTermEnv.c_cc[VTIME] = 1;
-
-  // no parity
-  newTermEnv.c_cflag &= ~PARENB;
-
-  // don't change newline (\n) in carriage-return (\r)
-  newTermEnv.c_iflag &= ~ICRNL;
-
-  // disable XON flow-control on output
-  newTermEnv.c_iflag &= ~IXON;
-
-  // disable implementation-defined output-processing
-  newTermEnv.c_oflag &= ~OPOST;
-
-  // don't interpret INTR, QUIT, SUSP or DSUSP
-  newTermEnv.c_lflag &= ~ISIG;
-
-  //
-  newTermEnv.c_lflag |= IEXTEN;
-
-  // echo input characters
-  newTermEnv.c_lflag &= ~ECHO;
-
-  // Activating the port-settings
-  tcsetattr(portID, TCSANOW, &newTermEnv);
+  if( serialPort == 0 || ! serialPort->open( portName, B9600 ) )
+    {
+      return VLA_ERR_COMM;
+    }
 
-  serial_set_baudrate(9600);
   return VLA_ERR_NOERR;
 }
 
 /** release serial port on normal exit */
 VLA_ERROR VLA_SYS::serial_close_port()
 {
-  extern int portID;
-  extern struct termios oldTermEnv;
-
-  if (portID == -1) {
-    return VLA_ERR_COMM;
-  }
-
-  tcsetattr(portID, TCSANOW, &oldTermEnv);
+  if( serialPort == 0 || ! serialPort->isOpen() )
+    {
+      return VLA_ERR_COMM;
+    }
 
+  serialPort->close();
   return VLA_ERR_NOERR;
 }
 
 /** serial output of single character to the VL */
 VLA_ERROR VLA_SYS::serial_out(const byte outbyte)
 {
-  extern int portID;
+  if( serialPort == 0 || ! serialPort->isOpen() )
+    {
+      return VLA_ERR_COMM;
+    }
 
-  if (portID == -1)
+  if( serialPort->writeByte( outbyte ) )
+    {
+      return VLA_ERR_NOERR;
+    }
+  else
     {
       return VLA_ERR_COMM;
     }
+}
 
-  int res = write(portID, &outbyte, sizeof(outbyte));
+/** buffered serial output of a block of characters to the VL */
+VLA_ERROR VLA_SYS::serial_out(const byte *data, const int32 count)
+{
+  if( serialPort == 0 || ! serialPort->isOpen() )
+    {
+      return VLA_ERR_COMM;
+    }
 
-  if( res < -1 )
+  if( serialPort->write( data, count ) == count )
     {
       return VLA_ERR_NOERR;
     }
@@ -211,23 +124,19 @@ VLA_ERROR VLA_SYS::serial_out(const byte outbyte)
  */
 VLA_ERROR VLA_SYS::serial_in(byte *inbyte)
 {
-  extern int portID;
-  if (portID == -1) {
-    return VLA_ERR_COMM;
-  }
+  if( serialPort == 0 || ! serialPort->isOpen() )
+    {
+      return VLA_ERR_COMM;
+    }
 
-  int res = read(portID, inbyte, sizeof(*inbyte));
-
-  if(res == 0) {
-    //  	  *inbyte = 0x03;
-    // Kein Zeichen empfangen!!!
-    //		  cerr << "\n Nichts gelesen !!!\n\n";
-    //      cerr << "Fehlercode: " << VLA_ERR_NOCHAR << " (sonst: " << VLA_ERR_NOERR << ")\n";
-    // Trotz dieses Rueckgabe-Codes bricht die aufrufende Funktion nicht ab!
-    // Eine "-1" kann die Funktion nicht zurueckliefern, da dies kein
-    // Element von VLA_ERROR ist :-(
-    return VLA_ERR_NOCHAR;		
-  }
+  if( ! serialPort->readByte( *inbyte, READ_TIMEOUT ) )
+    {
+      // Kein Zeichen empfangen!!!
+      // Trotz dieses Rueckgabe-Codes bricht die aufrufende Funktion nicht ab!
+      // Eine "-1" kann die Funktion nicht zurueckliefern, da dies kein
+      // Element von VLA_ERROR ist :-(
+      return VLA_ERR_NOCHAR;
+    }
 
   return VLA_ERR_NOERR;
 }
@@ -235,28 +144,22 @@ VLA_ERROR VLA_SYS::serial_in(byte *inbyte)
 /** clear serial input- and output-buffers */
 VLA_ERROR VLA_SYS::serial_empty_io_buffers()
 {
-  extern int portID;
-
-  if (portID == -1) {
-    return VLA_ERR_COMM;
-  }
-	
-  if(tcflush(portID, TCIOFLUSH) == -1) {
-    cerr << "\nERROR: could not empty buffer!\n";
-  }
+  if( serialPort == 0 || ! serialPort->isOpen() )
+    {
+      return VLA_ERR_COMM;
+    }
 
+  serialPort->flush();
   return VLA_ERR_NOERR;
 }
 
 /** set communication parameters */
 VLA_ERROR VLA_SYS::serial_set_baudrate(const int32 baudrate)
 {
-  extern struct termios newTermEnv;
-  extern int portID;
-
-  if (portID == -1) {
-    return VLA_ERR_COMM;
-  }
+  if( serialPort == 0 || ! serialPort->isOpen() )
+    {
+      return VLA_ERR_COMM;
+    }
 
   //
   ////////////////////////////////////////////////////////////////////////
@@ -286,10 +189,7 @@ VLA_ERROR VLA_SYS::serial_set_baudrate(const int32 baudrate)
     else if(baudrate >=   110) speed = B110;
     else speed = B75;
     
-    cfsetospeed(&newTermEnv, speed);
-    cfsetispeed(&newTermEnv, speed);
-    // Activating the port-settings
-    tcsetattr(portID, TCSANOW, &newTermEnv);
+    serialPort->setSpeed( speed );
   }
 
   return VLA_ERR_NOERR;
@@ -96,4 +96,12 @@ typedef int
 typedef byte *
   lpb;
 
+
+// receiver of the data bytes of a block, while it is read from the VL
+class VLA_SINK {
+ public:
+  virtual ~VLA_SINK() {}
+  virtual void put(byte b) = 0;
+};
+
 #endif
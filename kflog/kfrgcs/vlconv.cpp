@@ -33,6 +33,7 @@
 // VLAPI-Includes
 #include "vlconv.h"
 #include "vlapihlp.h"
+#include "grecord.h"
 
 // redeclaration of itoa()
 #include <utils.h>
@@ -390,8 +391,8 @@ int enllim(int enl) {
 
 
 /*
-Bin�ren Datenblock *bin_puffer in das IGC-Format umwandeln und in der
-Datei *Ausgabedatei speichern
+Bin�ren Datenblock, wie er vom Logger kommt, in das IGC-Format umwandeln
+und in der Datei *Ausgabedatei speichern
 
 
 Konvertierung erfolgt in 2 Phasen:
@@ -424,85 +425,166 @@ tnd  x     8  Zeit und Datum
   Ausgabedatei:
     Datei, in die das Ergebnis der Konvertierung (IGC-Datei) geschrieben
     wird
-  bin_puffer:
-    Zeiger auf den Speicherbereich, in dem die bin�re formatierte IGC-
-    Datei, so wie sie vom Logger kommt, liegt
   oo_fillin:
     ???
-  *serno:
-    Seriennummer des Loggers, aus dem die Datei stammt
-  *sp:
-    Position, an der die Signatur in der Bin�rdatei liegt
 
 */
 
 const int actual_conv_version = 424;
 
+// size of the window, in which the spooled records are converted
+const int spool_window = 4096;
 
-long convert_gcs(int igcfile_version, FILE *Ausgabedatei, lpb bin_puffer, int oo_fillin, word *serno, long *sp) {
- IGCHEADER igcheader;
- C_RECORD task;
- struct { // Alle Werte direkt aus Fix, vor Umwandlung
-   char time[10];
-   char valid;
-   long lat;
-   word latdeg;
-   word latmin;
-   long lon;
-   word londeg;
-   word lonmin;
-   word press;
-   word gpalt;
-   long pressure_alt;
-   long gps_alt;
-   word fxa;
-   word hdop;
-   word enl;
- } igcfix;
-
- int		l = 0;
- int		ende;
 
- long		time_relative = 0;  // relative Zeit vom Aufzeichnungsbeginn an
- long		temptime;
- long		decl_time;
- tm		firsttime;
- tm		realtime;
- byte		Haupttyp;
- byte		Untertyp;
- lpb		p;
- lpb		p2;
- long		pl;
- char		PILOT[40];
- int            tzh,tzm;
-// word           keysn;
- int            bfv = 0; // Bin�rdatenformat-Version
- long           delta_lat,delta_lon;
- // Zeitzone in Minuten aus Feld FDT
- int            tzn = 4000; // Ini-Wert zur Erkennung, ob es das Feld gab
- // aus Position berechnete Zeitzone
- float          ftz = 0;
- // Flag, ob ftz aus g�ltiger Position stammt
- int		tzset = 0;
+GCSCONV::GCSCONV(int igcfile_version, FILE *Ausgabedatei, int oo_fillin) {
+  if (igcfile_version == 0)
+    igcfile_version = actual_conv_version;
 
+  version = igcfile_version;
+  ausgabe = Ausgabedatei;
+  fillin  = oo_fillin;
 
- // long ggtz = timezone;
+  igcheader = new IGCHEADER;
+  igcheader->redirect(Ausgabedatei);
+  task = new C_RECORD;
 
-  if (igcfile_version == 0)
-    igcfile_version = actual_conv_version;
+  reclen = 0;
+  memset(rec, 0, sizeof rec);
 
-  igcfix.lat = 0;
-  igcfix.lon = 0;
+  ende = 0;
+  error = 0;
+  pl = 0;
+  spos = 0;
+  serial = 0;
 
-  //igcfile_version = 0;
-  igcheader.redirect(Ausgabedatei);
-  //task.init();
+  time_relative = 0;
   decl_time = -1;
+  memset(&firsttime, 0, sizeof firsttime);
+  bfv = 0;
+  tzn = 4000;
+  ftz = 0;
+  tzset = 0;
+  lon = 0;
 
-  ende = 0;
-  p = bin_puffer;
+  // the records and the G-records are spooled until the header is known
+  spool  = tmpfile();
+  gspool = tmpfile();
+
+  grecord = gspool ? new GRECORD(gspool) : 0;
+
+  if (!spool || !gspool)
+    error = ende = 1;
+}
+
+
+GCSCONV::~GCSCONV() {
+  delete grecord;
+  delete igcheader;
+  delete task;
+  if (spool)
+    fclose(spool);
+  if (gspool)
+    fclose(gspool);
+}
+
+
+/*
+Naechstes Byte der Binaerdatei uebernehmen. Sobald ein Datensatz
+vollstaendig ist, wird er ausgewertet, in die Spooldatei geschrieben und
+in den G-Record eingerechnet.
+*/
+void GCSCONV::put(byte b) {
+ int l;
+  if (ende)
+    return;
+
+  rec[reclen++] = b;
+
+  l = record_length();
+  if (l < 0)
+    // Datensatz noch unvollstaendig
+    return;
+
+  if (l > 0) {
+    scan(rec, l);
+    fwrite(rec, 1, l, spool);
+    for (int i=0; i<l; i++)
+      grecord->update(rec[i]);
+    pl += l;
+  }
+
+  // Reserve hinter dem Datensatz fuer die naechste Auswertung loeschen
+  memset(rec, 0, reclen);
+  reclen = 0;
+}
+
+
+/*
+Laenge des Datensatzes im Puffer bestimmen.
+  -1: Datensatz ist noch unvollstaendig
+   0: Ende der Binaerdatei, der Datensatz gehoert nicht mehr dazu
+*/
+int GCSCONV::record_length(void) {
+ int l;
+  switch (rec[0] & rectyp_msk) {
+    case rectyp_tnd :
+      l = 8;
+      break;
+    case rectyp_pos :
+    case rectyp_poc :
+      if (reclen < 3)
+	return -1;
+      if (rec[2] & 0x80) { // Endebedingung
+	ende = 1;
+	return 0;
+      }
+      l = pos_ds_size[bfv][(rec[0] & rectyp_msk) == rectyp_pos ? 0 : 1];
+      break;
+    case rectyp_sep :
+    case rectyp_fil :
+      l = 1;
+      break;
+    case rectyp_end :
+      l = 41;
+      break;
+    case rectyp_vrb :
+    case rectyp_vrt :
+      if (reclen < 2)
+	return -1;
+      l = rec[1];
+      // die Laenge umfasst mindestens Typ und Laengenbyte
+      if (l < 2) {
+	ende = 1;
+	return 0;
+      }
+      break;
+    default :
+      ende = 1;
+      return 0;
+  }
+
+  // ein Datensatz der Laenge 0 wuerde die Konvertierung nie beenden
+  if (l == 0) {
+    ende = 1;
+    return 0;
+  }
+
+  return (reclen < l) ? -1 : l;
+}
+
+
+/*
+Phase 1: HFxxx- und C-Records aus einem vollstaendigen Datensatz fuellen
+*/
+void GCSCONV::scan(lpb p, int l) {
+ long		temptime;
+ byte		Haupttyp;
+ byte		Untertyp;
+ lpb		p2;
+ char		PILOT[40];
+ char		valid;
+ long		delta_lon;
 
-  do {
     Haupttyp = p[0] & rectyp_msk;
     switch (Haupttyp) {
       case rectyp_tnd :
@@ -518,7 +600,7 @@ long convert_gcs(int igcfile_version, FILE *Ausgabedatei, lpb bin_puffer, int oo
 
 
 	// Y2K-patch
-	if(igcfile_version >= 424)
+	if(version >= 424)
 	  if(firsttime.tm_year < 80)
 	    firsttime.tm_year += 100;
 
@@ -527,50 +609,29 @@ long convert_gcs(int igcfile_version, FILE *Ausgabedatei, lpb bin_puffer, int oo
 	firsttime.tm_hour -= time_relative / 3600;
 	//xxxtime
 	mktime(&firsttime);
-	l = 8;
 	break;
-/*
-      case rectyp_pos : time_relative += p[2];
-			l = pos_ds_size[bfv][0];
-			break;
-      case rectyp_poc :	if(p[2] & 0x80) { // Endebedingung
-			  ende = 1;
-			  l = 0;
-			  break;
-			}
-			time_relative += p[2];
-			l = pos_ds_size[bfv][1];
-			break;
-*/
       case rectyp_pos :
-      case rectyp_poc :	if (p[2] & 0x80) { // Endebedingung
-			  ende = 1;
-			  l = 0;
-			  break;
-			}
-			time_relative += p[2];
-			igcfix.valid = ((p[0] & 0x10) >> 4) ? 'A' : 'V';
+      case rectyp_poc :	time_relative += p[2];
+			valid = ((p[0] & 0x10) >> 4) ? 'A' : 'V';
 			if (Haupttyp == rectyp_pos) {
-			  l = pos_ds_size[bfv][0];
-			  igcfix.lon   =   ((unsigned long)p[6] ) << 16
-					 | ((unsigned long)p[7] ) << 8
-					 | p[8];
+			  lon   =   ((unsigned long)p[6] ) << 16
+				  | ((unsigned long)p[7] ) << 8
+				  | p[8];
 			  if (p[9] & 0x80)
-			    igcfix.lon = -igcfix.lon;
+			    lon = -lon;
 			}
 			else {
-			  l = pos_ds_size[bfv][1];
 			  delta_lon = (((unsigned long)p[3] & 0x78) << 5) | p[5];
 			  if (p[6] & 0x80)
 			    delta_lon = -delta_lon;
-			  igcfix.lon += delta_lon;
+			  lon += delta_lon;
 			}
 			// ftz mit L�ngengrad f�llen
 			// der erste g�ltige ist der letzte,
 			// der in ftz gespeichert wird
 			if (!tzset) {
-			  ftz = float(igcfix.lon);
-			  if (igcfix.valid=='A')
+			  ftz = float(lon);
+			  if (valid=='A')
 			    tzset=1;
 			}
 			break;
@@ -578,39 +639,37 @@ long convert_gcs(int igcfile_version, FILE *Ausgabedatei, lpb bin_puffer, int oo
 			bfv = p[0] & ~rectyp_msk;
 			if (bfv > max_bfv) {
 			  // unsupported binary file version
-			  return 0;
+			  bfv = 0;
+			  error = 1;
+			  ende = 1;
 			}
-			l = 1;
-			break;
-      case 0xC0       : l = 1; // F�llzeichen
 			break;
-      case rectyp_end : *sp = (p-bin_puffer) + 1;
-			l = 41;
+      case rectyp_end : spos = pl + 1;
 			ende = 1;
 			break;
       case rectyp_vrb :
-      case rectyp_vrt : l = p[1];
-			switch(Haupttyp) {
+      case rectyp_vrt : switch(Haupttyp) {
 			  case rectyp_vrb : p2 = p+2; break;
 			  case rectyp_vrt : time_relative += p[2];
 					    p2 = p+3; break;
 			  default	  : p2 = p; break;
 			}
+			if (p2 >= p+l)
+			  break;
 			Untertyp = (p2[0]);
 			switch (Untertyp) {
 
 			  case FLDNTP :
-			    task.NTP = p2[1];
+			    task->NTP = p2[1];
 			    decl_time = time_relative;
 			    break;
 			  case FLDTID :
-			    task.TID = 256*p2[1] + p2[2];
-			    if (igcfile_version >= 422)
+			    task->TID = 256*p2[1] + p2[2];
+			    if (version >= 422)
 			      decl_time = time_relative;
 			    break;
 			  case FLDFDT :
-			    //_fmemcpy(&task.FDT,&p2[1],sizeof task.FDT);
-			    memcpy(&task.FDT,&p2[1],sizeof task.FDT);
+			    memcpy(&task->FDT,&p2[1],sizeof task->FDT);
 			    break;
 			  case FLDTZN :  // Zeitzonenoffset einlesen
 			    if (p2[1] < 128)
@@ -620,159 +679,156 @@ long convert_gcs(int igcfile_version, FILE *Ausgabedatei, lpb bin_puffer, int oo
 			    break;
 
 			  case FLDTKF :
-			    task.TKF.packed2unpacked(&p2[1]);
+			    task->TKF.packed2unpacked(&p2[1]);
 			    break;
 			  case FLDSTA :
-			    task.STA.packed2unpacked(&p2[1]);
+			    task->STA.packed2unpacked(&p2[1]);
 			    break;
 			  case FLDFIN :
-			    task.FIN.packed2unpacked(&p2[1]);
+			    task->FIN.packed2unpacked(&p2[1]);
 			    break;
 			  case FLDLDG :
-			    task.LDG.packed2unpacked(&p2[1]);
+			    task->LDG.packed2unpacked(&p2[1]);
 			    break;
 			  case FLDTP1 :
-			    task.TP[0].packed2unpacked(&p2[1]);
-			    break;
 			  case FLDTP2 :
-			    task.TP[1].packed2unpacked(&p2[1]);
-			    break;
 			  case FLDTP3 :
-			    task.TP[2].packed2unpacked(&p2[1]);
-			    break;
 			  case FLDTP4 :
-			    task.TP[3].packed2unpacked(&p2[1]);
-			    break;
 			  case FLDTP5 :
-			    task.TP[4].packed2unpacked(&p2[1]);
-			    break;
 			  case FLDTP6 :
-			    task.TP[5].packed2unpacked(&p2[1]);
-			    break;
 			  case FLDTP7 :
-			    task.TP[6].packed2unpacked(&p2[1]);
-			    break;
 			  case FLDTP8 :
-			    task.TP[7].packed2unpacked(&p2[1]);
-			    break;
 			  case FLDTP9 :
-			    task.TP[8].packed2unpacked(&p2[1]);
-			    break;
 			  case FLDTP10 :
-			    task.TP[9].packed2unpacked(&p2[1]);
-			    break;
 			  case FLDTP11 :
-			    task.TP[10].packed2unpacked(&p2[1]);
-			    break;
 			  case FLDTP12 :
-			    task.TP[11].packed2unpacked(&p2[1]);
+			    task->TP[Untertyp - FLDTP1].packed2unpacked(&p2[1]);
 			    break;
 
 			  case FLDPLT1 :  // Pilotenname einlesen
 			  case FLDPLT2 :  // Pilotenname einlesen
 			  case FLDPLT3 :  // Pilotenname einlesen
 			  case FLDPLT4 :  // Pilotenname einlesen
-//			    _fmemcpy(igcheader.PLT, &p2[1], (sizeof igcheader.PLT));
-//			    igcheader.PLT[(sizeof igcheader.PLT)-1] = 0;
-			    //_fmemcpy(PILOT, &p2[1], (sizeof PILOT));
 			    memcpy(PILOT, &p2[1], (sizeof PILOT));
 			    PILOT[(sizeof PILOT)-1] = 0;
-			    strcat(igcheader.PLT,PILOT);
-			    if (igcfile_version < 413) // war in alten Dateien so !
-			      strcat(igcheader.PLT," ");
+			    strcat(igcheader->PLT,PILOT);
+			    if (version < 413) // war in alten Dateien so !
+			      strcat(igcheader->PLT," ");
 			    break;
 			  case FLDGTY :  // Flugzeugtyp einlesen
-			    //_fmemcpy(igcheader.GTY, &p2[1], (sizeof igcheader.GTY));
-			    memcpy(igcheader.GTY, &p2[1], (sizeof igcheader.GTY));
-			    igcheader.GTY[(sizeof igcheader.GTY)-1] = 0;
+			    memcpy(igcheader->GTY, &p2[1], (sizeof igcheader->GTY));
+			    igcheader->GTY[(sizeof igcheader->GTY)-1] = 0;
 			    break;
 			  case FLDGID :  // Flugzeugkennzeichen einlesen
-			    //_fmemcpy(igcheader.GID, &p2[1], (sizeof igcheader.GID));
-			    memcpy(igcheader.GID, &p2[1], (sizeof igcheader.GID));
-			    igcheader.GID[(sizeof igcheader.GID)-1] = 0;
+			    memcpy(igcheader->GID, &p2[1], (sizeof igcheader->GID));
+			    igcheader->GID[(sizeof igcheader->GID)-1] = 0;
 			    break;
 			  case FLDCCL :  // Wettbewerbsklasse einlesen
-			    //_fmemcpy(igcheader.CCL, &p2[1], (sizeof igcheader.CCL));
-			    memcpy(igcheader.CCL, &p2[1], (sizeof igcheader.CCL));
-			    igcheader.CCL[(sizeof igcheader.CCL)-1] = 0;
+			    memcpy(igcheader->CCL, &p2[1], (sizeof igcheader->CCL));
+			    igcheader->CCL[(sizeof igcheader->CCL)-1] = 0;
 			    break;
 			  case FLDCID :  // Wettbewerbskennzeichen einlesen
-			    //_fmemcpy(igcheader.CID, &p2[1], (sizeof igcheader.CID));
-			    memcpy(igcheader.CID, &p2[1], (sizeof igcheader.CID));
-			    igcheader.CID[(sizeof igcheader.CID)-1] = 0;
+			    memcpy(igcheader->CID, &p2[1], (sizeof igcheader->CID));
+			    igcheader->CID[(sizeof igcheader->CID)-1] = 0;
 			    break;
 			  case FLDHDR :  // Seriennummer und anderes einlesen
-			    // Public-Key erst mal l�schen
-			    // 19.10.99 weggemacht, weil schon in main vorhanden
-			    //dsa_y_b[0] = 2; dsa_y_b[1] = 0;
-			    //memset(&dsa_y_b[2],0,(sizeof dsa_y_b)-2);
-
-					*serno = (256L*p2[1]+p2[2]);
+			    serial = (256L*p2[1]+p2[2]);
 
 			    // sonstiges einlesen
-			    strcpy(igcheader.A,wordtoserno(*serno));
+			    strcpy(igcheader->A,wordtoserno(serial));
 
-			    sprintf(igcheader.DTM,"%03u",p2[3]);
-			    sprintf(igcheader.RHW,"%0X.%0X",p2[4]>>4,(p2[4]&0xf));
-			    sprintf(igcheader.RFW,"%0X.%0X",p2[5]>>4,(p2[5]&0xf));
-			    sprintf(igcheader.FXA,"%03u",p2[7]);
+			    sprintf(igcheader->DTM,"%03u",p2[3]);
+			    sprintf(igcheader->RHW,"%0X.%0X",p2[4]>>4,(p2[4]&0xf));
+			    sprintf(igcheader->RFW,"%0X.%0X",p2[5]>>4,(p2[5]&0xf));
+			    sprintf(igcheader->FXA,"%03u",p2[7]);
 
 			    // neuer obligatorischer H-Record
-			    if (igcfile_version >= 421)
-			      sprintf(igcheader.FTY,"GARRECHT INGENIEURGESELLSCHAFT,VOLKSLOGGER 1.0");
+			    if (version >= 421)
+			      sprintf(igcheader->FTY,"GARRECHT INGENIEURGESELLSCHAFT,VOLKSLOGGER 1.0");
 			    break;
 			};
 			break;
-
-      default	      : ende = 1;
-			break;
     }
-    p += l;
-  } while (!ende);
-
-  pl = p - bin_puffer;
+}
 
 
-  // Zeitzone/Stunden = floor (LON+7.5�) / 15� des 1. g�ltigen Fixes
-  ftz = ftz + 450000L;
-  ftz = ftz / 900000L;
-  task.zz_min = int(60 * floor(ftz));
-//  printf("theoretische Zeitzone = UTC %-d min\n",task.zz_min);
-//  getch();
+/*
+Phase 2: Header und C-Records ausgeben, die gespoolten Datensaetze in
+B- und E-Records konvertieren und die G-Records anhaengen
+*/
+long GCSCONV::finish(word *serno, long *sp) {
+ int            tzh,tzm;
+ tm		realtime;
+ long		delta_lat,delta_lon;
+ struct { // Alle Werte direkt aus Fix, vor Umwandlung
+   char time[10];
+   char valid;
+   long lat;
+   word latdeg;
+   word latmin;
+   long lon;
+   word londeg;
+   word lonmin;
+   word press;
+   word gpalt;
+   long pressure_alt;
+   long gps_alt;
+   word fxa;
+   word hdop;
+   word enl;
+ } igcfix;
+ byte		window[spool_window];
+ int		wlen;
+ int		l;
+ byte		Haupttyp;
+ byte		Untertyp;
+ lpb		p;
+ lpb		p2;
 
+  // eine abgebrochene Binaerdatei wie im Speicher mit 0xff auffuellen
+  while (!ende)
+    put(0xff);
 
+  if (error)
+    return 0;
 
+  *serno = serial;
+  *sp = spos;
 
+  // Zeitzone/Stunden = floor (LON+7.5�) / 15� des 1. g�ltigen Fixes
+  ftz = ftz + 450000L;
+  ftz = ftz / 900000L;
+  task->zz_min = int(60 * floor(ftz));
 
   // bei neuen Dateien
-  if ( (igcfile_version >= 420) && (igcfile_version<422) )
+  if ( (version >= 420) && (version<422) )
 
     // falls kein TZN-Feld existierte
     if (tzn == 4000)
       // dieses durch das errechnete emulieren
-      tzn = task.zz_min;
+      tzn = task->zz_min;
 
   // bei allen Dateien
   // TZN anzeigen, wenn (auf welche Weise auch immer) gesetzt
   if (tzn != 4000) {
     tzh = abs(tzn) / 60;
     tzm = abs(tzn) % 60;
-    sprintf(igcheader.TZN,"UTC%c%02d:%02d",(tzn<0 ? '-':'+'),tzh,tzm);
+    sprintf(igcheader->TZN,"UTC%c%02d:%02d",(tzn<0 ? '-':'+'),tzh,tzm);
   }
 
-  strftime(igcheader.DTE,sizeof(igcheader.DTE),"%d%m%y",&firsttime);
-  igcheader.output(igcfile_version,oo_fillin);
+  strftime(igcheader->DTE,sizeof(igcheader->DTE),"%d%m%y",&firsttime);
+  igcheader->output(version,fillin);
 
 
-  if ( igcfile_version >= 414 || (task.STA.koord.lat != 0) || (task.STA.koord.lon != 0) ) {
+  if ( version >= 414 || (task->STA.koord.lat != 0) || (task->STA.koord.lon != 0) ) {
     if (decl_time >= 0) {
-      task.hasdeclaration = 1;
-      memcpy(&task.TDECL, &firsttime, sizeof task.TDECL);
-      task.TDECL.tm_sec += decl_time %3600;
-      task.TDECL.tm_hour += decl_time /3600;
-	  task.TDECL.tm_isdst = -1;
-      mktime(&task.TDECL);
-      task.print(igcfile_version,Ausgabedatei);
+      task->hasdeclaration = 1;
+      memcpy(&task->TDECL, &firsttime, sizeof task->TDECL);
+      task->TDECL.tm_sec += decl_time %3600;
+      task->TDECL.tm_hour += decl_time /3600;
+	  task->TDECL.tm_isdst = -1;
+      mktime(&task->TDECL);
+      task->print(version,ausgabe);
     }
   }
 
@@ -780,20 +836,29 @@ long convert_gcs(int igcfile_version, FILE *Ausgabedatei, lpb bin_puffer, int oo
   igcfix.lat = 0;
   igcfix.lon = 0;
 
-
-
   realtime = firsttime;
   ende = 0;
-  p = bin_puffer;
+
+  // Die Datensaetze werden in einem Fenster der Spooldatei konvertiert.
+  // Hinter dem Ende der Datei steht wie im Speicher 0xff.
+  rewind(spool);
+  memset(window, 0xff, sizeof window);
+  wlen = fread(window, 1, sizeof window, spool);
+  p = window;
+
   do {
+    if (p + max_rec_size > window + wlen && !feof(spool)) {
+      // Rest an den Anfang schieben und nachladen
+      int rest = (window + wlen) - p;
+      memmove(window, p, rest);
+      memset(window + rest, 0xff, sizeof(window) - rest);
+      wlen = rest + fread(window + rest, 1, sizeof(window) - rest, spool);
+      p = window;
+    }
+
     Haupttyp = p[0] & rectyp_msk;
     switch(Haupttyp) {
       case rectyp_sep : l = 1;
-			if (bfv > max_bfv) {
-			  ende = 1;
-			  l = 0;
-			  break;
-			}
 			break;
       case 0xC0       : l = 1;
 			break;
@@ -803,7 +868,6 @@ long convert_gcs(int igcfile_version, FILE *Ausgabedatei, lpb bin_puffer, int oo
 			  l = 0;
 			  break;
 			}
-			time_relative += p[2];
 			realtime.tm_sec += p[2];
 			realtime.tm_isdst = -1;
 			mktime(&realtime);
@@ -846,6 +910,10 @@ long convert_gcs(int igcfile_version, FILE *Ausgabedatei, lpb bin_puffer, int oo
 			  igcfix.fxa = hdop2fxa(p[6] & 0x0f);
 			  igcfix.enl = 4*p[8];
 			}
+			if (l == 0) {
+			  ende = 1;
+			  break;
+			}
 			igcfix.latdeg = labs(igcfix.lat) / 60000;
 			igcfix.latmin = labs(igcfix.lat) % 60000;
 			igcfix.londeg = labs(igcfix.lon) / 60000;
@@ -853,21 +921,21 @@ long convert_gcs(int igcfile_version, FILE *Ausgabedatei, lpb bin_puffer, int oo
 
 			igcfix.gps_alt = 10L * igcfix.gpalt - 1000L;
 
-			if (igcfile_version >= 423)
+			if (version >= 423)
 			  igcfix.enl = enlflt(igcfix.enl);
 			igcfix.enl = enllim(igcfix.enl);
 
 			// Bei allen neuen Dateien auf Wunsch von IAN
 			// aber dank neuer Regeln ab
 			// Konverter Nr. 4.20 nicht mehr !!
-			if ( (igcfile_version >= 413) && (igcfile_version < 420) )
+			if ( (version >= 413) && (version < 420) )
 			  if (igcfix.valid == 'V')
 			    igcfix.gps_alt = 0;
 
 			igcfix.pressure_alt = pressure2altitude(igcfix.press);
 
 			strftime(igcfix.time,sizeof(igcfix.time),"%H%M%S",&realtime);
-			fprintf(Ausgabedatei,"B%6s%02u%05u%c%03u%05u%c%c%05ld%05ld%03u",
+			fprintf(ausgabe,"B%6s%02u%05u%c%03u%05u%c%c%05ld%05ld%03u",
 			      igcfix.time,
 			      igcfix.latdeg, igcfix.latmin,
 			      ((igcfix.lat<0) ? 'S':'N'),
@@ -881,13 +949,13 @@ long convert_gcs(int igcfile_version, FILE *Ausgabedatei, lpb bin_puffer, int oo
 
 			if ( // erst bei ENL im I-Record aktivieren
 			// waren irrt�mlich schon mal aktiv
-			(igcfile_version >= 413) && (igcfile_version <416))
-			  fprintf(Ausgabedatei,"999");
+			(version >= 413) && (version <416))
+			  fprintf(ausgabe,"999");
 			// m�ssen auf jeden Fall aktiv sein, wenn Sensor da
-			if (strcmp(igcheader.RHW,"3.3")>=0)
-			  fprintf(Ausgabedatei,"%03u",igcfix.enl);
+			if (strcmp(igcheader->RHW,"3.3")>=0)
+			  fprintf(ausgabe,"%03u",igcfix.enl);
 
-			fprintf(Ausgabedatei,"\n");
+			fprintf(ausgabe,"\n");
 			break;
 
       case rectyp_vrb :
@@ -900,13 +968,17 @@ long convert_gcs(int igcfile_version, FILE *Ausgabedatei, lpb bin_puffer, int oo
 					    p2 = p+3; break;
 			  default	  : p2 = p; break;
 			}
+			if (l == 0) {
+			  ende = 1;
+			  break;
+			}
 			Untertyp = (p2[0]);
 			switch (Untertyp) {
 			case FLDEPEV : strftime(igcfix.time,sizeof(igcfix.time),"%H%M%S",&realtime);
-				       fprintf(Ausgabedatei,"E%6sPEVEVENTBUTTON PRESSED\n",igcfix.time);
+				       fprintf(ausgabe,"E%6sPEVEVENTBUTTON PRESSED\n",igcfix.time);
 				       break;
 			case FLDETKF : strftime(igcfix.time,sizeof(igcfix.time),"%H%M%S",&realtime);
-				       fprintf(Ausgabedatei,"LGCSTKF%6sTAKEOFF DETECTED\n",igcfix.time);
+				       fprintf(ausgabe,"LGCSTKF%6sTAKEOFF DETECTED\n",igcfix.time);
 				       break;
 			};
 			break;
@@ -922,10 +994,18 @@ long convert_gcs(int igcfile_version, FILE *Ausgabedatei, lpb bin_puffer, int oo
     }
     p += l;
   } while (!ende);
+
+  // G-Records anhaengen
+  grecord->final();
+  rewind(gspool);
+  while ((wlen = fread(window, 1, sizeof window, gspool)) > 0)
+    fwrite(window, 1, wlen, ausgabe);
+
   return pl;
 }
 
 
+
 // Members of class DIRENTRY
 
 char *gen_filename(DIRENTRY *de, int flightnum) {
@@ -61,22 +61,89 @@
 #define FLDETKF      0x61
 
 
+struct IGCHEADER;
+class C_RECORD;
+class GRECORD;
+
 /*
-convert_gcs
+GCSCONV
   function:
-    converts a given flight log from VOLKSLOGGER binary to IGC-format
-  input values:
-    converter version
-    output stream handle
-    pointer to binary file buffer
-    OO-fillin
-    serial-number (reference)
-    position of signature in binary file (reference)
-  return value:
-    length of binary file
+    converts a flight log from VOLKSLOGGER binary to IGC-format, while
+    the log is read from the logger
+  usage:
+    put() takes the binary log bytewise. Every complete record is scanned
+    for the header data, added to the G-record and spooled into a
+    temporary file. finish() writes the header, the C-records, the B- and
+    E-records converted from the spool and the G-records to the output
+    stream. So the memory needed does not depend on the size of the log.
 */
-int32 convert_gcs(int16, FILE *, lpb, int16, word *, long *);
+class GCSCONV : public VLA_SINK {
+ public:
+  /*
+    input values:
+      converter version, 0 for the actual one
+      output stream handle
+      OO-fillin
+  */
+  GCSCONV(int igcfile_version, FILE *Ausgabedatei, int oo_fillin);
+  virtual ~GCSCONV();
+
+  // next byte of the binary log
+  void put(byte b);
+
+  // true, if the end of the binary log is reached
+  int done(void) { return ende; }
+
+  /*
+    writes the IGC-file
+    output values:
+      serial-number (reference)
+      position of signature in binary file (reference)
+    return value:
+      length of binary file, 0 in case of an error
+  */
+  long finish(word *serno, long *sp);
+
+ private:
+  int  record_length(void);
+  void scan(lpb p, int l);
+
+  int        version;
+  FILE      *ausgabe;
+  int        fillin;
 
+  IGCHEADER *igcheader;
+  C_RECORD  *task;
+  GRECORD   *grecord;
+
+  // spool files of the records and the G-records
+  FILE      *spool;
+  FILE      *gspool;
+
+  // largest record: variable record with length byte 255, plus reserve
+  // for the field copies of the scan behind the record end
+  enum { max_rec_size = 255 + 64 };
+
+  // the record, which is assembled
+  byte       rec[max_rec_size];
+  int        reclen;
+
+  int        ende;
+  int        error;
+  long       pl;    // length of the scanned binary log
+  long       spos;  // position of the signature
+  word       serial;
+
+  // state of the header scan
+  long       time_relative;
+  long       decl_time;
+  tm         firsttime;
+  int        bfv;
+  int        tzn;
+  float      ftz;
+  int        tzset;
+  long       lon;
+};
 
 /*
 DIRENTRY
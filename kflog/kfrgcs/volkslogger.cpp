@@ -30,18 +30,12 @@
 /**
  * The device-name of the port.
  */
-char* portName = "\0";
-int portID = -1;
+QString portName;
 
 /**
- * holds the port-settings at start of the application
+ * The serial port of the plugin, which is used by VLA_SYS.
  */
-struct termios oldTermEnv;
-
-/**
- * is used to change the port-settings
- */
-struct termios newTermEnv;
+SerialTransport* serialPort = 0;
 
 VLAPI vl;
 
@@ -69,7 +63,6 @@ Volkslogger::Volkslogger( QObject *parent ) : FlightRecorderPluginBase( parent )
   //_capabilities.supDspCompetitionID = true;
   //End set capabilities.
 
-  portID = -1;
   haveDatabase = false;
 }
 
@@ -194,7 +187,8 @@ int Volkslogger::writeConfigData(FR_BasicData& /*basicdata*/, FR_ConfigData& /*c
 int Volkslogger::openRecorder(const QString& pName, int baud)
 {
   int err;
-  portName = pName.toLatin1().data();
+  portName = pName;
+  serialPort = &_serial;
 
   if((err = vl.open(1, 5, 0, baud)) != VLA_ERR_NOERR) {
     qWarning() << QObject::tr("No logger found!");
@@ -38,25 +38,8 @@ extern int breakTransfer;
 
 static char c36[] = "0123456789abcdefghijklmnopqrstuvwxyz";
 
-static int portID = -1;
-/**
- * holds the port-settings at start of the application
- */
-static struct termios oldTermEnv;
-/**
- * is used to change the port-settings
- */
-static struct termios newTermEnv;
-
-/**
- * Needed to reset the serial port in any case of unexpected exiting
- * of the program. Called via signal-handler of the runtime-environment.
- */
-static void releaseTTY(int /*signal*/)
-{
-  tcsetattr( portID, TCSANOW, &oldTermEnv );
-  exit( -1 );
-}
+// Timeout of a serial read in milliseconds
+#define READ_TIMEOUT  100
 
 SoaringPilot::SoaringPilot( QObject *parent ) : FlightRecorderPluginBase( parent )
 {
@@ -81,8 +64,6 @@ SoaringPilot::SoaringPilot( QObject *parent ) : FlightRecorderPluginBase( parent
   //_capabilities.supDspGliderID = true;
   //_capabilities.supDspCompetitionID = true;
   //End set capabilities.
-
-  portID = -1;
 }
 
 SoaringPilot::~SoaringPilot()
@@ -97,7 +78,7 @@ int SoaringPilot::writeFile( QStringList &file )
     {
       QString line = file.at(i) + "\r\n";
 
-      if( write( portID, line.toLatin1().data(), line.size() ) != 1 )
+      if( _serial.write( line.toLatin1() ) != line.size() )
         {
           return FR_ERROR;
         }
@@ -109,7 +90,7 @@ int SoaringPilot::writeFile( QStringList &file )
 /** read a file like structure from the device */
 int SoaringPilot::readFile(QStringList &file)
 {
-  char inbyte;
+  unsigned char inbyte;
   QString s;
   time_t t1;
   int start = 0;
@@ -119,7 +100,7 @@ int SoaringPilot::readFile(QStringList &file)
 
   while( !breakTransfer )
     {
-      if( read( portID, &inbyte, sizeof(inbyte) ) )
+      if( _serial.readByte( inbyte, READ_TIMEOUT ) )
         {
           start = 1;
           t1 = time( 0 );
@@ -135,7 +116,7 @@ int SoaringPilot::readFile(QStringList &file)
                 continue;
 
               default:
-                s.append( inbyte );
+                s.append( QChar( inbyte ) );
                 break;
             }
         }
@@ -433,90 +414,24 @@ int SoaringPilot::openRecorder(const QString& portName, int baud)
 {
   speed_t speed;
 
-  /* eventuell als Mode zusätzlich O_NONBLOCK ??? */
-  portID = open(portName.toLatin1().data(), O_RDWR | O_NOCTTY);
-
-  if(portID != -1) {
-    //
-    // Before we change any port-settings, we must establish a
-    // signal-handler, which is used to restore the port-settings
-    // after terminating the program.
-    //    Because a SIGKILL-signal removes the program immediately,
-    // the status of the port will be undefined.
-    //
-    struct sigaction sact;
-
-    sact.sa_handler = releaseTTY;
-    sigaction(SIGHUP, &sact, NULL);
-    sigaction(SIGINT, &sact, NULL);
-    sigaction(SIGPIPE, &sact, NULL);
-    sigaction(SIGTERM, &sact, NULL);
-
-    ////////////////////////////////////////////////////////////////////////
-    //
-    // port-configuration
-    //
-
-    // reading the current port-settings
-    tcgetattr(portID, &newTermEnv);
-
-    // storing the port-settings to restore them ...
-    oldTermEnv = newTermEnv;
-
-    if(baud >= 115200) speed = B115200;
-    else if(baud >= 57600) speed = B57600;
-    else if(baud >= 38400) speed = B38400;
-    else if(baud >= 19200) speed = B19200;
-    else if(baud >=  9600) speed = B9600;
-    else if(baud >=  4800) speed = B4800;
-    else if(baud >=  2400) speed = B2400;
-    else if(baud >=  1800) speed = B1800;
-    else if(baud >=  1200) speed = B1200;
-    else if(baud >=   600) speed = B600;
-    else if(baud >=   300) speed = B300;
-    else if(baud >=   200) speed = B200;
-    else if(baud >=   150) speed = B150;
-    else if(baud >=   110) speed = B110;
-    else speed = B75;
-
-    cfsetospeed(&newTermEnv, speed);
-    cfsetispeed(&newTermEnv, speed);
-
-    // input flags
-    newTermEnv.c_iflag |= CREAD;   // (wichtig!)
-    newTermEnv.c_iflag |= CLOCAL;  // (wichtig!)
-    newTermEnv.c_iflag &= ~IGNCR;  // (wichtig!)
-    newTermEnv.c_iflag &= ~ISTRIP; // dont strip
-    newTermEnv.c_iflag &= ~ICRNL; // don't change newline (\n) in carriage-return (\r)
-    newTermEnv.c_iflag &= ~INLCR; // don't change carriage-return (\r) in newline (\n)
-    newTermEnv.c_iflag &= ~IXON; // disable XON flow-control on output
-    newTermEnv.c_iflag &= ~IXOFF; // disable XON flow-control on intput
-    newTermEnv.c_iflag |= IGNBRK; // ignore break
-    newTermEnv.c_iflag &= ~BRKINT; // dont signal break
-
-    // control flags
-    newTermEnv.c_cflag |= CRTSCTS; // Hardware control on output
-    newTermEnv.c_cflag |= CS8; // Bytesize = 8
-    newTermEnv.c_cflag &= ~CSTOPB; // 1 stop-bit
-    newTermEnv.c_cflag &= ~PARENB; // no parity
-
-    // control characters
-    newTermEnv.c_cc[VMIN] = 0; // don't wait for a character
-    newTermEnv.c_cc[VTIME] = 1; // wait at least 1 msec.
-
-    // output flags
-    newTermEnv.c_oflag &= ~OPOST; // no post processing
-    newTermEnv.c_oflag &= ~ONLCR; // don't change newline (\n) in carriage-return (\r)
-    newTermEnv.c_oflag &= ~OCRNL; // don't change carriage-return (\r) in newline (\n)
-
-    // line flags
-    newTermEnv.c_lflag &= ~ICANON; // enable raw-mode (diable canonical-mode)
-    newTermEnv.c_lflag &= ~IEXTEN; // no extended processing
-    newTermEnv.c_lflag &= ~ISIG; // don't interpret INTR, QUIT, SUSP or DSUSP
-    newTermEnv.c_lflag &= ~ECHO;// echo input characters
-
-    // Activating the port-settings
-    tcsetattr(portID, TCSANOW, &newTermEnv);
+  if(baud >= 115200) speed = B115200;
+  else if(baud >= 57600) speed = B57600;
+  else if(baud >= 38400) speed = B38400;
+  else if(baud >= 19200) speed = B19200;
+  else if(baud >=  9600) speed = B9600;
+  else if(baud >=  4800) speed = B4800;
+  else if(baud >=  2400) speed = B2400;
+  else if(baud >=  1800) speed = B1800;
+  else if(baud >=  1200) speed = B1200;
+  else if(baud >=   600) speed = B600;
+  else if(baud >=   300) speed = B300;
+  else if(baud >=   200) speed = B200;
+  else if(baud >=   150) speed = B150;
+  else if(baud >=   110) speed = B110;
+  else speed = B75;
+
+  // The Pilot uses the hardware flow control.
+  if( _serial.open( portName, speed, true ) ) {
     _isConnected=true;
     return FR_OK;
   }
@@ -531,11 +446,9 @@ int SoaringPilot::openRecorder(const QString& portName, int baud)
  */
 int SoaringPilot::closeRecorder()
 {
-  if( portID != -1 )
+  if( _serial.isOpen() )
     {
-      tcsetattr( portID, TCSANOW, &oldTermEnv );
-      close( portID );
-      portID = -1;
+      _serial.close();
       _isConnected = false;
       return FR_OK;
     }
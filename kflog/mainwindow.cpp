@@ -38,11 +38,13 @@
 #include "distance.h"
 #include "evaluationdialog.h"
 #include "flightdataprint.h"
+#include "flightgroup.h"
 #include "flightloader.h"
 #include "helpwindow.h"
 #include "igc3ddialog.h"
 #include "kflogconfig.h"
 #include "map.h"
+#include "mapatlas.h"
 #include "mapcontents.h"
 #include "mapconfig.h"
 #include "mapcontrolview.h"
@@ -193,7 +195,7 @@ MainWindow::MainWindow( QWidget *parent, Qt::WindowFlags flags ) :
   connect(map, SIGNAL(waypointEdited(Waypoint *)), waypointTreeView, SLOT(slotEditWaypoint(Waypoint *)));
   connect(map, SIGNAL(elevation(int)), legend, SLOT(slotSelectElevation(int)));
   connect(map, SIGNAL(regWaypointDialog(QWidget *)), this, SLOT(slotRegisterWaypointDialog(QWidget *)));
-  connect(map, SIGNAL(openFile(const QUrl&)), this, SLOT(slotOpenFile(const QUrl&)));
+  connect(map, SIGNAL(openFiles(const QList<QUrl>&)), this, SLOT(slotOpenFiles(const QList<QUrl>&)));
   connect(map, SIGNAL(setStatusBarProgress(int)), this, SLOT(slotSetProgress(int)));
   connect(map, SIGNAL(setStatusBarMsg(const QString&)), this, SLOT(slotSetStatusMsg(const QString&)));
   connect(map, SIGNAL(flightTaskModified()), objectTree, SLOT(slotFlightChanged()));
@@ -208,6 +210,7 @@ MainWindow::MainWindow( QWidget *parent, Qt::WindowFlags flags ) :
 
   connect(_globalMapContents, SIGNAL(activatePlanning()), map,SLOT(slotActivatePlanning()));
   connect(_globalMapContents, SIGNAL(closingFlight(BaseFlightElement*)), objectTree, SLOT(slotCloseFlight(BaseFlightElement*)));
+  connect(_globalMapContents, SIGNAL(contentsChanged()),map, SLOT(slotClearHitIndex()));
   connect(_globalMapContents, SIGNAL(contentsChanged()),map, SLOT(slotScheduleRedrawMap()));
   connect(_globalMapContents, SIGNAL(currentFlightChanged()), this, SLOT(slotModifyMenu()));
   connect(_globalMapContents, SIGNAL(currentFlightChanged()), dataView, SLOT(slotSetFlightData()));
@@ -237,7 +240,7 @@ MainWindow::MainWindow( QWidget *parent, Qt::WindowFlags flags ) :
   connect(objectTree, SIGNAL(newFlightGroup()), _globalMapContents, SLOT(slotNewFlightGroup()));
   connect(objectTree, SIGNAL(editFlightGroup()), _globalMapContents, SLOT(slotEditFlightGroup()));
   connect(objectTree, SIGNAL(openFlight()), this, SLOT(slotOpenFile()));
-  connect(objectTree, SIGNAL(openFile(const QUrl&)), this, SLOT(slotOpenFile(const QUrl&)));
+  connect(objectTree, SIGNAL(openFiles(const QList<QUrl>&)), this, SLOT(slotOpenFiles(const QList<QUrl>&)));
   connect(objectTree, SIGNAL(setFlightQNH()), this, SLOT(slotSetFlightQNH()));
   connect(objectTree, SIGNAL(updateFlightWindows()), this, SLOT(slotUpdateFlightWindows()));
   connect(objectTree, SIGNAL(optimizeFlight()), this, SLOT(slotOptimizeFlight()));
@@ -499,12 +502,22 @@ void MainWindow::createMenuBar()
   fileSavePixmapAction->setEnabled(true);
   connect( fileSavePixmapAction, SIGNAL(triggered()), this, SLOT(slotSaveMap2Image()) );
 
+  fileSaveAtlasAction = new QAction( getPixmap("kde_image_16.png"),
+                                     tr("Save map atlas to PNG..."), this );
+  fileSaveAtlasAction->setEnabled(false);
+  connect( fileSaveAtlasAction, SIGNAL(triggered()), this, SLOT(slotSaveAtlas2Image()) );
+
   filePrintAction = new QAction( getPixmap("kde_fileprint_16.png"),
                                  tr("Print Map"), this );
   filePrintAction->setShortcut( Qt::CTRL + Qt::Key_P );
   filePrintAction->setEnabled(true);
   connect( filePrintAction, SIGNAL(triggered()), this, SLOT(slotPrintMap()) );
 
+  filePrintAtlasAction = new QAction( getPixmap("kde_fileprint_16.png"),
+                                      tr("Print Map Atlas"), this );
+  filePrintAtlasAction->setEnabled(false);
+  connect( filePrintAtlasAction, SIGNAL(triggered()), this, SLOT(slotPrintAtlas()) );
+
   filePrintFlightAction = new QAction( getPixmap("kde_fileprint_16.png"),
                                        tr("Print Flight Data"), this );
   filePrintFlightAction->setEnabled(true);
@@ -564,8 +577,10 @@ void MainWindow::createMenuBar()
   fileMenu->addAction( fileCloseAction );
   fileMenu->addSeparator();
   fileMenu->addAction( fileSavePixmapAction );
+  fileMenu->addAction( fileSaveAtlasAction );
   fileMenu->addSeparator();
   fileMenu->addAction( filePrintAction );
+  fileMenu->addAction( filePrintAtlasAction );
   fileMenu->addAction( filePrintFlightAction );
   fileMenu->addAction( filePrintTaskAction );
   fileMenu->addSeparator();
@@ -1163,9 +1178,21 @@ void MainWindow::slotFlightViewIgcOpenGL()
 {
 #ifndef _WIN32
   // Note, that this function does not only delivers Flight objects!!!
-  Flight *flight = dynamic_cast<Flight *> (_globalMapContents->getFlight());
+  BaseFlightElement *bfe = _globalMapContents->getFlight();
+
+  QList<Flight *> flights;
+
+  if( bfe != 0 && bfe->getTypeID() == BaseMapElement::Flight )
+    {
+      flights.append( dynamic_cast<Flight *> (bfe) );
+    }
+  else if( bfe != 0 && bfe->getTypeID() == BaseMapElement::FlightGroup )
+    {
+      // All flights of a group are shown together.
+      flights = dynamic_cast<FlightGroup *> (bfe)->getFlightList();
+    }
 
-  if( flight == static_cast<Flight *> (0) )
+  if( flights.isEmpty() )
     {
       return;
     }
@@ -1219,7 +1246,10 @@ void MainWindow::slotFlightViewIgcOpenGL()
       return;
     }
 
-  (void)(*addFlight)( flight );
+  for( int i = 0; i < flights.size(); i++ )
+    {
+      (void)(*addFlight)( flights.at( i ) );
+    }
 
   // FIXME: Memory leak from libHandle is to fix here!
 #else
@@ -1258,6 +1288,8 @@ void MainWindow::slotModifyMenu()
   flightMenu->setEnabled(false);
   filePrintFlightAction->setEnabled(false);
   filePrintTaskAction->setEnabled(false);
+  filePrintAtlasAction->setEnabled(false);
+  fileSaveAtlasAction->setEnabled(false);
   viewCenterTaskAction->setEnabled(false);
   viewCenterFlightAction->setEnabled(false);
 
@@ -1271,6 +1303,8 @@ void MainWindow::slotModifyMenu()
             flightMenu->setEnabled(true);
             filePrintFlightAction->setEnabled(true);
             filePrintTaskAction->setEnabled(false);
+            filePrintAtlasAction->setEnabled(true);
+            fileSaveAtlasAction->setEnabled(true);
             viewCenterFlightAction->setEnabled(true);
             viewCenterTaskAction->setEnabled(false);
             break;
@@ -1279,6 +1313,8 @@ void MainWindow::slotModifyMenu()
             flightMenu->setEnabled(false);
             filePrintFlightAction->setEnabled(false);
             filePrintTaskAction->setEnabled(true);
+            filePrintAtlasAction->setEnabled(true);
+            fileSaveAtlasAction->setEnabled(true);
             viewCenterFlightAction->setEnabled(false);
             viewCenterTaskAction->setEnabled(true);
             break;
@@ -1331,48 +1367,60 @@ void MainWindow::slotOpenFile()
           return;
         }
 
-      for (int i = 0; i < fNames.size(); i++)
-      {
-          QFile file( fNames[i] );
+      flightDir = fd->directory().canonicalPath();
 
-          flightDir = fd->directory().canonicalPath();
+      FlightLoader flightLoader( this );
 
-          FlightLoader flightLoader( this );
+      QStringList loaded = flightLoader.openFlights( fNames );
 
-          if( flightLoader.openFlight(file) )
-            {
-              slotSetCurrentFile( fNames[0] );
-            }
-      }
+      for( int i = 0; i < loaded.size(); i++ )
+        {
+          slotSetCurrentFile( loaded[i] );
+        }
     }
 
   slotSetStatusMsg( tr( "Ready." ) );
 }
 
 void MainWindow::slotOpenFile( const QUrl& url )
+{
+  slotOpenFiles( QList<QUrl>() << url );
+}
+
+void MainWindow::slotOpenFiles( const QList<QUrl>& urls )
 {
   slotSetStatusMsg(tr("Opening file..."));
 
-  QString path;
+  // The flights are collected and loaded together in the background.
+  QStringList flights;
+
+  for( int i = 0; i < urls.size(); i++ )
+    {
+      const QUrl& url = urls.at(i);
+
+      QString path;
 #ifdef _WIN32
-  // HACK 2DO
-  // For some reason QUrl behaves stupidly when opening a local path like C:\<path\<file>
-  // C is the scheme (instead of "file") and the path is just \<path>\<file>
-  // workaround: take URL 1:1 and just check for validity
-  path=url.toString(QUrl::None);
+      // HACK 2DO
+      // For some reason QUrl behaves stupidly when opening a local path like C:\<path\<file>
+      // C is the scheme (instead of "file") and the path is just \<path>\<file>
+      // workaround: take URL 1:1 and just check for validity
+      path=url.toString(QUrl::None);
 
-  if (url.isValid())
+      if (! url.isValid())
 #else
-  path=url.path();
+      path=url.path();
 
-  if( url.scheme() == "file" || url.isRelative() )
+      if( url.scheme() != "file" && ! url.isRelative() )
 #endif
-    {
-      QFile file( path );
+        {
+          continue;
+        }
 
       if( url.path().right( 9 ).toLower() == ".kflogtsk" )
         {
           // this is probably a taskfile. Try to open it as a task
+          QFile file( path );
+
           if( _globalMapContents->loadTask( file ) )
             {
               slotSetCurrentFile( url.path() );
@@ -1381,12 +1429,19 @@ void MainWindow::slotOpenFile( const QUrl& url )
       else
         {
           // try to open as flight
-          FlightLoader flightLoader( this );
+          flights.append( path );
+        }
+    }
 
-          if( flightLoader.openFlight( file ) )
-            {
-              slotSetCurrentFile( url.path() );
-            }
+  if( flights.size() > 0 )
+    {
+      FlightLoader flightLoader( this );
+
+      QStringList loaded = flightLoader.openFlights( flights );
+
+      for( int i = 0; i < loaded.size(); i++ )
+        {
+          slotSetCurrentFile( loaded[i] );
         }
     }
 
@@ -1532,6 +1587,9 @@ void MainWindow::slotOpenRecorderDialog()
   connect( dlg, SIGNAL(addTask(FlightTask *)),
            _globalMapContents, SLOT(slotAppendTask(FlightTask *)) );
 
+  connect( dlg, SIGNAL(openFlights(const QList<QUrl>&)),
+           this, SLOT(slotOpenFiles(const QList<QUrl>&)) );
+
   dlg->exec();
 }
 
@@ -1849,23 +1907,105 @@ void MainWindow::slotPrintMap()
       return;
     }
 
-  QPainter painter( &printer );
+  // The visible part of the map is rendered offscreen with the resolution
+  // of the printer page.
+  QSize pageSize = MapAtlas::pageSize( &printer );
+
+  double scale = _globalMapMatrix->getScale( MapMatrix::CurrentScale ) *
+                 qMax( double( map->width() ) / pageSize.width(),
+                       double( map->height() ) / pageSize.height() );
+
+  MapAtlas atlas( scale, pageSize );
+  atlas.addPage( _globalMapMatrix->getMapCenter() );
+  atlas.print( &printer );
+
+  slotSetStatusMsg( tr( "Ready." ) );
+}
+
+void MainWindow::slotPrintAtlas()
+{
+  BaseFlightElement *f = _globalMapContents->getFlight();
+
+  if( f == 0 )
+    {
+      return;
+    }
+
+  double scale = MapAtlas::selectScale( this );
+
+  if( scale <= 0.0 )
+    {
+      return;
+    }
+
+  slotSetStatusMsg( tr( "Printing map atlas ..." ) );
+
+  QPrinter printer( QPrinter::HighResolution );
+
+  printer.setDocName( "kflog-atlas" );
+  printer.setCreator( QString( "KFLog " ) + KFLOG_VERSION );
+  printer.setOutputFileName( getApplicationDataDirectory() + "/kflog-atlas.pdf" );
+
+  QPrintDialog dialog( &printer, this );
+
+  dialog.setWindowTitle( tr("Print Map Atlas") );
+  dialog.setSizeGripEnabled ( true );
+  dialog.setOptions( QAbstractPrintDialog::PrintToFile |
+                     QAbstractPrintDialog::PrintShowPageSize );
+
+  if( dialog.exec() != QDialog::Accepted )
+    {
+      slotSetStatusMsg( tr( "" ) );
+      return;
+    }
+
+  MapAtlas atlas( scale, MapAtlas::pageSize( &printer ) );
 
-  // We print the current content of the map into a file.
-  QWidget *map = _globalMap;
+  if( atlas.createPages( f ) > 0 )
+    {
+      atlas.print( &printer );
+    }
 
-  double xscale = printer.pageRect().width() / double( map->width() );
-  double yscale = printer.pageRect().height() / double( map->height() );
-  double scale = qMin( xscale, yscale );
+  slotSetStatusMsg( tr( "Ready." ) );
+}
 
-  painter.translate( printer.paperRect().x() + printer.pageRect().width() / 2,
-                     printer.paperRect().y() + printer.pageRect().height() / 2 );
+void MainWindow::slotSaveAtlas2Image()
+{
+  BaseFlightElement *f = _globalMapContents->getFlight();
 
-  painter.scale( scale, scale );
+  if( f == 0 )
+    {
+      return;
+    }
 
-  painter.translate( -map->width() / 2, -map->height() / 2 );
+  double scale = MapAtlas::selectScale( this );
 
-  map->render( &painter );
+  if( scale <= 0.0 )
+    {
+      return;
+    }
+
+  QString fileName = QFileDialog::getSaveFileName( this,
+                                                   tr("Save map atlas as images"),
+                                                   getApplicationDataDirectory() + "/kflog_atlas.png",
+                                                   tr("Image (*.png)") );
+  if( fileName.isEmpty() )
+    {
+      return;
+    }
+
+  slotSetStatusMsg( tr( "Saving map atlas ..." ) );
+
+  // The pages have the format DIN A4.
+  MapAtlas atlas( scale, MapAtlas::pageSize( QSizeF( 210.0, 297.0 ) ) );
+
+  if( atlas.createPages( f ) > 0 && ! atlas.exportImages( fileName ) )
+    {
+      QMessageBox::warning( this,
+                            tr("Map Atlas"),
+                            tr("Cannot save the map atlas as<BR><B>%1</B>").arg( fileName ),
+                            QMessageBox::Ok );
+    }
 
   slotSetStatusMsg( tr( "Ready." ) );
 }
@@ -139,6 +139,10 @@ public slots:
    * Opens the printing dialog to print the map.
    */
   void slotPrintMap();
+  /**
+   * Prints the map pages along the current flight or task.
+   */
+  void slotPrintAtlas();
   /** */
   void slotPrintFlight();
   /** */
@@ -157,6 +161,11 @@ public slots:
    * Opens the file given in url.
    */
   void slotOpenFile(const QUrl& url);
+  /**
+   * Opens the files given in urls. The flights are loaded together in the
+   * background.
+   */
+  void slotOpenFiles(const QList<QUrl>& urls);
   /**
    * Opens a task-file-open-dialog.
    */
@@ -240,6 +249,9 @@ public slots:
   /** Called to save the map into an image file. */
   void slotSaveMap2Image();
 
+  /** Called to save the map pages along a flight or task into image files. */
+  void slotSaveAtlas2Image();
+
   /** Called to save the map into an image file. */
   void slotSavePixmap(QUrl url, int width=0, int height=0 );
   /**
@@ -358,7 +370,9 @@ private:
   QMenu*   fileOpenRecentMenu;
   QAction* fileCloseAction;
   QAction* fileSavePixmapAction;
+  QAction* fileSaveAtlasAction;
   QAction* filePrintAction;
+  QAction* filePrintAtlasAction;
   QAction* filePrintFlightAction;
   QAction* filePrintTaskAction;
   QAction* fileOpenRecorderAction;
@@ -49,6 +49,9 @@
 #define MAX_Y_TO_PAN QApplication::desktop()->height()-30
 #define MAP_INFO_DELAY 1000
 
+// Interval of the animation timer in ms, independent of the fix rate.
+#define ANIMATION_INTERVAL 40
+
 /** External references */
 extern MainWindow   *_mainWindow;
 extern MapConfig    *_globalMapConfig;
@@ -65,6 +68,8 @@ Map::Map( QWidget* parent ) :
   preStepIndex(-1),
   drawFlightStepCursor(false),
   animationPaused(false),
+  animationTime(0.0),
+  animationSpeed(60),
   planning(0),
   tempTask(""),
   startDragZoom(false),
@@ -72,6 +77,8 @@ Map::Map( QWidget* parent ) :
   isMapMoveActive(false),
   isDrawing(false),
   redrawRequest(false),
+  renderingSections(false),
+  animationResume(false),
   preSnapPoint(-999, -999)
 {
   pixCursor = QPixmap(40,40);
@@ -600,55 +607,31 @@ void Map::__displayMapInfo(const QPoint& current, bool automatic)
 
   QString text;
 
-  // compose search list
-  QList<int> searchList;
-  searchList << MapContents::GliderfieldList
-	     << MapContents::AirfieldList
-	     << MapContents::OutLandingList
-	     << MapContents::NavaidList
-	     << MapContents::HotspotList;
+  // Only the drawn point elements near to the position are checked.
+  SinglePoint *sp = m_hitIndex.findPoint( current, delta );
 
-  for( int k = 0; k < searchList.size(); k++ )
+  if( sp )
     {
-      for( int i = 0; i < _globalMapContents->getListLength(searchList.at(k) ); i++ )
-      {
-        SinglePoint *sp = dynamic_cast<SinglePoint *>(_globalMapContents->getElement(searchList.at(k), i));
-
-        if( sp == 0 )
-          {
-            continue;
-          }
-
-        QPoint sitePos = sp->getMapPosition();
-
-        int dX = abs( sitePos.x() - current.x() );
-        int dY = abs( sitePos.y() - current.y() );
-
-        // Abstand entspricht der Icon-Größe.
-        if( dX < delta && dY < delta )
-          {
-            Airfield *af   = dynamic_cast<Airfield *>(sp); // try casting to an airfield
-            RadioPoint *rp = dynamic_cast<RadioPoint *>(sp); // try casting to a navaid
+      Airfield *af   = dynamic_cast<Airfield *>(sp); // try casting to an airfield
+      RadioPoint *rp = dynamic_cast<RadioPoint *>(sp); // try casting to a navaid
 
-            if( af )
-              {
-                text += af->getInfoString();
-              }
-            else if( rp )
-              {
-                text += rp->getInfoString();
-              }
-            else
-              {
-                text += sp->getInfoString();
-              }
+      if( af )
+        {
+          text += af->getInfoString();
+        }
+      else if( rp )
+        {
+          text += rp->getInfoString();
+        }
+      else
+        {
+          text += sp->getInfoString();
+        }
 
-            // Text anzeigen
-            WhatsThat* box = new WhatsThat( this, text, timeout, mapToGlobal( current ) );
-            box->setVisible( true );
-            return;
-          }
-       }
+      // Text anzeigen
+      WhatsThat* box = new WhatsThat( this, text, timeout, mapToGlobal( current ) );
+      box->setVisible( true );
+      return;
     }
 
   BaseFlightElement *baseFlight = _globalMapContents->getFlight();
@@ -785,9 +768,18 @@ void Map::__displayAirspaceInfo(const QPoint& current, bool automatic)
 
   bool show = false;
 
-  for( int loop = 0; loop < airspaceRegionList.count(); loop++)
+  // The exact test is only done for airspaces, whose bounding rectangle
+  // contains the position.
+  QList<int> candidates = m_hitIndex.findRegions( current );
+
+  for( int loop = 0; loop < candidates.count(); loop++)
     {
-      QPair<QPainterPath, Airspace*> pair = airspaceRegionList.at(loop);
+      if( candidates.at(loop) >= airspaceRegionList.count() )
+        {
+          continue;
+        }
+
+      const QPair<QPainterPath, Airspace*>& pair = airspaceRegionList.at(candidates.at(loop));
 
       if( pair.first.contains(current) )
         {
@@ -1192,20 +1184,24 @@ void Map::paintEvent( QPaintEvent* event )
 
   QPainter painter(this);
 
-  painter.drawPixmap( event->rect().left(),
-                      event->rect().top(),
-                      pixBuffer,
-                      0, 0, event->rect().width(),
-                      event->rect().height() );
+  painter.drawPixmap( event->rect().topLeft(), pixBuffer, event->rect() );
 
   // Redraw the flight cursors on request.
   if( drawFlightCursors == true && pixFlightCursors.isNull() == false )
     {
-      painter.drawPixmap( event->rect().left(),
-                          event->rect().top(),
-                          pixFlightCursors,
-                          0, 0, event->rect().width(),
-                          event->rect().height() );
+      painter.drawPixmap( event->rect().topLeft(), pixFlightCursors, event->rect() );
+    }
+
+  // Draw the glider symbols of the flight animation.
+  for( int i = 0; i < animationTracks.size(); i++ )
+    {
+      const AnimationTrack& track = animationTracks.at(i);
+
+      if( track.gliderRect.intersects( event->rect() ) )
+        {
+          painter.drawPixmap( track.gliderRect.topLeft(), pixGliders,
+                              QRect( track.rotation * 40, 0, 40, 40 ) );
+        }
     }
 
   // Draw the flight step cursor at the map on request.
@@ -1286,7 +1282,7 @@ void Map::__drawGrid()
           pointArray.insert( 0, p );
 
           p = pointArray.last();
-          p.setX( width() );
+          p.setX( pixGrid.width() );
           pointArray.append( p );
 
           // Draw the main lines
@@ -1330,7 +1326,7 @@ void Map::__drawGrid()
               pointArraySmall.insert( 0, p );
 
               p = pointArraySmall.last();
-              p.setX( width() );
+              p.setX( pixGrid.width() );
               pointArraySmall.append( p );
 
               if( loop2 == (number / 2.0) )
@@ -1416,12 +1412,13 @@ void Map::__drawMap()
   QPainter isoMapP(&pixIsoMap);
 
   m_drawnCityList.clear();
+  m_hitIndex.clear( pixIsoMap.rect() );
   QList<BaseMapElement *> drawnElements;
 
   // Take the color of the subterrain for filling
   pixIsoMap.fill( _globalMapConfig->getIsoColor(0) );
 
-  _globalMapContents->drawIsoList( &isoMapP, rect() );
+  _globalMapContents->drawIsoList( &isoMapP, pixIsoMap.rect() );
 
   emit setStatusBarProgress(10);
 
@@ -1474,21 +1471,30 @@ void Map::__drawMap()
 
   emit setStatusBarProgress(70);
 
-  _globalMapContents->drawList(&aeroP, MapContents::HotspotList, drawnElements);
+  // The drawn point elements are put into the hit index. The priority
+  // defines the search order of the hit tests.
+  QList<BaseMapElement *> drawnPoints;
 
-  _globalMapContents->drawList(&aeroP, MapContents::NavaidList, drawnElements);
+  _globalMapContents->drawList(&aeroP, MapContents::HotspotList, drawnPoints);
+  __insertDrawnPoints( drawnPoints, 4 );
+
+  _globalMapContents->drawList(&aeroP, MapContents::NavaidList, drawnPoints);
+  __insertDrawnPoints( drawnPoints, 3 );
 
   emit setStatusBarProgress(75);
 
-  _globalMapContents->drawList(&aeroP, MapContents::AirfieldList, drawnElements);
+  _globalMapContents->drawList(&aeroP, MapContents::AirfieldList, drawnPoints);
+  __insertDrawnPoints( drawnPoints, 1 );
 
   emit setStatusBarProgress(80);
 
-  _globalMapContents->drawList(&aeroP, MapContents::GliderfieldList, drawnElements);
+  _globalMapContents->drawList(&aeroP, MapContents::GliderfieldList, drawnPoints);
+  __insertDrawnPoints( drawnPoints, 0 );
 
   emit setStatusBarProgress(90);
 
-  _globalMapContents->drawList(&aeroP, MapContents::OutLandingList, drawnElements);
+  _globalMapContents->drawList(&aeroP, MapContents::OutLandingList, drawnPoints);
+  __insertDrawnPoints( drawnPoints, 2 );
 
   emit setStatusBarProgress(95);
 
@@ -1520,15 +1526,44 @@ void Map::__drawAirspaces()
         }
 
       QPair<QPainterPath, Airspace *> pair( as.createRegion(), &as );
+
+      QRect bRect = pair.first.boundingRect().toAlignedRect();
+
+      if( ! bRect.intersects( pixAirspace.rect() ) )
+        {
+          // Not visible, no drawing and no hit test is needed.
+          continue;
+        }
+
+      m_hitIndex.insertRegion( bRect, airspaceRegionList.size() );
       airspaceRegionList.append( pair );
 
-      as.drawRegion( &cuAeroMapP, this->rect() );
+      as.drawRegion( &cuAeroMapP, pixAirspace.rect() );
     }
 
   cuAeroMapP.end();
   // qDebug("Airspace, drawTime=%d ms", t.elapsed());
 }
 
+void Map::__insertDrawnPoints( QList<BaseMapElement *>& drawnPoints,
+                               const int priority )
+{
+  for( int i = 0; i < drawnPoints.size(); i++ )
+    {
+      m_hitIndex.insertPoint( static_cast<SinglePoint *> (drawnPoints.at(i)),
+                              priority );
+    }
+
+  drawnPoints.clear();
+}
+
+void Map::slotClearHitIndex()
+{
+  m_hitIndex.clear( rect() );
+  m_drawnCityList.clear();
+  _globalMapContents->getAirspaceRegionList().clear();
+}
+
 void Map::__drawFlight()
 {
   pixFlight.fill(Qt::transparent);
@@ -1596,19 +1631,12 @@ void Map::dragEnterEvent( QDragEnterEvent* event )
 
 void Map::dropEvent( QDropEvent* event )
 {
-  QList<QUrl> urlList = event->mimeData()->urls();
-
-  for( int i = 0; i < urlList.size(); i++ )
-    {
-      emit openFile( urlList.at(i) );
-    }
+  emit openFiles( event->mimeData()->urls() );
 }
 
 void Map::__redrawMap()
 {
-  static QSize lastSize;
-
-  if( isDrawing )
+  if( isDrawing || renderingSections )
     {
       // Queue the redraw request
       redrawRequest = true;
@@ -1621,17 +1649,7 @@ void Map::__redrawMap()
   if( ! lastSize.isValid() || lastSize != size() )
     {
       lastSize = size();
-      pixBuffer = QPixmap( size() );
-      pixBuffer.fill(Qt::transparent);
-      pixAero = QPixmap( size() );
-      pixAirspace = QPixmap( size() );
-      pixFlight = QPixmap( size() );
-      pixPlan = QPixmap( size() );
-      pixGrid = QPixmap( size() );
-      pixUnderMap = QPixmap( size() );
-      pixIsoMap = QPixmap( size() );
-      pixWaypoints = QPixmap( size() );
-      pixFlightCursors = QPixmap( size() );
+      __createLayers( size() );
     }
 
   _globalMapMatrix->createMatrix( size() );
@@ -1640,6 +1658,42 @@ void Map::__redrawMap()
   // Status bar not set "geniously" so far...
   emit setStatusBarProgress(0);
 
+  __drawLayers();
+  //__drawPlannedTask();
+  // Linie zum aktuellen Punkt löschen
+  prePlanPos.setX(-999);
+  prePlanPos.setY(-999);
+
+  __showLayer();
+
+  emit setStatusBarProgress(100);
+
+  if( redrawRequest == true )
+    {
+      redrawMapTimer->start(500);
+      redrawRequest = false;
+    }
+
+  isDrawing = false;
+}
+
+void Map::__createLayers( const QSize& layerSize )
+{
+  pixBuffer = QPixmap( layerSize );
+  pixBuffer.fill(Qt::transparent);
+  pixAero = QPixmap( layerSize );
+  pixAirspace = QPixmap( layerSize );
+  pixFlight = QPixmap( layerSize );
+  pixPlan = QPixmap( layerSize );
+  pixGrid = QPixmap( layerSize );
+  pixUnderMap = QPixmap( layerSize );
+  pixIsoMap = QPixmap( layerSize );
+  pixWaypoints = QPixmap( layerSize );
+  pixFlightCursors = QPixmap( layerSize );
+}
+
+void Map::__drawLayers()
+{
   pixAero.fill(Qt::transparent);
   pixAirspace.fill(Qt::transparent);
   pixGrid.fill(Qt::transparent);
@@ -1654,22 +1708,86 @@ void Map::__redrawMap()
   __drawMap();
   __drawFlight();
   __drawWaypoints();
-  //__drawPlannedTask();
-  // Linie zum aktuellen Punkt löschen
-  prePlanPos.setX(-999);
-  prePlanPos.setY(-999);
+}
 
-  __showLayer();
+QImage Map::renderSection( const QPoint& center,
+                           const double scale,
+                           const QSize& pageSize,
+                           const QRect& section )
+{
+  if( isDrawing || section.isEmpty() )
+    {
+      return QImage();
+    }
 
-  emit setStatusBarProgress(100);
+  isDrawing = true;
 
-  if( redrawRequest == true )
+  // The layers are used with the size of the section. They must be created
+  // new for the widget at the next redraw. The displayed buffer is kept.
+  lastSize = QSize();
+
+  QPixmap buffer = pixBuffer;
+  __createLayers( section.size() );
+  pixBuffer = buffer;
+
+  _globalMapMatrix->centerToLatLon( center );
+  _globalMapMatrix->slotSetScale( scale );
+  _globalMapMatrix->createMatrix( pageSize, section );
+
+  __drawLayers();
+
+  QImage image( section.size(), QImage::Format_ARGB32_Premultiplied );
+  image.fill( Qt::transparent );
+
+  QPainter painter( &image );
+
+  painter.drawPixmap( 0, 0, pixIsoMap );
+  painter.drawPixmap( 0, 0, pixUnderMap );
+  painter.drawPixmap( 0, 0, pixAirspace );
+  painter.drawPixmap( 0, 0, pixFlight );
+  painter.drawPixmap( 0, 0, pixPlan );
+  painter.drawPixmap( 0, 0, pixAero );
+  painter.drawPixmap( 0, 0, pixWaypoints );
+  painter.drawPixmap( 0, 0, pixGrid );
+  painter.end();
+
+  isDrawing = false;
+
+  if( redrawRequest == true && ! renderingSections )
     {
       redrawMapTimer->start(500);
       redrawRequest = false;
     }
 
-  isDrawing = false;
+  return image;
+}
+
+void Map::beginRenderSections()
+{
+  renderingSections = true;
+  redrawMapTimer->stop();
+
+  if( timerAnimate->isActive() )
+    {
+      timerAnimate->stop();
+      animationResume = true;
+    }
+}
+
+void Map::endRenderSections()
+{
+  renderingSections = false;
+  redrawRequest = false;
+
+  __redrawMap();
+
+  if( animationResume )
+    {
+      // The rendering time does not count as playback time.
+      animationResume = false;
+      animationClock.start();
+      timerAnimate->start( ANIMATION_INTERVAL );
+    }
 }
 
 /** Save Map to PNG-file with width, height. Use actual size if width=0 & height=0 */
@@ -1758,6 +1876,12 @@ void Map::slotRedrawMap()
 
 void Map::slotScheduleRedrawMap()
 {
+  if( renderingSections )
+    {
+      // The map is redrawn by endRenderSections.
+      return;
+    }
+
   redrawMapTimer->start(500);
 }
 
@@ -1795,10 +1919,49 @@ void Map::__showLayer()
   buffer.drawPixmap(pixWaypoints.rect(), pixWaypoints);
   buffer.drawPixmap(pixGrid.rect(), pixGrid);
 
+  if( ! timerAnimate->isActive() && ! animationPaused )
+    {
+      // A finished animation is removed with the next redraw.
+      animationTracks.clear();
+    }
+
+  // The map matrix can be changed, place the glider symbols new.
+  for( int i = 0; i < animationTracks.size(); i++ )
+    {
+      AnimationTrack& track = animationTracks[i];
+      QPoint pos = _globalMapMatrix->map( track.position );
+
+      track.gliderRect = QRect( pos.x() - 20, pos.y() - 20, 40, 40 );
+    }
+
   slotDrawCursor( lastCur1Pos, lastCur2Pos );
   update();
 }
 
+void Map::__showLayer( const QRect& rect )
+{
+  QRect r = rect & pixBuffer.rect();
+
+  if( r.isEmpty() )
+    {
+      return;
+    }
+
+  QPainter buffer(&pixBuffer);
+
+  buffer.setCompositionMode( QPainter::CompositionMode_Source );
+  buffer.drawPixmap(r, pixIsoMap, r);
+  buffer.setCompositionMode( QPainter::CompositionMode_SourceOver );
+
+  buffer.drawPixmap(r, pixUnderMap, r);
+  buffer.drawPixmap(r, pixAirspace, r);
+  buffer.drawPixmap(r, pixFlight, r);
+  buffer.drawPixmap(r, pixPlan, r);
+  buffer.drawPixmap(r, pixAero, r);
+  buffer.drawPixmap(r, pixWaypoints, r);
+  buffer.drawPixmap(r, pixGrid, r);
+}
+
 void Map::__showFlightData( const QPoint& mapPos )
 {
   // Show flight data, if position is in the near of a flight.
@@ -2035,6 +2198,85 @@ void Map::slotCenterToTask()
   emit changed( size() );
 }
 
+/**
+ * Builds the position streams of the flights to animate.
+ */
+void Map::__prepareAnimation( const QList<Flight *>& flightList )
+{
+  animationTracks.clear();
+
+  // The flights of a group can be from different days. They are shifted by
+  // whole days, so that they are compared at the same time of day.
+  QVector<time_t> shifts( flightList.size(), 0 );
+  time_t refTime = 0;
+  time_t begin = 0;
+  bool first = true;
+
+  for( int i = 0; i < flightList.size(); i++ )
+    {
+      Flight *flight = flightList.at(i);
+
+      if( flight->getRouteLength() == 0 )
+        {
+          continue;
+        }
+
+      time_t start = flight->getPoint(0).time;
+
+      if( first )
+        {
+          refTime = start;
+        }
+
+      shifts[i] = (time_t) qRound( (start - refTime) / 86400.0 ) * 86400;
+
+      if( first || start - shifts[i] < begin )
+        {
+          begin = start - shifts[i];
+        }
+
+      first = false;
+    }
+
+  for( int i = 0; i < flightList.size(); i++ )
+    {
+      Flight *flight = flightList.at(i);
+      int count = (int) flight->getRouteLength();
+
+      AnimationTrack track;
+      track.flight = flight;
+      track.times.resize( count );
+      track.positions.resize( count );
+      track.rotations.resize( count );
+
+      for( int n = 0; n < count; n++ )
+        {
+          FlightPoint cP = flight->getPoint(n);
+
+          track.times[n]     = (int) (cP.time - shifts[i] - begin);
+          track.positions[n] = cP.projP;
+
+          int bearing = (int) rint(cP.bearing * 180.0 / M_PI);
+
+          bearing = ((bearing % 360) + 360) % 360;
+
+          // We only rotate in steps of 15 degrees.
+          track.rotations[n] = (( bearing + 7 ) / 15 ) % 24;
+        }
+
+      if( count > 0 )
+        {
+          track.position = track.positions[0];
+          track.rotation = track.rotations[0];
+
+          QPoint pos = _globalMapMatrix->map( track.position );
+          track.gliderRect = QRect( pos.x() - 20, pos.y() - 20, 40, 40 );
+        }
+
+      animationTracks.append( track );
+    }
+}
+
 /**
  * Called to start the animation timer.
  */
@@ -2047,14 +2289,19 @@ void Map::slotAnimateFlightStart()
       return;
     }
 
-  if( animationPaused )
+  if( animationPaused && animationTracks.size() > 0 )
     {
-      // Animation was paused, continue animation.
+      // Animation was paused, continue animation. The pause does not count
+      // as playback time.
       animationPaused = false;
-      timerAnimate->start( 50 );
+      animationClock.start();
+      timerAnimate->start( ANIMATION_INTERVAL );
       return;
     }
 
+  timerAnimate->stop();
+  animationPaused = false;
+
   // Loop through the flight list and reset animation flag.
   for( int i = 0; i < flightList.size(); i++ )
     {
@@ -2067,34 +2314,19 @@ void Map::slotAnimateFlightStart()
   // flights will not be visible as nAnimationIndex is zero for all flights to animate.
   slotRedrawFlight();
 
-  for( int i = 0; i < flightList.size(); i++ )
-    {
-      Flight *flight = flightList.at(i);
-      FlightPoint cP = flight->getPoint(0);
-      QPoint prePos  = _globalMapMatrix->map(cP.projP);
-      QPoint pos     = prePos;
-
-      // Save map part, which will be overwritten by glider symbol.
-      QPixmap pix = pixBuffer.copy( pos.x() - 20, pos.y() - 20, 40, 40 );
-
-      flight->setLastAnimationPos(pos);
-      flight->setLastAnimationPixmap(pix);
+  __prepareAnimation( flightList );
 
-      int bearing = (int) rint(cP.bearing * 180.0 / M_PI);
+  animationSpeed = qMax( 1, _settings.value( "/Flight/AnimationSpeed", 60 ).toInt() );
+  animationTime  = 0.0;
+  animationClock.start();
 
-      // We only rotate in steps of 15 degrees.
-      int rot = (( bearing + 7 ) / 15 ) % 24;
-
-      // Draw the right glider symbol at the map.
-      QPainter p( &pixBuffer );
-      p.drawPixmap( pos.x() - 20, pos.y() - 20, pixGliders, rot*40, 0, 40, 40 );
+  // Show the glider symbols at the start points.
+  for( int i = 0; i < animationTracks.size(); i++ )
+    {
+      update( animationTracks.at(i).gliderRect );
     }
 
-  // Force an immediate redraw of the map to see the animation.
-  repaint();
-
-  // start 50ms timer
-  timerAnimate->start( 50 );
+  timerAnimate->start( ANIMATION_INTERVAL );
 }
 
 /**
@@ -2107,7 +2339,10 @@ void Map::slotAnimateFlightPause()
 }
 
 /**
- * Called for every timeout of the animation timer.
+ * Called for every timeout of the animation timer. The playback time is
+ * derived from the real time, so that the animation speed does not depend
+ * on the timer accuracy and the fix rate of the flights. Only the new parts
+ * of the flights and the moved glider symbols are repainted.
  */
 void Map::slotAnimateFlightTimeout()
 {
@@ -2115,59 +2350,109 @@ void Map::slotAnimateFlightTimeout()
 
   QList<Flight *> flightList = getFlightList();
 
-  if( flightList.size() == 0 )
+  if( flightList.size() == 0 || flightList.size() != animationTracks.size() )
     {
+      // The animated flights are not longer available.
       animationPaused = false;
       timerAnimate->stop();
+      animationTracks.clear();
+      update();
       return;
     }
 
-  // Loop through the flight list and reset animation flag.
-  for( int i = 0; i < flightList.size(); i++ )
+  animationTime += animationClock.restart() * animationSpeed / 1000.0;
+
+  QRegion dirty;
+
+  for( int i = 0; i < animationTracks.size(); i++ )
     {
-      Flight *flight = flightList.at(i);
+      AnimationTrack& track = animationTracks[i];
+      Flight *flight = track.flight;
 
-      flight->setAnimationNextIndex();
+      if( flightList.at(i) != flight )
+        {
+          animationPaused = false;
+          timerAnimate->stop();
+          animationTracks.clear();
+          update();
+          return;
+        }
+
+      int count = track.times.size();
 
-      if( flight->isAnimationActive() )
+      if( count == 0 )
         {
-          bDone = false;
+          flight->setAnimationActive( false );
+          continue;
         }
 
-      // Write info from current point on statusbar. The last flight in the list
-      // is always the winner.
-      FlightPoint cP = flight->getPoint( (flight->getAnimationIndex()) );
-      QPoint pos = _globalMapMatrix->map( cP.projP );
-      QPoint lastpos = flight->getLastAnimationPos();
-      QPixmap& pix = flight->getLastAnimationPixmap();
-      emit showFlightPoint( cP.origP, cP );
+      int last = track.index;
 
-      // Show elevation in status bar
-      emit elevation(cP.surfaceHeight);
+      while( track.index + 1 < count && track.times[track.index + 1] <= animationTime )
+        {
+          track.index++;
+        }
+
+      if( track.index + 1 < count )
+        {
+          bDone = false;
+
+          // Move the glider between the route points.
+          int t0 = track.times[track.index];
+          int t1 = track.times[track.index + 1];
+          double f = 0.0;
+
+          if( t1 > t0 && animationTime > t0 )
+            {
+              f = (animationTime - t0) / (t1 - t0);
+            }
 
-      // Erase previous glider symbol
-      QPainter p;
-      p.begin( &pixBuffer );
-      p.drawPixmap( lastpos.x() - 20, lastpos.y() - 20, pix );
+          const QPoint& p0 = track.positions[track.index];
+          const QPoint& p1 = track.positions[track.index + 1];
 
-      // Draw flight up to this point in pixFlight.
-      __drawFlight();
+          track.position = p0 + (p1 - p0) * f;
+        }
+      else
+        {
+          track.position = track.positions.last();
+          flight->setAnimationActive( false );
+        }
 
-      // draw flight at the map.
-      p.drawPixmap( 0, 0, pixFlight );
+      if( track.index != last )
+        {
+          flight->setAnimationIndex( track.index );
 
-      // save map part for next timeout
-      pix = pixBuffer.copy( pos.x() - 20, pos.y() - 20, 40, 40 );
-      flight->setLastAnimationPos(pos);
+          // Draw the new part of the flight and show it in the buffer.
+          QPainter flightP( &pixFlight );
+          QRect r = flight->drawAnimationPart( &flightP, last, track.index );
+          flightP.end();
 
-      int bearing = (int) rint(cP.bearing * 180.0 / M_PI);
+          if( ! r.isEmpty() )
+            {
+              __showLayer( r );
+              dirty += r;
+            }
 
-      // We only rotate in steps of 15 degrees.
-      int rot = (( bearing + 7 ) / 15 ) % 24;
+          // Write info from current point on statusbar. The last flight in
+          // the list is always the winner.
+          FlightPoint cP = flight->getPoint( track.index );
+          emit showFlightPoint( cP.origP, cP );
 
-      // draw the right glider symbol at the map
-      p.drawPixmap( pos.x() - 20, pos.y() - 20, pixGliders, rot*40, 0, 40, 40 );
-      p.end();
+          // Show elevation in status bar
+          emit elevation( cP.surfaceHeight );
+        }
+
+      QPoint pos = _globalMapMatrix->map( track.position );
+      QRect gliderRect( pos.x() - 20, pos.y() - 20, 40, 40 );
+      int rotation = track.rotations[track.index];
+
+      if( gliderRect != track.gliderRect || rotation != track.rotation )
+        {
+          dirty += track.gliderRect;
+          dirty += gliderRect;
+          track.gliderRect = gliderRect;
+          track.rotation   = rotation;
+        }
     }
 
   if( bDone )
@@ -2175,10 +2460,10 @@ void Map::slotAnimateFlightTimeout()
       // if one of the flights still is active, bDone will be false
       timerAnimate->stop();
     }
-  else
+
+  if( ! dirty.isEmpty() )
     {
-      // force a paint event of the map
-      repaint();
+      update( dirty );
     }
 }
 
@@ -2197,11 +2482,13 @@ void Map::slotAnimateFlightStop()
 
   // Reset animation pause flag
   animationPaused = false;
+  animationTracks.clear();
 
   QList<Flight *> flightList = getFlightList();
 
   if( flightList.size() == 0 )
     {
+      update();
       return;
     }
 
@@ -2546,8 +2833,8 @@ bool Map::__getTaskWaypoint( const QPoint& current,
 void Map::__drawWaypoints()
 {
   // get map screen size
-  int w = size().width();
-  int h = size().height();
+  int w = pixWaypoints.width();
+  int h = pixWaypoints.height();
 
   QRect testRect(-10, -10, w + 20, h + 20);
   QString labelText;
@@ -3246,76 +3533,50 @@ QString Map::calculateRealMapScale( const int metersPerPixel )
 
 bool Map::findMapPoint( int delta, const QPoint& mapPosition, Waypoint *w )
 {
-  // compose search list
-  QList<int> searchList;
-  searchList << MapContents::GliderfieldList
-	     << MapContents::AirfieldList
-	     << MapContents::OutLandingList
-	     << MapContents::NavaidList
-	     << MapContents::HotspotList;
-
-  int dX, dY;
-
   // select Waypoint
   QRegExp blank( "[ ]" );
 
-  for( int k = 0; k < searchList.size(); k++ )
-    {
-      for( int i = 0; i < _globalMapContents->getListLength(searchList.at(k) ); i++ )
-      {
-        SinglePoint *sp = dynamic_cast<SinglePoint *>(_globalMapContents->getElement(searchList.at(k), i));
-
-          if( sp == 0 )
-            {
-              continue;
-            }
+  // Only the drawn point elements near to the position are checked.
+  SinglePoint *sp = m_hitIndex.findPoint( mapPosition, delta );
 
-        QPoint sitePos = sp->getMapPosition();
-
-        dX = abs( sitePos.x() - mapPosition.x() );
-        dY = abs( sitePos.y() - mapPosition.y() );
+  if( sp )
+    {
+      QString name = sp->getName();
+      w->name = name.replace( blank, "" ).left( 8 ).toUpper();
+      w->description = sp->getName();
+      w->country = sp->getCountry();
+      w->type = sp->getTypeID();
+      w->origP = sp->getWGSPosition();
+      w->projP = sp->getPosition();
+      w->elevation = sp->getElevation();
+      w->comment = sp->getComment();
+      w->icao = "";
+      w->frequency = 0.0;
+      w->rwyList.clear();
 
-        // Abstand entspricht der Icon-Größe.
-        if( dX < delta && dY < delta )
-          {
-            QString name = sp->getName();
-            w->name = name.replace( blank, "" ).left( 8 ).toUpper();
-            w->description = sp->getName();
-            w->country = sp->getCountry();
-            w->type = sp->getTypeID();
-            w->origP = sp->getWGSPosition();
-            w->projP = sp->getPosition();
-            w->elevation = sp->getElevation();
-            w->comment = sp->getComment();
-            w->icao = "";
-            w->frequency = 0.0;
-            w->rwyList.clear();
-
-            Airfield *af   = dynamic_cast<Airfield *>(sp); // try casting to an airfield
-            RadioPoint *rp = dynamic_cast<RadioPoint *>(sp); // try casting to a navaid
-
-            if( af )
-              {
-                w->icao = af->getICAO();
-                w->frequency = af->getFrequency();
-                w->rwyList = af->getRunwayList();
-              }
-            else if( rp )
-              {
-                w->icao = rp->getICAO();
-                w->frequency = rp->getFrequency();
-                w->comment = rp->getAdditionalText();
-              }
-            else
-              {
-                w->icao = "";
-                w->frequency = 0.0;
-                w->rwyList.clear();
-              }
+      Airfield *af   = dynamic_cast<Airfield *>(sp); // try casting to an airfield
+      RadioPoint *rp = dynamic_cast<RadioPoint *>(sp); // try casting to a navaid
 
-          return true;
+      if( af )
+        {
+          w->icao = af->getICAO();
+          w->frequency = af->getFrequency();
+          w->rwyList = af->getRunwayList();
         }
-      }
+      else if( rp )
+        {
+          w->icao = rp->getICAO();
+          w->frequency = rp->getFrequency();
+          w->comment = rp->getAdditionalText();
+        }
+      else
+        {
+          w->icao = "";
+          w->frequency = 0.0;
+          w->rwyList.clear();
+        }
+
+      return true;
     }
 
   return false;
@@ -32,16 +32,20 @@
 #define MAP_H
 
 #include <QBitmap>
+#include <QImage>
 #include <QList>
 #include <QMenu>
 #include <QRegion>
 #include <QSize>
+#include <QTime>
 #include <QTimer>
 #include <QUrl>
+#include <QVector>
 #include <QWheelEvent>
 #include <QWidget>
 
 #include "flighttask.h"
+#include "maphitindex.h"
 #include "waypointcatalog.h"
 
 class Flight;
@@ -102,6 +106,44 @@ private:
      */
     bool findMapPoint( int delta, const QPoint& mapPosition, Waypoint *w );
 
+    /**
+     * Renders a section of a map page offscreen. The page is centered to the
+     * passed position and drawn in the passed scale with the same elements
+     * and layers as the displayed map. Large pages are rendered section by
+     * section to limit the size of the layers. The displayed map is not
+     * changed, but the map matrix is left in the page state. The caller has
+     * to restore it and to call \ref endRenderSections afterwards.
+     *
+     * \param center Center of the page in KFLog coordinates, latitude and
+     *               longitude
+     *
+     * \param scale Scale of the page in meters per pixel
+     *
+     * \param pageSize Size of the whole page in pixels
+     *
+     * \param section Part of the page to be rendered
+     *
+     * \return The rendered section or a null image, if the map is just drawn.
+     */
+    QImage renderSection( const QPoint& center,
+                          const double scale,
+                          const QSize& pageSize,
+                          const QRect& section );
+
+    /**
+     * Must be called before sections are rendered by \ref renderSection.
+     * A running flight animation is stopped and redraws of the displayed map
+     * are suppressed, because both would use the layers and the map matrix
+     * of the page, if events are processed between the sections.
+     */
+    void beginRenderSections();
+
+    /**
+     * Must be called after the map matrix has been restored. Redraws the
+     * displayed map and resumes a stopped flight animation.
+     */
+    void endRenderSections();
+
   public slots:
 
     /**  */
@@ -110,6 +152,11 @@ private:
     void slotRedrawMap();
     /** */
     void slotScheduleRedrawMap();
+    /**
+     * Clears the hit index and the drawn city list. Must be called, if the
+     * map contents have been removed.
+     */
+    void slotClearHitIndex();
     /** */
     void slotCenterToFlight();
     /** */
@@ -124,8 +171,9 @@ private:
     void slotRedrawFlight();
     /**
      * Animation slot.
-     * Called for every timeout of the animation timer. Advances the cross-hair
-     * one single step.
+     * Called for every timeout of the animation timer. Advances the animated
+     * flights to the current playback time and repaints only the changed
+     * parts of the map.
      */
     void slotAnimateFlightTimeout();
     /**
@@ -213,7 +261,7 @@ private:
     /** */
     void setStatusBarMsg(const QString&);
     /** */
-    void openFile(const QUrl& surl);
+    void openFiles(const QList<QUrl>& urls);
     /** */
     void showFlightPoint(const QPoint& pos, const FlightPoint& point);
     /** */
@@ -307,10 +355,28 @@ private:
      * Redraws the map.
      */
     void __redrawMap();
+    /**
+     * Creates all layer pixmaps with the passed size.
+     */
+    void __createLayers( const QSize& layerSize );
+    /**
+     * Clears the layers and draws the map, flight and waypoint layers
+     * according to the current map matrix.
+     */
+    void __drawLayers();
     /**
      * Copies the pixmaps into pixBuffer and calls a paintEvent().
      */
     void __showLayer();
+    /**
+     * Composes the layers into the buffer inside of the rectangle only.
+     * Used by the flight animation to show new parts of the flight.
+     */
+    void __showLayer( const QRect& rect );
+    /**
+     * Builds the animation tracks of the flights.
+     */
+    void __prepareAnimation( const QList<Flight *>& flightList );
 
     /**
      *  Show flight data, if position is in the near of a flight.
@@ -329,6 +395,12 @@ private:
      * Draws all airspaces on the map.
      */
     void __drawAirspaces();
+    /**
+     * Puts the drawn point elements into the hit index and clears the
+     * passed list.
+     */
+    void __insertDrawnPoints( QList<BaseMapElement *>& drawnPoints,
+                              const int priority );
     /**
      */
     void __drawFlight();
@@ -449,7 +521,6 @@ private:
 
     QPoint prePos;
     QPoint prePlanPos;
-    QPoint preAnimationPos;
 
     /** Map coordinates of previous flight step point. */
     QPoint preStepPos;
@@ -466,6 +537,46 @@ private:
     QTimer* timerAnimate;
     /** Flag to indicate an animation pause. */
     bool animationPaused;
+    /** Measures the real time between two animation timeouts. */
+    QTime animationClock;
+    /** Playback time of the animation in seconds since its begin. */
+    double animationTime;
+    /** Playback seconds per real second. */
+    int animationSpeed;
+
+    /**
+     * Position stream of an animated flight. The times of all tracks refer
+     * to the same animation begin, so that the flights of a group are
+     * animated synchronously.
+     */
+    class AnimationTrack
+    {
+     public:
+
+      AnimationTrack() :
+        flight(0),
+        index(0),
+        rotation(0)
+      {};
+
+      Flight* flight;
+      /** Playback times of the route points in seconds. */
+      QVector<int> times;
+      /** Projected positions of the route points. */
+      QVector<QPoint> positions;
+      /** Glider symbol numbers of the route points. */
+      QVector<char> rotations;
+      /** Index of the last passed route point. */
+      int index;
+      /** Projected glider position, interpolated between the route points. */
+      QPoint position;
+      int rotation;
+      /** Map area, where the glider symbol is drawn. */
+      QRect gliderRect;
+    };
+
+    /** The tracks of the animated flights. */
+    QList<AnimationTrack> animationTracks;
     /**
      * contains planning task points
      * enthält die Punkte!!!
@@ -524,6 +635,15 @@ private:
     bool isDrawing;
     bool redrawRequest;
 
+    /** Set between beginRenderSections and endRenderSections. */
+    bool renderingSections;
+
+    /** Set, if the animation was stopped by beginRenderSections. */
+    bool animationResume;
+
+    /** Size of the layers for the widget, invalid if they must be created. */
+    QSize lastSize;
+
     /** Reference to the redraw timer */
     QTimer *redrawMapTimer;
 
@@ -537,6 +657,9 @@ private:
 
     /** List of drawn cities. */
     QList<BaseMapElement *> m_drawnCityList;
+
+    /** Screen space index of the drawn point elements and airspaces. */
+    MapHitIndex m_hitIndex;
 };
 
 #endif
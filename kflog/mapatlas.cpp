@@ -0,0 +1,453 @@
+/***********************************************************************
+**
+**   mapatlas.cpp
+**
+**   This file is part of KFLog.
+**
+************************************************************************
+**
+**   Copyright (c):  2026 by agent <agent@local>
+**
+**   This file is distributed under the terms of the General Public
+**   License. See the file COPYING for more information.
+**
+***********************************************************************/
+
+#ifdef QT_5
+    #include <QtWidgets>
+    #include <QPrinter>
+#else
+    #include <QtGui>
+#endif
+
+#include "flight.h"
+#include "flightgroup.h"
+#include "flighttask.h"
+#include "mainwindow.h"
+#include "map.h"
+#include "mapatlas.h"
+#include "mapmatrix.h"
+#include "target.h"
+
+extern MainWindow *_mainWindow;
+extern Map        *_globalMap;
+extern MapMatrix  *_globalMapMatrix;
+
+const int MapAtlas::Dpi = 150;
+
+// Maximum width and height of a section rendered by the map.
+#define SECTION_SIZE 1024
+
+// Part of the page width and height at every border, which is shared with
+// the neighbour pages.
+#define PAGE_OVERLAP 0.1
+
+MapAtlas::MapAtlas( const double scale, const QSize& pageSize ) :
+  m_scale(scale),
+  m_pageSize(pageSize)
+{
+  m_mapCenter = _globalMapMatrix->getMapCenter();
+  m_mapScale  = _globalMapMatrix->getScale( MapMatrix::CurrentScale );
+}
+
+MapAtlas::~MapAtlas()
+{
+}
+
+void MapAtlas::addPage( const QPoint& center )
+{
+  m_pages.append( center );
+}
+
+int MapAtlas::createPages( BaseFlightElement* element )
+{
+  if( element == 0 )
+    {
+      return 0;
+    }
+
+  QList<QPoint> route;
+
+  switch( element->getTypeID() )
+    {
+      case BaseMapElement::FlightGroup:
+        {
+          // The flights of a group have normally the same task, the first
+          // flight is used.
+          QList<Flight *>& flights = dynamic_cast<FlightGroup *>(element)->getFlightList();
+
+          if( flights.isEmpty() )
+            {
+              return 0;
+            }
+
+          element = flights.first();
+        }
+
+        // fall through
+
+      case BaseMapElement::Flight:
+        {
+          Flight* flight = dynamic_cast<Flight *>(element);
+
+          for( int i = 0; i < flight->getRouteLength(); i++ )
+            {
+              route.append( flight->getPoint(i).origP );
+            }
+
+          break;
+        }
+
+      case BaseMapElement::Task:
+        {
+          QList<Waypoint *> wpList = dynamic_cast<FlightTask *>(element)->getWPList();
+
+          for( int i = 0; i < wpList.size(); i++ )
+            {
+              route.append( wpList.at(i)->origP );
+            }
+
+          break;
+        }
+
+      default:
+        break;
+    }
+
+  if( route.isEmpty() )
+    {
+      return 0;
+    }
+
+  int count = m_pages.size();
+
+  __layoutPages( route );
+  __restoreMatrix();
+
+  return m_pages.size() - count;
+}
+
+void MapAtlas::__layoutPages( const QList<QPoint>& route )
+{
+  QTime t;
+  t.start();
+
+  // The pages are placed in the pixel coordinates of a page, which is
+  // centered to the route.
+  int latMin = route.first().x();
+  int latMax = latMin;
+  int lonMin = route.first().y();
+  int lonMax = lonMin;
+
+  for( int i = 1; i < route.size(); i++ )
+    {
+      latMin = qMin( latMin, route.at(i).x() );
+      latMax = qMax( latMax, route.at(i).x() );
+      lonMin = qMin( lonMin, route.at(i).y() );
+      lonMax = qMax( lonMax, route.at(i).y() );
+    }
+
+  _globalMapMatrix->centerToLatLon( (latMin + latMax) / 2, (lonMin + lonMax) / 2 );
+  _globalMapMatrix->slotSetScale( m_scale );
+  _globalMapMatrix->createMatrix( m_pageSize );
+
+  const int maxWidth  = (int) (m_pageSize.width() * (1.0 - 2 * PAGE_OVERLAP));
+  const int maxHeight = (int) (m_pageSize.height() * (1.0 - 2 * PAGE_OVERLAP));
+
+  QPoint last = _globalMapMatrix->map( _globalMapMatrix->wgsToMap( route.first() ) );
+  QRect box( last, last );
+
+  for( int i = 1; i < route.size(); i++ )
+    {
+      QPoint pos = _globalMapMatrix->map( _globalMapMatrix->wgsToMap( route.at(i) ) );
+
+      QRect next = box.united( QRect( pos, pos ) );
+
+      if( next.width() > maxWidth || next.height() > maxHeight )
+        {
+          // The point is outside of the page. The page is closed and the
+          // next one starts with the segment to the point.
+          QPoint center = _globalMapMatrix->mapToWgs( box.center() );
+          m_pages.append( QPoint( center.y(), center.x() ) );
+
+          next = QRect( last, last ).united( QRect( pos, pos ) );
+        }
+
+      box  = next;
+      last = pos;
+    }
+
+  QPoint center = _globalMapMatrix->mapToWgs( box.center() );
+  m_pages.append( QPoint( center.y(), center.x() ) );
+
+  qDebug( "MapAtlas: %d route points, %d pages, layout %dms",
+          route.size(), m_pages.size(), t.elapsed() );
+}
+
+QImage MapAtlas::__renderPage( const int index )
+{
+  QImage page( m_pageSize, QImage::Format_RGB32 );
+  page.fill( qRgb( 255, 255, 255 ) );
+
+  QPainter painter( &page );
+
+  for( int y = 0; y < m_pageSize.height(); y += SECTION_SIZE )
+    {
+      for( int x = 0; x < m_pageSize.width(); x += SECTION_SIZE )
+        {
+          QRect section( x, y,
+                         qMin( SECTION_SIZE, m_pageSize.width() - x ),
+                         qMin( SECTION_SIZE, m_pageSize.height() - y ) );
+
+          QImage image = _globalMap->renderSection( m_pages.at(index),
+                                                    m_scale,
+                                                    m_pageSize,
+                                                    section );
+          if( image.isNull() )
+            {
+              return QImage();
+            }
+
+          painter.drawImage( section.topLeft(), image );
+        }
+    }
+
+  QFont font;
+  font.setBold( true );
+  font.setPointSize( 10 );
+  font.setStyle( QFont::StyleItalic );
+  font.setStyleHint( QFont::SansSerif );
+
+  painter.setFont( font );
+  painter.setPen( Qt::black );
+
+  QString text = QObject::tr( "Page %1 of %2" ).arg( index + 1 ).arg( m_pages.size() ) +
+                 QString( "  -  %1created by KFLog %2 (www.kflog.org)" )
+                 .arg( QChar(Qt::Key_copyright) )
+                 .arg( KFLOG_VERSION );
+
+  painter.drawText( 10, m_pageSize.height() - 10, text );
+
+  return page;
+}
+
+void MapAtlas::__restoreMatrix()
+{
+  _globalMapMatrix->centerToLatLon( m_mapCenter );
+  _globalMapMatrix->slotSetScale( m_mapScale );
+  _globalMapMatrix->createMatrix( _globalMap->size() );
+}
+
+bool MapAtlas::print( QPrinter* printer )
+{
+  if( m_pages.isEmpty() )
+    {
+      return false;
+    }
+
+  QPainter painter;
+
+  if( ! painter.begin( printer ) )
+    {
+      return false;
+    }
+
+  QTime t;
+  t.start();
+
+  QProgressDialog progress( _mainWindow );
+  progress.setWindowModality( Qt::WindowModal );
+  progress.setWindowTitle( QObject::tr("Printing map...") );
+  progress.setRange( 0, m_pages.size() );
+  progress.setMinimumDuration( 0 );
+
+  // The pages are rendered with the aspect ratio of the printer page.
+  const QRect target( 0, 0, printer->pageRect().width(), printer->pageRect().height() );
+
+  bool ok = true;
+
+  _globalMap->beginRenderSections();
+
+  for( int i = 0; i < m_pages.size(); i++ )
+    {
+      progress.setLabelText( QObject::tr("Rendering page %1 of %2")
+                             .arg( i + 1 ).arg( m_pages.size() ) );
+      progress.setValue( i );
+
+      if( progress.wasCanceled() )
+        {
+          ok = false;
+          break;
+        }
+
+      QImage page = __renderPage( i );
+
+      if( page.isNull() )
+        {
+          ok = false;
+          break;
+        }
+
+      if( i > 0 )
+        {
+          printer->newPage();
+        }
+
+      painter.drawImage( target, page );
+    }
+
+  painter.end();
+  progress.setValue( m_pages.size() );
+
+  __restoreMatrix();
+  _globalMap->endRenderSections();
+
+  qDebug( "MapAtlas: %d pages printed in %dms", m_pages.size(), t.elapsed() );
+
+  return ok;
+}
+
+bool MapAtlas::exportImages( const QString& fileName )
+{
+  if( m_pages.isEmpty() )
+    {
+      return false;
+    }
+
+  QTime t;
+  t.start();
+
+  QFileInfo fi( fileName );
+  const QString base = fi.absolutePath() + "/" + fi.completeBaseName();
+
+  QProgressDialog progress( _mainWindow );
+  progress.setWindowModality( Qt::WindowModal );
+  progress.setWindowTitle( QObject::tr("Saving map atlas...") );
+  progress.setRange( 0, m_pages.size() );
+  progress.setMinimumDuration( 0 );
+
+  // The rendering needs the GUI thread. The pages are encoded and written
+  // by the pool, while the next pages are rendered.
+  QThreadPool pool;
+  QList<MapAtlasWriteTask *> tasks;
+
+  bool ok = true;
+
+  _globalMap->beginRenderSections();
+
+  for( int i = 0; i < m_pages.size(); i++ )
+    {
+      progress.setLabelText( QObject::tr("Rendering page %1 of %2")
+                             .arg( i + 1 ).arg( m_pages.size() ) );
+      progress.setValue( i );
+
+      if( progress.wasCanceled() )
+        {
+          ok = false;
+          break;
+        }
+
+      QImage page = __renderPage( i );
+
+      if( page.isNull() )
+        {
+          ok = false;
+          break;
+        }
+
+      QString name = QString( "%1_%2.png" ).arg( base ).arg( i + 1, 2, 10, QChar('0') );
+
+      MapAtlasWriteTask* task = new MapAtlasWriteTask( page, name );
+      task->setAutoDelete( false );
+      tasks.append( task );
+      pool.start( task );
+    }
+
+  __restoreMatrix();
+  _globalMap->endRenderSections();
+
+  pool.waitForDone();
+  progress.setValue( m_pages.size() );
+
+  for( int i = 0; i < tasks.size(); i++ )
+    {
+      if( ! tasks.at(i)->isOk() )
+        {
+          qWarning() << "MapAtlas: Cannot write" << tasks.at(i)->fileName();
+          ok = false;
+        }
+    }
+
+  qDeleteAll( tasks );
+
+  qDebug( "MapAtlas: %d pages saved in %dms", m_pages.size(), t.elapsed() );
+
+  return ok;
+}
+
+double MapAtlas::ratioToScale( const int ratio )
+{
+  // meters per inch divided by the pixels per inch
+  return ratio * 0.0254 / Dpi;
+}
+
+QSize MapAtlas::pageSize( QPrinter* printer )
+{
+  return pageSize( printer->pageRect( QPrinter::Millimeter ).size() );
+}
+
+QSize MapAtlas::pageSize( const QSizeF& paperSize )
+{
+  return QSize( qRound( paperSize.width() / 25.4 * Dpi ),
+                qRound( paperSize.height() / 25.4 * Dpi ) );
+}
+
+double MapAtlas::selectScale( QWidget* parent )
+{
+  static const int ratios[] = { 100000, 200000, 500000, 1000000 };
+
+  QStringList scaleList;
+
+  scaleList.append("1:100.000");
+  scaleList.append("1:200.000");
+  scaleList.append("1:500.000");
+  scaleList.append("1:1.000.000");
+
+  bool ok = false;
+
+  QString scale = QInputDialog::getItem( parent,
+                                         QObject::tr("Map Atlas"),
+                                         QObject::tr("Map Scale") + ":",
+                                         scaleList,
+                                         1,
+                                         false,
+                                         &ok );
+  if( ! ok )
+    {
+      return 0.0;
+    }
+
+  return ratioToScale( ratios[scaleList.indexOf( scale )] );
+}
+
+/*---------------------- MapAtlasWriteTask -----------------------------------*/
+
+MapAtlasWriteTask::MapAtlasWriteTask( const QImage& image, const QString& fileName ) :
+  QRunnable(),
+  m_image(image),
+  m_fileName(fileName),
+  m_ok(false)
+{
+}
+
+MapAtlasWriteTask::~MapAtlasWriteTask()
+{
+}
+
+void MapAtlasWriteTask::run()
+{
+  m_ok = m_image.save( m_fileName, "png" );
+
+  // Release the page, it is not needed anymore.
+  m_image = QImage();
+}
@@ -0,0 +1,211 @@
+/***********************************************************************
+**
+**   mapatlas.h
+**
+**   This file is part of KFLog.
+**
+************************************************************************
+**
+**   Copyright (c):  2026 by agent <agent@local>
+**
+**   This file is distributed under the terms of the General Public
+**   License. See the file COPYING for more information.
+**
+***********************************************************************/
+
+/**
+ * \class MapAtlas
+ *
+ * \author agent
+ *
+ * \brief Prints and exports the map page by page.
+ *
+ * A map atlas consists of pages with a fixed scale and size. The pages can
+ * be placed along a flight or a task, so that the whole route is covered by
+ * overlapping pages, or a single page can be centered to a position.
+ *
+ * Every page is rendered offscreen by the map in sections, independent of
+ * the displayed map. The sections are drawn with the same map elements and
+ * projected points as the displayed map. The rendered pages are sent to a
+ * printer or are written as PNG files. The PNG encoding is done by a thread
+ * pool, while the next pages are rendered.
+ *
+ * \date 2026
+ *
+ * \version 1.0
+ */
+
+#ifndef MAP_ATLAS_H
+#define MAP_ATLAS_H
+
+#include <QImage>
+#include <QList>
+#include <QPoint>
+#include <QRunnable>
+#include <QSize>
+#include <QSizeF>
+#include <QString>
+
+class BaseFlightElement;
+class QPrinter;
+class QWidget;
+
+class MapAtlas
+{
+ public:
+
+  /**
+   * \param scale Scale of the pages in meters per pixel
+   *
+   * \param pageSize Size of a page in pixels
+   */
+  MapAtlas( const double scale, const QSize& pageSize );
+
+  virtual ~MapAtlas();
+
+  /**
+   * Adds a page centered to the position.
+   *
+   * \param center Center of the page in KFLog coordinates, latitude and
+   *               longitude
+   */
+  void addPage( const QPoint& center );
+
+  /**
+   * Places pages along the route of a flight, a flight group or a task.
+   *
+   * \return The number of added pages.
+   */
+  int createPages( BaseFlightElement* element );
+
+  /** \return The number of pages. */
+  int count() const
+  {
+    return m_pages.size();
+  };
+
+  /**
+   * Renders all pages into the printer, one printer page for every atlas
+   * page.
+   *
+   * \return True in case of success.
+   */
+  bool print( QPrinter* printer );
+
+  /**
+   * Renders all pages and writes them as PNG files. The page number is
+   * appended to the base name of the passed file name.
+   *
+   * \return True in case of success.
+   */
+  bool exportImages( const QString& fileName );
+
+  /**
+   * \return The scale in meters per pixel for a map scale 1:ratio.
+   */
+  static double ratioToScale( const int ratio );
+
+  /**
+   * \return The size of a printer page in pixels.
+   */
+  static QSize pageSize( QPrinter* printer );
+
+  /**
+   * \return The size of a paper in pixels.
+   *
+   * \param paperSize Width and height of the paper in mm
+   */
+  static QSize pageSize( const QSizeF& paperSize );
+
+  /**
+   * Asks the user for the scale of the atlas pages.
+   *
+   * \return The selected scale in meters per pixel or 0, if the user has
+   *         canceled the dialog.
+   */
+  static double selectScale( QWidget* parent );
+
+  /** Resolution of the rendered pages in dots per inch */
+  static const int Dpi;
+
+ private:
+
+  Q_DISABLE_COPY ( MapAtlas )
+
+  /**
+   * Places the pages along a route of KFLog coordinates, latitude and
+   * longitude. Consecutive pages overlap, at least the connecting segment
+   * of the route is shown on both pages.
+   */
+  void __layoutPages( const QList<QPoint>& route );
+
+  /**
+   * Renders a page section by section.
+   *
+   * \return The rendered page or a null image in case of an error.
+   */
+  QImage __renderPage( const int index );
+
+  /**
+   * Restores the matrix of the displayed map.
+   */
+  void __restoreMatrix();
+
+  double m_scale;
+  QSize  m_pageSize;
+
+  /** Centers of the pages in KFLog coordinates */
+  QList<QPoint> m_pages;
+
+  /** Map center and scale before the rendering */
+  QPoint m_mapCenter;
+  double m_mapScale;
+};
+
+/**
+ * \class MapAtlasWriteTask
+ *
+ * \author agent
+ *
+ * \brief Writes a rendered atlas page as PNG file in a thread pool.
+ *
+ * \date 2026
+ *
+ * \version 1.0
+ */
+class MapAtlasWriteTask : public QRunnable
+{
+ public:
+
+  MapAtlasWriteTask( const QImage& image, const QString& fileName );
+
+  virtual ~MapAtlasWriteTask();
+
+  /**
+   * Encodes and writes the image. Called by the thread pool.
+   */
+  void run();
+
+  const QString& fileName() const
+  {
+    return m_fileName;
+  };
+
+  /**
+   * \return True, if the file was written. Valid after the pool is done.
+   */
+  bool isOk() const
+  {
+    return m_ok;
+  };
+
+ private:
+
+  Q_DISABLE_COPY ( MapAtlasWriteTask )
+
+  QImage  m_image;
+  QString m_fileName;
+  bool    m_ok;
+};
+
+#endif
@@ -83,6 +83,12 @@ float getSpeed(FlightPoint p);
  */
 float getBearing(FlightPoint p1, FlightPoint p2);
 
+/**
+ * Calculates the bearing from the first to the second point given in KFLog
+ * coordinates.
+ */
+float getBearing(int lat1, int lon1, int lat2, int lon2);
+
 /**
  * Converts a x/y position into a polar-coordinate.
  */
@@ -46,6 +46,7 @@
 #include "openairparser.h"
 #include "radiopoint.h"
 #include "singlepoint.h"
+#include "sourcecache.h"
 #include "welt2000.h"
 #include "wgspoint.h"
 
@@ -234,12 +235,17 @@ bool MapContents::__downloadMapFile( QString &file, QString &directory )
 /** Called, if all downloads are finished. */
 void MapContents::slotDownloadsFinished( int requests, int errors )
 {
+  bool changed = ! m_downloadManger->changedFiles().isEmpty();
+
   // All has finished, free not more needed resources
   m_downloadManger->deleteLater();
   m_downloadManger = static_cast<DownloadManager *> (0);
 
-  // initiate a new map load
-  emit contentsChanged();
+  if( changed )
+    {
+      // initiate a new map load
+      emit contentsChanged();
+    }
 
   if( errors )
     {
@@ -318,7 +324,7 @@ void MapContents::slotDownloadWelt2000(bool askUser)
   _settings.setValue( "/Welt2000/Link", welt2000Link );
 
   QString url  = welt2000Link + "/" + welt2000FileName;
-  QString dest = getMapRootDirectory() + "/points/WELT2000.TXT.new";
+  QString dest = getMapRootDirectory() + "/points/WELT2000.TXT";
 
   m_downloadMangerW2000->downloadRequest( url, dest );
 }
@@ -330,85 +336,20 @@ void MapContents::slotWelt2000DownloadFinished( int requests, int errors )
 {
   qDebug() << "MapContents::slotWelt2000DownloadFinished():" << requests << errors;
 
+  bool changed = ! m_downloadMangerW2000->changedFiles().isEmpty();
+
   // All has finished, free not more needed resources
   m_downloadMangerW2000->deleteLater();
   m_downloadMangerW2000 = static_cast<DownloadManager *> (0);
 
-  // Check, if the file content of the new Welt2000 file has been changed.
-  QString curW2000 = getMapRootDirectory() + "/points/WELT2000.TXT";
-  QString newW2000 = getMapRootDirectory() + "/points/WELT2000.TXT.new";
-
-  QFileInfo curFi(curW2000);
-  QFileInfo newFi(newW2000);
-
-  if( newFi.exists() == false )
+  // The file is only replaced, if the server has a newer version.
+  if( changed )
     {
-      // No new file available, abort further processing.
-      return;
-    }
-
-  if( curFi.exists() == false || curFi.size() != newFi.size() )
-    {
-      // Current file is not available or file sizes are different.
-      // Rename new file and initiate a load of it.
-      rename( newW2000.toLatin1().data(), curW2000.toLatin1().data() );
       slotReloadPointData();
       return;
     }
 
-  // Compare both files, line by line
-  QFile curFile(curW2000);
-  QFile newFile(newW2000);
-
-  bool differ = false;
-
-  bool curOk = curFile.open( QIODevice::ReadOnly );
-
-  if( curOk == false )
-    {
-      return;
-    }
-
-  bool newOk = newFile.open( QIODevice::ReadOnly );
-
-  if( newOk == false )
-    {
-      curFile.close();
-      return;
-    }
-
-  while( true )
-    {
-      QByteArray curBA = curFile.readLine();
-      QByteArray newBA = newFile.readLine();
-
-      if( curBA.size() == 0 || newBA.size() == 0 )
-        {
-          // EOF or error, do break only
-          break;
-        }
-
-      if( curBA.contains(newBA) == false )
-        {
-          // both do differ, do break
-          differ = true;
-          break;
-        }
-    }
-
-  curFile.close();
-  newFile.close();
-
-  QFile::remove( curW2000 );
-  QFile::rename( newW2000, curW2000 );
-
-  if( differ == true )
-    {
-      slotReloadPointData();
-    }
-
   qDebug() << "MapContents::slotWelt2000DownloadFinished(): no difference between old and new";
-  return;
 }
 
 void MapContents::slotReloadPointData()
@@ -471,12 +412,17 @@ void MapContents::slotDownloadOpenAipAirspaceFiles( bool askUser )
 
 void MapContents::slotOpenAipAsDownloadsFinished( int requests, int errors )
 {
+  bool changed = ! m_downloadOpenAipAsManger->changedFiles().isEmpty();
+
   // All has finished, free not more needed resources
   m_downloadOpenAipAsManger->deleteLater();
   m_downloadOpenAipAsManger = static_cast<DownloadManager *> (0);
 
-  // initiate a reload of all airspace data
-  slotReloadAirspaceData();
+  if( changed )
+    {
+      // initiate a reload of all airspace data
+      slotReloadAirspaceData();
+    }
 
   if( errors )
     {
@@ -580,12 +526,17 @@ void MapContents::slotDownloadOpenAipPointFiles( bool askUser )
 
 void MapContents::slotOpenAipPoiDownloadsFinished( int requests, int errors )
 {
+  bool changed = ! m_downloadOpenAipPoiManger->changedFiles().isEmpty();
+
   // All has finished, free not more needed resources
   m_downloadOpenAipPoiManger->deleteLater();
   m_downloadOpenAipPoiManger = static_cast<DownloadManager *> (0);
 
-  // initiate a reload of all airfield data
-  slotReloadPointData();
+  if( changed )
+    {
+      // initiate a reload of all airfield data
+      slotReloadPointData();
+    }
 
   if( errors )
     {
@@ -862,6 +813,9 @@ bool MapContents::__readTerrainFile( const int fileSecID,
       return false;
     }
 
+  // Taken before the read, so that a change during the read is detected.
+  const QByteArray fingerprint = SourceCache<Isohypse>::fingerprint( pathName );
+
   QDataStream in( &mapfile );
   in.setVersion( QDataStream::Qt_3_3 );
 
@@ -1025,6 +979,8 @@ bool MapContents::__readTerrainFile( const int fileSecID,
 
   mapfile.close();
 
+  tileFingerprints.insert( pathName, fingerprint );
+
   return true;
 }
 
@@ -1057,6 +1013,9 @@ bool MapContents::__readBinaryFile( const int  fileSecID,
       return false;
     }
 
+  // Taken before the read, so that a change during the read is detected.
+  const QByteArray fingerprint = SourceCache<Isohypse>::fingerprint( pathName );
+
   QDataStream in( &mapfile );
   in.setVersion( QDataStream::Qt_2_0 );
 
@@ -1284,6 +1243,8 @@ bool MapContents::__readBinaryFile( const int  fileSecID,
 
   mapfile.close();
 
+  tileFingerprints.insert( pathName, fingerprint );
+
   return true;
 }
 
@@ -1499,6 +1460,12 @@ void MapContents::proofeSection(bool isPrint)
   char step, hasstep; // used as small integers
   TilePartMap::Iterator it;
 
+  if( tileSectionSet.isEmpty() && tilePartMap.isEmpty() )
+    {
+      // The tiles are projected while they are read.
+      tileProjection = __projectionKey();
+    }
+
   for(int row = northCorner; row <= southCorner; row++)
     {
       for(int col = westCorner; col <= eastCorner; col++)
@@ -1770,6 +1737,30 @@ SinglePoint* MapContents::getSinglePoint(int listIndex, uint index)
 
 void MapContents::slotReloadMapData()
 {
+  if( tileProjection == __projectionKey() )
+    {
+      // Only tiles with changed files are read again.
+      QList<int> sections = tileSectionSet.toList() + tilePartMap.keys();
+
+      bool changed = false;
+
+      for( int i = 0; i < sections.size(); i++ )
+        {
+          if( __isTileChanged( sections.at(i) ) )
+            {
+              __removeTile( sections.at(i) );
+              changed = true;
+            }
+        }
+
+      if( changed )
+        {
+          emit contentsChanged();
+        }
+
+      return;
+    }
+
   // qDebug() << "MapContents::slotReloadMapData(): Clears all Maps!";
 
   airspaceList.clear();
@@ -1799,10 +1790,95 @@ void MapContents::slotReloadMapData()
   // map tiles are cleared
   tileSectionSet.clear();
   tilePartMap.clear();
+  tileFingerprints.clear();
 
   emit contentsChanged();
 }
 
+QByteArray MapContents::__projectionKey()
+{
+  extern MapMatrix *_globalMapMatrix;
+
+  ProjectionBase* projection = _globalMapMatrix->getProjection();
+
+  QByteArray key;
+  QDataStream out( &key, QIODevice::WriteOnly );
+
+  out << qint32( projection->projectionType() );
+  projection->saveParameters( out );
+
+  return key;
+}
+
+bool MapContents::__isTileChanged( const int secID )
+{
+  const char fileTypes[3] = { FILE_TYPE_GROUND, FILE_TYPE_TERRAIN, FILE_TYPE_MAP };
+
+  QString path = getMapRootDirectory() + "/landscape/";
+  QString file;
+
+  for( int i = 0; i < 3; i++ )
+    {
+      file.sprintf( "%c_%.5d.kfl", fileTypes[i], secID );
+
+      QString pathName = path + file;
+
+      // A file, which was not read, has no fingerprint.
+      if( tileFingerprints.value( pathName ) !=
+          SourceCache<Isohypse>::fingerprint( pathName ) )
+        {
+          return true;
+        }
+    }
+
+  return false;
+}
+
+/**
+ * Removes all elements of a map tile from the passed list.
+ */
+template<class T> static void removeTileElements( QList<T>& list, const int secID )
+{
+  for( int i = list.size() - 1; i >= 0; i-- )
+    {
+      if( list.at(i).getMapSegment() == secID )
+        {
+          list.removeAt(i);
+        }
+    }
+}
+
+void MapContents::__removeTile( const int secID )
+{
+  removeTileElements( cityList, secID );
+  removeTileElements( highwayList, secID );
+  removeTileElements( roadList, secID );
+  removeTileElements( railList, secID );
+  removeTileElements( hydroList, secID );
+  removeTileElements( lakeList, secID );
+  removeTileElements( topoList, secID );
+  removeTileElements( villageList, secID );
+  removeTileElements( obstacleList, secID );
+  removeTileElements( landmarkList, secID );
+
+  groundMap.remove( secID );
+  terrainMap.remove( secID );
+
+  tileSectionSet.remove( secID );
+  tilePartMap.remove( secID );
+
+  QString path = getMapRootDirectory() + "/landscape/";
+  QString file;
+
+  const char fileTypes[3] = { FILE_TYPE_GROUND, FILE_TYPE_TERRAIN, FILE_TYPE_MAP };
+
+  for( int i = 0; i < 3; i++ )
+    {
+      file.sprintf( "%c_%.5d.kfl", fileTypes[i], secID );
+      tileFingerprints.remove( path + file );
+    }
+}
+
 
 void MapContents::printContents(QPainter* targetPainter, bool isText)
 {
@@ -1874,27 +1950,52 @@ void MapContents::drawList( QPainter* targetPainter,
     {
       case AirfieldList:
         for (int i = 0; i < airfieldList.size(); i++)
-          airfieldList[i].drawMapElement(targetPainter);
+          {
+            if( airfieldList[i].drawMapElement(targetPainter) )
+              {
+                drawnElements.append( &airfieldList[i] );
+              }
+          }
         break;
 
       case GliderfieldList:
         for (int i = 0; i < gliderfieldList.size(); i++)
-          gliderfieldList[i].drawMapElement(targetPainter);
+          {
+            if( gliderfieldList[i].drawMapElement(targetPainter) )
+              {
+                drawnElements.append( &gliderfieldList[i] );
+              }
+          }
         break;
 
       case OutLandingList:
         for (int i = 0; i < outLandingList.size(); i++)
-          outLandingList[i].drawMapElement(targetPainter);
+          {
+            if( outLandingList[i].drawMapElement(targetPainter) )
+              {
+                drawnElements.append( &outLandingList[i] );
+              }
+          }
         break;
 
       case NavaidList:
         for (int i = 0; i < navaidList.size(); i++)
-          navaidList[i].drawMapElement(targetPainter);
+          {
+            if( navaidList[i].drawMapElement(targetPainter) )
+              {
+                drawnElements.append( &navaidList[i] );
+              }
+          }
         break;
 
       case HotspotList:
         for (int i = 0; i < hotspotList.size(); i++)
-          hotspotList[i].drawMapElement(targetPainter);
+          {
+            if( hotspotList[i].drawMapElement(targetPainter) )
+              {
+                drawnElements.append( &hotspotList[i] );
+              }
+          }
         break;
 
       case AirspaceList:
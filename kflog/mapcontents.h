@@ -34,7 +34,9 @@
 #define MAP_CONTENTS_H
 
 #include <QBitArray>
+#include <QByteArray>
 #include <QFile>
+#include <QHash>
 #include <QList>
 #include <QObject>
 #include <QMap>
@@ -372,7 +374,11 @@ class MapContents : public QObject
   /** No descriptions */
   void slotEditFlightGroup();
 
-  /** */
+  /**
+   * Reloads the map tiles. If the projection has been changed, all map
+   * data are cleared and read again. Otherwise only the tiles, whose files
+   * have been changed since they were read, are read again.
+   */
   void slotReloadMapData();
 
    /** Re-projects any flights and tasks that may be loaded. */
@@ -535,6 +541,23 @@ class MapContents : public QObject
 
  private:
 
+  /**
+   * \return A key of the current map projection and its parameters.
+   */
+  QByteArray __projectionKey();
+
+  /**
+   * \return True, if a file of the tile has been changed, added or removed
+   *         since the tile was read.
+   */
+  bool __isTileChanged( const int secID );
+
+  /**
+   * Removes all elements and isohypses of a tile, so that the tile is read
+   * again by \ref proofeSection.
+   */
+  void __removeTile( const int secID );
+
   /**
    * Reads a binary map file.
    *
@@ -702,6 +725,17 @@ class MapContents : public QObject
   typedef QMap<int, char> TilePartMap;
   TilePartMap tilePartMap;
 
+  /**
+   * Fingerprints of all read tile files with the path name as key, see
+   * \ref SourceCache.
+   */
+  QHash<QString, QByteArray> tileFingerprints;
+
+  /**
+   * Key of the projection, which was used for the loaded map tiles.
+   */
+  QByteArray tileProjection;
+
   /** */
   QString mapDir;
 
@@ -0,0 +1,167 @@
+/***********************************************************************
+**
+**   maphitindex.cpp
+**
+**   This file is part of KFLog.
+**
+************************************************************************
+**
+**   Copyright (c):  2026 by agent <agent@local>
+**
+**   This file is distributed under the terms of the General Public
+**   License. See the file COPYING for more information.
+**
+***********************************************************************/
+
+#include <cstdlib>
+
+#include <QtAlgorithms>
+
+#include "maphitindex.h"
+#include "singlepoint.h"
+
+MapHitIndex::MapHitIndex( const int cellSize ) :
+  m_cellSize( qMax( cellSize, 1 ) ),
+  m_columns( 0 ),
+  m_rows( 0 ),
+  m_sequence( 0 )
+{
+}
+
+MapHitIndex::~MapHitIndex()
+{
+}
+
+void MapHitIndex::clear( const QRect& area )
+{
+  m_area     = area;
+  m_columns  = qMax( 1, (area.width() + m_cellSize - 1) / m_cellSize );
+  m_rows     = qMax( 1, (area.height() + m_cellSize - 1) / m_cellSize );
+  m_sequence = 0;
+
+  m_pointCells.clear();
+  m_pointCells.resize( m_columns * m_rows );
+
+  m_regions.clear();
+  m_regionCells.clear();
+  m_regionCells.resize( m_columns * m_rows );
+}
+
+int MapHitIndex::column( const int x ) const
+{
+  return qBound( 0, (x - m_area.left()) / m_cellSize, m_columns - 1 );
+}
+
+int MapHitIndex::row( const int y ) const
+{
+  return qBound( 0, (y - m_area.top()) / m_cellSize, m_rows - 1 );
+}
+
+void MapHitIndex::insertPoint( SinglePoint* point, const int priority )
+{
+  if( point == 0 || m_pointCells.isEmpty() )
+    {
+      return;
+    }
+
+  PointEntry entry;
+  entry.pos      = point->getMapPosition();
+  entry.priority = priority;
+  entry.sequence = m_sequence++;
+  entry.point    = point;
+
+  m_pointCells[row( entry.pos.y() ) * m_columns + column( entry.pos.x() )].append( entry );
+}
+
+void MapHitIndex::insertRegion( const QRect& rect, const int index )
+{
+  if( m_regionCells.isEmpty() || ! rect.intersects( m_area ) )
+    {
+      // Regions outside of the map area can never be hit.
+      return;
+    }
+
+  RegionEntry entry;
+  entry.rect  = rect;
+  entry.index = index;
+
+  const int pos = m_regions.size();
+  m_regions.append( entry );
+
+  const int c2 = column( rect.right() );
+  const int r2 = row( rect.bottom() );
+
+  for( int r = row( rect.top() ); r <= r2; r++ )
+    {
+      for( int c = column( rect.left() ); c <= c2; c++ )
+        {
+          m_regionCells[r * m_columns + c].append( pos );
+        }
+    }
+}
+
+SinglePoint* MapHitIndex::findPoint( const QPoint& pos, const int delta ) const
+{
+  if( m_pointCells.isEmpty() )
+    {
+      return 0;
+    }
+
+  const PointEntry* best = 0;
+
+  const int c2 = column( pos.x() + delta );
+  const int r2 = row( pos.y() + delta );
+
+  for( int r = row( pos.y() - delta ); r <= r2; r++ )
+    {
+      for( int c = column( pos.x() - delta ); c <= c2; c++ )
+        {
+          const QVector<PointEntry>& cell = m_pointCells[r * m_columns + c];
+
+          for( int i = 0; i < cell.size(); i++ )
+            {
+              const PointEntry& entry = cell[i];
+
+              if( abs( entry.pos.x() - pos.x() ) >= delta ||
+                  abs( entry.pos.y() - pos.y() ) >= delta )
+                {
+                  continue;
+                }
+
+              if( best == 0 ||
+                  entry.priority < best->priority ||
+                  ( entry.priority == best->priority && entry.sequence < best->sequence ) )
+                {
+                  best = &entry;
+                }
+            }
+        }
+    }
+
+  return ( best != 0 ) ? best->point : 0;
+}
+
+QList<int> MapHitIndex::findRegions( const QPoint& pos ) const
+{
+  QList<int> result;
+
+  if( m_regionCells.isEmpty() )
+    {
+      return result;
+    }
+
+  const QVector<int>& cell = m_regionCells[row( pos.y() ) * m_columns + column( pos.x() )];
+
+  for( int i = 0; i < cell.size(); i++ )
+    {
+      const RegionEntry& entry = m_regions[cell[i]];
+
+      if( entry.rect.contains( pos ) )
+        {
+          result.append( entry.index );
+        }
+    }
+
+  qSort( result );
+  return result;
+}
@@ -0,0 +1,133 @@
+/***********************************************************************
+**
+**   maphitindex.h
+**
+**   This file is part of KFLog.
+**
+************************************************************************
+**
+**   Copyright (c):  2026 by agent <agent@local>
+**
+**   This file is distributed under the terms of the General Public
+**   License. See the file COPYING for more information.
+**
+***********************************************************************/
+
+/**
+ * \class MapHitIndex
+ *
+ * \author agent
+ *
+ * \brief Screen space index of the drawn map elements.
+ *
+ * The map widget is divided into square cells. Every drawn point element is
+ * put into the cell of its map position, every drawn airspace into all cells
+ * covered by its bounding rectangle. A hit test has then only to check the
+ * elements of the cells around the mouse position.
+ *
+ * Elements outside of the map widget are put into the border cells, so that
+ * no hit can be lost.
+ *
+ * The index is filled during the drawing of the map and is valid until the
+ * next map drawing.
+ *
+ * \date 2026
+ *
+ * \version 1.0
+ */
+
+#ifndef MAP_HIT_INDEX_H
+#define MAP_HIT_INDEX_H
+
+#include <QList>
+#include <QPoint>
+#include <QRect>
+#include <QVector>
+
+class SinglePoint;
+
+class MapHitIndex
+{
+ public:
+
+  MapHitIndex( const int cellSize = 32 );
+
+  virtual ~MapHitIndex();
+
+  /**
+   * Removes all elements and sets the area to be covered by the index.
+   */
+  void clear( const QRect& area );
+
+  /**
+   * Adds a drawn point element at its current map position.
+   *
+   * \param point Drawn point element
+   *
+   * \param priority Elements with a lower priority value are returned first
+   *        by \ref findPoint. Elements with the same priority are returned
+   *        in the order of their insertion.
+   */
+  void insertPoint( SinglePoint* point, const int priority );
+
+  /**
+   * Adds a drawn region with its bounding rectangle.
+   *
+   * \param rect Bounding rectangle of the region in map widget coordinates
+   *
+   * \param index Index of the region in the caller's region list
+   */
+  void insertRegion( const QRect& rect, const int index );
+
+  /**
+   * Searches the point element with the highest priority, which has a
+   * distance less than delta in both directions to the passed position.
+   *
+   * \return The found element or null.
+   */
+  SinglePoint* findPoint( const QPoint& pos, const int delta ) const;
+
+  /**
+   * Returns the indexes of all regions, whose bounding rectangle contains
+   * the passed position, in ascending order. The exact test has to be done
+   * by the caller.
+   */
+  QList<int> findRegions( const QPoint& pos ) const;
+
+ private:
+
+  struct PointEntry
+  {
+    QPoint       pos;
+    int          priority;
+    int          sequence;
+    SinglePoint* point;
+  };
+
+  struct RegionEntry
+  {
+    QRect rect;
+    int   index;
+  };
+
+  /** Returns the column of the cell containing x, limited to the grid. */
+  int column( const int x ) const;
+
+  /** Returns the row of the cell containing y, limited to the grid. */
+  int row( const int y ) const;
+
+  int m_cellSize;
+  int m_columns;
+  int m_rows;
+  int m_sequence;
+
+  QRect m_area;
+
+  QVector< QVector<PointEntry> > m_pointCells;
+  QVector<RegionEntry> m_regions;
+
+  /** Every cell contains the positions of its regions in m_regions. */
+  QVector< QVector<int> > m_regionCells;
+};
+
+#endif
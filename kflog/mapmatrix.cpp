@@ -369,7 +369,7 @@ QPoint MapMatrix::getHomeCoord() const
   return QPoint(homeLat, homeLon);
 }
 
-void MapMatrix::createMatrix( const QSize& newSize )
+void MapMatrix::createMatrix( const QSize& newSize, const QRect& section )
 {
   mapViewSize = newSize;
 
@@ -392,6 +392,14 @@ void MapMatrix::createMatrix( const QSize& newSize )
 
   worldMatrix *= translateMatrix;
 
+  QSize viewSize = newSize;
+
+  if( section.isValid() )
+    {
+      worldMatrix *= QTransform( 1, 0, 0, 1, -section.x(), -section.y() );
+      viewSize = section.size();
+    }
+
   // Setting the viewBorder
   bool result = true;
   invertMatrix = worldMatrix.inverted( &result );
@@ -406,18 +414,18 @@ void MapMatrix::createMatrix( const QSize& newSize )
   // Nordhalbkugel. Auf der Südhalbkugel stimmen die Werte nur
   // näherungsweise.
   //
-  QPoint tCenter  = __mapToWgs(invertMatrix.map(QPoint(newSize.width() / 2, 0)));
+  QPoint tCenter  = __mapToWgs(invertMatrix.map(QPoint(viewSize.width() / 2, 0)));
   QPoint tlCorner = __mapToWgs(invertMatrix.map(QPoint(0, 0)));
-  QPoint trCorner = __mapToWgs(invertMatrix.map(QPoint(newSize.width(), 0)));
-  QPoint blCorner = __mapToWgs(invertMatrix.map(QPoint(0, newSize.height())));
-  QPoint brCorner = __mapToWgs(invertMatrix.map(QPoint(newSize.width(),newSize.height())));
+  QPoint trCorner = __mapToWgs(invertMatrix.map(QPoint(viewSize.width(), 0)));
+  QPoint blCorner = __mapToWgs(invertMatrix.map(QPoint(0, viewSize.height())));
+  QPoint brCorner = __mapToWgs(invertMatrix.map(QPoint(viewSize.width(),viewSize.height())));
 
   viewBorder.setTop( tCenter.y() );
   viewBorder.setLeft( tlCorner.x() );
   viewBorder.setRight( trCorner.x() );
   viewBorder.setBottom( qMin( blCorner.y(), brCorner.y() ) );
 
-  mapBorder = invertMatrix.mapRect( QRect( 0, 0, newSize.width(), newSize.height() ) );
+  mapBorder = invertMatrix.mapRect( QRect( 0, 0, viewSize.width(), viewSize.height() ) );
 
   emit displayMatrixValues( getScaleRange(), isSwitchScale() );
 }
@@ -195,8 +195,13 @@ public:
 
   /**
    * Initializes the matrix for displaying the map.
+   *
+   * @param newSize Size of the whole map view
+   * @param section Part of the view, which is drawn. The matrix maps the
+   *                top left corner of the section to the origin. The whole
+   *                view is used, if the section is not valid.
    */
-  void createMatrix(const QSize& newSize);
+  void createMatrix(const QSize& newSize, const QRect& section = QRect());
 
   /**
    * @return "true", if the given point in visible in the current map.
@@ -0,0 +1,378 @@
+/***********************************************************************
+**
+**   mappedwaypointfile.cpp
+**
+**   This file is part of KFLog.
+**
+************************************************************************
+**
+**   Copyright (c):  2026 by agent <agent@local>
+**
+**   This file is distributed under the terms of the General Public
+**   License. See the file COPYING for more information.
+**
+***********************************************************************/
+
+#include <cstring>
+
+#include <QtCore>
+
+#include "mappedwaypointfile.h"
+#include "runway.h"
+#include "waypoint.h"
+
+#define DATA_STREAM QDataStream::Qt_4_7
+
+// Kflog file header
+#define KFLOG_FILE_MAGIC    0x404b464c
+#define FILE_TYPE_WAYPOINTS 0x50
+
+// Sizes of the header and of the fixed records
+#define HEADER_SIZE  32
+#define RECORD_SIZE  44
+#define RUNWAY_SIZE  16
+
+const quint16 MappedWaypointFile::FormatId = 106;
+
+namespace
+{
+  quint32 get32( const uchar* p )
+  {
+    return qFromLittleEndian<quint32>( p );
+  }
+
+  float getFloat( const uchar* p )
+  {
+    quint32 u = get32( p );
+    float f;
+    memcpy( &f, &u, sizeof(f) );
+    return f;
+  }
+
+  void put32( QByteArray& data, const quint32 value )
+  {
+    uchar buf[4];
+    qToLittleEndian<quint32>( value, buf );
+    data.append( reinterpret_cast<const char *>(buf), 4 );
+  }
+
+  void put16( QByteArray& data, const quint16 value )
+  {
+    uchar buf[2];
+    qToLittleEndian<quint16>( value, buf );
+    data.append( reinterpret_cast<const char *>(buf), 2 );
+  }
+
+  void put8( QByteArray& data, const quint8 value )
+  {
+    data.append( static_cast<char>(value) );
+  }
+
+  void putFloat( QByteArray& data, const float value )
+  {
+    quint32 u;
+    memcpy( &u, &value, sizeof(u) );
+    put32( data, u );
+  }
+
+  /**
+   * Collects the strings of a catalog. Every different string is stored
+   * only once, prefixed by its length in bytes. Offset 0 is the empty
+   * string.
+   */
+  class StringTable
+  {
+   public:
+
+    StringTable()
+    {
+      put16( m_data, 0 );
+      m_offsets.insert( QString(""), 0 );
+    };
+
+    quint32 add( const QString& string )
+    {
+      QHash<QString, quint32>::const_iterator it = m_offsets.constFind( string );
+
+      if( it != m_offsets.constEnd() )
+        {
+          return it.value();
+        }
+
+      QByteArray utf8 = string.toUtf8().left( 0xffff );
+      quint32 offset = m_data.size();
+
+      put16( m_data, utf8.size() );
+      m_data.append( utf8 );
+      m_offsets.insert( string, offset );
+
+      return offset;
+    };
+
+    const QByteArray& data() const
+    {
+      return m_data;
+    };
+
+   private:
+
+    QByteArray              m_data;
+    QHash<QString, quint32> m_offsets;
+  };
+}
+
+MappedWaypointFile::MappedWaypointFile() :
+  m_data(0),
+  m_size(0),
+  m_count(0),
+  m_recordOffset(0),
+  m_runwayCount(0),
+  m_runwayOffset(0),
+  m_stringOffset(0),
+  m_stringSize(0)
+{
+}
+
+MappedWaypointFile::~MappedWaypointFile()
+{
+  close();
+}
+
+bool MappedWaypointFile::open( const QString& fileName )
+{
+  close();
+
+  m_file.setFileName( fileName );
+
+  if( ! m_file.open( QIODevice::ReadOnly ) )
+    {
+      return false;
+    }
+
+  m_size = m_file.size();
+
+  if( m_size < HEADER_SIZE || m_size > 0x7fffffff )
+    {
+      close();
+      return false;
+    }
+
+  m_data = m_file.map( 0, m_size );
+
+  if( m_data == 0 )
+    {
+      qWarning() << "MappedWaypointFile: Cannot map" << fileName;
+      close();
+      return false;
+    }
+
+  // magic, type and format are big endian like in the older formats
+  quint32 magic  = qFromBigEndian<quint32>( m_data );
+  quint8  type   = m_data[4];
+  quint16 format = qFromBigEndian<quint16>( m_data + 5 );
+
+  if( magic != KFLOG_FILE_MAGIC || type != FILE_TYPE_WAYPOINTS ||
+      format != FormatId )
+    {
+      close();
+      return false;
+    }
+
+  m_count        = get32( m_data + 8 );
+  m_recordOffset = get32( m_data + 12 );
+  m_runwayCount  = get32( m_data + 16 );
+  m_runwayOffset = get32( m_data + 20 );
+  m_stringOffset = get32( m_data + 24 );
+  m_stringSize   = get32( m_data + 28 );
+
+  // All sections must be inside of the file.
+  bool ok = m_count >= 0 &&
+            m_recordOffset + qint64( m_count ) * RECORD_SIZE <= m_size &&
+            m_runwayOffset + qint64( m_runwayCount ) * RUNWAY_SIZE <= m_size &&
+            qint64( m_stringOffset ) + m_stringSize <= m_size;
+
+  if( ! ok )
+    {
+      qWarning() << "MappedWaypointFile: Corrupt catalog" << fileName;
+      close();
+      return false;
+    }
+
+  return true;
+}
+
+void MappedWaypointFile::close()
+{
+  if( m_data != 0 )
+    {
+      m_file.unmap( m_data );
+      m_data = 0;
+    }
+
+  m_file.close();
+
+  m_size  = 0;
+  m_count = 0;
+}
+
+const uchar* MappedWaypointFile::record( const int index ) const
+{
+  return m_data + m_recordOffset + index * RECORD_SIZE;
+}
+
+QString MappedWaypointFile::string( const quint32 offset ) const
+{
+  if( offset + 2 > m_stringSize )
+    {
+      return QString();
+    }
+
+  const uchar* p = m_data + m_stringOffset + offset;
+  quint32 len = qFromLittleEndian<quint16>( p );
+
+  if( offset + 2 + len > m_stringSize )
+    {
+      return QString();
+    }
+
+  return QString::fromUtf8( reinterpret_cast<const char *>(p + 2), len );
+}
+
+Waypoint* MappedWaypointFile::waypoint( const int index ) const
+{
+  if( index < 0 || index >= m_count )
+    {
+      return static_cast<Waypoint *> (0);
+    }
+
+  const uchar* r = record( index );
+
+  Waypoint* w = new Waypoint;
+
+  w->name        = string( get32( r ) );
+  w->description = string( get32( r + 4 ) );
+  w->icao        = string( get32( r + 8 ) );
+  w->comment     = string( get32( r + 12 ) );
+  w->country     = string( get32( r + 16 ) );
+  w->origP.setLat( (qint32) get32( r + 20 ) );
+  w->origP.setLon( (qint32) get32( r + 24 ) );
+  w->elevation   = getFloat( r + 28 );
+  w->frequency   = getFloat( r + 32 );
+  w->type        = static_cast<qint8>( r[41] );
+  w->importance  = r[42];
+
+  quint32 first = get32( r + 36 );
+  quint32 count = r[40];
+
+  for( quint32 i = first; i < first + count && i < m_runwayCount; i++ )
+    {
+      const uchar* rw = m_data + m_runwayOffset + i * RUNWAY_SIZE;
+
+      quint16 heading = qFromLittleEndian<quint16>( rw + 8 );
+
+      QPair<ushort, ushort> headings;
+      headings.first  = heading >> 8;
+      headings.second = heading & 0xff;
+
+      Runway rwy( getFloat( rw ),
+                  headings,
+                  static_cast<enum Runway::SurfaceType>( rw[10] ),
+                  rw[11],
+                  getFloat( rw + 4 ) );
+
+      w->rwyList.append( rwy );
+    }
+
+  return w;
+}
+
+bool MappedWaypointFile::write( const QString& fileName,
+                                const QList<Waypoint*>& wpList )
+{
+  const int count = wpList.size();
+
+  StringTable strings;
+  QByteArray records;
+  QByteArray runways;
+  quint32 runwayCount = 0;
+
+  records.reserve( count * RECORD_SIZE );
+
+  for( int i = 0; i < count; i++ )
+    {
+      const Waypoint* w = wpList.at(i);
+
+      put32( records, strings.add( w->name.left(8).toUpper() ) );
+      put32( records, strings.add( w->description ) );
+      put32( records, strings.add( w->icao ) );
+      put32( records, strings.add( w->comment ) );
+      put32( records, strings.add( w->country ) );
+      put32( records, w->origP.lat() );
+      put32( records, w->origP.lon() );
+      putFloat( records, w->elevation );
+      putFloat( records, w->frequency );
+      put32( records, runwayCount );
+
+      int rwyCount = qMin( w->rwyList.size(), 255 );
+
+      put8( records, rwyCount );
+      put8( records, w->type );
+      put8( records, w->importance );
+      put8( records, 0 );
+
+      for( int j = 0; j < rwyCount; j++ )
+        {
+          Runway rwy = w->rwyList.at(j);
+
+          QPair<ushort, ushort> rwyHeadings = rwy.getRunwayHeadings();
+
+          putFloat( runways, rwy.m_length );
+          putFloat( runways, rwy.m_width );
+          put16( runways, (rwyHeadings.first * 256) + (rwyHeadings.second & 0xff) );
+          put8( runways, rwy.m_surface );
+          put8( runways, rwy.m_isOpen );
+          put8( runways, rwyHeadings.first != rwyHeadings.second );
+          put8( runways, 0 );
+          put16( runways, 0 );
+        }
+
+      runwayCount += rwyCount;
+    }
+
+  quint32 recordOffset = HEADER_SIZE;
+  quint32 runwayOffset = recordOffset + records.size();
+  quint32 stringOffset = runwayOffset + runways.size();
+
+  QByteArray header;
+
+  // magic, type and format like in the older formats
+  QDataStream out( &header, QIODevice::WriteOnly );
+  out.setVersion( DATA_STREAM );
+  out << quint32( KFLOG_FILE_MAGIC );
+  out << qint8( FILE_TYPE_WAYPOINTS );
+  out << quint16( FormatId );
+  out << quint8( 0 );
+
+  put32( header, count );
+  put32( header, recordOffset );
+  put32( header, runwayCount );
+  put32( header, runwayOffset );
+  put32( header, stringOffset );
+  put32( header, strings.data().size() );
+
+  QFile file( fileName );
+
+  if( ! file.open( QIODevice::WriteOnly ) )
+    {
+      return false;
+    }
+
+  bool ok = file.write( header ) == header.size() &&
+            file.write( records ) == records.size() &&
+            file.write( runways ) == runways.size() &&
+            file.write( strings.data() ) == strings.data().size();
+
+  file.close();
+
+  return ok;
+}
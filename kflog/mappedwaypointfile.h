@@ -0,0 +1,125 @@
+/***********************************************************************
+**
+**   mappedwaypointfile.h
+**
+**   This file is part of KFLog.
+**
+************************************************************************
+**
+**   Copyright (c):  2026 by agent <agent@local>
+**
+**   This file is distributed under the terms of the General Public
+**   License. See the file COPYING for more information.
+**
+***********************************************************************/
+
+/**
+ * \class MappedWaypointFile
+ *
+ * \author agent
+ *
+ * \brief Memory mapped access to a binary KFLog waypoint catalog.
+ *
+ * The binary catalog format 106 is designed to be read directly from a
+ * memory mapped file. It starts with the same magic, file type and format
+ * number as the older binary formats, followed by:
+ *
+ * - a header with the sizes and offsets of the following sections,
+ * - a table of fixed size waypoint records,
+ * - a table of fixed size runway records,
+ * - a string table, which stores every different string only once.
+ *
+ * All numbers behind the format number are stored little endian. Opening a
+ * file maps it and checks the header only. The waypoint objects are created
+ * from the records without a stream decoding of every field. The catalog
+ * reads all records, because it keeps every waypoint in its list, so that a
+ * save writes the catalog back completely.
+ *
+ * \date 2026
+ *
+ * \version 1.0
+ */
+
+#ifndef MAPPED_WAYPOINT_FILE_H
+#define MAPPED_WAYPOINT_FILE_H
+
+#include <QFile>
+#include <QList>
+#include <QString>
+
+class Waypoint;
+
+class MappedWaypointFile
+{
+ public:
+
+  MappedWaypointFile();
+
+  virtual ~MappedWaypointFile();
+
+  /**
+   * Maps the file into the memory and checks its header.
+   *
+   * \param fileName Name of the catalog file
+   *
+   * \return True, if the file is a valid catalog in format 106.
+   */
+  bool open( const QString& fileName );
+
+  /**
+   * Unmaps and closes the file.
+   */
+  void close();
+
+  bool isOpen() const
+  {
+    return m_data != 0;
+  };
+
+  /**
+   * \return The number of waypoint records.
+   */
+  int size() const
+  {
+    return m_count;
+  };
+
+  /**
+   * Creates a waypoint object from a record. The caller takes the ownership
+   * of the returned object.
+   */
+  Waypoint* waypoint( const int index ) const;
+
+  /**
+   * Writes a waypoint list as catalog in format 106.
+   *
+   * \return True in case of success.
+   */
+  static bool write( const QString& fileName, const QList<Waypoint*>& wpList );
+
+  /** The number of the binary catalog format */
+  static const quint16 FormatId;
+
+ private:
+
+  Q_DISABLE_COPY ( MappedWaypointFile )
+
+  /** \return The string at the offset of the string table. */
+  QString string( const quint32 offset ) const;
+
+  /** \return The address of a waypoint record. */
+  const uchar* record( const int index ) const;
+
+  QFile  m_file;
+  uchar* m_data;
+  qint64 m_size;
+
+  int     m_count;
+  quint32 m_recordOffset;
+  quint32 m_runwayCount;
+  quint32 m_runwayOffset;
+  quint32 m_stringOffset;
+  quint32 m_stringSize;
+};
+
+#endif
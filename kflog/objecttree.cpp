@@ -903,10 +903,5 @@ void ObjectTree::dragMoveEvent( QDragMoveEvent * event )
 
 void ObjectTree::dropEvent( QDropEvent* event )
 {
-  QList<QUrl> urlList = event->mimeData()->urls();
-
-  for( int i = 0; i < urlList.size(); i++ )
-    {
-      emit openFile( urlList.at(i) );
-    }
+  emit openFiles( event->mimeData()->urls() );
 }
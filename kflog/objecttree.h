@@ -247,9 +247,9 @@ signals:
   void openFlight();
 
   /**
-   * Indicate that a file should be opened
+   * Indicate that files should be opened
    */
-  void openFile(const QUrl&);
+  void openFiles(const QList<QUrl>&);
 
   /**
    * Sets the current flight's QNH
@@ -29,6 +29,93 @@
 #include "mapdefaults.h"
 #include "resource.h"
 
+/**
+ * Returns the part of a string reference. No characters are copied.
+ */
+static QStringRef subRef( const QStringRef& ref, const int pos, const int n )
+{
+  return QStringRef( ref.string(), ref.position() + pos, n );
+}
+
+/**
+ * Returns the string reference without leading and trailing white spaces.
+ */
+static QStringRef trimmedRef( const QStringRef& ref )
+{
+  const QChar* data = ref.unicode();
+  int first = 0;
+  int last = ref.size();
+
+  while( first < last && data[first].isSpace() )
+    {
+      first++;
+    }
+
+  while( last > first && data[last - 1].isSpace() )
+    {
+      last--;
+    }
+
+  return subRef( ref, first, last - first );
+}
+
+/**
+ * Converts a decimal number like -12.345 without creating a string. Leading
+ * and trailing white spaces are ignored.
+ */
+static bool toDouble( const QStringRef& ref, double& value )
+{
+  const QStringRef number = trimmedRef( ref );
+  const QChar* data = number.unicode();
+  const int size = number.size();
+
+  int i = 0;
+  bool negative = false;
+
+  if( i < size && (data[i] == QChar('-') || data[i] == QChar('+')) )
+    {
+      negative = data[i] == QChar('-');
+      i++;
+    }
+
+  double mantissa = 0.0;
+  double divisor = 1.0;
+  bool point = false;
+  int digits = 0;
+
+  for( ; i < size; i++ )
+    {
+      const ushort c = data[i].unicode();
+
+      if( c >= '0' && c <= '9' )
+        {
+          mantissa = mantissa * 10.0 + (c - '0');
+          digits++;
+
+          if( point )
+            {
+              divisor *= 10.0;
+            }
+        }
+      else if( c == '.' && ! point )
+        {
+          point = true;
+        }
+      else
+        {
+          return false;
+        }
+    }
+
+  if( digits == 0 )
+    {
+      return false;
+    }
+
+  value = negative ? -mantissa / divisor : mantissa / divisor;
+  return true;
+}
+
 OpenAirParser::OpenAirParser() :
  _lineNumber(0),
  _objCounter(0),
@@ -38,8 +125,12 @@ OpenAirParser::OpenAirParser() :
   asUpperType(BaseMapElement::NotSet),
   asLower(BaseMapElement::NotSet),
   asLowerType(BaseMapElement::NotSet),
+  asCircleRadius(0.0),
+  asCirclePoints(0),
   _awy_width(0),
-  _direction(1)
+  _direction(1),
+  m_mapProjection(true),
+  m_maxArcDeviation(25.0)
 {
   QLocale::setDefault(QLocale::C);
 }
@@ -66,25 +157,59 @@ bool OpenAirParser::parse(const QString& path, QList<Airspace>& list)
 
   m_airspaceTypeMapper = AirspaceHelper::initializeAirspaceTypeMapping( path );
 
-  QTextStream in(&source);
-  in.setCodec( "ISO 8859-15" );
+  // The whole file is decoded at once. The lines are then only referenced
+  // in the decoded text and not copied.
+  QTextCodec* codec = QTextCodec::codecForName( "ISO 8859-15" );
 
-  while( ! in.atEnd() )
+  const QString text = codec ? codec->toUnicode( source.readAll() ) :
+                               QString::fromLatin1( source.readAll() );
+
+  const QChar* data = text.unicode();
+  const int size = text.size();
+  int pos = 0;
+
+  while( pos < size )
     {
-      // qDebug("reading line %d: '%s'", _lineNumber, line.toLatin1().data());
-      QString line = in.readLine().simplified();
-      _lineNumber++;
+      int end = pos;
 
-      if (line.startsWith("*") || line.startsWith("#") || line.isEmpty() )
+      while( end < size && data[end] != QChar('\n') )
         {
-          continue;
+          end++;
         }
 
+      _lineNumber++;
+
       // delete comments at the end of the line before parsing it
-      line = line.split('*')[0];
-      line = line.split('#')[0];
+      int stop = pos;
+
+      while( stop < end && data[stop] != QChar('*') && data[stop] != QChar('#') )
+        {
+          stop++;
+        }
+
+      // remove leading and trailing white spaces
+      int first = pos;
+
+      while( first < stop && data[first].isSpace() )
+        {
+          first++;
+        }
+
+      while( stop > first && data[stop - 1].isSpace() )
+        {
+          stop--;
+        }
+
+      pos = end + 1;
+
+      if( first == stop )
+        {
+          // Empty line or comment line
+          continue;
+        }
 
-      parseLine(line);
+      // qDebug("reading line %d: '%s'", _lineNumber, line.toLatin1().data());
+      parseLine( QStringRef( &text, first, stop - first ) );
     }
 
   if (_isCurrentAirspace)
@@ -116,9 +241,64 @@ void OpenAirParser::resetState()
 }
 
 
-void OpenAirParser::parseLine(QString& line)
+QString OpenAirParser::argumentString( const QStringRef& arg )
 {
-  if (line.startsWith("AC "))
+  const QChar* data = arg.unicode();
+  bool simple = true;
+
+  // Check, if the argument contains any white spaces, which must be
+  // simplified. That is seldom the case.
+  for( int i = 0; i < arg.size(); i++ )
+    {
+      if( data[i].isSpace() &&
+          ( data[i] != QChar(' ') || (i > 0 && data[i - 1].isSpace()) ) )
+        {
+          simple = false;
+          break;
+        }
+    }
+
+  if( simple )
+    {
+      return arg.toString();
+    }
+
+  return arg.toString().simplified();
+}
+
+void OpenAirParser::parseLine( const QStringRef& line )
+{
+  // A record consists of a key, white spaces and an argument. The line has
+  // no leading and trailing white spaces.
+  const QChar* data = line.unicode();
+  const int size = line.size();
+
+  int keyLen = 0;
+
+  while( keyLen < size && ! data[keyLen].isSpace() )
+    {
+      keyLen++;
+    }
+
+  int argStart = keyLen;
+
+  while( argStart < size && data[argStart].isSpace() )
+    {
+      argStart++;
+    }
+
+  if( argStart == keyLen )
+    {
+      //unknown record type, a record has always an argument
+      qDebug( "OAP::parseLine: unknown type at line (%d): %s", _lineNumber,
+              line.toString().toLatin1().data());
+      return;
+    }
+
+  const QStringRef key( line.string(), line.position(), keyLen );
+  const QStringRef arg( line.string(), line.position() + argStart, size - argStart );
+
+  if (key == QLatin1String("AC"))
     {
       //type of record. This also indicates we're starting a new object
       if (_isCurrentAirspace)
@@ -127,24 +307,23 @@ void OpenAirParser::parseLine(QString& line)
 	}
 
       newAirspace();
-      parseType(line);
+      parseType( argumentString(arg) );
       return;
     }
 
   //the rest of the records don't make sense if we're not parsing an object
   int lat, lon;
   double radius;
-  bool ok;
 
   if (!_isCurrentAirspace)
     {
       return;
     }
 
-  if (line.startsWith("AN "))
+  if (key == QLatin1String("AN"))
     {
       // airspace name
-      asName = line.mid(3);
+      asName = argumentString(arg);
 
 #ifdef _MSC_VER
 #pragma message ("warning: Remove airspace mapping workaround for RMZ if it is not more necessary!")
@@ -167,28 +346,24 @@ void OpenAirParser::parseLine(QString& line)
       return;
     }
 
-  if (line.startsWith("AH "))
+  if (key == QLatin1String("AH"))
     {
       //airspace ceiling
-      QString alt = line.mid(3);
-      parseAltitude(alt, asUpperType, asUpper);
+      parseAltitude(arg, asUpperType, asUpper);
       return;
     }
 
-  if (line.startsWith("AL "))
+  if (key == QLatin1String("AL"))
     {
       //airspace floor
-      QString alt = line.mid(3);
-      parseAltitude(alt, asLowerType, asLower);
+      parseAltitude(arg, asLowerType, asLower);
       return;
     }
 
-  if (line.startsWith("DP "))
+  if (key == QLatin1String("DP"))
     {
       //polygon coordinate
-      QString coord = line.mid(3);
-
-      if( parseCoordinate(coord, lat, lon) )
+      if( parseCoordinate(arg, lat, lon) )
         {
           asPA.append(QPoint(lat, lon));
         }
@@ -197,12 +372,10 @@ void OpenAirParser::parseLine(QString& line)
       return;
     }
 
-  if (line.startsWith("DC "))
+  if (key == QLatin1String("DC"))
     {
       //circle
-      radius=line.mid(3).toDouble(&ok);
-
-      if (ok)
+      if( toDouble( arg, radius ) )
         {
           addCircle(radius);
         }
@@ -210,65 +383,38 @@ void OpenAirParser::parseLine(QString& line)
       return;
     }
 
-  if (line.startsWith("DA "))
+  if (key == QLatin1String("DA"))
     {
-
-      makeAngleArc(line.mid(3));
+      makeAngleArc(arg);
       return;
     }
 
-  if (line.startsWith("DB "))
+  if (key == QLatin1String("DB"))
     {
-      makeCoordinateArc(line.mid(3));
+      makeCoordinateArc(arg);
       return;
     }
 
-  if (line.startsWith("DY "))
+  if (key == QLatin1String("V"))
     {
-      //airway
-      return;
-    }
-
-  if (line.startsWith("V "))
-    {
-      parseVariable(line.mid(2));
+      parseVariable(arg);
       return;
     }
 
   //ignored record types
-  if (line.startsWith("AT "))
-    {
-      //label placement, ignore
-      return;
-    }
-
-  if (line.startsWith("TO "))
+  if (key == QLatin1String("DY") || // airway
+      key == QLatin1String("AT") || // label placement
+      key == QLatin1String("TO") || // terrain open polygon
+      key == QLatin1String("TC") || // terrain closed polygon
+      key == QLatin1String("SP") || // pen definition
+      key == QLatin1String("SB"))   // brush definition
     {
-      //terrain open polygon, ignore
-      return;
-    }
-
-  if (line.startsWith("TC "))
-    {
-      //terrain closed polygon, ignore
-      return;
-    }
-
-  if (line.startsWith("SP "))
-    {
-      //pen definition, ignore
-      return;
-    }
-
-  if (line.startsWith("SB "))
-    {
-      //brush definition, ignore
       return;
     }
 
   //unknown record type
   qDebug( "OAP::parseLine: unknown type at line (%d): %s", _lineNumber,
-          line.toLatin1().data());
+          line.toString().toLatin1().data());
 }
 
 
@@ -282,6 +428,8 @@ void OpenAirParser::newAirspace()
   asUpperType = BaseMapElement::NotSet;
   asLower = BaseMapElement::NotSet;
   asLowerType = BaseMapElement::NotSet;
+  asCircleRadius = 0.0;
+  asCirclePoints = 0;
   _isCurrentAirspace = true;
   _direction = 1; //must be reset according to specifications
 }
@@ -306,9 +454,17 @@ void OpenAirParser::finishAirspace()
   // Translate all WGS84 points to current map projection
   QPolygon astPA;
 
-  for (int i = 0; i < asPA.count(); i++)
+  if( m_mapProjection )
+    {
+      for (int i = 0; i < asPA.count(); i++)
+        {
+          astPA.append( _globalMapMatrix->wgsToMap(asPA.at(i)) );
+        }
+    }
+  else
     {
-      astPA.append( _globalMapMatrix->wgsToMap(asPA.at(i)) );
+      // The projection is done later on by the caller.
+      astPA = asPA;
     }
 
   Airspace as( asName,
@@ -317,103 +473,98 @@ void OpenAirParser::finishAirspace()
                asUpper, asUpperType,
                asLower, asLowerType );
 
+  if( asCircleRadius > 0.0 && asCirclePoints == asPA.count() )
+    {
+      // The airspace consists only of a circle. Its exact shape is used
+      // for the point inside checks.
+      as.setCircle( asCircleCenter, asCircleRadius );
+    }
+
   _airlist.append(as);
   _objCounter++;
   _isCurrentAirspace = false;
   //qDebug("finalized airspace %s. %d points in airspace", asName.toLatin1().data(), asPA.count());
 }
 
-void OpenAirParser::parseType(QString& line)
+void OpenAirParser::parseType( const QString& type )
 {
-  line=line.mid(3);
-
-  if( ! m_airspaceTypeMapper.contains(line) )
+  if( ! m_airspaceTypeMapper.contains(type) )
     {
       //no mapping from the found type to a Cumulus base type was found
       qWarning("OAP: Line=%d AS Type, '%s' not mapped to a basetype. Object ignored.",
-               _lineNumber, line.toLatin1().data());
+               _lineNumber, type.toLatin1().data());
       _isCurrentAirspace = false; //stop accepting other lines in this object
       return;
     }
   else
     {
-      asType = m_airspaceTypeMapper.value(line, BaseMapElement::AirUkn);
+      asType = m_airspaceTypeMapper.value(type, BaseMapElement::AirUkn);
     }
 }
 
-void OpenAirParser::parseAltitude(QString& line, BaseMapElement::elevationType& type, int& alt)
+void OpenAirParser::parseAltitude( const QStringRef& line,
+                                   BaseMapElement::elevationType& type,
+                                   int& alt )
 {
   bool convertFromMeters = false;
   bool altitudeIsFeet = false;
-  QString input = line;
-  QStringList elements;
-  int len = 0, pos = 0;
-  QString part;
-  bool ok;
-  int num = 0;
+
+  const QChar* data = line.unicode();
+  const int size = line.size();
 
   type = BaseMapElement::NotSet;
   alt = 0;
-  // qDebug("line %d: parsing altitude '%s'", _lineNumber, line.toLatin1().data());
-  //fist, split the string in parsable elements
-  //we start with the text parts
-  QRegExp reg("[A-Za-z]+");
+  // qDebug("line %d: parsing altitude '%s'", _lineNumber, line.toString().toLatin1().data());
 
-  while (line.length() > 0)
+  // At first the text parts of the line are interpreted.
+  for( int pos = 0; pos < size; )
     {
-      pos = reg.indexIn(line, pos + len);
-      len = reg.matchedLength();
-      if (pos < 0)
+      const ushort c = data[pos].unicode();
+
+      if( ! ((c >= 'A' && c <= 'Z') || (c >= 'a' && c <= 'z')) )
         {
-          break;
+          pos++;
+          continue;
         }
-      elements.append(line.mid(pos, len));
-    }
-
-  //now, get our number parts
 
-  reg.setPattern("[0-9]+");
-  pos=0;
-  len=0;
+      int end = pos;
 
-  while (line.length()>0)
-    {
-      pos = reg.indexIn(line, pos+len);
-      len = reg.matchedLength();
-
-      if (pos<0)
+      while( end < size &&
+             ((data[end].unicode() >= 'A' && data[end].unicode() <= 'Z') ||
+              (data[end].unicode() >= 'a' && data[end].unicode() <= 'z')) )
         {
-          break;
+          end++;
         }
-      elements.append(line.mid(pos, len));
-      line=line.mid(len);
-    }
 
-  // now, try parsing piece by piece
-  for ( QStringList::Iterator it = elements.begin(); it != elements.end(); ++it )
-    {
-      part = (*it).toUpper();
+      const QStringRef part = subRef( line, pos, end - pos );
+      pos = end;
+
       BaseMapElement::elevationType newType = BaseMapElement::NotSet;
 
       // first, try to interpret as elevation type
-      if ( part == "AMSL" || part == "MSL" || part == "ALT" )
+      if( part.compare( QLatin1String("AMSL"), Qt::CaseInsensitive ) == 0 ||
+          part.compare( QLatin1String("MSL"), Qt::CaseInsensitive ) == 0 ||
+          part.compare( QLatin1String("ALT"), Qt::CaseInsensitive ) == 0 )
         {
           newType = BaseMapElement::MSL;
         }
-      else if ( part == "GND" || part == "SFC" || part == "ASFC" ||
-                part == "AGL" || part == "GROUND" )
+      else if( part.compare( QLatin1String("GND"), Qt::CaseInsensitive ) == 0 ||
+               part.compare( QLatin1String("SFC"), Qt::CaseInsensitive ) == 0 ||
+               part.compare( QLatin1String("ASFC"), Qt::CaseInsensitive ) == 0 ||
+               part.compare( QLatin1String("AGL"), Qt::CaseInsensitive ) == 0 ||
+               part.compare( QLatin1String("GROUND"), Qt::CaseInsensitive ) == 0 )
         {
           newType = BaseMapElement::GND;
         }
-      else if (part.startsWith("UNL"))
+      else if( part.startsWith( QLatin1String("UNL"), Qt::CaseInsensitive ) )
         {
           newType = BaseMapElement::UNLTD;
         }
-      else if (part == "FL")
+      else if( part.compare( QLatin1String("FL"), Qt::CaseInsensitive ) == 0 )
         {
           newType = BaseMapElement::FL;
         }
-      else if (part == "STD")
+      else if( part.compare( QLatin1String("STD"), Qt::CaseInsensitive ) == 0 )
         {
           newType = BaseMapElement::STD;
         }
@@ -430,33 +581,53 @@ void OpenAirParser::parseAltitude(QString& line, BaseMapElement::elevationType&
           // elevation type. That can be only a mistake in the data
           // and will be ignored.
           qWarning( "OpenAirParser: Line=%d, '%s' contains more than one elevation type. Only first one is taken",
-                    _lineNumber, input.toLatin1().data());
+                    _lineNumber, line.toString().toLatin1().data());
           continue;
         }
 
       //see if it is a way of setting units to feet
-      if (part == "FT")
+      if( part.compare( QLatin1String("FT"), Qt::CaseInsensitive ) == 0 )
         {
           altitudeIsFeet = true;
           continue;
         }
 
       //see if it is a way of setting units to meters
-      if (part == "M")
+      if( part.compare( QLatin1String("M"), Qt::CaseInsensitive ) == 0 )
         {
           convertFromMeters = true;
           continue;
         }
 
-      //try to interpret as a number
-      num = part.toInt(&ok);
-      if (ok)
+      //ignore other parts
+    }
+
+  // Then the number parts are interpreted, the last one is the altitude.
+  for( int pos = 0; pos < size; )
+    {
+      if( data[pos].unicode() < '0' || data[pos].unicode() > '9' )
         {
-          alt = num;
+          pos++;
+          continue;
         }
 
-      //ignore other parts
+      qint64 num = 0;
+      int digits = 0;
+
+      while( pos < size && data[pos].unicode() >= '0' && data[pos].unicode() <= '9' )
+        {
+          num = num * 10 + (data[pos].unicode() - '0');
+          digits++;
+          pos++;
+        }
+
+      // Too large numbers are ignored.
+      if( digits <= 9 )
+        {
+          alt = (int) num;
+        }
     }
+
   if ( altitudeIsFeet && type == BaseMapElement::NotSet )
     {
       type = BaseMapElement::MSL;
@@ -478,19 +649,30 @@ void OpenAirParser::parseAltitude(QString& line, BaseMapElement::elevationType&
 }
 
 
-bool OpenAirParser::parseCoordinate(QString& line, int& lat, int& lon)
+bool OpenAirParser::parseCoordinate( const QStringRef& line, int& lat, int& lon )
 {
   bool result=true;
-  line=line.toUpper();
 
-  int pos=0;
+  const QChar* data = line.unicode();
+  int pos = 0;
+
   lat=0;
   lon=0;
 
-  QRegExp reg("[NSEW]");
-  pos = reg.indexIn(line, 0);
+  // The first sky direction separates latitude and longitude.
+  while( pos < line.size() )
+    {
+      const QChar c = data[pos].toUpper();
+
+      if( c == QChar('N') || c == QChar('S') || c == QChar('E') || c == QChar('W') )
+        {
+          break;
+        }
+
+      pos++;
+    }
 
-  if( pos == -1 )
+  if( pos == line.size() )
     {
       qWarning() << "OAP::parseCoordinate: line"
                  << _lineNumber
@@ -499,18 +681,14 @@ bool OpenAirParser::parseCoordinate(QString& line, int& lat, int& lon)
       return false;
     }
 
-  QString part1 = line.left(pos+1);
-  QString part2 = line.mid(pos+1);
-
-  result &= parseCoordinatePart(part1, lat, lon);
-  result &= parseCoordinatePart(part2, lat, lon);
+  result &= parseCoordinatePart( subRef( line, 0, pos + 1 ), lat, lon );
+  result &= parseCoordinatePart( subRef( line, pos + 1, line.size() - pos - 1 ), lat, lon );
 
   return result;
 }
 
-bool OpenAirParser::parseCoordinatePart(QString& line, int& lat, int& lon)
+bool OpenAirParser::parseCoordinatePart( const QStringRef& line, int& lat, int& lon )
 {
-  bool ok, ok1, ok2 = false;
   int value = 0;
 
   if( line.isEmpty() )
@@ -521,118 +699,77 @@ bool OpenAirParser::parseCoordinatePart(QString& line, int& lat, int& lon)
 
   // A input line can contain elements like:
   // P1= "50:11:31.1504N" P2= " 17:42:38.5171E"
+  // The elements are separated by colons, the last one ends with the sky
+  // direction.
+  QStringRef elements[3];
+  int count = 0;
+  int start = 0;
 
-  QStringList sl = line.split(QChar(':'));
-  QString skyDirection;
-
-  if( sl.size() == 1 )
+  for( int i = 0; i <= line.size(); i++ )
     {
-      // One element is contained, that means decimal degrees
-      QString deg = sl.at(0).trimmed();
-      skyDirection = deg.right(1);
-
-      if( skyDirection != "N" && skyDirection != "S" && skyDirection != "W" && skyDirection != "E" )
+      if( i < line.size() && line.at(i) != QChar(':') )
         {
-          qWarning() << "OAP::parseCoordinatePart: wrong sky direction at line" << _lineNumber;
-          return false;
+          continue;
         }
 
-      deg = deg.left( deg.size() - 1 );
-
-      double ddeg = deg.toDouble(&ok);
-
-      if( ! ok )
+      if( count == 3 )
         {
-          qWarning() << "OAP::parseCoordinatePart: wrong coordinate value"
-                     << line << "at line" << _lineNumber;
+          qWarning("OAP::parseCoordinatePart: unknown format! Line %d", _lineNumber);
           return false;
         }
 
-      value = static_cast<int> (rint(ddeg * 600000.0));
+      elements[count++] = trimmedRef( subRef( line, start, i - start ) );
+      start = i + 1;
     }
-  else if( sl.size() == 2 )
-    {
-      // Two elements are contained
-      QString deg = sl.at(0).trimmed();
-      QString min = sl.at(1).trimmed();
-
-      skyDirection = min.right(1);
-
-      if( skyDirection != "N" && skyDirection != "S" && skyDirection != "W" && skyDirection != "E" )
-        {
-          qWarning() << "OAP::parseCoordinatePart: wrong sky direction at line" << _lineNumber;
-          return false;
-        }
 
-      min = min.left( min.size() - 1 );
+  QStringRef& last = elements[count - 1];
 
-      double ddeg = deg.toDouble(&ok);
-      double dmin = min.toDouble(&ok1);
+  const QChar skyDirection = last.isEmpty() ? QChar() : last.at( last.size() - 1 ).toUpper();
 
-      if( ! ok || ! ok1 )
-        {
-          qWarning() << "OAP::parseCoordinatePart: wrong coordinate value"
-                      << line << "at line" << _lineNumber;
-          return false;
-        }
-
-      value = static_cast<int> (rint((ddeg * 600000.0) + (dmin * 10000.0)));
-    }
-  else if( sl.size() == 3 )
+  if( skyDirection != QChar('N') && skyDirection != QChar('S') &&
+      skyDirection != QChar('W') && skyDirection != QChar('E') )
     {
-      // Three elements are contained
-      QString deg = sl.at(0).trimmed();
-      QString min = sl.at(1).trimmed();
-      QString sec = sl.at(2).trimmed();
-
-      skyDirection = sec.right(1);
-
-      if( skyDirection != "N" && skyDirection != "S" && skyDirection != "W" && skyDirection != "E" )
-        {
-          qWarning() << "OAP::parseCoordinatePart: wrong sky direction" << skyDirection << "at line" << _lineNumber;
-          return false;
-        }
+      qWarning() << "OAP::parseCoordinatePart: wrong sky direction at line" << _lineNumber;
+      return false;
+    }
 
-      sec = sec.left( sec.size() - 1 );
+  last = subRef( last, 0, last.size() - 1 );
 
-      double ddeg = deg.toDouble(&ok);
-      double dmin = min.toDouble(&ok1);
-      double dsec = sec.toDouble(&ok2);
+  double number[3] = { 0.0, 0.0, 0.0 };
 
-      if( ! ok || ! ok1 || ! ok2 )
+  for( int i = 0; i < count; i++ )
+    {
+      if( ! toDouble( elements[i], number[i] ) )
         {
           qWarning() << "OAP::parseCoordinatePart: wrong coordinate value"
-                      << line << "at line" << _lineNumber;
+                     << line.toString() << "at line" << _lineNumber;
           return false;
         }
-
-      value = static_cast<int> (rint((600000.0 * ddeg) + (10000.0 * (dmin + (dsec / 60.0)))));
-    }
-  else
-    {
-      qWarning("OAP::parseCoordinatePart: unknown format! Line %d", _lineNumber);
-      return false;
     }
 
-  if( skyDirection == "N" )
+  // degrees, minutes and seconds
+  value = static_cast<int> (rint((600000.0 * number[0]) +
+                                 (10000.0 * (number[1] + (number[2] / 60.0)))));
+
+  if( skyDirection == QChar('N') )
     {
       lat = value;
       return true;
     }
 
-  if( skyDirection == "S" )
+  if( skyDirection == QChar('S') )
     {
       lat = -value;
       return true;
     }
 
-  if( skyDirection == "E" )
+  if( skyDirection == QChar('E') )
     {
       lon = value;
       return true;
     }
 
-  if( skyDirection == "W" )
+  if( skyDirection == QChar('W') )
     {
       lon = -value;
       return true;
@@ -641,7 +778,7 @@ bool OpenAirParser::parseCoordinatePart(QString& line, int& lat, int& lon)
   return false;
 }
 
-bool OpenAirParser::parseCoordinate(QString& line, QPoint& coord)
+bool OpenAirParser::parseCoordinate( const QStringRef& line, QPoint& coord )
 {
   int lat=0, lon=0;
   bool result = parseCoordinate(line, lat, lon);
@@ -651,29 +788,41 @@ bool OpenAirParser::parseCoordinate(QString& line, QPoint& coord)
 }
 
 
-bool OpenAirParser::parseVariable(QString line)
+bool OpenAirParser::parseVariable( const QStringRef& line )
 {
-  QStringList arguments=line.split('=');
-  if (arguments.count()<2)
-    return false;
+  const int eq = line.indexOf( QChar('=') );
 
-  QString variable=arguments[0].simplified().toUpper();
-  QString value=arguments[1].simplified();
-  // qDebug("line %d: variable = '%s', value='%s'", _lineNumber, variable.toLatin1().data(), value.toLatin1().data());
-  if (variable=="X")
+  if( eq < 0 )
+    {
+      return false;
+    }
+
+  // The value ends at a further equal sign.
+  int end = line.indexOf( QChar('='), eq + 1 );
+
+  if( end < 0 )
+    {
+      end = line.size();
+    }
+
+  const QStringRef variable = trimmedRef( subRef( line, 0, eq ) );
+  const QStringRef value = trimmedRef( subRef( line, eq + 1, end - eq - 1 ) );
+
+  // qDebug("line %d: variable = '%s', value='%s'", _lineNumber, variable.toString().toLatin1().data(), value.toString().toLatin1().data());
+  if( variable.compare( QLatin1String("X"), Qt::CaseInsensitive ) == 0 )
     {
       //coordinate
       return parseCoordinate(value, _center);
     }
 
-  if (variable=="D")
+  if( variable.compare( QLatin1String("D"), Qt::CaseInsensitive ) == 0 )
     {
       //direction
-      if (value=="+")
+      if (value == QLatin1String("+"))
         {
           _direction=+1;
         }
-      else if (value=="-")
+      else if (value == QLatin1String("-"))
         {
           _direction=-1;
         }
@@ -684,12 +833,12 @@ bool OpenAirParser::parseVariable(QString line)
       return true;
     }
 
-  if (variable=="W")
+  if( variable.compare( QLatin1String("W"), Qt::CaseInsensitive ) == 0 )
     {
       //airway width
-      bool ok;
-      double result=value.toDouble(&ok);
-      if (ok)
+      double result;
+
+      if( toDouble( value, result ) )
         {
           _awy_width = result;
           return true;
@@ -697,7 +846,7 @@ bool OpenAirParser::parseVariable(QString line)
       return false;
     }
 
-  if (variable=="Z")
+  if( variable.compare( QLatin1String("Z"), Qt::CaseInsensitive ) == 0 )
     {
       //zoom visiblity at zoom level; ignore
       return true;
@@ -709,33 +858,30 @@ bool OpenAirParser::parseVariable(QString line)
 
 // DA radius, angleStart, angleEnd
 // radius in nm, center defined by using V X=...
-bool OpenAirParser::makeAngleArc(QString line)
+bool OpenAirParser::makeAngleArc( const QStringRef& line )
 {
   //qDebug("OpenAirParser::makeAngleArc");
-  bool ok;
   double radius, angle1, angle2;
 
-  QStringList arguments = line.split(',');
-  if (arguments.count()<3)
-    return false;
+  const int comma1 = line.indexOf( QChar(',') );
+  const int comma2 = comma1 < 0 ? -1 : line.indexOf( QChar(','), comma1 + 1 );
 
-  radius=arguments[0].trimmed().toDouble(&ok);
-
-  if ( !ok )
+  if( comma2 < 0 )
     {
       return false;
     }
 
-  angle1=arguments[1].trimmed().toDouble(&ok);
+  // A further argument is ignored.
+  int end = line.indexOf( QChar(','), comma2 + 1 );
 
-  if (!ok)
+  if( end < 0 )
     {
-      return false;
+      end = line.size();
     }
 
-  angle2=arguments[2].trimmed().toDouble(&ok);
-
-  if (!ok)
+  if( ! toDouble( subRef( line, 0, comma1 ), radius ) ||
+      ! toDouble( subRef( line, comma1 + 1, comma2 - comma1 - 1 ), angle1 ) ||
+      ! toDouble( subRef( line, comma2 + 1, end - comma2 - 1 ), angle2 ) )
     {
       return false;
     }
@@ -750,7 +896,8 @@ bool OpenAirParser::makeAngleArc(QString line)
   double kmr = radius * MILE_kfl / 1000.;
   //qDebug( "distLat=%f, distLon=%f, radius=%fkm", distLat, distLon, kmr );
 
-  addArc( kmr/(distLat/10000.), kmr/(distLon/10000.), angle1/180*M_PI, angle2/180*M_PI );
+  addArc( kmr/(distLat/10000.), kmr/(distLon/10000.), kmr * 1000.,
+          angle1/180*M_PI, angle2/180*M_PI );
   return true;
 }
 
@@ -810,21 +957,34 @@ double OpenAirParser::bearing( QPoint& p1, QPoint& p2 )
  * DB coordinate1, coordinate2
  * center defined by using V X=...
  */
-bool OpenAirParser::makeCoordinateArc(QString line)
+bool OpenAirParser::makeCoordinateArc( const QStringRef& line )
 {
   // qDebug("OpenAirParser::makeCoordinateArc");
   double radius, angle1, angle2;
 
   //split of the coordinates, and check the number of arguments
-  QStringList arguments = line.split(',');
-  if (arguments.count()<2)
-    return false;
+  const int comma = line.indexOf( QChar(',') );
+
+  if( comma < 0 )
+    {
+      return false;
+    }
+
+  int end = line.indexOf( QChar(','), comma + 1 );
+
+  if( end < 0 )
+    {
+      end = line.size();
+    }
 
   QPoint coord1, coord2;
 
   //try to parse the coordinates
-  if (!(parseCoordinate(arguments[0], coord1) && parseCoordinate(arguments[1], coord2)))
-    return false;
+  if( ! (parseCoordinate( subRef( line, 0, comma ), coord1 ) &&
+         parseCoordinate( subRef( line, comma + 1, end - comma - 1 ), coord2 )) )
+    {
+      return false;
+    }
 
   //calculate the radius by taking the average of the two distances (in km)
   radius = (dist(&_center, &coord1) + dist(&_center, &coord2)) / 2.0;
@@ -846,19 +1006,44 @@ bool OpenAirParser::makeCoordinateArc(QString line)
   angle2 = bearing(_center, coord2);
 
   // add the arc to the point array
-  addArc( radius/(distLat/10000.), radius/(distLon/10000.), angle1, angle2 );
+  addArc( radius/(distLat/10000.), radius/(distLon/10000.), radius * 1000.,
+          angle1, angle2 );
   return true;
 }
 
 
-void OpenAirParser::addCircle(const double& rLat, const double& rLon)
+double OpenAirParser::arcStep( const double& meters ) const
+{
+  // The chords of a polygon with the angular step a have a maximum distance
+  // of r * (1 - cos(a/2)) to the arc. The step is limited to the range
+  // from 1 degree, the former fixed step, up to 10 degrees.
+  const double minStep = M_PI / 180.0;
+  const double maxStep = M_PI / 18.0;
+
+  if( meters <= m_maxArcDeviation )
+    {
+      return maxStep;
+    }
+
+  double step = 2.0 * acos( 1.0 - m_maxArcDeviation / meters );
+
+  return qBound( minStep, step, maxStep );
+}
+
+
+void OpenAirParser::addCircle( const double& rLat, const double& rLon,
+                               const double& meters )
 {
   double x, y, phi;
 
-  // qDebug("rLat: %d, rLon:%d", rLat, rLon);
-  for (int i=0; i<360; i+=1)
+  int nsteps = int( ceil( (2.0 * M_PI) / arcStep( meters ) ) );
+
+  const double step = (2.0 * M_PI) / nsteps;
+
+  // qDebug("rLat: %d, rLon:%d, steps: %d", rLat, rLon, nsteps);
+  for( int i = 0; i < nsteps; i++ )
     {
-      phi=double(i)/180.0*M_PI;
+      phi = i * step;
       x = cos(phi)*rLat;
       y = sin(phi)*rLon;
       x +=_center.x();
@@ -882,13 +1067,23 @@ void OpenAirParser::addCircle(const double& radius)
 
   //qDebug( "distLat=%f, distLon=%f, radius=%fkm", distLat, distLon, kmr );
 
-  addCircle( kmr/(distLat/10000.), kmr/(distLon/10000.) );  // kilometer/minute
-}
+  bool single = asPA.isEmpty();
 
+  addCircle( kmr/(distLat/10000.), kmr/(distLon/10000.), kmr * 1000. );  // kilometer/minute
+
+  if( single )
+    {
+      // Remember the exact circle. It is only used, if no further points
+      // are added to the airspace.
+      asCircleCenter = _center;
+      asCircleRadius = kmr * 1000.;
+      asCirclePoints = asPA.count();
+    }
+}
 
-#define STEP_WIDTH 1
 
 void OpenAirParser::addArc(const double& rX, const double& rY,
+                           const double& meters,
                            double angle1, double angle2)
 {
   //qDebug("addArc() dir=%d, a1=%f a2=%f",_direction, angle1*180/M_PI , angle2*180/M_PI );
@@ -906,29 +1101,27 @@ void OpenAirParser::addArc(const double& rX, const double& rY,
         angle1 += 2.0 * M_PI;
     }
 
-  int nsteps = abs(int(((angle2 - angle1) * 180) / (STEP_WIDTH * M_PI))) + 2;
+  // The arc is divided into equal steps, which are not larger than the
+  // allowed step for its radius.
+  int nsteps = int( ceil( fabs( angle2 - angle1 ) / arcStep( meters ) ) );
 
-  //qDebug("delta=%d pai=%d",int(((angle2-angle1)*180)/(STEP_WIDTH*M_PI)), pai );
+  if( nsteps < 1 )
+    {
+      nsteps = 1;
+    }
 
-  const double step = (STEP_WIDTH * M_PI) / 180.0;
+  const double step = (angle2 - angle1) / nsteps;
 
-  double phi = angle1;
+  //qDebug("delta=%f steps=%d", (angle2-angle1)*180/M_PI, nsteps );
 
-  for (int i = 0; i < nsteps - 1; i++)
+  for (int i = 0; i < nsteps; i++)
     {
+      double phi = angle1 + i * step;
+
       x = (cos(phi) * rX) + _center.x();
       y = (sin(phi) * rY) + _center.y();
 
       asPA.append( QPoint((int) rint(x), (int) rint(y)) );
-
-      if (_direction > 0) //clockwise
-        {
-          phi += step;
-        }
-      else
-        {
-          phi -= step;
-        }
     }
 
   x = (cos(angle2) * rX) + _center.x();
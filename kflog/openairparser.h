@@ -49,6 +49,7 @@
 #include <QDataStream>
 #include <QPolygon>
 #include <QPoint>
+#include <QStringRef>
 
 #include "basemapelement.h"
 
@@ -79,27 +80,72 @@ public:
    */
   bool parse(const QString& path, QList<Airspace>& list);
 
+  /**
+   * Enables or disables the projection of the read coordinates. If disabled,
+   * the polygons of the airspaces contain the WGS84 coordinates and the
+   * projection has to be done by the caller. That is required, if the parser
+   * runs in a worker thread, because the map projection is not thread safe.
+   *
+   * @param enable The new projection mode, default is enabled
+   */
+  void setMapProjection( const bool enable )
+  {
+    m_mapProjection = enable;
+  };
+
+  /**
+   * Sets the maximum allowed deviation of the tessellated arcs and circles
+   * from their exact course. The number of polygon points of an arc depends
+   * then on its radius.
+   *
+   * @param meters The maximum deviation in meters
+   */
+  void setMaxArcDeviation( const double meters )
+  {
+    m_maxArcDeviation = meters;
+  };
+
 private:
 
   void resetState();
-  void parseLine(QString&);
+
+  /**
+   * Parses a line, which must not contain comments and leading or trailing
+   * white spaces.
+   */
+  void parseLine( const QStringRef& line );
+
+  /**
+   * Returns the argument of a record as string. White spaces in it are
+   * simplified. Only used for the values of AC and AN records, all other
+   * records are parsed in place from their character span.
+   */
+  static QString argumentString( const QStringRef& arg );
+
   void newAirspace();
   void newPA();
   void finishAirspace();
-  void parseType(QString&);
-  void parseAltitude(QString&, BaseMapElement::elevationType&, int&);
-  bool parseCoordinate(QString&, int& lat, int& lon);
-  bool parseCoordinate(QString&, QPoint&);
-  bool parseCoordinatePart(QString&, int& lat, int& lon);
-  bool parseVariable(QString);
-  bool makeAngleArc(QString);
-  bool makeCoordinateArc(QString);
+  void parseType( const QString& type );
+  void parseAltitude( const QStringRef&, BaseMapElement::elevationType&, int& );
+  bool parseCoordinate( const QStringRef&, int& lat, int& lon );
+  bool parseCoordinate( const QStringRef&, QPoint& );
+  bool parseCoordinatePart( const QStringRef&, int& lat, int& lon );
+  bool parseVariable( const QStringRef& );
+  bool makeAngleArc( const QStringRef& );
+  bool makeCoordinateArc( const QStringRef& );
   double bearing( QPoint& p1, QPoint& p2 );
-  void addCircle(const double& rLat, const double& rLon);
+  void addCircle(const double& rLat, const double& rLon, const double& meters);
   void addCircle(const double& radius);
-  void addArc(const double& rLat, const double& rLon,
+  void addArc(const double& rLat, const double& rLon, const double& meters,
               double angle1, double angle2);
 
+  /**
+   * Returns the angular step in radians between two points of an arc with
+   * the passed radius in meters, so that the chords do not deviate more than
+   * the configured maximum from the arc.
+   */
+  double arcStep( const double& meters ) const;
+
 private:
 
   QList<Airspace> _airlist;
@@ -116,6 +162,17 @@ private:
   BaseMapElement::elevationType asLowerType;
 
   QPoint _center;
+
+  /**
+   * Center and radius in meters of a circular airspace. The radius is zero,
+   * if the current airspace is not a single circle.
+   */
+  QPoint asCircleCenter;
+  double asCircleRadius;
+
+  /** Number of polygon points after the circle has been added. */
+  int asCirclePoints;
+
   double _awy_width;
   int _direction; // 1 for clockwise, -1 for anti clockwise
 
@@ -123,6 +180,17 @@ private:
    * Mapper openair airspace type to Cumulus airspace type.
    */
   QMap<QString, BaseMapElement::objectType> m_airspaceTypeMapper;
+
+  /**
+   * Flag to enable the projection of the read coordinates.
+   */
+  bool m_mapProjection;
+
+  /**
+   * Maximum deviation in meters of the tessellated arcs from their exact
+   * course.
+   */
+  double m_maxArcDeviation;
 };
 
 #endif
@@ -25,6 +25,7 @@
 #include "glview.h"
 
 #include <cmath>
+#include <cstddef>
 #include <cstdlib>
 
 #include "../flight.h"
@@ -34,6 +35,65 @@
 #include <QtGui>
 #include <QtOpenGL>
 
+/**
+ * Vertex shader. The vertex color depends on the selected color mode.
+ */
+static const char* VertexShaderSource =
+  "attribute vec3 a_position;\n"
+  "attribute float a_vario;\n"
+  "attribute float a_time;\n"
+  "attribute vec4 a_color;\n"
+  "uniform int u_colorMode;\n"
+  "uniform bool u_shadow;\n"
+  "uniform float u_minZ;\n"
+  "uniform float u_maxZ;\n"
+  "varying vec4 v_color;\n"
+  "varying float v_time;\n"
+  "void main()\n"
+  "{\n"
+  "  gl_Position = gl_ModelViewProjectionMatrix * vec4( a_position, 1.0 );\n"
+  "  v_time = a_time;\n"
+  "  if( u_shadow )\n"
+  "    {\n"
+  "      v_color = vec4( 0.5, 0.5, 0.5, 1.0 );\n"
+  "    }\n"
+  "  else if( u_colorMode == 1 )\n"
+  "    {\n"
+  "      float t = clamp( (a_position.z - u_minZ) / max( u_maxZ - u_minZ, 1.0 ), 0.0, 1.0 );\n"
+  "      v_color = vec4( t, 0.2, 1.0 - t, 1.0 );\n"
+  "    }\n"
+  "  else if( u_colorMode == 2 )\n"
+  "    {\n"
+  "      float t = clamp( a_vario / 5.0, -1.0, 1.0 );\n"
+  "      v_color = t >= 0.0 ? mix( vec4( 1.0 ), vec4( 1.0, 0.0, 0.0, 1.0 ), t ) :\n"
+  "                           mix( vec4( 1.0 ), vec4( 0.0, 0.0, 1.0, 1.0 ), -t );\n"
+  "    }\n"
+  "  else\n"
+  "    {\n"
+  "      v_color = a_color;\n"
+  "    }\n"
+  "}\n";
+
+/**
+ * Fragment shader. Fragments outside of the time window are dropped.
+ */
+static const char* FragmentShaderSource =
+  "uniform float u_timeStart;\n"
+  "uniform float u_timeEnd;\n"
+  "varying vec4 v_color;\n"
+  "varying float v_time;\n"
+  "void main()\n"
+  "{\n"
+  "  if( u_timeEnd > u_timeStart && (v_time < u_timeStart || v_time > u_timeEnd) )\n"
+  "    {\n"
+  "      discard;\n"
+  "    }\n"
+  "  gl_FragColor = v_color;\n"
+  "}\n";
+
+/** Flight time in seconds the playback is advanced per timer step. */
+#define PLAYBACK_STEP 60
+
 /*!
   This is the main class for the OpenGL implementation. The constructor
   initializes some variables.
@@ -42,7 +102,10 @@
 GLView::GLView( QWidget* parent ) : QGLWidget( parent )
 {
   setToolTip(tr("Press left or right mouse button during move to change the view.\n"
-                 "Use mouse wheel for zooming."));
+                 "Use mouse wheel for zooming.\n"
+                 "Press C to change the flight colors, P to start or stop the playback."));
+  setFocusPolicy( Qt::StrongFocus );
+
   // These values should be stored KConfig
   xRot = -45.0;
   yRot = 0.0;
@@ -55,6 +118,16 @@ GLView::GLView( QWidget* parent ) : QGLWidget( parent )
   deltaY = 0.0;
   deltaZ = 0.0;
   boxObject = 0;          // bounding box object (0 means none)
+  program = 0;
+  useShaders = false;
+  colorMode = DrawPenColor;
+  timeStart = timeEnd = 0.0;
+  firstTime = lastTime = 0.0;
+  minx = maxx = miny = maxy = minz = maxz = 0;
+
+  playbackTimer = new QTimer( this );
+  playbackTimer->setInterval( 40 );
+  connect( playbackTimer, SIGNAL(timeout()), this, SLOT(slotPlaybackStep()) );
 }
 
 
@@ -63,6 +136,8 @@ GLView::GLView( QWidget* parent ) : QGLWidget( parent )
  */
 GLView::~GLView()
 {
+  makeCurrent();
+
   if( boxObject )
     {
       glDeleteLists( boxObject, 1 );
@@ -70,126 +145,199 @@ GLView::~GLView()
 
   for( int i = 0; i < flightList.size(); i++ )
     {
-      glDeleteLists( flightList.at( i ), 1 );
+      delete flightList.at( i ).vbo;
     }
+
+  delete program;
 }
 
-void GLView::addShadow(Flight* flight)
+void GLView::addFlight(Flight* flight)
 {
-  if (flight)
+  if( flight == 0 || flight->getRouteLength() == 0 )
     {
-      int length = flight->getRouteLength();
+      return;
+    }
 
-      GLuint list = glGenLists( 1 );
+  extern MapConfig _globalMapConfig;
 
-      glNewList( list, GL_COMPILE );
+  QList<FlightPoint*>& route = flight->getRoute();
 
-      qglColor( Qt::gray ); // Shorthand for glColor3f or glIndex
-      glLineWidth( 2.0 );
+  FlightBuffer fb;
+  fb.vbo   = 0;
+  fb.count = route.size();
+  fb.vertices.resize( fb.count );
 
-      FlightPoint fPoint;
-      int actx, acty, actz;
-      fPoint = flight->getPoint( 0 );
-      actx = fPoint.projP.x();
-      acty = -fPoint.projP.y(); // Attention!
-      actz = minz;
-      glVertex3i( actx, acty, actz );
-      minx = actx;
-      maxx = actx;
-      miny = acty;
-      maxy = acty;
-      minz = actz;
-      maxz = actz;
+  // The time is stored in seconds of the day, so that the flights of a
+  // group can be shown in the same time window.
+  const time_t dayStart = route.at( 0 )->time - (route.at( 0 )->time % 86400);
 
-      glBegin( GL_LINE_LOOP );
+  if( flightList.isEmpty() )
+    {
+      minx = maxx = route.at( 0 )->projP.x();
+      miny = maxy = -route.at( 0 )->projP.y(); // Attention!
+      minz = maxz = route.at( 0 )->height;
+      firstTime = lastTime = route.at( 0 )->time - dayStart;
+    }
 
-      for( int i = 1; i < length; i++ )
+  for( int i = 0; i < fb.count; i++ )
+    {
+      FlightPoint* fPoint = route.at( i );
+      GLVertex& v = fb.vertices[i];
+
+      v.x = fPoint->projP.x();
+      v.y = -fPoint->projP.y(); // Attention!
+      v.z = fPoint->height;
+      v.vario = fPoint->dT > 0 ? float( fPoint->dH ) / float( fPoint->dT ) : 0.0;
+      v.time = fPoint->time - dayStart;
+
+      if( i > 0 && v.time < fb.vertices[i - 1].time )
         {
-          fPoint = flight->getPoint( i );
-          actx = fPoint.projP.x();
-          acty = -fPoint.projP.y();
-          glVertex3i( actx, acty, actz );
+          // Correct time for overnight-flights
+          v.time += 86400;
         }
 
-      glEnd();
-      glEndList();
+      QColor color = _globalMapConfig.getDrawPen( fPoint ).color();
+      v.color[0] = color.red();
+      v.color[1] = color.green();
+      v.color[2] = color.blue();
+      v.color[3] = 255;
+
+      maxx = qMax( long( v.x ), maxx );
+      minx = qMin( long( v.x ), minx );
+      maxy = qMax( long( v.y ), maxy );
+      miny = qMin( long( v.y ), miny );
+      maxz = qMax( long( v.z ), maxz );
+      minz = qMin( long( v.z ), minz );
+    }
+
+  firstTime = qMin( firstTime, fb.vertices.first().time );
+  lastTime  = qMax( lastTime, fb.vertices.last().time );
+
+  flightList.append( fb );
 
-      flightList.append( list );
+  // center all flights
+  deltaX = -(maxx + minx) / 2.0;
+  deltaY = -(maxy + miny) / 2.0;
+  deltaZ = -(maxz + minz) / 2.0;
+
+  // change Bounding Box
+  scale = qMax( abs( maxx - minx ), abs( maxy - miny ) );
+  scale = qMax( double( scale ), fabs( maxz - minz ) );
+  scale = 1.0 / qMax( double( scale ), 1.0 );
+
+  makeCurrent();
+
+  if( boxObject )
+    {
+      glDeleteLists( boxObject, 1 );
     }
+
+  boxObject = makeBoxObject();
+  updateGL();
 }
 
-void GLView::addFlight(Flight* flight)
+void GLView::uploadFlights()
 {
-  if( flight )
+  for( int i = 0; i < flightList.size(); i++ )
     {
-      int length = flight->getRouteLength();
+      FlightBuffer& fb = flightList[i];
 
-      // qDebug( "Adding %d points", length );
-
-      extern MapConfig _globalMapConfig;
+      if( fb.vbo != 0 )
+        {
+          continue;
+        }
 
-      GLuint list = glGenLists( 1 );
+      fb.vbo = new QGLBuffer( QGLBuffer::VertexBuffer );
+      fb.vbo->setUsagePattern( QGLBuffer::StaticDraw );
 
-      glNewList( list, GL_COMPILE );
+      if( fb.vbo->create() == false || fb.vbo->bind() == false )
+        {
+          qWarning( "GLView: Cannot create vertex buffer!" );
+          continue;
+        }
 
-      qglColor( Qt::blue ); // Shorthand for glColor3f or glIndex
+      fb.vbo->allocate( fb.vertices.constData(), fb.count * sizeof(GLVertex) );
+      fb.vbo->release();
 
-      glLineWidth( 2.0 );
+      // The vertex data are now kept by the graphic card.
+      fb.vertices = QVector<GLVertex>();
+    }
+}
 
-      FlightPoint fPoint;
-      int actx, acty, actz;
-      fPoint = flight->getPoint( 0 );
-      actx = fPoint.projP.x();
-      acty = -fPoint.projP.y(); // Attention!
-      actz = fPoint.height;
-      glVertex3i( actx, acty, actz );
-      minx = actx;
-      maxx = actx;
-      miny = acty;
-      maxy = acty;
-      minz = actz;
-      maxz = actz;
+void GLView::drawFlights( bool shadow )
+{
+  const int stride = sizeof(GLVertex);
 
-      glBegin( GL_LINE_LOOP );
+  if( useShaders )
+    {
+      program->bind();
+      program->setUniformValue( "u_colorMode", GLint( colorMode ) );
+      program->setUniformValue( "u_shadow", GLint( shadow ) );
+      program->setUniformValue( "u_minZ", GLfloat( minz ) );
+      program->setUniformValue( "u_maxZ", GLfloat( maxz ) );
+      program->setUniformValue( "u_timeStart", timeStart );
+      program->setUniformValue( "u_timeEnd", timeEnd );
+      program->enableAttributeArray( "a_position" );
+      program->enableAttributeArray( "a_vario" );
+      program->enableAttributeArray( "a_time" );
+      program->enableAttributeArray( "a_color" );
+    }
+  else
+    {
+      glEnableClientState( GL_VERTEX_ARRAY );
 
-      for( int i = 1; i < length; i++ )
+      if( shadow )
         {
-          fPoint = flight->getPoint( i );
-          actx = fPoint.projP.x();
-          acty = -fPoint.projP.y();
-          actz = fPoint.height;
-
-          QPen drawP = _globalMapConfig.getDrawPen( &fPoint );
-          qglColor( drawP.color() );
-          glVertex3i( actx, acty, actz );
-          maxx = qMax( long( actx ), maxx );
-          minx = qMin( long( actx ), minx );
-          maxy = qMax( long( acty ), maxy );
-          miny = qMin( long( acty ), miny );
-          maxz = qMax( long( actz ), maxz );
-          minz = qMin( long( actz ), minz );
+          qglColor( Qt::gray );
         }
+      else
+        {
+          glEnableClientState( GL_COLOR_ARRAY );
+        }
+    }
 
-      glEnd();
-      glEndList();
-
-      deltaX = -(maxx + minx) / 2.0;
-      deltaY = -(maxy + miny) / 2.0;
-      deltaZ = -(maxz + minz) / 2.0;
-      flightList.append( list );
+  for( int i = 0; i < flightList.size(); i++ )
+    {
+      const FlightBuffer& fb = flightList.at( i );
 
-      // change Bounding Box
-      scale = qMax( abs( maxx - minx ), abs( maxy - miny ) );
-      scale = qMax( double( scale ), fabs( maxz - minz ) );
-      scale = 1.0 / scale;
+      if( fb.vbo == 0 || fb.vbo->bind() == false )
+        {
+          continue;
+        }
 
-      if( boxObject )
+      if( useShaders )
+        {
+          program->setAttributeBuffer( "a_position", GL_FLOAT, offsetof(GLVertex, x), 3, stride );
+          program->setAttributeBuffer( "a_vario", GL_FLOAT, offsetof(GLVertex, vario), 1, stride );
+          program->setAttributeBuffer( "a_time", GL_FLOAT, offsetof(GLVertex, time), 1, stride );
+          program->setAttributeBuffer( "a_color", GL_UNSIGNED_BYTE, offsetof(GLVertex, color), 4, stride );
+        }
+      else
         {
-          glDeleteLists( boxObject, 1 );
+          glVertexPointer( 3, GL_FLOAT, stride, (const GLvoid *) offsetof(GLVertex, x) );
+
+          if( ! shadow )
+            {
+              glColorPointer( 4, GL_UNSIGNED_BYTE, stride, (const GLvoid *) offsetof(GLVertex, color) );
+            }
         }
 
-      boxObject = makeBoxObject();
-      addShadow( flight );
+      glDrawArrays( GL_LINE_STRIP, 0, fb.count );
+      fb.vbo->release();
+    }
+
+  if( useShaders )
+    {
+      program->disableAttributeArray( "a_position" );
+      program->disableAttributeArray( "a_vario" );
+      program->disableAttributeArray( "a_time" );
+      program->disableAttributeArray( "a_color" );
+      program->release();
+    }
+  else
+    {
+      glDisableClientState( GL_COLOR_ARRAY );
+      glDisableClientState( GL_VERTEX_ARRAY );
     }
 }
 
@@ -205,6 +353,8 @@ void GLView::paintGL()
   glClear( GL_COLOR_BUFFER_BIT );
   glLoadIdentity(); // unity matrix
 
+  uploadFlights();
+
   // the following lines are for the transformations
   // You have to read them "bottom up". E.g. the last translation
   // is actually the first that is performed (This is due to the
@@ -225,13 +375,22 @@ void GLView::paintGL()
 
   // now all objects that should be displayed
   // bounding box
-  glCallList( boxObject );
-
-  // flight list (including the shadows of the flights)
-  for( int i = 0; i < flightList.size(); ++i )
+  if( boxObject )
     {
-      glCallList( flightList.at( i ) );
+      glCallList( boxObject );
     }
+
+  glLineWidth( 2.0 );
+
+  // flights
+  drawFlights( false );
+
+  // The shadows are the flights flattened to the lowest height.
+  glPushMatrix();
+  glTranslatef( 0.0, 0.0, minz );
+  glScalef( 1.0, 1.0, 0.0 );
+  drawFlights( true );
+  glPopMatrix();
 }
 
 /*!
@@ -245,6 +404,25 @@ void GLView::initializeGL()
 
   qglClearColor(getBackgroundColor());
   glShadeModel( GL_FLAT );    // shading model
+
+  useShaders = false;
+
+  if( QGLShaderProgram::hasOpenGLShaderPrograms( context() ) )
+    {
+      delete program;
+      program = new QGLShaderProgram( context(), this );
+
+      if( program->addShaderFromSourceCode( QGLShader::Vertex, VertexShaderSource ) &&
+          program->addShaderFromSourceCode( QGLShader::Fragment, FragmentShaderSource ) &&
+          program->link() )
+        {
+          useShaders = true;
+        }
+      else
+        {
+          qWarning() << "GLView: Shader program not usable:" << program->log();
+        }
+    }
 }
 
 
@@ -406,6 +584,67 @@ void GLView::wheelEvent ( QWheelEvent * e )
   zoom( factor );
 }
 
+void GLView::keyPressEvent( QKeyEvent* e )
+{
+  switch( e->key() )
+    {
+      case Qt::Key_C:
+        setColorMode( (colorMode + 1) % 3 );
+        break;
+      case Qt::Key_P:
+        togglePlayback();
+        break;
+      default:
+        QGLWidget::keyPressEvent( e );
+        break;
+    }
+}
+
+void GLView::setColorMode( int mode )
+{
+  colorMode = mode;
+  updateGL();
+}
+
+void GLView::setTimeWindow( float start, float end )
+{
+  timeStart = start;
+  timeEnd   = end;
+  updateGL();
+}
+
+void GLView::togglePlayback()
+{
+  if( playbackTimer->isActive() )
+    {
+      playbackTimer->stop();
+      setTimeWindow( 0.0, 0.0 );
+      return;
+    }
+
+  if( useShaders == false || flightList.isEmpty() )
+    {
+      // The time window is only supported by the shader program.
+      return;
+    }
+
+  setTimeWindow( firstTime, firstTime + PLAYBACK_STEP );
+  playbackTimer->start();
+}
+
+void GLView::slotPlaybackStep()
+{
+  if( timeEnd >= lastTime )
+    {
+      // Playback is finished, show the whole flights.
+      playbackTimer->stop();
+      setTimeWindow( 0.0, 0.0 );
+      return;
+    }
+
+  setTimeWindow( firstTime, timeEnd + PLAYBACK_STEP );
+}
+
 QColor GLView::getBackgroundColor()
 {
   return QColor( 64, 102, 128 );
@@ -20,28 +20,56 @@
 #define GL_VIEW_H
 
 #include <QGLWidget>
+#include <QGLBuffer>
+#include <QGLShaderProgram>
 
 #include <QColor>
 #include <QList>
 #include <QPoint>
+#include <QTimer>
+#include <QVector>
 #include <QWidget>
 
+#include <QKeyEvent>
 #include <QMouseEvent>
 #include <QWheelEvent>
 
 class Flight;
 
+/**
+ * \class GLView
+ *
+ * \author Christof Bodner, Axel Pauli, agent
+ *
+ * \brief OpenGL view of flights.
+ *
+ * Every flight is uploaded once as vertex buffer object. Besides the
+ * position each vertex carries the vario, the time of day and the color of
+ * the map drawing pen. The coloring and the time window used for the
+ * playback are done by a shader program. If shader programs are not
+ * supported, the vertex buffers are drawn by the fixed function pipeline.
+ *
+ * \date 2003-2026
+ *
+ * \version 1.1
+ */
 class GLView : public QGLWidget
 {
   Q_OBJECT
 
 public:
 
+  /** Coloring modes of the flights. */
+  enum ColorMode { DrawPenColor = 0, AltitudeColor = 1, VarioColor = 2 };
+
   GLView( QWidget* parent );
   virtual ~GLView();
 
+  /**
+   * Adds a flight to the view. The flight data are copied, the upload to
+   * the graphic card is done at the next paint event.
+   */
   virtual void addFlight(Flight* flight);
-  virtual void addShadow(Flight* flight);
 
 public slots:
 
@@ -50,8 +78,26 @@ public slots:
   void setZRotation( int degrees );
   void zoom( float scalefactor );
 
+  /** Sets the coloring mode of the flights. */
+  void setColorMode( int mode );
+
+  /**
+   * Only flight parts inside the passed time window, given in seconds of
+   * the day, are drawn. If end is not greater than start, all is drawn.
+   */
+  void setTimeWindow( float start, float end );
+
+  /** Starts or stops the playback of the flights. */
+  void togglePlayback();
+
+private slots:
+
+  /** Called by the playback timer to extend the time window. */
+  void slotPlaybackStep();
+
 protected:
 
+  void keyPressEvent ( QKeyEvent * e );
   void mouseMoveEvent ( QMouseEvent * e );
   void mousePressEvent ( QMouseEvent * e );
   void wheelEvent ( QWheelEvent * e );
@@ -64,9 +110,37 @@ protected:
 
 private:
 
+  /** Vertex layout of the flight buffers. */
+  struct GLVertex
+  {
+    GLfloat x, y, z;
+    GLfloat vario;
+    GLfloat time;
+    GLubyte color[4];
+  };
+
+  /** Vertex data and buffer object of one flight. */
+  struct FlightBuffer
+  {
+    QVector<GLVertex> vertices;
+    QGLBuffer*        vbo;
+    int               count;
+  };
+
+  /** Uploads all not yet uploaded flights into vertex buffer objects. */
+  void uploadFlights();
+
+  /** Draws all flights or their shadows. */
+  void drawFlights( bool shadow );
+
   QColor getBackgroundColor();
   GLuint boxObject;
-  QList<GLuint> flightList;
+  QList<FlightBuffer> flightList;
+  QGLShaderProgram* program;
+  bool useShaders;
+  int colorMode;
+  float timeStart, timeEnd, firstTime, lastTime;
+  QTimer* playbackTimer;
   GLfloat xRot, yRot, zRot, deltaX, deltaY, deltaZ, scale, heightExaggerate;
   QPoint  mouse_last;
   long minx, maxx, miny, maxy, minz, maxz;
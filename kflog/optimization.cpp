@@ -28,6 +28,7 @@
 #include <QApplication>
 #include <QMessageBox>
 
+#include "geovectors.h"
 #include "optimization.h"
 #include "mainwindow.h"
 
@@ -147,7 +148,7 @@ void Optimization::run()
   double c;                // temp variables
   unsigned int index;
   double wLeg;
-  FlightPoint **rp;
+  double *row;             // distances of the current point
 
   n = route.count() + 1;
 
@@ -156,61 +157,67 @@ void Optimization::run()
   if( progress )
     {
       progress->setMinimumWidth( progress->sizeHint().width() + 45 );
-      progress->setRange( 0, 7 * n );
+      progress->setRange( 0, n );
       progress->setValue( 0 );
     }
 
   // allocate memory
   L = (double *) malloc( (n + 1) * (LEGS + 1) * sizeof(double) );
   w = (unsigned int *) malloc( (n + 1) * (LEGS + 1) * sizeof(unsigned int) );
-  rp = (FlightPoint **) malloc( route.count() * sizeof(FlightPoint *) );
+  row = (double *) malloc( (n + 1) * sizeof(double) );
 
   Q_CHECK_PTR(L);
   Q_CHECK_PTR(w);
-  Q_CHECK_PTR(rp);
+  Q_CHECK_PTR(row);
 
   for( int i = 0; i <= n - 1; i++ )
     {
       L[i + 0 * n] = 0;
     }
 
-  for( int i = 0; i < route.count(); i++ )
-    {
-      rp[i] = route.at( i );
-    }
+  // The distances are computed with unit vectors of the points. The
+  // distances of a point to all its predecessors are the same for all legs
+  // and are calculated only once.
+  GeoVectors vectors( route );
 
-  for( int k = 1; k <= LEGS; k++ )
+  for( int i = 0; i < n - 1; i++ )
     {
-      ii = (k - 1) * n;
-      wLeg = weight( k );
+      qApp->processEvents();
 
-      for( int i = 0; i < n - 1; i++ )
+      if( stopit )
         {
-          qApp->processEvents();
+          free( L );
+          free( w );
+          free( row );
 
-          if( stopit )
+          if( progress )
             {
-              free( L );
-              free( w );
-              free( rp );
               progress->setValue( 0 );
-              optimized = false;
-              return;
             }
 
-          index = i + k * n;
+          optimized = false;
+          return;
+        }
 
-          if( progress )
-            {
-              progress->setValue( index );
-            }
+      if( progress )
+        {
+          progress->setValue( i );
+        }
+
+      vectors.distances( i, 0, i, row );
+
+      for( int k = 1; k <= LEGS; k++ )
+        {
+          ii = (k - 1) * n;
+          wLeg = weight( k );
+          index = i + k * n;
 
           L[index] = 0;
           c = 0;
 
           for( int j = 0; j < i; j++ )
             {
-              c = L[j + ii] + wLeg * dist( rp[j], rp[i] );
+              c = L[j + ii] + wLeg * row[j];
 
               if( c > L[index] )
                 {
@@ -253,7 +260,7 @@ void Optimization::run()
   // free memory
   free( L );
   free( w );
-  free( rp );
+  free( row );
 
   if( progress )
     {
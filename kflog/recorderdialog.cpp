@@ -43,7 +43,9 @@ extern QSettings    _settings;
 
 RecorderDialog::RecorderDialog( QWidget *parent ) :
   QDialog(parent),
+  downloadThread(0),
   libHandle(0),
+  breakTransfer(0),
   activeRecorder(0)
 {
   setObjectName( "RecorderDialog" );
@@ -144,9 +146,11 @@ RecorderDialog::~RecorderDialog()
 {
   _settings.setValue( "/RecorderDialog/Name", selectType->currentText() );
   _settings.setValue( "/RecorderDialog/Port", selectPort->currentIndex() );
+  _settings.setValue( "/RecorderDialog/PortName", selectPort->currentText() );
   _settings.setValue( "/RecorderDialog/Baud", selectSpeed->currentIndex() );
   _settings.setValue( "/RecorderDialog/URL", selectURL->text() );
   _settings.setValue( "/RecorderDialog/Geometry", saveGeometry() );
+  _settings.setValue( "/RecorderDialog/OpenDownloads", openDownloads->isChecked() );
 
   slotCloseRecorder();
 
@@ -361,6 +365,15 @@ void RecorderDialog::__createRecorderPage()
   libNameList.clear();
 
   selectPort->setCurrentIndex( _settings.value("/RecorderDialog/Port", 0).toInt() );
+
+  // The port can be entered by the user, e.g. the pseudo terminal of a
+  // recorder emulator.
+  QString port( _settings.value("/RecorderDialog/PortName", "").toString() );
+
+  if( ! port.isEmpty() && selectPort->findText( port ) < 0 )
+    {
+      selectPort->setEditText( port );
+    }
   selectSpeed->setCurrentIndex( _settings.value("/RecorderDialog/Baud", 0).toInt() );
 
   QString name( _settings.value("/RecorderDialog/Name", "").toString() );
@@ -545,7 +558,7 @@ void RecorderDialog::__createFlightPage()
   flightList->setFocusPolicy( Qt::StrongFocus );
   flightList->setRootIsDecorated( false );
   flightList->setItemsExpandable( true );
-  flightList->setSelectionMode( QAbstractItemView::NoSelection );
+  flightList->setSelectionMode( QAbstractItemView::ExtendedSelection );
   flightList->setAlternatingRowColors( true );
   flightList->addRowSpacing( 5 );
   flightList->setColumnCount( 8 );
@@ -583,11 +596,22 @@ void RecorderDialog::__createFlightPage()
 
   flightList->loadConfig();
 
-  QPushButton* loadB = new QPushButton( tr( "Load list" ) );
-  connect( loadB, SIGNAL(clicked()), SLOT(slotReadFlightList()) );
+  cmdLoadFlightList = new QPushButton( tr( "Load list" ) );
+  connect( cmdLoadFlightList, SIGNAL(clicked()), SLOT(slotReadFlightList()) );
 
-  QPushButton* saveB = new QPushButton( tr( "Save flight" ) );
-  connect( saveB, SIGNAL(clicked()), SLOT(slotDownloadFlight()) );
+  cmdSaveFlight = new QPushButton( tr( "Save flight" ) );
+  cmdSaveFlight->setToolTip( tr("Downloads the selected flights.") );
+  connect( cmdSaveFlight, SIGNAL(clicked()), SLOT(slotDownloadFlight()) );
+
+  cmdSaveNewFlights = new QPushButton( tr( "Save new flights" ) );
+  cmdSaveNewFlights->setToolTip(
+                  tr("Downloads all flights, which are not yet stored\n"
+                     "in the default flight directory.") );
+  connect( cmdSaveNewFlights, SIGNAL(clicked()), SLOT(slotDownloadNewFlights()) );
+
+  cmdCancelDownload = new QPushButton( tr( "Cancel" ) );
+  cmdCancelDownload->setEnabled( false );
+  connect( cmdCancelDownload, SIGNAL(clicked()), SLOT(slotCancelDownload()) );
 
   useLongNames = new QCheckBox( tr( "Long filenames" ) );
 
@@ -603,6 +627,10 @@ void RecorderDialog::__createFlightPage()
                      "<b>Note!</b> Do not use fast download<BR>"
                      " when using the file for competitions.</html>"));
 
+  openDownloads = new QCheckBox( tr( "Open downloaded flights" ) );
+  openDownloads->setChecked( _settings.value( "/RecorderDialog/OpenDownloads", false ).toBool() );
+  openDownloads->setToolTip( tr("If checked, the downloaded flights are opened in KFLog.") );
+
   QVBoxLayout *flightPageLayout = new QVBoxLayout;
   flightPageLayout->setSpacing(10);
   flightPageLayout->setContentsMargins( 0, 0, 0, 0 );
@@ -610,15 +638,22 @@ void RecorderDialog::__createFlightPage()
 
   QHBoxLayout *buttonBox = new QHBoxLayout;
   buttonBox->setSpacing( 10 );
-  buttonBox->addWidget(loadB);
+  buttonBox->addWidget(cmdLoadFlightList);
   buttonBox->addStretch( 10 );
-  buttonBox->addWidget( saveB );
+  buttonBox->addWidget( cmdSaveFlight );
+  buttonBox->addWidget( cmdSaveNewFlights );
+  buttonBox->addWidget( cmdCancelDownload );
   buttonBox->addStretch( 10 );
   buttonBox->addWidget(useLongNames);
   buttonBox->addStretch( 10 );
   buttonBox->addWidget(useFastDownload);
 
+  QHBoxLayout *optionBox = new QHBoxLayout;
+  optionBox->addStretch( 10 );
+  optionBox->addWidget( openDownloads );
+
   flightPageLayout->addLayout( buttonBox );
+  flightPageLayout->addLayout( optionBox );
   flightPage->setLayout( flightPageLayout );
 }
 
@@ -976,7 +1011,12 @@ void RecorderDialog::slotConnectRecorder()
       return;
     }
 
-  portName = "/dev/" + selectPort->currentText();
+  portName = selectPort->currentText();
+
+  if( ! portName.startsWith( "/" ) )
+    {
+      portName = "/dev/" + portName;
+    }
 
   QString name= libNameList[selectType->currentText()];
 
@@ -1065,6 +1105,16 @@ void RecorderDialog::slotConnectRecorder()
 
 void RecorderDialog::slotCloseRecorder()
 {
+  if( downloadThread )
+    {
+      // The recorder must not be closed under the running download.
+      disconnect( downloadThread, 0, this, 0 );
+      downloadThread->cancel();
+      downloadThread->wait();
+      delete downloadThread;
+      downloadThread = 0;
+    }
+
   if( activeRecorder )
     {
       QApplication::setOverrideCursor( QCursor(Qt::WaitCursor) );
@@ -1260,25 +1310,108 @@ void RecorderDialog::slotReadFlightList()
 
 void RecorderDialog::slotDownloadFlight()
 {
-  QTreeWidgetItem *item = flightList->currentItem();
+  if( !activeRecorder || downloadThread )
+    {
+      return;
+    }
+
+  QList<QTreeWidgetItem *> items = flightList->selectedItems();
+
+  if( items.isEmpty() && flightList->currentItem() != 0 )
+    {
+      items.append( flightList->currentItem() );
+    }
+
+  if( items.isEmpty() )
+    {
+      return;
+    }
+
+  QList<FlightDownloadThread::Job> jobs;
+
+  if( items.size() == 1 )
+    {
+      // A single flight can be saved under an user defined name.
+      int flightID( items.at(0)->text( colNo ).toInt() - 1 );
+
+      QString filter;
+      filter.append(tr("IGC") + " (*.igc)");
+
+      QString fileName =
+          QFileDialog::getSaveFileName( this,
+                                        tr( "Select IGC file to save to" ),
+                                        __flightFileName( flightID ),
+                                        filter );
+      if( fileName.isEmpty() )
+        {
+          return;
+        }
+
+      jobs.append( FlightDownloadThread::Job( flightID, fileName ) );
+    }
+  else
+    {
+      for( int i = 0; i < items.size(); i++ )
+        {
+          int flightID( items.at(i)->text( colNo ).toInt() - 1 );
+
+          jobs.append( FlightDownloadThread::Job( flightID,
+                                                  __flightFileName( flightID ) ) );
+        }
+    }
+
+  __startDownload( jobs );
+}
+
+void RecorderDialog::slotDownloadNewFlights()
+{
+  if( !activeRecorder || downloadThread )
+    {
+      return;
+    }
+
+  QList<FlightDownloadThread::Job> jobs;
 
-  if( item == 0 || !activeRecorder )
+  for( int i = 0; i < dirList.size(); i++ )
+    {
+      QString fileName = __flightFileName( i );
+
+      if( ! QFile::exists( fileName ) )
+        {
+          jobs.append( FlightDownloadThread::Job( i, fileName ) );
+        }
+    }
+
+  if( jobs.isEmpty() )
     {
+      QMessageBox::information( this,
+                                tr("Flight download"),
+                                tr("All flights of the recorder are already stored in the flight directory."),
+                                QMessageBox::Ok );
       return;
     }
 
+  __startDownload( jobs );
+}
+
+void RecorderDialog::slotCancelDownload()
+{
+  if( downloadThread )
+    {
+      statusBar->setText( tr("Canceling flight download") );
+      cmdCancelDownload->setEnabled( false );
+      downloadThread->cancel();
+    }
+}
+
+QString RecorderDialog::__flightFileName( const int flightID )
+{
   // If no DefaultFlightDirectory is configured, we must use $HOME instead of the root-directory
   QString flightDir = _settings.value( "/Path/DefaultFlightDirectory",
                                        _mainWindow->getApplicationDataDirectory() ).toString();
 
   QString fileName = flightDir + "/";
 
-  int flightID( item->text( colNo ).toInt() - 1 );
-
-  qDebug() << "PathName:" << fileName;
-  qDebug() << "LongFileName: " << dirList.at(flightID)->longFileName;
-  qDebug() << "ShortFileName:" << dirList.at(flightID)->shortFileName;
-
   if( useLongNames->isChecked() )
     {
       fileName += dirList.at( flightID )->longFileName.toUpper();
@@ -1288,57 +1421,160 @@ void RecorderDialog::slotDownloadFlight()
       fileName += dirList.at( flightID )->shortFileName.toUpper();
     }
 
-  QString filter;
-  filter.append(tr("IGC") + " (*.igc)");
+  return fileName;
+}
+
+void RecorderDialog::__startDownload( const QList<FlightDownloadThread::Job>& jobs )
+{
+  downloadedFlights.clear();
+
+  // A failed download is repeated two times.
+  downloadThread = new FlightDownloadThread( activeRecorder,
+                                             jobs,
+                                             !useFastDownload->isChecked(),
+                                             2,
+                                             breakTransfer,
+                                             this );
+
+  connect( downloadThread, SIGNAL(downloadStarted(int, int, const QString&)),
+           this, SLOT(slotDownloadStarted(int, int, const QString&)) );
+  connect( downloadThread, SIGNAL(downloadRetry(int, int, const QString&)),
+           this, SLOT(slotDownloadRetry(int, int, const QString&)) );
+  connect( downloadThread, SIGNAL(downloadFinished(int, bool, const QString&, const QString&)),
+           this, SLOT(slotDownloadFinished(int, bool, const QString&, const QString&)) );
+  connect( downloadThread, SIGNAL(queueFinished(int, int, bool)),
+           this, SLOT(slotDownloadQueueFinished(int, int, bool)) );
+
+  __setDownloadActive( true );
+
+  statusBar->setText( tr("Downloading flight from recorder") );
+
+  // The port is used by the download thread only, timers of the plugin
+  // running in the GUI thread must not access it in the meantime.
+  activeRecorder->setKeepAlive( false );
+  downloadThread->start();
+}
 
-  fileName = QFileDialog::getSaveFileName( this,
-                                           tr( "Select IGC file to save to" ),
-                                           fileName,
-                                           filter );
-  if( fileName.isEmpty() )
+void RecorderDialog::__setDownloadActive( const bool active )
+{
+  if( active )
     {
-      return;
+      slotDisablePages();
+
+      // Only the cancel button of the flight page remains usable.
+      flightPage->setEnabled( true );
+      flightList->setEnabled( false );
+      cmdLoadFlightList->setEnabled( false );
+      cmdSaveFlight->setEnabled( false );
+      cmdSaveNewFlights->setEnabled( false );
+      useLongNames->setEnabled( false );
+      useFastDownload->setEnabled( false );
+      openDownloads->setEnabled( false );
+    }
+  else
+    {
+      flightList->setEnabled( true );
+      cmdLoadFlightList->setEnabled( true );
+      cmdSaveFlight->setEnabled( true );
+      cmdSaveNewFlights->setEnabled( true );
+      useLongNames->setEnabled( true );
+      openDownloads->setEnabled( true );
+
+      slotEnablePages();
     }
 
-  slotDisablePages();
+  setupTree->setEnabled( ! active );
+  recorderPage->setEnabled( ! active );
+  cmdCancelDownload->setEnabled( active );
+}
 
-  QApplication::setOverrideCursor( QCursor(Qt::WaitCursor) );
-  statusBar->setText( tr("Downloading flight from recorder") );
-  QCoreApplication::processEvents();
-  QCoreApplication::flush();
+void RecorderDialog::slotDownloadStarted( int job, int jobs,
+                                          const QString& /* fileName */ )
+{
+  statusBar->setText( tr("Downloading flight %1 of %2 from recorder")
+                      .arg( job + 1 ).arg( jobs ) );
+}
 
-  int ret = activeRecorder->downloadFlight( flightID,
-                                            !useFastDownload->isChecked(),
-                                            fileName );
+void RecorderDialog::slotDownloadRetry( int job, int retry, const QString& error )
+{
+  qWarning() << "RecorderDialog: download of job" << job << "failed:" << error
+             << "Retry" << retry;
 
-  QApplication::restoreOverrideCursor();
+  statusBar->setText( tr("Download failed, retry %1").arg( retry ) );
+}
 
-  if( ret < FR_OK )
+void RecorderDialog::slotDownloadFinished( int job, bool ok,
+                                           const QString& fileName,
+                                           const QString& error )
+{
+  Q_UNUSED( job )
+
+  if( ok )
     {
-      QString errorDetails = activeRecorder->lastError();
+      downloadedFlights.append( QUrl::fromLocalFile( fileName ) );
+    }
+  else
+    {
+      downloadErrors.append( QFileInfo( fileName ).fileName() + ": " + error );
+    }
+}
 
-      QString errorText = tr( "Cannot download flight from recorder." );
+void RecorderDialog::slotDownloadQueueFinished( int downloaded, int failed, bool canceled )
+{
+  downloadThread->wait();
+  downloadThread->deleteLater();
+  downloadThread = 0;
 
-      if( ! errorDetails.isEmpty() )
-        {
-          errorText += "\n" + errorDetails;
-        }
+  if( activeRecorder )
+    {
+      activeRecorder->setKeepAlive( true );
+    }
+
+  if( breakTransfer != 0 )
+    {
+      *breakTransfer = 0;
+    }
+
+  statusBar->setText("");
+  __setDownloadActive( false );
+
+  if( failed > 0 )
+    {
+      QString errorText = tr( "%1 of %2 flights could not be downloaded from the recorder." )
+                          .arg( failed ).arg( downloaded + failed );
+
+      errorText += "\n\n" + downloadErrors.join( "\n" );
 
       QMessageBox::critical( this,
                              tr( "Library Error" ),
                              errorText,
                              QMessageBox::Ok );
     }
+  else if( canceled )
+    {
+      QMessageBox::information( this,
+                                tr("Flight download canceled"),
+                                tr("%1 flights downloaded from the recorder.").arg( downloaded ),
+                                QMessageBox::Ok );
+    }
   else
     {
       QMessageBox::information( this,
                                 tr("Flight download finished"),
-                                tr("Flight successfully downloaded from the recorder."),
+                                downloaded == 1 ?
+                                tr("Flight successfully downloaded from the recorder.") :
+                                tr("%1 flights successfully downloaded from the recorder.").arg( downloaded ),
                                 QMessageBox::Ok );
     }
 
-  statusBar->setText("");
-  slotEnablePages();
+  downloadErrors.clear();
+
+  if( openDownloads->isChecked() && ! downloadedFlights.isEmpty() )
+    {
+      emit openFlights( downloadedFlights );
+    }
+
+  downloadedFlights.clear();
 }
 
 void RecorderDialog::slotWriteDeclaration()
@@ -1631,6 +1867,9 @@ bool RecorderDialog::__openLib( const QString& libN )
 
   activeRecorder->setParent(this);
 
+  // The abort flag is optional, it allows to cancel a running transfer.
+  breakTransfer = (int *) dlsym( libHandle, "breakTransfer" );
+
   apiID->setText(activeRecorder->getLibName());
 
   libName = libN;
@@ -2469,6 +2708,7 @@ void RecorderDialog::slotRecorderTypeChanged(const QString& newRecorderName )
       // closing old library handle
       dlclose( libHandle );
       libHandle = 0;
+      breakTransfer = 0;
   }
 
   if( ! __openLib( newLibName ) )
@@ -25,6 +25,7 @@
     #include <QtGui>
 #endif
 
+#include "flightdownloadthread.h"
 #include "flightrecorderpluginbase.h"
 #include "flighttask.h"
 #include "frstructs.h"
@@ -78,9 +79,18 @@ class RecorderDialog : public QDialog
    */
   void slotReadFlightList();
   /**
-   * Downloads the currently selected flight from the recorder. You need to call slotReadFlightList before calling this slot.
+   * Downloads the currently selected flights from the recorder. You need to call slotReadFlightList before calling this slot.
    */
   void slotDownloadFlight();
+  /**
+   * Downloads all flights from the recorder, which are not yet stored in the
+   * flight directory.
+   */
+  void slotDownloadNewFlights();
+  /**
+   * Stops the running flight download.
+   */
+  void slotCancelDownload();
   /**
    * Sends a declaration to the recorder
    */
@@ -134,12 +144,28 @@ class RecorderDialog : public QDialog
   /** No descriptions */
   void slotRecorderTypeChanged(const QString &name);
 
+  /** Called by the download thread, when a flight download is started. */
+  void slotDownloadStarted( int job, int jobs, const QString& fileName );
+
+  /** Called by the download thread, when a flight download is repeated. */
+  void slotDownloadRetry( int job, int retry, const QString& error );
+
+  /** Called by the download thread, when a flight download is finished. */
+  void slotDownloadFinished( int job, bool ok, const QString& fileName,
+                             const QString& error );
+
+  /** Called by the download thread, when all flights are downloaded. */
+  void slotDownloadQueueFinished( int downloaded, int failed, bool canceled );
+
  signals:
 
   void addCatalog(WaypointCatalog *w);
 
   void addTask(FlightTask *t);
 
+  /** Emitted with the downloaded flights, which shall be opened. */
+  void openFlights(const QList<QUrl>& urls);
+
  public:
 
   /**
@@ -157,6 +183,22 @@ class RecorderDialog : public QDialog
   /** */
   int __fillDirList();
 
+  /**
+   * \return The automatic file name of a flight in the flight directory.
+   */
+  QString __flightFileName( const int flightID );
+
+  /**
+   * Starts the download thread with the passed flights.
+   */
+  void __startDownload( const QList<FlightDownloadThread::Job>& jobs );
+
+  /**
+   * Enables the widgets used during a running download and disables all
+   * other ones, or vice versa.
+   */
+  void __setDownloadActive( const bool active );
+
   /**
    * Opens the library with the indicated name
    */
@@ -265,9 +307,27 @@ class RecorderDialog : public QDialog
   QCheckBox* useFastDownload;
   /** */
   QCheckBox* useLongNames;
+  /** Opens the downloaded flights after the download */
+  QCheckBox* openDownloads;
+
+  QPushButton* cmdLoadFlightList;
+  QPushButton* cmdSaveFlight;
+  QPushButton* cmdSaveNewFlights;
+  QPushButton* cmdCancelDownload;
+
+  /** The running flight download */
+  FlightDownloadThread* downloadThread;
+
+  /** The flights downloaded by the running download thread */
+  QList<QUrl> downloadedFlights;
+
+  /** The errors of the failed flight downloads */
+  QStringList downloadErrors;
 
   /** Handle to the bound library plugin. */
   void* libHandle;
+  /** Abort flag of the bound library plugin, if it is exported. */
+  int* breakTransfer;
   /** */
   QString libName;
   /** */
@@ -0,0 +1,298 @@
+/***********************************************************************
+**
+**   sectorcrossing.cpp
+**
+**   This file is part of KFLog.
+**
+************************************************************************
+**
+**   Copyright (c):  2026 by agent <agent@local>
+**
+**   This file is distributed under the terms of the General Public
+**   License. See the file COPYING for more information.
+**
+***********************************************************************/
+
+#include <cmath>
+
+#include <QtGlobal>
+
+#include "flightpoint.h"
+#include "mapcalc.h"
+#include "sectorcrossing.h"
+
+/** Radius of the cylinder around the turnpoint in km. */
+#define CYLINDER_RADIUS 0.5
+
+/** Radius of the sector 1 in km. */
+#define SECTOR1_RADIUS 3.0
+
+/**
+ * Limits the parameter range [lo, hi] of a segment to the part, where
+ * a + b * t >= 0 is valid. Returns false, if the range becomes empty.
+ */
+static bool clipLinear( const double a, const double b, double& lo, double& hi )
+{
+  if( fabs( b ) < 1E-12 )
+    {
+      return a >= 0.0;
+    }
+
+  const double root = -a / b;
+
+  if( b > 0.0 )
+    {
+      lo = qMax( lo, root );
+    }
+  else
+    {
+      hi = qMin( hi, root );
+    }
+
+  return lo <= hi;
+}
+
+/**
+ * Limits the parameter range [lo, hi] of the segment p0 + t * d to the part
+ * inside of the circle with the radius r around the origin. Returns false, if
+ * the range becomes empty.
+ */
+static bool clipDisc( const QPointF& p0, const QPointF& d, const double r,
+                      double& lo, double& hi )
+{
+  const double a = d.x() * d.x() + d.y() * d.y();
+  const double b = 2.0 * ( p0.x() * d.x() + p0.y() * d.y() );
+  const double c = p0.x() * p0.x() + p0.y() * p0.y() - r * r;
+
+  if( a < 1E-12 )
+    {
+      return c <= 0.0;
+    }
+
+  const double disc = b * b - 4.0 * a * c;
+
+  if( disc < 0.0 )
+    {
+      return false;
+    }
+
+  const double s = sqrt( disc );
+
+  lo = qMax( lo, (-b - s) / (2.0 * a) );
+  hi = qMin( hi, (-b + s) / (2.0 * a) );
+
+  return lo <= hi;
+}
+
+SectorCrossing::SectorCrossing( const QList<FlightPoint*>& route )
+{
+  const int count = route.size();
+
+  m_lat.resize( count );
+  m_lon.resize( count );
+  m_time.resize( count );
+
+  for( int i = 0; i < count; i++ )
+    {
+      const FlightPoint* fp = route.at(i);
+
+      m_lat[i]  = fp->origP.lat();
+      m_lon[i]  = fp->origP.lon();
+      m_time[i] = fp->time;
+    }
+
+  // The blocks contain the start and the end point of their segments.
+  const int segs = segments();
+
+  for( int first = 0; first < segs; first += BlockSize )
+    {
+      const int last = qMin( first + BlockSize, count - 1 );
+
+      int minLat = m_lat[first];
+      int maxLat = minLat;
+      int minLon = m_lon[first];
+      int maxLon = minLon;
+
+      for( int i = first + 1; i <= last; i++ )
+        {
+          minLat = qMin( minLat, m_lat[i] );
+          maxLat = qMax( maxLat, m_lat[i] );
+          minLon = qMin( minLon, m_lon[i] );
+          maxLon = qMax( maxLon, m_lon[i] );
+        }
+
+      QRect box;
+      box.setCoords( minLat, minLon, maxLat, maxLon );
+      m_blocks.append( box );
+    }
+}
+
+SectorCrossing::~SectorCrossing()
+{
+}
+
+QPointF SectorCrossing::direction( const QPoint& center, const QPoint& other )
+{
+  const int lat = center.x();
+  const int lon = center.y();
+
+  const double kLat = dist( lat, lon, lat + 10000, lon ) / 10000.;
+  const double kLon = dist( lat, lon, lat, lon + 10000 ) / 10000.;
+
+  QPointF v( (center.x() - other.x()) * kLat, (center.y() - other.y()) * kLon );
+
+  const double length = hypot( v.x(), v.y() );
+
+  if( length < 1E-9 )
+    {
+      return QPointF( 1.0, 0.0 );
+    }
+
+  return v / length;
+}
+
+void SectorCrossing::findEntries( const QPoint& center,
+                                  const QPointF& axis,
+                                  const Position& start,
+                                  Entries& result ) const
+{
+  result.sector1    = 0;
+  result.sector2    = 0;
+  result.sectorFAI  = 0;
+  result.sector1Pos = start;
+  result.sector2Pos = start;
+
+  const int segs = segments();
+
+  if( segs == 0 )
+    {
+      return;
+    }
+
+  const int lat0 = center.x();
+  const int lon0 = center.y();
+
+  // Kilometers per coordinate unit in the local plane
+  const double kLat = dist( lat0, lon0, lat0 + 10000, lon0 ) / 10000.;
+  const double kLon = dist( lat0, lon0, lat0, lon0 + 10000 ) / 10000.;
+
+  // Inner normals of the FAI sector borders, which are rotated by 45 degrees
+  // against the axis.
+  const double c = M_SQRT1_2;
+  const QPointF n1( ( axis.x() + axis.y() ) * c, ( axis.y() - axis.x() ) * c );
+  const QPointF n2( ( axis.x() - axis.y() ) * c, ( axis.y() + axis.x() ) * c );
+
+  const int last = m_time.size() - 1;
+
+  for( int b = qMax( 0, start.segment ) / BlockSize; b < m_blocks.size(); b++ )
+    {
+      const QRect& box = m_blocks[b];
+
+      const double xMin = ( box.left() - lat0 ) * kLat;
+      const double xMax = ( box.right() - lat0 ) * kLat;
+      const double yMin = ( box.top() - lon0 ) * kLon;
+      const double yMax = ( box.bottom() - lon0 ) * kLon;
+
+      // Largest distance in axis direction of the box
+      const double front = ( axis.x() > 0.0 ? xMax : xMin ) * axis.x() +
+                           ( axis.y() > 0.0 ? yMax : yMin ) * axis.y();
+
+      // Nearest point of the box to the turnpoint
+      const double nx = qBound( xMin, 0.0, xMax );
+      const double ny = qBound( yMin, 0.0, yMax );
+
+      if( front < 0.0 && nx * nx + ny * ny > CYLINDER_RADIUS * CYLINDER_RADIUS )
+        {
+          // The block lays completely behind the turnpoint.
+          continue;
+        }
+
+      const int end = qMin( (b + 1) * BlockSize, segs );
+
+      for( int i = qMax( b * BlockSize, start.segment ); i < end; i++ )
+        {
+          const int j = qMin( i + 1, last );
+
+          const QPointF p0( ( m_lat[i] - lat0 ) * kLat, ( m_lon[i] - lon0 ) * kLon );
+          const QPointF p1( ( m_lat[j] - lat0 ) * kLat, ( m_lon[j] - lon0 ) * kLon );
+          const QPointF d = p1 - p0;
+
+          const double dt = double( m_time[j] - m_time[i] );
+
+          double from = 0.0;
+
+          if( i == start.segment && dt > 0.0 )
+            {
+              from = qBound( 0.0, ( start.time - m_time[i] ) / dt, 1.0 );
+            }
+
+          // Entry parameters of the sectors, -1 means not entered.
+          double lo, hi;
+          double tCylinder = -1.0, tHalf = -1.0, tFai = -1.0, tSector1 = -1.0;
+
+          lo = from; hi = 1.0;
+
+          if( clipDisc( p0, d, CYLINDER_RADIUS, lo, hi ) )
+            {
+              tCylinder = lo;
+            }
+
+          lo = from; hi = 1.0;
+
+          if( clipLinear( p0.x() * axis.x() + p0.y() * axis.y(),
+                          d.x() * axis.x() + d.y() * axis.y(), lo, hi ) )
+            {
+              tHalf = lo;
+            }
+
+          lo = from; hi = 1.0;
+
+          if( clipLinear( p0.x() * n1.x() + p0.y() * n1.y(),
+                          d.x() * n1.x() + d.y() * n1.y(), lo, hi ) &&
+              clipLinear( p0.x() * n2.x() + p0.y() * n2.y(),
+                          d.x() * n2.x() + d.y() * n2.y(), lo, hi ) )
+            {
+              tFai = lo;
+
+              if( clipDisc( p0, d, SECTOR1_RADIUS, lo, hi ) )
+                {
+                  tSector1 = lo;
+                }
+            }
+
+          if( tCylinder >= 0.0 && ( tSector1 < 0.0 || tCylinder < tSector1 ) )
+            {
+              tSector1 = tCylinder;
+            }
+
+          double tSector2 = tHalf;
+
+          if( tCylinder >= 0.0 && ( tSector2 < 0.0 || tCylinder < tSector2 ) )
+            {
+              tSector2 = tCylinder;
+            }
+
+          if( result.sectorFAI == 0 && tFai >= 0.0 )
+            {
+              result.sectorFAI = m_time[i] + (time_t) rint( tFai * dt );
+            }
+
+          if( result.sector2 == 0 && tSector2 >= 0.0 )
+            {
+              result.sector2 = m_time[i] + (time_t) rint( tSector2 * dt );
+              result.sector2Pos.segment = i;
+              result.sector2Pos.time = result.sector2;
+            }
+
+          if( tSector1 >= 0.0 )
+            {
+              result.sector1 = m_time[i] + (time_t) rint( tSector1 * dt );
+              result.sector1Pos.segment = i;
+              result.sector1Pos.time = result.sector1;
+
+              // The search ends with the entry into sector 1.
+              return;
+            }
+        }
+    }
+}
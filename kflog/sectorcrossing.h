@@ -0,0 +1,147 @@
+/***********************************************************************
+**
+**   sectorcrossing.h
+**
+**   This file is part of KFLog.
+**
+************************************************************************
+**
+**   Copyright (c):  2026 by agent <agent@local>
+**
+**   This file is distributed under the terms of the General Public
+**   License. See the file COPYING for more information.
+**
+***********************************************************************/
+
+/**
+ * \class SectorCrossing
+ *
+ * \author agent
+ *
+ * \brief Finds the entries of a flight track into the sectors of a turnpoint.
+ *
+ * The track is handled as a sequence of straight segments between the
+ * flight points. Every segment is tested analytically against the sector
+ * geometry, so that an entry between two logged points is not lost. The
+ * entry time is interpolated along the segment.
+ *
+ * The geometry is computed in a local plane around the turnpoint with
+ * kilometers as unit. The segments are grouped into blocks with a bounding
+ * box in WGS84 coordinates. A block is skipped, if its box is located
+ * completely outside of all sectors.
+ *
+ * \date 2026
+ *
+ * \version 1.0
+ */
+
+#ifndef SECTOR_CROSSING_H
+#define SECTOR_CROSSING_H
+
+#include <ctime>
+
+#include <QList>
+#include <QPoint>
+#include <QPointF>
+#include <QRect>
+#include <QVector>
+
+class FlightPoint;
+
+class SectorCrossing
+{
+ public:
+
+  /**
+   * Position on the track, from which a search is started.
+   */
+  struct Position
+  {
+    /** Index of the segment */
+    int segment;
+
+    /** Entries before this time are ignored. */
+    time_t time;
+  };
+
+  /**
+   * Result of \ref findEntries. A time of zero means, that the sector was
+   * not reached.
+   */
+  struct Entries
+  {
+    /** Entry into the 0.5km cylinder or the 3km FAI sector */
+    time_t sector1;
+
+    /** Entry into the 0.5km cylinder or the 90 degree sector */
+    time_t sector2;
+
+    /** Entry into the unlimited FAI sector */
+    time_t sectorFAI;
+
+    /** Position of the sector 1 entry */
+    Position sector1Pos;
+
+    /** Position of the first sector 2 entry */
+    Position sector2Pos;
+  };
+
+  SectorCrossing( const QList<FlightPoint*>& route );
+
+  virtual ~SectorCrossing();
+
+  /**
+   * \return The number of segments of the track.
+   */
+  int segments() const
+  {
+    return m_time.size() > 1 ? m_time.size() - 1 : m_time.size();
+  };
+
+  /**
+   * \return The time of the passed flight point.
+   */
+  time_t time( const int index ) const
+  {
+    return m_time[index];
+  };
+
+  /**
+   * Returns the direction from the other point to the center point as unit
+   * vector in the local plane of the center point.
+   */
+  static QPointF direction( const QPoint& center, const QPoint& other );
+
+  /**
+   * Searches the first entries into the sectors of a turnpoint. The search
+   * ends with the entry into sector 1.
+   *
+   * \param center The turnpoint in WGS84 coordinates.
+   *
+   * \param axis Unit vector in the local plane of the turnpoint, which
+   *        points to the middle of the sectors.
+   *
+   * \param start Position on the track, where the search starts.
+   *
+   * \param result The found entries.
+   */
+  void findEntries( const QPoint& center,
+                    const QPointF& axis,
+                    const Position& start,
+                    Entries& result ) const;
+
+ private:
+
+  /** Number of segments in a block of the bounding box index. */
+  enum { BlockSize = 32 };
+
+  /** Coordinates and times of the flight points. */
+  QVector<int>    m_lat;
+  QVector<int>    m_lon;
+  QVector<time_t> m_time;
+
+  /** Bounding boxes of the segment blocks in WGS84 coordinates. */
+  QVector<QRect> m_blocks;
+};
+
+#endif
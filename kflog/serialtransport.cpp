@@ -0,0 +1,478 @@
+/***********************************************************************
+**
+**   serialtransport.cpp
+**
+**   This file is part of KFLog.
+**
+************************************************************************
+**
+**   Copyright (c):  2026 by agent <agent@local>
+**
+**   This file is distributed under the terms of the General Public
+**   License. See the file COPYING for more information.
+**
+***********************************************************************/
+
+#ifndef _WIN32
+
+#include <cerrno>
+#include <csignal>
+#include <cstring>
+
+#include <fcntl.h>
+#include <poll.h>
+#include <unistd.h>
+
+#include <QtCore>
+
+#include "serialtransport.h"
+
+// Maximum wait time in milliseconds for a stopped output queue.
+#define WRITE_TIMEOUT 5000
+
+SerialTransport* SerialTransport::m_openPort = 0;
+
+bool SerialTransport::m_reportStatistics = false;
+
+SerialTransport::SerialTransport() :
+  m_fd(-1),
+  m_speed(B0),
+  m_head(0),
+  m_count(0),
+  m_bytesRead(0),
+  m_bytesWritten(0),
+  m_readTimeouts(0)
+{
+  memset( &m_oldTermEnv, 0, sizeof(m_oldTermEnv) );
+  memset( &m_termEnv, 0, sizeof(m_termEnv) );
+}
+
+SerialTransport::~SerialTransport()
+{
+  close();
+}
+
+void SerialTransport::releaseTTY( int signal )
+{
+  if( m_openPort != 0 )
+    {
+      tcsetattr( m_openPort->m_fd, TCSANOW, &m_openPort->m_oldTermEnv );
+    }
+
+  // Terminate the program with the default action of the signal.
+  ::signal( signal, SIG_DFL );
+  raise( signal );
+}
+
+bool SerialTransport::open( const QString& device, const speed_t speed,
+                            const bool hwFlowControl )
+{
+  close();
+
+  m_fd = ::open( device.toLocal8Bit().constData(),
+                 O_RDWR | O_NOCTTY | O_NONBLOCK );
+
+  if( m_fd == -1 )
+    {
+      qWarning() << "SerialTransport: Cannot open" << device
+                 << strerror( errno );
+      return false;
+    }
+
+  if( tcgetattr( m_fd, &m_oldTermEnv ) == -1 )
+    {
+      qWarning() << "SerialTransport:" << device << "is not a terminal";
+      ::close( m_fd );
+      m_fd = -1;
+      return false;
+    }
+
+  //
+  // Before we change any port-settings, we must establish a
+  // signal-handler, which is used to restore the port-settings
+  // after terminating the program.
+  // Because a SIGKILL-signal removes the program immediately,
+  // the status of the port will be undefined.
+  //
+  m_openPort = this;
+  m_device   = device;
+
+  struct sigaction sact;
+  memset( &sact, 0, sizeof(sact) );
+  sigemptyset( &sact.sa_mask );
+  sact.sa_handler = releaseTTY;
+  sigaction( SIGHUP, &sact, NULL );
+  sigaction( SIGINT, &sact, NULL );
+  sigaction( SIGPIPE, &sact, NULL );
+  sigaction( SIGTERM, &sact, NULL );
+
+  m_termEnv = m_oldTermEnv;
+
+  // raw mode, 8 data bits, no parity, one stop bit
+  m_termEnv.c_iflag &= ~(IGNBRK | BRKINT | PARMRK | ISTRIP | INLCR | IGNCR |
+                         ICRNL | IXON | IXOFF | IXANY);
+  m_termEnv.c_iflag |= IGNPAR;
+  m_termEnv.c_oflag &= ~OPOST;
+  m_termEnv.c_lflag &= ~(ECHO | ECHONL | ICANON | ISIG | IEXTEN);
+  m_termEnv.c_cflag &= ~(CSIZE | PARENB | CSTOPB | CRTSCTS);
+  m_termEnv.c_cflag |= (CS8 | CLOCAL | CREAD);
+
+  if( hwFlowControl )
+    {
+      m_termEnv.c_cflag |= CRTSCTS;
+    }
+
+  // The waiting is done by poll, a read returns always immediately.
+  m_termEnv.c_cc[VMIN]  = 0;
+  m_termEnv.c_cc[VTIME] = 0;
+
+  m_speed = speed;
+  cfsetospeed( &m_termEnv, speed );
+  cfsetispeed( &m_termEnv, speed );
+
+  flush();
+
+  if( ! apply() )
+    {
+      close();
+      return false;
+    }
+
+  m_bytesRead    = 0;
+  m_bytesWritten = 0;
+  m_readTimeouts = 0;
+  m_openTime.start();
+
+  return true;
+}
+
+void SerialTransport::close()
+{
+  if( m_fd == -1 )
+    {
+      return;
+    }
+
+  if( m_reportStatistics && m_openTime.isValid() )
+    {
+      qint64 ms = qMax( m_openTime.elapsed(), qint64( 1 ) );
+
+      qDebug() << "SerialTransport:" << m_device
+               << "read" << m_bytesRead << "bytes, wrote" << m_bytesWritten
+               << "bytes in" << ms << "ms," << (m_bytesRead * 1000 / ms)
+               << "bytes/s received," << m_readTimeouts << "read timeouts";
+    }
+
+  m_openTime.invalidate();
+
+  tcsetattr( m_fd, TCSANOW, &m_oldTermEnv );
+  ::close( m_fd );
+
+  m_fd    = -1;
+  m_head  = 0;
+  m_count = 0;
+
+  if( m_openPort == this )
+    {
+      m_openPort = 0;
+    }
+}
+
+bool SerialTransport::apply()
+{
+  if( tcsetattr( m_fd, TCSANOW, &m_termEnv ) == -1 )
+    {
+      qWarning() << "SerialTransport: Cannot set port settings"
+                 << strerror( errno );
+      return false;
+    }
+
+  return true;
+}
+
+bool SerialTransport::setSpeed( const speed_t speed )
+{
+  if( m_fd == -1 )
+    {
+      return false;
+    }
+
+  m_speed = speed;
+  cfsetospeed( &m_termEnv, speed );
+  cfsetispeed( &m_termEnv, speed );
+
+  return apply();
+}
+
+bool SerialTransport::setFlowControl( const bool enable )
+{
+  if( m_fd == -1 )
+    {
+      return false;
+    }
+
+  if( enable )
+    {
+      m_termEnv.c_cflag |= CRTSCTS;
+    }
+  else
+    {
+      m_termEnv.c_cflag &= ~CRTSCTS;
+    }
+
+  return apply();
+}
+
+bool SerialTransport::fill( const int timeout )
+{
+  if( m_fd == -1 )
+    {
+      return false;
+    }
+
+  if( m_count == BufferSize )
+    {
+      // The buffer is full, the caller must consume the data first.
+      return true;
+    }
+
+  QElapsedTimer timer;
+  timer.start();
+
+  while( true )
+    {
+      struct pollfd pfd;
+      pfd.fd      = m_fd;
+      pfd.events  = POLLIN;
+      pfd.revents = 0;
+
+      int wait = qMax( timeout - (int) timer.elapsed(), 0 );
+      int ret  = poll( &pfd, 1, wait );
+
+      if( ret == -1 && errno == EINTR )
+        {
+          continue;
+        }
+
+      if( ret <= 0 )
+        {
+          if( ret == 0 && timeout > 0 )
+            {
+              m_readTimeouts++;
+            }
+
+          // timeout or error
+          return false;
+        }
+
+      // Read as much as fits into the free part behind the tail.
+      int tail  = (m_head + m_count) % BufferSize;
+      int space = qMin( BufferSize - m_count, BufferSize - tail );
+
+      ssize_t n = ::read( m_fd, m_buffer + tail, space );
+
+      if( n > 0 )
+        {
+          m_count     += n;
+          m_bytesRead += n;
+          return true;
+        }
+
+      if( n == -1 && (errno == EAGAIN || errno == EINTR) )
+        {
+          continue;
+        }
+
+      if( n == -1 )
+        {
+          qWarning() << "SerialTransport: Read error" << strerror( errno );
+        }
+
+      return false;
+    }
+}
+
+int SerialTransport::take( unsigned char* data, const int count )
+{
+  int done = 0;
+
+  while( done < count && m_count > 0 )
+    {
+      int chunk = qMin( count - done, qMin( m_count, BufferSize - m_head ) );
+
+      memcpy( data + done, m_buffer + m_head, chunk );
+
+      done    += chunk;
+      m_head   = (m_head + chunk) % BufferSize;
+      m_count -= chunk;
+    }
+
+  if( m_count == 0 )
+    {
+      m_head = 0;
+    }
+
+  return done;
+}
+
+int SerialTransport::read( unsigned char* data, const int count, const int timeout )
+{
+  if( m_fd == -1 )
+    {
+      return -1;
+    }
+
+  if( count <= 0 )
+    {
+      return 0;
+    }
+
+  if( m_count == 0 && ! fill( timeout ) )
+    {
+      return 0;
+    }
+
+  int done = take( data, count );
+
+  // Fetch the rest of the already received data without waiting.
+  while( done < count && fill( 0 ) )
+    {
+      done += take( data + done, count - done );
+    }
+
+  return done;
+}
+
+bool SerialTransport::readByte( unsigned char& byte, const int timeout )
+{
+  if( m_count == 0 && ! fill( timeout ) )
+    {
+      return false;
+    }
+
+  return take( &byte, 1 ) == 1;
+}
+
+QByteArray SerialTransport::readLine( const int timeout, const int maxSize )
+{
+  QByteArray line;
+
+  if( m_fd == -1 )
+    {
+      return line;
+    }
+
+  QElapsedTimer timer;
+  timer.start();
+
+  while( line.size() < maxSize )
+    {
+      if( m_count == 0 &&
+          ! fill( qMax( timeout - (int) timer.elapsed(), 0 ) ) )
+        {
+          break;
+        }
+
+      // Search the newline in the received data.
+      int n = 0;
+
+      while( n < m_count && line.size() + n < maxSize )
+        {
+          if( m_buffer[(m_head + n) % BufferSize] == '\n' )
+            {
+              n++;
+              break;
+            }
+
+          n++;
+        }
+
+      int start = line.size();
+      line.resize( start + n );
+      take( reinterpret_cast<unsigned char *>( line.data() ) + start, n );
+
+      if( line.endsWith( '\n' ) )
+        {
+          break;
+        }
+    }
+
+  return line;
+}
+
+int SerialTransport::write( const unsigned char* data, const int count )
+{
+  if( m_fd == -1 )
+    {
+      return -1;
+    }
+
+  int done = 0;
+
+  while( done < count )
+    {
+      ssize_t n = ::write( m_fd, data + done, count - done );
+
+      if( n > 0 )
+        {
+          done           += n;
+          m_bytesWritten += n;
+          continue;
+        }
+
+      if( n == -1 && errno == EINTR )
+        {
+          continue;
+        }
+
+      if( n == -1 && errno != EAGAIN )
+        {
+          qWarning() << "SerialTransport: Write error" << strerror( errno );
+          return done > 0 ? done : -1;
+        }
+
+      // The output queue is full, wait until it accepts data again.
+      struct pollfd pfd;
+      pfd.fd      = m_fd;
+      pfd.events  = POLLOUT;
+      pfd.revents = 0;
+
+      int ret = poll( &pfd, 1, WRITE_TIMEOUT );
+
+      if( ret == -1 && errno == EINTR )
+        {
+          continue;
+        }
+
+      if( ret <= 0 )
+        {
+          qWarning() << "SerialTransport: Write timeout";
+          break;
+        }
+    }
+
+  return done;
+}
+
+void SerialTransport::flush()
+{
+  m_head  = 0;
+  m_count = 0;
+
+  if( m_fd != -1 )
+    {
+      tcflush( m_fd, TCIOFLUSH );
+    }
+}
+
+bool SerialTransport::drain()
+{
+  if( m_fd == -1 )
+    {
+      return false;
+    }
+
+  return tcdrain( m_fd ) == 0;
+}
+
+#endif // _WIN32
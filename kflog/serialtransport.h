@@ -0,0 +1,258 @@
+/***********************************************************************
+**
+**   serialtransport.h
+**
+**   This file is part of KFLog.
+**
+************************************************************************
+**
+**   Copyright (c):  2026 by agent <agent@local>
+**
+**   This file is distributed under the terms of the General Public
+**   License. See the file COPYING for more information.
+**
+***********************************************************************/
+
+/**
+ * \class SerialTransport
+ *
+ * \author agent
+ *
+ * \brief Buffered serial port access for the flight recorder plugins.
+ *
+ * The port is opened in non blocking raw mode. Received bytes are collected
+ * in a ring buffer, which is refilled with all available bytes by one read
+ * call, after poll has signaled new data. So a byte oriented protocol does
+ * not need a system call per byte and every wait is bounded by a timeout in
+ * milliseconds instead of the VTIME setting of the terminal. Writes are done
+ * blockwise and wait with poll, if the output queue of the driver is full.
+ *
+ * The settings of the port are restored, when the port is closed or the
+ * program is terminated by a signal.
+ *
+ * The transfered bytes and the read timeouts are counted. If the report is
+ * enabled by \ref setReportStatistics, they are reported together with the
+ * throughput, when the port is closed. So the transfer of a plugin can be
+ * measured against a real recorder or an emulator connected to a pseudo
+ * terminal.
+ *
+ * \date 2026
+ *
+ * \version 1.0
+ */
+
+#ifndef SERIAL_TRANSPORT_H
+#define SERIAL_TRANSPORT_H
+
+#ifndef _WIN32
+
+#include <termios.h>
+
+#include <QByteArray>
+#include <QElapsedTimer>
+#include <QString>
+
+class SerialTransport
+{
+ public:
+
+  SerialTransport();
+
+  /**
+   * Closes the port, if it is still open.
+   */
+  virtual ~SerialTransport();
+
+  /**
+   * Opens the device and sets it into raw mode with 8 data bits, no parity
+   * and one stop bit.
+   *
+   * \param device Name of the serial device
+   *
+   * \param speed Transfer speed as termios constant, e.g. B9600
+   *
+   * \param hwFlowControl Enables the RTS/CTS flow control
+   *
+   * \return True in case of success.
+   */
+  bool open( const QString& device, const speed_t speed,
+             const bool hwFlowControl = false );
+
+  /**
+   * Restores the old port settings and closes the device.
+   */
+  void close();
+
+  bool isOpen() const
+  {
+    return m_fd != -1;
+  };
+
+  /**
+   * \return The file descriptor of the open device or -1.
+   */
+  int handle() const
+  {
+    return m_fd;
+  };
+
+  speed_t speed() const
+  {
+    return m_speed;
+  };
+
+  /**
+   * Changes the transfer speed of the open port.
+   */
+  bool setSpeed( const speed_t speed );
+
+  /**
+   * Enables or disables the RTS/CTS flow control of the open port.
+   */
+  bool setFlowControl( const bool enable );
+
+  /**
+   * Waits up to timeout milliseconds for received data and returns then all
+   * available bytes up to count without further waiting.
+   *
+   * \return The number of read bytes, 0 in case of a timeout or -1 in case
+   *         of an error.
+   */
+  int read( unsigned char* data, const int count, const int timeout );
+
+  /**
+   * Reads one byte with a timeout in milliseconds.
+   *
+   * \return True, if a byte was read.
+   */
+  bool readByte( unsigned char& byte, const int timeout );
+
+  /**
+   * Reads a line terminated by a newline character, which is included in the
+   * result. If the timeout in milliseconds expires or maxSize bytes are read,
+   * the incomplete line is returned.
+   */
+  QByteArray readLine( const int timeout, const int maxSize = 512 );
+
+  /**
+   * Writes a block of data. Waits, if the output queue of the driver is full
+   * or stopped by the flow control.
+   *
+   * \return The number of written bytes or -1 in case of an error.
+   */
+  int write( const unsigned char* data, const int count );
+
+  int write( const QByteArray& data )
+  {
+    return write( reinterpret_cast<const unsigned char *>( data.constData() ),
+                  data.size() );
+  };
+
+  bool writeByte( const unsigned char byte )
+  {
+    return write( &byte, 1 ) == 1;
+  };
+
+  /**
+   * Discards the receive buffer and all not transmitted or not read data of
+   * the driver.
+   */
+  void flush();
+
+  /**
+   * Waits until all written data are transmitted.
+   */
+  bool drain();
+
+  /**
+   * \return The number of bytes received since the opening of the port.
+   */
+  qint64 bytesRead() const
+  {
+    return m_bytesRead;
+  };
+
+  /**
+   * \return The number of bytes written since the opening of the port.
+   */
+  qint64 bytesWritten() const
+  {
+    return m_bytesWritten;
+  };
+
+  /**
+   * \return The number of reads, which were ended by their timeout.
+   */
+  int readTimeouts() const
+  {
+    return m_readTimeouts;
+  };
+
+  /**
+   * Enables the report of the transfer statistics at the closing of a port.
+   * It is disabled by default.
+   */
+  static void setReportStatistics( const bool enable )
+  {
+    m_reportStatistics = enable;
+  };
+
+ private:
+
+  Q_DISABLE_COPY ( SerialTransport )
+
+  /**
+   * Waits up to timeout milliseconds for received data and appends all
+   * available bytes to the ring buffer.
+   *
+   * \return True, if new data were appended.
+   */
+  bool fill( const int timeout );
+
+  /**
+   * Moves up to count bytes from the ring buffer to data.
+   */
+  int take( unsigned char* data, const int count );
+
+  /** Activates the port settings in m_termEnv. */
+  bool apply();
+
+  /** Restores the port settings of the open port, called by the signals. */
+  static void releaseTTY( int signal );
+
+  /** The open port, which must be restored by the signal handler. */
+  static SerialTransport* m_openPort;
+
+  /** Switch of the statistics report at closing time. */
+  static bool m_reportStatistics;
+
+  enum { BufferSize = 4096 };
+
+  int m_fd;
+
+  /** The name of the open device */
+  QString m_device;
+
+  speed_t m_speed;
+
+  /** The port settings at opening time */
+  struct termios m_oldTermEnv;
+
+  /** The active port settings */
+  struct termios m_termEnv;
+
+  /** Ring buffer of the received bytes */
+  unsigned char m_buffer[BufferSize];
+  int m_head;
+  int m_count;
+
+  /** Transfer statistics */
+  QElapsedTimer m_openTime;
+  qint64        m_bytesRead;
+  qint64        m_bytesWritten;
+  int           m_readTimeouts;
+};
+
+#endif // _WIN32
+
+#endif
@@ -0,0 +1,153 @@
+/***********************************************************************
+**
+**   sourcecache.h
+**
+**   This file is part of KFLog.
+**
+************************************************************************
+**
+**   Copyright (c):  2026 by agent <agent@local>
+**
+**   This file is distributed under the terms of the General Public
+**   License. See the file COPYING for more information.
+**
+***********************************************************************/
+
+/**
+ * \class SourceCache
+ *
+ * \author agent
+ *
+ * \brief Keeps the read items of map data source files.
+ *
+ * The items of every source file are stored together with a fingerprint of
+ * the file, which consists of its size and modification time. As long as
+ * the fingerprint is unchanged, a reload of the map data can take the items
+ * from the cache instead of reading the file again. The items are stored
+ * before filtering and map projection, so that the cache stays valid, if
+ * the filter settings or the projection are changed.
+ *
+ * The cache is not thread safe, the caller has to protect it.
+ *
+ * \date 2026
+ *
+ * \version 1.0
+ */
+
+#ifndef SOURCE_CACHE_H
+#define SOURCE_CACHE_H
+
+#include <QByteArray>
+#include <QDateTime>
+#include <QFileInfo>
+#include <QHash>
+#include <QList>
+#include <QString>
+#include <QStringList>
+
+template<class T> class SourceCache
+{
+ public:
+
+  SourceCache()
+  {};
+
+  /**
+   * \return The fingerprint of a source file or an empty array, if the file
+   *         does not exist.
+   */
+  static QByteArray fingerprint( const QString& fileName )
+  {
+    QFileInfo fi( fileName );
+
+    if( ! fi.exists() )
+      {
+        return QByteArray();
+      }
+
+    return QByteArray::number( fi.size() ) + ":" +
+           QByteArray::number( fi.lastModified().toMSecsSinceEpoch() );
+  };
+
+  /**
+   * Looks up the items of a source file.
+   *
+   * \param fileName Name of the source file
+   *
+   * \param fp Current fingerprint of the source file
+   *
+   * \param items The stored items of the file
+   *
+   * \return True, if the file is unchanged since its items were stored.
+   */
+  bool lookup( const QString& fileName, const QByteArray& fp, QList<T>& items ) const
+  {
+    typename QHash<QString, Entry>::const_iterator it = m_entries.find( fileName );
+
+    if( fp.isEmpty() || it == m_entries.end() || it.value().fingerprint != fp )
+      {
+        return false;
+      }
+
+    items = it.value().items;
+    return true;
+  };
+
+  /**
+   * Stores the items of a source file. The fingerprint must be taken before
+   * the file is read, so that a modification during the read is detected at
+   * the next lookup.
+   */
+  void insert( const QString& fileName, const QByteArray& fp, const QList<T>& items )
+  {
+    Entry entry;
+    entry.fingerprint = fp;
+    entry.items       = items;
+
+    m_entries.insert( fileName, entry );
+  };
+
+  /**
+   * Removes a source file from the cache.
+   */
+  void remove( const QString& fileName )
+  {
+    m_entries.remove( fileName );
+  };
+
+  /**
+   * Removes all source files, which are not contained in the passed list,
+   * e.g. because they are not selected anymore.
+   */
+  void retain( const QStringList& fileNames )
+  {
+    QStringList keys = m_entries.keys();
+
+    for( int i = 0; i < keys.size(); i++ )
+      {
+        if( ! fileNames.contains( keys.at(i) ) )
+          {
+            m_entries.remove( keys.at(i) );
+          }
+      }
+  };
+
+  void clear()
+  {
+    m_entries.clear();
+  };
+
+ private:
+
+  class Entry
+  {
+   public:
+
+    QByteArray fingerprint;
+    QList<T>   items;
+  };
+
+  QHash<QString, Entry> m_entries;
+};
+
+#endif
@@ -25,6 +25,7 @@
 #include <Lmcons.h>
 #endif
 
+#include <cctype>
 #include <cmath>
 #ifndef _WIN32
 #include <unistd.h>
@@ -34,9 +35,9 @@
 #else
     #include <QtGui>
 #endif
-#include <QtXml>
 
 #include "altitude.h"
+#include "csvtokenizer.h"
 #include "runway.h"
 #include "da4record.h"
 
@@ -46,6 +47,7 @@
 
 #include "mainwindow.h"
 #include "mapdefaults.h"
+#include "mappedwaypointfile.h"
 #include "target.h"
 #include "waypointcatalog.h"
 
@@ -56,6 +58,7 @@
 #define FILE_FORMAT_ID_3    103 // waypoint list size added
 #define FILE_FORMAT_ID_4    104 // runway list added
 #define FILE_FORMAT_ID_5    105 // runway length stored as float to avoid rounding issues between ft - m
+#define FILE_FORMAT_ID_6    106 // memory mappable, see MappedWaypointFile
 
 // Center point definition, also used by waypoint import filter.
 #define CENTER_POS      0
@@ -231,92 +234,107 @@ bool WaypointCatalog::readXml(const QString& catalog)
 
   QApplication::setOverrideCursor(QCursor(Qt::WaitCursor));
 
-  QString errorMsg;
-  int errorLine;
-  int errorColumn;
-  QDomDocument doc;
+  // The catalog is read as stream, so that no document tree is built.
+  QXmlStreamReader xml( &file );
 
-  bool ok = doc.setContent( &file, false, &errorMsg, &errorLine, &errorColumn );
+  bool ok = true;
+  bool doctypeOk = false;
 
-  if( ! ok )
+  while( ok && ! xml.atEnd() )
     {
-      QApplication::restoreOverrideCursor();
-
-      qWarning() << "WaypointCatalog::readXml(): XML parse error in File="
-    		 << catalog
-                 << "Error=" << errorMsg
-                 << "Line=" << errorLine
-                 << "Column=" << errorColumn;
+      xml.readNext();
 
-      QMessageBox::critical( _mainWindow,
-                             QObject::tr("Error in %1").arg(QFileInfo(catalog).fileName()),
-                             QString("<html>XML Error at line %1 column %2:<br><br>%3</html>").arg(errorLine).arg(errorColumn).arg(errorMsg),
-                             QMessageBox::Ok );
-      file.close();
-      return false;
-    }
+      if( xml.isDTD() )
+        {
+          doctypeOk = ( xml.dtdName() == "KFLogWaypoint" );
+          continue;
+        }
 
-  if (doc.doctype().name() == "KFLogWaypoint")
-    {
-      QDomNodeList nl = doc.elementsByTagName("Waypoint");
+      if( ! xml.isStartElement() || xml.name() != "Waypoint" )
+        {
+          continue;
+        }
 
-      for( int i = 0; i < nl.count(); i++ )
+      if( ! doctypeOk )
         {
-          QDomNamedNodeMap nm =  nl.item(i).attributes();
-          Waypoint *w = new Waypoint;
+          break;
+        }
 
-          w->name = nm.namedItem("Name").toAttr().value().left(8).toUpper();
-          w->description = nm.namedItem("Description").toAttr().value();
-          w->icao = nm.namedItem("ICAO").toAttr().value().toUpper();
+      QXmlStreamAttributes attr = xml.attributes();
+      Waypoint *w = new Waypoint;
 
-          if( w->icao == "-1" )
-            {
-              w->icao = "";
-            }
+      w->name = attr.value("Name").toString().left(8).toUpper();
+      w->description = attr.value("Description").toString();
+      w->icao = attr.value("ICAO").toString().toUpper();
 
-          w->type = nm.namedItem("Type").toAttr().value().toInt();
-          w->origP.setLat(nm.namedItem("Latitude").toAttr().value().toInt());
-          w->origP.setLon(nm.namedItem("Longitude").toAttr().value().toInt());
-          w->elevation = nm.namedItem("Elevation").toAttr().value().toFloat();
-          w->frequency = nm.namedItem("Frequency").toAttr().value().toFloat();
+      if( w->icao == "-1" )
+        {
+          w->icao = "";
+        }
 
-          QPair<ushort, ushort> rwyHeadings = QPair<ushort, ushort>(0, 0);
+      w->type = attr.value("Type").toString().toInt();
+      w->origP.setLat(attr.value("Latitude").toString().toInt());
+      w->origP.setLon(attr.value("Longitude").toString().toInt());
+      w->elevation = attr.value("Elevation").toString().toFloat();
+      w->frequency = attr.value("Frequency").toString().toFloat();
 
-          ushort rwyHeading = nm.namedItem("Runway").toAttr().value().toUShort();
-          rwyHeadings.first = rwyHeading >> 8;
-          rwyHeadings.second = rwyHeading & 0xff;
+      QPair<ushort, ushort> rwyHeadings = QPair<ushort, ushort>(0, 0);
 
-          bool isLandable = nm.namedItem("Landable").toAttr().value().toInt();
-          int rwyLength = nm.namedItem("Length").toAttr().value().toFloat();
-          enum Runway::SurfaceType rwySfc = (enum Runway::SurfaceType) nm.namedItem("Surface").toAttr().value().toInt();
+      ushort rwyHeading = attr.value("Runway").toString().toUShort();
+      rwyHeadings.first = rwyHeading >> 8;
+      rwyHeadings.second = rwyHeading & 0xff;
 
-          Runway rwy( rwyLength, rwyHeadings, rwySfc, isLandable );
+      bool isLandable = attr.value("Landable").toString().toInt();
+      int rwyLength = attr.value("Length").toString().toFloat();
+      enum Runway::SurfaceType rwySfc = (enum Runway::SurfaceType) attr.value("Surface").toString().toInt();
 
-          w->rwyList.append( rwy );
-          w->comment = nm.namedItem("Comment").toAttr().value();
-          w->importance = nm.namedItem("Importance").toAttr().value().toInt();
+      Runway rwy( rwyLength, rwyHeadings, rwySfc, isLandable );
 
-          if( nm.contains("Country") )
-            {
-              w->country = nm.namedItem("Country").toAttr().value();
-            }
+      w->rwyList.append( rwy );
+      w->comment = attr.value("Comment").toString();
+      w->importance = attr.value("Importance").toString().toInt();
 
-          if( !insertWaypoint( w ) )
-            {
-              break;
-            }
+      if( attr.hasAttribute("Country") )
+        {
+          w->country = attr.value("Country").toString();
+        }
+
+      if( !insertWaypoint( w ) )
+        {
+          break;
         }
+    }
+
+  if( xml.hasError() )
+    {
+      QApplication::restoreOverrideCursor();
 
+      qWarning() << "WaypointCatalog::readXml(): XML parse error in File="
+                 << catalog
+                 << "Error=" << xml.errorString()
+                 << "Line=" << xml.lineNumber()
+                 << "Column=" << xml.columnNumber();
+
+      QMessageBox::critical( _mainWindow,
+                             QObject::tr("Error in %1").arg(QFileInfo(catalog).fileName()),
+                             QString("<html>XML Error at line %1 column %2:<br><br>%3</html>").arg(xml.lineNumber()).arg(xml.columnNumber()).arg(xml.errorString()),
+                             QMessageBox::Ok );
+      file.close();
+      return false;
+    }
+
+  if( doctypeOk )
+    {
       onDisc = true;
       path = catalog;
-
-      ok = true;
     }
   else
     {
+      ok = false;
+
       QMessageBox::critical( _mainWindow,
                              QObject::tr("Error occurred!"),
-                             QObject::tr("wrong doctype ") + doc.doctype().name(),
+                             QObject::tr("wrong doctype ") + xml.dtdName().toString(),
                              QMessageBox::Ok );
     }
 
@@ -330,47 +348,43 @@ bool WaypointCatalog::readXml(const QString& catalog)
 bool WaypointCatalog::writeXml()
 {
   bool ok = true;
-  QDomDocument doc("KFLogWaypoint");
-  QDomElement root = doc.createElement("KFLogWaypoint");
-  QDomElement child;
   Waypoint *w;
   QFile file;
   QString fName = path;
 
-  QApplication::setOverrideCursor( QCursor(Qt::WaitCursor) );
+  file.setFileName(fName);
 
-  root.setAttribute( "Application", "KFLog" );
-  root.setAttribute( "Creator", getLogin() );
-  root.setAttribute( "Time", QTime::currentTime().toString( "HH:mm:mm" ) );
-  root.setAttribute( "Date", QDate::currentDate().toString( Qt::ISODate ) );
-  root.setAttribute( "Version", "1.0" );
-  root.setAttribute( "Entries", wpList.size() );
+  if( ! file.open( QIODevice::WriteOnly | QIODevice::Text ) )
+    {
+      QMessageBox::critical( _mainWindow,
+                             QObject::tr("Error occurred!"),
+                             QString ("<html><B>%1</B><BR>").arg(fName) +
+                             QObject::tr("permission denied!") +
+                             "</html>", QMessageBox::Ok );
+      return ok;
+    }
 
-  doc.appendChild(root);
+  QApplication::setOverrideCursor( QCursor(Qt::WaitCursor) );
 
-  foreach(w, wpList)
-  {
-#if 0
-    qDebug( "writing waypoint %s (%s - %s)",
-            w->name.toLatin1().data(),
-            w->description.toLatin1().data(),
-            w->icao.toLatin1().data() );
-#endif
+  // The waypoints are written directly into the file, no document tree
+  // is built.
+  QXmlStreamWriter xml( &file );
+  xml.setAutoFormatting( true );
+  xml.setAutoFormattingIndent( 4 );
 
-    child = doc.createElement("Waypoint");
+  xml.writeStartDocument();
+  xml.writeDTD( "<!DOCTYPE KFLogWaypoint>" );
 
-    child.setAttribute("Name", w->name.left(8).toUpper());
-    child.setAttribute("Description", w->description);
-    child.setAttribute("ICAO", w->icao);
-    child.setAttribute("Type", w->type);
-    child.setAttribute("Latitude", w->origP.lat());
-    child.setAttribute("Longitude", w->origP.lon());
-    child.setAttribute("Elevation", w->elevation);
-    child.setAttribute("Frequency", w->frequency);
-    child.setAttribute("Comment", w->comment);
-    child.setAttribute("Importance", w->importance);
-    child.setAttribute("Country", w->country);
+  xml.writeStartElement( "KFLogWaypoint" );
+  xml.writeAttribute( "Application", "KFLog" );
+  xml.writeAttribute( "Creator", getLogin() );
+  xml.writeAttribute( "Time", QTime::currentTime().toString( "HH:mm:mm" ) );
+  xml.writeAttribute( "Date", QDate::currentDate().toString( Qt::ISODate ) );
+  xml.writeAttribute( "Version", "1.0" );
+  xml.writeAttribute( "Entries", QString::number( wpList.size() ) );
 
+  foreach(w, wpList)
+  {
     Runway rwy;
 
     if( w->rwyList.size() > 0 )
@@ -378,36 +392,32 @@ bool WaypointCatalog::writeXml()
         rwy = w->rwyList[0];
       }
 
-    child.setAttribute("Landable", rwy.m_isOpen);
-    child.setAttribute("Runway", (rwy.m_heading.first << 8) + (rwy.m_heading.second & 0xff));
-    child.setAttribute("Length", rwy.m_length);
-    child.setAttribute("Surface", rwy.m_surface);
-
-    root.appendChild(child);
+    xml.writeEmptyElement( "Waypoint" );
+    xml.writeAttribute( "Name", w->name.left(8).toUpper() );
+    xml.writeAttribute( "Description", w->description );
+    xml.writeAttribute( "ICAO", w->icao );
+    xml.writeAttribute( "Type", QString::number( w->type ) );
+    xml.writeAttribute( "Latitude", QString::number( w->origP.lat() ) );
+    xml.writeAttribute( "Longitude", QString::number( w->origP.lon() ) );
+    xml.writeAttribute( "Elevation", QString::number( w->elevation ) );
+    xml.writeAttribute( "Frequency", QString::number( w->frequency ) );
+    xml.writeAttribute( "Comment", w->comment );
+    xml.writeAttribute( "Importance", QString::number( w->importance ) );
+    xml.writeAttribute( "Country", w->country );
+    xml.writeAttribute( "Landable", QString::number( rwy.m_isOpen ) );
+    xml.writeAttribute( "Runway", QString::number( (rwy.m_heading.first << 8) + (rwy.m_heading.second & 0xff) ) );
+    xml.writeAttribute( "Length", QString::number( rwy.m_length ) );
+    xml.writeAttribute( "Surface", QString::number( rwy.m_surface ) );
   }
 
-  file.setFileName(fName);
-
-  if( file.open( QIODevice::WriteOnly | QIODevice::Text ) )
-    {
-      const int IndentSize = 4;
+  xml.writeEndElement();
+  xml.writeEndDocument();
 
-      QTextStream out( &file );
-      doc.save( out, IndentSize );
-      file.close();
+  file.close();
 
-      path = fName;
-      modified = false;
-      onDisc = true;
-    }
-  else
-    {
-      QMessageBox::critical( _mainWindow,
-                             QObject::tr("Error occurred!"),
-                             QString ("<html><B>%1</B><BR>").arg(fName) +
-                             QObject::tr("permission denied!") +
-                             "</html>", QMessageBox::Ok );
-    }
+  path = fName;
+  modified = false;
+  onDisc = true;
 
   QApplication::restoreOverrideCursor();
   return ok;
@@ -416,86 +426,20 @@ bool WaypointCatalog::writeXml()
 bool WaypointCatalog::writeBinary()
 {
   bool ok = true;
-
-  QString wpName="";
-  QString wpDescription="";
-  QString wpICAO="";
-  qint8 wpType;
-  qint32 wpLatitude;
-  qint32 wpLongitude;
-  float wpElevation;
-  float wpFrequency;
-  QString wpComment="";
-  quint8 wpImportance;
-
-  Waypoint *w;
-  QFile f;
   QString fName = path;
 
-  f.setFileName(fName);
-
-  if (f.open(QIODevice::WriteOnly))
-    {
-      QApplication::setOverrideCursor( QCursor(Qt::WaitCursor) );
-
-      QDataStream out(& f);
-      out.setVersion( DATA_STREAM );
-
-      //write file header
-      out << quint32( KFLOG_FILE_MAGIC );
-      out << qint8( FILE_TYPE_WAYPOINTS );
-      out << quint16( FILE_FORMAT_ID_5 );
-      out << qint32( wpList.size() );
-
-      foreach(w, wpList)
-        {
-          wpName = w->name.left(8).toUpper();
-          wpDescription = w->description;
-          wpICAO = w->icao;
-          wpType = w->type;
-          wpLatitude = w->origP.lat();
-          wpLongitude = w->origP.lon();
-          wpElevation = w->elevation;
-          wpFrequency = w->frequency;
-          wpComment = w->comment;
-          wpImportance = w->importance;
-
-          out << wpName;
-          out << wpDescription;
-          out << wpICAO;
-          out << wpType;
-          out << wpLatitude;
-          out << wpLongitude;
-          out << wpElevation;
-          out << wpFrequency;
-          out << wpComment;
-          out << wpImportance;
-          out << w->country;
-
-          // The runway list is saved
-          out << quint8( w->rwyList.size() );
-
-          for( int i = 0; i < w->rwyList.size(); i++ )
-            {
-              Runway rwy = w->rwyList.at(i);
+  QApplication::setOverrideCursor( QCursor(Qt::WaitCursor) );
 
-              QPair<ushort, ushort> rwyHeadings = rwy.getRunwayHeadings();
+  // The catalog is written in the memory mappable format.
+  bool written = MappedWaypointFile::write( fName, wpList );
 
-              out << rwy.m_length;
-              out << rwy.m_width;
-              out << quint16( (rwyHeadings.first * 256) + (rwyHeadings.second & 0xff) );
-              out << quint8( rwy.m_surface );
-              out << quint8( rwy.m_isOpen );
-              out << quint8(  (rwyHeadings.first != rwyHeadings.second) );
-            }
-        }
+  QApplication::restoreOverrideCursor();
 
-      f.close();
+  if( written )
+    {
       path = fName;
       modified = false;
       onDisc = true;
-
-      QApplication::restoreOverrideCursor();
     }
   else
     {
@@ -744,98 +688,115 @@ bool WaypointCatalog::readFilserTXT(const QString& catalog)
 {
   qDebug() << "WaypointCatalog::readFilserTXT: " << catalog;
 
-  QFile f(catalog);
+  QTime t;
+  t.start();
 
-  if (f.exists())
+  // The file contains ASCII only, it is decoded like the C strings.
+  CsvTokenizer tokenizer( "UTF-8" );
+
+  if( ! tokenizer.open( catalog ) )
     {
-      if (f.open(QIODevice::ReadOnly))
+      return false;
+    }
+
+  int counter = 0;
+
+  while( tokenizer.readLine() )
+    {
+      if( tokenizer.field(0).startsWith('*') ) // comment/header line
         {
-          while (!f.atEnd())
-            {
-              char line[256];
+          continue;
+        }
 
-              qint64 result = f.readLine (line, sizeof(line));
+      if( tokenizer.count() < 9 )
+        {
+          // That will prevent a crash, if a wrong file is read!
+          continue;
+        }
 
-              if (result > 0)
-                {
-                  QStringList list = QString(line).split (",");
+      Waypoint *w = new Waypoint;
+      w->name = tokenizer.toString(1);
+      w->description = "";
+      w->icao = "";
 
-                  if(list.size() == 0 || list[0] == "*") // comment/header line
-                    {
-                      continue;
-                    }
+      const CsvTokenizer::Field& type = tokenizer.field(2);
 
-                  if( list.size() < 9 )
-                    {
-                      // That will prevent a crash, if a wrong file is read!
-                      continue;
-                    }
+      if( type.equals("APT") )
+        w->type = BaseMapElement::Airfield;
+      else if( type.equals("OUTLAN") )
+        w->type = BaseMapElement::Outlanding;
+      else
+        w->type = BaseMapElement::Landmark; // TP, MARKER
 
-                  Waypoint *w = new Waypoint;
-                  w->name = list [1];
-                  w->description = "";
-                  w->icao = "";
-
-                  if (list[2].toUpper() == "TP")
-                    w->type = BaseMapElement::Landmark;
-                  else if (list[2].toUpper() == "APT")
-                    w->type = BaseMapElement::Airfield;
-                  else if (list[2].toUpper() == "OUTLAN")
-                    w->type = BaseMapElement::Outlanding;
-                  else if (list[2].toUpper() == "MARKER")
-                    w->type = BaseMapElement::Landmark;
-                  else
-                    w->type = BaseMapElement::Landmark;
-                  w->origP.setLat((int)(rint(list[3].toDouble() * 600000.0)));
-                  w->origP.setLon((int)(rint(list[4].toDouble() * 600000.0)));
-                  w->elevation = (int)(rint(list[5].toInt() * 0.3048)); // don't we have conversion constants ?
-                  w->frequency = list[6].toFloat() / 1000.0;
+      double value = 0.0;
 
-                  Runway rwy;
+      CsvTokenizer::toDouble( tokenizer.field(3), value );
+      w->origP.setLat((int)(rint(value * 600000.0)));
 
-                  rwy.m_length = list[7].toUInt(); // length ?!
-                  rwy.m_heading.first = list[8].toUShort(); // direction ?!
-                  rwy.m_heading.second = ((rwy.m_heading.first > 18) ? rwy.m_heading.first - 18 : rwy.m_heading.first + 18 );
+      value = 0.0;
+      CsvTokenizer::toDouble( tokenizer.field(4), value );
+      w->origP.setLon((int)(rint(value * 600000.0)));
 
-                  if( rwy.m_heading.first > 0 )
-                    {
-                      rwy.m_isOpen = true;
-                    }
+      int number = 0;
+      CsvTokenizer::toInt( tokenizer.field(5), number );
+      w->elevation = (int)(rint(number * 0.3048)); // don't we have conversion constants ?
 
-                  QChar surface = list[9].toUpper()[0];
+      value = 0.0;
+      CsvTokenizer::toDouble( tokenizer.field(6), value );
+      w->frequency = value / 1000.0;
 
-                  switch (surface.toLatin1())
-                    {
-                    case 'G':
-                      rwy.m_surface = Runway::Grass;
-                      break;
-                    case 'C':
-                      rwy.m_surface = Runway::Concrete;
-                      break;
-                    default:
-                      rwy.m_surface = Runway::Unknown;
-                      break;
-                    }
+      Runway rwy;
 
-                  w->rwyList.append(rwy);
-                  w->comment = QObject::tr("Imported from %1").arg(catalog);
-                  w->importance = 1;
+      number = 0;
+      CsvTokenizer::toInt( tokenizer.field(7), number );
+      rwy.m_length = qMax( number, 0 ); // length ?!
 
-                  if (!insertWaypoint(w))
-                    {
-                      delete w;
-                      break;
-                    }
-                }
-            }
+      number = 0;
+      CsvTokenizer::toInt( tokenizer.field(8), number );
+      rwy.m_heading.first = (ushort) number; // direction ?!
+      rwy.m_heading.second = ((rwy.m_heading.first > 18) ? rwy.m_heading.first - 18 : rwy.m_heading.first + 18 );
 
-          f.close();
-          onDisc = true;
-          path = catalog;
-          return true;
+      if( rwy.m_heading.first > 0 )
+        {
+          rwy.m_isOpen = true;
         }
+
+      const CsvTokenizer::Field& surface = tokenizer.field(9);
+
+      switch( surface.isEmpty() ? 0 : toupper( (uchar) surface.data[0] ) )
+        {
+        case 'G':
+          rwy.m_surface = Runway::Grass;
+          break;
+        case 'C':
+          rwy.m_surface = Runway::Concrete;
+          break;
+        default:
+          rwy.m_surface = Runway::Unknown;
+          break;
+        }
+
+      w->rwyList.append(rwy);
+      w->comment = QObject::tr("Imported from %1").arg(catalog);
+      w->importance = 1;
+
+      if (!insertWaypoint(w))
+        {
+          delete w;
+          break;
+        }
+
+      counter++;
     }
-  return false;
+
+  tokenizer.close();
+
+  qDebug( "WaypointCatalog::readFilserTXT: %d waypoints read in %dms",
+          counter, t.elapsed() );
+
+  onDisc = true;
+  path = catalog;
+  return true;
 }
 
 /** write a waypoint catalog into a filser txt file */
@@ -1093,6 +1054,12 @@ bool WaypointCatalog::readBinary(const QString &catalog)
 
       in >> fileFormat;
 
+      if( fileFormat == FILE_FORMAT_ID_6 )
+        {
+          f.close();
+          return readMappedBinary( catalog );
+        }
+
       if( fileFormat < FILE_FORMAT_ID_2 )
         {
           qWarning() << "Wrong waypoint file format! Read format Id"
@@ -1259,7 +1226,7 @@ bool WaypointCatalog::readBinary(const QString &catalog)
       path = catalog;
       ok = true;
 
-      if( fileFormat < FILE_FORMAT_ID_5 )
+      if( fileFormat < FILE_FORMAT_ID_6 )
         {
           // write file back in newer format
           writeBinary();
@@ -1282,6 +1249,57 @@ bool WaypointCatalog::readBinary(const QString &catalog)
   return ok;
 }
 
+bool WaypointCatalog::readMappedBinary( const QString& catalog )
+{
+  MappedWaypointFile file;
+
+  if( ! file.open( catalog ) )
+    {
+      QMessageBox::critical( _mainWindow,
+                             QObject::tr("Error occurred!"),
+                             QString("<html><B>%1</B><BR>").arg(catalog) +
+                             QObject::tr("is not a valid waypoint catalog!") +
+                             "</html>", QMessageBox::Ok );
+      return false;
+    }
+
+  QApplication::setOverrideCursor( QCursor(Qt::WaitCursor) );
+
+  // All waypoints are read, also if an area or radius filter is active.
+  // The filters are applied by the display only, otherwise a later save
+  // of the catalog would lose the filtered waypoints.
+  int count = file.size();
+
+  // Names are unique in a saved catalog, so an empty catalog can be filled
+  // without the linear search of insertWaypoint.
+  bool wasEmpty = wpList.isEmpty();
+  QSet<QString> names;
+
+  for( int i = 0; i < count; i++ )
+    {
+      Waypoint *w = file.waypoint( i );
+
+      if( wasEmpty && ! names.contains( w->name ) )
+        {
+          names.insert( w->name );
+          wpList.append( w );
+        }
+      else if( ! insertWaypoint( w ) )
+        {
+          break;
+        }
+    }
+
+  qDebug() << "WaypointCatalog::readMappedBinary:" << wpList.size() << "of"
+           << file.size() << "waypoints read from" << catalog;
+
+  onDisc = true;
+  path = catalog;
+
+  QApplication::restoreOverrideCursor();
+  return true;
+}
+
 /** read a waypoint catalog from a SeeYou cup file, only waypoint part */
 bool WaypointCatalog::readCup (const QString& catalog)
 {
@@ -1307,7 +1325,12 @@ bool WaypointCatalog::readCup (const QString& catalog)
       return false;
     }
 
-  if (!file.open(QIODevice::ReadOnly | QIODevice::Text))
+  // A cup line consists of elements separated by commas. String elements
+  // are enclosed in quotation marks. Inside such a string element, a
+  // comma is allowed and is not to interpret as separator!
+  CsvTokenizer tokenizer;
+
+  if( ! tokenizer.open( catalog ) )
     {
       return false;
     }
@@ -1320,39 +1343,33 @@ bool WaypointCatalog::readCup (const QString& catalog)
       names.insert( wpList.at(i)->name );
     }
 
-  int lineNo = 0;
+  QTime t;
+  t.start();
 
-  QTextStream in(&file);
-  in.setCodec( "ISO 8859-15" );
+  int counter = 0;
 
   QApplication::setOverrideCursor( QCursor(Qt::WaitCursor) );
 
-  while (!in.atEnd())
+  while( tokenizer.readLine() )
     {
-      QString line = in.readLine();
+      int lineNo = tokenizer.lineNumber();
 
-      lineNo++;
-
-      if( line.size() == 0 )
+      if( tokenizer.isEmptyLine() )
         {
           continue;
         }
 
-      bool ok;
-
-      QList<QString> list = splitCupLine( line, ok );
-
-      if( list[0] == "-----Related Tasks-----" )
+      if( tokenizer.field(0).equals( "-----Related Tasks-----" ) )
         {
           // Task part starts, we will ignore it and break up reading
           break;
         }
 
       // 10 elements are mandatory, element 11 description is optional
-      if( list.count() < 10 ||
-          list[0].toLower() == "name" ||
-          list[1].toLower() == "code" ||
-          list[2].toLower() == "country" )
+      if( tokenizer.count() < 10 ||
+          tokenizer.field(0).equals( "name" ) ||
+          tokenizer.field(1).equals( "code" ) ||
+          tokenizer.field(2).equals( "country" ) )
         {
           // too less elements or a description line, ignore this
           continue;
@@ -1368,34 +1385,25 @@ bool WaypointCatalog::readCup (const QString& catalog)
 
       w->importance = 0;
 
-      if( list[0].length() ) // long name of waypoint
-        {
-          w->description = list[0].replace( QRegExp("\""), "" );
-        }
-      else
-        {
-          w->description = "";
-        }
+      // long name of waypoint
+      w->description = tokenizer.toString(0);
 
-      if( list[1].isEmpty() )
-        {
-          // If no code is set, we assign the long name as code to have a workaround.
-          list[1] = list[0];
-        }
+      // If no code is set, we assign the long name as code to have a workaround.
+      QString code = tokenizer.field(1).isEmpty() ? w->description : tokenizer.toString(1);
 
       // short name of a waypoint has only 8 characters and upper cases
-      w->name = list[1].replace( QRegExp("\""), "" ).left(8).toUpper();
-      w->country = list[2].left(2).toUpper();
+      w->name = code.left(8).toUpper();
+      w->country = tokenizer.toString(2).left(2).toUpper();
       w->icao = "";
       rwy.m_surface = Runway::Unknown;
 
       // waypoint type
-      uint wpType = list[6].toUInt(&ok);
+      int wpType;
 
-      if( ! ok )
+      if( ! CsvTokenizer::toInt( tokenizer.field(6), wpType ) || wpType < 0 )
         {
           qWarning("CUP Read (%d): Invalid waypoint type '%s'. Ignoring it.",
-                   lineNo, list[6].toLatin1().data() );
+                   lineNo, tokenizer.toString(6).toLatin1().data() );
           delete w;
           continue;
         }
@@ -1439,111 +1447,51 @@ bool WaypointCatalog::readCup (const QString& catalog)
         }
 
       // latitude as ddmm.mmm(N|S)
-      double degree = list[3].left(2).toDouble(&ok);
-
-      if( ! ok )
-        {
-          qWarning("CUP Read (%d): Error reading coordinate (N/S) (1)", lineNo);
-          delete w;
-          continue;
-        }
+      int lat;
 
-      double minutes = list[3].mid(2,6).toDouble(&ok);
-
-      if( ! ok )
+      if( ! CsvTokenizer::toCoordinate( tokenizer.field(3), 2, lat ) )
         {
-          qWarning("CUP Read (%d): Error reading coordinate (N/S) (2)", lineNo);
+          qWarning("CUP Read (%d): Error reading coordinate (N/S)", lineNo);
           delete w;
           continue;
         }
 
-      double latTmp = (degree * 600000.) + (minutes * 10000.0);
-
-      if( list[3].right(1).toUpper() == "S" )
-        {
-          latTmp = -latTmp;
-        }
-
       // longitude dddmm.mmm(E|W)
-      degree = list[4].left(3).toDouble(&ok);
-
-      if( ! ok )
-        {
-          qWarning("CUP Read (%d): Error reading coordinate (E/W) (1)", lineNo);
-          delete w;
-          continue;
-        }
+      int lon;
 
-      minutes = list[4].mid(3,6).toDouble(&ok);
-
-      if( ! ok )
+      if( ! CsvTokenizer::toCoordinate( tokenizer.field(4), 3, lon ) )
         {
-          qWarning("CUP Read (%d): Error reading coordinate (E/W) (2)", lineNo);
+          qWarning("CUP Read (%d): Error reading coordinate (E/W)", lineNo);
           delete w;
           continue;
         }
 
-      double lonTmp = (degree * 600000.) + (minutes * 10000.0);
-
-
-      if( list[4].right(1).toUpper() == "W" )
-        {
-          lonTmp = -lonTmp;
-        }
-
-      w->origP.setLat((int) rint(latTmp));
-      w->origP.setLon((int) rint(lonTmp));
+      w->origP.setLat( lat );
+      w->origP.setLon( lon );
 
       // two units are possible:
       // o meter: m
       // o feet:  ft
-      if( list[5].length() ) // elevation in meter or feet
+      if( ! tokenizer.field(5).isEmpty() ) // elevation in meter or feet
         {
-          QString unit;
-          int uStart = list[5].indexOf( QRegExp("[mf]") );
+          float tmpElev;
 
-          if( uStart == -1 )
+          if( ! CsvTokenizer::toMeters( tokenizer.field(5), tmpElev ) )
             {
-              qWarning("CUP Read (%d): Error reading elevation unit '%s'.", lineNo,
-                       list[5].toLatin1().data());
+              qWarning("CUP Read (%d): Error reading elevation '%s'.", lineNo,
+                       tokenizer.toString(5).toLatin1().data());
               delete w;
               continue;
             }
 
-          unit = list[5].mid( uStart ).toLower();
-
-          float tmpElev = (list[5].left(list[5].length() - unit.length())).toFloat(&ok);
-
-          if( ! ok )
-            {
-              qWarning("CUP Read (%d): Error reading elevation value '%s'.", lineNo,
-                       list[5].left(list[5].length() - unit.length()).toLatin1().data());
-              delete w;
-              continue;
-            }
-
-          if( unit == "m" )
-            {
-              w->elevation = tmpElev;
-            }
-          else if( unit == "ft" )
-            {
-              w->elevation = tmpElev * 0.3048;
-            }
-          else
-            {
-              qWarning("CUP Read (%d): Unknown elevation value '%s'.", lineNo,
-                       unit.toLatin1().data());
-              delete w;
-              continue;
-            }
+          w->elevation = tmpElev;
         }
 
-      if( list[9].trimmed().length() ) // airport frequency
+      if( ! tokenizer.field(9).isEmpty() ) // airport frequency
         {
-          float frequency = list[9].replace( QRegExp("\""), "" ).toFloat(&ok);
+          double frequency;
 
-          if( ok )
+          if( CsvTokenizer::toDouble( tokenizer.field(9), frequency ) )
             {
               w->frequency = frequency;
             }
@@ -1553,11 +1501,11 @@ bool WaypointCatalog::readCup (const QString& catalog)
             }
         }
 
-      if( list[7].trimmed().length() ) // runway direction 010...360
+      if( ! tokenizer.field(7).isEmpty() ) // runway direction 010...360
         {
-          uint rdir = list[7].toInt(&ok);
+          int rdir;
 
-          if( ok )
+          if( CsvTokenizer::toInt( tokenizer.field(7), rdir ) )
             {
               rwy.m_heading.first = rdir/10;
               rwy.m_heading.second = rwy.m_heading.first <= 18 ? rwy.m_heading.first + 18 : rwy.m_heading.first - 18;
@@ -1569,7 +1517,7 @@ bool WaypointCatalog::readCup (const QString& catalog)
             }
         }
 
-      if( list[8].trimmed().length() ) // runway length in meters
+      if( ! tokenizer.field(8).isEmpty() ) // runway length in meters
         {
           // three units are possible:
           // o meter: m
@@ -1577,38 +1525,17 @@ bool WaypointCatalog::readCup (const QString& catalog)
           // o statute mile: ml
           // o feet: ft, @AP: Note that is not conform to the SeeYou specification
           //                  but I saw it in an south African file.
+          float length;
 
-          QString unit;
-          int uStart = list[8].indexOf( QRegExp("[fmn]") );
-
-          if( uStart != -1 )
+          if( CsvTokenizer::toMeters( tokenizer.field(8), length ) )
             {
-              unit = list[8].mid( uStart ).toLower();
-              float length = list[8].left( list[8].length()-unit.length() ).toFloat(&ok);
-
-              if( ok )
-                {
-                  if( unit == "nm" ) // nautical miles
-                    {
-                      length *= 1852;
-                    }
-                  else if( unit == "ml" ) // statute miles
-                    {
-                      length *= 1609.34;
-                    }
-                  else if( unit == "ft" ) // feet
-                    {
-                      length *= 0.3048;
-                    }
-
-                  rwy.m_length = length;
-                }
+              rwy.m_length = length;
             }
         }
 
-      if( list.count() == 11 && list[10].trimmed().length() ) // description, optional
+      if( tokenizer.count() == 11 && ! tokenizer.field(10).isEmpty() ) // description, optional
         {
-          w->comment += list[10].replace( QRegExp("\""), "" );
+          w->comment += tokenizer.toString(10);
         }
 
       w->rwyList.append(rwy);
@@ -1638,11 +1565,15 @@ bool WaypointCatalog::readCup (const QString& catalog)
 
       // Store used waypoint name in set.
       names.insert( w->name );
+      counter++;
     }
 
-  file.close();
+  tokenizer.close();
   QApplication::restoreOverrideCursor();
 
+  qDebug( "WaypointCatalog::readCup: %d waypoints read in %dms",
+          counter, t.elapsed() );
+
   onDisc = true;
   path = catalog;
   return true;
@@ -2290,86 +2221,6 @@ bool WaypointCatalog::removeWaypoint( const QString& name )
   return false;
 }
 
-QList<QString> WaypointCatalog::splitCupLine( QString& line, bool &ok )
-{
-  // A cup line consists of elements separated by commas. String elements
-  // are enclosed in quotation marks. Inside such a string element, a
-  // comma is allowed and is not to interpret as separator!
-  QList<QString> list;
-
-  int start, pos, len, idx;
-  start = pos = len = idx = 0;
-
-  line = line.trimmed();
-
-  len = line.size();
-
-  while( true )
-    {
-      if( line[pos] == QChar('"') )
-        {
-          // Handle quoted string
-          pos++;
-
-          if( pos >= len )
-            {
-              ok = false;
-              return list;
-            }
-
-          // Search the end quote
-          idx = line.indexOf( QChar('"'), pos );
-
-          if( idx == -1 )
-            {
-              // Syntax error, abort split
-              ok = false;
-              return list;
-            }
-
-          pos = idx; // set current position to index of quote sign
-        }
-
-      idx = line.indexOf( QChar(','), pos );
-
-      if( idx == -1 )
-        {
-          // No comma found, maybe we are at the end
-          if( start < len )
-            {
-              list.append( line.mid( start, len-start ) );
-            }
-          else
-            {
-              list.append( QString("") );
-            }
-
-          ok = true;
-          return list;
-        }
-
-      if( start < idx )
-        {
-          list.append( line.mid( start, idx-start ) );
-        }
-      else
-        {
-          list.append( QString("") );
-        }
-
-      if( (idx + 1) >= len )
-        {
-          // No more data available
-          ok = true;
-          return list;
-        }
-
-      pos = start = idx + 1;
-    }
-
-  return list;
-}
-
 /** Reads a Cambridge Aero Instruments turnpoint file. */
 bool WaypointCatalog::readDat(const QString &catalog)
 {
@@ -2398,7 +2249,9 @@ bool WaypointCatalog::readDat(const QString &catalog)
       return false;
     }
 
-  if (! file.open(QIODevice::ReadOnly | QIODevice::Text))
+  CsvTokenizer tokenizer;
+
+  if( ! tokenizer.open( catalog ) )
     {
       QMessageBox::warning( _mainWindow,
                             QObject::tr("Error occurred!"),
@@ -2416,28 +2269,25 @@ bool WaypointCatalog::readDat(const QString &catalog)
       names.insert( wpList.at(i)->name );
     }
 
-  int lineNo = 0;
+  QString country = _settings.value( "/Homesite/Country", "" ).toString();
 
-  QTextStream in(&file);
-  in.setCodec( "ISO 8859-15" );
+  QTime t;
+  t.start();
+
+  int counter = 0;
 
   QApplication::setOverrideCursor( QCursor(Qt::WaitCursor) );
 
-  while (!in.atEnd())
+  while( tokenizer.readLine() )
     {
-      QString line = in.readLine().trimmed();
-
-      lineNo++;
+      int lineNo = tokenizer.lineNumber();
 
-      if( line.size() == 0 || line.startsWith("*") )
+      if( tokenizer.isEmptyLine() || tokenizer.field(0).startsWith('*') )
         {
           // Filter out empty and comment lines
           continue;
         }
 
-      bool ok;
-      QStringList list = line.split( "," );
-
       /*
       Example turnpoints, two possible coordinate formats seems to be in use.
       0 ,1         ,2          ,3   ,4,5           ,6
@@ -2449,159 +2299,52 @@ bool WaypointCatalog::readDat(const QString &catalog)
 
       // Lines defining a turnpoint contain 7 fields, separated by commas.
       // The final field is terminated by the newline. Field 7 is optional.
-      if( list.size() < 6 )
+      if( tokenizer.count() < 6 )
         {
           qWarning() << "Line" << lineNo
                      << "is ignored, contains too less elements!";
           continue;
         }
 
-      Waypoint *w = new Waypoint;
-
-      w->importance = 0; // low
-      w->country = _settings.value( "/Homesite/Country", "" ).toString();
-
-      if( list[1].size() < 9 )
-        {
-          qWarning("DAT Read (%d): Format error latitude", lineNo);
-          continue;
-        }
-
       // latitude as 57:04.213N|S or 52:08:39N|S
-      double degree = list[1].left(2).toDouble(&ok);
+      int lat;
 
-      if( ! ok )
+      if( ! CsvTokenizer::toCoordinate( tokenizer.field(1), 2, lat ) )
         {
-          qWarning("DAT Read (%d): Format error latitude degree", lineNo);
-          delete w;
-          continue;
-        }
-
-      double minutes = 0.0;
-      double seconds = 0.0;
-
-      if( list[1][5] == QChar('.') )
-        {
-          minutes = list[1].mid(3, 6).toDouble(&ok);
-        }
-      else if( list[1][5] == QChar(':') )
-        {
-          minutes = list[1].mid(3, 2).toDouble(&ok);
-
-          if( ok )
-            {
-              seconds = list[1].mid(6, 2).toDouble(&ok);
-            }
-        }
-
-      if( ! ok )
-        {
-          qWarning("DAT Read (%d): Format error latitude minutes/seconds", lineNo);
-          delete w;
+          qWarning("DAT Read (%d): Format error latitude", lineNo);
           continue;
         }
 
-      double latTmp = (degree * 600000.) + (10000. * (minutes + seconds / 60. ));
-
-      if( list[1].right(1).toUpper() == "S" )
-        {
-          latTmp = -latTmp;
-        }
-
       // longitude as 002:47.239E|W or 012:40:06E|W
-      if( list[2].size() < 10 )
-        {
-          qWarning("DAT Read (%d): Format error longitude", lineNo);
-          continue;
-        }
-
-      degree = list[2].left(3).toDouble(&ok);
+      int lon;
 
-      if( ! ok )
+      if( ! CsvTokenizer::toCoordinate( tokenizer.field(2), 3, lon ) )
         {
-          qWarning("DAT Read (%d): Format error longitude degree", lineNo);
-          delete w;
-          continue;
-        }
-
-      minutes = 0.0;
-      seconds = 0.0;
-
-      if( list[2][6] == QChar('.') )
-        {
-          minutes = list[2].mid(4, 6).toDouble(&ok);
-        }
-      else if( list[2][6] == QChar(':') )
-        {
-          minutes = list[2].mid(4, 2).toDouble(&ok);
-
-          if( ok )
-            {
-              seconds = list[2].mid(7, 2).toDouble(&ok);
-            }
-        }
-
-      if( ! ok )
-        {
-          qWarning("DAT Read (%d): Format error longitude minutes/seconds", lineNo);
-          delete w;
+          qWarning("DAT Read (%d): Format error longitude", lineNo);
           continue;
         }
 
-      double lonTmp = (degree * 600000.) + (10000. * (minutes + seconds / 60. ));
-
-
-      if( list[2].right(1).toUpper() == "W" )
-        {
-          lonTmp = -lonTmp;
-        }
+      Waypoint *w = new Waypoint;
 
-      w->origP.setLat((int) rint(latTmp));
-      w->origP.setLon((int) rint(lonTmp));
+      w->importance = 0; // low
+      w->country = country;
+      w->origP.setLat( lat );
+      w->origP.setLon( lon );
 
       // Height AMSL 9{1,5}[FM] 9=height, F=feet, M=metres.
-      // two units are possible:
-      // o meter: m
-      // o feet:  ft
-      if( list[3].size() ) // elevation in meter or feet
+      if( ! tokenizer.field(3).isEmpty() ) // elevation in meter or feet
         {
-          QString unit = list[3].right(1).toUpper();
-
-          if( unit != "F" && unit != "M" )
-            {
-              qWarning("DAT Read (%d): Error reading elevation unit '%s'.",
-                       lineNo, list[3].toLatin1().data());
-              delete w;
-              continue;
-            }
-
-          float tmpElev = list[3].left(list[3].size() - 1).toFloat(&ok);
+          float tmpElev;
 
-          if( ! ok )
+          if( ! CsvTokenizer::toMeters( tokenizer.field(3), tmpElev ) )
             {
-              qWarning("DAT Read (%d): Error reading elevation value '%s'.",
-                        lineNo,
-                        list[3].left(list[3].size() - 1).toLatin1().data());
+              qWarning("DAT Read (%d): Error reading elevation '%s'.",
+                       lineNo, tokenizer.toString(3).toLatin1().data());
               delete w;
               continue;
             }
 
-          if( unit == "M" )
-            {
-              w->elevation = tmpElev;
-            }
-          else if( unit == "F" )
-            {
-              // Convert feet to meters
-              w->elevation = tmpElev * 0.3048;
-            }
-          else
-            {
-              qWarning("DAT Read (%d): Unknown elevation value '%s'.", lineNo,
-                       unit.toLatin1().data());
-              delete w;
-              continue;
-            }
+          w->elevation = tmpElev;
         }
 
       /*
@@ -2620,7 +2363,9 @@ bool WaypointCatalog::readDat(const QString &catalog)
       W       Waypoint
       */
 
-      if( list[4].isEmpty() )
+      const CsvTokenizer::Field& attributes = tokenizer.field(4);
+
+      if( attributes.isEmpty() )
         {
           qWarning("DAT Read (%d): Missing turnpoint attributes", lineNo );
           delete w;
@@ -2630,24 +2375,22 @@ bool WaypointCatalog::readDat(const QString &catalog)
       // That is the default
       w->type = BaseMapElement::Landmark;
 
-      list[4] = list[4].toUpper();
-
-      if( list[4].contains("T") )
+      if( attributes.contains('T') )
         {
           w->type = BaseMapElement::Turnpoint;
         }
 
-      if( list[4].contains("A") )
+      if( attributes.contains('A') )
         {
           w->type = BaseMapElement::Airfield;
         }
 
-      if( list[4].contains("L") )
+      if( attributes.contains('L') )
         {
           // w->isLandable = true;
         }
 
-      if( list[5].isEmpty() )
+      if( tokenizer.field(5).isEmpty() )
         {
           qWarning("DAT Read (%d): Missing turnpoint name", lineNo );
           delete w;
@@ -2656,29 +2399,11 @@ bool WaypointCatalog::readDat(const QString &catalog)
 
       // Short name of a waypoint has only 8 characters and upper cases in KFLog.
       // That is handled in another way by Cambridge.
-      w->name = list[5].left(8).toUpper().trimmed();
-      w->description = list[5].trimmed();
+      w->description = tokenizer.toString(5);
+      w->name = w->description.left(8).toUpper().trimmed();
 
-      if( list.size() >= 7 )
-        {
-          QString comment = list[6].trimmed();
-
-          if( ! comment.isEmpty() )
-            {
-              // A description is optional by Cambridge.
-              w->comment += comment;
-            }
-        }
-
-#if 0
-      if( ! w->comment.isEmpty() )
-        {
-          w->comment.append("; ");
-        }
-
-      w->comment.append( "TP attributes: ").append(list[4]);
-      w->comment.append( "; WP-No: ").append(list[0]);
-#endif
+      // A description is optional by Cambridge.
+      w->comment += tokenizer.toString(6);
 
       // We do check, if the waypoint name is already in use because DAT
       // short names are not always unique.
@@ -2705,11 +2430,15 @@ bool WaypointCatalog::readDat(const QString &catalog)
 
       // Store used waypoint name in set.
       names.insert( w->name );
+      counter++;
     }
 
-  file.close();
+  tokenizer.close();
   QApplication::restoreOverrideCursor();
 
+  qDebug( "WaypointCatalog::readDat: %d waypoints read in %dms",
+          counter, t.elapsed() );
+
   onDisc = true;
   path = catalog;
   return true;
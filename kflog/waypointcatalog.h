@@ -132,15 +132,14 @@ public:
 private:
 
   /**
-   * Splits a cup file line into its single elements.
+   * Reads all waypoints of a KFLog waypoint file in the memory mappable
+   * binary format.
    *
-   * \param line Line to be split.
+   * \param catalog Path of the catalog file.
    *
-   * \param ok True if split was ok otherwise false
-   *
-   * \return A list with the splt elements.
+   * \return True if the catalog was read.
    */
-  QList<QString> splitCupLine( QString& line, bool &ok );
+  bool readMappedBinary( const QString& catalog );
 
 public:
 
@@ -19,6 +19,7 @@
 #define _USE_MATH_DEFINES
 #endif
 #include <cmath>
+#include <cstring>
 #ifndef _MSC_VER
 #include <unistd.h>
 #endif
@@ -29,9 +30,11 @@
 #include "basemapelement.h"
 #include "mapcalc.h"
 #include "mapcontents.h"
+#include "mapdefaults.h"
 #include "mapmatrix.h"
 #include "resource.h"
 #include "runway.h"
+#include "sourcecache.h"
 #include "wgspoint.h"
 #include "distance.h"
 
@@ -44,18 +47,27 @@
 // KFLog's configuration settings
 extern QSettings _settings;
 
-// All is prepared for additional calculation, storage and
-// reconstruction of a bounding box. Be free to switch on/off it via
-// conditional define.
+QByteArray Welt2000::c_sourceFingerprint;
+QByteArray Welt2000::c_sourceHash;
 
-#undef BOUNDING_BOX
-// #define BOUNDING_BOX 1
+#define DATA_STREAM QDataStream::Qt_4_7
+
+// general KFLOG file token: @KFL
+#define KFLOG_FILE_MAGIC    0x404b464c
+
+// compiled Welt2000 file
+#define FILE_TYPE_W2000     0x57
+#define FILE_VERSION_W2000  100
+
+// size of a record in the compiled Welt2000 file
+#define W2000_RECORD_SIZE   41
 
 extern MapContents*  _globalMapContents;
 extern MapMatrix*    _globalMapMatrix;
 
 Welt2000::Welt2000() :
-  c_homeRadius(0.0)
+  c_homeRadius(0.0),
+  c_outlandings(true)
 {
   // prepare base mappings of KFLog
   c_baseTypeMap.insert( "IntAirport", BaseMapElement::IntAirport );
@@ -121,53 +133,85 @@ bool Welt2000::load( QList<Airfield>& airfieldList,
   qDebug() << "Welt2000::load";
 
   QString wu = "WELT2000.TXT";
+  QString wc = "WELT2000.TXC";
   QString sd = "/points/";
   QString mapDir = _globalMapContents->getMapRootDirectory();
 
   QString path2File = mapDir + sd + wu;
+  QString compiledFile = mapDir + sd + wc;
 
-  QFileInfo test( path2File );
+  QFile in( path2File );
 
-  if( ! test.exists() )
+  if( ! in.exists() )
     {
       qWarning( "W2000: No Welt2000 file found in the map points directory" );
       return false;
     }
 
-  // parse source file
-  return parse( path2File, airfieldList, gliderfieldList, outlandingList );
-}
+  QByteArray fingerprint = SourceCache<Airfield>::fingerprint( path2File );
 
-/**
- * Parses the passed file in Welt2000 format and put the appropriate
- * entries in the related lists.
- *
- * arg1 path: Full name with path of welt2000 file
- * arg2 airfieldList: All airports have to be stored in this list
- * arg3 gliderfieldList: All gilder fields have to be stored in this list
- * arg4 outlandibgList: All outlanding fields have to be stored in this list, when
- *                      the outlanding option is set in the user configuration
- * returns true (success) or false (error occurred)
- */
-bool Welt2000::parse( QString& path,
-                      QList<Airfield>& airfieldList,
-                      QList<Airfield>& gliderfieldList,
-                      QList<Airfield>& outlandingList )
-{
-  QTime t;
-  t.start();
+  if( ! in.open(QIODevice::ReadOnly) )
+    {
+      qWarning("W2000: Cannot open airfield file %s!", path2File.toLatin1().data());
+      return false;
+    }
 
-  QFile in(path);
+  const qint64 size = in.size();
+  uchar* data = 0;
 
-  if( !in.open(QIODevice::ReadOnly) )
+  loadFilterSettings();
+
+  // The compiled file is only valid for the current source file content and
+  // the current filter settings. The hash of the content is calculated
+  // again only, if the fingerprint of the file has changed.
+  if( fingerprint.isEmpty() || fingerprint != c_sourceFingerprint )
     {
-      qWarning("W2000: Cannot open airfield file %s!", path.toLatin1().data());
+      if( size > 0 )
+        {
+          data = in.map( 0, size );
+        }
+
+      if( data == 0 )
+        {
+          qWarning("W2000: Cannot map airfield file %s!", path2File.toLatin1().data());
+          return false;
+        }
+
+      c_sourceHash =
+        QCryptographicHash::hash( QByteArray::fromRawData( reinterpret_cast<const char *>(data), (int) size ),
+                                  QCryptographicHash::Md5 );
+
+      c_sourceFingerprint = fingerprint;
+    }
+
+  QByteArray key = compiledKey( c_sourceHash );
+
+  if( readCompiledFile( compiledFile, key, airfieldList, gliderfieldList, outlandingList ) )
+    {
+      return true;
+    }
+
+  if( data == 0 && size > 0 )
+    {
+      data = in.map( 0, size );
+    }
+
+  if( data == 0 )
+    {
+      qWarning("W2000: Cannot map airfield file %s!", path2File.toLatin1().data());
       return false;
     }
 
-  QTextStream ins(&in);
-  ins.setCodec( "ISO 8859-15" );
+  // parse source file
+  return parse( reinterpret_cast<const char *>(data), size, compiledFile, key,
+                airfieldList, gliderfieldList, outlandingList );
+}
 
+/**
+ * Loads the filter settings from the KFLog configuration.
+ */
+void Welt2000::loadFilterSettings()
+{
   // Check, if in KFLOg settings other definitions exist. These will
   // overwrite the definitions in the configuration file.
   QString cFilter = _settings.value( "/Welt2000/CountryFilter", "" ).toString();
@@ -195,7 +239,7 @@ bool Welt2000::parse( QString& path,
     }
 
   // get outlanding load flag from configuration data
-  bool outlandings = _settings.value( "/Welt2000/LoadOutlandings", true ).toBool();
+  c_outlandings = _settings.value( "/Welt2000/LoadOutlandings", true ).toBool();
 
   // get home radius from configuration data
   int radius = _settings.value( "/Welt2000/HomeRadius", 0 ).toInt();
@@ -206,6 +250,8 @@ bool Welt2000::parse( QString& path,
       radius = 500;
     }
 
+  c_homeRadius = 0.0;
+
   if( radius > 0 )
     {
       // we must look, what unit the user has chosen. This unit must
@@ -216,33 +262,142 @@ bool Welt2000::parse( QString& path,
   qDebug() << "W2000: Country Filter contains"
            << c_countryList.count()
            << "entries." << c_countryList;
-  qDebug() << "W2000: Read Outlandings=" << outlandings;
+  qDebug() << "W2000: Read Outlandings=" << c_outlandings;
   qDebug( "W2000: Home radius is set to %.1f Km", c_homeRadius );
+}
 
-  // put all entries of country list into a dictionary for faster
-  // access
-  QHash<QString, QString> countryDict;
+/**
+ * Creates the key of the compiled file. The home radius is not part of the
+ * key, it is applied during reading of the compiled file.
+ */
+QByteArray Welt2000::compiledKey( const QByteArray& sourceHash )
+{
+  QByteArray key = sourceHash;
+
+  key += c_countryList.join(",").toLatin1();
+  key += c_outlandings ? "|OL1" : "|OL0";
+
+  QMap<QString, QString>::const_iterator it;
+
+  for( it = c_shortMap.constBegin(); it != c_shortMap.constEnd(); ++it )
+    {
+      key += "|" + it.key().toLatin1() + "=" + it.value().toLatin1();
+    }
+
+  for( it = c_icaoMap.constBegin(); it != c_icaoMap.constEnd(); ++it )
+    {
+      key += "|" + it.key().toLatin1() + "=" + it.value().toLatin1();
+    }
+
+  return QCryptographicHash::hash( key, QCryptographicHash::Md5 );
+}
+
+/**
+ * Converts a fixed column field into an integer. Leading and trailing
+ * spaces are ignored as QString::trimmed().toInt() does it.
+ */
+static bool scanInt( const char* s, int len, int& result )
+{
+  while( len > 0 && *s == ' ' )
+    {
+      s++;
+      len--;
+    }
+
+  while( len > 0 && s[len - 1] == ' ' )
+    {
+      len--;
+    }
+
+  bool negative = false;
+
+  if( len > 0 && (*s == '-' || *s == '+') )
+    {
+      negative = (*s == '-');
+      s++;
+      len--;
+    }
+
+  if( len == 0 )
+    {
+      return false;
+    }
+
+  int value = 0;
+
+  for( int i = 0; i < len; i++ )
+    {
+      if( s[i] < '0' || s[i] > '9' )
+        {
+          return false;
+        }
+
+      value = value * 10 + (s[i] - '0');
+    }
+
+  result = negative ? -value : value;
+  return true;
+}
+
+/**
+ * Returns the index cell of a KFLog coordinate. A cell covers one degree.
+ */
+static inline qint16 cellOf( const qint32 coord )
+{
+  return static_cast<qint16> (floor( coord / 600000.0 ));
+}
+
+/**
+ * Parses the passed buffer in Welt2000 format and put the appropriate
+ * entries in the related lists.
+ *
+ * arg1 data: Memory mapped content of the welt2000 file
+ * arg2 size: Size of the mapped content
+ * arg3 compiledPath: Full name with path of the compiled file
+ * arg4 key: Key to be stored in the compiled file
+ * arg5 airfieldList: All airports have to be stored in this list
+ * arg6 gliderfieldList: All gilder fields have to be stored in this list
+ * arg7 outlandibgList: All outlanding fields have to be stored in this list, when
+ *                      the outlanding option is set in the user configuration
+ * returns true (success) or false (error occurred)
+ */
+bool Welt2000::parse( const char* data,
+                      const qint64 size,
+                      const QString& compiledPath,
+                      const QByteArray& key,
+                      QList<Airfield>& airfieldList,
+                      QList<Airfield>& gliderfieldList,
+                      QList<Airfield>& outlandingList )
+{
+  QTime t;
+  t.start();
+
+  QTextCodec* codec = QTextCodec::codecForName( "ISO 8859-15" );
+
+  // put all entries of country list into a set of two letter codes for
+  // faster access
+  QSet<quint16> countrySet;
 
   for( int i = 0; i < c_countryList.count(); i++ )
     {
-      // populate country dictionary
-      countryDict.insert( c_countryList[i], c_countryList[i] );
+      QByteArray c = c_countryList[i].toLatin1();
+
+      if( c.size() == 2 )
+        {
+          countrySet.insert( (uchar(c[0]) << 8) | uchar(c[1]) );
+        }
     }
 
-#ifdef BOUNDING_BOX
-  QRect boundingBox;
-#endif
+  const bool useCountryFilter = ! c_countryList.isEmpty();
 
   uint lineNo = 0;
-  QSet<QString> shortNameSet; // contains all short names already in use
 
   // Contains the coordinates of the objects put in the lists. Used as filter
   // to avoid multiple entries at the same point.
-  QSet<QString> pointFilter;
+  QSet<qint64> pointFilter;
 
-  // statistics counter
-  uint ul, gl, af, ol;
-  ul = gl = af = ol = 0;
+  QVector<Record> records;
+  QByteArray strings;
 
   // Input file was taken from Michael Meiers Welt2000 data dase
   //
@@ -269,106 +424,154 @@ bool Welt2000::parse( QString& path,
   // DAMGA2 DAMGARTEN CLS   *   !C200072512150   5N541551E0122640DEE0
   // PIEVE2 PIEVERSTORF 25M *AGR!A 3208261      27N534906E0110841DEX0
 
-  while( ! in.atEnd() )
+  const char* cur = data;
+  const char* end = data + size;
+
+  while( cur < end )
     {
-      bool ok, ok1;
-      QString line, buf;
-      line = in.readLine(128);
+      const char* eol = static_cast<const char *> (memchr( cur, '\n', end - cur ));
+
+      if( eol == 0 )
+        {
+          eol = end;
+        }
+
+      const char* raw = cur;
+      int rawLen = eol - cur;
+      cur = eol + 1;
       lineNo++;
 
-      if( line.isEmpty() )
+      if( rawLen == 0 )
         {
           continue;
         }
 
       // step over comment or invalid lines
-      if( line.startsWith("#") || line.startsWith("$") ||
-          line.startsWith("\t") || line.startsWith(" ") )
+      if( raw[0] == '#' || raw[0] == '$' || raw[0] == '\t' || raw[0] == ' ' )
         {
           continue;
         }
 
       // remove white spaces and line end characters
-      line = line.trimmed();
+      while( rawLen > 0 && uchar(raw[rawLen - 1]) <= ' ' )
+        {
+          rawLen--;
+        }
 
-      // replace markers against space
-      line.replace( QRegExp("[!?]+"), " " );
+      // Copy the line into a fixed buffer. Markers are replaced against
+      // space and all is converted to upper case.
+      char line[128];
+      int len = 0;
+      bool inMarker = false;
 
-      if( line.length() < 62 )
+      for( int i = 0; i < rawLen && len < (int) sizeof(line); i++ )
         {
-          // country sign not included
-          continue;
-        }
+          char c = raw[i];
 
-      // get short name for user mapping before changing line
-      QString shortName = line.mid( 0, 6 );
+          if( c == '!' || c == '?' )
+            {
+              if( inMarker == false )
+                {
+                  line[len++] = ' ';
+                  inMarker = true;
+                }
 
-      // convert all to toUpper case
-      line = line.toUpper();
+              continue;
+            }
 
-      // Extract country sign. It is coded according to ISO 3166.
-      QString country = line.mid( 60, 2 ).toUpper();
+          inMarker = false;
 
-      if( ! countryDict.isEmpty() )
-        {
-          if( ! countryDict.contains(country) )
+          if( c >= 'a' && c <= 'z' )
             {
-              continue;
+              c -= 'a' - 'A';
             }
+
+          line[len++] = c;
+        }
+
+      if( len < 62 )
+        {
+          // country sign not included
+          continue;
+        }
+
+      // Extract country sign. It is coded according to ISO 3166.
+      if( useCountryFilter &&
+          ! countrySet.contains( (uchar(line[60]) << 8) | uchar(line[61]) ) )
+        {
+          continue;
         }
 
       // look, what kind of line was read.
       // COL5 = 1 Airfield or also UL site
       // COL5 = 2 Outlanding, contains also UL places
-      QString kind = line.mid( 5, 1 );
+      const char kind = line[5];
 
-      if( kind != "1" && kind != "2" )
+      if( kind != '1' && kind != '2' )
         {
           continue; // not of interest for us
         }
 
+      Record rec;
+      memset( &rec, 0, sizeof(rec) );
+      memset( rec.icao, ' ', sizeof(rec.icao) );
+      memset( rec.flNo, ' ', sizeof(rec.flNo) );
+      rec.country[0] = line[60];
+      rec.country[1] = line[61];
+      rec.seq = lineNo;
+
       bool ulField = false;
       bool glField = false;
       bool afField = false;
       bool olField = false;
 
-      QString commentShort;
-      QString commentLong;
-      QString icao;
-
-      if( kind == "2" ) // can be an UL field
+      if( kind == '2' ) // can be an UL field
         {
-          if( line.mid( 23, 4 ) == "*ULM" )
+          if( memcmp( line + 23, "*ULM", 4 ) == 0 )
             {
               ulField = true;
             }
           else
             {
               // outlanding found
-              if( outlandings == false )
+              if( c_outlandings == false )
                 {
                   // ignore outlandings
                   continue;
                 }
 
               olField = true;
-              commentShort = line.mid( 24, 4 );
-              commentShort.replace(QRegExp("[!?]+"), " " );
-              commentShort = commentShort.toUpper().trimmed();
 
-              if( commentShort.startsWith( "FL" ) )
+              // The trimmed short comment can contain an emergency field number.
+              int cs = 24, ce = 28;
+
+              while( cs < ce && line[cs] == ' ' )
+                {
+                  cs++;
+                }
+
+              while( ce > cs && line[ce - 1] == ' ' )
+                {
+                  ce--;
+                }
+
+              if( ce - cs >= 2 && line[cs] == 'F' && line[cs + 1] == 'L' )
                 {
-                  commentLong = QString( QObject::tr("Emergency Field No: ")) +
-                                commentShort.mid( 2, 2 );
+                  rec.flags |= 1;
+
+                  for( int i = 0; i < 2 && cs + 2 + i < ce; i++ )
+                    {
+                      rec.flNo[i] = line[cs + 2 + i];
+                    }
                 }
             }
         }
-      else if( line.mid( 23, 4 ) == "#GLD" )
+      else if( memcmp( line + 23, "#GLD", 4 ) == 0 )
         {
           // Glider field
           glField = true;
         }
-      else if( line.mid( 23, 5 ) == "# ULM" )
+      else if( memcmp( line + 23, "# ULM", 5 ) == 0 )
         {
           // newer coding for UL field
           ulField = true;
@@ -376,25 +579,29 @@ bool Welt2000::parse( QString& path,
       else
         {
           afField = true;
-          icao = line.mid( 24, 4 ).trimmed().toUpper();
+          memcpy( rec.icao, line + 24, 4 );
 
-          if( line.mid( 20, 4 ) == "GLD#" )
+          if( memcmp( line + 20, "GLD#", 4 ) == 0 )
             {
               // other possibility for a glider field with ICAO code
               glField = true;
             }
         }
 
-      // Airfield name
-      QString afName = line.mid( 7, 16 );
+      // Airfield name, determine its trimmed range
+      int ns = 7, ne = 23;
 
-      // remove special mark signs
-      afName.replace( QRegExp("[!?]+"), "" );
+      while( ns < ne && line[ns] == ' ' )
+        {
+          ns++;
+        }
 
-      // remove resp. replace white spaces against one space
-      afName = afName.simplified();
+      while( ne > ns && line[ne - 1] == ' ' )
+        {
+          ne--;
+        }
 
-      if( afName.length() == 0 )
+      if( ns == ne )
         {
           qWarning( "W2000, Line %d: Airfield name is undefined, ignoring entry!",
                     lineNo );
@@ -419,17 +626,25 @@ bool Welt2000::parse( QString& path,
         }
       else if( afField == true )
         {
-          if( icao.startsWith("ET") )
+          // The ICAO identifier is left aligned in its field.
+          int is = 0;
+
+          while( is < 4 && rec.icao[is] == ' ' )
+            {
+              is++;
+            }
+
+          if( is <= 2 && rec.icao[is] == 'E' && rec.icao[is + 1] == 'T' )
             {
               // German military airport
               afType = BaseMapElement::MilAirport;
             }
-          else if( afName.contains(QRegExp(" MIL$")) )
+          else if( ne - ns > 4 && memcmp( line + ne - 4, " MIL", 4 ) == 0 )
             {
               // should be an military airport but not 100% sure
               afType = BaseMapElement::MilAirport;
             }
-          else if( icao.startsWith("EDD") )
+          else if( is <= 1 && memcmp( rec.icao + is, "EDD", 3 ) == 0 )
             {
               // German international airport
               afType = BaseMapElement::IntAirport;
@@ -441,256 +656,155 @@ bool Welt2000::parse( QString& path,
         }
 
       // make the user's desired mapping for short name
-      if( c_shortMap.contains(shortName) )
+      if( ! c_shortMap.isEmpty() )
         {
-          QString val = c_shortMap[shortName];
+          // get short name from the original line
+          QString shortName = QString::fromLatin1( raw, qMin( rawLen, 6 ) );
 
-          if( c_baseTypeMap.contains(val) )
+          if( c_shortMap.contains(shortName) )
             {
-              afType = c_baseTypeMap[val];
+              QString val = c_shortMap[shortName];
+
+              if( c_baseTypeMap.contains(val) )
+                {
+                  afType = c_baseTypeMap[val];
+                }
             }
         }
 
       // make the user's wanted mapping for icao
-      if( ! icao.isEmpty() && c_icaoMap.contains(icao) )
+      if( afField && ! c_icaoMap.isEmpty() )
         {
-          QString val = c_icaoMap[icao];
+          QString icao = QString::fromLatin1( rec.icao, 4 ).trimmed();
 
-          if( c_baseTypeMap.contains(val) )
+          if( ! icao.isEmpty() && c_icaoMap.contains(icao) )
             {
-              afType = c_baseTypeMap[val];
-            }
-        }
-
-      // airfield name
-      afName = afName.toLower();
+              QString val = c_icaoMap[icao];
 
-      QChar lastChar(' ');
-
-      // convert airfield names to upper-lower
-      for( int i=0; i < afName.length(); i++ )
-        {
-          if( lastChar == ' ' )
-            {
-              afName.replace( i, 1, afName.mid(i,1).toUpper() );
-            }
-
-          lastChar = afName[i];
-        }
-
-      // gps name, we use 8 characters without spaces
-      QString gpsName = afName;
-      gpsName.remove(QChar(' '));
-      gpsName = gpsName.left(8);
-
-      if( ! shortNameSet.contains( gpsName) )
-        {
-          shortNameSet.insert( gpsName );
-        }
-      else
-        {
-          // Try to generate an unique short name. The assumption is that we never have
-          // more than 10 equal names.
-          for( int i=0; i <= 9; i++ )
-            {
-              gpsName.replace( gpsName.length()-1, 1, QString::number(i) );
-
-              if( ! shortNameSet.contains( gpsName) )
+              if( c_baseTypeMap.contains(val) )
                 {
-                  shortNameSet.insert( gpsName );
-                  break;
+                  afType = c_baseTypeMap[val];
                 }
             }
         }
 
-      if( ulField  )
-        {
-          if( afName.right(3) == " Ul" )
-            {
-              // Convert lower l of Ul to upper case
-              afName.replace( afName.length()-1, 1, "L" );
-            }
-          else
-            {
-              // append UL substring
-              // afName += " UL";
-            }
-        }
-
-      qint32 lat, lon;
-      QString degree, min, sec;
-      double d, m, s;
-
-      // convert latitude
-      degree = line.mid(46,2);
-      min    = line.mid(48,2);
-      sec    = line.mid(50,2);
-
-      d = degree.toDouble(&ok);
-
-      if( ! ok )
-        {
-          qWarning( "W2000, Line %d: %s (%s) wrong latitude degree value, ignoring entry!",
-                    lineNo, afName.toLatin1().data(), country.toLatin1().data() );
-          continue;
-        }
-
-      m = min.toDouble(&ok);
-
-      if( ! ok )
-        {
-          qWarning( "W2000, Line %d: %s (%s) wrong latitude minute value, ignoring entry!",
-                    lineNo, afName.toLatin1().data(), country.toLatin1().data() );
-          continue;
-        }
+      rec.type = static_cast<quint8> (afType);
 
-      s = sec.toDouble(&ok);
+      int d, m, s;
+      bool ok = scanInt( line + 46, 2, d ) && scanInt( line + 48, 2, m ) &&
+                scanInt( line + 50, 2, s );
 
       if( ! ok )
         {
-          qWarning( "W2000, Line %d: %s (%s) wrong latitude second value, ignoring entry!",
-                    lineNo, afName.toLatin1().data(), country.toLatin1().data() );
+          qWarning( "W2000, Line %d: %.16s (%.2s) wrong latitude value, ignoring entry!",
+                    lineNo, line + 7, line + 60 );
           continue;
         }
 
-      double latTmp = (d * 600000.) + (10000. * (m + s / 60. ));
-
-      lat = (qint32) rint(latTmp);
+      rec.lat = (qint32) rint( (d * 600000.) + (10000. * (m + s / 60. )) );
 
       if( line[45] == 'S' )
         {
-          lat = -lat;
-        }
-
-      // convert longitude
-      degree = line.mid(53,3);
-      min    = line.mid(56,2);
-      sec    = line.mid(58,2);
-
-      d = degree.toDouble(&ok);
-
-      if( ! ok )
-        {
-          qWarning( "W2000, Line %d: %s (%s) wrong longitude degree value, ignoring entry!",
-                    lineNo, afName.toLatin1().data(), country.toLatin1().data() );
-          continue;
+          rec.lat = -rec.lat;
         }
 
-      m = min.toDouble(&ok);
+      ok = scanInt( line + 53, 3, d ) && scanInt( line + 56, 2, m ) &&
+           scanInt( line + 58, 2, s );
 
       if( ! ok )
         {
-          qWarning( "W2000, Line %d: %s (%s) wrong longitude minute value, ignoring entry!",
-                    lineNo, afName.toLatin1().data(), country.toLatin1().data() );
+          qWarning( "W2000, Line %d: %.16s (%.2s) wrong longitude value, ignoring entry!",
+                    lineNo, line + 7, line + 60 );
           continue;
         }
 
-      s = sec.toDouble(&ok);
-
-      if( ! ok )
-        {
-          qWarning( "W2000, Line %d: %s (%s) wrong longitude second value, ignoring entry!",
-                    lineNo, afName.toLatin1().data(), country.toLatin1().data() );
-          continue;
-        }
-
-      double lonTmp = (d * 600000.) + (10000. * (m + s / 60. ));
-
-      lon = (qint32) rint(lonTmp);
+      rec.lon = (qint32) rint( (d * 600000.) + (10000. * (m + s / 60. )) );
 
       if( line[52] == 'W' )
         {
-          lon = -lon;
-        }
-
-      if( c_homeRadius > 0 )
-        {
-          // Compute the distance between the home position and the
-          // read point, if a radius is defined. Is the distance is greater
-          // than as the user defined value we skip this point.
-
-          QPoint home = _globalMapMatrix->getHomeCoord();
-          QPoint af( lat, lon );
-
-          double d = dist( &home, &af );
-
-          if( d > c_homeRadius )
-            {
-              // Distance is greater than defined radius in GeneralConfig
-              // qDebug("Ignoring Dist=%f, AF=%s", d, afName.toLatin1().data());
-              continue;
-            }
+          rec.lon = -rec.lon;
         }
 
-#ifdef BOUNDING_BOX
-      // update the bounding box
-      _globalMapContents->AddPointToRect( boundingBox, QPoint(lat, lon) );
-#endif
-
-      WGSPoint wgsPos(lat, lon);
-
       // We do check here, if the coordinates of the object are already known to
       // filter out multiple entries. Only the first entry do pass the filter.
-      QString corrString = WGSPoint::coordinateString( wgsPos );
+      qint64 coordKey = (qint64(rec.lat) << 32) | quint32(rec.lon);
 
-      if( pointFilter.contains( corrString ) )
+      if( pointFilter.contains( coordKey ) )
         {
           // An object with the same coordinates do already exist.
           // We do ignore this one.
-          qWarning( "W2000, Line %d: %s (%s) skipping entry, coordinates already in use!",
-                    lineNo, afName.toLatin1().data(), country.toLatin1().data() );
+          qWarning( "W2000, Line %d: %.16s (%.2s) skipping entry, coordinates already in use!",
+                    lineNo, line + 7, line + 60 );
           continue;
         }
 
       // store coordinates in filter
-      pointFilter.insert( corrString );
-
-      QPoint position = _globalMapMatrix->wgsToMap(wgsPos);
+      pointFilter.insert( coordKey );
 
       // elevation
-      buf = line.mid(41,4 ).trimmed();
+      int elevation = 0;
+
+      if( ! scanInt( line + 41, 4, elevation ) )
+        {
+          qWarning( "W2000, Line %d: %.16s (%.2s) missing or wrong elevation, set value to 0!",
+                    lineNo, line + 7, line + 60 );
+          elevation = 0;
+        }
+
+      rec.elevation = static_cast<qint16> (elevation);
 
-      ok = false;
-      qint16 elevation = 0;
+      // frequency, coded as MHz in three columns and the decimals in two
+      // columns
+      int mhz = 0, decimals = 0;
+      int ds = 39, de = 41;
 
-      if( ! buf.isEmpty() )
+      while( ds < de && line[ds] == ' ' )
         {
-          elevation = buf.toInt(&ok);
+          ds++;
         }
 
-      if( ! ok )
+      while( de > ds && line[de - 1] == ' ' )
         {
-          qWarning( "W2000, Line %d: %s (%s) missing or wrong elevation, set value to 0!",
-                    lineNo, afName.toLatin1().data(), country.toLatin1().data() );
-          elevation = 0;
+          de--;
         }
 
-      // frequency
-      QString frequency = line.mid(36,3) + "." + line.mid(39,2).trimmed();
+      int khz = -1;
 
-      float fFrequency = frequency.toFloat(&ok);
+      if( scanInt( line + 36, 3, mhz ) )
+        {
+          if( ds == de )
+            {
+              khz = mhz * 1000;
+            }
+          else if( line[ds] != '-' && line[ds] != '+' &&
+                   scanInt( line + ds, de - ds, decimals ) )
+            {
+              khz = mhz * 1000 + decimals * (de - ds == 1 ? 100 : 10);
+            }
+        }
 
-      if( ( !ok || fFrequency < 108 || fFrequency > 137.0 ) )
+      if( khz < 108000 || khz > 137000 )
         {
           if( olField == false )
             {
               // Don't display warnings for outlandings
-              qWarning( "W2000, Line %d: %s (%s) missing or wrong frequency, set value to 0!",
-                        lineNo, afName.toLatin1().data(), country.toLatin1().data() );
+              qWarning( "W2000, Line %d: %.16s (%.2s) missing or wrong frequency, set value to 0!",
+                        lineNo, line + 7, line + 60 );
             }
 
-          fFrequency = 0.0; // reset frequency to unknown
+          khz = 0; // reset frequency to unknown
         }
       else
         {
-          // check, what has to be appended as last digit
           // check, what has to be appended as last digit
           if( line[40] == '2' || line[40] == '7' )
             {
-              fFrequency += 0.005;
+              khz += 5;
             }
         }
 
+      rec.frequency = khz;
+
       /* Runway description from Welt2000.txt file
        *
        * A: 08/26 MEANS THAT THERE IS ONLY ONE RUNWAYS 08 AND (26=08 + 18)
@@ -701,159 +815,540 @@ bool Welt2000::parse( QString& path,
        */
 
       // runway direction have two digits, we consider both directions
-      buf = line.mid(32,2).trimmed();
-
-      ok = false;
-      ok1 = false;
-
-      ushort rwDir1 = 0;
-      ushort rwDir2 = 0;
-      ushort rwCount = 0;
-
-      QPair<ushort, ushort> rwDirections[2];
-      rwDirections[0] = QPair<ushort, ushort>( 0, 0);
-      rwDirections[1] = QPair<ushort, ushort>( 0, 0);
-
-      if( ! buf.isEmpty() )
-        {
-          rwDir1 = buf.toUShort(&ok);
-        }
+      int rwDir1 = 0;
+      int rwDir2 = 0;
 
-      // extract second direction
-      buf = line.mid(34,2).trimmed();
-
-      if( ! buf.isEmpty() )
-        {
-          rwDir2 = buf.toUShort(&ok1);
-        }
+      ok = scanInt( line + 32, 2, rwDir1 ) && scanInt( line + 34, 2, rwDir2 );
 
-      if( ! ok || ! ok1 || rwDir1 < 1 || rwDir1 > 36 || rwDir2 < 1 || rwDir2 > 36 )
+      if( ! ok || rwDir1 < 1 || rwDir1 > 36 || rwDir2 < 1 || rwDir2 > 36 )
         {
-          qWarning( "W2000, Line %d: %s (%s) missing or wrong runway direction, set value to 0!",
-                    lineNo, afName.toLatin1().data(), country.toLatin1().data() );
+          qWarning( "W2000, Line %d: %.16s (%.2s) missing or wrong runway direction, set value to 0!",
+                    lineNo, line + 7, line + 60 );
         }
       else
         {
           if( rwDir1 == rwDir2 || abs( rwDir1 - rwDir2 ) == 18 )
             {
               // We have only one runway
-              rwDirections[0].first  = rwDir1;
-              rwDirections[0].second = rwDir2;
-              rwCount = 1;
+              rec.rwDir[0] = rwDir1;
+              rec.rwDir[1] = rwDir2;
+              rec.rwCount = 1;
             }
           else
             {
               // WE have two runways
-              rwDirections[0].first  = rwDir1;
-              rwDirections[0].second = ((rwDir1 > 18) ? rwDir1 - 18 : rwDir1 + 18 );
-              rwDirections[1].first  = rwDir2;
-              rwDirections[1].second = ((rwDir2 > 18) ? rwDir2 - 18 : rwDir2 + 18 );
-              rwCount = 2;
+              rec.rwDir[0] = rwDir1;
+              rec.rwDir[1] = ((rwDir1 > 18) ? rwDir1 - 18 : rwDir1 + 18 );
+              rec.rwDir[2] = rwDir2;
+              rec.rwDir[3] = ((rwDir2 > 18) ? rwDir2 - 18 : rwDir2 + 18 );
+              rec.rwCount = 2;
             }
         }
 
       // runway length in meters, must be multiplied by 10
-      buf = line.mid(29,3).trimmed();
+      int rwLen = 0;
 
-      ok = false;
-      ushort rwLen = 0;
+      if( ! scanInt( line + 29, 3, rwLen ) || rwLen < 0 )
+        {
+          qWarning( "W2000, Line %d: %.16s (%.2s) missing or wrong runway length, set value to 0!",
+                    lineNo, line + 7, line + 60 );
+          rwLen = 0;
+        }
 
-      if( ! buf.isEmpty() )
+      rec.rwLength = rwLen * 10;
+
+      // runway surface
+      switch( line[28] )
         {
-          rwLen = buf.toUInt(&ok);
+          case 'A':
+            rec.rwSurface = Runway::Asphalt;
+            break;
+          case 'C':
+            rec.rwSurface = Runway::Concrete;
+            break;
+          case 'G':
+            rec.rwSurface = Runway::Grass;
+            break;
+          case 'S':
+            rec.rwSurface = Runway::Sand;
+            break;
+          default:
+            rec.rwSurface = Runway::Unknown;
+            break;
         }
 
-      if( ! ok )
+      // Airfield name, only the accepted entries are converted into a string.
+      QString afName = codec ? codec->toUnicode( line + ns, ne - ns )
+                             : QString::fromLatin1( line + ns, ne - ns );
+
+      // replace white spaces against one space
+      afName = afName.simplified().toLower();
+
+      QChar lastChar(' ');
+
+      // convert airfield names to upper-lower
+      for( int i=0; i < afName.length(); i++ )
         {
-          qWarning( "W2000, Line %d: %s (%s) missing or wrong runway length, set value to 0!",
-                    lineNo, afName.toLatin1().data(), country.toLatin1().data() );
-          rwLen = 0;
+          if( lastChar == ' ' )
+            {
+              afName[i] = afName[i].toUpper();
+            }
+
+          lastChar = afName[i];
         }
-      else
+
+      if( ulField && afName.right(3) == " Ul" )
         {
-          rwLen *= 10;
+          // Convert lower l of Ul to upper case
+          afName.replace( afName.length()-1, 1, "L" );
         }
 
-      // runway surface
-      enum Runway::SurfaceType rwSurface;
-      QChar rwType = line[28];
+      QByteArray name = afName.toUtf8();
+
+      rec.nameOffset = strings.size();
+      rec.nameLength = qMin( name.size(), 255 );
+      strings.append( name.constData(), rec.nameLength );
+
+      records.append( rec );
+    }
+
+  int parseTime = t.elapsed();
+
+  // Group the records by their index cells. The stable sort keeps the
+  // source file order inside of a cell.
+  QVector<Record> sorted;
+  QVector<Cell> cells;
+  QMap<qint32, QVector<int> > cellMap;
+
+  for( int i = 0; i < records.size(); i++ )
+    {
+      qint32 cellKey = (qint32(cellOf(records[i].lat)) << 16) |
+                       quint16(cellOf(records[i].lon));
+
+      cellMap[cellKey].append( i );
+    }
+
+  sorted.reserve( records.size() );
+
+  QMap<qint32, QVector<int> >::const_iterator it;
+
+  for( it = cellMap.constBegin(); it != cellMap.constEnd(); ++it )
+    {
+      const QVector<int>& members = it.value();
 
-      if( rwType == 'A' )
+      Cell cell;
+      cell.lat   = cellOf( records[members.first()].lat );
+      cell.lon   = cellOf( records[members.first()].lon );
+      cell.first = sorted.size();
+      cell.count = members.size();
+      cells.append( cell );
+
+      for( int i = 0; i < members.size(); i++ )
         {
-          rwSurface = Runway::Asphalt;
+          sorted.append( records[members[i]] );
         }
-      else if( rwType == 'C' )
+    }
+
+  writeCompiledFile( compiledPath, key, sorted, cells, strings );
+
+  qDebug( "W2000, Statistics from file %s: Parsing Time=%dms, Sum=%d, Cells=%d",
+          basename(compiledPath.toLatin1().data()), parseTime, records.size(), cells.size() );
+
+  appendRecords( records, strings.constData(),
+                 airfieldList, gliderfieldList, outlandingList );
+
+  return true;
+}
+
+/**
+ * Writes the parsed records sorted by their index cells into the compiled
+ * file. The file is written under a temporary name and renamed at the end
+ * to avoid a partial file in case of an error.
+ */
+bool Welt2000::writeCompiledFile( const QString& compiledPath,
+                                  const QByteArray& key,
+                                  const QVector<Record>& records,
+                                  const QVector<Cell>& cells,
+                                  const QByteArray& strings )
+{
+  QString tmpPath = compiledPath + ".tmp";
+
+  QFile f( tmpPath );
+
+  if( ! f.open( QIODevice::WriteOnly ) )
+    {
+      qWarning( "W2000: Cannot open compiled file %s for writing!",
+                tmpPath.toLatin1().data() );
+      return false;
+    }
+
+  QDataStream out( &f );
+  out.setVersion( DATA_STREAM );
+
+  out << quint32( KFLOG_FILE_MAGIC );
+  out << qint8( FILE_TYPE_W2000 );
+  out << quint16( FILE_VERSION_W2000 );
+  out << key;
+  out << quint32( records.size() );
+  out << quint32( cells.size() );
+  out << quint32( strings.size() );
+
+  for( int i = 0; i < cells.size(); i++ )
+    {
+      const Cell& c = cells[i];
+      out << c.lat << c.lon << c.first << c.count;
+    }
+
+  for( int i = 0; i < records.size(); i++ )
+    {
+      const Record& r = records[i];
+
+      out << r.lat << r.lon << r.seq << r.nameOffset << r.nameLength;
+      out.writeRawData( r.icao, sizeof(r.icao) );
+      out.writeRawData( r.country, sizeof(r.country) );
+      out.writeRawData( r.flNo, sizeof(r.flNo) );
+      out << r.flags << r.type << r.elevation << r.frequency
+          << r.rwLength << r.rwSurface << r.rwCount;
+      out.writeRawData( reinterpret_cast<const char *>(r.rwDir), sizeof(r.rwDir) );
+    }
+
+  out.writeRawData( strings.constData(), strings.size() );
+
+  bool ok = (out.status() == QDataStream::Ok);
+
+  f.close();
+
+  if( ! ok )
+    {
+      qWarning( "W2000: Cannot write compiled file %s!",
+                tmpPath.toLatin1().data() );
+      f.remove();
+      return false;
+    }
+
+  QFile::remove( compiledPath );
+
+  return QFile::rename( tmpPath, compiledPath );
+}
+
+/**
+ * Checks, if the one degree cell range [c, c+1] overlaps the passed
+ * longitude range. The range can cross the date line.
+ */
+static bool lonCellInRange( const qint16 c, const double min, const double max )
+{
+  for( int shift = -360; shift <= 360; shift += 360 )
+    {
+      if( c + shift + 1 >= min && c + shift <= max )
         {
-          rwSurface = Runway::Concrete;
+          return true;
         }
-      else if( rwType == 'G' )
+    }
+
+  return false;
+}
+
+/**
+ * Reads the compiled file, if its key matches the passed one. Only the
+ * index cells touched by the home radius are read.
+ */
+bool Welt2000::readCompiledFile( const QString& compiledPath,
+                                 const QByteArray& key,
+                                 QList<Airfield>& airfieldList,
+                                 QList<Airfield>& gliderfieldList,
+                                 QList<Airfield>& outlandingList )
+{
+  QTime t;
+  t.start();
+
+  QFile f( compiledPath );
+
+  if( ! f.exists() || ! f.open( QIODevice::ReadOnly ) )
+    {
+      return false;
+    }
+
+  const qint64 size = f.size();
+  uchar* data = 0;
+
+  if( size > 0 )
+    {
+      data = f.map( 0, size );
+    }
+
+  if( data == 0 )
+    {
+      return false;
+    }
+
+  QByteArray raw = QByteArray::fromRawData( reinterpret_cast<const char *>(data), (int) size );
+  QBuffer buffer( &raw );
+  buffer.open( QIODevice::ReadOnly );
+
+  QDataStream in( &buffer );
+  in.setVersion( DATA_STREAM );
+
+  quint32 magic = 0;
+  qint8 type = 0;
+  quint16 version = 0;
+  QByteArray fileKey;
+
+  in >> magic >> type >> version;
+
+  if( magic != KFLOG_FILE_MAGIC || type != FILE_TYPE_W2000 ||
+      version != FILE_VERSION_W2000 )
+    {
+      qDebug() << "W2000: Compiled file has wrong format, recompiling";
+      return false;
+    }
+
+  in >> fileKey;
+
+  if( fileKey != key )
+    {
+      qDebug() << "W2000: Source file or filter changed, recompiling";
+      return false;
+    }
+
+  quint32 nRecords = 0, nCells = 0, nStrings = 0;
+
+  in >> nRecords >> nCells >> nStrings;
+
+  QVector<Cell> cells( nCells );
+
+  for( uint i = 0; i < nCells; i++ )
+    {
+      Cell& c = cells[i];
+      in >> c.lat >> c.lon >> c.first >> c.count;
+    }
+
+  const qint64 recordsStart = buffer.pos();
+  const qint64 stringsStart = recordsStart + qint64(nRecords) * W2000_RECORD_SIZE;
+
+  if( in.status() != QDataStream::Ok || stringsStart + nStrings > size )
+    {
+      qWarning( "W2000: Compiled file %s is corrupted!",
+                compiledPath.toLatin1().data() );
+      return false;
+    }
+
+  // Determine the cell range touched by the home radius.
+  double minLat = -90.0, maxLat = 90.0, minLon = -180.0, maxLon = 180.0;
+
+  if( c_homeRadius > 0 )
+    {
+      QPoint home = _globalMapMatrix->getHomeCoord();
+
+      double homeLat = home.x() / 600000.0;
+      double homeLon = home.y() / 600000.0;
+      double dLat = c_homeRadius * 1000.0 / RADIUS * 180.0 / M_PI;
+
+      minLat = homeLat - dLat;
+      maxLat = homeLat + dLat;
+
+      if( minLat > -90.0 && maxLat < 90.0 )
         {
-          rwSurface = Runway::Grass;
+          double cosLat = cos( qMax( fabs(minLat), fabs(maxLat) ) * M_PI / 180.0 );
+          double dLon = dLat / cosLat;
+
+          if( dLon < 180.0 )
+            {
+              minLon = homeLon - dLon;
+              maxLon = homeLon + dLon;
+            }
         }
-      else if( rwType == 'S' )
+    }
+
+  QVector<Record> records;
+  uint usedCells = 0;
+
+  for( uint i = 0; i < nCells; i++ )
+    {
+      const Cell& c = cells[i];
+
+      if( c.lat + 1 < minLat || c.lat > maxLat ||
+          lonCellInRange( c.lon, minLon, maxLon ) == false )
         {
-          rwSurface = Runway::Sand;
+          continue;
         }
-      else
+
+      usedCells++;
+      buffer.seek( recordsStart + qint64(c.first) * W2000_RECORD_SIZE );
+
+      for( uint j = 0; j < c.count; j++ )
         {
-          rwSurface = Runway::Unknown;
+          Record r;
+
+          in >> r.lat >> r.lon >> r.seq >> r.nameOffset >> r.nameLength;
+          in.readRawData( r.icao, sizeof(r.icao) );
+          in.readRawData( r.country, sizeof(r.country) );
+          in.readRawData( r.flNo, sizeof(r.flNo) );
+          in >> r.flags >> r.type >> r.elevation >> r.frequency
+             >> r.rwLength >> r.rwSurface >> r.rwCount;
+          in.readRawData( reinterpret_cast<char *>(r.rwDir), sizeof(r.rwDir) );
+
+          if( r.nameOffset + r.nameLength > nStrings || r.rwCount > 2 )
+            {
+              qWarning( "W2000: Compiled file %s is corrupted!",
+                        compiledPath.toLatin1().data() );
+              return false;
+            }
+
+          records.append( r );
         }
+    }
+
+  if( in.status() != QDataStream::Ok )
+    {
+      qWarning( "W2000: Compiled file %s is corrupted!",
+                compiledPath.toLatin1().data() );
+      return false;
+    }
+
+  appendRecords( records, reinterpret_cast<const char *>(data) + stringsStart,
+                 airfieldList, gliderfieldList, outlandingList );
+
+  qDebug( "W2000: %d of %d cells read from compiled file %s in %dms",
+          usedCells, nCells, basename(compiledPath.toLatin1().data()), t.elapsed() );
+
+  return true;
+}
+
+bool Welt2000::seqLessThan( const Record& r1, const Record& r2 )
+{
+  return r1.seq < r2.seq;
+}
+
+/**
+ * Applies the home radius filter to the records, creates the airfield
+ * objects in source file order and appends them to the related lists.
+ */
+void Welt2000::appendRecords( QVector<Record>& records,
+                              const char* strings,
+                              QList<Airfield>& airfieldList,
+                              QList<Airfield>& gliderfieldList,
+                              QList<Airfield>& outlandingList )
+{
+  // The generation of unique short names depends on the source file order.
+  qSort( records.begin(), records.end(), seqLessThan );
+
+  QPoint home = _globalMapMatrix->getHomeCoord();
+
+  QSet<QString> shortNameSet; // contains all short names already in use
+
+  // statistics counter
+  uint ul, gl, af, ol;
+  ul = gl = af = ol = 0;
 
-      //---------------------------------------------------------------
-      // append a new record to the related list
-      //---------------------------------------------------------------
+  for( int n = 0; n < records.size(); n++ )
+    {
+      const Record& r = records[n];
 
-      // count output records separated by kind
-      if( ulField )
+      if( c_homeRadius > 0 )
         {
-          ul++;
+          // Compute the distance between the home position and the
+          // read point, if a radius is defined. Is the distance is greater
+          // than as the user defined value we skip this point.
+          QPoint afPos( r.lat, r.lon );
+
+          if( dist( &home, &afPos ) > c_homeRadius )
+            {
+              continue;
+            }
         }
-      else if( glField )
+
+      QString afName = QString::fromUtf8( strings + r.nameOffset, r.nameLength );
+
+      // gps name, we use 8 characters without spaces
+      QString gpsName = afName;
+      gpsName.remove(QChar(' '));
+      gpsName = gpsName.left(8);
+
+      if( ! shortNameSet.contains( gpsName) )
         {
-          gl++;
+          shortNameSet.insert( gpsName );
         }
-      else if( olField )
+      else
         {
-          ol++;
+          // Try to generate an unique short name. The assumption is that we never have
+          // more than 10 equal names.
+          for( int i=0; i <= 9; i++ )
+            {
+              gpsName.replace( gpsName.length()-1, 1, QString::number(i) );
+
+              if( ! shortNameSet.contains( gpsName) )
+                {
+                  shortNameSet.insert( gpsName );
+                  break;
+                }
+            }
         }
-      else
+
+      QString commentLong;
+
+      if( r.flags & 1 )
         {
-          af++;
+          commentLong = QString( QObject::tr("Emergency Field No: ")) +
+                        QString::fromLatin1( r.flNo, sizeof(r.flNo) ).trimmed();
         }
 
-      Airfield af( afName, icao.trimmed(), gpsName, afType,
-                   wgsPos, position, elevation, fFrequency, country, commentLong );
+      WGSPoint wgsPos( r.lat, r.lon );
+      QPoint position = _globalMapMatrix->wgsToMap(wgsPos);
 
-      for( int i = 0; i < rwCount; i++ )
+      BaseMapElement::objectType afType = static_cast<BaseMapElement::objectType> (r.type);
+
+      Airfield afe( afName,
+                    QString::fromLatin1( r.icao, sizeof(r.icao) ).trimmed(),
+                    gpsName,
+                    afType,
+                    wgsPos,
+                    position,
+                    r.elevation,
+                    r.frequency / 1000.0,
+                    QString::fromLatin1( r.country, sizeof(r.country) ),
+                    commentLong );
+
+      for( int i = 0; i < r.rwCount; i++ )
         {
           // create an runway object
-          Runway rw( rwLen, rwDirections[i], rwSurface, true );
-          af.addRunway( rw );
+          Runway rw( r.rwLength,
+                     QPair<ushort, ushort>( r.rwDir[2*i], r.rwDir[2*i+1] ),
+                     static_cast<enum Runway::SurfaceType> (r.rwSurface),
+                     true );
+
+          afe.addRunway( rw );
         }
 
       if( afType == BaseMapElement::Outlanding )
         {
           // Add an outlanding site to the list.
-          outlandingList.append( af );
+          outlandingList.append( afe );
+          ol++;
         }
       else if( afType == BaseMapElement::Gliderfield )
         {
           // Add a glider site to the related list.
-          gliderfieldList.append( af );
+          gliderfieldList.append( afe );
+          gl++;
         }
       else
         {
           // Add an airfield or an ultralight field to the list
-          airfieldList.append( af );
-        }
-    } // End of while( ! in.atEnd() )
+          airfieldList.append( afe );
 
-  in.close();
-
-  qDebug( "W2000, Statistics from file %s: Parsing Time=%dms, Sum=%d, Airfields=%d, GL=%d, UL=%d, OL=%d",
-          basename(path.toLatin1().data()), t.elapsed(), af+gl+ul+ol, af, gl, ul, ol );
+          if( afType == BaseMapElement::UltraLight )
+            {
+              ul++;
+            }
+          else
+            {
+              af++;
+            }
+        }
+    }
 
-  return true;
+  qDebug( "W2000: Sum=%d, Airfields=%d, GL=%d, UL=%d, OL=%d",
+          af+gl+ul+ol, af, gl, ul, ol );
 }
 
 /**
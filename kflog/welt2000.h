@@ -52,12 +52,15 @@
 #ifndef _welt2000_h
 #define _welt2000_h
 
+#include <QByteArray>
 #include <QMap>
 #include <QList>
+#include <QSet>
 #include <QString>
 #include <QStringList>
 #include <QRect>
 #include <QPoint>
+#include <QVector>
 
 #include "airfield.h"
 #include "basemapelement.h"
@@ -69,11 +72,15 @@
  *
  * \brief Class to read, parse and filter a Welt2000 file.
  *
- * This class can read, parse and filter a Welt2000 file.
+ * This class can read, parse and filter a Welt2000 file. The parse result
+ * is stored as compiled file WELT2000.TXC beside the source file. It is
+ * reused as long as the source file and the country and outlanding filters
+ * are unchanged. The home radius filter is applied during the read of the
+ * compiled file by using its spatial index.
  *
  * \date 2006-2014
  *
- * \version 1.1
+ * \version 1.2
  */
 
 class Welt2000
@@ -117,20 +124,110 @@ public:
 private:
 
     /**
-     * Parses the passed file in welt2000 format and put the appropriate
-     * entries in the related lists.
+     * Fixed size record of the compiled Welt2000 file. Strings, which have
+     * no fixed length, are kept in a separate string table.
+     */
+    struct Record
+    {
+      qint32  lat;
+      qint32  lon;
+      quint32 seq;        // line number in the source file
+      quint32 nameOffset; // offset of the UTF-8 name in the string table
+      quint8  nameLength;
+      char    icao[4];
+      char    country[2];
+      char    flNo[2];    // number of an emergency field
+      quint8  flags;
+      quint8  type;
+      qint16  elevation;
+      quint32 frequency;  // in kHz
+      quint16 rwLength;
+      quint8  rwSurface;
+      quint8  rwCount;
+      quint8  rwDir[4];
+    };
+
+    /**
+     * Entry of the spatial index. All records of a one degree cell are
+     * stored one after another in the compiled file.
+     */
+    struct Cell
+    {
+      qint16  lat;
+      qint16  lon;
+      quint32 first;
+      quint32 count;
+    };
+
+    /**
+     * Loads the filter settings from the KFLog configuration.
+     */
+    void loadFilterSettings();
+
+    /**
+     * Creates the key of the compiled file from the hash of the source file
+     * and all filter settings, which are applied during compilation.
+     */
+    QByteArray compiledKey( const QByteArray& sourceHash );
+
+    /**
+     * Parses the passed buffer in welt2000 format, writes the result as
+     * compiled file and puts the appropriate entries in the related lists.
      *
-     * @param path Full name with path of welt2000 file
+     * @param data Memory mapped content of the welt2000 file
+     * @param size Size of the mapped content
+     * @param compiledPath Full name with path of the compiled file
+     * @param key Key to be stored in the header of the compiled file
      * @param airfieldList All airports have to be stored in this list
      * @param gliderfieldList All gilder fields have to be stored in this list
      * @param outlandingList All outlanding fields have to be stored in this list
      * @return true (success) or false (error occurred)
      */
-    bool parse( QString& path,
+    bool parse( const char* data,
+                const qint64 size,
+                const QString& compiledPath,
+                const QByteArray& key,
                 QList<Airfield>& airfieldList,
                 QList<Airfield>& gliderfieldList,
                 QList<Airfield>& outlandingList );
 
+    /**
+     * Writes the parsed records sorted by their index cells into the
+     * compiled file.
+     */
+    bool writeCompiledFile( const QString& compiledPath,
+                            const QByteArray& key,
+                            const QVector<Record>& records,
+                            const QVector<Cell>& cells,
+                            const QByteArray& strings );
+
+    /**
+     * Reads the compiled file, if its key matches the passed one. Only the
+     * index cells touched by the home radius are read.
+     *
+     * @return true (success) or false (no valid compiled file)
+     */
+    bool readCompiledFile( const QString& compiledPath,
+                           const QByteArray& key,
+                           QList<Airfield>& airfieldList,
+                           QList<Airfield>& gliderfieldList,
+                           QList<Airfield>& outlandingList );
+
+    /**
+     * Compares two records by their position in the source file.
+     */
+    static bool seqLessThan( const Record& r1, const Record& r2 );
+
+    /**
+     * Applies the home radius filter to the records, creates the airfield
+     * objects in source file order and appends them to the related lists.
+     */
+    void appendRecords( QVector<Record>& records,
+                        const char* strings,
+                        QList<Airfield>& airfieldList,
+                        QList<Airfield>& gliderfieldList,
+                        QList<Airfield>& outlandingList );
+
     /**
      * Get the distance back according to the set unit by the user.
      *
@@ -152,6 +249,12 @@ private:
     QStringList c_countryList;
     // radius around home position
     double c_homeRadius;
+    // outlanding load flag
+    bool c_outlandings;
+
+    // fingerprint and content hash of the last loaded source file
+    static QByteArray c_sourceFingerprint;
+    static QByteArray c_sourceHash;
 };
 
 #endif